@@ -197,6 +197,48 @@ public:
     */
     const String& getShaderCachePath() const { return mShaderCachePath; }
 
+    /** 
+    Set whether the microcode of the compiled programs is cached in the shader cache path.
+    @remarks
+    While enabled with a cache path set, the microcode cache of the GpuProgramManager
+    and the saving of microcodes into it are turned on, and the microcode is loaded
+    from and saved into the cache path along with the program cache. Disabling it or
+    clearing the cache path restores the previous GpuProgramManager settings.
+    The default is disabled, which leaves the GpuProgramManager untouched.
+    @param enabled Whether to cache the microcode.
+    */
+    void setMicrocodeCacheEnabled(bool enabled);
+
+    /** 
+    Return whether the microcode of the compiled programs is cached in the shader cache path.
+    */
+    bool getMicrocodeCacheEnabled() const { return mMicrocodeCacheEnabled; }
+
+    /** 
+    Save the persistent program cache into the shader cache path.
+    @remarks
+    When a cache path is set, the programs generated for each resolved chain of
+    sub render states and target language are loaded from it. Programs found there
+    skip the writing of their source code, and compilation too where the microcode
+    cache is enabled and the render system caches microcode.
+    The caches are saved when the generator is destroyed, or by calling this.
+    @see setMicrocodeCacheEnabled
+    */
+    void saveProgramCache();
+
+    /** 
+    Generate the programs of every material of a resource group, so that they
+    are in the program cache on the next launch.
+    @remarks
+    Creates shader based techniques of the given scheme for the materials of the
+    group, validates them and saves the program cache. Lighting programs depend on
+    the light settings of the active scene manager, like at runtime.
+    @param groupName The initialised resource group of the materials.
+    @param schemeName The destination scheme name.
+    @return The number of materials whose programs were generated.
+    */
+    size_t precompileResourceGroup(const String& groupName, const String& schemeName = DEFAULT_SCHEME_NAME);
+
     /** 
     Flush the shader cache. This operation will cause all active sachems to be invalidated and will
     destroy any CPU/GPU program that created by this shader generator.
@@ -923,6 +965,12 @@ protected:
     /** Destory the shader generator instance. */
     void _destroy();
 
+    /** Turn the microcode cache of the GpuProgramManager on and load it from the shader cache path. */
+    void attachMicrocodeCache();
+
+    /** Restore the microcode cache settings of the GpuProgramManager. */
+    void detachMicrocodeCache();
+
     /** Find source technique to generate shader based technique based on it. */
     Technique* findSourceTechnique(const String& materialName, const String& groupName, const String& srcTechniqueSchemeName, bool allowProgrammable);
 
@@ -1048,6 +1096,11 @@ protected:
     StringVector mFragmentShaderProfilesList;
     // Path for caching the generated shaders.
     String mShaderCachePath;
+    // Whether the microcode is cached in the shader cache path.
+    bool mMicrocodeCacheEnabled;
+    // The microcode cache settings of the GpuProgramManager before attaching to it.
+    bool mPrevEnableMicrocodeCache;
+    bool mPrevSaveMicrocodesToCache;
     // Shader program manager.
     ProgramManager* mProgramManager;
     // Shader program writer manager.
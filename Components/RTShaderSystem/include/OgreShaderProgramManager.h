@@ -108,6 +108,38 @@ public:
     */
     void flushGpuProgramsCache();
 
+    /** Load the persistent program cache, replacing the programs cached so far.
+    @remarks
+    The cache maps the resolved CPU programs of a render state, with the target
+    language and profiles, to the name and source code of their GPU programs.
+    When a program is found in it, writing its source code is skipped, and the
+    GPU program is created from the cached source, which the microcode cache of
+    the GpuProgramManager recognises.
+    @param stream The stream to read the cache from, as written by saveProgramCache.
+    @return Whether the stream held a cache of this version.
+    */
+    bool loadProgramCache(const DataStreamPtr& stream);
+
+    /** Save the persistent program cache.
+    @param stream The writable stream to save the cache into.
+    */
+    void saveProgramCache(const DataStreamPtr& stream);
+
+    /** Return whether programs were added to the cache since it was last loaded or saved. */
+    bool isProgramCacheDirty() const { return mProgramCacheDirty; }
+
+    /** Return the number of programs in the persistent cache. */
+    size_t getProgramCacheSize() const { return mProgramCache.size(); }
+
+    /** Return the number of GPU programs found in the persistent cache. */
+    size_t getProgramCacheHits() const { return mProgramCacheHits; }
+
+    /** Return the number of GPU programs whose source code had to be written. */
+    size_t getProgramCacheMisses() const { return mProgramCacheMisses; }
+
+    /** Remove all the programs from the persistent cache. */
+    void clearProgramCache();
+
 protected:
 
     //-----------------------------------------------------------------------------
@@ -129,6 +161,17 @@ protected:
     typedef ProgramProcessorMap::const_iterator         ProgramProcessorConstIterator;
     typedef vector<ProgramProcessor*>::type             ProgramProcessorList;
 
+    //-----------------------------------------------------------------------------
+    // GPU program entry of the persistent program cache.
+    struct CachedProgram
+    {
+        String name;
+        String source;
+    };
+    typedef map<String, CachedProgram>::type            ProgramCacheMap;
+    typedef ProgramCacheMap::iterator                   ProgramCacheIterator;
+    typedef ProgramCacheMap::const_iterator             ProgramCacheConstIterator;
+
     
 protected:
     /** Create default program processors. */
@@ -168,6 +211,15 @@ protected:
     */
     String generateGUID(const String& programString);
 
+    /** 
+    Generates the key of a program in the persistent program cache.
+    @param shaderProgram The resolved CPU program.
+    @param language The target shader language.
+    @param profiles The profiles string for program compilation.
+    @return A string representing a 128 bit hash value of the program structure.
+    */
+    String generateProgramCacheKey(Program* shaderProgram, const String& language, const String& profiles);
+
     /** Create GPU program based on the give CPU program.
     @param shaderProgram The CPU program instance.
     @param programWriter The program writer instance.
@@ -238,6 +290,14 @@ protected:
     ProgramProcessorList mDefaultProgramProcessors;
     // map the source code of the shaders to a name for them
     ProgramSourceToNameMap mProgramSourceToNameMap;
+    // Persistent cache of the generated programs.
+    ProgramCacheMap mProgramCache;
+    // Whether programs were added to the persistent cache since it was loaded or saved.
+    bool mProgramCacheDirty;
+    // Number of GPU programs found in the persistent cache.
+    size_t mProgramCacheHits;
+    // Number of GPU programs missing from the persistent cache.
+    size_t mProgramCacheMisses;
 
 private:
     friend class ProgramSet;
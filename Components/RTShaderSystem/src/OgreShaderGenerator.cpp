@@ -45,6 +45,7 @@ THE SOFTWARE.
 #include "OgreShaderExTriplanarTexturing.h"
 #include "OgreRoot.h"
 #include "OgreException.h"
+#include "OgreLogManager.h"
 
 namespace Ogre {
 
@@ -58,6 +59,8 @@ namespace RTShader {
 
 String ShaderGenerator::DEFAULT_SCHEME_NAME     = "ShaderGeneratorDefaultScheme";
 String GENERATED_SHADERS_GROUP_NAME             = "ShaderGeneratorResourceGroup";
+String PROGRAM_CACHE_FILE_NAME                  = "RTShaderProgramCache.bin";
+String MICROCODE_CACHE_FILE_NAME                = "RTShaderMicrocode.bin";
 String ShaderGenerator::SGPass::UserKey         = "SGPass";
 String ShaderGenerator::SGTechnique::UserKey    = "SGTechnique";
 
@@ -77,7 +80,9 @@ ShaderGenerator& ShaderGenerator::getSingleton()
 //-----------------------------------------------------------------------------
 ShaderGenerator::ShaderGenerator() :
     mActiveSceneMgr(NULL), mRenderObjectListener(NULL), mSceneManagerListener(NULL), mScriptTranslatorManager(NULL),
-    mMaterialSerializerListener(NULL), mShaderLanguage(""), mProgramManager(NULL), mProgramWriterManager(NULL),
+    mMaterialSerializerListener(NULL), mShaderLanguage(""),
+    mMicrocodeCacheEnabled(false), mPrevEnableMicrocodeCache(false), mPrevSaveMicrocodesToCache(false),
+    mProgramManager(NULL), mProgramWriterManager(NULL),
     mFSLayer(0), mFFPRenderStateBuilder(NULL),mActiveViewportValid(false), mVSOutputCompactPolicy(VSOCP_LOW),
     mCreateShaderOverProgrammablePass(false), mIsFinalizing(false)
 {
@@ -173,7 +178,8 @@ bool ShaderGenerator::_initialize()
     // Create the default scheme.
     createScheme(DEFAULT_SCHEME_NAME);
 	
-	if (Ogre::Root::getSingleton().getRenderSystem()->getName().find("Direct3D11") != String::npos)
+	RenderSystem* renderSystem = Ogre::Root::getSingleton().getRenderSystem();
+	if (renderSystem != NULL && renderSystem->getName().find("Direct3D11") != String::npos)
 	{
 		this->setTargetLanguage("hlsl",4.0);
 	}
@@ -247,6 +253,10 @@ void ShaderGenerator::_destroy()
     OGRE_LOCK_AUTO_MUTEX;
     
     mIsFinalizing = true;
+
+    // Keep the programs generated this session for the next one.
+    if (mProgramManager != NULL)
+        saveProgramCache();
     
     // Delete technique entries.
     for (SGTechniqueMapIterator itTech = mTechniqueEntriesMap.begin(); itTech != mTechniqueEntriesMap.end(); ++itTech)
@@ -1410,6 +1420,9 @@ void ShaderGenerator::setShaderCachePath( const String& cachePath )
         // Remove previous cache path. 
         if (mShaderCachePath.empty() == false)
         {
+            saveProgramCache();
+            if (mMicrocodeCacheEnabled)
+                detachMicrocodeCache();
             ResourceGroupManager::getSingleton().removeResourceLocation(mShaderCachePath, GENERATED_SHADERS_GROUP_NAME);
         }
 
@@ -1435,8 +1448,123 @@ void ShaderGenerator::setShaderCachePath( const String& cachePath )
             remove(outTestFileName.c_str());
 
             ResourceGroupManager::getSingleton().addResourceLocation(mShaderCachePath, "FileSystem", GENERATED_SHADERS_GROUP_NAME);                 
+
+            // Load the programs and microcode cached by previous sessions.
+            ResourceGroupManager& groupManager = ResourceGroupManager::getSingleton();
+            if (groupManager.resourceExists(GENERATED_SHADERS_GROUP_NAME, PROGRAM_CACHE_FILE_NAME))
+            {
+                mProgramManager->loadProgramCache(
+                    groupManager.openResource(PROGRAM_CACHE_FILE_NAME, GENERATED_SHADERS_GROUP_NAME));
+            }
+
+            if (mMicrocodeCacheEnabled)
+                attachMicrocodeCache();
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::setMicrocodeCacheEnabled(bool enabled)
+{
+    if (mMicrocodeCacheEnabled == enabled)
+        return;
+
+    // Case cache path is set -> switch the GpuProgramManager cache right away.
+    if (mShaderCachePath.empty() == false)
+    {
+        if (enabled)
+        {
+            attachMicrocodeCache();
+        }
+        else
+        {
+            // Keep the microcode compiled so far.
+            saveProgramCache();
+            detachMicrocodeCache();
         }
     }
+
+    mMicrocodeCacheEnabled = enabled;
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::attachMicrocodeCache()
+{
+    GpuProgramManager& gpuProgramManager = GpuProgramManager::getSingleton();
+    mPrevEnableMicrocodeCache = gpuProgramManager.getEnableMicrocodeCache();
+    mPrevSaveMicrocodesToCache = gpuProgramManager.getSaveMicrocodesToCache();
+    gpuProgramManager.setEnableMicrocodeCache(true);
+    gpuProgramManager.setSaveMicrocodesToCache(true);
+
+    ResourceGroupManager& groupManager = ResourceGroupManager::getSingleton();
+    if (groupManager.resourceExists(GENERATED_SHADERS_GROUP_NAME, MICROCODE_CACHE_FILE_NAME))
+    {
+        gpuProgramManager.loadMicrocodeCache(
+            groupManager.openResource(MICROCODE_CACHE_FILE_NAME, GENERATED_SHADERS_GROUP_NAME));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::detachMicrocodeCache()
+{
+    GpuProgramManager& gpuProgramManager = GpuProgramManager::getSingleton();
+    gpuProgramManager.setEnableMicrocodeCache(mPrevEnableMicrocodeCache);
+    gpuProgramManager.setSaveMicrocodesToCache(mPrevSaveMicrocodesToCache);
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::saveProgramCache()
+{
+    OGRE_LOCK_AUTO_MUTEX;
+
+    if (mShaderCachePath.empty())
+        return;
+
+    if (mProgramManager->isProgramCacheDirty())
+    {
+        mProgramManager->saveProgramCache(Root::getSingleton().createFileStream(
+            mShaderCachePath + PROGRAM_CACHE_FILE_NAME, GENERATED_SHADERS_GROUP_NAME, true));
+    }
+
+    if (mMicrocodeCacheEnabled && GpuProgramManager::getSingleton().isCacheDirty())
+    {
+        GpuProgramManager::getSingleton().saveMicrocodeCache(Root::getSingleton().createFileStream(
+            mShaderCachePath + MICROCODE_CACHE_FILE_NAME, GENERATED_SHADERS_GROUP_NAME, true));
+    }
+}
+
+//-----------------------------------------------------------------------------
+size_t ShaderGenerator::precompileResourceGroup(const String& groupName, const String& schemeName)
+{
+    OGRE_LOCK_AUTO_MUTEX;
+
+    // Gather the names first, validating may create resources.
+    StringVector materialNames;
+    ResourceManager::ResourceMapIterator itMat = MaterialManager::getSingleton().getResourceIterator();
+    while (itMat.hasMoreElements())
+    {
+        ResourcePtr material = itMat.getNext();
+        if (material->getGroup() == groupName)
+            materialNames.push_back(material->getName());
+    }
+
+    size_t count = 0;
+    for (StringVector::const_iterator it = materialNames.begin(); it != materialNames.end(); ++it)
+    {
+        if (createShaderBasedTechnique(*it, groupName, MaterialManager::DEFAULT_SCHEME_NAME, schemeName) &&
+            validateMaterial(schemeName, *it, groupName))
+        {
+            ++count;
+        }
+    }
+
+    LogManager::getSingleton().stream() << "RTShader: Generated the programs of " << count << " of " <<
+        materialNames.size() << " materials of group '" << groupName << "', " <<
+        mProgramManager->getProgramCacheHits() << " programs found in the cache, " <<
+        mProgramManager->getProgramCacheMisses() << " written";
+
+    saveProgramCache();
+    return count;
 }
 
 //-----------------------------------------------------------------------------
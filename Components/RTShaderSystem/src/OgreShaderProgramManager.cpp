@@ -47,7 +47,19 @@ THE SOFTWARE.
 #include "OgreShaderGLSLProgramProcessor.h"
 #endif
 #include "OgreShaderGLSLESProgramProcessor.h"
+#include "OgreShaderFunction.h"
 #include "OgreGpuProgramManager.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+
+#include "Hash/MurmurHash3.h"
+#include "OgreIdString.h"
+
+#if OGRE_ARCH_TYPE == OGRE_ARCHITECTURE_32
+        #define OGRE_HASH128_FUNC MurmurHash3_x86_128
+#else
+        #define OGRE_HASH128_FUNC MurmurHash3_x64_128
+#endif
 
 
 namespace Ogre {
@@ -58,6 +70,108 @@ RTShader::ProgramManager* Singleton<RTShader::ProgramManager>::msSingleton = 0;
 
 namespace RTShader {
 
+namespace
+{
+    // Identifies program cache streams, the last digit being the version.
+    const uint32 PROGRAM_CACHE_MAGIC = 0x52545331;  // "RTS1"
+
+    //-----------------------------------------------------------------------------
+    void writeCacheString(const DataStreamPtr& stream, const String& value)
+    {
+        uint32 length = static_cast<uint32>(value.size());
+        stream->write(&length, sizeof(uint32));
+        stream->write(value.data(), length);
+    }
+
+    //-----------------------------------------------------------------------------
+    bool readCacheString(const DataStreamPtr& stream, String& value)
+    {
+        uint32 length = 0;
+        if (stream->read(&length, sizeof(uint32)) != sizeof(uint32) || length > stream->size())
+            return false;
+        value.resize(length);
+        return length == 0 || stream->read(&value[0], length) == length;
+    }
+
+    //-----------------------------------------------------------------------------
+    /** Binary description of the resolved structure of a CPU program, every
+    field the program writers depend on, which keys the program cache.
+    */
+    class ProgramDescription
+    {
+    public:
+        void add(const String& value)
+        {
+            add(static_cast<uint32>(value.size()));
+            mData.append(value);
+        }
+
+        template<typename T> void add(T value)
+        {
+            mData.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void addParameter(const Parameter* parameter)
+        {
+            add(parameter->toString());
+            add(static_cast<int>(parameter->getType()));
+            add(static_cast<int>(parameter->getSemantic()));
+            add(parameter->getIndex());
+            add(static_cast<int>(parameter->getContent()));
+            add(static_cast<uint32>(parameter->getSize()));
+        }
+
+        void addParameters(const ShaderParameterList& parameters)
+        {
+            add(static_cast<uint32>(parameters.size()));
+            for (ShaderParameterConstIterator it = parameters.begin(); it != parameters.end(); ++it)
+                addParameter(it->get());
+        }
+
+        void addFunction(Function* function)
+        {
+            add(function->getName());
+            add(function->getDescription());
+            add(static_cast<int>(function->getFunctionType()));
+            addParameters(function->getInputParameters());
+            addParameters(function->getOutputParameters());
+            addParameters(function->getLocalParameters());
+
+            // The writers emit the atoms in execution order.
+            function->sortAtomInstances();
+            const FunctionAtomInstanceList& atoms = function->getAtomInstances();
+            add(static_cast<uint32>(atoms.size()));
+            for (FunctionAtomInstanceConstIterator it = atoms.begin(); it != atoms.end(); ++it)
+            {
+                FunctionAtom* atom = *it;
+                add(atom->getFunctionAtomType());
+                add(atom->getGroupExecutionOrder());
+                add(atom->getInternalExecutionOrder());
+                if (atom->getFunctionAtomType() != FunctionInvocation::Type)
+                    continue;
+
+                FunctionInvocation* invocation = static_cast<FunctionInvocation*>(atom);
+                add(invocation->getFunctionName());
+                add(invocation->getReturnType());
+                const FunctionInvocation::OperandVector& operands = invocation->getOperandList();
+                add(static_cast<uint32>(operands.size()));
+                for (FunctionInvocation::OperandVector::const_iterator itOp = operands.begin(); itOp != operands.end(); ++itOp)
+                {
+                    add(itOp->getParameter()->toString());
+                    add(static_cast<int>(itOp->getSemantic()));
+                    add(itOp->getMask());
+                    add(itOp->getIndirectionLevel());
+                }
+            }
+        }
+
+        const String& getData() const { return mData; }
+
+    private:
+        String mData;
+    };
+}
+
 
 //-----------------------------------------------------------------------
 ProgramManager* ProgramManager::getSingletonPtr()
@@ -73,7 +187,10 @@ ProgramManager& ProgramManager::getSingleton()
 }
 
 //-----------------------------------------------------------------------------
-ProgramManager::ProgramManager()
+ProgramManager::ProgramManager() :
+    mProgramCacheDirty(false),
+    mProgramCacheHits(0),
+    mProgramCacheMisses(0)
 {
     createDefaultProgramProcessors();
     createDefaultProgramWriterFactories();
@@ -386,26 +503,59 @@ GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
                                                const StringVector& profilesList,
                                                const String& cachePath)
 {
-    stringstream sourceCodeStringStream;
     String programName;
-
-    // Generate source code.
-    programWriter->writeSourceCode(sourceCodeStringStream, shaderProgram);
-    String source = sourceCodeStringStream.str();
+    String source;
+    bool cached = false;
 
 #if OGRE_PLATFORM != OGRE_PLATFORM_ANDROID
-    
-    // Generate program name.
-    programName = generateGUID(source);
+
+    // Look the resolved program up in the persistent cache.
+    const String cacheKey = generateProgramCacheKey(shaderProgram, language, profiles);
+    ProgramCacheConstIterator itCached = mProgramCache.find(cacheKey);
+    if (itCached != mProgramCache.end())
+    {
+        programName = itCached->second.name;
+        source = itCached->second.source;
+        cached = true;
+        ++mProgramCacheHits;
+    }
+    else
+    {
+        // Generate source code.
+        stringstream sourceCodeStringStream;
+        programWriter->writeSourceCode(sourceCodeStringStream, shaderProgram);
+        source = sourceCodeStringStream.str();
+
+        // Generate program name.
+        programName = generateGUID(source);
+
+        if (shaderProgram->getType() == GPT_VERTEX_PROGRAM)
+        {
+            programName += "_VS";
+        }
+        else if (shaderProgram->getType() == GPT_FRAGMENT_PROGRAM)
+        {
+            programName += "_FS";
+        }
+
+        CachedProgram& entry = mProgramCache[cacheKey];
+        entry.name = programName;
+        entry.source = source;
+        mProgramCacheDirty = true;
+        ++mProgramCacheMisses;
+    }
 
 #else // Disable caching on android devices 
 
+    // Generate source code.
+    stringstream sourceCodeStringStream;
+    programWriter->writeSourceCode(sourceCodeStringStream, shaderProgram);
+    source = sourceCodeStringStream.str();
+
     // Generate program name.
     static int gpuProgramID = 0;
     programName = "RTSS_"  + StringConverter::toString(++gpuProgramID);
-   
-#endif
-    
+
     if (shaderProgram->getType() == GPT_VERTEX_PROGRAM)
     {
         programName += "_VS";
@@ -414,6 +564,8 @@ GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
     {
         programName += "_FS";
     }
+   
+#endif
 
     // Try to get program by name.
     HighLevelGpuProgramPtr pGpuProgram = HighLevelGpuProgramManager::getSingleton().getByName(programName);
@@ -425,8 +577,9 @@ GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
         pGpuProgram = HighLevelGpuProgramManager::getSingleton().createProgram(programName,
             ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, language, shaderProgram->getType());
 
-        // Case cache directory specified -> create program from file.
-        if (cachePath.empty() == false)
+        // Case cache directory specified -> create program from file, unless the
+        // source comes from the program cache.
+        if (cachePath.empty() == false && !cached)
         {
             const String  programFullName = programName + "." + language;
             const String  programFileName = cachePath + programFullName;    
@@ -463,7 +616,7 @@ GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
             pGpuProgram->setSourceFile(programFullName);
         }
 
-        // No cache directory specified -> create program from system memory.
+        // No cache directory specified or cached program -> create program from system memory.
         else
         {
             pGpuProgram->setSource(source);
@@ -570,6 +723,124 @@ String ProgramManager::generateGUID(const String& programString)
 }
 
 
+//-----------------------------------------------------------------------------
+String ProgramManager::generateProgramCacheKey(Program* shaderProgram, const String& language, const String& profiles)
+{
+    ProgramDescription description;
+
+    // The target of the writers.
+    RenderSystem* renderSystem = Root::getSingleton().getRenderSystem();
+    description.add(language);
+    description.add(ShaderGenerator::getSingleton().getTargetLanguageVersion());
+    description.add(profiles);
+    description.add(renderSystem ? renderSystem->getName() : BLANKSTRING);
+    description.add(renderSystem ? renderSystem->getNativeShadingLanguageVersion() : uint16(0));
+
+    // The resolved program.
+    description.add(static_cast<int>(shaderProgram->getType()));
+    description.add(shaderProgram->getUseColumnMajorMatrices());
+    description.add(static_cast<uint32>(shaderProgram->getDependencyCount()));
+    for (unsigned int i = 0; i < shaderProgram->getDependencyCount(); ++i)
+        description.add(shaderProgram->getDependency(i));
+
+    const UniformParameterList& parameters = shaderProgram->getParameters();
+    description.add(static_cast<uint32>(parameters.size()));
+    for (UniformParameterConstIterator it = parameters.begin(); it != parameters.end(); ++it)
+    {
+        const UniformParameter* parameter = it->get();
+        description.addParameter(parameter);
+        description.add(parameter->isAutoConstantParameter());
+        if (parameter->isAutoConstantParameter())
+        {
+            description.add(static_cast<int>(parameter->getAutoConstantType()));
+            description.add(static_cast<uint32>(parameter->getAutoConstantIntData()));
+            description.add(parameter->getAutoConstantRealData());
+        }
+    }
+
+    const ShaderFunctionList& functions = shaderProgram->getFunctions();
+    description.add(static_cast<uint32>(functions.size()));
+    for (ShaderFunctionConstIterator it = functions.begin(); it != functions.end(); ++it)
+        description.addFunction(*it);
+    description.add(shaderProgram->getEntryPointFunction()->getName());
+
+    uint32 hash[4];
+    const String& data = description.getData();
+    OGRE_HASH128_FUNC(data.data(), static_cast<int>(data.size()), IdString::Seed, hash);
+
+    stringstream stream;
+    stream.fill('0');
+    stream.setf(std::ios::hex, std::ios::basefield);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        stream.width(8);
+        stream << hash[i];
+    }
+    return stream.str();
+}
+
+//-----------------------------------------------------------------------------
+bool ProgramManager::loadProgramCache(const DataStreamPtr& stream)
+{
+    mProgramCache.clear();
+    mProgramCacheDirty = false;
+
+    uint32 magic = 0, count = 0;
+    if (stream->read(&magic, sizeof(uint32)) != sizeof(uint32) || magic != PROGRAM_CACHE_MAGIC ||
+        stream->read(&count, sizeof(uint32)) != sizeof(uint32))
+    {
+        LogManager::getSingleton().logMessage("RTShader: Ignoring program cache '" + stream->getName() +
+            "' of an unknown version");
+        return false;
+    }
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        String key;
+        CachedProgram entry;
+        if (!readCacheString(stream, key) || !readCacheString(stream, entry.name) ||
+            !readCacheString(stream, entry.source))
+        {
+            LogManager::getSingleton().logMessage("RTShader: Program cache '" + stream->getName() +
+                "' is truncated");
+            break;
+        }
+        mProgramCache[key] = entry;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::saveProgramCache(const DataStreamPtr& stream)
+{
+    if (!stream->isWriteable())
+    {
+        OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+            "Unable to write to stream " + stream->getName(),
+            "ProgramManager::saveProgramCache");
+    }
+
+    uint32 magic = PROGRAM_CACHE_MAGIC;
+    uint32 count = static_cast<uint32>(mProgramCache.size());
+    stream->write(&magic, sizeof(uint32));
+    stream->write(&count, sizeof(uint32));
+
+    for (ProgramCacheConstIterator it = mProgramCache.begin(); it != mProgramCache.end(); ++it)
+    {
+        writeCacheString(stream, it->first);
+        writeCacheString(stream, it->second.name);
+        writeCacheString(stream, it->second.source);
+    }
+    mProgramCacheDirty = false;
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::clearProgramCache()
+{
+    mProgramCache.clear();
+    mProgramCacheDirty = true;
+}
+
 //-----------------------------------------------------------------------------
 void ProgramManager::addProgramProcessor(ProgramProcessor* processor)
 {
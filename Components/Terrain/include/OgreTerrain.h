@@ -1926,6 +1926,7 @@ namespace Ogre
         Real mCompositeMapDistance;
         String mResourceGroup;
         bool mUseVertexCompressionWhenAvailable;
+        bool mCompressCompositeMap;
 
     public:
         TerrainGlobalOptions();
@@ -2106,6 +2107,21 @@ namespace Ogre
          */
         void setUseVertexCompressionWhenAvailable(bool enable) { mUseVertexCompressionWhenAvailable = enable; }
 
+        /** Get whether composite maps are block compressed when the hardware
+            supports it.
+        */
+        bool getCompressCompositeMap() const { return mCompressCompositeMap; }
+
+        /** Set whether composite maps are block compressed when the hardware
+         supports it.
+         @note You should only call this before creating any terrain instances.
+         The default is false. When enabled, composite maps are PF_DXT5 textures,
+         a quarter of the memory of uncompressed ones; each update is read back
+         from the render target and encoded on the CPU, which costs a little
+         more time and some precision.
+         */
+        void setCompressCompositeMap(bool enable) { mCompressCompositeMap = enable; }
+
         /** Override standard Singleton retrieval.
         @remarks
         Why do we do this? Well, it's because the Singleton
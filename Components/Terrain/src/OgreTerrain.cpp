@@ -115,6 +115,7 @@ namespace Ogre
         , mCompositeMapDistance(4000)
         , mResourceGroup(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME)
         , mUseVertexCompressionWhenAvailable(true)
+        , mCompressCompositeMap(false)
     {
     }
     //---------------------------------------------------------------------
@@ -3741,10 +3742,14 @@ namespace Ogre
     {
         if (mCompositeMapRequired && mCompositeMap.isNull())
         {
-            // create
+            // create, block compressed if requested and supported
+            PixelFormat format = PF_BYTE_RGBA;
+            if (TerrainGlobalOptions::getSingleton().getCompressCompositeMap() &&
+                TextureManager::getSingleton().isFormatSupported(TEX_TYPE_2D, PF_DXT5, TU_STATIC))
+                format = PF_DXT5;
             mCompositeMap = TextureManager::getSingleton().createManual(
                 mMaterialName + "/comp", _getDerivedResourceGroup(), 
-                TEX_TYPE_2D, mCompositeMapSize, mCompositeMapSize, 0, PF_BYTE_RGBA, TU_STATIC);
+                TEX_TYPE_2D, mCompositeMapSize, mCompositeMapSize, 0, format, TU_STATIC);
 
             mCompositeMapSizeActual = mCompositeMap->getWidth();
 
@@ -3763,8 +3768,8 @@ namespace Ogre
                 // initialise to black
                 Box box(0, 0, mCompositeMapSizeActual, mCompositeMapSizeActual);
                 HardwarePixelBufferSharedPtr buf = mCompositeMap->getBuffer();
-                uint8* pInit = static_cast<uint8*>(buf->lock(box, HardwarePixelBuffer::HBL_DISCARD).data);
-                memset(pInit, 0, mCompositeMapSizeActual * mCompositeMapSizeActual * 4);
+                const PixelBox& pInit = buf->lock(box, HardwarePixelBuffer::HBL_DISCARD);
+                memset(pInit.data, 0, pInit.getConsecutiveSize());
                 buf->unlock();
 
             }
@@ -174,7 +174,22 @@ namespace Ogre
                        static_cast<uint32>(rect.top),
                        static_cast<uint32>(rect.right),
                        static_cast<uint32>(rect.bottom));
-        destCompositeMap->getBuffer()->blit(mCompositeMapRTT->getBuffer(), box, box);
+        if (PixelUtil::isCompressed(destCompositeMap->getFormat()))
+        {
+            // Compressed maps are updated in whole blocks, encoded on the CPU
+            box.left &= ~3u;
+            box.top &= ~3u;
+            box.right = std::min((box.right + 3) & ~3u, static_cast<uint32>(size));
+            box.bottom = std::min((box.bottom + 3) & ~3u, static_cast<uint32>(size));
+            PixelBox pixels(box.getWidth(), box.getHeight(), 1, PF_BYTE_RGBA);
+            uint8* data = OGRE_ALLOC_T(uint8, pixels.getConsecutiveSize(), MEMCATEGORY_GENERAL);
+            pixels.data = data;
+            mCompositeMapRTT->getBuffer()->blitToMemory(box, pixels);
+            destCompositeMap->getBuffer()->blitFromMemory(pixels, box);
+            OGRE_FREE(data, MEMCATEGORY_GENERAL);
+        }
+        else
+            destCompositeMap->getBuffer()->blit(mCompositeMapRTT->getBuffer(), box, box);
 
         
     }
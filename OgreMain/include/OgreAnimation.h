@@ -45,6 +45,7 @@ namespace Ogre {
     */
 
     class Animation;
+    class BakedNodeAnimation;
     
     /** An animation container interface, which allows generic access to sibling animations.
      @remarks
@@ -258,8 +259,12 @@ namespace Ogre {
             other animations.
         @param scale The scale to apply to translations and scalings, useful for 
             adapting an animation to a different size target.
+        @param cursor Optional keyframe cursor of the animation state being
+            applied, which speeds up the search for keyframes when the node
+            tracks are baked (see setUseBakedNodeTracks).
         */
-        void apply(Skeleton* skeleton, Real timePos, Real weight = 1.0, Real scale = 1.0f);
+        void apply(Skeleton* skeleton, Real timePos, Real weight = 1.0, Real scale = 1.0f,
+            AnimationState::KeyFrameCursor* cursor = 0);
 
         /** Applies all node tracks given a specific time point and weight to a given skeleton.
         @remarks
@@ -272,9 +277,12 @@ namespace Ogre {
             be modulated with the weight factor.
         @param scale The scale to apply to translations and scalings, useful for 
             adapting an animation to a different size target.
+        @param cursor Optional keyframe cursor of the animation state being
+            applied, see above.
         */
         void apply(Skeleton* skeleton, Real timePos, float weight,
-          const AnimationState::BoneBlendMask* blendMask, Real scale);
+          const AnimationState::BoneBlendMask* blendMask, Real scale,
+          AnimationState::KeyFrameCursor* cursor = 0);
 
         /** Applies all vertex tracks given a specific time point and weight to a given entity.
         @param entity The Entity to which this animation should be applied
@@ -344,6 +352,68 @@ namespace Ogre {
         */
         RotationInterpolationMode getRotationInterpolationMode(void) const;
 
+        /** Tells the animation whether to evaluate its node tracks from a baked copy
+            of their keyframes when it is applied to a skeleton.
+        @remarks
+            Keyframes are normally held by their tracks as individually allocated
+            objects and searched for on every evaluation. When baking is enabled, the
+            keyframes of all node tracks are also copied into contiguous arrays, the
+            keyframes in use are found from a cursor kept by the AnimationState, and
+            the tracks are interpolated together in SIMD batches. This makes a large
+            difference for skeletons with many bones and for many animated skeletons.
+        @par
+            The results are the same as without baking. Baking applies to linear
+            interpolation only; with IM_SPLINE, and for tracks which have a listener,
+            the tracks are evaluated as usual. The copy costs as much memory as the
+            keyframes themselves and is rebuilt whenever they change.
+        */
+        void setUseBakedNodeTracks(bool baked);
+
+        /** Gets whether node tracks are evaluated from a baked copy of their keyframes. */
+        bool getUseBakedNodeTracks(void) const { return mUseBakedNodeTracks; }
+
+        /** Compresses the keyframes of the node tracks.
+        @remarks
+            Character animations are usually sampled at a fixed rate, so most of
+            their keyframes can be reproduced by interpolating their neighbours,
+            and their values cover small ranges. This drops the keyframes which
+            linear interpolation reproduces within the given tolerances and
+            quantises the others, which typically cuts the memory used by the
+            node tracks by 5 to 10 times (see BakedNodeAnimation::bakeCompressed).
+        @par
+            The compressed keyframes replace those of the tracks, which are left
+            empty; they are evaluated as baked tracks are (see setUseBakedNodeTracks),
+            always with linear interpolation and ignoring track listeners. To
+            edit the keyframes, call decompressNodeTracks first; creating a node
+            track or a keyframe of one decompresses them as well. Any base keyframe
+            is applied before compressing, a later one to the compressed keyframes. Compressed animations are saved as
+            such by SkeletonSerializer.
+        @param positionTolerance Largest error allowed on dropped translations.
+        @param rotationTolerance Largest error allowed on dropped rotations.
+        @param scaleTolerance Largest error allowed on dropped scales.
+        */
+        void compressNodeTracks(Real positionTolerance = 0.001f,
+            const Radian& rotationTolerance = Radian(0.001f), Real scaleTolerance = 0.001f);
+
+        /** Recreates the keyframes of compressed node tracks in the tracks. */
+        void decompressNodeTracks(void);
+
+        /** Gets whether the node tracks are compressed (see compressNodeTracks). */
+        bool hasCompressedNodeTracks(void) const { return mNodeTracksCompressed; }
+
+        /** Internal method to access the compressed node tracks, null if the
+            node tracks are not compressed. */
+        BakedNodeAnimation* _getCompressedNodeTracks(void) const
+        { return mNodeTracksCompressed ? mBakedNodeTracks : 0; }
+
+        /** Internal method replacing the node track keyframes by empty compressed
+            tracks, which loaders then fill in. */
+        BakedNodeAnimation* _createCompressedNodeTracks(void);
+
+        /** Internal method creating a node track for the compressed keyframes
+            loaders add, without decompressing the other tracks. */
+        NodeAnimationTrack* _createCompressedNodeTrack(unsigned short handle, Node* node);
+
         // Methods for setting the defaults
         /** Sets the default animation interpolation mode. 
         @remarks
@@ -444,7 +514,11 @@ namespace Ogre {
         
         /** Internal method used to tell the animation that keyframe list has been
             changed, which may cause it to rebuild some internal data */
-        void _keyFrameListChanged(void) { mKeyFrameTimesDirty = true; }
+        void _keyFrameListChanged(void) { mKeyFrameTimesDirty = true; mBakedNodeTracksDirty = true; }
+
+        /** Internal method used to tell the animation that the data of a keyframe
+            has been changed, which may cause it to rebuild some internal data */
+        void _keyFrameDataChanged(void) { mBakedNodeTracksDirty = true; }
 
         /** Internal method used to convert time position to time index object.
         @note
@@ -457,6 +531,10 @@ namespace Ogre {
             global keyframe time list.
         */
         TimeIndex _getTimeIndex(Real timePos) const;
+
+        /** Internal method used to wrap a time position into the length of the
+            animation, as _getTimeIndex does. */
+        Real _wrapTimePos(Real timePos) const;
         
         /** Sets a base keyframe which for the skeletal / pose keyframes 
             in this animation. 
@@ -523,6 +601,15 @@ namespace Ogre {
         /// Dirty flag indicate that keyframe time list need to rebuild
         mutable bool mKeyFrameTimesDirty;
 
+        /// Whether node tracks are applied to skeletons from mBakedNodeTracks
+        bool mUseBakedNodeTracks;
+        /// Dirty flag indicate that the baked node tracks need to rebuild
+        bool mBakedNodeTracksDirty;
+        /// Baked node tracks, created on demand or holding the compressed keyframes
+        BakedNodeAnimation* mBakedNodeTracks;
+        /// Whether mBakedNodeTracks is the only copy of the node track keyframes
+        bool mNodeTracksCompressed;
+
         bool mUseBaseKeyFrame;
         Real mBaseKeyFrameTime;
         String mBaseKeyFrameAnimationName;
@@ -533,6 +620,12 @@ namespace Ogre {
 
         /// Internal method to build global keyframe time list
         void buildKeyFrameTimeList(void) const;
+
+        /// Internal method to get the baked node tracks, if they can be used
+        BakedNodeAnimation* getBakedNodeTracks(void);
+
+        /// Internal method creating a node track, whether or not they are compressed
+        NodeAnimationTrack* createNodeTrackImpl(unsigned short handle);
     };
 
     /** @} */
@@ -58,6 +58,10 @@ namespace Ogre {
         /// Typedef for an array of float values used as a bone blend mask
         typedef vector<float>::type BoneBlendMask;
 
+        /** Per track keyframe positions of the last evaluation of baked node
+            tracks, see Animation::setUseBakedNodeTracks. */
+        typedef vector<ushort>::type KeyFrameCursor;
+
         /** Normal constructor with all params supplied
             @param
                 animName The name of this state.
@@ -161,6 +165,13 @@ namespace Ogre {
       const BoneBlendMask* getBlendMask() const {return mBlendMask;}
       /// Return whether there is currently a valid blend mask set
       bool hasBlendMask() const {return mBlendMask != 0;}
+      /** Gets the keyframe cursor used to evaluate baked node tracks.
+      @remarks
+          The cursor remembers where the last evaluation found its keyframes,
+          so that forward playback finds the next ones without searching.
+          It is only a hint and is validated before use.
+      */
+      KeyFrameCursor& _getKeyFrameCursor(void) const { return mKeyFrameCursor; }
       /// Set the weight for the bone identified by the given handle
       void setBlendMaskEntry(size_t boneHandle, float weight);
       /// Get the weight for the bone identified by the given handle
@@ -180,6 +191,8 @@ namespace Ogre {
         Real mWeight;
         bool mEnabled;
         bool mLoop;
+        /// Keyframe positions of the last baked evaluation
+        mutable KeyFrameCursor mKeyFrameCursor;
 
     };
 
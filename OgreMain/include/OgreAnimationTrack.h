@@ -238,6 +238,9 @@ namespace Ogre
         /** Set a listener for this track. */
         virtual void setListener(Listener* l) { mListener = l; }
 
+        /** Returns the listener of this track, if any. */
+        Listener* getListener(void) const { return mListener; }
+
         /** Returns the parent Animation object for this track. */
         Animation *getParent() const { return mParent; }
     protected:
@@ -352,6 +355,17 @@ namespace Ogre
         virtual void applyToNode(Node* node, const TimeIndex& timeIndex, Real weight = 1.0, 
             Real scale = 1.0f);
 
+        /** Applies an interpolated keyframe to a node, the way applyToNode does.
+        @remarks
+            Used to apply keyframes interpolated elsewhere, for instance by
+            BakedNodeAnimation, with exactly the same blending.
+        @param node The node to modify.
+        @param translate, rotation, scale The interpolated keyframe.
+        @param weight, scl As for applyToNode.
+        */
+        void _applyKeyFrameToNode(Node* node, const Vector3& translate, const Quaternion& rotation,
+            const Vector3& scale, Real weight, Real scl) const;
+
         /** Sets the method of rotation calculation */
         virtual void setUseShortestRotationPath(bool useShortestPath);
 
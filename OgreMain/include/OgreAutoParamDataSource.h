@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 #include "OgreCommon.h"
 #include "OgreLight.h"
+#include "OgreAtomicScalar.h"
 
 namespace Ogre {
 
@@ -54,6 +55,12 @@ namespace Ogre {
         will calculate concatenated matrices etc only when required, passing back precalculated
         matrices when they are requested more than once when the underlying information has
         not altered.
+    @par
+        Matrices derived only from the view and projection are kept until the camera, 
+        the render target or the identity view / projection settings of the renderable
+        change, so they are usually calculated once per camera per frame.
+    @par
+        It also counts versions of the information, see getVariabilityVersion.
     */
     class _OgreExport AutoParamDataSource : public SceneMgtAlloc
     {
@@ -82,6 +89,19 @@ namespace Ogre {
         mutable Real mDirLightExtrusionDistance;
         mutable Vector4 mLodCameraPosition;
         mutable Vector4 mLodCameraPositionObjectSpace;
+        mutable Matrix4 mTransposeWorldMatrix;
+        mutable Matrix4 mTransposeWorldViewMatrix;
+        mutable Matrix4 mTransposeWorldViewProjMatrix;
+        mutable Matrix4 mInverseWorldViewProjMatrix;
+        mutable Matrix4 mInverseTransposeWorldViewProjMatrix;
+        mutable Matrix4 mTransposeViewMatrix;
+        mutable Matrix4 mInverseTransposeViewMatrix;
+        mutable Matrix4 mTransposeProjectionMatrix;
+        mutable Matrix4 mInverseProjectionMatrix;
+        mutable Matrix4 mInverseTransposeProjectionMatrix;
+        mutable Matrix4 mTransposeViewProjMatrix;
+        mutable Matrix4 mInverseViewProjMatrix;
+        mutable Matrix4 mInverseTransposeViewProjMatrix;
 
         mutable bool mWorldMatrixDirty;
         mutable bool mViewMatrixDirty;
@@ -109,6 +129,34 @@ namespace Ogre {
         mutable bool mSceneDepthRangeDirty;
         mutable bool mLodCameraPositionDirty;
         mutable bool mLodCameraPositionObjectSpaceDirty;
+        mutable bool mTransposeWorldMatrixDirty;
+        mutable bool mTransposeWorldViewMatrixDirty;
+        mutable bool mTransposeWorldViewProjMatrixDirty;
+        mutable bool mInverseWorldViewProjMatrixDirty;
+        mutable bool mInverseTransposeWorldViewProjMatrixDirty;
+        mutable bool mTransposeViewMatrixDirty;
+        mutable bool mInverseTransposeViewMatrixDirty;
+        mutable bool mTransposeProjectionMatrixDirty;
+        mutable bool mInverseProjectionMatrixDirty;
+        mutable bool mInverseTransposeProjectionMatrixDirty;
+        mutable bool mTransposeViewProjMatrixDirty;
+        mutable bool mInverseViewProjMatrixDirty;
+        mutable bool mInverseTransposeViewProjMatrixDirty;
+        /// Whether the view matrix is the one of a renderable using an identity view
+        bool mIdentityView;
+        /// Whether the projection matrix is the one of a renderable using an identity projection
+        bool mIdentityProjection;
+
+        /// Versions of the information, see getVariabilityVersion
+        uint64 mGlobalVersion;
+        uint64 mPerObjectVersion;
+        uint64 mLightsVersion;
+        /** Last version given out, shared by all the data sources.
+        @remarks
+            Atomic since data sources may be used on several threads at once; 64
+            bits so that it doesn't wrap around to 0 in any realistic run time.
+        */
+        static AtomicScalar<uint64> msLastVersion;
 
         const Renderable* mCurrentRenderable;
         const Camera* mCurrentCamera;
@@ -123,6 +171,15 @@ namespace Ogre {
         const Pass* mCurrentPass;
 
         Light mBlankLight;
+
+        /// Marks everything derived from the world matrices as dirty
+        void markWorldMatricesDirty(void);
+        /// Marks everything derived from the view matrix as dirty
+        void markViewMatrixDirty(void);
+        /// Marks everything derived from the projection matrix as dirty
+        void markProjectionMatrixDirty(void);
+        /// Gives new versions to the information of the given variability (a GpuParamVariability mask)
+        void markChanged(uint16 variability);
     public:
         AutoParamDataSource();
         virtual ~AutoParamDataSource();
@@ -212,19 +269,19 @@ namespace Ogre {
         virtual const Vector4& getSceneDepthRange() const;
         virtual const Vector4& getShadowSceneDepthRange(size_t index) const;
         virtual const ColourValue& getShadowColour() const;
-        virtual Matrix4 getInverseViewProjMatrix(void) const;
-        virtual Matrix4 getInverseTransposeViewProjMatrix() const;
-        virtual Matrix4 getTransposeViewProjMatrix() const;
-        virtual Matrix4 getTransposeViewMatrix() const;
-        virtual Matrix4 getInverseTransposeViewMatrix() const;
-        virtual Matrix4 getTransposeProjectionMatrix() const;
-        virtual Matrix4 getInverseProjectionMatrix() const;
-        virtual Matrix4 getInverseTransposeProjectionMatrix() const;
-        virtual Matrix4 getTransposeWorldViewProjMatrix() const;
-        virtual Matrix4 getInverseWorldViewProjMatrix() const;
-        virtual Matrix4 getInverseTransposeWorldViewProjMatrix() const;
-        virtual Matrix4 getTransposeWorldViewMatrix() const;
-        virtual Matrix4 getTransposeWorldMatrix() const;
+        virtual const Matrix4& getInverseViewProjMatrix(void) const;
+        virtual const Matrix4& getInverseTransposeViewProjMatrix() const;
+        virtual const Matrix4& getTransposeViewProjMatrix() const;
+        virtual const Matrix4& getTransposeViewMatrix() const;
+        virtual const Matrix4& getInverseTransposeViewMatrix() const;
+        virtual const Matrix4& getTransposeProjectionMatrix() const;
+        virtual const Matrix4& getInverseProjectionMatrix() const;
+        virtual const Matrix4& getInverseTransposeProjectionMatrix() const;
+        virtual const Matrix4& getTransposeWorldViewProjMatrix() const;
+        virtual const Matrix4& getInverseWorldViewProjMatrix() const;
+        virtual const Matrix4& getInverseTransposeWorldViewProjMatrix() const;
+        virtual const Matrix4& getTransposeWorldViewMatrix() const;
+        virtual const Matrix4& getTransposeWorldMatrix() const;
         virtual Real getTime(void) const;
         virtual Real getTime_0_X(Real x) const;
         virtual Real getCosTime_0_X(Real x) const;
@@ -257,6 +314,18 @@ namespace Ogre {
         virtual void setPassNumber(const int passNumber);
         virtual void incPassNumber(void);
         virtual void updateLightCustomGpuParameter(const GpuProgramParameters::AutoConstantEntry& constantEntry, GpuProgramParameters *params) const;
+
+        /** Gets the version of the information used by the auto constants of a variability.
+        @remarks
+            The version changes whenever the information may have changed, is never 0 and
+            is never shared by two data sources. GpuProgramParameters uses it to skip 
+            the constants which are already up to date.
+        @par
+            The constants varying globally also depend on the current pass, which is not
+            part of their version.
+        @param variability One of GPV_GLOBAL, GPV_PER_OBJECT or GPV_LIGHTS.
+        */
+        uint64 getVariabilityVersion(GpuParamVariability variability) const;
     };
     /** @} */
     /** @} */
@@ -0,0 +1,278 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BakedNodeAnimation_H__
+#define __BakedNodeAnimation_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreAnimationState.h"
+#include "OgreVector3.h"
+#include "OgreQuaternion.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Contiguous copy of the keyframes of the node tracks of an animation.
+    @remarks
+        The keyframe times, translations, rotations and scales of every track
+        are stored in separate arrays, one track after the other, instead of
+        in individually allocated TransformKeyFrame objects. Evaluation looks
+        up the keyframes of each track from a cursor remembering the previous
+        ones, which is O(1) for forward playback, and interpolates the tracks
+        in batches with OptimisedUtil::interpolateNodeKeyFrames.
+    @par
+        Results are identical to those of NodeAnimationTrack::applyToNode with
+        linear interpolation. Animation owns and maintains an instance of this
+        class, see Animation::setUseBakedNodeTracks.
+    @par
+        The keyframes may also be held compressed, see bakeCompressed. The
+        compressed tracks are then the only copy of the keyframes; this is how
+        Animation::compressNodeTracks stores them.
+    */
+    class _OgreExport BakedNodeAnimation : public AnimationAlloc
+    {
+    public:
+        /** Keyframes of a compressed track.
+        @remarks
+            Rotations are stored as their three smallest components, quantised
+            to 15 bits each; the spare top bits hold the index of the largest
+            component and the sign of the quaternion. Translations and scales are
+            quantised to 16 bits per component over the range of the track.
+            Rebasing a track (see _applyBaseKeyFrame) shifts those ranges and
+            keeps a rotation applied before the quantised ones, so the keyframes
+            are not quantised again.
+        */
+        struct CompressedTrack
+        {
+            unsigned short handle;
+            unsigned short numKeyFrames;
+            /// Whether the track stores scales, otherwise they are all UNIT_SCALE
+            bool hasScale;
+            /// Translations are translateMin + quantised value * translateStep
+            Vector3 translateMin;
+            Vector3 translateStep;
+            /// Scales are scaleMin + quantised value * scaleStep
+            Vector3 scaleMin;
+            Vector3 scaleStep;
+            /// Whether rotations are rotationBase * quantised rotation
+            bool hasRotationBase;
+            Quaternion rotationBase;
+            /// numKeyFrames keyframe times
+            Real* times;
+            /// 3 * numKeyFrames quantised rotation components
+            uint16* rotations;
+            /// 3 * numKeyFrames quantised translation components
+            uint16* translations;
+            /// 3 * numKeyFrames quantised scale components, null without scales
+            uint16* scales;
+        };
+
+        BakedNodeAnimation();
+        ~BakedNodeAnimation();
+
+        /** Copies the keyframes of all node tracks of an animation, replacing
+            any previous contents. */
+        void bake(const Animation* animation);
+
+        /** Compresses the keyframes of all node tracks of an animation,
+            replacing any previous contents.
+        @remarks
+            Keyframes which linear interpolation of their neighbours reproduces
+            within the given tolerances are dropped, except for the first and
+            last keyframe of each track; the remaining ones are quantised (see
+            CompressedTrack). Quantisation adds an error of around 1e-4 radians
+            to rotations and 1/65535 of the range of the track to translations
+            and scales.
+        @param animation The animation whose node tracks to compress.
+        @param positionTolerance Largest distance allowed between a dropped
+            translation and its interpolated value.
+        @param rotationTolerance Largest angle allowed between a dropped
+            rotation and its interpolated value.
+        @param scaleTolerance Largest difference allowed between a dropped
+            scale and its interpolated value.
+        */
+        void bakeCompressed(const Animation* animation, Real positionTolerance,
+            const Radian& rotationTolerance, Real scaleTolerance);
+
+        /** Releases all keyframes. */
+        void clear(void);
+
+        /** Gets whether the keyframes are held compressed. */
+        bool isCompressed(void) const { return mCompressed; }
+
+        /** Gets the number of tracks with keyframes. */
+        size_t getNumTracks(void) const { return mTracks.size(); }
+
+        /** Gets the total number of keyframes. */
+        size_t getNumKeyFrames(void) const { return mTimes.size(); }
+
+        /** Gets the index of the track with the given handle, or getNumTracks()
+            if there is none. */
+        size_t findTrack(unsigned short handle) const;
+
+        /** Gets the handle of a track. */
+        unsigned short getTrackHandle(size_t trackIndex) const { return mTracks[trackIndex].handle; }
+
+        /** Gets the number of keyframes of a track. */
+        unsigned short getNumKeyFrames(size_t trackIndex) const { return mTracks[trackIndex].numKeyFrames; }
+
+        /** Gets a keyframe of a track, decoded if the track is compressed. */
+        void getKeyFrame(size_t trackIndex, unsigned short keyIndex, Real& time,
+            Vector3& translate, Quaternion& rotation, Vector3& scale) const;
+
+        /** Interpolates a track at a time, as NodeAnimationTrack::getInterpolatedKeyFrame
+            does with linear interpolation.
+        @param trackIndex The index of the track.
+        @param timePos The time position, already wrapped into the animation length.
+        @param kf Receives the interpolated transform.
+        */
+        void getInterpolatedKeyFrame(size_t trackIndex, Real timePos, TransformKeyFrame* kf) const;
+
+        /** Gets the number of bytes used by the keyframes. */
+        size_t calculateSize(void) const;
+
+        /** Applies the tracks to the bones of a skeleton or to nodes.
+        @remarks
+            Same as Animation::apply, with linear interpolation. Compressed
+            tracks are applied even if their NodeAnimationTrack has a listener.
+        @param skeleton The skeleton to animate, or null to animate nodes.
+        @param node Without skeleton, the node to animate, or null to animate the
+            node associated with each track.
+        @param timePos The time position, already wrapped into the animation length.
+        @param weight The influence of the animation.
+        @param blendMask Optional per bone weights, modulated with weight.
+        @param scale The scale to apply to translations and scalings.
+        @param cursor Optional keyframe cursor, updated by this call.
+        */
+        void apply(Skeleton* skeleton, Node* node, Real timePos, Real weight,
+            const AnimationState::BoneBlendMask* blendMask, Real scale,
+            AnimationState::KeyFrameCursor* cursor);
+
+        /** Internal method to start compressed contents filled with
+            _addCompressedTrack, clearing any previous contents. */
+        void _initCompressed(const Animation* animation);
+
+        /** Internal method adding a compressed track with uninitialised keyframes.
+        @remarks
+            Meant for loaders reading quantised keyframes directly. The keyframe
+            pointers of the track are set on return and remain valid until the
+            next track is added.
+        @param track The node track the keyframes belong to.
+        @param data The header of the track, whose keyframe pointers are set.
+        */
+        void _addCompressedTrack(NodeAnimationTrack* track, CompressedTrack& data);
+
+        /** Internal method to get the data of a compressed track. */
+        CompressedTrack _getCompressedTrack(size_t trackIndex);
+
+        /** Internal method rebasing a compressed track on a keyframe, as
+            NodeAnimationTrack::_applyBaseKeyFrame does.
+        @remarks
+            The quantised keyframes are left as they are: translations and
+            scales are rebased through their ranges, rotations through the base
+            rotation of the track, so no precision is lost.
+        */
+        void _applyBaseKeyFrame(size_t trackIndex, const TransformKeyFrame* base);
+
+        /** Internal method removing the keyframes of a track. */
+        void _removeTrack(unsigned short handle);
+
+        /** Internal method pointing a copy at the tracks of another animation
+            with the same track handles. */
+        void _relink(const Animation* animation);
+
+    protected:
+        struct Track
+        {
+            NodeAnimationTrack* track;
+            unsigned short handle;
+            unsigned short numKeyFrames;
+            /// Index of the first keyframe in the keyframe arrays
+            size_t firstKeyFrame;
+            /// Compressed only, index of the first scale or NO_SCALE
+            size_t firstScale;
+            /// Compressed only, see CompressedTrack
+            Vector3 translateMin;
+            Vector3 translateStep;
+            Vector3 scaleMin;
+            Vector3 scaleStep;
+            bool hasRotationBase;
+            Quaternion rotationBase;
+        };
+        typedef vector<Track>::type TrackList;
+        TrackList mTracks;
+
+        /// Track::firstScale of compressed tracks without scales
+        static const size_t NO_SCALE = ~size_t(0);
+
+        /// Animation the keyframes were copied from
+        const Animation* mAnimation;
+        /// Whether the keyframes are held in the quantised arrays
+        bool mCompressed;
+
+        vector<Real>::type mTimes;
+        vector<Vector3>::type mTranslations;
+        vector<Quaternion>::type mRotations;
+        vector<Vector3>::type mScales;
+
+        /// Compressed keyframes, 3 values per keyframe
+        vector<uint16>::type mQuantisedRotations;
+        vector<uint16>::type mQuantisedTranslations;
+        vector<uint16>::type mQuantisedScales;
+
+        /** Finds the first keyframe of a track at or after a time, as the
+            lower bound search of AnimationTrack::getKeyFramesAtTime does. */
+        size_t findKeyFrame(const Track& track, Real timePos, unsigned short* cursor) const;
+
+        /** Finds the keyframes either side of a time and the interpolation
+            factor between them, as AnimationTrack::getKeyFramesAtTime does. */
+        Real findKeyFrames(const Track& track, Real timePos, unsigned short* cursor,
+            size_t& keyFrame1, size_t& keyFrame2) const;
+
+        /** Gets a keyframe given its index in the keyframe arrays. */
+        void decodeKeyFrame(const Track& track, size_t keyIndex, Vector3& translate,
+            Quaternion& rotation, Vector3& scale) const;
+
+        /// Quantises a unit quaternion to 3 values
+        static void quantiseRotation(const Quaternion& q, uint16* values);
+        /// Decodes a quaternion quantised by quantiseRotation
+        static Quaternion dequantiseRotation(const uint16* values);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -0,0 +1,92 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BlockCompression_H__
+#define __BlockCompression_H__
+
+#include "OgrePrerequisites.h"
+#include "OgrePixelFormat.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Image
+    *  @{
+    */
+    /** CPU encoder and decoder for the block compressed formats of 4x4 pixels.
+    @remarks
+        Textures generated at runtime can be compressed with this before
+        they are loaded, so that they take the memory of pre-compressed ones.
+        The encoder favours speed over quality: colours are fitted along
+        their principal axis, with one least squares refinement, and ETC1
+        blocks try every intensity table for both sub-block layouts.
+    @par
+        PixelUtil::bulkPixelConversion uses this to convert to and from the
+        supported formats, so Image, HardwarePixelBuffer::blitFromMemory and
+        the codecs accept them like any other format.
+    */
+    class _OgreExport BlockCompression
+    {
+    public:
+        /** Whether compress can encode the given format.
+        @remarks
+            PF_DXT1 (with 1 bit alpha), PF_DXT5, PF_BC4_UNORM, PF_BC5_UNORM
+            and PF_ETC1_RGB8 are supported.
+        */
+        static bool canCompress(PixelFormat format);
+
+        /// Whether decompress can decode the given format, the same as canCompress
+        static bool canDecompress(PixelFormat format);
+
+        /** Encodes an uncompressed box into a block compressed one.
+        @remarks
+            Pixels of partial blocks at the right and bottom edges are
+            replicated. BC4 encodes the red channel, BC5 the red and green ones.
+        @param src Box of any uncompressed format.
+        @param dst Box of a format supported by canCompress, of the same
+            dimensions as src, covering its whole buffer.
+        @param scheduler Scheduler to encode rows of blocks in parallel on; if
+            null, the one of the Root's work queue is used if it has one.
+        */
+        static void compress(const PixelBox& src, const PixelBox& dst, TaskScheduler* scheduler = 0);
+
+        /** Decodes a block compressed box into an uncompressed one.
+        @param src Box of a format supported by canDecompress, covering its whole buffer.
+        @param dst Box of any uncompressed format, of the same dimensions as src.
+        */
+        static void decompress(const PixelBox& src, const PixelBox& dst);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
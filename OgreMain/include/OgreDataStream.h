@@ -435,6 +435,10 @@ namespace Ogre {
         /** Get a pointer to the current position in the memory block this stream holds. */
         uchar* getCurrentPtr(void) { return mPos; }
         
+        /** @copydoc DataStream::getAsString
+        */
+        String getAsString(void);
+
         /** @copydoc DataStream::read
         */
         size_t read(void* buf, size_t count);
@@ -475,6 +479,42 @@ namespace Ogre {
         void setFreeOnClose(bool free) { mFreeOnClose = free; }
     };
 
+    /** Read-only MemoryDataStream over the contents of a file mapped into memory.
+    @remarks
+        The file is mapped rather than read, so opening it costs no copy and the
+        pages are only loaded when they are accessed. Code which is aware of
+        MemoryDataStream, such as the mesh serializer, may then use the data in
+        place through getCurrentPtr instead of reading it into buffers of its own.
+    @par
+        On platforms without file mapping the whole file is read into memory
+        instead, which behaves the same apart from the up front cost.
+    */
+    class _OgreExport MappedFileDataStream : public MemoryDataStream
+    {
+    protected:
+        /// Whether mData is a mapping of the file rather than a copy of it
+        bool mMapped;
+
+    public:
+        /** Maps a file into memory.
+        @param name The name to give the stream
+        @param fullPath The path of the file to map
+        @note Throws an exception if the file cannot be opened.
+        */
+        MappedFileDataStream(const String& name, const String& fullPath);
+
+        ~MappedFileDataStream();
+
+        /** Gets whether the data is mapped, or was read into memory because
+            mapping is not available.
+        */
+        bool isMapped(void) const { return mMapped; }
+
+        /** @copydoc DataStream::close
+        */
+        void close(void);
+    };
+
     /** Common subclass of DataStream for handling data from 
         std::basic_istream.
     */
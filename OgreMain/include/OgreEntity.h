@@ -638,6 +638,8 @@ namespace Ogre {
 
         /** @copydoc MovableObject::_notifyAttached */
         void _notifyAttached(Node* parent, bool isTagPoint = false);
+        /** @copydoc MovableObject::_notifyMoved */
+        void _notifyMoved(void);
         /** Returns the number of requests that have been made for software animation
         @remarks
             If non-zero then software animation will be performed in updateAnimation
@@ -120,7 +120,23 @@ namespace Ogre {
             return msIgnoreHidden;
         }
 
+        /// Set whether files opened read-only are mapped into memory
+        /// (see MappedFileDataStream) rather than streamed. Mapped files are
+        /// MemoryDataStream instances which loaders may use in place.
+        /// The default is true.
+        static void setUseMappedFiles(bool useMapped)
+        {
+            msUseMappedFiles = useMapped;
+        }
+
+        /// Get whether files opened read-only are mapped into memory.
+        static bool getUseMappedFiles()
+        {
+            return msUseMappedFiles;
+        }
+
         static bool msIgnoreHidden;
+        static bool msUseMappedFiles;
     };
 
     /** Specialisation of ArchiveFactory for FileSystem files. */
@@ -1502,6 +1502,33 @@ namespace Ogre {
         /// physical index for active pass iteration parameter real constant entry;
         size_t mActivePassIterationIndex;
 
+        /// A run of auto constants sharing the same variability in the update plan
+        struct AutoConstantGroup
+        {
+            uint16 variability;
+            size_t begin;
+            size_t end;
+        };
+        typedef vector<AutoConstantGroup>::type AutoConstantGroupList;
+        /** Indexes into mAutoConstants ordered by variability and then by type, so 
+            that constants are updated a group at a time and ones derived from the 
+            same information follow each other.
+        */
+        vector<size_t>::type mAutoConstantPlan;
+        /// The groups of mAutoConstantPlan
+        AutoConstantGroupList mAutoConstantGroups;
+        /// Whether mAutoConstants changed since the plan was built
+        bool mAutoConstantPlanDirty;
+        /// Versions of the global, per object and lights information the autos were last updated from
+        uint64 mAutoConstantVersions[3];
+        /// The pass the global autos were last updated for
+        const Pass* mAutoConstantPass;
+
+        /// Marks the update plan as out of date, and the autos as never updated
+        void markAutoConstantsChanged(void);
+        /// Builds the update plan from the current auto constants
+        void buildAutoConstantPlan(void);
+
         /// Return the variability for an auto constant
         uint16 deriveVariability(AutoConstantType act);
 
@@ -1978,6 +2005,8 @@ namespace Ogre {
         /** Gets a specific Auto Constant entry if index is in valid range
             otherwise returns a NULL
             @param index which entry is to be retrieved
+            @note The entry may be modified, so all autos will be updated again
+                by the next _updateAutoParams.
         */
         AutoConstantEntry* getAutoConstantEntry(const size_t index);
         /** Returns true if this instance has any automatic constants. */
@@ -2033,6 +2062,10 @@ namespace Ogre {
         const AutoConstantEntry* _findRawAutoConstantEntryBool(size_t physicalIndex);
 
         /** Update automatic parameters.
+            @remarks
+                Autos whose information has not changed since the last update, according
+                to AutoParamDataSource::getVariabilityVersion, are not written again even
+                if their variability is in the mask. 
             @param source The source of the parameters
             @param variabilityMask A mask of GpuParamVariability which identifies which autos will need updating
         */
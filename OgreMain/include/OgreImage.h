@@ -453,19 +453,53 @@ namespace Ogre {
             FILTER_BILINEAR,
             FILTER_BOX,
             FILTER_TRIANGLE,
-            FILTER_BICUBIC
+            FILTER_BICUBIC,
+            /// Kaiser windowed sinc, for generateMipmaps
+            FILTER_KAISER
         };
         /** Scale a 1D, 2D or 3D image volume. 
             @param  src         PixelBox containing the source pointer, dimensions and format
             @param  dst         PixelBox containing the destination pointer, dimensions and format
             @param  filter      Which filter to use
+            @param  scheduler   Scheduler to split large destinations into bands of rows
+                over; if null, the one of the Root's work queue is used if it has one.
             @remarks    This function can do pixel format conversion in the process.
             @note   dst and src can point to the same PixelBox object without any problem
         */
-        static void scale(const PixelBox &src, const PixelBox &dst, Filter filter = FILTER_BILINEAR);
+        static void scale(const PixelBox &src, const PixelBox &dst, Filter filter = FILTER_BILINEAR,
+            TaskScheduler* scheduler = 0);
         
         /** Resize a 2D image, applying the appropriate filter. */
-        void resize(ushort width, ushort height, Filter filter = FILTER_BILINEAR);
+        void resize(ushort width, ushort height, Filter filter = FILTER_BILINEAR,
+            TaskScheduler* scheduler = 0);
+
+        /** Generates the full mipmap chain of the image, down to 1x1.
+        @remarks
+            Each level is filtered from the previous one, halving every dimension
+            larger than 1, and existing mipmaps are replaced. The rows of a level
+            are split into bands over every face, which are filtered in parallel.
+            The image ends up owning its buffer, even if it was loaded with
+            loadDynamicImage and autoDelete false.
+        @param filter FILTER_BOX averages blocks of 2x2 pixels (2x2x2 for
+            volumes); FILTER_KAISER uses a Kaiser windowed sinc, which keeps 2D
+            images sharper. Other filters scale each level with Image::scale.
+        @param scheduler Scheduler to run the bands on; if null, the one of the
+            Root's work queue is used if it has one, otherwise the levels are
+            filtered on the calling thread.
+        @note Compressed formats aren't supported.
+        */
+        void generateMipmaps(Filter filter = FILTER_BOX, TaskScheduler* scheduler = 0);
+
+        /** Block compresses every face and mipmap of the image.
+        @remarks
+            Generate the mipmaps first, if they're wanted, as compressed images
+            can't be filtered. The image ends up owning its new buffer.
+        @param format A format supported by BlockCompression::canCompress.
+        @param scheduler Scheduler to encode rows of blocks in parallel on; if
+            null, the one of the Root's work queue is used if it has one.
+        @see BlockCompression
+        */
+        Image& compress(PixelFormat format, TaskScheduler* scheduler = 0);
         
         /// Static function to calculate size in bytes from the number of mipmaps, faces and the dimensions
         static size_t calculateSize(size_t mipmaps, size_t faces, uint32 width, uint32 height, uint32 depth, PixelFormat format);
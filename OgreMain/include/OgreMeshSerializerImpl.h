@@ -174,6 +174,12 @@ namespace Ogre {
         virtual void readPoseKeyFrame(DataStreamPtr& stream, VertexAnimationTrack* track);
         virtual void readExtremes(DataStreamPtr& stream, Mesh *pMesh);
 
+        /** Fills a newly created index buffer with the indexes which follow in the stream.
+        @remarks
+            Indexes held in memory with the native endianness are written to the
+            buffer straight from the stream, see Serializer::readInPlace.
+        */
+        void readIndexBufferData(DataStreamPtr& stream, const HardwareIndexBufferSharedPtr& ibuf);
 
         /// Flip an entire vertex buffer from little endian
         virtual void flipFromLittleEndian(void* pData, size_t vertexCount, size_t vertexSize, const VertexDeclaration::VertexElementList& elems);
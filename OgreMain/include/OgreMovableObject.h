@@ -158,6 +158,9 @@ namespace Ogre {
         /// the light mask defined for this movable. This will be taken into consideration when deciding which light should affect this movable
         uint32 mLightMask;
 
+        /// Proxy of this object in the scene query broadphase of its manager
+        uint32 mSceneQueryProxy;
+
         // Static members
         /// Default query flags
         static uint32 msDefaultQueryFlags;
@@ -184,6 +187,10 @@ namespace Ogre {
         virtual void _notifyManager(SceneManager* man) { mManager = man; }
         /** Get the manager of this object, if any (internal use only) */
         virtual SceneManager* _getManager(void) const { return mManager; }
+        /** Sets the proxy of this object in the scene query broadphase of its manager (internal use only) */
+        void _setSceneQueryProxy(uint32 proxy) { mSceneQueryProxy = proxy; }
+        /** Gets the proxy of this object in the scene query broadphase of its manager (internal use only) */
+        uint32 _getSceneQueryProxy(void) const { return mSceneQueryProxy; }
 
         /** Returns the name of this object. */
         virtual const String& getName(void) const { return mName; }
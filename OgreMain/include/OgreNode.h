@@ -201,6 +201,12 @@ namespace Ogre {
         */
         virtual void updateFromParentImpl(void) const;
 
+        /** Class-specific notification that the derived transform was recomputed.
+        @remarks
+            Called after updateFromParentImpl, or by NodeTransformArray once a
+            bulk update has completed, before the listener is notified.
+        */
+        virtual void derivedTransformUpdatedImpl(void) const {}
 
         /** Internal method for creating a new child node - must be overridden per subclass. */
         virtual Node* createChildImpl(void) = 0;
@@ -230,6 +236,8 @@ namespace Ogre {
         /// User objects binding.
         UserObjectBindings mUserObjectBindings;
 
+        friend class NodeTransformArray;
+
     public:
         /** Constructor, should only be called by parent, not directly.
         @remarks
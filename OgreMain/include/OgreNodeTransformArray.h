@@ -0,0 +1,151 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NodeTransformArray_H__
+#define __NodeTransformArray_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Depth-sorted, structure-of-arrays view of a node hierarchy used to
+        update derived transforms in bulk.
+    @remarks
+        The hierarchy below a root node is flattened into one array per depth
+        level, each holding the nodes of that level, the index of their parent
+        in the previous level and the derived transforms as separate position,
+        orientation and scale streams. Levels are updated in increasing order;
+        within a level every node only depends on data of the previous level,
+        so disjoint ranges of one level may be updated concurrently.
+    @par
+        The update reproduces Node::_update exactly: the same nodes are visited,
+        the same nodes recompute their derived transform (using
+        OptimisedUtil::concatenateNodeTransforms, which matches
+        Node::updateFromParentImpl) and the same update flags are cleared.
+        Events are raised afterwards, from a single thread, by finishUpdate.
+    @par
+        The arrays reference the nodes directly, so they must be rebuilt whenever
+        the hierarchy changes. SceneManager tracks this for the scene graph.
+    */
+    class _OgreExport NodeTransformArray : public NodeAlloc
+    {
+    public:
+        NodeTransformArray();
+        ~NodeTransformArray();
+
+        /** Rebuilds the arrays from the hierarchy below the given node. */
+        void rebuild(Node* root);
+
+        /** Releases all arrays. */
+        void clear(void);
+
+        /** Gets the number of depth levels, 0 if the arrays are empty. */
+        size_t getNumLevels(void) const { return mLevels.size(); }
+
+        /** Gets the number of nodes in the given depth level. */
+        size_t getNumNodes(size_t level) const { return mLevels[level].nodes.size(); }
+
+        /** Gets a node of the given depth level. */
+        Node* getNode(size_t level, size_t index) const { return mLevels[level].nodes[index]; }
+
+        /** Gets whether the last update reached the given node, ie. whether
+            the recursive update would have called Node::_update on it.
+        */
+        bool wasVisited(size_t level, size_t index) const
+        { return (mLevels[level].states[index] & STATE_VISITED) != 0; }
+
+        /** Updates the derived transforms of a range of nodes of a depth level.
+        @remarks
+            All previous levels must have been updated first. Ranges of the
+            same level may be updated concurrently from different threads.
+        @param level The depth level, 0 being the root.
+        @param begin, end The range of nodes within the level.
+        */
+        void updateLevel(size_t level, size_t begin, size_t end);
+
+        /** Completes an update once all levels have been updated.
+        @remarks
+            Clears the update flags of every visited node and raises the
+            notifications of the nodes whose transform changed, in depth order.
+            Must be called from a single thread.
+        */
+        void finishUpdate(void);
+
+    protected:
+        /// Per node state of the current update
+        enum StateFlags
+        {
+            /// Reached by the update
+            STATE_VISITED = 1 << 0,
+            /// Derived transform was recomputed
+            STATE_TRANSFORM_UPDATED = 1 << 1,
+            /// All children are visited and must recompute their transform
+            STATE_UPDATE_ALL_CHILDREN = 1 << 2,
+            /// Only children in Node::mChildrenToUpdate are visited
+            STATE_UPDATE_SELECTED_CHILDREN = 1 << 3
+        };
+
+        /// Number of derived transform streams per level
+        static const size_t NUM_TRANSFORM_STREAMS = 10;
+
+        struct Level
+        {
+            /// Nodes of this depth level
+            vector<Node*>::type nodes;
+            /// Index of the parent of each node in the previous level
+            vector<uint32>::type parents;
+            /// StateFlags of each node for the current update
+            vector<uint8>::type states;
+            /// NUM_TRANSFORM_STREAMS streams of 'stride' values, SIMD aligned
+            Real* transforms;
+            /// Distance between two streams, multiple of 4
+            size_t stride;
+        };
+        typedef vector<Level>::type LevelList;
+        LevelList mLevels;
+
+        /// Recomputes the transform of the given nodes of a level
+        void updateTransforms(Level& level, const Level* parentLevel,
+            const uint32* indices, size_t count);
+        /// Copies the current derived transform of a node into the level streams
+        void storeTransform(Level& level, size_t index, const Node* node);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -203,6 +203,69 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) = 0;
+
+        /** Combines a batch of node local transforms with the derived
+            transforms of their parents.
+        @remarks
+            This is the structure-of-arrays form of Node::updateFromParentImpl
+            and evaluates the same expressions in the same order, so the results
+            are identical to those of the per-node path.
+        @par
+            Each block holds a number of streams, each of which is an array of
+            numNodes values placed 'stride' values after the previous stream.
+            The transform streams are, in order: position x, y, z, orientation
+            w, x, y, z and scale x, y, z.
+        @param parentTransforms Block of 10 streams holding the derived
+            transforms of the parents.
+        @param localTransforms Block of 12 streams holding the local transforms,
+            followed by a stream which is 1 where the node inherits orientation
+            and 0 otherwise, and a stream which is 1 where the node inherits
+            scale and 0 otherwise.
+        @param derivedTransforms Block of 10 streams receiving the derived
+            transforms.
+        @param stride Distance between two streams, in values. Must be a
+            multiple of 4.
+        @param numNodes Number of nodes to process, must not exceed stride.
+        @note
+            All blocks must be aligned to SIMD alignment.
+        */
+        virtual void concatenateNodeTransforms(
+            const Real* parentTransforms,
+            const Real* localTransforms,
+            Real* derivedTransforms,
+            size_t stride,
+            size_t numNodes) = 0;
+
+        /** Linearly interpolates a batch of node keyframe pairs.
+        @remarks
+            This is the structure-of-arrays form of the linear interpolation
+            done by NodeAnimationTrack::getInterpolatedKeyFrame with
+            Animation::RIM_LINEAR rotations: positions and scales are
+            interpolated linearly and rotations with Quaternion::nlerp. Where
+            the parameter is zero the first keyframe is returned unchanged. The
+            results are identical to those of the per-track path.
+        @par
+            The keyframe blocks use the stream layout of concatenateNodeTransforms.
+        @param keyFrames1 Block of 10 streams holding the first keyframes.
+        @param keyFrames2 Block of 10 streams holding the second keyframes.
+        @param params Block of 2 streams, the interpolation parameters
+            followed by a stream which is 1 where rotations take the shortest
+            path and 0 otherwise.
+        @param transforms Block of 10 streams receiving the interpolated
+            keyframes.
+        @param stride Distance between two streams, in values. Must be a
+            multiple of 4.
+        @param numNodes Number of keyframe pairs to process, must not exceed stride.
+        @note
+            All blocks must be aligned to SIMD alignment.
+        */
+        virtual void interpolateNodeKeyFrames(
+            const Real* keyFrames1,
+            const Real* keyFrames2,
+            const Real* params,
+            Real* transforms,
+            size_t stride,
+            size_t numNodes) = 0;
     };
 
     /** Returns raw offseted of the given pointer.
@@ -110,6 +110,35 @@ namespace Ogre {
         */
         virtual void _affectParticles(ParticleSystem* pSystem, Real timeElapsed) = 0;
 
+        /** Method called instead of _affectParticles when the system keeps its particles
+            in contiguous storage (see ParticleSystem::setContiguousParticleStorage).
+        @remarks
+            The affector may process the streams as arrays, which is what this method is
+            for. The streams hold up to date values on entry; anything written to them is
+            picked up by the system. It is only called if _supportsParticleStreams returns
+            true. The default implementation calls _affectParticles, which remains correct
+            since the system synchronises the Particle instances when they are iterated.
+        @param
+            pSystem Pointer to a ParticleSystem to affect.
+        @param
+            timeElapsed The number of seconds which have elapsed since the last call.
+        @param
+            streams The live particles of the system.
+        */
+        virtual void _affectParticleStreams(ParticleSystem* pSystem, Real timeElapsed, ParticleStreams& streams)
+        {
+            (void)streams;
+            _affectParticles(pSystem, timeElapsed);
+        }
+
+        /** Returns whether this affector implements _affectParticleStreams.
+        @remarks
+            Affectors which don't are run through _affectParticles, so that the
+            system only copies the particles out of contiguous storage once for
+            any number of them in a row.
+        */
+        virtual bool _supportsParticleStreams(void) const { return false; }
+
         /** Returns the name of the type of affector. 
         @remarks
             This property is useful for determining the type of affector procedurally so another
@@ -0,0 +1,150 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ParticleStreams_H__
+#define __ParticleStreams_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Effects
+    *  @{
+    */
+    /** Structure-of-arrays storage of the live particles of a ParticleSystem.
+    @remarks
+        The simulated state of each particle (position, direction, colour,
+        time to live, rotation and dimensions) is kept in separate, densely packed streams with one
+        slot per live particle, so the per frame updates become simple loops
+        over arrays. Particles are removed by moving the last slot into the
+        hole, so slots are not kept in any particular order.
+    @par
+        Each slot also references the Particle instance it belongs to. The
+        streams and the instances are only synchronised on request, see
+        loadParticles and storeParticles; ParticleSystem does this whenever
+        the instances are exposed through its regular interface.
+    */
+    class _OgreExport ParticleStreams : public FXAlloc
+    {
+    public:
+        /// Streams held for each particle
+        enum Stream
+        {
+            PS_POSITION_X,
+            PS_POSITION_Y,
+            PS_POSITION_Z,
+            PS_DIRECTION_X,
+            PS_DIRECTION_Y,
+            PS_DIRECTION_Z,
+            PS_COLOUR_R,
+            PS_COLOUR_G,
+            PS_COLOUR_B,
+            PS_COLOUR_A,
+            PS_TIME_TO_LIVE,
+            PS_TOTAL_TIME_TO_LIVE,
+            PS_ROTATION,
+            PS_ROTATION_SPEED,
+            PS_WIDTH,
+            PS_HEIGHT,
+            /// 1 if the particle has its own dimensions, 0 otherwise
+            PS_OWN_DIMENSIONS,
+
+            PS_COUNT
+        };
+
+        ParticleStreams();
+        ~ParticleStreams();
+
+        /** Gets the number of particles stored. */
+        size_t size(void) const { return mParticles.size(); }
+
+        /** Returns true if no particle is stored. */
+        bool empty(void) const { return mParticles.empty(); }
+
+        /** Gets one of the streams.
+        @remarks
+            The stream holds size() values and is aligned to SIMD alignment;
+            the storage is padded so that it may be processed in groups of 4.
+            The pointer is invalidated by add and reserve.
+        */
+        Real* getStream(Stream stream) { return mData + stream * mCapacity; }
+
+        /** Gets one of the streams. */
+        const Real* getStream(Stream stream) const { return mData + stream * mCapacity; }
+
+        /** Gets the Particle instance of a slot. */
+        Particle* getParticle(size_t index) const { return mParticles[index]; }
+
+        /** Gets the Particle instances of all slots, in slot order. */
+        const vector<Particle*>::type& getParticles(void) const { return mParticles; }
+
+        /** Appends a slot for a particle, initialised from the instance.
+        @return The index of the new slot.
+        */
+        size_t add(Particle* particle);
+
+        /** Removes a slot by moving the last slot into it. */
+        void remove(size_t index);
+
+        /** Removes all slots. */
+        void clear(void);
+
+        /** Ensures storage for the given number of particles. */
+        void reserve(size_t capacity);
+
+        /** Copies the state of the Particle instance of a slot into the streams. */
+        void loadParticle(size_t index);
+
+        /** Copies the state of the Particle instances of all slots into the streams. */
+        void loadParticles(void);
+
+        /** Copies the state held by the streams into the Particle instance of a slot. */
+        void storeParticle(size_t index) const;
+
+        /** Copies the state held by the streams into the Particle instances of all slots. */
+        void storeParticles(void) const;
+
+    protected:
+        /// Particle instance of each slot
+        vector<Particle*>::type mParticles;
+        /// PS_COUNT streams of mCapacity values
+        Real* mData;
+        /// Number of slots allocated, multiple of 4
+        size_t mCapacity;
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -143,6 +143,13 @@ namespace Ogre {
             String doGet(const void* target) const;
             void doSet(void* target, const String& val);
         };
+        /** Command object for contiguous storage (see ParamCommand).*/
+        class CmdContiguousStorage : public ParamCommand
+        {
+        public:
+            String doGet(const void* target) const;
+            void doSet(void* target, const String& val);
+        };
 
         /// Default constructor required for STL creation in manager
         ParticleSystem();
@@ -567,6 +574,24 @@ namespace Ogre {
         /// Gets whether particles are sorted relative to the camera.
         bool getSortingEnabled(void) const { return mSorted; }
 
+        /** Sets whether the live particles are simulated in contiguous arrays.
+        @remarks
+            By default the live particles are kept in a linked list and every
+            update visits them through it. When this is enabled, the position,
+            direction, colour and time to live of the live particles are also
+            kept in ParticleStreams, in contiguous arrays with one slot per
+            particle, and expiry and motion are applied to those arrays. This
+            is much faster for systems with many particles.
+        @par
+            The Particle instances remain available through _getIterator and
+            getParticle, so existing affectors and renderers keep working; they
+            are brought up to date whenever they are exposed, which costs an
+            extra pass over the particles.
+        */
+        void setContiguousParticleStorage(bool enabled);
+        /// Gets whether the live particles are simulated in contiguous arrays.
+        bool getContiguousParticleStorage(void) const { return mParticleStreams != 0; }
+
         /** Set the (initial) bounds of the particle system manually. 
         @remarks
             If you can, set the bounds of a particle system up-front and 
@@ -661,6 +686,7 @@ namespace Ogre {
         static CmdLocalSpace msLocalSpaceCmd;
         static CmdIterationInterval msIterationIntervalCmd;
         static CmdNonvisibleTimeout msNonvisibleTimeoutCmd;
+        static CmdContiguousStorage msContiguousStorageCmd;
 
 
         AxisAlignedBox mAABB;
@@ -812,6 +838,20 @@ namespace Ogre {
         /// The number of emitted emitters in the pool.
         size_t mEmittedEmitterPoolSize;
 
+        /** Contiguous storage of the live particles, if enabled.
+        @remarks
+            When present, the slots hold the same particles as mActiveParticles
+            and the list keeps one node per slot, but the values of the nodes
+            are only refreshed on demand.
+        */
+        ParticleStreams* mParticleStreams;
+        /// The streams were changed after the Particle instances
+        bool mParticlesOutOfDate;
+        /// The Particle instances may have been changed after the streams
+        bool mParticleStreamsOutOfDate;
+        /// The slots changed since mActiveParticles was filled
+        bool mActiveParticleListOutOfDate;
+
         /// Optional origin of this particle system (eg script name)
         String mOrigin;
 
@@ -836,6 +876,26 @@ namespace Ogre {
         /** Applies the effects of affectors. */
         void _triggerAffectors(Real timeElapsed);
 
+        /** Contiguous storage version of _expire. */
+        void _expireStreams(Real timeElapsed);
+
+        /** Contiguous storage version of _applyMotion. */
+        void _applyMotionStreams(Real timeElapsed);
+
+        /** Brings the Particle instances and mActiveParticles up to date with
+            the contiguous storage.
+        */
+        void updateParticlesFromStreams(void);
+
+        /** Takes a particle from the free list without synchronising the contiguous storage. */
+        Particle* createParticleImpl(void);
+
+        /** Takes an emitter particle from the free list without synchronising the contiguous storage. */
+        Particle* createEmitterParticleImpl(const String& emitterName);
+
+        /** Brings the contiguous storage up to date with the Particle instances. */
+        void updateStreamsFromParticles(void);
+
         /** Sort the particles in the system **/
         void _sortParticles(Camera* cam);
 
@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "OgreLight.h"
 #include "OgreTextureUnitState.h"
 #include "OgreUserObjectBindings.h"
+#include "OgreAtomicScalar.h"
 
 namespace Ogre {
 
@@ -244,6 +245,14 @@ namespace Ogre {
         mutable uint32 mRenderStateHash;
         // Tells whether to recalcualte render state hash
         mutable bool mRenderStateHashDirty;
+        /// Counts the changes which may affect the render state, see getRenderStateChangeCount
+        uint32 mRenderStateChangeCount;
+        /// Hashed GPU program names, for getRenderStateKey
+        uint16 mProgramSortHash;
+        /// Hashed texture names, for getRenderStateKey
+        uint16 mTextureSortHash;
+        /// Unique identifier, see getId
+        uint32 mId;
 
 
         /// Used to get scene blending flags from a blending type
@@ -258,6 +267,8 @@ namespace Ogre {
         static PassSet msPassGraveyard;
         /// The Pass hash functor
         static HashFunc* msHashFunc;
+        /// Last identifier given to a Pass
+        static AtomicScalar<uint32> msLastId;
     public:
         OGRE_STATIC_MUTEX(msDirtyHashListMutex);
         OGRE_STATIC_MUTEX(msPassGraveyardMutex);
@@ -300,6 +311,44 @@ namespace Ogre {
 
         const uint32 getRenderStateHash() const;
 
+        /** Gets a number which changes whenever the pass changes in a way which
+            may affect the render state.
+        @remarks
+            Unlike getRenderStateHash this also changes when the texture units
+            change, and is cheap to get; the SceneManager uses it to find passes
+            which need not be set again.
+        */
+        uint32 getRenderStateChangeCount(void) const { return mRenderStateChangeCount; }
+
+        /** Gets a key ordering passes so as to minimise render state changes.
+        @remarks
+            The key is divided as follows (high to low bits):
+        @code
+            bits   purpose
+             4     Pass index (so that all passes are rendered in order)
+            14     Hashed GPU program names
+            14     Hashed texture names
+             8     Hashed blending, depth, colour write and alpha reject state
+            24     Zero, for users of the key to fill in
+        @endcode
+            The texture names come before the program names unless the hash
+            function is MIN_GPU_PROGRAM_CHANGE. Program and texture hashes are
+            updated along with the pass hash.
+        @par
+            If a custom hash function is set (see setHashFunction), the top 32
+            bits are the pass hash instead of the index, program and texture
+            fields, so that passes are ordered as the custom function wants.
+        */
+        uint64 getRenderStateKey(void) const;
+
+        /** Gets a number identifying this Pass.
+        @remarks
+            Unlike the hash, no two passes created in the same process get the
+            same identifier (until 2^32 passes have been created); copies of a 
+            pass get their own identifier.
+        */
+        uint32 getId(void) const { return mId; }
+
         /// Gets the index of this Pass in the parent Technique
         unsigned short getIndex(void) const { return mIndex; }
         /* Set the name of the pass
@@ -1742,6 +1791,9 @@ namespace Ogre {
             @note
             You can also use one of the built-in hash functions, see the alternate version
             of this method. The default is MIN_TEXTURE_CHANGE.
+            @par
+            Pass grouped render queues order passes by this hash, passes with
+            equal hashes by their blending and depth state, see getRenderStateKey.
             @see HashFunc
         */
         static void setHashFunction(HashFunc* hashFunc) { msHashFunc = hashFunc; }
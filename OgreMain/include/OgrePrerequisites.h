@@ -148,6 +148,7 @@ namespace Ogre {
     class AutoParamDataSource;
     class AxisAlignedBox;
     class AxisAlignedBoxSceneQuery;
+    class Barrier;
     class Billboard;
     class BillboardChain;
     class BillboardSet;
@@ -225,6 +226,7 @@ namespace Ogre {
     class Node;
     class NodeAnimationTrack;
     class NodeKeyFrame;
+    class NodeTransformArray;
     class NumericAnimationTrack;
     class NumericKeyFrame;
     class Particle;
@@ -232,6 +234,7 @@ namespace Ogre {
     class ParticleAffectorFactory;
     class ParticleEmitter;
     class ParticleEmitterFactory;
+    class ParticleStreams;
     class ParticleSystem;
     class ParticleSystemManager;
     class ParticleSystemRenderer;
@@ -280,6 +283,7 @@ namespace Ogre {
     class SceneManagerEnumerator;
     class SceneNode;
     class SceneQuery;
+    class SceneQueryBroadphase;
     class SceneQueryListener;
     class ScriptCompiler;
     class ScriptCompilerManager;
@@ -294,6 +298,8 @@ namespace Ogre {
     class Skeleton;
     class SkeletonInstance;
     class SkeletonManager;
+    class SoftwareSkinningBatch;
+    class SpatialLightIndex;
     class Sphere;
     class SphereSceneQuery;
     class StaticGeometry;
@@ -303,6 +309,7 @@ namespace Ogre {
     class SubEntity;
     class SubMesh;
     class TagPoint;
+    class TaskScheduler;
     class Technique;
     class TempBlendedBufferInfo;
     class ExternalTextureSource;
@@ -82,7 +82,11 @@ namespace Ogre {
         implementation can handle both unsigned and signed integers, as well as
         floats (which are often not supported by other radix sorters). doubles
         are not supported; you will need to implement your functor object to convert
-        to float if you wish to use this sort routine.
+        to float if you wish to use this sort routine. Unsigned 64-bit integers are
+        supported too, which allows sorting on several fields packed into one key.
+    @par
+        Bytes which are the same for all the values are skipped, so keys with
+        fields which rarely differ cost little more than smaller ones.
     */
     template <class TContainer, class TContainerValueType, typename TCompValueType>
     class RadixSort
@@ -91,8 +95,8 @@ namespace Ogre {
         typedef typename TContainer::iterator ContainerIter;
     protected:
         /// Alpha-pass counters of values (histogram)
-        /// 4 of them so we can radix sort a maximum of a 32bit value
-        int mCounters[4][256];
+        /// 8 of them so we can radix sort a maximum of a 64bit value
+        int mCounters[8][256];
         /// Beta-pass offsets 
         int mOffsets[256];
         /// Sort area size
@@ -300,23 +304,32 @@ namespace Ogre {
             mSrc = &mSortArea1;
             mDest = &mSortArea2;
 
-            for (p = 0; p < mNumPasses - 1; ++p)
+            for (p = 0; p < mNumPasses; ++p)
             {
-                sortPass(p);
+                // Skip bytes which are the same for every value, they don't change the
+                // order; except the final one, which reverses negative floats
+                if (p < mNumPasses - 1 && mCounters[p][getByte(p, mSortArea1[0].key)] == mSortSize)
+                    continue;
+
+                if (p < mNumPasses - 1)
+                    sortPass(p);
+                else
+                {
+                    // Final pass may differ, make polymorphic
+                    finalPass(p, prevValue);
+                }
                 // flip src/dst
                 SortVector* tmp = mSrc;
                 mSrc = mDest;
                 mDest = tmp;
             }
-            // Final pass may differ, make polymorphic
-            finalPass(p, prevValue);
 
-            // Copy everything back
+            // Copy everything back, the last pass wrote to what is now the source
             int c = 0;
             for (i = container.begin(); 
                 i != container.end(); ++i, ++c)
             {
-                *i = *((*mDest)[c].iter);
+                *i = *((*mSrc)[c].iter);
             }
         }
 
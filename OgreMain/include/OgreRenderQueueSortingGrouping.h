@@ -131,23 +131,39 @@ namespace Ogre {
         };
 
     protected:
-        /// Comparator to order pass groups
-        struct PassGroupLess
+        /** Entry in the pass grouped list.
+        @remarks
+            Entries are ordered by the key, which is Pass::getRenderStateKey,
+            then by the pass identifier (so that passes with the same state
+            still group together) and then by view depth (so that each group
+            is drawn front to back).
+        */
+        struct PassGroupEntry
         {
-            bool _OgreExport operator()(const Pass* a, const Pass* b) const
+            /// Sort key
+            uint64 key;
+            /// Pass::getId
+            uint32 passId;
+            /// Top bits of the (positive) view depth, which order like the depth
+            uint16 depth;
+            /// Pointer to the Pass
+            Pass* pass;
+            /// Pointer to the Renderable details
+            Renderable* renderable;
+
+            PassGroupEntry(uint64 k, Pass* p, Renderable* rend) 
+                : key(k), passId(p->getId()), depth(0), pass(p), renderable(rend) {}
+        };
+        /// Comparator to order pass group entries by key, pass and depth
+        struct PassGroupKeyLess
+        {
+            bool operator()(const PassGroupEntry& a, const PassGroupEntry& b) const
             {
-                // Sort by passHash, which is pass, then texture unit changes
-                uint32 hasha = a->getHash();
-                uint32 hashb = b->getHash();
-                if (hasha == hashb)
-                {
-                    // Must differentTransparentQueueItemLessiate by pointer incase 2 passes end up with the same hash
-                    return a < b;
-                }
-                else
-                {
-                    return hasha < hashb;
-                }
+                if (a.key != b.key)
+                    return a.key < b.key;
+                if (a.passId != b.passId)
+                    return a.passId < b.passId;
+                return a.depth < b.depth;
             }
         };
         /// Comparator to order objects by descending camera distance
@@ -191,9 +207,9 @@ namespace Ogre {
          vectors only ever increase in size, so even if we do clear() the memory stays
          allocated, ie fast */
         typedef vector<RenderablePass>::type RenderablePassList;
-        typedef vector<Renderable*>::type RenderableList;
-        /** Map of pass to renderable lists, this is a grouping by pass. */
-        typedef map<Pass*, RenderableList*, PassGroupLess>::type PassGroupRenderableMap;
+        /** Vector of renderables with their passes and sort keys, this is a
+         grouping by pass once sorted. */
+        typedef vector<PassGroupEntry>::type PassGroupEntryList;
 
         /// Functor for accessing sort value 1 for radix sort (Pass)
         struct RadixSortFunctorPass
@@ -228,11 +244,32 @@ namespace Ogre {
         /// Radix sorter for sort value 2 (distance)
         static RadixSort<RenderablePassList, RenderablePass, float> msRadixSorter2;
 
+        /// Functor for accessing the pass group sort key for radix sort
+        struct RadixSortFunctorKey
+        {
+            uint64 operator()(const PassGroupEntry& e) const
+            {
+                return e.key;
+            }
+        };
+
+        /// Functor for accessing the pass group pass and depth for radix sort
+        struct RadixSortFunctorPassDepth
+        {
+            uint64 operator()(const PassGroupEntry& e) const
+            {
+                return (static_cast<uint64>(e.passId) << 16) | e.depth;
+            }
+        };
+
+        /// Radix sorter for the pass group entries
+        static RadixSort<PassGroupEntryList, PassGroupEntry, uint64> msRadixSorter3;
+
         /// Bitmask of the organisation modes requested
         uint8 mOrganisationMode;
 
-        /// Grouped 
-        PassGroupRenderableMap mGrouped;
+        /// Grouped (once sorted)
+        PassGroupEntryList mGrouped;
         /// Sorted descending (can iterate backwards to get ascending)
         RenderablePassList mSortedDescending;
 
@@ -250,7 +287,7 @@ namespace Ogre {
         /// Empty the collection
         void clear(void);
 
-        /** Remove the group entry (if any) for a given Pass.
+        /** Remove the group entries (if any) for a given Pass.
         @remarks
             To be used when a pass is destroyed, such that any
             grouping level for it becomes useless.
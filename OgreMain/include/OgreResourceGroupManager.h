@@ -306,8 +306,18 @@ namespace Ogre {
 
         ResourceLoadingListener *mLoadingListener;
 
+        /// Number of threads preparing scripts, see setNumScriptParsingThreads
+        size_t mNumScriptParsingThreads;
+
         /// Resource index entry, resourcename->location 
-        typedef map<String, Archive*>::type ResourceLocationIndex;
+        typedef OGRE_HashMap<String, Archive*> ResourceLocationIndex;
+        /// A resource read ahead by prefetchResources
+        struct PrefetchedResource
+        {
+            Archive* archive;
+            DataStreamPtr stream;
+        };
+        typedef OGRE_HashMap<String, PrefetchedResource> PrefetchedResourceMap;
 
         /// List of resources which can be loaded / unloaded
         typedef list<ResourcePtr>::type LoadUnloadResourceList;
@@ -336,6 +346,8 @@ namespace Ogre {
             ResourceLocationIndex resourceIndexCaseSensitive;
             /// Index of resource names to locations, built for speedy access (case insensitive archives)
             ResourceLocationIndex resourceIndexCaseInsensitive;
+            /// Resources read ahead by prefetchResources, each handed out once by openResource
+            PrefetchedResourceMap prefetchedResources;
             /// Pre-declared resources, ready to be created
             ResourceDeclarationList resourceDeclarations;
             /// Created resources which are ready to be loaded / unloaded
@@ -353,6 +365,12 @@ namespace Ogre {
             void addToIndex(const String& filename, Archive* arch);
             void removeFromIndex(const String& filename, Archive* arch);
             void removeFromIndex(Archive* arch);
+            /** Looks a resource up in the indexes, returns 0 if it isn't indexed
+            @param filename The name of the resource
+            @param lcaseFilename The name in lower case, set by the first lookup
+                needing it when empty, so lookups in several groups fold it once
+            */
+            Archive* findInIndex(const String& filename, String& lcaseFilename) const;
 
         };
         /// Map from resource group names to groups
@@ -368,6 +386,14 @@ namespace Ogre {
             Called as part of initialiseResourceGroup
         */
         void parseResourceGroupScripts(ResourceGroup* grp);
+        /// A script to parse and the loader parsing it
+        typedef std::pair<ScriptLoader*, const FileInfo*> ScriptLoaderFile;
+        typedef vector<ScriptLoaderFile>::type ScriptLoaderFileVector;
+        /** Parses the given scripts, preparing them on several threads first.
+        @remarks
+            Called as part of parseResourceGroupScripts, see setNumScriptParsingThreads
+        */
+        void parseScriptsParallel(ResourceGroup* grp, const ScriptLoaderFileVector& scriptFiles);
         /** Create all the pre-declared resources.
         @remarks
             Called as part of initialiseResourceGroup
@@ -381,8 +407,8 @@ namespace Ogre {
         void dropGroupContents(ResourceGroup* grp);
         /** Delete a group for shutdown - don't notify ResourceManagers. */
         void deleteGroup(ResourceGroup* grp);
-        /// Internal find method for auto groups
-        ResourceGroup* findGroupContainingResourceImpl(const String& filename);
+        /// Internal find method for auto groups, see ResourceGroup::findInIndex for lcaseFilename
+        ResourceGroup* findGroupContainingResourceImpl(const String& filename, String& lcaseFilename);
         /// Internal event firing method
         void fireResourceGroupScriptingStarted(const String& groupName, size_t scriptCount);
         /// Internal event firing method
@@ -417,8 +443,9 @@ namespace Ogre {
         /** Find out if the named file exists in a group. Internal use only
          @param group Pointer to the resource group
          @param filename Fully qualified name of the file to test for
+         @param lcaseFilename See ResourceGroup::findInIndex
          */
-        bool resourceExists(ResourceGroup* group, const String& filename);
+        bool resourceExists(ResourceGroup* group, const String& filename, String& lcaseFilename);
 
         /// Stored current group - optimisation for when bulk loading a group
         ResourceGroup* mCurrentGroup;
@@ -781,6 +808,29 @@ namespace Ogre {
         */
         DataStreamListPtr openResources(const String& pattern, 
             const String& groupName = DEFAULT_RESOURCE_GROUP_NAME);
+
+        /** Reads a batch of resources ahead of their use.
+        @remarks
+            The resources are located like openResource does and read into
+            memory in parallel: on the task scheduler of the Root's work queue
+            if it has worker threads, otherwise on as many threads as a
+            DefaultWorkQueue is set to use, started for the occasion. The next
+            openResource call for each of them, with the same name and group,
+            returns the data read ahead; the data is released once handed out,
+            or when the group is cleared. Resources in other archives than
+            FileSystemArchive and "Zip" ones are read on the calling thread,
+            since those archives may not be thread safe. Resources which can't
+            be found are skipped.
+        @param resourceNames The names of the resources, as they will be opened.
+        @param groupName The resource group the resources will be opened from.
+        */
+        void prefetchResources(const StringVector& resourceNames,
+            const String& groupName = DEFAULT_RESOURCE_GROUP_NAME);
+
+        /** Releases the resources read ahead by prefetchResources and not opened yet.
+        @param groupName The resource group.
+        */
+        void clearPrefetchedResources(const String& groupName = DEFAULT_RESOURCE_GROUP_NAME);
         
         /** List all file or directory names in a resource group.
         @note
@@ -1063,6 +1113,24 @@ namespace Ogre {
         /// Returns the current loading listener
         ResourceLoadingListener *getLoadingListener();
 
+        /** Sets the number of threads parsing scripts when a group is initialised.
+        @remarks
+            With more than one thread, script loaders which support it (see
+            ScriptLoader::beginPreparingScripts) get their scripts prepared
+            concurrently, using the calling thread and numThreads - 1 worker
+            threads started for the occasion. The prepared scripts are then
+            handed back to the loaders on the calling thread, in the usual
+            order and with the usual events, so the outcome doesn't change.
+        @par
+            Scripts are always parsed one by one while a ResourceLoadingListener
+            is set, since it may replace the streams as they are opened.
+        @param numThreads Number of threads, 1 (the default) to parse every
+            script on the calling thread.
+        */
+        void setNumScriptParsingThreads(size_t numThreads);
+        /// Gets the number of threads parsing scripts, see setNumScriptParsingThreads
+        size_t getNumScriptParsingThreads(void) const { return mNumScriptParsingThreads; }
+
         /** Override standard Singleton retrieval.
         @remarks
         Why do we do this? Well, it's because the Singleton
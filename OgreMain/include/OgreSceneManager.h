@@ -49,6 +49,7 @@ Torus Knot Software Ltd.
 #include "OgreLodListener.h"
 #include "OgreHeaderPrefix.h"
 #include "OgreNameGenerator.h"
+#include "Threading/OgreThreads.h"
 
 namespace Ogre {
     /** \addtogroup Core
@@ -210,6 +211,21 @@ namespace Ogre {
             Real skyBoxDistance;
         };
 
+        /** Counts of the render state changes and draws issued in a frame.
+        @see SceneManager::getRenderStateStats
+        */
+        struct RenderStateStats
+        {
+            /// Number of passes set on the RenderSystem
+            size_t passChanges;
+            /// Number of _setPass calls skipped since the pass was already set
+            size_t redundantPassChanges;
+            /// Number of GPU programs bound
+            size_t gpuProgramBinds;
+            /// Number of render operations issued
+            size_t draws;
+        };
+
         /** Class that allows listening in on the various stages of SceneManager
             processing, so that custom behaviour can be implemented from outside.
         */
@@ -432,6 +448,85 @@ namespace Ogre {
         typedef set<SceneNode*>::type AutoTrackingSceneNodes;
         AutoTrackingSceneNodes mAutoTrackingSceneNodes;
 
+        /// Whether _updateSceneGraph uses the depth-sorted, multithreaded update
+        bool mParallelSceneGraphUpdate;
+        /// Depth-sorted view of the scene graph used by the parallel update
+        NodeTransformArray* mNodeTransformArray;
+        /// Incremented whenever a scene node is attached or detached
+        unsigned long mSceneGraphStructureVersion;
+        /// Value of mSceneGraphStructureVersion when mNodeTransformArray was built
+        unsigned long mNodeTransformArrayVersion;
+        /// Depth level the worker threads are updating
+        size_t mNodeTransformLevel;
+
+        /// Whether _findVisibleObjects culls the scene graph on the worker threads
+        bool mParallelFrustumCulling;
+        /// Camera the worker threads cull against
+        Camera* mCullCamera;
+        typedef vector<SceneNode*>::type SceneNodeArray;
+        /// Nodes found visible by each worker thread, in scene graph order
+        vector<SceneNodeArray>::type mVisibleNodesPerThread;
+
+        /// Whether software skinning is gathered and run on the worker threads
+        bool mBatchedSoftwareSkinning;
+        /// Software skinning of the entities found visible, see setBatchedSoftwareSkinning
+        SoftwareSkinningBatch* mSoftwareSkinningBatch;
+        /// Whether entities add their software skinning to mSoftwareSkinningBatch
+        bool mGatherSoftwareSkinning;
+
+        /// Tasks which are split among the worker threads
+        enum WorkerThreadTask
+        {
+            WTT_UPDATE_NODE_TRANSFORMS,
+            WTT_CULL_FRUSTUM,
+            WTT_SOFTWARE_SKINNING
+        };
+
+        /// Number of threads taking part in worker thread tasks, including the calling one
+        size_t mNumWorkerThreads;
+        /// Additional threads, the calling thread always takes the first share of a task
+        ThreadHandleVec mWorkerThreads;
+        /// Synchronises the calling thread with the worker threads
+        Barrier* mWorkerThreadsBarrier;
+        /// Task the worker threads execute once woken up
+        WorkerThreadTask mWorkerThreadTask;
+        /// Set to make the worker threads exit once woken up
+        bool mExitWorkerThreads;
+
+        /// Creates mNumWorkerThreads - 1 worker threads
+        void startWorkerThreads(void);
+        /// Waits for all worker threads to exit
+        void stopWorkerThreads(void);
+        /** Executes a task on all worker threads and the calling thread, and
+            blocks until all of them are done.
+        */
+        void fireWorkerThreadsAndWait(WorkerThreadTask task);
+        /** Executes a worker thread's share of a task.
+        @param task The task to execute.
+        @param threadIdx Index of the thread, 0 being the calling thread.
+        @param numThreads Number of threads the task is split among.
+        */
+        virtual void executeWorkerThreadTask(WorkerThreadTask task, size_t threadIdx, size_t numThreads);
+
+        /** Gets whether this scene manager's scene graph can be updated with
+            the parallel update.
+        @remarks
+            Scene managers whose scene nodes override SceneNode::_update or
+            SceneNode::updateFromParentImpl must return false, since the
+            parallel update does not call those.
+        */
+        virtual bool isParallelSceneGraphUpdateSupported(void) const { return true; }
+        /// Rebuilds mNodeTransformArray if the scene graph structure changed
+        void refreshNodeTransformArray(void);
+        /// Updates the scene graph one depth level at a time using the worker threads
+        void updateSceneGraphParallel(void);
+        /// Blends the software skinning gathered in mSoftwareSkinningBatch
+        void flushSoftwareSkinning(void);
+        /// Culls the scene graph on the worker threads, then queues the visible nodes
+        void findVisibleObjectsParallel(Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
+        /// Culls a worker thread's share of the scene graph
+        void cullFrustumThread(size_t threadIdx, size_t numThreads);
+
         // Sky params
         // Sky plane
         Entity* mSkyPlaneEntity;
@@ -528,6 +623,14 @@ namespace Ogre {
         LightInfoList mCachedLightInfos;
         LightInfoList mTestLightInfos; // potentially new list
         ulong mLightsDirtyCounter;
+        /// Whether _populateLightList uses mLightIndex
+        bool mUseSpatialLightIndex;
+        /// Grid over mLightsAffectingFrustum, built on demand
+        SpatialLightIndex* mLightIndex;
+        /// Value of mLightsDirtyCounter when mLightIndex was built
+        ulong mLightIndexDirtyCounter;
+        /// Scratch list for the results of mLightIndex
+        vector<uint32>::type mLightIndexQuery;
         LightList mShadowTextureCurrentCasterLightList;
 
         typedef map<String, MovableObject*>::type MovableObjectMap;
@@ -539,6 +642,10 @@ namespace Ogre {
         };
         typedef map<String, MovableObjectCollection*>::type MovableObjectCollectionMap;
         MovableObjectCollectionMap mMovableObjectCollectionMap;
+        /// Whether the default scene queries use mSceneQueryBroadphase
+        bool mUseSceneQueryBroadphase;
+        /// Tree over the movable objects, built by the first scene query
+        SceneQueryBroadphase* mSceneQueryBroadphase;
         NameGenerator mMovableNameGenerator;
         /** Gets the movable object collection for the given type name.
         @remarks
@@ -994,6 +1101,24 @@ namespace Ogre {
         /// Gpu params that need rebinding (mask of GpuParamVariability)
         uint16 mGpuParamsDirty;
 
+        /// Pass last given to _setPass, or 0 if the render state is unknown
+        const Pass* mLastPassRequested;
+        /// Pass last set on the RenderSystem by _setPass
+        const Pass* mLastPassSet;
+        /// Change counts of the above when they were set
+        uint32 mLastPassRequestedChangeCount;
+        uint32 mLastPassSetChangeCount;
+        /// Illumination stage the last pass was set in
+        IlluminationRenderStage mLastPassIlluminationStage;
+        /// Last per-object polygon mode set, 0 if unknown
+        int mLastObjectPolygonMode;
+        /// Last per-object normalisation set, -1 if unknown
+        int mLastObjectNormaliseNormals;
+        /// Render state counters for the current frame
+        RenderStateStats mRenderStateStats;
+        /// Frame number mRenderStateStats belongs to
+        unsigned long mRenderStateStatsFrame;
+
         virtual void useLights(const LightList& lights, unsigned short limit);
         virtual void setViewMatrix(const Matrix4& m);
         virtual void useLightsGpuProgram(const Pass* pass, const LightList* lights);
@@ -1257,6 +1382,19 @@ namespace Ogre {
         */
         virtual void _populateLightList(const SceneNode* sn, Real radius, LightList& destList, uint32 lightMask = 0xFFFFFFFF);
 
+        /** Sets whether _populateLightList uses a spatial index of the lights
+            affecting the frustum instead of testing every one of them.
+        @remarks
+            The index is a uniform grid rebuilt whenever the lights affecting the
+            frustum change, and is only used when there are enough of them for
+            it to pay off. The resulting light lists are identical either way.
+            Enabled by default.
+        */
+        void setUseSpatialLightIndex(bool enabled) { mUseSpatialLightIndex = enabled; }
+
+        /** Gets whether _populateLightList uses a spatial index of the lights. */
+        bool getUseSpatialLightIndex(void) const { return mUseSpatialLightIndex; }
+
         /** Creates an instance of a SceneNode.
             @remarks
                 Note that this does not add the SceneNode to the scene hierarchy.
@@ -1815,6 +1953,44 @@ namespace Ogre {
         */
         virtual void _updateSceneGraph(Camera* cam);
 
+        /** Sets whether the scene graph is updated by depth level, on the worker threads.
+        @remarks
+            The default update recurses from the root node. When enabled, the
+            scene graph is instead flattened into depth-sorted arrays and every
+            depth level is split among the worker threads, which combine the
+            transforms with OptimisedUtil::concatenateNodeTransforms. The
+            resulting derived transforms are identical to those of the recursive
+            update. Node::Listener::nodeUpdated and MovableObject::_notifyMoved
+            are called from the calling thread once all transforms have been
+            updated, and bounds are updated from the calling thread as well.
+        @par
+            Has no effect if the scene manager does not support it, or if
+            OGRE_NODE_INHERIT_TRANSFORM is enabled. Disabled by default.
+        */
+        void setParallelSceneGraphUpdate(bool enabled);
+
+        /** Gets whether the scene graph is updated by depth level, on the worker threads. */
+        bool getParallelSceneGraphUpdate(void) const { return mParallelSceneGraphUpdate; }
+
+        /** Sets the number of threads that tasks such as the parallel scene
+            graph update are split among.
+        @remarks
+            The calling thread counts as one of them, so a value of 1 (the
+            default) creates no additional threads.
+        */
+        void setNumWorkerThreads(size_t numThreads);
+
+        /** Gets the number of threads that tasks are split among. */
+        size_t getNumWorkerThreads(void) const { return mNumWorkerThreads; }
+
+        /** Internal method, notifies that a scene node was attached to or
+            detached from its parent.
+        */
+        void _notifySceneGraphStructureChanged(void) { ++mSceneGraphStructureVersion; }
+
+        /** Internal method, main loop of the worker threads. */
+        unsigned long _updateWorkerThread(ThreadHandle* threadHandle);
+
         /** Internal method which parses the scene to find visible objects to render.
             @remarks
                 If you're implementing a custom scene manager, this is the most important method to
@@ -1828,6 +2004,51 @@ namespace Ogre {
         */
         virtual void _findVisibleObjects(Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
 
+        /** Sets whether _findVisibleObjects tests the scene nodes against the
+            camera on the worker threads.
+        @remarks
+            The scene graph is split into chunks, one per worker thread (see
+            setNumWorkerThreads), and every thread tests the world bounds of
+            its nodes against the camera. The visible nodes are then added to
+            the render queue from the calling thread, in a deterministic order.
+        @par
+            Only the bounds tests are distributed: notifying objects of the
+            camera and queueing their renderables updates LODs, animations and
+            hardware buffers, which must happen on the rendering thread.
+            Disabled by default. Scene managers which override
+            _findVisibleObjects are not affected.
+        */
+        void setParallelFrustumCulling(bool enabled);
+
+        /** Gets whether _findVisibleObjects tests the scene nodes on the worker threads. */
+        bool getParallelFrustumCulling(void) const { return mParallelFrustumCulling; }
+
+        /** Sets whether the software skinning of the visible entities is
+            gathered and blended in one batch, on the worker threads.
+        @remarks
+            Entities normally blend their vertices as soon as they are queued
+            for rendering. When enabled, the blends of all entities found
+            visible by a camera are recorded instead, then split among the
+            worker threads (see setNumWorkerThreads) once the scene has been
+            traversed, before anything is rendered. Buffers shared by the
+            entities, such as the source vertices of a common mesh, are
+            locked once for the whole batch. The blended vertices are the
+            same as with the per entity blend.
+        @par
+            Entity::_updateAnimation called from outside rendering still blends
+            immediately. Disabled by default.
+        */
+        void setBatchedSoftwareSkinning(bool enabled);
+
+        /** Gets whether software skinning is gathered and blended in one batch. */
+        bool getBatchedSoftwareSkinning(void) const { return mBatchedSoftwareSkinning; }
+
+        /** Internal method, gets the batch entities add their software skinning
+            to, or null if they must blend it immediately.
+        */
+        SoftwareSkinningBatch* _getSoftwareSkinningBatch(void) const
+        { return mGatherSoftwareSkinning ? mSoftwareSkinningBatch : 0; }
+
           /** Internal method for issuing the render operation.*/
         virtual void _issueRenderOp(const Pass* pass, Renderable* rend, bool passTransformState);
         
@@ -2653,6 +2874,29 @@ namespace Ogre {
         /** Destroys a scene query of any type. */
         virtual void destroyQuery(SceneQuery* query);
 
+        /** Sets whether the default scene queries find their candidates with a
+            bounding volume tree instead of testing every movable object.
+        @remarks
+            The tree is built by the first query, then maintained from the
+            movements of the objects reported by the scene graph update. The
+            queries return the same objects either way, possibly in another
+            order. Enabled by default; disabling it frees the tree.
+        */
+        void setUseSceneQueryBroadphase(bool enabled);
+
+        /** Gets whether the default scene queries use a bounding volume tree. */
+        bool getUseSceneQueryBroadphase(void) const { return mUseSceneQueryBroadphase; }
+
+        /** Gets the bounding volume tree of the scene queries, or null if it
+            was not built (internal use only). */
+        SceneQueryBroadphase* _getSceneQueryBroadphase(void) const { return mSceneQueryBroadphase; }
+
+        /** Builds the bounding volume tree of the scene queries if needed and
+            refits the objects which moved since (internal use only).
+        @return The tree, or null if it is disabled.
+        */
+        SceneQueryBroadphase* _updateSceneQueryBroadphase(void);
+
         typedef MapIterator<CameraList> CameraIterator;
         typedef MapIterator<AnimationList> AnimationIterator;
 
@@ -3450,6 +3694,23 @@ namespace Ogre {
         */
         virtual void _markGpuParamsDirty(uint16 mask);
 
+        /** Tells the SceneManager that the RenderSystem state may no longer
+            match the last pass set.
+        @remarks
+            _setPass skips passes which are already set, e.g. consecutive
+            transparent objects with the same material. Call this if you change
+            RenderSystem state directly while rendering, so that the next pass
+            is set in full. Render queue and render object listeners do not need
+            to call this, since the SceneManager assumes they change state.
+        */
+        virtual void _markRenderStateDirty(void);
+
+        /** Gets the render state changes and draws issued so far this frame.
+        @remarks
+            The counters are reset when the first scene of a new frame is rendered.
+        */
+        const RenderStateStats& getRenderStateStats(void) const { return mRenderStateStats; }
+
 
         /** Indicates to the SceneManager whether it should suppress the 
             active shadow rendering technique until told otherwise.
@@ -3567,6 +3828,10 @@ namespace Ogre {
 
         /** See IntersectionSceneQuery. */
         void execute(IntersectionSceneQueryListener* listener);
+
+    protected:
+        /// Objects found by the broadphase of the scene manager
+        vector<MovableObject*>::type mCandidates;
     };
 
     /** Default implementation of RaySceneQuery. */
@@ -3578,6 +3843,10 @@ namespace Ogre {
 
         /** See RayScenQuery. */
         void execute(RaySceneQueryListener* listener);
+
+    protected:
+        /// Objects found by the broadphase of the scene manager
+        vector<MovableObject*>::type mCandidates;
     };
     /** Default implementation of SphereSceneQuery. */
     class _OgreExport DefaultSphereSceneQuery : public SphereSceneQuery
@@ -3588,6 +3857,10 @@ namespace Ogre {
 
         /** See SceneQuery. */
         void execute(SceneQueryListener* listener);
+
+    protected:
+        /// Objects found by the broadphase of the scene manager
+        vector<MovableObject*>::type mCandidates;
     };
     /** Default implementation of PlaneBoundedVolumeListSceneQuery. */
     class _OgreExport DefaultPlaneBoundedVolumeListSceneQuery : public PlaneBoundedVolumeListSceneQuery
@@ -3598,6 +3871,10 @@ namespace Ogre {
 
         /** See SceneQuery. */
         void execute(SceneQueryListener* listener);
+
+    protected:
+        /// Objects found by the broadphase of the scene manager
+        vector<MovableObject*>::type mCandidates;
     };
     /** Default implementation of AxisAlignedBoxSceneQuery. */
     class _OgreExport DefaultAxisAlignedBoxSceneQuery : public AxisAlignedBoxSceneQuery
@@ -3608,6 +3885,10 @@ namespace Ogre {
 
         /** See RayScenQuery. */
         void execute(SceneQueryListener* listener);
+
+    protected:
+        /// Objects found by the broadphase of the scene manager
+        vector<MovableObject*>::type mCandidates;
     };
     
 
@@ -79,6 +79,9 @@ namespace Ogre {
         /** @copydoc Node::updateFromParentImpl. */
         void updateFromParentImpl(void) const;
 
+        /** @copydoc Node::derivedTransformUpdatedImpl. */
+        void derivedTransformUpdatedImpl(void) const;
+
         /** See Node. */
         Node* createChildImpl(void);
 
@@ -209,6 +212,22 @@ namespace Ogre {
             VisibleObjectsBoundsInfo* visibleBounds, 
             bool includeChildren = true, bool displayNodes = false, bool onlyShadowCasters = false);
 
+        /** Adds the objects attached to this node to the rendering queue.
+        @remarks
+            Does not test the node's bounds against the camera, nor cascade down
+            to child nodes; for scene managers which determine the visible
+            nodes themselves.
+        */
+        virtual void _addToRenderQueue(Camera* cam, RenderQueue* queue,
+            bool onlyShadowCasters, VisibleObjectsBoundsInfo* visibleBounds);
+
+        /** Adds the debug renderable and the bounding box of this node to the
+            rendering queue, if they are to be displayed.
+        @param queue The rendering queue.
+        @param displayNodes Whether the node itself is rendered as a set of axes.
+        */
+        virtual void _addDebugRenderablesToQueue(RenderQueue* queue, bool displayNodes);
+
         /** Gets the axis-aligned bounding box of this node (and hence all subnodes).
         @remarks
             Recommended only if you are extending a SceneManager, because the bounding box returned
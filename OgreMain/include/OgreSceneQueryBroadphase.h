@@ -0,0 +1,195 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SceneQueryBroadphase_H__
+#define __SceneQueryBroadphase_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreVector3.h"
+#include "OgrePlaneBoundedVolume.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Dynamic AABB tree over the movable objects of a scene manager, used by
+        the default scene queries to find the objects near a region, a ray or
+        each other without testing every object.
+    @remarks
+        Each object is a leaf of a binary tree of bounding boxes. Leaves hold
+        the world bounds of their object enlarged by a margin, so an object
+        moving inside its enlarged box does not need to be moved in the tree.
+        Objects report their movement through MovableObject::_notifyMoved,
+        which the scene graph update raises for every object whose node or
+        bounds changed; they are only refitted on the next call to update,
+        from the world bounds cached by that update, which are the bounds the
+        scene queries test.
+    @par
+        The leaf boxes also enclose the bounding sphere of the objects, so
+        sphere queries can use them. Objects with infinite bounds, and objects
+        owned by another scene manager which does not notify this one of their
+        movement, are returned by every query. Queries are conservative: the
+        caller is expected to run the exact test on the objects found.
+    */
+    class _OgreExport SceneQueryBroadphase : public SceneMgtAlloc
+    {
+    public:
+        typedef vector<MovableObject*>::type ObjectList;
+
+        /// Proxy of the objects which are not registered
+        static const uint32 NO_PROXY = 0xFFFFFFFF;
+
+        SceneQueryBroadphase(SceneManager* owner);
+        ~SceneQueryBroadphase();
+
+        /** Registers an object, it is inserted on the next update. */
+        void addObject(MovableObject* obj);
+
+        /** Unregisters an object, does nothing if it was not registered. */
+        void removeObject(MovableObject* obj);
+
+        /** Unregisters every object. */
+        void removeAllObjects(void);
+
+        /** Gets the number of registered objects. */
+        size_t getNumObjects(void) const { return mNumObjects + mForeignObjects.size(); }
+
+        /** Gets the height of the tree, for diagnostics. */
+        size_t getHeight(void) const;
+
+        /** Marks the bounds of a registered object as changed. */
+        void _notifyObjectMoved(MovableObject* obj);
+
+        /** Refits the objects which moved since the last update. */
+        void update(void);
+
+        /** Finds the objects which may intersect a box.
+        @param box The box to test.
+        @param result Receives the objects; it is cleared first.
+        */
+        void findObjects(const AxisAlignedBox& box, ObjectList& result) const;
+
+        /** Finds the objects which may intersect a sphere. */
+        void findObjects(const Sphere& sphere, ObjectList& result) const;
+
+        /** Finds the objects which may be hit by a ray. */
+        void findObjects(const Ray& ray, ObjectList& result) const;
+
+        /** Finds the objects which may intersect any of a list of volumes. */
+        void findObjects(const PlaneBoundedVolumeList& volumes, ObjectList& result) const;
+
+        /** Finds every registered object, in proxy order. */
+        void getObjects(ObjectList& result) const;
+
+    protected:
+        /// Node of the tree, either a leaf holding a proxy or a parent of two nodes
+        struct TreeNode
+        {
+            Vector3 minimum;
+            Vector3 maximum;
+            /// Parent node, or next free node when unused
+            int32 parent;
+            int32 child1;
+            int32 child2;
+            /// Height of the subtree, 0 for leaves, -1 for free nodes
+            int32 height;
+            /// Proxy of the object of a leaf
+            uint32 proxy;
+
+            bool isLeaf(void) const { return child1 == -1; }
+        };
+        typedef vector<TreeNode>::type TreeNodeList;
+
+        /// Registered object of this scene manager
+        struct Proxy
+        {
+            MovableObject* object;
+            /// Leaf of the object, -1 when its bounds are null or infinite
+            int32 leaf;
+            /// Whether the object has infinite bounds
+            bool unbounded;
+            /// Whether the object is in mDirtyProxies
+            bool dirty;
+        };
+        typedef vector<Proxy>::type ProxyList;
+        typedef vector<uint32>::type ProxyIndexList;
+
+        /// Computes the box of the leaf of an object, returns false if null or infinite
+        bool getObjectBounds(MovableObject* obj, Vector3& minimum, Vector3& maximum, bool& unbounded) const;
+        /// Moves a proxy to the current bounds of its object
+        void refreshProxy(uint32 proxy);
+        /// Sets whether a proxy is in mUnboundedProxies
+        void setUnbounded(uint32 proxy, bool unbounded);
+
+        int32 allocateNode(void);
+        void freeNode(int32 node);
+        void insertLeaf(int32 leaf);
+        void removeLeaf(int32 leaf);
+        /// Rotates the subtree at a node if unbalanced, returns its new root
+        int32 balance(int32 node);
+
+        /** Gathers the objects of the leaves accepted by a test, plus those
+            returned by every query. */
+        template <typename Test>
+        void query(const Test& test, ObjectList& result) const;
+
+        /// Scene manager whose objects notify this
+        SceneManager* mOwner;
+        /// Margin added around the bounds of the leaves, relative to their size
+        Real mMarginFactor;
+
+        TreeNodeList mNodes;
+        int32 mRoot;
+        int32 mFreeNode;
+
+        ProxyList mProxies;
+        /// Unused entries of mProxies
+        ProxyIndexList mFreeProxies;
+        /// Proxies moved since the last update
+        ProxyIndexList mDirtyProxies;
+        /// Proxies with infinite bounds
+        ProxyIndexList mUnboundedProxies;
+        /// Number of used entries of mProxies
+        size_t mNumObjects;
+        /// Objects of other scene managers, returned by every query
+        ObjectList mForeignObjects;
+
+        OGRE_MUTEX(mMutex);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
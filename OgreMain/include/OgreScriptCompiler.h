@@ -201,6 +201,50 @@ namespace Ogre
         typedef SharedPtr<Error> ErrorPtr;
         typedef list<ErrorPtr>::type ErrorList;
 
+        /** A script as far as it can be compiled on its own, see _prepare */
+        struct PreparedScript : public ScriptLoader::PreparedScript
+        {
+            /// The parsed script
+            ConcreteNodeListPtr cst;
+            /// The abstract syntax tree, if it could be generated ahead
+            AbstractNodeListPtr ast;
+            /// Variables set at the top level of the script while generating the tree
+            map<String,String>::type env;
+            /// Errors found while generating the tree, raised once compiled
+            ErrorList errors;
+        };
+
+        /// Hash of the name and contents of a script, see ScriptCompilerManager::setScriptCacheEnabled
+        struct Hash
+        {
+            uint64 hashVal[2];
+
+            bool operator < ( const Hash &_r ) const
+            {
+                if( hashVal[0] < _r.hashVal[0] ) return true;
+                if( hashVal[0] > _r.hashVal[0] ) return false;
+                return hashVal[1] < _r.hashVal[1];
+            }
+            bool operator == ( const Hash &_r ) const
+            {
+                return hashVal[0] == _r.hashVal[0] && hashVal[1] == _r.hashVal[1];
+            }
+        };
+        /// Scripts imported while compiling a script, with their hash; zero for those which could not be opened
+        typedef list<std::pair<String, Hash> >::type DependencyList;
+
+        /** A script compiled up to translation, see ScriptCompilerManager::setScriptCacheEnabled */
+        struct CachedScript : public ScriptCompilerAlloc
+        {
+            /// The imported scripts, the entry is only valid while they're unchanged
+            DependencyList dependencies;
+            /// Errors found until translation, raised again whenever the script is compiled
+            ErrorList errors;
+            /// The tree with imports, inheritance and variables processed
+            AbstractNodeListPtr nodes;
+        };
+        typedef SharedPtr<CachedScript> CachedScriptPtr;
+
         // These are the built-in error codes
         enum{
             CE_STRINGEXPECTED,
@@ -235,6 +279,28 @@ namespace Ogre
         AbstractNodeListPtr _generateAST(const String &str, const String &source, bool doImports = false, bool doObjects = false, bool doVariables = false);
         /// Compiles the given abstract syntax tree
         bool _compile(AbstractNodeListPtr nodes, const String &group, bool doImports = true, bool doObjects = true, bool doVariables = true);
+        /** Lexes and parses a script and, if the compiler has no listener,
+            generates its abstract syntax tree.
+        @remarks
+            Only reads the state of the compiler, so several scripts may be
+            prepared at once from different threads as long as the compiler
+            isn't used otherwise meanwhile.
+        */
+        void _prepare(const DataStreamPtr &stream, PreparedScript &script);
+        /** Compiles a script prepared by _prepare, with the same result as
+            compiling it from its source.
+        */
+        bool _compilePrepared(PreparedScript &script, const String &group);
+        /** Compiles a script, going through the script cache of ScriptCompilerManager
+            when it's enabled.
+        @remarks
+            A cached tree is used if the script and all the scripts it imports
+            are unchanged, otherwise the script is compiled from its source and
+            the processed tree is added to the cache.
+        */
+        bool _compileCached(const DataStreamPtr &stream, const String &group);
+        /// Computes the hash identifying a script in the script cache
+        static Hash _computeHash(const String &name, const DataStreamPtr &stream);
         /// Adds the given error to the compiler's list of errors
         void addError(uint32 code, const String &file, int line, const String &msg = "");
         /// Sets the listener used by the compiler
@@ -270,6 +336,16 @@ namespace Ogre
 
     private: // Tree processing
         AbstractNodeListPtr convertToAST(const ConcreteNodeListPtr &nodes);
+        /// Processes the given tree and translates it, the end of compile
+        bool compileAST(AbstractNodeListPtr &ast);
+        /// Translates the processed tree
+        bool translateAST(const AbstractNodeListPtr &ast);
+        /// Adds the processed tree to the script cache, if it's being recorded
+        void addToCache(const AbstractNodeListPtr &ast);
+        /// Compiles a cached script, returns false if it's out of date
+        bool compileFromCache(const CachedScript &script, const String &group);
+        /// Sets the word ids of a tree read from the script cache
+        void assignIds(AbstractNodeList &nodes);
         /// This built-in function processes import nodes
         void processImports(AbstractNodeListPtr &nodes);
         /// Loads the requested script and converts it to an AST
@@ -310,6 +386,12 @@ namespace Ogre
         // Error list
         ErrorList mErrors;
 
+        // Whether the script being compiled goes into the script cache, and its hash
+        bool mCacheRecording;
+        Hash mCacheHash;
+        // The imports of the script going into the script cache
+        DependencyList mCacheDependencies;
+
         // The listener
         ScriptCompilerListener *mListener;
     private: // Internal helper classes and processors
@@ -319,8 +401,12 @@ namespace Ogre
             AbstractNodeListPtr mNodes;
             AbstractNode *mCurrent;
             ScriptCompiler *mCompiler;
+            /// Receives the variables and errors instead of the compiler, if set
+            PreparedScript *mPrepared;
+
+            void addError(uint32 code, const String &file, int line, const String &msg = "");
         public:
-            AbstractTreeBuilder(ScriptCompiler *compiler);
+            AbstractTreeBuilder(ScriptCompiler *compiler, PreparedScript *prepared = 0);
             const AbstractNodeListPtr &getResult() const;
             void visit(ConcreteNode *node);
             static void visit(AbstractTreeBuilder *visitor, const ConcreteNodeList &nodes);
@@ -418,6 +504,18 @@ namespace Ogre
 
         // A pointer to the specific compiler instance used
         OGRE_THREAD_POINTER(ScriptCompiler, mScriptCompiler);
+
+        // The compiler preparing scripts, see beginPreparingScripts
+        ScriptCompiler *mPreparingCompiler;
+
+        // The script cache, see setScriptCacheEnabled
+        typedef map<ScriptCompiler::Hash, ScriptCompiler::CachedScriptPtr>::type ScriptCacheMap;
+        ScriptCacheMap mScriptCache;
+        bool mScriptCacheEnabled;
+        bool mScriptCacheDirty;
+
+        static const uint32 SCRIPTCACHE_CHUNK_ID;
+        static const uint16 SCRIPTCACHE_CHUNK_VERSION;
     public:
         ScriptCompilerManager();
         virtual ~ScriptCompilerManager();
@@ -457,6 +555,50 @@ namespace Ogre
         void parseScript(DataStreamPtr& stream, const String& groupName);
         /// @copydoc ScriptLoader::getLoadingOrder
         Real getLoadingOrder(void) const;
+        /// @copydoc ScriptLoader::beginPreparingScripts
+        bool beginPreparingScripts(void);
+        /// @copydoc ScriptLoader::prepareScript
+        ScriptLoader::PreparedScript* prepareScript(DataStreamPtr& stream, const String& groupName);
+        /// @copydoc ScriptLoader::parsePreparedScript
+        void parsePreparedScript(ScriptLoader::PreparedScript* script, const String& groupName);
+        /// @copydoc ScriptLoader::endPreparingScripts
+        void endPreparingScripts(void);
+
+        /** Sets whether compiled scripts are kept in the script cache.
+        @remarks
+            The cache holds scripts as they are just before translation, after
+            imports, object inheritance and variables have been processed. A
+            script whose name and contents are found in the cache, and whose
+            imported scripts haven't changed either, is translated directly
+            from there, without being lexed, parsed or processed again. Errors
+            found before translation are raised again each time.
+        @par
+            Save the cache with saveScriptCache and load it again on the next
+            run with loadScriptCache to keep the benefit across runs. Scripts
+            are only cached while no ScriptCompilerListener is set, since a
+            listener may change the way a script is processed. Scripts going
+            through the cache aren't prepared on several threads, see
+            ResourceGroupManager::setNumScriptParsingThreads.
+        */
+        void setScriptCacheEnabled(bool enabled);
+        /// Gets whether compiled scripts are kept in the script cache
+        bool getScriptCacheEnabled(void) const { return mScriptCacheEnabled; }
+        /// Returns true if scripts were added to the cache since it was last loaded or saved
+        bool isScriptCacheDirty(void) const { return mScriptCacheDirty; }
+        /// Removes all scripts from the script cache
+        void clearScriptCache(void);
+        /** Saves the script cache.
+        @param stream The destination stream
+        */
+        void saveScriptCache(const DataStreamPtr& stream);
+        /** Loads the script cache, replacing its current contents.
+        @param stream The source stream, written by saveScriptCache
+        */
+        void loadScriptCache(const DataStreamPtr& stream);
+        /// Internal method, gets a script from the cache, or a null pointer
+        ScriptCompiler::CachedScriptPtr _getCachedScript(const ScriptCompiler::Hash& hash);
+        /// Internal method, adds a script to the cache, replacing any previous version
+        void _addCachedScript(const ScriptCompiler::Hash& hash, const ScriptCompiler::CachedScriptPtr& script);
 
         /** Override standard Singleton retrieval.
         @remarks
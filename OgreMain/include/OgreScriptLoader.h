@@ -86,6 +86,54 @@ namespace Ogre {
         */
         virtual Real getLoadingOrder(void) const  = 0;
 
+        /** A script which has been through prepareScript. */
+        class _OgreExport PreparedScript : public ResourceAlloc
+        {
+        public:
+            virtual ~PreparedScript() {}
+        };
+
+        /** Starts a batch of scripts parsed in two steps.
+        @remarks
+            ResourceGroupManager can parse the scripts of a group on several
+            threads (see ResourceGroupManager::setNumScriptParsingThreads). The
+            work which only depends on the script itself, such as lexing, is
+            done by prepareScript, called from worker threads for several scripts
+            at once. The scripts are then completed by parsePreparedScript, in
+            the order parseScript would have been called and from the thread
+            which called this method.
+        @return
+            Whether the loader supports prepareScript. The default
+            implementation returns false, and the scripts are parsed by
+            parseScript as usual.
+        */
+        virtual bool beginPreparingScripts(void) { return false; }
+
+        /** Does the part of parsing a script which doesn't depend on other
+            scripts or on the state of the engine.
+        @remarks
+            May be called from several threads at once, between
+            beginPreparingScripts and endPreparingScripts.
+        @param stream The script, held in memory
+        @param groupName The resource group the script is parsed for
+        @return The prepared script, to be deleted by the caller once passed
+            to parsePreparedScript.
+        */
+        virtual PreparedScript* prepareScript(DataStreamPtr& stream, const String& groupName)
+        {
+            (void)stream; (void)groupName;
+            return 0;
+        }
+
+        /** Completes the parsing of a script returned by prepareScript. */
+        virtual void parsePreparedScript(PreparedScript* script, const String& groupName)
+        {
+            (void)script; (void)groupName;
+        }
+
+        /** Ends a batch started with beginPreparingScripts. */
+        virtual void endPreparingScripts(void) {}
+
     };
 
     /** @} */
@@ -104,6 +104,16 @@ namespace Ogre {
 
         String readString(DataStreamPtr& stream);
         String readString(DataStreamPtr& stream, size_t numChars);
+
+        /** Gets the next bytes of a stream held in memory without copying them.
+        @remarks
+            Returns a pointer to the data at the current position of the stream
+            and skips past it, if the stream is a MemoryDataStream (for example a
+            MappedFileDataStream) holding at least size more bytes and the data
+            needs no endian conversion. Otherwise nothing is read and 0 is
+            returned, in which case the data must be read as usual.
+        */
+        const void* readInPlace(DataStreamPtr& stream, size_t size);
         
         virtual void flipToLittleEndian(void* pData, size_t size, size_t count = 1);
         virtual void flipFromLittleEndian(void* pData, size_t size, size_t count = 1);
@@ -101,6 +101,25 @@ namespace Ogre {
                     // Quaternion rotate            : Rotation to apply at this keyframe
                     // Vector3 translate            : Translation to apply at this keyframe
                     // Vector3 scale                : Scale to apply at this keyframe
+
+            SKELETON_ANIMATION_TRACK_COMPRESSED = 0x4200,
+            // [v1.100+] A single animation track with compressed keyframes, see
+            // BakedNodeAnimation::CompressedTrack. Used instead of SKELETON_ANIMATION_TRACK
+            // by animations with compressed node tracks.
+            // Repeating section (within SKELETON_ANIMATION)
+
+                // unsigned short boneIndex     : Index of bone to apply to
+                // unsigned short numKeyFrames  : Number of keyframes
+                // unsigned short flags         : 1 if the track has scales, 2 if it has a base rotation
+                // Vector3 translateMin         : Translation of quantised value 0
+                // Vector3 translateStep        : Translation per quantised unit
+                // Vector3 scaleMin             : [if flags & 1] Scale of quantised value 0
+                // Vector3 scaleStep            : [if flags & 1] Scale per quantised unit
+                // Quaternion rotationBase      : [if flags & 2] Rotation applied before the quantised ones
+                // float times[numKeyFrames]    : The time positions (seconds)
+                // unsigned short rotations[numKeyFrames * 3]     : Quantised rotations
+                // unsigned short translations[numKeyFrames * 3]  : Quantised translations
+                // unsigned short scales[numKeyFrames * 3]        : [if flags & 1] Quantised scales
         SKELETON_ANIMATION_LINK         = 0x5000
         // Link to another skeleton, to re-use its animations
 
@@ -0,0 +1,147 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SoftwareSkinningBatch_H__
+#define __SoftwareSkinningBatch_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHardwareVertexBuffer.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Gathers the software skinning of many vertex data sets, so they can be
+        blended together, split among several threads.
+    @remarks
+        Mesh::softwareVertexBlend locks, blends and unlocks the buffers of one
+        vertex data set. This class splits these steps: add locks the buffers
+        and records the blend, execute runs OptimisedUtil::softwareVertexSkinning
+        on a share of the recorded vertices and may be called from several
+        threads at once, finish unlocks everything. Buffers used by several
+        blends, such as the source data of a mesh shared by a crowd of
+        entities, are only locked once.
+    @par
+        The results are those of Mesh::softwareVertexBlend; the vertices are
+        blended in chunks whose size is a multiple of 4, so the same SIMD
+        routines are used.
+    */
+    class _OgreExport SoftwareSkinningBatch : public AnimationAlloc
+    {
+    public:
+        SoftwareSkinningBatch();
+        ~SoftwareSkinningBatch();
+
+        /** Records a blend, see Mesh::softwareVertexBlend for the parameters.
+        @remarks
+            Locks the buffers, so must be called from the rendering thread.
+            The blend matrix pointers are copied, but the matrices themselves
+            must stay valid until execute has run.
+        */
+        void add(const VertexData* sourceVertexData, const VertexData* targetVertexData,
+            const Matrix4* const* blendMatrices, size_t numMatrices, bool blendNormals);
+
+        /** Gets whether no blend was recorded since the last call to finish. */
+        bool empty(void) const { return mBlends.empty(); }
+
+        /** Gets the number of vertices recorded since the last call to finish. */
+        size_t getNumVertices(void) const { return mNumVertices; }
+
+        /** Blends a share of the recorded vertices.
+        @remarks
+            Each thread must pass its own threadIdx, from 0 to numThreads - 1;
+            together they blend every recorded vertex.
+        */
+        void execute(size_t threadIdx, size_t numThreads);
+
+        /** Unlocks the buffers and forgets the recorded blends.
+        @remarks
+            Must be called from the rendering thread, once execute has run on
+            every thread.
+        */
+        void finish(void);
+
+    protected:
+        struct Blend
+        {
+            const float* srcPos;
+            const float* srcNorm;
+            float* destPos;
+            float* destNorm;
+            const float* blendWeights;
+            const unsigned char* blendIndices;
+            size_t srcPosStride;
+            size_t destPosStride;
+            size_t srcNormStride;
+            size_t destNormStride;
+            size_t blendWeightStride;
+            size_t blendIndexStride;
+            size_t numWeightsPerVertex;
+            /// First entry of mBlendMatrices used by this blend
+            size_t firstMatrix;
+        };
+        typedef vector<Blend>::type BlendList;
+        BlendList mBlends;
+
+        /// Range of vertices of a blend, the unit of work of execute
+        struct Chunk
+        {
+            size_t blend;
+            size_t begin;
+            size_t end;
+        };
+        typedef vector<Chunk>::type ChunkList;
+        ChunkList mChunks;
+
+        vector<const Matrix4*>::type mBlendMatrices;
+
+        struct LockedBuffer
+        {
+            HardwareVertexBufferSharedPtr buffer;
+            void* data;
+        };
+        typedef map<HardwareVertexBuffer*, LockedBuffer>::type LockedBufferMap;
+        LockedBufferMap mLockedBuffers;
+
+        size_t mNumVertices;
+
+        /// Locks a buffer unless it already is, returns its data
+        void* lockBuffer(const HardwareVertexBufferSharedPtr& buffer, HardwareBuffer::LockOptions options);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -0,0 +1,108 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SpatialLightIndex_H__
+#define __SpatialLightIndex_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreAxisAlignedBox.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Uniform grid over a list of lights, used to find the lights which may
+        affect a sphere without testing every light.
+    @remarks
+        Each point or spot light is registered in the grid cells overlapped by
+        the box enclosing its attenuation range; directional lights affect
+        everything and are kept aside. The grid spans the light positions only,
+        lights and queries reaching past it are clamped to the border cells,
+        which keeps the grid small when a few lights have a very large range.
+    @par
+        Queries are conservative: they return every light whose range may
+        intersect the sphere, and possibly some that do not, so the caller is
+        expected to run the exact test on the result.
+    */
+    class _OgreExport SpatialLightIndex : public SceneMgtAlloc
+    {
+    public:
+        typedef vector<uint32>::type IndexList;
+
+        SpatialLightIndex();
+        ~SpatialLightIndex();
+
+        /** Rebuilds the index for the given lights. */
+        void build(const LightList& lights);
+
+        /** Gets the number of lights the index was built for. */
+        size_t getNumLights(void) const { return mNumLights; }
+
+        /** Finds the lights which may affect a sphere.
+        @param centre, radius The sphere.
+        @param indices Receives the indices of the lights, in the list passed
+            to build, in increasing order.
+        */
+        void query(const Vector3& centre, Real radius, IndexList& indices);
+
+    protected:
+        /// Gets the cell range overlapped by a box along each axis
+        void getCellRange(const Vector3& minimum, const Vector3& maximum,
+            size_t cellMin[3], size_t cellMax[3]) const;
+
+        /// Number of lights the index was built for
+        size_t mNumLights;
+        /// Area covered by the grid
+        AxisAlignedBox mBounds;
+        /// Reciprocal of the cell size along each axis
+        Vector3 mInvCellSize;
+        /// Number of cells along each axis
+        size_t mResolution[3];
+        /// Offset of the first light of each cell in mCellLights, plus the total
+        IndexList mCellStart;
+        /// Lights of each cell, cell after cell
+        IndexList mCellLights;
+        /// Lights affecting every query (directional lights)
+        IndexList mGlobalLights;
+        /// Query each light was last returned by, to skip duplicates
+        IndexList mLightQueries;
+        /// Current query number
+        uint32 mQuery;
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -154,10 +154,22 @@ namespace Ogre {
         };
         typedef vector<SubMeshLodGeometryLink>::type SubMeshLodGeometryLinkList;
         typedef map<SubMesh*, SubMeshLodGeometryLinkList*>::type SubMeshGeometryLookup;
+
+        // forward declarations
+        class LODBucket;
+        class MaterialBucket;
+        class Region;
+
+        /// Identifier of an entity added to the geometry, see addEntityInstance
+        typedef uint32 InstanceID;
         /// Structure recording a queued submesh for the build
         struct QueuedSubMesh : public BatchedGeometryAlloc
         {
             SubMesh* submesh;
+            /// The entity this submesh was added with
+            InstanceID instanceID;
+            /// The region this submesh was assigned to, 0 until it is built
+            Region* region;
             /// Link to LOD list of geometry, potentially optimised
             SubMeshLodGeometryLinkList* geometryLodList;
             String materialName;
@@ -177,11 +189,26 @@ namespace Ogre {
             Vector3 scale;
         };
         typedef vector<QueuedGeometry*>::type QueuedGeometryList;
-        
-        // forward declarations
-        class LODBucket;
-        class MaterialBucket;
-        class Region;
+
+        /** Source buffers locked for reading while buckets are built.
+        @remarks
+            Each buffer is locked once, from the thread running the build, so
+            that the buckets sharing it can read it from worker threads.
+        */
+        class _OgreExport SourceBufferLocks : public BatchedGeometryAlloc
+        {
+        public:
+            ~SourceBufferLocks() { unlockAll(); }
+            /// Locks the buffer if not done yet, and returns its contents
+            const void* lock(HardwareBuffer* buffer);
+            /// Returns the contents of a buffer locked earlier, safe from any thread
+            const void* get(HardwareBuffer* buffer) const;
+            /// Unlocks all the buffers
+            void unlockAll(void);
+        protected:
+            typedef map<HardwareBuffer*, const void*>::type LockMap;
+            LockMap mLocks;
+        };
 
         /** A GeometryBucket is a the lowest level bucket where geometry with 
             the same vertex & index format is stored. It also acts as the 
@@ -206,6 +233,10 @@ namespace Ogre {
             HardwareIndexBuffer::IndexType mIndexType;
             /// Maximum vertex indexable
             size_t mMaxVertexIndex;
+            /// Locked index buffer while building
+            void* mIndexLock;
+            /// Locked vertex buffers while building
+            vector<uchar*>::type mVertexLocks;
 
             template<typename T>
             void copyIndexes(const T* src, T* dst, size_t count, size_t indexOffset)
@@ -246,6 +277,17 @@ namespace Ogre {
             bool assign(QueuedGeometry* qsm);
             /// Build
             void build(bool stencilShadows);
+            /** Creates and locks the buffers, and locks the sources of the queued geometry.
+            @note Must be called from the thread running the build.
+            */
+            void _beginBuild(bool stencilShadows, SourceBufferLocks& sources);
+            /** Copies and transforms the queued geometry into the locked buffers.
+            @note Different buckets may copy their geometry concurrently.
+            */
+            void _copyGeometry(bool stencilShadows, const SourceBufferLocks& sources);
+            /** Unlocks the buffers, and prepares them for stencil shadows if required.
+            */
+            void _endBuild(bool stencilShadows);
             /// Dump contents for diagnostics
             void dump(std::ofstream& of) const;
         };
@@ -284,6 +326,13 @@ namespace Ogre {
             void assign(QueuedGeometry* qsm);
             /// Build
             void build(bool stencilShadows);
+            /** Loads the material and begins building the geometry buckets,
+                which are added to the list to have their geometry copied.
+            */
+            void _beginBuild(bool stencilShadows, SourceBufferLocks& sources,
+                GeometryBucketList& buckets);
+            /// Completes the build once the geometry has been copied
+            void _endBuild(bool stencilShadows);
             /// Add children to the render queue
             void addRenderables(RenderQueue* queue, uint8 group, 
                 Real lodValue);
@@ -361,6 +410,11 @@ namespace Ogre {
             void assign(QueuedSubMesh* qsm, ushort atLod);
             /// Build
             void build(bool stencilShadows);
+            /// @copydoc MaterialBucket::_beginBuild
+            void _beginBuild(bool stencilShadows, SourceBufferLocks& sources,
+                MaterialBucket::GeometryBucketList& buckets);
+            /// Completes the build, including the edge list if required
+            void _endBuild(bool stencilShadows);
             /// Add children to the render queue
             void addRenderables(RenderQueue* queue, uint8 group, 
                 Real lodValue);
@@ -431,6 +485,9 @@ namespace Ogre {
             /// Cached squared view depth value to avoid recalculation by GeometryBucket
             Real mSquaredViewDepth;
 
+            /// Merge the LOD values and bounds of a queued mesh into the region
+            void mergeLodAndBounds(QueuedSubMesh* qmesh);
+
         public:
             Region(StaticGeometry* parent, const String& name, SceneManager* mgr, 
                 uint32 regionID, const Vector3& centre);
@@ -441,6 +498,21 @@ namespace Ogre {
             void assign(QueuedSubMesh* qmesh);
             /// Build this region
             void build(bool stencilShadows);
+            /** Creates the scene node if needed and begins building the LOD
+                buckets, see MaterialBucket::_beginBuild.
+            */
+            void _beginBuild(bool stencilShadows, SourceBufferLocks& sources,
+                MaterialBucket::GeometryBucketList& buckets);
+            /// Completes the build once the geometry has been copied
+            void _endBuild(bool stencilShadows);
+            /** Destroys the built geometry, keeping the queued meshes so that
+                the region can be built again.
+            */
+            void _clear(void);
+            /// Removes the queued meshes of an instance, they are not deallocated
+            void _removeInstance(InstanceID instance);
+            /// Get the number of queued meshes in this region
+            size_t getNumQueuedSubMeshes(void) const { return mQueuedSubMeshes.size(); }
             /// Get the region ID of this region
             uint32 getID(void) const { return mRegionID; }
             /// Get the centre point of the region
@@ -514,6 +586,15 @@ namespace Ogre {
             
         /// Map of regions
         RegionMap mRegionMap;
+        /// Identifier given to the next entity added
+        InstanceID mNextInstanceID;
+        /// Regions to rebuild on the next update
+        set<uint32>::type mDirtyRegions;
+
+        /** Builds a set of regions, copying the geometry of all their buckets
+            in parallel if the work queue provides a task scheduler.
+        */
+        virtual void buildRegions(const vector<Region*>::type& regions);
 
         /** Virtual method for getting a region most suitable for the
             passed in bounds. Can be overridden by subclasses.
@@ -602,17 +683,34 @@ namespace Ogre {
             completely safely, and destroy the Entity before destroying 
             this StaticGeometry if you like. The Entity passed in is simply 
             used as a definition.
-        @note Must be called before 'build'.
+        @note Must be called before 'build', or followed by 'update' if the
+            geometry has already been built.
         @param ent The Entity to use as a definition (the Mesh and Materials 
             referenced will be recorded for the build call).
         @param position The world position at which to add this Entity
         @param orientation The world orientation at which to add this Entity
         @param scale The scale at which to add this entity
+        @see addEntityInstance to be able to remove the Entity again
         */
         virtual void addEntity(Entity* ent, const Vector3& position,
             const Quaternion& orientation = Quaternion::IDENTITY, 
             const Vector3& scale = Vector3::UNIT_SCALE);
 
+        /** Adds an Entity to the static geometry, like addEntity, and returns
+            an identifier for it.
+        @remarks
+            Use this instead of addEntity to remove the Entity again later,
+            followed by 'update' if the geometry has already been built.
+        @param ent The Entity to use as a definition
+        @param position The world position at which to add this Entity
+        @param orientation The world orientation at which to add this Entity
+        @param scale The scale at which to add this entity
+        @return An identifier which can be passed to removeEntity
+        */
+        InstanceID addEntityInstance(Entity* ent, const Vector3& position,
+            const Quaternion& orientation = Quaternion::IDENTITY, 
+            const Vector3& scale = Vector3::UNIT_SCALE);
+
         /** Adds all the Entity objects attached to a SceneNode and all it's
             children to the static geometry.
         @remarks
@@ -639,12 +737,34 @@ namespace Ogre {
             options which have been set, this method constructs the batched 
             geometry structures required. The batches are added to the scene 
             and will be rendered unless you specifically hide them.
+        @par
+            The geometry of the regions is copied in parallel when the
+            WorkQueue of Root provides a TaskScheduler.
         @note
-            Once you have called this method, you can no longer add any more 
-            entities.
+            Once you have called this method, any entities added or removed
+            only appear after a call to update().
         */
         virtual void build(void);
 
+        /** Removes an Entity previously added to the static geometry.
+        @note If the geometry has already been built, call update() to 
+            rebuild the regions it was part of.
+        @param instance The identifier returned by addEntityInstance
+        */
+        virtual void removeEntity(InstanceID instance);
+
+        /** Rebuilds only the regions touched by entities added or removed
+            since the last build.
+        @remarks
+            This is much cheaper than calling build() again when a few
+            entities change in a large geometry. If the geometry has not been
+            built yet, this just builds it.
+        */
+        virtual void update(void);
+
+        /// Has the geometry been built?
+        bool isBuilt(void) const { return mBuilt; }
+
         /** Destroys all the built geometry state (reverse of build). 
         @remarks
             You can call build() again after this and it will pick up all the
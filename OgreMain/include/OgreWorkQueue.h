@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreAny.h"
 #include "OgreSharedPtr.h"
 #include "OgreCommon.h"
+#include "OgreAtomicScalar.h"
 #include "Threading/OgreThreadHeaders.h"
 #include "OgreHeaderPrefix.h"
 
@@ -130,6 +131,8 @@ namespace Ogre
             String mMessages;
             /// Data associated with the result of the process
             Any mData;
+            /// Next response pushed on the same queue (internal use)
+            Response* mNextQueued;
 
         public:
             Response(const Request* rq, bool success, const Any& data, const String& msg = BLANKSTRING);
@@ -354,6 +357,14 @@ namespace Ogre
         */
         virtual uint16 getChannel(const String& channelName);
 
+        /** Get the task scheduler running the requests of this queue, if any.
+        @remarks
+            Engine systems can use it to run fine grained parallel work, see
+            TaskScheduler::parallelFor, on the same threads as the background
+            requests. The default implementation returns 0.
+        */
+        virtual TaskScheduler* getTaskScheduler() { return 0; }
+
     };
 
     /** Base for a general purpose request / response style background work queue.
@@ -456,6 +467,53 @@ namespace Ogre
         virtual unsigned long getResponseProcessingTimeLimit() const { return mResposeTimeLimitMS; }
         /// @copydoc WorkQueue::setResponseProcessingTimeLimit
         virtual void setResponseProcessingTimeLimit(unsigned long ms) { mResposeTimeLimitMS = ms; }
+
+        /** Set the priority of the responses of a channel.
+        @remarks
+            processResponses handles the waiting responses of higher priority
+            channels first; responses of channels with the same priority are
+            handled in the order they were queued. The default priority is 0.
+        */
+        virtual void setResponseChannelPriority(uint16 channel, int priority);
+
+        /** Limit how many responses of a channel a single processResponses call
+            handles.
+        @remarks
+            Once a channel has used its budget, its remaining responses wait for
+            the next call and the other channels get their turn. The overall
+            limit set by setResponseProcessingTimeLimit still applies.
+        @param channel The channel to limit.
+        @param maxResponses Number of responses per call, 0 for no limit.
+        @param maxMilliseconds Time spent in the response handlers of the
+            channel per call, 0 for no limit.
+        */
+        virtual void setResponseChannelBudget(uint16 channel, size_t maxResponses, unsigned long maxMilliseconds);
+
+        /// Counters of the responses of one channel
+        struct ResponseChannelStats
+        {
+            /// Responses waiting to be processed
+            size_t queued;
+            /// Responses processed since the counters were reset
+            size_t processed;
+            /// Time the last processed response waited, in microseconds
+            unsigned long lastLatency;
+            /// Longest time a processed response waited, in microseconds
+            unsigned long maxLatency;
+            /// Average time the processed responses waited, in microseconds
+            unsigned long averageLatency;
+        };
+
+        /** Get the counters of the responses of a channel.
+        @remarks
+            Latencies are measured from the first processResponses call which
+            could have handled the response, ie. they show how long responses
+            are held back by budgets, priorities and the time limit.
+        */
+        virtual ResponseChannelStats getResponseChannelStats(uint16 channel);
+
+        /// Reset the processed response counters of every channel
+        virtual void resetResponseChannelStats();
     protected:
         String mName;
         size_t mWorkerThreadCount;
@@ -464,10 +522,48 @@ namespace Ogre
         unsigned long mResposeTimeLimitMS;
 
         typedef deque<Request*>::type RequestQueue;
-        typedef deque<Response*>::type ResponseQueue;
         RequestQueue mRequestQueue; // Guarded by mRequestMutex
         RequestQueue mProcessQueue; // Guarded by mProcessMutex
-        ResponseQueue mResponseQueue; // Guarded by mResponseMutex
+
+        /** Responses pushed by the workers, most recent first, linked through
+            Response::mNextQueued. Workers push without locking; the list is
+            taken as a whole into the channel queues, see moveQueuedResponses.
+            Stored as an integer since AtomicScalar doesn't support pointers on
+            every platform.
+        */
+        AtomicScalar<size_t> mQueuedResponses;
+
+        struct QueuedResponse
+        {
+            Response* response;
+            /// Position in the order responses were queued
+            unsigned long long order;
+            /// When processResponses first saw the response, in microseconds
+            unsigned long time;
+        };
+        typedef deque<QueuedResponse>::type ResponseQueue;
+
+        struct ResponseChannel
+        {
+            int priority;
+            size_t maxResponses;
+            unsigned long maxMicroseconds;
+            ResponseQueue responses;
+
+            /// Usage of the budget by the current processResponses call
+            size_t responsesUsed;
+            unsigned long microsecondsUsed;
+
+            size_t numProcessed;
+            unsigned long lastLatency;
+            unsigned long maxLatency;
+            unsigned long long totalLatency;
+
+            ResponseChannel();
+        };
+        typedef map<uint16, ResponseChannel>::type ResponseChannelMap;
+        ResponseChannelMap mResponseChannels; // Guarded by mResponseMutex
+        unsigned long long mResponseOrder; // Guarded by mResponseMutex
 
         /// Thread function
         struct _OgreExport WorkerFunc OGRE_THREAD_WORKER_INHERIT
@@ -560,6 +656,20 @@ namespace Ogre
         void processRequestResponse(Request* r, bool synchronous);
         Response* processRequest(Request* r);
         void processResponse(Response* r);
+        /// Push a response for processResponses, lock-free
+        void queueResponse(Response* r);
+        /** Get the most recent response pushed by the workers, with acquire
+            ordering so that the list can be walked through mNextQueued.
+        */
+        Response* getQueuedResponses(void);
+        /** Move the responses pushed by the workers into the channel queues.
+            mResponseMutex must be locked.
+        */
+        void moveQueuedResponses(unsigned long now);
+        /** Take the next response processResponses should handle, if any.
+            mResponseMutex must be locked.
+        */
+        Response* takeNextResponse(ResponseChannel*& channel, unsigned long now);
         /// Notify workers about a new request. 
         virtual void notifyWorkers() = 0;
         /// Put a Request on the queue with a specific RequestID.
@@ -39,6 +39,9 @@ THE SOFTWARE.
 typedef struct zzip_dir     ZZIP_DIR;
 typedef struct zzip_file    ZZIP_FILE;
 typedef union _zzip_plugin_io zzip_plugin_io_handlers;
+// Forward declaration for zlib
+struct z_stream_s;
+typedef struct z_stream_s z_stream;
 
 namespace Ogre {
 
@@ -53,6 +56,13 @@ namespace Ogre {
     @remarks
         This archive format supports all archives compressed in the standard
         zip format, including iD pk3 files.
+    @par
+        Archives on disk are mapped into memory and read through their central
+        directory, which is kept in a hash table. Files are opened as independent
+        streams onto the mapping, so they can be opened and inflated on several
+        threads at once; stored files are handed out as a view of the mapping
+        without a copy. Archives using features this reader does not handle
+        (zip64, encryption), and embedded archives, are read through zziplib.
     */
     class _OgreExport ZipArchive : public Archive 
     {
@@ -66,6 +76,42 @@ namespace Ogre {
         /// A pointer to file io alternative implementation 
         zzip_plugin_io_handlers* mPluginIo;
 
+        /// Location of a file's data in the mapped archive
+        struct ZipEntry
+        {
+            /// Offset of the local file header from the start of the archive
+            size_t headerOffset;
+            size_t compressedSize;
+            size_t uncompressedSize;
+            /// Compression method, 0 for stored and 8 for deflated
+            uint16 method;
+        };
+        typedef vector<ZipEntry>::type ZipEntryList;
+        /// Maps lower case names to indexes into mFileList
+        typedef OGRE_HashMap<String, size_t> ZipEntryIndex;
+
+        /// The mapped archive, null when reading through zziplib
+        MemoryDataStreamPtr mArchiveData;
+        /// Entries matching mFileList, when the archive is mapped
+        ZipEntryList mEntries;
+        /// Files by full name
+        ZipEntryIndex mEntryIndex;
+        /// Files by base name, names which aren't unique map to -1
+        ZipEntryIndex mBaseNameIndex;
+        /// Files and folders by FileInfo::filename, case sensitive, as exists matches them
+        ZipEntryIndex mFileNameIndex;
+
+        /** Reads the central directory of the mapped archive into mFileList and mEntries.
+        @return false if the archive needs zziplib
+        */
+        bool readCentralDirectory(void);
+        /// Fills the name indexes from mFileList
+        void buildIndex(void);
+        /// Returns the index into mFileList of a file, or -1
+        size_t findEntry(const String& filename) const;
+        /// Opens a file of the mapped archive
+        DataStreamPtr openEntry(size_t index) const;
+
         OGRE_AUTO_MUTEX;
     public:
         ZipArchive(const String& name, const String& archType, zzip_plugin_io_handlers* pluginIo = NULL);
@@ -193,6 +239,57 @@ namespace Ogre {
 
     };
 
+    /** Specialisation of DataStream for stored files of a mapped zip archive.
+    @remarks
+        The stream is a view of the mapping, which it keeps alive.
+    */
+    class _OgrePrivate ZipMappedDataStream : public MemoryDataStream
+    {
+    protected:
+        MemoryDataStreamPtr mArchiveData;
+    public:
+        ZipMappedDataStream(const String& name, const MemoryDataStreamPtr& archiveData,
+            uchar* data, size_t size);
+        /// @copydoc DataStream::close
+        void close(void);
+    };
+
+    /** Specialisation of DataStream for deflated files of a mapped zip archive.
+    @remarks
+        Data is inflated on demand into a buffer the size of the file, which is
+        kept, so seeking backwards never restarts decompression.
+    */
+    class _OgrePrivate ZipInflateDataStream : public DataStream
+    {
+    protected:
+        MemoryDataStreamPtr mArchiveData;
+        z_stream* mZStream;
+        /// Inflated data, allocated on the first read
+        uchar* mBuffer;
+        /// Number of bytes inflated so far
+        size_t mInflated;
+        size_t mPos;
+
+        /// Inflates at least up to the given position
+        void inflateTo(size_t pos);
+    public:
+        ZipInflateDataStream(const String& name, const MemoryDataStreamPtr& archiveData,
+            const uchar* compressedData, size_t compressedSize, size_t uncompressedSize);
+        ~ZipInflateDataStream();
+        /// @copydoc DataStream::read
+        size_t read(void* buf, size_t count);
+        /// @copydoc DataStream::skip
+        void skip(long count);
+        /// @copydoc DataStream::seek
+        void seek(size_t pos);
+        /// @copydoc DataStream::tell
+        size_t tell(void) const;
+        /// @copydoc DataStream::eof
+        bool eof(void) const;
+        /// @copydoc DataStream::close
+        void close(void);
+    };
+
     /** @} */
     /** @} */
 
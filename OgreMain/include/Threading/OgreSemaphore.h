@@ -0,0 +1,71 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __Semaphore_H__
+#define __Semaphore_H__
+
+#include "OgrePlatform.h"
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+    //No need to include the heavy windows.h header for something like this!
+    typedef void* HANDLE;
+#else
+    #include <pthread.h>
+#endif
+
+namespace Ogre
+{
+    /** A counting semaphore, used to put threads to sleep until some work is
+        available for them.
+    @remarks
+        wait() blocks while the count is zero and then decrements it; post()
+        increments it, waking up one waiting thread if any.
+    */
+    class _OgreExport Semaphore
+    {
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        HANDLE          mSemaphore;
+#else
+        //POSIX unnamed semaphores aren't available everywhere (ie. Apple)
+        pthread_mutex_t mMutex;
+        pthread_cond_t  mCondition;
+        size_t          mCount;
+#endif
+
+    public:
+        Semaphore( size_t initialCount = 0 );
+        ~Semaphore();
+
+        /// Blocks until the count is above zero, then decrements it.
+        void wait(void);
+
+        /// Increments the count by the given amount, waking up as many waiting threads.
+        void post( size_t count = 1 );
+    };
+}
+
+#endif
@@ -0,0 +1,269 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __TaskScheduler_H__
+#define __TaskScheduler_H__
+
+#include "OgrePrerequisites.h"
+#include "Threading/OgreThreads.h"
+#include "Threading/OgreBarrier.h"
+#include "Threading/OgreLightweightMutex.h"
+#include "Threading/OgreSemaphore.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+    /** Pool of worker threads running small tasks, with work stealing.
+    @remarks
+        Each worker owns a queue of tasks. A worker takes the most recently
+        queued task from its own queue and, once that is empty, steals the
+        oldest task from the queue of another worker; threads which aren't
+        workers share one more queue. Workers sleep when there's nothing left
+        to steal and are woken up as tasks are submitted.
+    @par
+        Tasks are grouped into TaskGroup instances which can be waited on.
+        While waiting, the calling thread runs the queued tasks of that
+        group, so a scheduler without workers still gets everything done, on
+        the calling thread.
+    @par
+        The queues are guarded by lightweight mutexes: each one is only
+        contended by the owner and a thief, which keeps this a lot cheaper
+        than a single shared queue.
+    */
+    class _OgreExport TaskScheduler : public UtilityAlloc
+    {
+    public:
+        /// Index to pass for threads which aren't workers of the scheduler
+        static const size_t EXTERNAL_THREAD;
+
+        /** A unit of work. */
+        class _OgreExport Task
+        {
+        public:
+            virtual ~Task() {}
+
+            /** Runs the task.
+            @param threadIdx Index of the worker running the task, or
+                EXTERNAL_THREAD if run by a thread waiting on a TaskGroup.
+            */
+            virtual void execute(size_t threadIdx) = 0;
+        };
+
+        /** Tracks the completion of a set of tasks. */
+        class _OgreExport TaskGroup
+        {
+        public:
+            TaskGroup();
+            ~TaskGroup();
+
+            /// Gets whether every task submitted with this group has completed
+            bool isDone(void);
+
+        protected:
+            friend class TaskScheduler;
+
+            LightweightMutex mMutex;
+            /// Tasks submitted but not completed yet
+            size_t mPending;
+            /// Whether a thread sleeps on mCompleted
+            bool mWaiting;
+            Semaphore mCompleted;
+        };
+
+        /** Receives the start and end of the worker threads, ie. to register
+            them with the render system.
+        */
+        class _OgreExport Listener
+        {
+        public:
+            virtual ~Listener() {}
+
+            /// Called from a worker thread before it runs any task
+            virtual void workerThreadStarted(size_t threadIdx) { (void)threadIdx; }
+            /// Called from a worker thread before it ends
+            virtual void workerThreadStopped(size_t threadIdx) { (void)threadIdx; }
+        };
+
+        TaskScheduler();
+        ~TaskScheduler();
+
+        /** Starts the worker threads.
+        @remarks
+            Returns once every worker has started and notified the listener.
+        @param numThreads Number of workers, may be 0.
+        @param listener Optional listener, must outlive the workers.
+        */
+        void startup(size_t numThreads, Listener* listener = 0);
+
+        /** Stops the worker threads once they have run the queued tasks. */
+        void shutdown(void);
+
+        /// Gets the number of worker threads
+        size_t getNumThreads(void) const { return mThreads.size(); }
+
+        /** Queues a task.
+        @param task The task, must stay valid until it has run.
+        @param group Optional group the task belongs to.
+        @param threadIdx The calling worker, which queues the task on its own
+            queue, or EXTERNAL_THREAD.
+        */
+        void submit(Task* task, TaskGroup* group = 0, size_t threadIdx = EXTERNAL_THREAD);
+
+        /** Queues several tasks at once, spread over the worker queues.
+        @param tasks Array of count tasks, which must stay valid until they have run.
+        @param count Number of tasks.
+        @param group Optional group the tasks belong to.
+        */
+        void submit(Task* const* tasks, size_t count, TaskGroup* group = 0);
+
+        /** Blocks until all tasks of a group have completed.
+        @remarks
+            The calling thread runs the queued tasks of the group meanwhile.
+        @param group The group to wait for.
+        @param threadIdx The calling worker, or EXTERNAL_THREAD.
+        */
+        void wait(TaskGroup& group, size_t threadIdx = EXTERNAL_THREAD);
+
+        /** Calls a function over a range of indices, in parallel.
+        @remarks
+            The range is split into chunks of grainSize indices which are run
+            as tasks; returns once all of them have completed.
+        @param begin, end The range of indices.
+        @param grainSize Number of indices per task, the smallest amount of
+            work worth moving to another thread.
+        @param function Called as function(chunkBegin, chunkEnd), possibly
+            from several threads at once.
+        @param threadIdx The calling worker, or EXTERNAL_THREAD.
+        */
+        template <typename Function>
+        void parallelFor(size_t begin, size_t end, size_t grainSize, const Function& function,
+                         size_t threadIdx = EXTERNAL_THREAD)
+        {
+            if (begin >= end)
+                return;
+
+            grainSize = std::max<size_t>(grainSize, 1);
+            const size_t numChunks = (end - begin + grainSize - 1) / grainSize;
+            if (numChunks == 1 || mThreads.empty())
+            {
+                function(begin, end);
+                return;
+            }
+
+            typename vector< RangeTask<Function> >::type tasks;
+            tasks.reserve(numChunks);
+            for (size_t i = begin; i < end; i += grainSize)
+                tasks.push_back(RangeTask<Function>(function, i, std::min(i + grainSize, end)));
+
+            vector<Task*>::type taskPtrs(numChunks);
+            for (size_t i = 0; i < numChunks; ++i)
+                taskPtrs[i] = &tasks[i];
+
+            TaskGroup group;
+            submit(&taskPtrs[0], numChunks, &group);
+            wait(group, threadIdx);
+        }
+
+        /// Internal method, main function of each worker thread.
+        void _threadMain(size_t threadIdx);
+
+    protected:
+        /// Task running a function over a range, see parallelFor
+        template <typename Function>
+        class RangeTask : public Task
+        {
+            const Function* mFunction;
+            size_t mBegin;
+            size_t mEnd;
+
+        public:
+            RangeTask(const Function& function, size_t begin, size_t end)
+                : mFunction(&function), mBegin(begin), mEnd(end) {}
+
+            virtual void execute(size_t threadIdx)
+            {
+                (void)threadIdx;
+                (*mFunction)(mBegin, mEnd);
+            }
+        };
+
+        struct QueuedTask
+        {
+            Task* task;
+            TaskGroup* group;
+
+            QueuedTask() : task(0), group(0) {}
+            QueuedTask(Task* t, TaskGroup* g) : task(t), group(g) {}
+        };
+        typedef deque<QueuedTask>::type TaskDeque;
+
+        struct WorkerQueue
+        {
+            LightweightMutex mutex;
+            TaskDeque tasks;
+        };
+        typedef vector<WorkerQueue*>::type WorkerQueueList;
+        /// One queue per worker, then one for the other threads
+        WorkerQueueList mQueues;
+
+        ThreadHandleVec mThreads;
+        Listener* mListener;
+        Barrier* mStartBarrier;
+
+        /// Guards mNumSleeping and mShuttingDown
+        LightweightMutex mSleepMutex;
+        size_t mNumSleeping;
+        bool mShuttingDown;
+        /// Posted once per sleeping worker to wake up
+        Semaphore mWakeUp;
+        /// Queue the next batch starts to fill, see submit
+        size_t mNextQueue;
+
+        /// Gets the queue of a worker, or the shared one
+        WorkerQueue* getQueue(size_t threadIdx) const;
+        /// Takes a task from the worker's own queue, or steals one
+        bool findTask(size_t threadIdx, QueuedTask& outTask);
+        /// Takes a task of the given group from any queue
+        bool findGroupTask(const TaskGroup* group, QueuedTask& outTask);
+        /// Runs a task and notifies its group
+        void runTask(const QueuedTask& task, size_t threadIdx);
+        /// Wakes up to count sleeping workers
+        void wakeWorkers(size_t count);
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -0,0 +1,97 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __OgreTaskSchedulerWorkQueue_H__
+#define __OgreTaskSchedulerWorkQueue_H__
+
+#include "../OgreWorkQueue.h"
+#include "Threading/OgreTaskScheduler.h"
+
+namespace Ogre
+{
+    /** Request / response work queue running its requests on a TaskScheduler.
+    @remarks
+        Requests, channels and responses behave as with DefaultWorkQueue; each
+        queued request becomes a task of the scheduler, whose workers steal
+        from each other instead of all waiting on the request queue. The
+        scheduler is exposed through getTaskScheduler so engine systems can
+        run parallel work on the same threads.
+    */
+    class _OgreExport TaskSchedulerWorkQueue : public DefaultWorkQueueBase, public TaskScheduler::Listener
+    {
+    public:
+
+        TaskSchedulerWorkQueue(const String& name = BLANKSTRING);
+        virtual ~TaskSchedulerWorkQueue(); 
+
+        /// Processes one request on the calling thread.
+        virtual void _threadMain();
+
+        /// @copydoc WorkQueue::shutdown
+        virtual void shutdown();
+
+        /// @copydoc WorkQueue::startup
+        virtual void startup(bool forceRestart = true);
+
+        /** @copydoc WorkQueue::processResponses
+        @remarks
+            If the scheduler has no worker threads, the requests queued so far
+            are processed first, on the calling thread.
+        */
+        virtual void processResponses();
+
+        /// @copydoc WorkQueue::getTaskScheduler
+        virtual TaskScheduler* getTaskScheduler() { return &mScheduler; }
+
+        /// @copydoc TaskScheduler::Listener::workerThreadStarted
+        virtual void workerThreadStarted(size_t threadIdx);
+
+        /// @copydoc TaskScheduler::Listener::workerThreadStopped
+        virtual void workerThreadStopped(size_t threadIdx);
+
+    protected:
+        /// Task processing the next request of the queue
+        class _OgreExport RequestTask : public TaskScheduler::Task
+        {
+            TaskSchedulerWorkQueue* mQueue;
+
+        public:
+            RequestTask(TaskSchedulerWorkQueue* queue) : mQueue(queue) {}
+
+            virtual void execute(size_t threadIdx);
+        };
+
+        virtual void notifyWorkers();
+
+        TaskScheduler mScheduler;
+        /// Stateless, submitted once per queued request
+        RequestTask mRequestTask;
+    };
+
+}
+
+#endif
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreSkeleton.h"
 #include "OgreBone.h"
 #include "OgreMesh.h"
+#include "OgreBakedNodeAnimation.h"
 
 #include "OgreSubEntity.h"
 
@@ -48,6 +49,10 @@ namespace Ogre {
         , mInterpolationMode(msDefaultInterpolationMode)
         , mRotationInterpolationMode(msDefaultRotationInterpolationMode)
         , mKeyFrameTimesDirty(false)
+        , mUseBakedNodeTracks(false)
+        , mBakedNodeTracksDirty(true)
+        , mBakedNodeTracks(0)
+        , mNodeTracksCompressed(false)
         , mUseBaseKeyFrame(false)
         , mBaseKeyFrameTime(0.0f)
         , mBaseKeyFrameAnimationName(BLANKSTRING)
@@ -58,6 +63,7 @@ namespace Ogre {
     Animation::~Animation()
     {
         destroyAllTracks();
+        OGRE_DELETE mBakedNodeTracks;
     }
     //---------------------------------------------------------------------
     Real Animation::getLength(void) const
@@ -71,6 +77,25 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     NodeAnimationTrack* Animation::createNodeTrack(unsigned short handle)
+    {
+        // The new track would have no compressed keyframes
+        decompressNodeTracks();
+
+        return createNodeTrackImpl(handle);
+    }
+    //---------------------------------------------------------------------
+    NodeAnimationTrack* Animation::_createCompressedNodeTrack(unsigned short handle, Node* node)
+    {
+        assert(mNodeTracksCompressed && "Node tracks are not compressed");
+
+        NodeAnimationTrack* ret = createNodeTrackImpl(handle);
+
+        ret->setAssociatedNode(node);
+
+        return ret;
+    }
+    //---------------------------------------------------------------------
+    NodeAnimationTrack* Animation::createNodeTrackImpl(unsigned short handle)
     {
         if (hasNodeTrack(handle))
         {
@@ -129,6 +154,8 @@ namespace Ogre {
         {
             OGRE_DELETE i->second;
             mNodeTrackList.erase(i);
+            if (mNodeTracksCompressed)
+                mBakedNodeTracks->_removeTrack(handle);
             _keyFrameListChanged();
         }
     }
@@ -141,6 +168,12 @@ namespace Ogre {
             OGRE_DELETE i->second;
         }
         mNodeTrackList.clear();
+        if (mNodeTracksCompressed)
+        {
+            OGRE_DELETE mBakedNodeTracks;
+            mBakedNodeTracks = 0;
+            mNodeTracksCompressed = false;
+        }
         _keyFrameListChanged();
     }
     //---------------------------------------------------------------------
@@ -315,10 +348,17 @@ namespace Ogre {
         // Calculate time index for fast keyframe search
         TimeIndex timeIndex = _getTimeIndex(timePos);
 
-        NodeTrackList::iterator i;
-        for (i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+        if (mNodeTracksCompressed)
+        {
+            mBakedNodeTracks->apply(0, 0, timeIndex.getTimePos(), weight, 0, scale, 0);
+        }
+        else
         {
-            i->second->apply(timeIndex, weight, scale);
+            NodeTrackList::iterator i;
+            for (i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+            {
+                i->second->apply(timeIndex, weight, scale);
+            }
         }
         NumericTrackList::iterator j;
         for (j = mNumericTrackList.begin(); j != mNumericTrackList.end(); ++j)
@@ -337,6 +377,12 @@ namespace Ogre {
     {
         _applyBaseKeyFrame();
 
+        if (mNodeTracksCompressed)
+        {
+            mBakedNodeTracks->apply(0, node, _wrapTimePos(timePos), weight, 0, scale, 0);
+            return;
+        }
+
         // Calculate time index for fast keyframe search
         TimeIndex timeIndex = _getTimeIndex(timePos);
 
@@ -348,10 +394,17 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     void Animation::apply(Skeleton* skel, Real timePos, Real weight, 
-        Real scale)
+        Real scale, AnimationState::KeyFrameCursor* cursor)
     {
         _applyBaseKeyFrame();
 
+        BakedNodeAnimation* baked = getBakedNodeTracks();
+        if (baked)
+        {
+            baked->apply(skel, 0, _wrapTimePos(timePos), weight, 0, scale, cursor);
+            return;
+        }
+
         // Calculate time index for fast keyframe search
         TimeIndex timeIndex = _getTimeIndex(timePos);
 
@@ -367,10 +420,18 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     void Animation::apply(Skeleton* skel, Real timePos, float weight,
-      const AnimationState::BoneBlendMask* blendMask, Real scale)
+      const AnimationState::BoneBlendMask* blendMask, Real scale,
+      AnimationState::KeyFrameCursor* cursor)
     {
         _applyBaseKeyFrame();
 
+        BakedNodeAnimation* baked = getBakedNodeTracks();
+        if (baked)
+        {
+            baked->apply(skel, 0, _wrapTimePos(timePos), weight, blendMask, scale, cursor);
+            return;
+        }
+
         // Calculate time index for fast keyframe search
       TimeIndex timeIndex = _getTimeIndex(timePos);
 
@@ -531,8 +592,9 @@ namespace Ogre {
         iend = mNodeTrackList.end();
         for (i = mNodeTrackList.begin(); i != iend; ++i)
         {
+            // Compressed tracks are kept as they are
             const NodeAnimationTrack* track = i->second;
-            if (track->hasNonZeroKeyFrames())
+            if (mNodeTracksCompressed || track->hasNonZeroKeyFrames())
             {
                 tracks.erase(i->first);
             }
@@ -551,6 +613,10 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Animation::optimiseNodeTracks(bool discardIdentityTracks)
     {
+        // Compression already dropped the redundant keyframes
+        if (mNodeTracksCompressed)
+            return;
+
         // Iterate over the node tracks and identify those with no useful keyframes
         list<unsigned short>::type tracksToDestroy;
         NodeTrackList::iterator i;
@@ -611,6 +677,7 @@ namespace Ogre {
         Animation* newAnim = OGRE_NEW Animation(newName, mLength);
         newAnim->mInterpolationMode = mInterpolationMode;
         newAnim->mRotationInterpolationMode = mRotationInterpolationMode;
+        newAnim->mUseBakedNodeTracks = mUseBakedNodeTracks;
         
         // Clone all tracks
         for (NodeTrackList::const_iterator i = mNodeTrackList.begin();
@@ -618,6 +685,12 @@ namespace Ogre {
         {
             i->second->_clone(newAnim);
         }
+        if (mNodeTracksCompressed)
+        {
+            newAnim->mBakedNodeTracks = OGRE_NEW BakedNodeAnimation(*mBakedNodeTracks);
+            newAnim->mBakedNodeTracks->_relink(newAnim);
+            newAnim->mNodeTracksCompressed = true;
+        }
         for (NumericTrackList::const_iterator i = mNumericTrackList.begin();
             i != mNumericTrackList.end(); ++i)
         {
@@ -645,17 +718,118 @@ namespace Ogre {
             buildKeyFrameTimeList();
         }
 
+        timePos = _wrapTimePos(timePos);
+
+        // Search for global index
+        KeyFrameTimeList::iterator it =
+            std::lower_bound(mKeyFrameTimes.begin(), mKeyFrameTimes.end(), timePos);
+
+        return TimeIndex(timePos, static_cast<uint>(std::distance(mKeyFrameTimes.begin(), it)));
+    }
+    //-----------------------------------------------------------------------
+    Real Animation::_wrapTimePos(Real timePos) const
+    {
         // Wrap time
         Real totalAnimationLength = mLength;
 
         if( timePos > totalAnimationLength && totalAnimationLength > 0.0f )
             timePos = fmod( timePos, totalAnimationLength );
 
-        // Search for global index
-        KeyFrameTimeList::iterator it =
-            std::lower_bound(mKeyFrameTimes.begin(), mKeyFrameTimes.end(), timePos);
+        return timePos;
+    }
+    //-----------------------------------------------------------------------
+    void Animation::setUseBakedNodeTracks(bool baked)
+    {
+        mUseBakedNodeTracks = baked;
+        if (!baked && !mNodeTracksCompressed)
+        {
+            OGRE_DELETE mBakedNodeTracks;
+            mBakedNodeTracks = 0;
+            mBakedNodeTracksDirty = true;
+        }
+    }
+    //-----------------------------------------------------------------------
+    BakedNodeAnimation* Animation::getBakedNodeTracks(void)
+    {
+        if (mNodeTracksCompressed)
+            return mBakedNodeTracks;
 
-        return TimeIndex(timePos, static_cast<uint>(std::distance(mKeyFrameTimes.begin(), it)));
+        if (!mUseBakedNodeTracks || mInterpolationMode != IM_LINEAR)
+            return 0;
+
+        if (!mBakedNodeTracks)
+        {
+            mBakedNodeTracks = OGRE_NEW BakedNodeAnimation();
+            mBakedNodeTracksDirty = true;
+        }
+        if (mBakedNodeTracksDirty)
+        {
+            mBakedNodeTracks->bake(this);
+            mBakedNodeTracksDirty = false;
+        }
+        return mBakedNodeTracks;
+    }
+    //-----------------------------------------------------------------------
+    void Animation::compressNodeTracks(Real positionTolerance,
+        const Radian& rotationTolerance, Real scaleTolerance)
+    {
+        // Start again from the full keyframes, relative to the base keyframe
+        decompressNodeTracks();
+        _applyBaseKeyFrame();
+
+        if (!mBakedNodeTracks)
+            mBakedNodeTracks = OGRE_NEW BakedNodeAnimation();
+        mBakedNodeTracks->bakeCompressed(this, positionTolerance, rotationTolerance, scaleTolerance);
+        mNodeTracksCompressed = true;
+
+        for (NodeTrackList::iterator i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+        {
+            i->second->removeAllKeyFrames();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Animation::decompressNodeTracks(void)
+    {
+        if (!mNodeTracksCompressed)
+            return;
+
+        BakedNodeAnimation* compressed = mBakedNodeTracks;
+        mBakedNodeTracks = 0;
+        mNodeTracksCompressed = false;
+
+        for (size_t t = 0; t < compressed->getNumTracks(); ++t)
+        {
+            NodeAnimationTrack* track = getNodeTrack(compressed->getTrackHandle(t));
+            const unsigned short numKeyFrames = compressed->getNumKeyFrames(t);
+            for (unsigned short k = 0; k < numKeyFrames; ++k)
+            {
+                Real time;
+                Vector3 translate, scale;
+                Quaternion rotation;
+                compressed->getKeyFrame(t, k, time, translate, rotation, scale);
+
+                TransformKeyFrame* kf = track->createNodeKeyFrame(time);
+                kf->setTranslate(translate);
+                kf->setRotation(rotation);
+                kf->setScale(scale);
+            }
+        }
+        OGRE_DELETE compressed;
+        _keyFrameListChanged();
+    }
+    //-----------------------------------------------------------------------
+    BakedNodeAnimation* Animation::_createCompressedNodeTracks(void)
+    {
+        for (NodeTrackList::iterator i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+        {
+            i->second->removeAllKeyFrames();
+        }
+
+        if (!mBakedNodeTracks)
+            mBakedNodeTracks = OGRE_NEW BakedNodeAnimation();
+        mBakedNodeTracks->_initCompressed(this);
+        mNodeTracksCompressed = true;
+        return mBakedNodeTracks;
     }
     //-----------------------------------------------------------------------
     void Animation::buildKeyFrameTimeList(void) const
@@ -736,6 +910,8 @@ namespace Ogre {
             
             if (baseAnim)
             {
+                const BakedNodeAnimation* baseCompressed = baseAnim->_getCompressedNodeTracks();
+
                 for (NodeTrackList::iterator i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
                 {
                     NodeAnimationTrack* track = i->second;
@@ -747,8 +923,30 @@ namespace Ogre {
                         baseTrack = baseAnim->getNodeTrack(track->getHandle());
                     
                     TransformKeyFrame kf(baseTrack, mBaseKeyFrameTime);
-                    baseTrack->getInterpolatedKeyFrame(baseAnim->_getTimeIndex(mBaseKeyFrameTime), &kf);
-                    track->_applyBaseKeyFrame(&kf);
+                    if (baseCompressed)
+                    {
+                        const size_t index = baseCompressed->findTrack(track->getHandle());
+                        if (index != baseCompressed->getNumTracks())
+                        {
+                            baseCompressed->getInterpolatedKeyFrame(index,
+                                baseAnim->_wrapTimePos(mBaseKeyFrameTime), &kf);
+                        }
+                    }
+                    else
+                    {
+                        baseTrack->getInterpolatedKeyFrame(baseAnim->_getTimeIndex(mBaseKeyFrameTime), &kf);
+                    }
+                    if (mNodeTracksCompressed)
+                    {
+                        // Rebased without quantising the keyframes again
+                        const size_t index = mBakedNodeTracks->findTrack(track->getHandle());
+                        if (index != mBakedNodeTracks->getNumTracks())
+                            mBakedNodeTracks->_applyBaseKeyFrame(index, &kf);
+                    }
+                    else
+                    {
+                        track->_applyBaseKeyFrame(&kf);
+                    }
                 }
                 
                 for (VertexTrackList::iterator i = mVertexTrackList.begin(); i != mVertexTrackList.end(); ++i)
@@ -484,8 +484,14 @@ namespace Ogre {
         TransformKeyFrame kf(0, timeIndex.getTimePos());
         getInterpolatedKeyFrame(timeIndex, &kf);
 
+        _applyKeyFrameToNode(node, kf.getTranslate(), kf.getRotation(), kf.getScale(), weight, scl);
+    }
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::_applyKeyFrameToNode(Node* node, const Vector3& kfTranslate,
+        const Quaternion& kfRotation, const Vector3& kfScale, Real weight, Real scl) const
+    {
         // add to existing. Weights are not relative, but treated as absolute multipliers for the animation
-        Vector3 translate = kf.getTranslate() * weight * scl;
+        Vector3 translate = kfTranslate * weight * scl;
         node->translate(translate);
 
         // interpolate between no-rotation and full rotation, to point 'weight', so 0 = no rotate, 1 = full
@@ -494,15 +500,15 @@ namespace Ogre {
             mParent->getRotationInterpolationMode();
         if (rim == Animation::RIM_LINEAR)
         {
-            rotate = Quaternion::nlerp(weight, Quaternion::IDENTITY, kf.getRotation(), mUseShortestRotationPath);
+            rotate = Quaternion::nlerp(weight, Quaternion::IDENTITY, kfRotation, mUseShortestRotationPath);
         }
         else //if (rim == Animation::RIM_SPHERICAL)
         {
-            rotate = Quaternion::Slerp(weight, Quaternion::IDENTITY, kf.getRotation(), mUseShortestRotationPath);
+            rotate = Quaternion::Slerp(weight, Quaternion::IDENTITY, kfRotation, mUseShortestRotationPath);
         }
         node->rotate(rotate);
 
-        Vector3 scale = kf.getScale();
+        Vector3 scale = kfScale;
         // Not sure how to modify scale for cumulative anims... leave it alone
         //scale = ((Vector3::UNIT_SCALE - kf.getScale()) * weight) + Vector3::UNIT_SCALE;
         if (scale != Vector3::UNIT_SCALE)
@@ -569,6 +575,8 @@ namespace Ogre {
     void NodeAnimationTrack::_keyFrameDataChanged(void) const
     {
         mSplineBuildNeeded = true;
+        if (mParent)
+            mParent->_keyFrameDataChanged();
     }
     //---------------------------------------------------------------------
     bool NodeAnimationTrack::hasNonZeroKeyFrames(void) const
@@ -657,6 +665,10 @@ namespace Ogre {
     //--------------------------------------------------------------------------
     KeyFrame* NodeAnimationTrack::createKeyFrameImpl(Real time)
     {
+        // Compressed keyframes would hide the new one
+        if (mParent)
+            mParent->decompressNodeTracks();
+
         return OGRE_NEW TransformKeyFrame(this, time);
     }
     //--------------------------------------------------------------------------
@@ -48,6 +48,7 @@ namespace Ogre {
         0,      0,    1,    0,
         0,      0,    0,    1);
 
+    AtomicScalar<uint64> AutoParamDataSource::msLastVersion(0);
     //-----------------------------------------------------------------------------
     AutoParamDataSource::AutoParamDataSource()
         : mWorldMatrixCount(0),
@@ -69,6 +70,21 @@ namespace Ogre {
          mSceneDepthRangeDirty(true),
          mLodCameraPositionDirty(true),
          mLodCameraPositionObjectSpaceDirty(true),
+         mTransposeWorldMatrixDirty(true),
+         mTransposeWorldViewMatrixDirty(true),
+         mTransposeWorldViewProjMatrixDirty(true),
+         mInverseWorldViewProjMatrixDirty(true),
+         mInverseTransposeWorldViewProjMatrixDirty(true),
+         mTransposeViewMatrixDirty(true),
+         mInverseTransposeViewMatrixDirty(true),
+         mTransposeProjectionMatrixDirty(true),
+         mInverseProjectionMatrixDirty(true),
+         mInverseTransposeProjectionMatrixDirty(true),
+         mTransposeViewProjMatrixDirty(true),
+         mInverseViewProjMatrixDirty(true),
+         mInverseTransposeViewProjMatrixDirty(true),
+         mIdentityView(false),
+         mIdentityProjection(false),
          mCurrentRenderable(0),
          mCurrentCamera(0), 
          mCameraRelativeRendering(false),
@@ -91,7 +107,7 @@ namespace Ogre {
             mCurrentTextureProjector[i] = 0;
             mShadowCamDepthRangesDirty[i] = false;
         }
-
+        markChanged(GPV_ALL);
     }
     //-----------------------------------------------------------------------------
     AutoParamDataSource::~AutoParamDataSource()
@@ -116,20 +132,19 @@ namespace Ogre {
         }        
     }
     //-----------------------------------------------------------------------------
-    void AutoParamDataSource::setCurrentRenderable(const Renderable* rend)
+    void AutoParamDataSource::markWorldMatricesDirty(void)
     {
-        mCurrentRenderable = rend;
-        mWorldMatrixDirty = true;
-        mViewMatrixDirty = true;
-        mProjMatrixDirty = true;
         mWorldViewMatrixDirty = true;
-        mViewProjMatrixDirty = true;
         mWorldViewProjMatrixDirty = true;
         mInverseWorldMatrixDirty = true;
-        mInverseViewMatrixDirty = true;
         mInverseWorldViewMatrixDirty = true;
         mInverseTransposeWorldMatrixDirty = true;
         mInverseTransposeWorldViewMatrixDirty = true;
+        mTransposeWorldMatrixDirty = true;
+        mTransposeWorldViewMatrixDirty = true;
+        mTransposeWorldViewProjMatrixDirty = true;
+        mInverseWorldViewProjMatrixDirty = true;
+        mInverseTransposeWorldViewProjMatrixDirty = true;
         mCameraPositionObjectSpaceDirty = true;
         mLodCameraPositionObjectSpaceDirty = true;
         for(size_t i = 0; i < OGRE_MAX_SIMULTANEOUS_LIGHTS; ++i)
@@ -137,26 +152,115 @@ namespace Ogre {
             mTextureWorldViewProjMatrixDirty[i] = true;
             mSpotlightWorldViewProjMatrixDirty[i] = true;
         }
-
     }
     //-----------------------------------------------------------------------------
-    void AutoParamDataSource::setCurrentCamera(const Camera* cam, bool useCameraRelative)
+    void AutoParamDataSource::markViewMatrixDirty(void)
     {
-        mCurrentCamera = cam;
-        mCameraRelativeRendering = useCameraRelative;
-        mCameraRelativePosition = cam->getDerivedPosition();
         mViewMatrixDirty = true;
-        mProjMatrixDirty = true;
-        mWorldViewMatrixDirty = true;
         mViewProjMatrixDirty = true;
-        mWorldViewProjMatrixDirty = true;
         mInverseViewMatrixDirty = true;
+        mWorldViewMatrixDirty = true;
+        mWorldViewProjMatrixDirty = true;
         mInverseWorldViewMatrixDirty = true;
         mInverseTransposeWorldViewMatrixDirty = true;
+        mTransposeViewMatrixDirty = true;
+        mInverseTransposeViewMatrixDirty = true;
+        mTransposeViewProjMatrixDirty = true;
+        mInverseViewProjMatrixDirty = true;
+        mInverseTransposeViewProjMatrixDirty = true;
+        mTransposeWorldViewMatrixDirty = true;
+        mTransposeWorldViewProjMatrixDirty = true;
+        mInverseWorldViewProjMatrixDirty = true;
+        mInverseTransposeWorldViewProjMatrixDirty = true;
+    }
+    //-----------------------------------------------------------------------------
+    void AutoParamDataSource::markProjectionMatrixDirty(void)
+    {
+        mProjMatrixDirty = true;
+        mViewProjMatrixDirty = true;
+        mWorldViewProjMatrixDirty = true;
+        mTransposeProjectionMatrixDirty = true;
+        mInverseProjectionMatrixDirty = true;
+        mInverseTransposeProjectionMatrixDirty = true;
+        mTransposeViewProjMatrixDirty = true;
+        mInverseViewProjMatrixDirty = true;
+        mInverseTransposeViewProjMatrixDirty = true;
+        mTransposeWorldViewProjMatrixDirty = true;
+        mInverseWorldViewProjMatrixDirty = true;
+        mInverseTransposeWorldViewProjMatrixDirty = true;
+    }
+    //-----------------------------------------------------------------------------
+    void AutoParamDataSource::markChanged(uint16 variability)
+    {
+        // Versions are shared between data sources so that parameters updated from 
+        // another source never see a matching version
+        if (variability & GPV_GLOBAL)
+            mGlobalVersion = ++msLastVersion;
+        if (variability & GPV_PER_OBJECT)
+            mPerObjectVersion = ++msLastVersion;
+        if (variability & GPV_LIGHTS)
+            mLightsVersion = ++msLastVersion;
+    }
+    //-----------------------------------------------------------------------------
+    uint64 AutoParamDataSource::getVariabilityVersion(GpuParamVariability variability) const
+    {
+        switch(variability)
+        {
+        case GPV_GLOBAL:
+            return mGlobalVersion;
+        case GPV_PER_OBJECT:
+            return mPerObjectVersion;
+        case GPV_LIGHTS:
+            return mLightsVersion;
+        default:
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
+                "Only the global, per object and lights variabilities have versions",
+                "AutoParamDataSource::getVariabilityVersion");
+        }
+    }
+    //-----------------------------------------------------------------------------
+    void AutoParamDataSource::setCurrentRenderable(const Renderable* rend)
+    {
+        mCurrentRenderable = rend;
+        mWorldMatrixDirty = true;
+        markWorldMatricesDirty();
+
+        // The view and projection only change with the renderable if it
+        // asks for identity ones, then everything derived from them changes
+        bool identityView = rend && rend->getUseIdentityView();
+        bool identityProjection = rend && rend->getUseIdentityProjection();
+        if (identityView != mIdentityView || identityProjection != mIdentityProjection)
+        {
+            if (identityView != mIdentityView)
+            {
+                markViewMatrixDirty();
+                mIdentityView = identityView;
+            }
+            if (identityProjection != mIdentityProjection)
+            {
+                markProjectionMatrixDirty();
+                mIdentityProjection = identityProjection;
+            }
+            markChanged(GPV_ALL);
+        }
+        else
+        {
+            markChanged(GPV_PER_OBJECT);
+        }
+    }
+    //-----------------------------------------------------------------------------
+    void AutoParamDataSource::setCurrentCamera(const Camera* cam, bool useCameraRelative)
+    {
+        mCurrentCamera = cam;
+        mCameraRelativeRendering = useCameraRelative;
+        mCameraRelativePosition = cam->getDerivedPosition();
+        markViewMatrixDirty();
+        markProjectionMatrixDirty();
         mCameraPositionObjectSpaceDirty = true;
         mCameraPositionDirty = true;
         mLodCameraPositionObjectSpaceDirty = true;
         mLodCameraPositionDirty = true;
+        markChanged(GPV_ALL);
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentLightList(const LightList* ll)
@@ -167,7 +271,7 @@ namespace Ogre {
             mSpotlightViewProjMatrixDirty[i] = true;
             mSpotlightWorldViewProjMatrixDirty[i] = true;
         }
-
+        markChanged(GPV_LIGHTS);
     }
     //---------------------------------------------------------------------
     float AutoParamDataSource::getLightNumber(size_t index) const
@@ -267,11 +371,13 @@ namespace Ogre {
     {
         mMainCamBoundsInfo = info;
         mSceneDepthRangeDirty = true;
+        markChanged(GPV_ALL);
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentSceneManager(const SceneManager* sm)
     {
         mCurrentSceneManager = sm;
+        markChanged(GPV_ALL);
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setWorldMatrices(const Matrix4* m, size_t count)
@@ -279,6 +385,8 @@ namespace Ogre {
         mWorldMatrixArray = m;
         mWorldMatrixCount = count;
         mWorldMatrixDirty = false;
+        markWorldMatricesDirty();
+        markChanged(GPV_PER_OBJECT);
     }
     //-----------------------------------------------------------------------------
     const Matrix4& AutoParamDataSource::getWorldMatrix(void) const
@@ -521,7 +629,11 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setAmbientLightColour(const ColourValue& ambient)
     {
-        mAmbientLight = ambient;
+        if (mAmbientLight != ambient)
+        {
+            mAmbientLight = ambient;
+            markChanged(GPV_GLOBAL);
+        }
     }
     //---------------------------------------------------------------------
     float AutoParamDataSource::getLightCount() const
@@ -627,11 +739,14 @@ namespace Ogre {
         Real expDensity, Real linearStart, Real linearEnd)
     {
         (void)mode; // ignored
-        mFogColour = colour;
-        mFogParams.x = expDensity;
-        mFogParams.y = linearStart;
-        mFogParams.z = linearEnd;
-        mFogParams.w = linearEnd != linearStart ? 1 / (linearEnd - linearStart) : 0;
+        Vector4 params(expDensity, linearStart, linearEnd,
+            linearEnd != linearStart ? 1 / (linearEnd - linearStart) : 0);
+        if (mFogColour != colour || mFogParams != params)
+        {
+            mFogColour = colour;
+            mFogParams = params;
+            markChanged(GPV_GLOBAL);
+        }
     }
     //-----------------------------------------------------------------------------
     const ColourValue& AutoParamDataSource::getFogColour(void) const
@@ -652,6 +767,7 @@ namespace Ogre {
             mTextureViewProjMatrixDirty[index] = true;
             mTextureWorldViewProjMatrixDirty[index] = true;
             mShadowCamDepthRangesDirty[index] = true;
+            markChanged(GPV_ALL);
         }
 
     }
@@ -802,6 +918,9 @@ namespace Ogre {
     void AutoParamDataSource::setCurrentRenderTarget(const RenderTarget* target)
     {
         mCurrentRenderTarget = target;
+        // Flipping is applied to the projection
+        markProjectionMatrixDirty();
+        markChanged(GPV_ALL);
     }
     //-----------------------------------------------------------------------------
     const RenderTarget* AutoParamDataSource::getCurrentRenderTarget(void) const
@@ -812,11 +931,13 @@ namespace Ogre {
     void AutoParamDataSource::setCurrentViewport(const Viewport* viewport)
     {
         mCurrentViewport = viewport;
+        markChanged(GPV_ALL);
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setShadowDirLightExtrusionDistance(Real dist)
     {
         mDirLightExtrusionDistance = dist;
+        markChanged(GPV_LIGHTS);
     }
     //-----------------------------------------------------------------------------
     Real AutoParamDataSource::getShadowExtrusionDistance(void) const
@@ -841,69 +962,134 @@ namespace Ogre {
         return mCurrentRenderable;
     }
     //-----------------------------------------------------------------------------
-    Matrix4 AutoParamDataSource::getInverseViewProjMatrix(void) const
+    const Matrix4& AutoParamDataSource::getInverseViewProjMatrix(void) const
     {
-        return this->getViewProjectionMatrix().inverse();
+        if (mInverseViewProjMatrixDirty)
+        {
+            mInverseViewProjMatrix = getViewProjectionMatrix().inverse();
+            mInverseViewProjMatrixDirty = false;
+        }
+        return mInverseViewProjMatrix;
     }
     //-----------------------------------------------------------------------------
-    Matrix4 AutoParamDataSource::getInverseTransposeViewProjMatrix(void) const
+    const Matrix4& AutoParamDataSource::getInverseTransposeViewProjMatrix(void) const
     {
-        return this->getInverseViewProjMatrix().transpose();
+        if (mInverseTransposeViewProjMatrixDirty)
+        {
+            mInverseTransposeViewProjMatrix = getInverseViewProjMatrix().transpose();
+            mInverseTransposeViewProjMatrixDirty = false;
+        }
+        return mInverseTransposeViewProjMatrix;
     }
     //-----------------------------------------------------------------------------
-    Matrix4 AutoParamDataSource::getTransposeViewProjMatrix(void) const
+    const Matrix4& AutoParamDataSource::getTransposeViewProjMatrix(void) const
     {
-        return this->getViewProjectionMatrix().transpose();
+        if (mTransposeViewProjMatrixDirty)
+        {
+            mTransposeViewProjMatrix = getViewProjectionMatrix().transpose();
+            mTransposeViewProjMatrixDirty = false;
+        }
+        return mTransposeViewProjMatrix;
     }
     //-----------------------------------------------------------------------------
-    Matrix4 AutoParamDataSource::getTransposeViewMatrix(void) const
+    const Matrix4& AutoParamDataSource::getTransposeViewMatrix(void) const
     {
-        return this->getViewMatrix().transpose();
+        if (mTransposeViewMatrixDirty)
+        {
+            mTransposeViewMatrix = getViewMatrix().transpose();
+            mTransposeViewMatrixDirty = false;
+        }
+        return mTransposeViewMatrix;
     }
     //-----------------------------------------------------------------------------
-    Matrix4 AutoParamDataSource::getInverseTransposeViewMatrix(void) const
+    const Matrix4& AutoParamDataSource::getInverseTransposeViewMatrix(void) const
     {
-        return this->getInverseViewMatrix().transpose();
+        if (mInverseTransposeViewMatrixDirty)
+        {
+            mInverseTransposeViewMatrix = getInverseViewMatrix().transpose();
+            mInverseTransposeViewMatrixDirty = false;
+        }
+        return mInverseTransposeViewMatrix;
     }
     //-----------------------------------------------------------------------------
-    Matrix4 AutoParamDataSource::getTransposeProjectionMatrix(void) const
+    const Matrix4& AutoParamDataSource::getTransposeProjectionMatrix(void) const
     {
-        return this->getProjectionMatrix().transpose();
+        if (mTransposeProjectionMatrixDirty)
+        {
+            mTransposeProjectionMatrix = getProjectionMatrix().transpose();
+            mTransposeProjectionMatrixDirty = false;
+        }
+        return mTransposeProjectionMatrix;
     }
     //-----------------------------------------------------------------------------
-    Matrix4 AutoParamDataSource::getInverseProjectionMatrix(void) const 
+    const Matrix4& AutoParamDataSource::getInverseProjectionMatrix(void) const
     {
-        return this->getProjectionMatrix().inverse();
+        if (mInverseProjectionMatrixDirty)
+        {
+            mInverseProjectionMatrix = getProjectionMatrix().inverse();
+            mInverseProjectionMatrixDirty = false;
+        }
+        return mInverseProjectionMatrix;
     }
     //-----------------------------------------------------------------------------
-    Matrix4 AutoParamDataSource::getInverseTransposeProjectionMatrix(void) const
+    const Matrix4& AutoParamDataSource::getInverseTransposeProjectionMatrix(void) const
     {
-        return this->getInverseProjectionMatrix().transpose();
+        if (mInverseTransposeProjectionMatrixDirty)
+        {
+            mInverseTransposeProjectionMatrix = getInverseProjectionMatrix().transpose();
+            mInverseTransposeProjectionMatrixDirty = false;
+        }
+        return mInverseTransposeProjectionMatrix;
     }
     //-----------------------------------------------------------------------------
-    Matrix4 AutoParamDataSource::getTransposeWorldViewProjMatrix(void) const
+    const Matrix4& AutoParamDataSource::getTransposeWorldViewProjMatrix(void) const
     {
-        return this->getWorldViewProjMatrix().transpose();
+        if (mTransposeWorldViewProjMatrixDirty)
+        {
+            mTransposeWorldViewProjMatrix = getWorldViewProjMatrix().transpose();
+            mTransposeWorldViewProjMatrixDirty = false;
+        }
+        return mTransposeWorldViewProjMatrix;
     }
     //-----------------------------------------------------------------------------
-    Matrix4 AutoParamDataSource::getInverseWorldViewProjMatrix(void) const
+    const Matrix4& AutoParamDataSource::getInverseWorldViewProjMatrix(void) const
     {
-        return this->getWorldViewProjMatrix().inverse();
+        if (mInverseWorldViewProjMatrixDirty)
+        {
+            mInverseWorldViewProjMatrix = getWorldViewProjMatrix().inverse();
+            mInverseWorldViewProjMatrixDirty = false;
+        }
+        return mInverseWorldViewProjMatrix;
     }
     //-----------------------------------------------------------------------------
-    Matrix4 AutoParamDataSource::getInverseTransposeWorldViewProjMatrix(void) const
+    const Matrix4& AutoParamDataSource::getInverseTransposeWorldViewProjMatrix(void) const
     {
-        return this->getInverseWorldViewProjMatrix().transpose();
+        if (mInverseTransposeWorldViewProjMatrixDirty)
+        {
+            mInverseTransposeWorldViewProjMatrix = getInverseWorldViewProjMatrix().transpose();
+            mInverseTransposeWorldViewProjMatrixDirty = false;
+        }
+        return mInverseTransposeWorldViewProjMatrix;
     }
     //-----------------------------------------------------------------------------
-    Matrix4 AutoParamDataSource::getTransposeWorldViewMatrix(void) const
+    const Matrix4& AutoParamDataSource::getTransposeWorldViewMatrix(void) const
     {
-        return this->getWorldViewMatrix().transpose();
+        if (mTransposeWorldViewMatrixDirty)
+        {
+            mTransposeWorldViewMatrix = getWorldViewMatrix().transpose();
+            mTransposeWorldViewMatrixDirty = false;
+        }
+        return mTransposeWorldViewMatrix;
     }
     //-----------------------------------------------------------------------------
-    Matrix4 AutoParamDataSource::getTransposeWorldMatrix(void) const
+    const Matrix4& AutoParamDataSource::getTransposeWorldMatrix(void) const
     {
-        return this->getWorldMatrix().transpose();
+        if (mTransposeWorldMatrixDirty)
+        {
+            mTransposeWorldMatrix = getWorldMatrix().transpose();
+            mTransposeWorldMatrixDirty = false;
+        }
+        return mTransposeWorldMatrix;
     }
     //-----------------------------------------------------------------------------
     Real AutoParamDataSource::getTime(void) const
@@ -1056,12 +1242,17 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setPassNumber(const int passNumber)
     {
-        mPassNumber = passNumber;
+        if (mPassNumber != passNumber)
+        {
+            mPassNumber = passNumber;
+            markChanged(GPV_GLOBAL);
+        }
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::incPassNumber(void)
     {
         ++mPassNumber;
+        markChanged(GPV_GLOBAL);
     }
     //-----------------------------------------------------------------------------
     const Vector4& AutoParamDataSource::getSceneDepthRange() const
@@ -0,0 +1,720 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreBakedNodeAnimation.h"
+#include "OgreAnimation.h"
+#include "OgreAnimationTrack.h"
+#include "OgreKeyFrame.h"
+#include "OgreSkeleton.h"
+#include "OgreBone.h"
+#include "OgreOptimisedUtil.h"
+
+// Number of tracks gathered before running the interpolation kernel
+#define OGRE_BAKED_ANIMATION_BATCH_SIZE 64
+
+namespace Ogre {
+
+    //-----------------------------------------------------------------------
+    /// Source keyframes of a track being compressed
+    struct KeyFrameSource
+    {
+        vector<Real>::type times;
+        vector<Vector3>::type translations;
+        vector<Quaternion>::type rotations;
+        vector<Vector3>::type scales;
+    };
+    //-----------------------------------------------------------------------
+    /** Squared distance between two unit quaternions on the 4D sphere, which unlike
+        their dot product stays accurate for small angles. */
+    static Real rotationDistance(const Quaternion& q1, const Quaternion& q2)
+    {
+        return q1.Dot(q2) < 0 ? (q1 + q2).Norm() : (q1 - q2).Norm();
+    }
+    //-----------------------------------------------------------------------
+    /// Whether interpolating keyframes first and last reproduces the keyframes in between
+    static bool canInterpolate(const KeyFrameSource& src, size_t first, size_t last,
+        bool shortestPath, Real positionTolerance, Real rotationTolerance, Real scaleTolerance)
+    {
+        const Real t1 = src.times[first];
+        const Real range = src.times[last] - t1;
+        for (size_t k = first + 1; k < last; ++k)
+        {
+            const Real t = range > 0 ? (src.times[k] - t1) / range : 0;
+
+            const Vector3 translate = src.translations[first] +
+                (src.translations[last] - src.translations[first]) * t;
+            if (translate.squaredDistance(src.translations[k]) > positionTolerance * positionTolerance)
+                return false;
+
+            const Quaternion rotation = Quaternion::nlerp(t, src.rotations[first],
+                src.rotations[last], shortestPath);
+            if (rotationDistance(rotation, src.rotations[k]) > rotationTolerance)
+                return false;
+
+            const Vector3 scale = src.scales[first] + (src.scales[last] - src.scales[first]) * t;
+            if (scale.squaredDistance(src.scales[k]) > scaleTolerance * scaleTolerance)
+                return false;
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    /// Computes the quantisation range of 3 component values
+    static void getQuantisationRange(const vector<Vector3>::type& values,
+        const vector<size_t>::type& keys, Vector3& minimum, Vector3& step)
+    {
+        minimum = values[keys[0]];
+        Vector3 maximum = minimum;
+        for (size_t k = 1; k < keys.size(); ++k)
+        {
+            minimum.makeFloor(values[keys[k]]);
+            maximum.makeCeil(values[keys[k]]);
+        }
+        step = (maximum - minimum) / 65535.0f;
+    }
+    //-----------------------------------------------------------------------
+    /// Quantises a value to 16 bits given its range
+    static uint16 quantise(Real value, Real minimum, Real step)
+    {
+        if (step <= 0)
+            return 0;
+        const Real q = Math::Floor((value - minimum) / step + 0.5f);
+        return static_cast<uint16>(std::max(Real(0), std::min(Real(65535), q)));
+    }
+    //-----------------------------------------------------------------------
+    BakedNodeAnimation::BakedNodeAnimation()
+        : mAnimation(0)
+        , mCompressed(false)
+    {
+    }
+    //-----------------------------------------------------------------------
+    BakedNodeAnimation::~BakedNodeAnimation()
+    {
+    }
+    //-----------------------------------------------------------------------
+    void BakedNodeAnimation::clear(void)
+    {
+        mTracks.clear();
+        mTimes.clear();
+        mTranslations.clear();
+        mRotations.clear();
+        mScales.clear();
+        mQuantisedRotations.clear();
+        mQuantisedTranslations.clear();
+        mQuantisedScales.clear();
+        mAnimation = 0;
+        mCompressed = false;
+    }
+    //-----------------------------------------------------------------------
+    void BakedNodeAnimation::bake(const Animation* animation)
+    {
+        clear();
+        mAnimation = animation;
+
+        const Animation::NodeTrackList& tracks = animation->_getNodeTrackList();
+        size_t numKeyFrames = 0;
+        Animation::NodeTrackList::const_iterator i;
+        for (i = tracks.begin(); i != tracks.end(); ++i)
+        {
+            numKeyFrames += i->second->getNumKeyFrames();
+        }
+        mTimes.reserve(numKeyFrames);
+        mTranslations.reserve(numKeyFrames);
+        mRotations.reserve(numKeyFrames);
+        mScales.reserve(numKeyFrames);
+
+        for (i = tracks.begin(); i != tracks.end(); ++i)
+        {
+            NodeAnimationTrack* track = i->second;
+            const unsigned short numTrackKeyFrames = track->getNumKeyFrames();
+            // Tracks without keyframes are not applied
+            if (!numTrackKeyFrames)
+                continue;
+
+            Track baked;
+            baked.track = track;
+            baked.handle = i->first;
+            baked.numKeyFrames = numTrackKeyFrames;
+            baked.firstKeyFrame = mTimes.size();
+            baked.firstScale = NO_SCALE;
+            baked.hasRotationBase = false;
+            mTracks.push_back(baked);
+
+            for (unsigned short k = 0; k < numTrackKeyFrames; ++k)
+            {
+                const TransformKeyFrame* kf = track->getNodeKeyFrame(k);
+                mTimes.push_back(kf->getTime());
+                mTranslations.push_back(kf->getTranslate());
+                mRotations.push_back(kf->getRotation());
+                mScales.push_back(kf->getScale());
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BakedNodeAnimation::bakeCompressed(const Animation* animation, Real positionTolerance,
+        const Radian& rotationTolerance, Real scaleTolerance)
+    {
+        _initCompressed(animation);
+
+        // Two unit quaternions an angle a apart are 2 sin(a / 4) apart on the sphere
+        const Real rotationChord = 2 * Math::Sin(rotationTolerance * 0.25f);
+        const Real rotationTolerance2 = rotationChord * rotationChord;
+        KeyFrameSource src;
+        vector<size_t>::type keys;
+
+        const Animation::NodeTrackList& tracks = animation->_getNodeTrackList();
+        Animation::NodeTrackList::const_iterator i;
+        for (i = tracks.begin(); i != tracks.end(); ++i)
+        {
+            NodeAnimationTrack* track = i->second;
+            const unsigned short numTrackKeyFrames = track->getNumKeyFrames();
+            if (!numTrackKeyFrames)
+                continue;
+
+            src.times.clear();
+            src.translations.clear();
+            src.rotations.clear();
+            src.scales.clear();
+            bool hasScale = false;
+            for (unsigned short k = 0; k < numTrackKeyFrames; ++k)
+            {
+                const TransformKeyFrame* kf = track->getNodeKeyFrame(k);
+                src.times.push_back(kf->getTime());
+                src.translations.push_back(kf->getTranslate());
+                Quaternion rotation = kf->getRotation();
+                rotation.normalise();
+                src.rotations.push_back(rotation);
+                src.scales.push_back(kf->getScale());
+                hasScale = hasScale || kf->getScale() != Vector3::UNIT_SCALE;
+            }
+
+            // Greedily extend each segment as long as it reproduces the
+            // keyframes it skips
+            const bool shortestPath = track->getUseShortestRotationPath();
+            keys.clear();
+            keys.push_back(0);
+            size_t first = 0;
+            for (size_t k = 2; k < numTrackKeyFrames; ++k)
+            {
+                if (!canInterpolate(src, first, k, shortestPath,
+                    positionTolerance, rotationTolerance2, scaleTolerance))
+                {
+                    first = k - 1;
+                    keys.push_back(first);
+                }
+            }
+            if (numTrackKeyFrames > 1)
+            {
+                // A constant track only needs its first keyframe
+                const size_t last = numTrackKeyFrames - 1;
+                if (keys.size() > 1 ||
+                    src.translations[0].squaredDistance(src.translations[last]) > positionTolerance * positionTolerance ||
+                    rotationDistance(src.rotations[0], src.rotations[last]) > rotationTolerance2 ||
+                    src.scales[0].squaredDistance(src.scales[last]) > scaleTolerance * scaleTolerance)
+                {
+                    keys.push_back(last);
+                }
+            }
+
+            CompressedTrack data;
+            data.handle = i->first;
+            data.numKeyFrames = static_cast<unsigned short>(keys.size());
+            data.hasScale = hasScale;
+            data.hasRotationBase = false;
+            data.rotationBase = Quaternion::IDENTITY;
+            getQuantisationRange(src.translations, keys, data.translateMin, data.translateStep);
+            if (hasScale)
+                getQuantisationRange(src.scales, keys, data.scaleMin, data.scaleStep);
+            _addCompressedTrack(track, data);
+
+            for (size_t k = 0; k < keys.size(); ++k)
+            {
+                const size_t key = keys[k];
+                data.times[k] = src.times[key];
+                quantiseRotation(src.rotations[key], data.rotations + 3 * k);
+                for (size_t c = 0; c < 3; ++c)
+                {
+                    data.translations[3 * k + c] = quantise(src.translations[key][c],
+                        data.translateMin[c], data.translateStep[c]);
+                    if (hasScale)
+                    {
+                        data.scales[3 * k + c] = quantise(src.scales[key][c],
+                            data.scaleMin[c], data.scaleStep[c]);
+                    }
+                }
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BakedNodeAnimation::_initCompressed(const Animation* animation)
+    {
+        clear();
+        mAnimation = animation;
+        mCompressed = true;
+    }
+    //-----------------------------------------------------------------------
+    void BakedNodeAnimation::_addCompressedTrack(NodeAnimationTrack* track, CompressedTrack& data)
+    {
+        assert(mCompressed && "Keyframes are not compressed");
+
+        Track baked;
+        baked.track = track;
+        baked.handle = data.handle;
+        baked.numKeyFrames = data.numKeyFrames;
+        baked.firstKeyFrame = mTimes.size();
+        baked.firstScale = data.hasScale ? mQuantisedScales.size() : NO_SCALE;
+        baked.translateMin = data.translateMin;
+        baked.translateStep = data.translateStep;
+        baked.scaleMin = data.hasScale ? data.scaleMin : Vector3::UNIT_SCALE;
+        baked.scaleStep = data.hasScale ? data.scaleStep : Vector3::ZERO;
+        baked.hasRotationBase = data.hasRotationBase;
+        baked.rotationBase = data.rotationBase;
+        mTracks.push_back(baked);
+
+        const size_t numKeyFrames = data.numKeyFrames;
+        mTimes.resize(mTimes.size() + numKeyFrames);
+        mQuantisedRotations.resize(mQuantisedRotations.size() + 3 * numKeyFrames);
+        mQuantisedTranslations.resize(mQuantisedTranslations.size() + 3 * numKeyFrames);
+        if (data.hasScale)
+            mQuantisedScales.resize(mQuantisedScales.size() + 3 * numKeyFrames);
+
+        data = _getCompressedTrack(mTracks.size() - 1);
+    }
+    //-----------------------------------------------------------------------
+    BakedNodeAnimation::CompressedTrack BakedNodeAnimation::_getCompressedTrack(size_t trackIndex)
+    {
+        assert(mCompressed && "Keyframes are not compressed");
+
+        const Track& track = mTracks[trackIndex];
+        CompressedTrack data;
+        data.handle = track.handle;
+        data.numKeyFrames = track.numKeyFrames;
+        data.hasScale = track.firstScale != NO_SCALE;
+        data.translateMin = track.translateMin;
+        data.translateStep = track.translateStep;
+        data.scaleMin = track.scaleMin;
+        data.scaleStep = track.scaleStep;
+        data.hasRotationBase = track.hasRotationBase;
+        data.rotationBase = track.rotationBase;
+        // Empty tracks must not index past the end of the arrays
+        data.times = track.numKeyFrames ? &mTimes[track.firstKeyFrame] : 0;
+        data.rotations = track.numKeyFrames ? &mQuantisedRotations[3 * track.firstKeyFrame] : 0;
+        data.translations = track.numKeyFrames ? &mQuantisedTranslations[3 * track.firstKeyFrame] : 0;
+        data.scales = (data.hasScale && track.numKeyFrames) ? &mQuantisedScales[track.firstScale] : 0;
+        return data;
+    }
+    //-----------------------------------------------------------------------
+    void BakedNodeAnimation::_applyBaseKeyFrame(size_t trackIndex, const TransformKeyFrame* base)
+    {
+        assert(mCompressed && "Keyframes are not compressed");
+
+        Track& track = mTracks[trackIndex];
+        const Vector3 inverseScale = Vector3::UNIT_SCALE / base->getScale();
+        if (track.firstScale == NO_SCALE && inverseScale != Vector3::UNIT_SCALE)
+        {
+            // The scales are no longer all UNIT_SCALE; give the track quantised
+            // scales of 0, ie. scaleMin, after those of the tracks before it
+            size_t firstScale = mQuantisedScales.size();
+            for (TrackList::iterator i = mTracks.begin() + trackIndex + 1; i != mTracks.end(); ++i)
+            {
+                if (i->firstScale != NO_SCALE)
+                {
+                    if (firstScale == mQuantisedScales.size())
+                        firstScale = i->firstScale;
+                    i->firstScale += 3 * track.numKeyFrames;
+                }
+            }
+            mQuantisedScales.insert(mQuantisedScales.begin() + firstScale, 3 * track.numKeyFrames, 0);
+            track.firstScale = firstScale;
+        }
+
+        // Same operations as on the keyframes, which the ranges are linear in
+        track.translateMin -= base->getTranslate();
+        track.scaleMin *= inverseScale;
+        track.scaleStep *= inverseScale;
+        track.rotationBase = base->getRotation().Inverse() * track.rotationBase;
+        track.hasRotationBase = true;
+    }
+    //-----------------------------------------------------------------------
+    void BakedNodeAnimation::_removeTrack(unsigned short handle)
+    {
+        const size_t trackIndex = findTrack(handle);
+        if (trackIndex == mTracks.size())
+            return;
+
+        const Track removed = mTracks[trackIndex];
+        const size_t first = removed.firstKeyFrame;
+        const size_t last = first + removed.numKeyFrames;
+        mTimes.erase(mTimes.begin() + first, mTimes.begin() + last);
+        if (mCompressed)
+        {
+            mQuantisedRotations.erase(mQuantisedRotations.begin() + 3 * first,
+                mQuantisedRotations.begin() + 3 * last);
+            mQuantisedTranslations.erase(mQuantisedTranslations.begin() + 3 * first,
+                mQuantisedTranslations.begin() + 3 * last);
+            if (removed.firstScale != NO_SCALE)
+            {
+                mQuantisedScales.erase(mQuantisedScales.begin() + removed.firstScale,
+                    mQuantisedScales.begin() + removed.firstScale + 3 * removed.numKeyFrames);
+            }
+        }
+        else
+        {
+            mTranslations.erase(mTranslations.begin() + first, mTranslations.begin() + last);
+            mRotations.erase(mRotations.begin() + first, mRotations.begin() + last);
+            mScales.erase(mScales.begin() + first, mScales.begin() + last);
+        }
+
+        mTracks.erase(mTracks.begin() + trackIndex);
+        for (TrackList::iterator i = mTracks.begin() + trackIndex; i != mTracks.end(); ++i)
+        {
+            i->firstKeyFrame -= removed.numKeyFrames;
+            if (i->firstScale != NO_SCALE && removed.firstScale != NO_SCALE)
+                i->firstScale -= 3 * removed.numKeyFrames;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BakedNodeAnimation::_relink(const Animation* animation)
+    {
+        mAnimation = animation;
+        for (TrackList::iterator i = mTracks.begin(); i != mTracks.end(); ++i)
+        {
+            i->track = animation->getNodeTrack(i->handle);
+        }
+    }
+    //-----------------------------------------------------------------------
+    size_t BakedNodeAnimation::findTrack(unsigned short handle) const
+    {
+        for (size_t i = 0; i < mTracks.size(); ++i)
+        {
+            if (mTracks[i].handle == handle)
+                return i;
+        }
+        return mTracks.size();
+    }
+    //-----------------------------------------------------------------------
+    size_t BakedNodeAnimation::calculateSize(void) const
+    {
+        return sizeof(*this) + mTracks.size() * sizeof(Track) +
+            mTimes.size() * sizeof(Real) +
+            mTranslations.size() * sizeof(Vector3) +
+            mRotations.size() * sizeof(Quaternion) +
+            mScales.size() * sizeof(Vector3) +
+            (mQuantisedRotations.size() + mQuantisedTranslations.size() +
+            mQuantisedScales.size()) * sizeof(uint16);
+    }
+    //-----------------------------------------------------------------------
+    void BakedNodeAnimation::quantiseRotation(const Quaternion& q, uint16* values)
+    {
+        // Find the largest component, which is recomputed from the others
+        size_t largest = 0;
+        for (size_t c = 1; c < 4; ++c)
+        {
+            if (Math::Abs(q[c]) > Math::Abs(q[largest]))
+                largest = c;
+        }
+        const bool negative = q[largest] < 0;
+        const Real sign = negative ? -1.0f : 1.0f;
+
+        // The other components are within +-1/sqrt(2)
+        size_t v = 0;
+        for (size_t c = 0; c < 4; ++c)
+        {
+            if (c == largest)
+                continue;
+            const Real unit = (q[c] * sign * Math::Sqrt(2.0f) + 1.0f) * 0.5f;
+            const Real quantised = Math::Floor(unit * 32767.0f + 0.5f);
+            values[v++] = static_cast<uint16>(std::max(Real(0), std::min(Real(32767), quantised)));
+        }
+        values[0] |= static_cast<uint16>((largest & 1) << 15);
+        values[1] |= static_cast<uint16>((largest >> 1) << 15);
+        values[2] |= static_cast<uint16>(negative ? 0x8000 : 0);
+    }
+    //-----------------------------------------------------------------------
+    Quaternion BakedNodeAnimation::dequantiseRotation(const uint16* values)
+    {
+        const size_t largest = (values[0] >> 15) | ((values[1] >> 15) << 1);
+        const Real scale = 2.0f / 32767.0f;
+        const Real a = ((values[0] & 0x7fff) * scale - 1.0f) * Math::Sqrt(0.5f);
+        const Real b = ((values[1] & 0x7fff) * scale - 1.0f) * Math::Sqrt(0.5f);
+        const Real c = ((values[2] & 0x7fff) * scale - 1.0f) * Math::Sqrt(0.5f);
+        const Real d = Math::Sqrt(std::max(Real(0), 1.0f - a * a - b * b - c * c));
+
+        Quaternion q;
+        switch (largest)
+        {
+        case 0: q = Quaternion(d, a, b, c); break;
+        case 1: q = Quaternion(a, d, b, c); break;
+        case 2: q = Quaternion(a, b, d, c); break;
+        default: q = Quaternion(a, b, c, d); break;
+        }
+        return (values[2] & 0x8000) ? -q : q;
+    }
+    //-----------------------------------------------------------------------
+    void BakedNodeAnimation::decodeKeyFrame(const Track& track, size_t keyIndex,
+        Vector3& translate, Quaternion& rotation, Vector3& scale) const
+    {
+        if (!mCompressed)
+        {
+            translate = mTranslations[keyIndex];
+            rotation = mRotations[keyIndex];
+            scale = mScales[keyIndex];
+            return;
+        }
+
+        const uint16* t = &mQuantisedTranslations[3 * keyIndex];
+        translate.x = track.translateMin.x + t[0] * track.translateStep.x;
+        translate.y = track.translateMin.y + t[1] * track.translateStep.y;
+        translate.z = track.translateMin.z + t[2] * track.translateStep.z;
+        rotation = dequantiseRotation(&mQuantisedRotations[3 * keyIndex]);
+        if (track.hasRotationBase)
+            rotation = track.rotationBase * rotation;
+        if (track.firstScale == NO_SCALE)
+        {
+            scale = Vector3::UNIT_SCALE;
+        }
+        else
+        {
+            const uint16* s = &mQuantisedScales[track.firstScale + 3 * (keyIndex - track.firstKeyFrame)];
+            scale.x = track.scaleMin.x + s[0] * track.scaleStep.x;
+            scale.y = track.scaleMin.y + s[1] * track.scaleStep.y;
+            scale.z = track.scaleMin.z + s[2] * track.scaleStep.z;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BakedNodeAnimation::getKeyFrame(size_t trackIndex, unsigned short keyIndex, Real& time,
+        Vector3& translate, Quaternion& rotation, Vector3& scale) const
+    {
+        const Track& track = mTracks[trackIndex];
+        time = mTimes[track.firstKeyFrame + keyIndex];
+        decodeKeyFrame(track, track.firstKeyFrame + keyIndex, translate, rotation, scale);
+    }
+    //-----------------------------------------------------------------------
+    size_t BakedNodeAnimation::findKeyFrame(const Track& track, Real timePos,
+        unsigned short* cursor) const
+    {
+        const Real* times = &mTimes[track.firstKeyFrame];
+        const size_t numKeyFrames = track.numKeyFrames;
+
+        size_t lower;
+        if (cursor && (*cursor == 0 || (*cursor <= numKeyFrames && times[*cursor - 1] < timePos)))
+        {
+            // Everything before the cursor is earlier, so the lower bound is at
+            // or after it; during playback it is the same or the next keyframe
+            lower = *cursor;
+            if (lower < numKeyFrames && times[lower] < timePos)
+            {
+                ++lower;
+                if (lower < numKeyFrames && times[lower] < timePos)
+                    lower = std::lower_bound(times + lower + 1, times + numKeyFrames, timePos) - times;
+            }
+        }
+        else
+        {
+            lower = std::lower_bound(times, times + numKeyFrames, timePos) - times;
+        }
+
+        if (cursor)
+            *cursor = static_cast<unsigned short>(lower);
+        return lower;
+    }
+    //-----------------------------------------------------------------------
+    Real BakedNodeAnimation::findKeyFrames(const Track& track, Real timePos,
+        unsigned short* cursor, size_t& keyFrame1, size_t& keyFrame2) const
+    {
+        const size_t first = track.firstKeyFrame;
+        const size_t lower = findKeyFrame(track, timePos, cursor);
+        Real t2;
+        if (lower == track.numKeyFrames)
+        {
+            // There is no keyframe after this time, wrap back to first
+            keyFrame2 = first;
+            t2 = mAnimation->getLength() + mTimes[keyFrame2];
+            keyFrame1 = first + track.numKeyFrames - 1;
+        }
+        else
+        {
+            keyFrame2 = first + lower;
+            t2 = mTimes[keyFrame2];
+            keyFrame1 = (lower != 0 && timePos < t2) ? keyFrame2 - 1 : keyFrame2;
+        }
+        const Real t1 = mTimes[keyFrame1];
+
+        return (t1 == t2) ? 0.0f : (timePos - t1) / (t2 - t1);
+    }
+    //-----------------------------------------------------------------------
+    void BakedNodeAnimation::getInterpolatedKeyFrame(size_t trackIndex, Real timePos,
+        TransformKeyFrame* kf) const
+    {
+        const Track& track = mTracks[trackIndex];
+        size_t k1, k2;
+        const Real t = findKeyFrames(track, timePos, 0, k1, k2);
+
+        Vector3 translate1, scale1;
+        Quaternion rotation1;
+        decodeKeyFrame(track, k1, translate1, rotation1, scale1);
+        if (t == 0.0)
+        {
+            kf->setRotation(rotation1);
+            kf->setTranslate(translate1);
+            kf->setScale(scale1);
+            return;
+        }
+
+        Vector3 translate2, scale2;
+        Quaternion rotation2;
+        decodeKeyFrame(track, k2, translate2, rotation2, scale2);
+        const bool shortestPath = track.track->getUseShortestRotationPath();
+        if (mAnimation->getRotationInterpolationMode() == Animation::RIM_LINEAR)
+            kf->setRotation(Quaternion::nlerp(t, rotation1, rotation2, shortestPath));
+        else
+            kf->setRotation(Quaternion::Slerp(t, rotation1, rotation2, shortestPath));
+        kf->setTranslate(translate1 + ((translate2 - translate1) * t));
+        kf->setScale(scale1 + ((scale2 - scale1) * t));
+    }
+    //-----------------------------------------------------------------------
+    void BakedNodeAnimation::apply(Skeleton* skeleton, Node* node, Real timePos, Real weight,
+        const AnimationState::BoneBlendMask* blendMask, Real scale,
+        AnimationState::KeyFrameCursor* cursor)
+    {
+        if (cursor && cursor->size() != mTracks.size())
+            cursor->assign(mTracks.size(), 0);
+
+        const bool spherical =
+            mAnimation->getRotationInterpolationMode() == Animation::RIM_SPHERICAL;
+
+        const size_t stride = OGRE_BAKED_ANIMATION_BATCH_SIZE;
+        OGRE_SIMD_ALIGNED_DECL(Real, keyFrames1[10 * stride]);
+        OGRE_SIMD_ALIGNED_DECL(Real, keyFrames2[10 * stride]);
+        OGRE_SIMD_ALIGNED_DECL(Real, params[2 * stride]);
+        OGRE_SIMD_ALIGNED_DECL(Real, transforms[10 * stride]);
+        const Track* batchTracks[OGRE_BAKED_ANIMATION_BATCH_SIZE];
+        Node* batchNodes[OGRE_BAKED_ANIMATION_BATCH_SIZE];
+        Real batchWeights[OGRE_BAKED_ANIMATION_BATCH_SIZE];
+        size_t batchSize = 0;
+
+        OptimisedUtil* util = OptimisedUtil::getImplementation();
+        const size_t numTracks = mTracks.size();
+        for (size_t t = 0; t <= numTracks; ++t)
+        {
+            if (t < numTracks)
+            {
+                const Track& track = mTracks[t];
+                Node* target;
+                Real trackWeight = weight;
+                if (skeleton)
+                {
+                    Bone* bone = skeleton->getBone(track.handle);
+                    if (blendMask)
+                        trackWeight = (*blendMask)[bone->getHandle()] * weight;
+                    target = bone;
+                }
+                else
+                {
+                    target = node ? node : track.track->getAssociatedNode();
+                    if (!target)
+                        continue;
+                }
+                if (!trackWeight)
+                    continue;
+
+                if (!mCompressed && track.track->getListener())
+                {
+                    // Procedural tracks need the listener called
+                    track.track->applyToNode(target, TimeIndex(timePos), trackWeight, scale);
+                    continue;
+                }
+
+                size_t k1, k2;
+                const size_t i = batchSize++;
+                params[i] = findKeyFrames(track, timePos, cursor ? &(*cursor)[t] : 0, k1, k2);
+                params[stride + i] = track.track->getUseShortestRotationPath() ? 1.0f : 0.0f;
+
+                Vector3 translate1, scale1, translate2, scale2;
+                Quaternion rotation1, rotation2;
+                decodeKeyFrame(track, k1, translate1, rotation1, scale1);
+                decodeKeyFrame(track, k2, translate2, rotation2, scale2);
+
+                keyFrames1[i] = translate1.x;
+                keyFrames1[stride + i] = translate1.y;
+                keyFrames1[2 * stride + i] = translate1.z;
+                keyFrames1[3 * stride + i] = rotation1.w;
+                keyFrames1[4 * stride + i] = rotation1.x;
+                keyFrames1[5 * stride + i] = rotation1.y;
+                keyFrames1[6 * stride + i] = rotation1.z;
+                keyFrames1[7 * stride + i] = scale1.x;
+                keyFrames1[8 * stride + i] = scale1.y;
+                keyFrames1[9 * stride + i] = scale1.z;
+
+                keyFrames2[i] = translate2.x;
+                keyFrames2[stride + i] = translate2.y;
+                keyFrames2[2 * stride + i] = translate2.z;
+                keyFrames2[3 * stride + i] = rotation2.w;
+                keyFrames2[4 * stride + i] = rotation2.x;
+                keyFrames2[5 * stride + i] = rotation2.y;
+                keyFrames2[6 * stride + i] = rotation2.z;
+                keyFrames2[7 * stride + i] = scale2.x;
+                keyFrames2[8 * stride + i] = scale2.y;
+                keyFrames2[9 * stride + i] = scale2.z;
+
+                batchTracks[i] = &track;
+                batchNodes[i] = target;
+                batchWeights[i] = trackWeight;
+
+                if (batchSize < stride)
+                    continue;
+            }
+
+            if (!batchSize)
+                continue;
+
+            util->interpolateNodeKeyFrames(keyFrames1, keyFrames2, params, transforms, stride, batchSize);
+
+            for (size_t i = 0; i < batchSize; ++i)
+            {
+                const Vector3 translate(transforms[i], transforms[stride + i], transforms[2 * stride + i]);
+                Quaternion rotation(transforms[3 * stride + i], transforms[4 * stride + i],
+                    transforms[5 * stride + i], transforms[6 * stride + i]);
+                const Vector3 keyScale(transforms[7 * stride + i], transforms[8 * stride + i],
+                    transforms[9 * stride + i]);
+                if (spherical && params[i] != 0)
+                {
+                    const Quaternion rotation1(keyFrames1[3 * stride + i], keyFrames1[4 * stride + i],
+                        keyFrames1[5 * stride + i], keyFrames1[6 * stride + i]);
+                    const Quaternion rotation2(keyFrames2[3 * stride + i], keyFrames2[4 * stride + i],
+                        keyFrames2[5 * stride + i], keyFrames2[6 * stride + i]);
+                    rotation = Quaternion::Slerp(params[i], rotation1, rotation2, params[stride + i] != 0);
+                }
+
+                batchTracks[i]->track->_applyKeyFrameToNode(batchNodes[i],
+                    translate, rotation, keyScale, batchWeights[i], scale);
+            }
+            batchSize = 0;
+        }
+    }
+
+}
@@ -0,0 +1,770 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreBlockCompression.h"
+#include "OgreException.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+#include "Threading/OgreTaskScheduler.h"
+
+#include <cfloat>
+#include <climits>
+
+namespace Ogre {
+    namespace
+    {
+        /// Pixels of a block of 4x4, row by row, as R, G, B, A bytes
+        typedef uint8 BlockPixels[16][4];
+
+        /// Number of blocks worth encoding in a task of their own
+        const size_t COMPRESSION_GRAIN_BLOCKS = 1024;
+
+        inline int clampByte(int value)
+        {
+            return value < 0 ? 0 : (value > 255 ? 255 : value);
+        }
+        //---------------------------------------------------------------------
+        size_t getBlockSize(PixelFormat format)
+        {
+            return format == PF_DXT5 || format == PF_BC5_UNORM ? 16 : 8;
+        }
+        //---------------------------------------------------------------------
+        // BC1 colour blocks, also used by BC3
+        //---------------------------------------------------------------------
+        inline void expand565(uint16 colour, int* rgb)
+        {
+            int r = (colour >> 11) & 31, g = (colour >> 5) & 63, b = colour & 31;
+            rgb[0] = (r << 3) | (r >> 2);
+            rgb[1] = (g << 2) | (g >> 4);
+            rgb[2] = (b << 3) | (b >> 2);
+        }
+        //---------------------------------------------------------------------
+        inline uint16 quantise565(const float* rgb)
+        {
+            int r = clampByte(static_cast<int>(rgb[0] + 0.5f));
+            int g = clampByte(static_cast<int>(rgb[1] + 0.5f));
+            int b = clampByte(static_cast<int>(rgb[2] + 0.5f));
+            return static_cast<uint16>(((r * 31 + 127) / 255) << 11 | ((g * 63 + 127) / 255) << 5 |
+                ((b * 31 + 127) / 255));
+        }
+        //---------------------------------------------------------------------
+        /** Colours of the indices of a block. Three colour blocks have
+            black, transparent, as the 4th one.
+        */
+        void buildColourPalette(uint16 colour0, uint16 colour1, bool fourColours, int palette[4][3])
+        {
+            expand565(colour0, palette[0]);
+            expand565(colour1, palette[1]);
+            for (int k = 0; k < 3; ++k)
+            {
+                if (fourColours)
+                {
+                    palette[2][k] = (2 * palette[0][k] + palette[1][k] + 1) / 3;
+                    palette[3][k] = (palette[0][k] + 2 * palette[1][k] + 1) / 3;
+                }
+                else
+                {
+                    palette[2][k] = (palette[0][k] + palette[1][k] + 1) / 2;
+                    palette[3][k] = 0;
+                }
+            }
+        }
+        //---------------------------------------------------------------------
+        /// Picks the closest colour of each pixel, returns the squared error
+        int fitColourIndices(const BlockPixels& pixels, const bool* transparent, uint16 colour0,
+            uint16 colour1, bool fourColours, uint8* indices)
+        {
+            int palette[4][3];
+            buildColourPalette(colour0, colour1, fourColours, palette);
+            const int numColours = fourColours ? 4 : 3;
+
+            int error = 0;
+            for (size_t i = 0; i < 16; ++i)
+            {
+                if (transparent[i])
+                {
+                    indices[i] = 3;
+                    continue;
+                }
+                int bestError = INT_MAX;
+                for (int c = 0; c < numColours; ++c)
+                {
+                    int dr = palette[c][0] - pixels[i][0];
+                    int dg = palette[c][1] - pixels[i][1];
+                    int db = palette[c][2] - pixels[i][2];
+                    int e = dr * dr + dg * dg + db * db;
+                    if (e < bestError)
+                    {
+                        bestError = e;
+                        indices[i] = static_cast<uint8>(c);
+                    }
+                }
+                error += bestError;
+            }
+            return error;
+        }
+        //---------------------------------------------------------------------
+        /** Least squares endpoints for the given indices; returns false if
+            the indices don't constrain both of them.
+        */
+        bool refineColourEndpoints(const BlockPixels& pixels, const bool* transparent,
+            const uint8* indices, bool fourColours, float* endpoint0, float* endpoint1)
+        {
+            // weight of endpoint 0 in the colour of each index
+            static const float fourWeights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+            static const float threeWeights[4] = { 1.0f, 0.0f, 0.5f, 0.0f };
+            const float* weights = fourColours ? fourWeights : threeWeights;
+
+            float aa = 0, ab = 0, bb = 0;
+            float ax[3] = { 0, 0, 0 }, bx[3] = { 0, 0, 0 };
+            for (size_t i = 0; i < 16; ++i)
+            {
+                if (transparent[i])
+                    continue;
+                const float a = weights[indices[i]], b = 1.0f - a;
+                aa += a * a;
+                ab += a * b;
+                bb += b * b;
+                for (int k = 0; k < 3; ++k)
+                {
+                    ax[k] += a * pixels[i][k];
+                    bx[k] += b * pixels[i][k];
+                }
+            }
+
+            const float det = aa * bb - ab * ab;
+            if (fabs(det) < 1e-6f)
+                return false;
+            for (int k = 0; k < 3; ++k)
+            {
+                endpoint0[k] = (bb * ax[k] - ab * bx[k]) / det;
+                endpoint1[k] = (aa * bx[k] - ab * ax[k]) / det;
+            }
+            return true;
+        }
+        //---------------------------------------------------------------------
+        /** Encodes the colours of a block into 8 bytes. With transparency,
+            pixels of alpha below 128 make it a three colour block.
+        */
+        void encodeColourBlock(const BlockPixels& pixels, bool transparency, uint8* out)
+        {
+            bool transparent[16];
+            size_t numOpaque = 0;
+            for (size_t i = 0; i < 16; ++i)
+            {
+                transparent[i] = transparency && pixels[i][3] < 128;
+                if (!transparent[i])
+                    ++numOpaque;
+            }
+
+            uint16 colour0 = 0, colour1 = 0;
+            uint8 indices[16];
+            const bool fourColours = numOpaque == 16;
+            if (numOpaque == 0)
+            {
+                std::fill(indices, indices + 16, uint8(3));
+            }
+            else
+            {
+                // mean and covariance of the opaque colours
+                float mean[3] = { 0, 0, 0 };
+                for (size_t i = 0; i < 16; ++i)
+                {
+                    if (!transparent[i])
+                    {
+                        for (int k = 0; k < 3; ++k)
+                            mean[k] += pixels[i][k];
+                    }
+                }
+                for (int k = 0; k < 3; ++k)
+                    mean[k] /= numOpaque;
+
+                float cov[3][3] = { { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 } };
+                for (size_t i = 0; i < 16; ++i)
+                {
+                    if (transparent[i])
+                        continue;
+                    float d[3] = { pixels[i][0] - mean[0], pixels[i][1] - mean[1], pixels[i][2] - mean[2] };
+                    for (int j = 0; j < 3; ++j)
+                        for (int k = 0; k < 3; ++k)
+                            cov[j][k] += d[j] * d[k];
+                }
+
+                // principal axis by power iteration
+                float axis[3] = { 1, 1, 1 };
+                float length = 0;
+                for (int iteration = 0; iteration < 6; ++iteration)
+                {
+                    float next[3];
+                    for (int j = 0; j < 3; ++j)
+                        next[j] = cov[j][0] * axis[0] + cov[j][1] * axis[1] + cov[j][2] * axis[2];
+                    length = sqrtf(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+                    if (length < 1e-6f)
+                        break;
+                    for (int j = 0; j < 3; ++j)
+                        axis[j] = next[j] / length;
+                }
+
+                // the extreme projections of the colours are the endpoints
+                float minT = 0, maxT = 0;
+                if (length >= 1e-6f)
+                {
+                    minT = FLT_MAX;
+                    maxT = -FLT_MAX;
+                    for (size_t i = 0; i < 16; ++i)
+                    {
+                        if (transparent[i])
+                            continue;
+                        float t = (pixels[i][0] - mean[0]) * axis[0] + (pixels[i][1] - mean[1]) * axis[1] +
+                            (pixels[i][2] - mean[2]) * axis[2];
+                        minT = std::min(minT, t);
+                        maxT = std::max(maxT, t);
+                    }
+                }
+                float endpoint0[3], endpoint1[3];
+                for (int k = 0; k < 3; ++k)
+                {
+                    endpoint0[k] = mean[k] + axis[k] * maxT;
+                    endpoint1[k] = mean[k] + axis[k] * minT;
+                }
+
+                colour0 = quantise565(endpoint0);
+                colour1 = quantise565(endpoint1);
+                int error = fitColourIndices(pixels, transparent, colour0, colour1, fourColours, indices);
+
+                // one least squares step, kept if it's better
+                if (error > 0 &&
+                    refineColourEndpoints(pixels, transparent, indices, fourColours, endpoint0, endpoint1))
+                {
+                    uint16 refined0 = quantise565(endpoint0), refined1 = quantise565(endpoint1);
+                    uint8 refinedIndices[16];
+                    if (fitColourIndices(pixels, transparent, refined0, refined1, fourColours, refinedIndices) < error)
+                    {
+                        colour0 = refined0;
+                        colour1 = refined1;
+                        memcpy(indices, refinedIndices, 16);
+                    }
+                }
+
+                // the order of the endpoints selects the mode of the block
+                if (fourColours && colour0 < colour1)
+                {
+                    std::swap(colour0, colour1);
+                    for (size_t i = 0; i < 16; ++i)
+                        indices[i] ^= 1;
+                }
+                else if (fourColours && colour0 == colour1)
+                {
+                    std::fill(indices, indices + 16, uint8(0));
+                }
+                else if (!fourColours && colour0 > colour1)
+                {
+                    std::swap(colour0, colour1);
+                    for (size_t i = 0; i < 16; ++i)
+                    {
+                        if (indices[i] < 2)
+                            indices[i] ^= 1;
+                    }
+                }
+            }
+
+            out[0] = static_cast<uint8>(colour0 & 0xFF);
+            out[1] = static_cast<uint8>(colour0 >> 8);
+            out[2] = static_cast<uint8>(colour1 & 0xFF);
+            out[3] = static_cast<uint8>(colour1 >> 8);
+            for (size_t y = 0; y < 4; ++y)
+            {
+                out[4 + y] = static_cast<uint8>(indices[y * 4] | (indices[y * 4 + 1] << 2) |
+                    (indices[y * 4 + 2] << 4) | (indices[y * 4 + 3] << 6));
+            }
+        }
+        //---------------------------------------------------------------------
+        void decodeColourBlock(const uint8* in, bool allowThreeColours, BlockPixels& pixels)
+        {
+            uint16 colour0 = static_cast<uint16>(in[0] | (in[1] << 8));
+            uint16 colour1 = static_cast<uint16>(in[2] | (in[3] << 8));
+            const bool fourColours = !allowThreeColours || colour0 > colour1;
+            int palette[4][3];
+            buildColourPalette(colour0, colour1, fourColours, palette);
+
+            for (size_t i = 0; i < 16; ++i)
+            {
+                int index = (in[4 + i / 4] >> (2 * (i % 4))) & 3;
+                for (int k = 0; k < 3; ++k)
+                    pixels[i][k] = static_cast<uint8>(palette[index][k]);
+                pixels[i][3] = !fourColours && index == 3 ? 0 : 255;
+            }
+        }
+        //---------------------------------------------------------------------
+        // BC4 single channel blocks, also used by BC3 and BC5
+        //---------------------------------------------------------------------
+        /// Encodes one channel of a block into 8 bytes, with 8 interpolated values
+        void encodeChannelBlock(const BlockPixels& pixels, size_t channel, uint8* out)
+        {
+            int value0 = 0, value1 = 255;
+            for (size_t i = 0; i < 16; ++i)
+            {
+                value0 = std::max(value0, int(pixels[i][channel]));
+                value1 = std::min(value1, int(pixels[i][channel]));
+            }
+            out[0] = static_cast<uint8>(value0);
+            out[1] = static_cast<uint8>(value1);
+
+            uint64 bits = 0;
+            if (value0 > value1)
+            {
+                const int range = value0 - value1;
+                for (size_t i = 0; i < 16; ++i)
+                {
+                    // nearest of the 8 steps from value1 to value0
+                    int step = ((pixels[i][channel] - value1) * 14 + range) / (2 * range);
+                    uint64 index = step == 7 ? 0 : (step == 0 ? 1 : 8 - step);
+                    bits |= index << (3 * i);
+                }
+            }
+            for (size_t b = 0; b < 6; ++b)
+                out[2 + b] = static_cast<uint8>(bits >> (8 * b));
+        }
+        //---------------------------------------------------------------------
+        void decodeChannelBlock(const uint8* in, size_t channel, BlockPixels& pixels)
+        {
+            const int value0 = in[0], value1 = in[1];
+            int palette[8] = { value0, value1 };
+            if (value0 > value1)
+            {
+                for (int i = 2; i < 8; ++i)
+                    palette[i] = ((8 - i) * value0 + (i - 1) * value1 + 3) / 7;
+            }
+            else
+            {
+                for (int i = 2; i < 6; ++i)
+                    palette[i] = ((6 - i) * value0 + (i - 1) * value1 + 2) / 5;
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+
+            uint64 bits = 0;
+            for (size_t b = 0; b < 6; ++b)
+                bits |= uint64(in[2 + b]) << (8 * b);
+            for (size_t i = 0; i < 16; ++i)
+                pixels[i][channel] = static_cast<uint8>(palette[(bits >> (3 * i)) & 7]);
+        }
+        //---------------------------------------------------------------------
+        // ETC1 blocks
+        //---------------------------------------------------------------------
+        const int etc1Modifiers[8][2] =
+        {
+            { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+        };
+        //---------------------------------------------------------------------
+        /// Modifier of a pixel index: small and large, positive then negative
+        inline int etc1Modifier(int table, int index)
+        {
+            int modifier = etc1Modifiers[table][index & 1];
+            return index & 2 ? -modifier : modifier;
+        }
+        //---------------------------------------------------------------------
+        /// Whether a pixel is in the second half of a block, right or bottom when flipped
+        inline bool inSecondHalf(size_t i, bool flip)
+        {
+            return flip ? i >= 8 : (i & 3) >= 2;
+        }
+        //---------------------------------------------------------------------
+        /// Best table and pixel indices of a half for its base colour, returns the squared error
+        int fitEtc1Half(const BlockPixels& pixels, bool flip, bool second, const int* base,
+            int& bestTable, uint8* indices)
+        {
+            int bestError = INT_MAX;
+            uint8 tableIndices[16];
+            for (int table = 0; table < 8; ++table)
+            {
+                int error = 0;
+                for (size_t i = 0; i < 16 && error < bestError; ++i)
+                {
+                    if (inSecondHalf(i, flip) != second)
+                        continue;
+                    int bestPixelError = INT_MAX;
+                    for (int index = 0; index < 4; ++index)
+                    {
+                        const int modifier = etc1Modifier(table, index);
+                        int dr = clampByte(base[0] + modifier) - pixels[i][0];
+                        int dg = clampByte(base[1] + modifier) - pixels[i][1];
+                        int db = clampByte(base[2] + modifier) - pixels[i][2];
+                        int e = dr * dr + dg * dg + db * db;
+                        if (e < bestPixelError)
+                        {
+                            bestPixelError = e;
+                            tableIndices[i] = static_cast<uint8>(index);
+                        }
+                    }
+                    error += bestPixelError;
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestTable = table;
+                    for (size_t i = 0; i < 16; ++i)
+                    {
+                        if (inSecondHalf(i, flip) == second)
+                            indices[i] = tableIndices[i];
+                    }
+                }
+            }
+            return bestError;
+        }
+        //---------------------------------------------------------------------
+        inline void writeBigEndian(uint32 value, uint8* out)
+        {
+            out[0] = static_cast<uint8>(value >> 24);
+            out[1] = static_cast<uint8>(value >> 16);
+            out[2] = static_cast<uint8>(value >> 8);
+            out[3] = static_cast<uint8>(value);
+        }
+        //---------------------------------------------------------------------
+        void encodeEtc1Block(const BlockPixels& pixels, uint8* out)
+        {
+            int bestError = INT_MAX;
+            uint32 bestHigh = 0, bestLow = 0;
+            for (int flip = 0; flip < 2; ++flip)
+            {
+                // average colours of both halves
+                float average[2][3] = { { 0, 0, 0 }, { 0, 0, 0 } };
+                for (size_t i = 0; i < 16; ++i)
+                {
+                    for (int k = 0; k < 3; ++k)
+                        average[inSecondHalf(i, flip != 0)][k] += pixels[i][k] / 8.0f;
+                }
+
+                // individual mode quantises both to 4 bits; differential mode
+                // quantises to 5 bits, if the second is close enough
+                for (int differential = 0; differential < 2; ++differential)
+                {
+                    int quantised[2][3], base[2][3];
+                    bool valid = true;
+                    for (int half = 0; half < 2; ++half)
+                    {
+                        for (int k = 0; k < 3; ++k)
+                        {
+                            if (differential)
+                            {
+                                int q = clampByte(static_cast<int>(average[half][k] * 31.0f / 255.0f + 0.5f));
+                                quantised[half][k] = std::min(q, 31);
+                                base[half][k] = (quantised[half][k] << 3) | (quantised[half][k] >> 2);
+                            }
+                            else
+                            {
+                                int q = clampByte(static_cast<int>(average[half][k] * 15.0f / 255.0f + 0.5f));
+                                quantised[half][k] = std::min(q, 15);
+                                base[half][k] = quantised[half][k] * 17;
+                            }
+                        }
+                    }
+                    if (differential)
+                    {
+                        for (int k = 0; k < 3; ++k)
+                        {
+                            int delta = quantised[1][k] - quantised[0][k];
+                            valid = valid && delta >= -4 && delta <= 3;
+                        }
+                    }
+                    if (!valid)
+                        continue;
+
+                    int tables[2];
+                    uint8 indices[16];
+                    int error = fitEtc1Half(pixels, flip != 0, false, base[0], tables[0], indices);
+                    if (error >= bestError)
+                        continue;
+                    error += fitEtc1Half(pixels, flip != 0, true, base[1], tables[1], indices);
+                    if (error >= bestError)
+                        continue;
+
+                    bestError = error;
+                    bestHigh = 0;
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        const int shift = 27 - 8 * k;
+                        if (differential)
+                        {
+                            bestHigh |= quantised[0][k] << shift;
+                            bestHigh |= ((quantised[1][k] - quantised[0][k]) & 7) << (shift - 3);
+                        }
+                        else
+                        {
+                            bestHigh |= quantised[0][k] << (shift + 1);
+                            bestHigh |= quantised[1][k] << (shift - 3);
+                        }
+                    }
+                    bestHigh |= (tables[0] << 5) | (tables[1] << 2) | (differential << 1) | flip;
+
+                    // index bits run down the columns, most significant bits first
+                    bestLow = 0;
+                    for (size_t i = 0; i < 16; ++i)
+                    {
+                        const size_t bit = (i & 3) * 4 + i / 4;
+                        bestLow |= uint32(indices[i] >> 1) << (16 + bit);
+                        bestLow |= uint32(indices[i] & 1) << bit;
+                    }
+                }
+            }
+
+            writeBigEndian(bestHigh, out);
+            writeBigEndian(bestLow, out + 4);
+        }
+        //---------------------------------------------------------------------
+        void decodeEtc1Block(const uint8* in, BlockPixels& pixels)
+        {
+            const uint32 high = uint32(in[0]) << 24 | uint32(in[1]) << 16 | uint32(in[2]) << 8 | in[3];
+            const uint32 low = uint32(in[4]) << 24 | uint32(in[5]) << 16 | uint32(in[6]) << 8 | in[7];
+            const bool flip = (high & 1) != 0, differential = (high & 2) != 0;
+            const int tables[2] = { int(high >> 5) & 7, int(high >> 2) & 7 };
+
+            int base[2][3];
+            for (int k = 0; k < 3; ++k)
+            {
+                const int shift = 27 - 8 * k;
+                if (differential)
+                {
+                    int first = (high >> shift) & 31;
+                    int delta = (high >> (shift - 3)) & 7;
+                    int second = first + (delta >= 4 ? delta - 8 : delta);
+                    base[0][k] = (first << 3) | (first >> 2);
+                    base[1][k] = (second << 3) | (second >> 2);
+                }
+                else
+                {
+                    base[0][k] = ((high >> (shift + 1)) & 15) * 17;
+                    base[1][k] = ((high >> (shift - 3)) & 15) * 17;
+                }
+            }
+
+            for (size_t i = 0; i < 16; ++i)
+            {
+                const size_t bit = (i & 3) * 4 + i / 4;
+                const int index = int((low >> (16 + bit)) & 1) << 1 | int((low >> bit) & 1);
+                const int half = inSecondHalf(i, flip);
+                const int modifier = etc1Modifier(tables[half], index);
+                for (int k = 0; k < 3; ++k)
+                    pixels[i][k] = static_cast<uint8>(clampByte(base[half][k] + modifier));
+                pixels[i][3] = 255;
+            }
+        }
+        //---------------------------------------------------------------------
+        void encodeBlock(PixelFormat format, const BlockPixels& pixels, uint8* out)
+        {
+            switch (format)
+            {
+            case PF_DXT1:
+                encodeColourBlock(pixels, true, out);
+                break;
+            case PF_DXT5:
+                encodeChannelBlock(pixels, 3, out);
+                encodeColourBlock(pixels, false, out + 8);
+                break;
+            case PF_BC4_UNORM:
+                encodeChannelBlock(pixels, 0, out);
+                break;
+            case PF_BC5_UNORM:
+                encodeChannelBlock(pixels, 0, out);
+                encodeChannelBlock(pixels, 1, out + 8);
+                break;
+            case PF_ETC1_RGB8:
+                encodeEtc1Block(pixels, out);
+                break;
+            default:
+                break;
+            }
+        }
+        //---------------------------------------------------------------------
+        void decodeBlock(PixelFormat format, const uint8* in, BlockPixels& pixels)
+        {
+            switch (format)
+            {
+            case PF_DXT1:
+                decodeColourBlock(in, true, pixels);
+                break;
+            case PF_DXT5:
+                decodeColourBlock(in + 8, false, pixels);
+                decodeChannelBlock(in, 3, pixels);
+                break;
+            case PF_BC4_UNORM:
+            case PF_BC5_UNORM:
+                memset(pixels, 0, sizeof(BlockPixels));
+                decodeChannelBlock(in, 0, pixels);
+                if (format == PF_BC5_UNORM)
+                    decodeChannelBlock(in + 8, 1, pixels);
+                for (size_t i = 0; i < 16; ++i)
+                    pixels[i][3] = 255;
+                break;
+            case PF_ETC1_RGB8:
+                decodeEtc1Block(in, pixels);
+                break;
+            default:
+                break;
+            }
+        }
+        //---------------------------------------------------------------------
+        /// Box of one row of a slice of box
+        PixelBox getRow(const PixelBox& box, size_t y, size_t z)
+        {
+            return box.getSubVolume(Box(box.left, box.top + y, box.front + z,
+                box.right, box.top + y + 1, box.front + z + 1));
+        }
+        //---------------------------------------------------------------------
+        /// Encodes rows of blocks, indices running over the rows of every slice
+        struct CompressRows
+        {
+            const PixelBox* src;
+            const PixelBox* dst;
+
+            void operator()(size_t begin, size_t end) const
+            {
+                const size_t width = src->getWidth(), height = src->getHeight();
+                const size_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+                const size_t blockSize = getBlockSize(dst->format);
+
+                // 4 rows of source pixels as R, G, B, A bytes
+                vector<uint8>::type rows(width * 4 * 4);
+                for (size_t blockRow = begin; blockRow < end; ++blockRow)
+                {
+                    const size_t z = blockRow / blocksY, by = blockRow % blocksY;
+                    for (size_t y = 0; y < 4; ++y)
+                    {
+                        // bottom rows of partial blocks repeat the last one
+                        size_t sy = std::min(by * 4 + y, height - 1);
+                        PixelUtil::bulkPixelConversion(getRow(*src, sy, z),
+                            PixelBox(width, 1, 1, PF_BYTE_RGBA, &rows[y * width * 4]));
+                    }
+
+                    uint8* out = static_cast<uint8*>(dst->data) + blockRow * blocksX * blockSize;
+                    for (size_t bx = 0; bx < blocksX; ++bx, out += blockSize)
+                    {
+                        BlockPixels pixels;
+                        for (size_t i = 0; i < 16; ++i)
+                        {
+                            size_t sx = std::min(bx * 4 + (i & 3), width - 1);
+                            memcpy(pixels[i], &rows[((i >> 2) * width + sx) * 4], 4);
+                        }
+                        encodeBlock(dst->format, pixels, out);
+                    }
+                }
+            }
+        };
+    }
+    //---------------------------------------------------------------------
+    bool BlockCompression::canCompress(PixelFormat format)
+    {
+        switch (format)
+        {
+        case PF_DXT1:
+        case PF_DXT5:
+        case PF_BC4_UNORM:
+        case PF_BC5_UNORM:
+        case PF_ETC1_RGB8:
+            return true;
+        default:
+            return false;
+        }
+    }
+    //---------------------------------------------------------------------
+    bool BlockCompression::canDecompress(PixelFormat format)
+    {
+        return canCompress(format);
+    }
+    //---------------------------------------------------------------------
+    void BlockCompression::compress(const PixelBox& src, const PixelBox& dst, TaskScheduler* scheduler)
+    {
+        if (!canCompress(dst.format) || PixelUtil::isCompressed(src.format))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Can't compress from " + PixelUtil::getFormatName(src.format) +
+                " to " + PixelUtil::getFormatName(dst.format),
+                "BlockCompression::compress");
+        }
+        assert(src.getWidth() == dst.getWidth() && src.getHeight() == dst.getHeight() &&
+               src.getDepth() == dst.getDepth());
+
+        if (!scheduler)
+        {
+            Root* root = Root::getSingletonPtr();
+            WorkQueue* queue = root ? root->getWorkQueue() : 0;
+            scheduler = queue ? queue->getTaskScheduler() : 0;
+        }
+
+        CompressRows rows = { &src, &dst };
+        const size_t blocksX = (src.getWidth() + 3) / 4;
+        const size_t numBlockRows = (src.getHeight() + 3) / 4 * src.getDepth();
+        if (scheduler)
+        {
+            size_t grain = std::max<size_t>(COMPRESSION_GRAIN_BLOCKS / blocksX, 1);
+            scheduler->parallelFor(0, numBlockRows, grain, rows);
+        }
+        else
+            rows(0, numBlockRows);
+    }
+    //---------------------------------------------------------------------
+    void BlockCompression::decompress(const PixelBox& src, const PixelBox& dst)
+    {
+        if (!canDecompress(src.format) || PixelUtil::isCompressed(dst.format))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Can't decompress from " + PixelUtil::getFormatName(src.format) +
+                " to " + PixelUtil::getFormatName(dst.format),
+                "BlockCompression::decompress");
+        }
+        assert(src.getWidth() == dst.getWidth() && src.getHeight() == dst.getHeight() &&
+               src.getDepth() == dst.getDepth());
+
+        const size_t width = src.getWidth(), height = src.getHeight();
+        const size_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+        const size_t blockSize = getBlockSize(src.format);
+        vector<uint8>::type rows(blocksX * 4 * 4 * 4);
+
+        const uint8* in = static_cast<const uint8*>(src.data);
+        for (size_t z = 0; z < src.getDepth(); ++z)
+        {
+            for (size_t by = 0; by < blocksY; ++by)
+            {
+                for (size_t bx = 0; bx < blocksX; ++bx, in += blockSize)
+                {
+                    BlockPixels pixels;
+                    decodeBlock(src.format, in, pixels);
+                    for (size_t i = 0; i < 16; ++i)
+                        memcpy(&rows[((i >> 2) * blocksX * 4 + bx * 4 + (i & 3)) * 4], pixels[i], 4);
+                }
+
+                for (size_t y = 0; y < 4 && by * 4 + y < height; ++y)
+                {
+                    PixelUtil::bulkPixelConversion(
+                        PixelBox(width, 1, 1, PF_BYTE_RGBA, &rows[y * blocksX * 4 * 4]),
+                        getRow(dst, by * 4 + y, z));
+                }
+            }
+        }
+    }
+}
@@ -135,6 +135,7 @@ namespace Ogre {
     const uint32 DDSD_HEIGHT = 0x00000002;
     const uint32 DDSD_WIDTH = 0x00000004;
     const uint32 DDSD_PIXELFORMAT = 0x00001000;
+    const uint32 DDSD_LINEARSIZE = 0x00080000;
     const uint32 DDSD_DEPTH = 0x00800000;
     const uint32 DDPF_ALPHAPIXELS = 0x00000001;
     const uint32 DDPF_FOURCC = 0x00000004;
@@ -154,7 +155,6 @@ namespace Ogre {
     // Currently unused
 //    const uint32 DDSD_PITCH = 0x00000008;
 //    const uint32 DDSD_MIPMAPCOUNT = 0x00020000;
-//    const uint32 DDSD_LINEARSIZE = 0x00080000;
 
     // Special FourCC codes
     const uint32 D3DFMT_R16F            = 111;
@@ -223,6 +223,7 @@ namespace Ogre {
         bool isFloat32r = (imgData->format == PF_FLOAT32_R);
         bool isFloat16 = (imgData->format == PF_FLOAT16_RGBA);
         bool isFloat32 = (imgData->format == PF_FLOAT32_RGBA);
+        bool isCompressed = PixelUtil::isCompressed(imgData->format);
         bool notImplemented = false;
         String notImplementedString = "";
 
@@ -257,6 +258,10 @@ namespace Ogre {
         case PF_FLOAT32_R:
         case PF_FLOAT16_RGBA:
         case PF_FLOAT32_RGBA:
+        case PF_DXT1:
+        case PF_DXT5:
+        case PF_BC4_UNORM:
+        case PF_BC5_UNORM:
             break;
         default:
             // No crazy FOURCC or 565 et al. file formats at this stage
@@ -330,6 +335,14 @@ namespace Ogre {
             // Initalise the SizeOrPitch flags (power two textures for now)
             ddsHeaderSizeOrPitch = static_cast<uint32>(ddsHeaderRgbBits * imgData->width);
 
+            // Compressed formats give the size of the top level instead
+            if (isCompressed)
+            {
+                ddsHeaderFlags |= DDSD_LINEARSIZE;
+                ddsHeaderSizeOrPitch = static_cast<uint32>(PixelUtil::getMemorySize(
+                    imgData->width, imgData->height, 1, imgData->format));
+            }
+
             // Initalise the caps flags
             ddsHeaderCaps1 = (isVolume||isCubeMap) ? DDSCAPS_COMPLEX|DDSCAPS_TEXTURE : DDSCAPS_TEXTURE;
             if (isVolume)
@@ -365,7 +378,7 @@ namespace Ogre {
 
             ddsHeader.pixelFormat.size = DDS_PIXELFORMAT_SIZE;
             ddsHeader.pixelFormat.flags = (hasAlpha) ? DDPF_RGB|DDPF_ALPHAPIXELS : DDPF_RGB;
-            ddsHeader.pixelFormat.flags = (isFloat32r || isFloat16 || isFloat32) ? DDPF_FOURCC : ddsHeader.pixelFormat.flags;
+            ddsHeader.pixelFormat.flags = (isFloat32r || isFloat16 || isFloat32 || isCompressed) ? DDPF_FOURCC : ddsHeader.pixelFormat.flags;
             if (isFloat32r) {
                 ddsHeader.pixelFormat.fourCC = D3DFMT_R32F;
             }
@@ -375,6 +388,18 @@ namespace Ogre {
             else if (isFloat32) {
                 ddsHeader.pixelFormat.fourCC = D3DFMT_A32B32G32R32F;
             }
+            else if (imgData->format == PF_DXT1) {
+                ddsHeader.pixelFormat.fourCC = FOURCC('D','X','T','1');
+            }
+            else if (imgData->format == PF_DXT5) {
+                ddsHeader.pixelFormat.fourCC = FOURCC('D','X','T','5');
+            }
+            else if (imgData->format == PF_BC4_UNORM) {
+                ddsHeader.pixelFormat.fourCC = FOURCC('A','T','I','1');
+            }
+            else if (imgData->format == PF_BC5_UNORM) {
+                ddsHeader.pixelFormat.fourCC = FOURCC('A','T','I','2');
+            }
             else {
                 ddsHeader.pixelFormat.fourCC = 0;
             }
@@ -389,6 +414,14 @@ namespace Ogre {
             if( flipRgbMasks )
                 std::swap( ddsHeader.pixelFormat.redMask, ddsHeader.pixelFormat.blueMask );
 
+            if (isCompressed)
+            {
+                ddsHeader.pixelFormat.alphaMask = 0;
+                ddsHeader.pixelFormat.redMask = 0;
+                ddsHeader.pixelFormat.greenMask = 0;
+                ddsHeader.pixelFormat.blueMask = 0;
+            }
+
             ddsHeader.caps.caps1 = ddsHeaderCaps1;
             ddsHeader.caps.caps2 = ddsHeaderCaps2;
 //          ddsHeader.caps.reserved[0] = 0;
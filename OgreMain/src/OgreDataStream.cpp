@@ -30,6 +30,24 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreException.h"
 
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX || OGRE_PLATFORM == OGRE_PLATFORM_APPLE || \
+    OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS || OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
+#   define OGRE_MAPPED_FILE_POSIX 1
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#elif OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+#   define OGRE_MAPPED_FILE_WIN32 1
+#   define WIN32_LEAN_AND_MEAN
+#   if !defined(NOMINMAX) && defined(_MSC_VER)
+#       define NOMINMAX // required to stop windows.h messing up std::min
+#   endif
+#   include <windows.h>
+#else
+#   include <fstream>
+#endif
+
 namespace Ogre {
 
     //-----------------------------------------------------------------------
@@ -342,6 +360,15 @@ namespace Ogre {
         close();
     }
     //-----------------------------------------------------------------------
+    String MemoryDataStream::getAsString(void)
+    {
+        // Straight from memory, no intermediate buffer
+        if (!mData)
+            return BLANKSTRING;
+        mPos = mEnd;
+        return String(reinterpret_cast<const char*>(mData), mSize);
+    }
+    //-----------------------------------------------------------------------
     size_t MemoryDataStream::read(void* buf, size_t count)
     {
         size_t cnt = count;
@@ -470,6 +497,114 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
+    MappedFileDataStream::MappedFileDataStream(const String& name, const String& fullPath)
+        : MemoryDataStream(name, 0, 0, false, true), mMapped(false)
+    {
+#if OGRE_MAPPED_FILE_POSIX
+        int fd = ::open(fullPath.c_str(), O_RDONLY);
+        struct stat tagStat;
+        if (fd < 0 || fstat(fd, &tagStat) != 0)
+        {
+            if (fd >= 0)
+                ::close(fd);
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND,
+                "Cannot open file: " + fullPath,
+                "MappedFileDataStream::MappedFileDataStream");
+        }
+        mSize = static_cast<size_t>(tagStat.st_size);
+        if (mSize)
+        {
+            void* pMem = mmap(0, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (pMem == MAP_FAILED)
+            {
+                ::close(fd);
+                OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                    "Cannot map file: " + fullPath,
+                    "MappedFileDataStream::MappedFileDataStream");
+            }
+            mData = static_cast<uchar*>(pMem);
+            mMapped = true;
+        }
+        // The mapping keeps its own reference to the file
+        ::close(fd);
+#elif OGRE_MAPPED_FILE_WIN32
+        HANDLE hFile = CreateFileA(fullPath.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+        LARGE_INTEGER fileSize;
+        if (hFile == INVALID_HANDLE_VALUE || !GetFileSizeEx(hFile, &fileSize))
+        {
+            if (hFile != INVALID_HANDLE_VALUE)
+                CloseHandle(hFile);
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND,
+                "Cannot open file: " + fullPath,
+                "MappedFileDataStream::MappedFileDataStream");
+        }
+        mSize = static_cast<size_t>(fileSize.QuadPart);
+        if (mSize)
+        {
+            HANDLE hMapping = CreateFileMapping(hFile, 0, PAGE_READONLY, 0, 0, 0);
+            void* pMem = hMapping ? MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0) : 0;
+            // The view keeps its own references to the mapping and the file
+            if (hMapping)
+                CloseHandle(hMapping);
+            if (!pMem)
+            {
+                CloseHandle(hFile);
+                OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                    "Cannot map file: " + fullPath,
+                    "MappedFileDataStream::MappedFileDataStream");
+            }
+            mData = static_cast<uchar*>(pMem);
+            mMapped = true;
+        }
+        CloseHandle(hFile);
+#else
+        // No file mapping, read the whole file instead
+        std::ifstream file(fullPath.c_str(), std::ios::in | std::ios::binary);
+        if (!file)
+        {
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND,
+                "Cannot open file: " + fullPath,
+                "MappedFileDataStream::MappedFileDataStream");
+        }
+        file.seekg(0, std::ios_base::end);
+        mSize = static_cast<size_t>(file.tellg());
+        file.seekg(0, std::ios_base::beg);
+        if (mSize)
+        {
+            mData = OGRE_ALLOC_T(uchar, mSize, MEMCATEGORY_GENERAL);
+            mFreeOnClose = true;
+            file.read(reinterpret_cast<char*>(mData), static_cast<std::streamsize>(mSize));
+        }
+#endif
+        mPos = mData;
+        mEnd = mData + mSize;
+    }
+    //-----------------------------------------------------------------------
+    MappedFileDataStream::~MappedFileDataStream()
+    {
+        close();
+    }
+    //-----------------------------------------------------------------------
+    void MappedFileDataStream::close(void)
+    {
+        if (mMapped && mData)
+        {
+#if OGRE_MAPPED_FILE_POSIX
+            munmap(mData, mSize);
+#elif OGRE_MAPPED_FILE_WIN32
+            UnmapViewOfFile(mData);
+#endif
+            mData = mPos = mEnd = 0;
+            mMapped = false;
+        }
+        else
+        {
+            MemoryDataStream::close();
+        }
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
     FileStreamDataStream::FileStreamDataStream(std::ifstream* s, bool freeOnClose)
         : DataStream(), mInStream(s), mFStreamRO(s), mFStream(0), mFreeOnClose(freeOnClose)
     {
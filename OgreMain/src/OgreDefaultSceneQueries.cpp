@@ -28,8 +28,22 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 #include "OgreSceneManager.h"
 #include "OgreRoot.h"
+#include "OgreSceneQueryBroadphase.h"
 
 namespace Ogre {
+    //---------------------------------------------------------------------
+    /// Orders the objects of an intersection query, so each pair found from
+    /// both of its objects is only reported once
+    static inline bool isBefore(const MovableObject* a, const MovableObject* b,
+        const SceneManager* sceneMgr)
+    {
+        // Objects of other managers have no proxy here, they come last
+        const uint32 proxyA = a->_getManager() == sceneMgr ?
+            a->_getSceneQueryProxy() : SceneQueryBroadphase::NO_PROXY;
+        const uint32 proxyB = b->_getManager() == sceneMgr ?
+            b->_getSceneQueryProxy() : SceneQueryBroadphase::NO_PROXY;
+        return proxyA < proxyB || (proxyA == proxyB && a < b);
+    }
     //---------------------------------------------------------------------
     DefaultIntersectionSceneQuery::DefaultIntersectionSceneQuery(SceneManager* creator)
     : IntersectionSceneQuery(creator)
@@ -44,6 +58,38 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
     {
+        SceneQueryBroadphase* broadphase = mParentSceneMgr->_updateSceneQueryBroadphase();
+        if (broadphase)
+        {
+            SceneQueryBroadphase::ObjectList objects;
+            broadphase->getObjects(objects);
+            for (SceneQueryBroadphase::ObjectList::iterator i = objects.begin(); i != objects.end(); ++i)
+            {
+                MovableObject* a = *i;
+                if (!(a->getTypeFlags() & mQueryTypeMask) ||
+                    !(a->getQueryFlags() & mQueryMask) ||
+                    !a->isInScene())
+                    continue;
+
+                // Test the objects near a, each pair is reported from its first object
+                const AxisAlignedBox& box1 = a->getWorldBoundingBox();
+                broadphase->findObjects(box1, mCandidates);
+                for (SceneQueryBroadphase::ObjectList::iterator j = mCandidates.begin(); j != mCandidates.end(); ++j)
+                {
+                    MovableObject* b = *j;
+                    if (b != a && isBefore(a, b, mParentSceneMgr) &&
+                        (b->getTypeFlags() & mQueryTypeMask) &&
+                        (b->getQueryFlags() & mQueryMask) &&
+                        b->isInScene() &&
+                        box1.intersects(b->getWorldBoundingBox()))
+                    {
+                        if (!listener->queryResult(a, b)) return;
+                    }
+                }
+            }
+            return;
+        }
+
         // Iterate over all movable types
         Root::MovableObjectFactoryIterator factIt = 
             Root::getSingleton().getMovableObjectFactoryIterator();
@@ -134,6 +180,24 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultAxisAlignedBoxSceneQuery::execute(SceneQueryListener* listener)
     {
+        SceneQueryBroadphase* broadphase = mParentSceneMgr->_updateSceneQueryBroadphase();
+        if (broadphase)
+        {
+            broadphase->findObjects(mAABB, mCandidates);
+            for (SceneQueryBroadphase::ObjectList::iterator i = mCandidates.begin(); i != mCandidates.end(); ++i)
+            {
+                MovableObject* a = *i;
+                if ((a->getTypeFlags() & mQueryTypeMask) &&
+                    (a->getQueryFlags() & mQueryMask) && 
+                    a->isInScene() &&
+                    mAABB.intersects(a->getWorldBoundingBox()))
+                {
+                    if (!listener->queryResult(a)) return;
+                }
+            }
+            return;
+        }
+
         // Iterate over all movable types
         Root::MovableObjectFactoryIterator factIt = 
             Root::getSingleton().getMovableObjectFactoryIterator();
@@ -172,11 +236,35 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultRaySceneQuery::execute(RaySceneQueryListener* listener)
     {
-        // Note that because we have no scene partitioning, we actually
-        // perform a complete scene search even if restricted results are
-        // requested; smarter scene manager queries can utilise the paritioning 
-        // of the scene in order to reduce the number of intersection tests 
-        // required to fulfil the query
+        SceneQueryBroadphase* broadphase = mParentSceneMgr->_updateSceneQueryBroadphase();
+        if (broadphase)
+        {
+            broadphase->findObjects(mRay, mCandidates);
+            for (SceneQueryBroadphase::ObjectList::iterator i = mCandidates.begin(); i != mCandidates.end(); ++i)
+            {
+                MovableObject* a = *i;
+                if ((a->getTypeFlags() & mQueryTypeMask) &&
+                    (a->getQueryFlags() & mQueryMask) &&
+                    a->isInScene())
+                {
+                    // Do ray / box test
+                    std::pair<bool, Real> result =
+                        mRay.intersects(a->getWorldBoundingBox());
+
+                    if (result.first)
+                    {
+                        if (!listener->queryResult(a, result.second)) return;
+                    }
+                }
+            }
+            return;
+        }
+
+        // Note that without the broadphase, we actually perform a complete
+        // scene search even if restricted results are requested; smarter
+        // scene manager queries can utilise the paritioning of the scene in
+        // order to reduce the number of intersection tests required to
+        // fulfil the query
 
         // Iterate over all movable types
         Root::MovableObjectFactoryIterator factIt = 
@@ -225,6 +313,29 @@ namespace Ogre {
     {
         Sphere testSphere;
 
+        SceneQueryBroadphase* broadphase = mParentSceneMgr->_updateSceneQueryBroadphase();
+        if (broadphase)
+        {
+            broadphase->findObjects(mSphere, mCandidates);
+            for (SceneQueryBroadphase::ObjectList::iterator i = mCandidates.begin(); i != mCandidates.end(); ++i)
+            {
+                MovableObject* a = *i;
+                if (!(a->getTypeFlags() & mQueryTypeMask) ||
+                    !a->isInScene() || 
+                    !(a->getQueryFlags() & mQueryMask))
+                    continue;
+
+                // Do sphere / sphere test
+                testSphere.setCenter(a->getParentNode()->_getDerivedPosition());
+                testSphere.setRadius(a->getBoundingRadius());
+                if (mSphere.intersects(testSphere))
+                {
+                    if (!listener->queryResult(a)) return;
+                }
+            }
+            return;
+        }
+
         // Iterate over all movable types
         Root::MovableObjectFactoryIterator factIt = 
             Root::getSingleton().getMovableObjectFactoryIterator();
@@ -269,6 +380,33 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultPlaneBoundedVolumeListSceneQuery::execute(SceneQueryListener* listener)
     {
+        SceneQueryBroadphase* broadphase = mParentSceneMgr->_updateSceneQueryBroadphase();
+        if (broadphase)
+        {
+            broadphase->findObjects(mVolumes, mCandidates);
+            for (SceneQueryBroadphase::ObjectList::iterator i = mCandidates.begin(); i != mCandidates.end(); ++i)
+            {
+                MovableObject* a = *i;
+                if (!(a->getTypeFlags() & mQueryTypeMask) ||
+                    !(a->getQueryFlags() & mQueryMask) ||
+                    !a->isInScene())
+                    continue;
+
+                PlaneBoundedVolumeList::iterator pi, piend;
+                piend = mVolumes.end();
+                for (pi = mVolumes.begin(); pi != piend; ++pi)
+                {
+                    // Do AABB / plane volume test
+                    if (pi->intersects(a->getWorldBoundingBox()))
+                    {
+                        if (!listener->queryResult(a)) return;
+                        break;
+                    }
+                }
+            }
+            return;
+        }
+
         // Iterate over all movable types
         Root::MovableObjectFactoryIterator factIt = 
             Root::getSingleton().getMovableObjectFactoryIterator();
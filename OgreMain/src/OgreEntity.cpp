@@ -33,6 +33,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreSubEntity.h"
 #include "OgreException.h"
 #include "OgreSceneManager.h"
+#include "OgreSoftwareSkinningBatch.h"
 #include "OgreLogManager.h"
 #include "OgreSkeleton.h"
 #include "OgreBone.h"
@@ -50,6 +51,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreLodStrategy.h"
 #include "OgreLodListener.h"
 #include "OgreMaterialManager.h"
+#include "OgreSceneQueryBroadphase.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -948,6 +950,10 @@ namespace Ogre {
                 if (softwareAnimation)
                 {
                     const Matrix4* blendMatrices[256];
+                    // Gathered by the scene manager when batching, see
+                    // SceneManager::setBatchedSoftwareSkinning
+                    SoftwareSkinningBatch* batch = root._getCurrentSceneManager() ?
+                        root._getCurrentSceneManager()->_getSoftwareSkinningBatch() : 0;
 
                     // Ok, we need to do a software blend
                     // Firstly, check out working vertex buffers
@@ -964,12 +970,17 @@ namespace Ogre {
                         Mesh::prepareMatricesForVertexBlend(blendMatrices,
                                                             mBoneMatrices, mMesh->sharedBlendIndexToBoneIndexMap);
                         // Blend, taking source from either mesh data or morph data
-                        Mesh::softwareVertexBlend(
+                        const VertexData* sourceData =
                             (mMesh->getSharedVertexDataAnimationType() != VAT_NONE) ?
-                            mSoftwareVertexAnimVertexData : mMesh->sharedVertexData,
-                            mSkelAnimVertexData,
-                            blendMatrices, mMesh->sharedBlendIndexToBoneIndexMap.size(),
-                            blendNormals);
+                            mSoftwareVertexAnimVertexData : mMesh->sharedVertexData;
+                        if (batch)
+                            batch->add(sourceData, mSkelAnimVertexData,
+                                blendMatrices, mMesh->sharedBlendIndexToBoneIndexMap.size(),
+                                blendNormals);
+                        else
+                            Mesh::softwareVertexBlend(sourceData, mSkelAnimVertexData,
+                                blendMatrices, mMesh->sharedBlendIndexToBoneIndexMap.size(),
+                                blendNormals);
                     }
                     SubEntityList::iterator i, iend;
                     iend = mSubEntityList.end();
@@ -986,12 +997,17 @@ namespace Ogre {
                             Mesh::prepareMatricesForVertexBlend(blendMatrices,
                                                                 mBoneMatrices, se->mSubMesh->blendIndexToBoneIndexMap);
                             // Blend, taking source from either mesh data or morph data
-                            Mesh::softwareVertexBlend(
+                            const VertexData* sourceData =
                                 (se->getSubMesh()->getVertexAnimationType() != VAT_NONE)?
-                                se->mSoftwareVertexAnimVertexData : se->mSubMesh->vertexData,
-                                se->mSkelAnimVertexData,
-                                blendMatrices, se->mSubMesh->blendIndexToBoneIndexMap.size(),
-                                blendNormals);
+                                se->mSoftwareVertexAnimVertexData : se->mSubMesh->vertexData;
+                            if (batch)
+                                batch->add(sourceData, se->mSkelAnimVertexData,
+                                    blendMatrices, se->mSubMesh->blendIndexToBoneIndexMap.size(),
+                                    blendNormals);
+                            else
+                                Mesh::softwareVertexBlend(sourceData, se->mSkelAnimVertexData,
+                                    blendMatrices, se->mSubMesh->blendIndexToBoneIndexMap.size(),
+                                    blendNormals);
                         }
 
                     }
@@ -2222,6 +2238,28 @@ namespace Ogre {
 #endif
     }
     //-----------------------------------------------------------------------
+    void Entity::_notifyMoved(void)
+    {
+        MovableObject::_notifyMoved();
+
+        // The world bounds of the objects attached to bones follow the entity,
+        // their tag points only notify them when the skeleton moves
+        SceneQueryBroadphase* broadphase = mManager ? mManager->_getSceneQueryBroadphase() : 0;
+        if (broadphase)
+        {
+            ChildObjectList::iterator i, iend = mChildObjectList.end();
+            for (i = mChildObjectList.begin(); i != iend; ++i)
+            {
+                MovableObject* child = i->second;
+                if (child->_getManager() == mManager &&
+                    child->_getSceneQueryProxy() != SceneQueryBroadphase::NO_PROXY)
+                {
+                    broadphase->_notifyObjectMoved(child);
+                }
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     Entity::EntityShadowRenderable::EntityShadowRenderable(Entity* parent,
         HardwareIndexBufferSharedPtr* indexBuffer, const VertexData* vertexData,
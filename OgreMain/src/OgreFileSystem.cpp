@@ -55,6 +55,7 @@ THE SOFTWARE.
 namespace Ogre {
 
     bool FileSystemArchive::msIgnoreHidden = true;
+    bool FileSystemArchive::msUseMappedFiles = true;
 
     //-----------------------------------------------------------------------
     FileSystemArchive::FileSystemArchive(const String& name, const String& archType, bool readOnly )
@@ -204,6 +205,19 @@ namespace Ogre {
     {
         String full_path = concatenate_path(mName, filename);
 
+        if (readOnly && msUseMappedFiles)
+        {
+            // Map the file rather than stream it, so loaders can use it in place
+            try
+            {
+                return DataStreamPtr(OGRE_NEW MappedFileDataStream(filename, full_path));
+            }
+            catch (Exception&)
+            {
+                // Not mappable (eg. special or network files), stream it instead
+            }
+        }
+
         // Use filesystem to determine size 
         // (quicker than streaming to the end and back)
         struct stat tagStat;
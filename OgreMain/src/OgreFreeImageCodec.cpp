@@ -398,11 +398,20 @@ namespace Ogre {
     //---------------------------------------------------------------------
     Codec::DecodeResult FreeImageCodec::decode(DataStreamPtr& input) const
     {
-        // Buffer stream into memory (TODO: override IO functions instead?)
-        MemoryDataStream memStream(input, true);
+        // Decode in place if the stream is held in memory (eg. a mapped
+        // file), else buffer it into memory (TODO: override IO functions instead?)
+        MemoryDataStreamPtr buffered;
+        MemoryDataStream* memStream = dynamic_cast<MemoryDataStream*>(input.get());
+        if (!memStream)
+        {
+            buffered.bind(OGRE_NEW MemoryDataStream(input, true));
+            memStream = buffered.get();
+        }
+        uchar* pSrc = memStream->getCurrentPtr();
+        size_t srcSize = memStream->size() - memStream->tell();
 
         FIMEMORY* fiMem = 
-            FreeImage_OpenMemory(memStream.getPtr(), static_cast<DWORD>(memStream.size()));
+            FreeImage_OpenMemory(pSrc, static_cast<DWORD>(srcSize));
 
         FIBITMAP* fiBitmap = FreeImage_LoadFromMemory(
             (FREE_IMAGE_FORMAT)mFreeImageType, fiMem);
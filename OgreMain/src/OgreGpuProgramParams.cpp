@@ -930,6 +930,7 @@ namespace Ogre
         , mIgnoreMissingParams(false)
         , mActivePassIterationIndex(std::numeric_limits<size_t>::max())
     {
+        markAutoConstantsChanged();
     }
     //-----------------------------------------------------------------------------
 
@@ -961,6 +962,7 @@ namespace Ogre
         mTransposeMatrices = oth.mTransposeMatrices;
         mIgnoreMissingParams  = oth.mIgnoreMissingParams;
         mActivePassIterationIndex = oth.mActivePassIterationIndex;
+        markAutoConstantsChanged();
 
         return *this;
     }
@@ -2266,6 +2268,7 @@ namespace Ogre
             mAutoConstants.push_back(AutoConstantEntry(acType, physicalIndex, extraInfo, variability, elementSize));
 
         mCombinedVariability |= variability;
+        markAutoConstantsChanged();
 
 
     }
@@ -2316,6 +2319,7 @@ namespace Ogre
             mAutoConstants.push_back(AutoConstantEntry(acType, physicalIndex, rData, variability, elementSize));
 
         mCombinedVariability |= variability;
+        markAutoConstantsChanged();
     }
     //-----------------------------------------------------------------------------
     void GpuProgramParameters::clearAutoConstant(size_t index)
@@ -2333,6 +2337,7 @@ namespace Ogre
                 if (i->physicalIndex == physicalIndex)
                 {
                     mAutoConstants.erase(i);
+                    markAutoConstantsChanged();
                     break;
                 }
             }
@@ -2354,6 +2359,7 @@ namespace Ogre
                     if (i->physicalIndex == def->physicalIndex)
                     {
                         mAutoConstants.erase(i);
+                        markAutoConstantsChanged();
                         break;
                     }
                 }
@@ -2365,6 +2371,7 @@ namespace Ogre
     {
         mAutoConstants.clear();
         mCombinedVariability = GPV_GLOBAL;
+        markAutoConstantsChanged();
     }
     //-----------------------------------------------------------------------------
     GpuProgramParameters::AutoConstantIterator GpuProgramParameters::getAutoConstantIterator(void) const
@@ -2395,6 +2402,57 @@ namespace Ogre
     }
     //-----------------------------------------------------------------------------
 
+    //-----------------------------------------------------------------------------
+    void GpuProgramParameters::markAutoConstantsChanged(void)
+    {
+        mAutoConstantPlanDirty = true;
+        // Versions are never 0, so everything is updated next time
+        mAutoConstantVersions[0] = mAutoConstantVersions[1] = mAutoConstantVersions[2] = 0;
+        mAutoConstantPass = 0;
+    }
+    //-----------------------------------------------------------------------------
+    namespace
+    {
+        /// Orders auto constant indexes by variability, then by type
+        struct AutoConstantPlanLess
+        {
+            const GpuProgramParameters::AutoConstantList& autos;
+            AutoConstantPlanLess(const GpuProgramParameters::AutoConstantList& a) : autos(a) {}
+            bool operator()(size_t a, size_t b) const
+            {
+                const GpuProgramParameters::AutoConstantEntry& ea = autos[a];
+                const GpuProgramParameters::AutoConstantEntry& eb = autos[b];
+                if (ea.variability != eb.variability)
+                    return ea.variability < eb.variability;
+                return ea.paramType < eb.paramType;
+            }
+        };
+    }
+    //-----------------------------------------------------------------------------
+    void GpuProgramParameters::buildAutoConstantPlan(void)
+    {
+        mAutoConstantPlan.resize(mAutoConstants.size());
+        for (size_t i = 0; i < mAutoConstants.size(); ++i)
+            mAutoConstantPlan[i] = i;
+        // Stable, so autos of the same type keep the order they were set in
+        std::stable_sort(mAutoConstantPlan.begin(), mAutoConstantPlan.end(), 
+            AutoConstantPlanLess(mAutoConstants));
+
+        mAutoConstantGroups.clear();
+        for (size_t p = 0; p < mAutoConstantPlan.size(); ++p)
+        {
+            uint16 variability = mAutoConstants[mAutoConstantPlan[p]].variability;
+            if (mAutoConstantGroups.empty() || mAutoConstantGroups.back().variability != variability)
+            {
+                AutoConstantGroup group;
+                group.variability = variability;
+                group.begin = p;
+                mAutoConstantGroups.push_back(group);
+            }
+            mAutoConstantGroups.back().end = p + 1;
+        }
+        mAutoConstantPlanDirty = false;
+    }
     //-----------------------------------------------------------------------------
     void GpuProgramParameters::_updateAutoParams(const AutoParamDataSource* source, uint16 mask)
     {
@@ -2404,6 +2462,37 @@ namespace Ogre
         if (!(mask & mCombinedVariability))
             return;
 
+        mActivePassIterationIndex = std::numeric_limits<size_t>::max();
+
+        // Leave out the variabilities whose information did not change since the 
+        // autos were last updated from it; unknown variabilities always count as changed
+        static const GpuParamVariability versioned[3] = { GPV_GLOBAL, GPV_PER_OBJECT, GPV_LIGHTS };
+        uint16 changed = static_cast<uint16>(~(GPV_GLOBAL | GPV_PER_OBJECT | GPV_LIGHTS));
+        uint64 versions[3];
+        for (int v = 0; v < 3; ++v)
+        {
+            versions[v] = source->getVariabilityVersion(versioned[v]);
+            if (versions[v] != mAutoConstantVersions[v])
+                changed |= versioned[v];
+        }
+        if (source->getCurrentPass() != mAutoConstantPass)
+            changed |= GPV_GLOBAL;
+        // Remember what the requested autos are now up to date with
+        for (int v = 0; v < 3; ++v)
+        {
+            if (mask & versioned[v])
+                mAutoConstantVersions[v] = versions[v];
+        }
+        if (mask & GPV_GLOBAL)
+            mAutoConstantPass = source->getCurrentPass();
+
+        mask &= changed;
+        if (!(mask & mCombinedVariability))
+            return;
+
+        if (mAutoConstantPlanDirty)
+            buildAutoConstantPlan();
+
         size_t index;
         size_t numMatrices;
         const Matrix4* pMatrix;
@@ -2414,14 +2503,16 @@ namespace Ogre
         Matrix4 scaleM;
         DualQuaternion dQuat;
 
-        mActivePassIterationIndex = std::numeric_limits<size_t>::max();
-
         // Autoconstant index is not a physical index
-        for (AutoConstantList::const_iterator i = mAutoConstants.begin(); i != mAutoConstants.end(); ++i)
+        for (AutoConstantGroupList::const_iterator g = mAutoConstantGroups.begin(); g != mAutoConstantGroups.end(); ++g)
         {
             // Only update needed slots
-            if (i->variability & mask)
+            if (!(g->variability & mask))
+                continue;
+
+            for (size_t p = g->begin; p != g->end; ++p)
             {
+                const AutoConstantEntry* i = &mAutoConstants[mAutoConstantPlan[p]];
 
                 switch(i->paramType)
                 {
@@ -3278,6 +3369,8 @@ namespace Ogre
     {
         if (index < mAutoConstants.size())
         {
+            // The caller may change the entry
+            markAutoConstantsChanged();
             return &(mAutoConstants[index]);
         }
         else
@@ -3433,6 +3526,7 @@ namespace Ogre
         // mBoolConstants = source.getBoolConstantList();
         mAutoConstants = source.getAutoConstantList();
         mCombinedVariability = source.mCombinedVariability;
+        markAutoConstantsChanged();
         copySharedParamSetUsage(source.mSharedParamSets);
     }
     //---------------------------------------------------------------------
@@ -27,14 +27,74 @@ THE SOFTWARE.
 */
 #include "OgreStableHeaders.h"
 #include "OgreImage.h"
+#include "OgreBlockCompression.h"
 #include "OgreException.h"
 #include "OgreImageCodec.h"
 #include "OgreColourValue.h"
 #include "OgreMath.h"
 #include "OgreImageResampler.h"
 #include "OgreResourceGroupManager.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+#include "Threading/OgreTaskScheduler.h"
 
 namespace Ogre {
+    namespace
+    {
+        /// Number of destination pixels worth filtering in a task of their own
+        const size_t RESAMPLE_GRAIN_PIXELS = 16384;
+
+        typedef void (*ResampleFunction)(const PixelBox& src, const PixelBox& dst,
+            size_t rowBegin, size_t rowEnd);
+
+        /// Scheduler of the Root's work queue, if any
+        TaskScheduler* getDefaultScheduler()
+        {
+            Root* root = Root::getSingletonPtr();
+            WorkQueue* queue = root ? root->getWorkQueue() : 0;
+            return queue ? queue->getTaskScheduler() : 0;
+        }
+
+        /** Filters the destination rows of several faces at once, indices
+            running over the rows of every face in turn.
+        */
+        struct ResampleRows
+        {
+            ResampleFunction function;
+            const PixelBox* src;
+            const PixelBox* dst;
+            size_t rowsPerFace;
+
+            void operator()(size_t begin, size_t end) const
+            {
+                while (begin < end)
+                {
+                    size_t face = begin / rowsPerFace;
+                    size_t faceEnd = std::min((face + 1) * rowsPerFace, end);
+                    function(src[face], dst[face], begin - face * rowsPerFace,
+                        faceEnd - face * rowsPerFace);
+                    begin = faceEnd;
+                }
+            }
+        };
+
+        void resampleRows(ResampleFunction function, const PixelBox* src, const PixelBox* dst,
+            size_t numFaces, TaskScheduler* scheduler)
+        {
+            ResampleRows rows = { function, src, dst, dst[0].getHeight() };
+            const size_t rowPixels = dst[0].getWidth() * dst[0].getDepth();
+            if (!scheduler)
+                scheduler = getDefaultScheduler();
+
+            if (scheduler)
+            {
+                size_t grain = std::max<size_t>(RESAMPLE_GRAIN_PIXELS / rowPixels, 1);
+                scheduler->parallelFor(0, numFaces * rows.rowsPerFace, grain, rows);
+            }
+            else
+                rows(0, numFaces * rows.rowsPerFace);
+        }
+    }
     ImageCodec::~ImageCodec() {
     }
 
@@ -556,7 +616,7 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------------
-    void Image::resize(ushort width, ushort height, Filter filter)
+    void Image::resize(ushort width, ushort height, Filter filter, TaskScheduler* scheduler)
     {
         // resizing dynamic images is not supported
         assert(mAutoDelete);
@@ -575,10 +635,11 @@ namespace Ogre {
         mNumMipmaps = 0; // Loses precomputed mipmaps
 
         // scale the image from temp into our resized buffer
-        Image::scale(temp.getPixelBox(), getPixelBox(), filter);
+        Image::scale(temp.getPixelBox(), getPixelBox(), filter, scheduler);
     }
     //-----------------------------------------------------------------------
-    void Image::scale(const PixelBox &src, const PixelBox &scaled, Filter filter) 
+    void Image::scale(const PixelBox &src, const PixelBox &scaled, Filter filter,
+        TaskScheduler* scheduler)
     {
         assert(PixelUtil::isAccessible(src.format));
         assert(PixelUtil::isAccessible(scaled.format));
@@ -603,14 +664,14 @@ namespace Ogre {
             // super-optimized: no conversion
             switch (PixelUtil::getNumElemBytes(src.format)) 
             {
-            case 1: NearestResampler<1>::scale(src, temp); break;
-            case 2: NearestResampler<2>::scale(src, temp); break;
-            case 3: NearestResampler<3>::scale(src, temp); break;
-            case 4: NearestResampler<4>::scale(src, temp); break;
-            case 6: NearestResampler<6>::scale(src, temp); break;
-            case 8: NearestResampler<8>::scale(src, temp); break;
-            case 12: NearestResampler<12>::scale(src, temp); break;
-            case 16: NearestResampler<16>::scale(src, temp); break;
+            case 1: resampleRows(NearestResampler<1>::scale, &src, &temp, 1, scheduler); break;
+            case 2: resampleRows(NearestResampler<2>::scale, &src, &temp, 1, scheduler); break;
+            case 3: resampleRows(NearestResampler<3>::scale, &src, &temp, 1, scheduler); break;
+            case 4: resampleRows(NearestResampler<4>::scale, &src, &temp, 1, scheduler); break;
+            case 6: resampleRows(NearestResampler<6>::scale, &src, &temp, 1, scheduler); break;
+            case 8: resampleRows(NearestResampler<8>::scale, &src, &temp, 1, scheduler); break;
+            case 12: resampleRows(NearestResampler<12>::scale, &src, &temp, 1, scheduler); break;
+            case 16: resampleRows(NearestResampler<16>::scale, &src, &temp, 1, scheduler); break;
             default:
                 // never reached
                 assert(false);
@@ -646,10 +707,10 @@ namespace Ogre {
                 // super-optimized: byte-oriented math, no conversion
                 switch (PixelUtil::getNumElemBytes(src.format)) 
                 {
-                case 1: LinearResampler_Byte<1>::scale(src, temp); break;
-                case 2: LinearResampler_Byte<2>::scale(src, temp); break;
-                case 3: LinearResampler_Byte<3>::scale(src, temp); break;
-                case 4: LinearResampler_Byte<4>::scale(src, temp); break;
+                case 1: resampleRows(LinearResampler_Byte<1>::scale, &src, &temp, 1, scheduler); break;
+                case 2: resampleRows(LinearResampler_Byte<2>::scale, &src, &temp, 1, scheduler); break;
+                case 3: resampleRows(LinearResampler_Byte<3>::scale, &src, &temp, 1, scheduler); break;
+                case 4: resampleRows(LinearResampler_Byte<4>::scale, &src, &temp, 1, scheduler); break;
                 default:
                     // never reached
                     assert(false);
@@ -665,18 +726,141 @@ namespace Ogre {
                 if (scaled.format == PF_FLOAT32_RGB || scaled.format == PF_FLOAT32_RGBA)
                 {
                     // float32 to float32, avoid unpack/repack overhead
-                    LinearResampler_Float32::scale(src, scaled);
+                    resampleRows(LinearResampler_Float32::scale, &src, &scaled, 1, scheduler);
                     break;
                 }
                 // else, fall through
             default:
                 // non-optimized: floating-point math, performs conversion but always works
-                LinearResampler::scale(src, scaled);
+                resampleRows(LinearResampler::scale, &src, &scaled, 1, scheduler);
             }
             break;
         }
     }
 
+    //-----------------------------------------------------------------------
+    void Image::generateMipmaps(Filter filter, TaskScheduler* scheduler)
+    {
+        if (!PixelUtil::isAccessible(mFormat))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Mipmaps can only be generated for uncompressed images",
+                "Image::generateMipmaps");
+        }
+
+        size_t numMips = 0;
+        for (uint32 size = std::max(std::max(mWidth, mHeight), mDepth); size > 1; size /= 2)
+            ++numMips;
+        const size_t numFaces = getNumFaces();
+
+        // Faces are stored one after another, each followed by its mipmaps
+        size_t newSize = calculateSize(numMips, numFaces, mWidth, mHeight, mDepth, mFormat);
+        uchar* newBuffer = OGRE_ALLOC_T(uchar, newSize, MEMCATEGORY_GENERAL);
+        size_t topSize = PixelUtil::getMemorySize(mWidth, mHeight, mDepth, mFormat);
+        for (size_t face = 0; face < numFaces; ++face)
+            memcpy(newBuffer + face * (newSize / numFaces), getPixelBox(face, 0).data, topSize);
+
+        freeMemory();
+        mBuffer = newBuffer;
+        mBufSize = newSize;
+        mNumMipmaps = static_cast<uint8>(numMips);
+        mAutoDelete = true;
+
+        ResampleFunction function = 0;
+        if (filter == FILTER_KAISER)
+            function = KaiserDownsampler::downsample;
+        else if (filter == FILTER_BOX)
+        {
+            switch (mFormat)
+            {
+            case PF_L8: case PF_A8: case PF_BYTE_LA:
+            case PF_R8G8B8: case PF_B8G8R8:
+            case PF_R8G8B8A8: case PF_B8G8R8A8:
+            case PF_A8B8G8R8: case PF_A8R8G8B8:
+            case PF_X8B8G8R8: case PF_X8R8G8B8:
+                switch (PixelUtil::getNumElemBytes(mFormat))
+                {
+                case 1: function = BoxDownsampler_Byte<1>::downsample; break;
+                case 2: function = BoxDownsampler_Byte<2>::downsample; break;
+                case 3: function = BoxDownsampler_Byte<3>::downsample; break;
+                case 4: function = BoxDownsampler_Byte<4>::downsample; break;
+                }
+                break;
+            default:
+                function = BoxDownsampler::downsample;
+            }
+        }
+
+        if (!scheduler)
+            scheduler = getDefaultScheduler();
+
+        vector<PixelBox>::type src(numFaces), dst(numFaces);
+        for (size_t mip = 1; mip <= numMips; ++mip)
+        {
+            for (size_t face = 0; face < numFaces; ++face)
+            {
+                src[face] = getPixelBox(face, mip - 1);
+                dst[face] = getPixelBox(face, mip);
+            }
+
+            if (function)
+                resampleRows(function, &src[0], &dst[0], numFaces, scheduler);
+            else
+            {
+                for (size_t face = 0; face < numFaces; ++face)
+                    Image::scale(src[face], dst[face], filter, scheduler);
+            }
+        }
+    }
+
+    //-----------------------------------------------------------------------------
+
+    Image& Image::compress(PixelFormat format, TaskScheduler* scheduler)
+    {
+        if (!PixelUtil::isAccessible(mFormat) || !BlockCompression::canCompress(format))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Can't compress from " + PixelUtil::getFormatName(mFormat) +
+                " to " + PixelUtil::getFormatName(format),
+                "Image::compress");
+        }
+
+        const size_t numFaces = getNumFaces();
+        size_t newSize = calculateSize(mNumMipmaps, numFaces, mWidth, mHeight, mDepth, format);
+        uchar* newBuffer = OGRE_ALLOC_T(uchar, newSize, MEMCATEGORY_GENERAL);
+
+        // Faces are stored one after another, each followed by its mipmaps
+        uchar* dst = newBuffer;
+        try
+        {
+            for (size_t face = 0; face < numFaces; ++face)
+            {
+                for (size_t mip = 0; mip <= mNumMipmaps; ++mip)
+                {
+                    PixelBox src = getPixelBox(face, mip);
+                    BlockCompression::compress(src,
+                        PixelBox(src.getWidth(), src.getHeight(), src.getDepth(), format, dst), scheduler);
+                    dst += PixelUtil::getMemorySize(src.getWidth(), src.getHeight(), src.getDepth(), format);
+                }
+            }
+        }
+        catch (...)
+        {
+            // The image is left as it was
+            OGRE_FREE(newBuffer, MEMCATEGORY_GENERAL);
+            throw;
+        }
+
+        freeMemory();
+        mBuffer = newBuffer;
+        mBufSize = newSize;
+        mFormat = format;
+        mPixelSize = static_cast<uchar>(PixelUtil::getNumElemBytes(mFormat));
+        mFlags |= IF_COMPRESSED;
+        mAutoDelete = true;
+        return *this;
+    }
+
     //-----------------------------------------------------------------------------    
 
     ColourValue Image::getColourAt(size_t x, size_t y, size_t z) const
@@ -30,6 +30,13 @@ THE SOFTWARE.
 
 #include <algorithm>
 
+#if __OGRE_HAVE_SSE && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#   include <emmintrin.h>
+#   define OGRE_RESAMPLER_SSE2 1
+#else
+#   define OGRE_RESAMPLER_SSE2 0
+#endif
+
 // this file is inlined into OgreImage.cpp!
 // do not include anywhere else.
 namespace Ogre {
@@ -47,17 +54,21 @@ namespace Ogre {
 // sx2 = upper-bound integer x-position in source
 // sxf = fractional weight between sx1 and sx2
 // x,y,z = location of output pixel in destination
+//
+// every resampler only writes destination rows [rowBegin, rowEnd) of each
+// slice, relative to dst.top, so that a destination can be split into bands
+// which are resampled on several threads
 
 // nearest-neighbor resampler, does not convert formats.
 // templated on bytes-per-pixel to allow compiler optimizations, such
 // as simplifying memcpy() and replacing multiplies with bitshifts
 template<unsigned int elemsize> struct NearestResampler {
-    static void scale(const PixelBox& src, const PixelBox& dst) {
+    static void scale(const PixelBox& src, const PixelBox& dst, size_t rowBegin, size_t rowEnd) {
         // assert(src.format == dst.format);
 
         // srcdata stays at beginning, pdst is a moving pointer
         uchar* srcdata = (uchar*)src.getTopLeftFrontPixelPtr();
-        uchar* pdst = (uchar*)dst.getTopLeftFrontPixelPtr();
+        uchar* dstdata = (uchar*)dst.getTopLeftFrontPixelPtr();
 
         // sx_48,sy_48,sz_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
@@ -68,12 +79,13 @@ template<unsigned int elemsize> struct NearestResampler {
         // note: ((stepz>>1) - 1) is an extra half-step increment to adjust
         // for the center of the destination pixel, not the top-left corner
         uint64 sz_48 = (stepz >> 1) - 1;
-        for (size_t z = dst.front; z < dst.back; z++, sz_48 += stepz) {
+        for (size_t z = 0; z < dst.getDepth(); z++, sz_48 += stepz) {
             size_t srczoff = (size_t)(sz_48 >> 48) * src.slicePitch;
             
-            uint64 sy_48 = (stepy >> 1) - 1;
-            for (size_t y = dst.top; y < dst.bottom; y++, sy_48 += stepy) {
+            uint64 sy_48 = (stepy >> 1) - 1 + rowBegin * stepy;
+            for (size_t y = rowBegin; y < rowEnd; y++, sy_48 += stepy) {
                 size_t srcyoff = (size_t)(sy_48 >> 48) * src.rowPitch;
+                uchar* pdst = dstdata + elemsize*(z*dst.slicePitch + y*dst.rowPitch);
             
                 uint64 sx_48 = (stepx >> 1) - 1;
                 for (size_t x = dst.left; x < dst.right; x++, sx_48 += stepx) {
@@ -82,9 +94,7 @@ template<unsigned int elemsize> struct NearestResampler {
                     memcpy(pdst, psrc, elemsize);
                     pdst += elemsize;
                 }
-                pdst += elemsize*dst.getRowSkip();
             }
-            pdst += elemsize*dst.getSliceSkip();
         }
     }
 };
@@ -92,13 +102,13 @@ template<unsigned int elemsize> struct NearestResampler {
 
 // default floating-point linear resampler, does format conversion
 struct LinearResampler {
-    static void scale(const PixelBox& src, const PixelBox& dst) {
+    static void scale(const PixelBox& src, const PixelBox& dst, size_t rowBegin, size_t rowEnd) {
         size_t srcelemsize = PixelUtil::getNumElemBytes(src.format);
         size_t dstelemsize = PixelUtil::getNumElemBytes(dst.format);
 
         // srcdata stays at beginning, pdst is a moving pointer
         uchar* srcdata = (uchar*)src.getTopLeftFrontPixelPtr();
-        uchar* pdst = (uchar*)dst.getTopLeftFrontPixelPtr();
+        uchar* dstdata = (uchar*)dst.getTopLeftFrontPixelPtr();
         
         // sx_48,sy_48,sz_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
@@ -109,7 +119,7 @@ struct LinearResampler {
         // note: ((stepz>>1) - 1) is an extra half-step increment to adjust
         // for the center of the destination pixel, not the top-left corner
         uint64 sz_48 = (stepz >> 1) - 1;
-        for (size_t z = dst.front; z < dst.back; z++, sz_48+=stepz) {
+        for (size_t z = 0; z < dst.getDepth(); z++, sz_48+=stepz) {
             // temp is 16/16 bit fixed precision, used to adjust a source
             // coordinate (x, y, or z) backwards by half a pixel so that the
             // integer bits represent the first sample (eg, sx1) and the
@@ -121,13 +131,14 @@ struct LinearResampler {
             uint32 sz2 = std::min(sz1+1,src.getDepth()-1);// src z, sample #2
             float szf = (temp & 0xFFFF) / 65536.f; // weight of sample #2
 
-            uint64 sy_48 = (stepy >> 1) - 1;
-            for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
+            uint64 sy_48 = (stepy >> 1) - 1 + rowBegin * stepy;
+            for (size_t y = rowBegin; y < rowEnd; y++, sy_48+=stepy) {
                 temp = static_cast<unsigned int>(sy_48 >> 32);
                 temp = (temp > 0x8000)? temp - 0x8000 : 0;
                 uint32 sy1 = temp >> 16;                    // src y #1
                 uint32 sy2 = std::min(sy1+1,src.getHeight()-1);// src y #2
                 float syf = (temp & 0xFFFF) / 65536.f; // weight of #2
+                uchar* pdst = dstdata + dstelemsize*(z*dst.slicePitch + y*dst.rowPitch);
                 
                 uint64 sx_48 = (stepx >> 1) - 1;
                 for (size_t x = dst.left; x < dst.right; x++, sx_48+=stepx) {
@@ -163,9 +174,7 @@ struct LinearResampler {
 
                     pdst += dstelemsize;
                 }
-                pdst += dstelemsize*dst.getRowSkip();
             }
-            pdst += dstelemsize*dst.getSliceSkip();
         }
     }
 };
@@ -174,7 +183,7 @@ struct LinearResampler {
 // float32 linear resampler, converts FLOAT32_RGB/FLOAT32_RGBA only.
 // avoids overhead of pixel unpack/repack function calls
 struct LinearResampler_Float32 {
-    static void scale(const PixelBox& src, const PixelBox& dst) {
+    static void scale(const PixelBox& src, const PixelBox& dst, size_t rowBegin, size_t rowEnd) {
         size_t srcchannels = PixelUtil::getNumElemBytes(src.format) / sizeof(float);
         size_t dstchannels = PixelUtil::getNumElemBytes(dst.format) / sizeof(float);
         // assert(srcchannels == 3 || srcchannels == 4);
@@ -182,7 +191,7 @@ struct LinearResampler_Float32 {
 
         // srcdata stays at beginning, pdst is a moving pointer
         float* srcdata = (float*)src.getTopLeftFrontPixelPtr();
-        float* pdst = (float*)dst.getTopLeftFrontPixelPtr();
+        float* dstdata = (float*)dst.getTopLeftFrontPixelPtr();
         
         // sx_48,sy_48,sz_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
@@ -193,7 +202,7 @@ struct LinearResampler_Float32 {
         // note: ((stepz>>1) - 1) is an extra half-step increment to adjust
         // for the center of the destination pixel, not the top-left corner
         uint64 sz_48 = (stepz >> 1) - 1;
-        for (size_t z = dst.front; z < dst.back; z++, sz_48+=stepz) {
+        for (size_t z = 0; z < dst.getDepth(); z++, sz_48+=stepz) {
             // temp is 16/16 bit fixed precision, used to adjust a source
             // coordinate (x, y, or z) backwards by half a pixel so that the
             // integer bits represent the first sample (eg, sx1) and the
@@ -205,13 +214,14 @@ struct LinearResampler_Float32 {
             uint32 sz2 = std::min(sz1+1,src.getDepth()-1);// src z, sample #2
             float szf = (temp & 0xFFFF) / 65536.f; // weight of sample #2
 
-            uint64 sy_48 = (stepy >> 1) - 1;
-            for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
+            uint64 sy_48 = (stepy >> 1) - 1 + rowBegin * stepy;
+            for (size_t y = rowBegin; y < rowEnd; y++, sy_48+=stepy) {
                 temp = static_cast<unsigned int>(sy_48 >> 32);
                 temp = (temp > 0x8000)? temp - 0x8000 : 0;
                 uint32 sy1 = temp >> 16;                    // src y #1
                 uint32 sy2 = std::min(sy1+1,src.getHeight()-1);// src y #2
                 float syf = (temp & 0xFFFF) / 65536.f; // weight of #2
+                float* pdst = dstdata + dstchannels*(z*dst.slicePitch + y*dst.rowPitch);
                 
                 uint64 sx_48 = (stepx >> 1) - 1;
                 for (size_t x = dst.left; x < dst.right; x++, sx_48+=stepx) {
@@ -266,9 +276,7 @@ struct LinearResampler_Float32 {
 
                     pdst += dstchannels;
                 }
-                pdst += dstchannels*dst.getRowSkip();
             }
-            pdst += dstchannels*dst.getSliceSkip();
         }
     }
 };
@@ -281,26 +289,26 @@ struct LinearResampler_Float32 {
 // templated on bytes-per-pixel to allow compiler optimizations, such
 // as unrolling loops and replacing multiplies with bitshifts
 template<unsigned int channels> struct LinearResampler_Byte {
-    static void scale(const PixelBox& src, const PixelBox& dst) {
+    static void scale(const PixelBox& src, const PixelBox& dst, size_t rowBegin, size_t rowEnd) {
         // assert(src.format == dst.format);
 
         // only optimized for 2D
         if (src.getDepth() > 1 || dst.getDepth() > 1) {
-            LinearResampler::scale(src, dst);
+            LinearResampler::scale(src, dst, rowBegin, rowEnd);
             return;
         }
 
         // srcdata stays at beginning of slice, pdst is a moving pointer
         uchar* srcdata = (uchar*)src.getTopLeftFrontPixelPtr();
-        uchar* pdst = (uchar*)dst.getTopLeftFrontPixelPtr();
+        uchar* dstdata = (uchar*)dst.getTopLeftFrontPixelPtr();
 
         // sx_48,sy_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
         uint64 stepx = ((uint64)src.getWidth() << 48) / dst.getWidth();
         uint64 stepy = ((uint64)src.getHeight() << 48) / dst.getHeight();
         
-        uint64 sy_48 = (stepy >> 1) - 1;
-        for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
+        uint64 sy_48 = (stepy >> 1) - 1 + rowBegin * stepy;
+        for (size_t y = rowBegin; y < rowEnd; y++, sy_48+=stepy) {
             // bottom 28 bits of temp are 16/12 bit fixed precision, used to
             // adjust a source coordinate backwards by half a pixel so that the
             // integer bits represent the first sample (eg, sx1) and the
@@ -312,6 +320,15 @@ template<unsigned int channels> struct LinearResampler_Byte {
             uint32 sy2 = std::min(sy1+1, src.bottom-src.top-1);
             size_t syoff1 = sy1 * src.rowPitch;
             size_t syoff2 = sy2 * src.rowPitch;
+            uchar* pdst = dstdata + channels*y*dst.rowPitch;
+
+#if OGRE_RESAMPLER_SSE2
+            if (channels == 4) {
+                scaleRowSSE2(srcdata + syoff1*4, srcdata + syoff2*4, pdst,
+                    src.right-src.left, dst.getWidth(), stepx, syf);
+                continue;
+            }
+#endif
 
             uint64 sx_48 = (stepx >> 1) - 1;
             for (size_t x = dst.left; x < dst.right; x++, sx_48+=stepx) {
@@ -333,9 +350,297 @@ template<unsigned int channels> struct LinearResampler_Byte {
                     *pdst++ = static_cast<uchar>((accum + 0x800000) >> 24);
                 }
             }
-            pdst += channels*dst.getRowSkip();
         }
     }
+
+#if OGRE_RESAMPLER_SSE2
+    // one destination row of 4 channel pixels, with the same 8/24-bit fixed
+    // point math and so the same result as the generic loop: the weights
+    // factor into x and y weights of 12 bits, so each source row is blended
+    // exactly in 32 bits by pmaddwd and both rows in 64 bits by pmuludq
+    static void scaleRowSSE2(const uchar* srcrow1, const uchar* srcrow2, uchar* pdst,
+        size_t srcwidth, size_t dstwidth, uint64 stepx, unsigned int syf) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i wy1 = _mm_set1_epi32(static_cast<int>(0x1000 - syf));
+        const __m128i wy2 = _mm_set1_epi32(static_cast<int>(syf));
+        const __m128i round = _mm_set_epi32(0, 0x800000, 0, 0x800000);
+
+        uint64 sx_48 = (stepx >> 1) - 1;
+        for (size_t x = 0; x < dstwidth; x++, sx_48+=stepx) {
+            unsigned int temp = static_cast<unsigned int>(sx_48 >> 36);
+            temp = (temp > 0x800)? temp - 0x800 : 0;
+            unsigned int sxf = temp & 0xFFF;
+            uint32 sx1 = temp >> 12;
+            uint32 sx2 = std::min<uint32>(sx1+1, static_cast<uint32>(srcwidth-1));
+
+            int p11, p21, p12, p22;
+            memcpy(&p11, srcrow1 + sx1*4, 4); memcpy(&p21, srcrow1 + sx2*4, 4);
+            memcpy(&p12, srcrow2 + sx1*4, 4); memcpy(&p22, srcrow2 + sx2*4, 4);
+
+            // (0x1000 - sxf, sxf) pairs against interleaved samples
+            const __m128i wx = _mm_set1_epi32(static_cast<int>(((sxf << 16) | (0x1000 - sxf))));
+            __m128i h1 = _mm_madd_epi16(_mm_unpacklo_epi8(
+                _mm_unpacklo_epi8(_mm_cvtsi32_si128(p11), _mm_cvtsi32_si128(p21)), zero), wx);
+            __m128i h2 = _mm_madd_epi16(_mm_unpacklo_epi8(
+                _mm_unpacklo_epi8(_mm_cvtsi32_si128(p12), _mm_cvtsi32_si128(p22)), zero), wx);
+
+            // channels 0 and 2, then 1 and 3
+            __m128i even = _mm_add_epi64(_mm_add_epi64(_mm_mul_epu32(h1, wy1),
+                _mm_mul_epu32(h2, wy2)), round);
+            __m128i odd = _mm_add_epi64(_mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(h1, 32), wy1),
+                _mm_mul_epu32(_mm_srli_epi64(h2, 32), wy2)), round);
+            __m128i accum = _mm_or_si128(_mm_srli_epi64(even, 24),
+                _mm_slli_epi64(_mm_srli_epi64(odd, 24), 32));
+
+            accum = _mm_packus_epi16(_mm_packs_epi32(accum, zero), zero);
+            int result = _mm_cvtsi128_si32(accum);
+            memcpy(pdst, &result, 4);
+            pdst += 4;
+        }
+    }
+#endif
+};
+
+// mipmap downsamplers: halve every dimension of the source larger than 1,
+// so that dst is max(1, size / 2) in each dimension. odd sizes leave out the
+// last column, row or slice of the source.
+
+// box filter, averages 2x2 (2x2x2 for volumes) blocks. does not convert
+// formats; only handles pixel formats that use 1 byte per color channel.
+template<unsigned int channels> struct BoxDownsampler_Byte {
+    static void downsample(const PixelBox& src, const PixelBox& dst, size_t rowBegin, size_t rowEnd) {
+        // assert(src.format == dst.format);
+        uchar* srcdata = (uchar*)src.getTopLeftFrontPixelPtr();
+        uchar* dstdata = (uchar*)dst.getTopLeftFrontPixelPtr();
+
+        // offsets of the second sample along each axis, none when not halved
+        size_t stepx = src.getWidth() > 1 ? channels : 0;
+        size_t stepy = src.getHeight() > 1 ? channels*src.rowPitch : 0;
+        size_t stepz = src.getDepth() > 1 ? channels*src.slicePitch : 0;
+        size_t dstwidth = dst.getWidth();
+
+        for (size_t z = 0; z < dst.getDepth(); z++) {
+            for (size_t y = rowBegin; y < rowEnd; y++) {
+                uchar* psrc = srcdata + channels*((stepz ? 2*z : 0)*src.slicePitch +
+                    (stepy ? 2*y : 0)*src.rowPitch);
+                uchar* pdst = dstdata + channels*(z*dst.slicePitch + y*dst.rowPitch);
+                size_t x = 0;
+
+                if (stepz) {
+                    for (; x < dstwidth; x++, psrc += 2*stepx, pdst += channels) {
+                        for (unsigned int k = 0; k < channels; k++) {
+                            unsigned int accum =
+                                psrc[k] + psrc[stepx+k] + psrc[stepy+k] + psrc[stepx+stepy+k] +
+                                psrc[stepz+k] + psrc[stepz+stepx+k] + psrc[stepz+stepy+k] + psrc[stepz+stepx+stepy+k];
+                            pdst[k] = static_cast<uchar>((accum + 4) >> 3);
+                        }
+                    }
+                    continue;
+                }
+
+#if OGRE_RESAMPLER_SSE2
+                if (channels == 4 && stepx) {
+                    // 4 source pixels of both rows make 2 destination pixels
+                    const __m128i zero = _mm_setzero_si128();
+                    const __m128i two = _mm_set1_epi16(2);
+                    for (; x + 2 <= dstwidth; x += 2, psrc += 16, pdst += 8) {
+                        __m128i row1 = _mm_loadu_si128((const __m128i*)psrc);
+                        __m128i row2 = _mm_loadu_si128((const __m128i*)(psrc + stepy));
+                        __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(row1, zero), _mm_unpacklo_epi8(row2, zero));
+                        __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(row1, zero), _mm_unpackhi_epi8(row2, zero));
+                        lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+                        hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+                        __m128i accum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), two), 2);
+                        _mm_storel_epi64((__m128i*)pdst, _mm_packus_epi16(accum, zero));
+                    }
+                }
+#endif
+
+                for (; x < dstwidth; x++, psrc += 2*stepx, pdst += channels) {
+                    for (unsigned int k = 0; k < channels; k++) {
+                        unsigned int accum =
+                            psrc[k] + psrc[stepx+k] + psrc[stepy+k] + psrc[stepx+stepy+k];
+                        pdst[k] = static_cast<uchar>((accum + 2) >> 2);
+                    }
+                }
+            }
+        }
+    }
+};
+
+
+// rows of pixels converted to FLOAT32_RGBA, for the filters which
+// handle every format
+struct FloatRows {
+    vector<float>::type data;
+    size_t width;
+
+    void resize(size_t numRows, size_t rowWidth) {
+        width = rowWidth;
+        data.resize(numRows * width * 4);
+    }
+    float* row(size_t i) { return &data[i * width * 4]; }
+
+    // unpacks a row of src into row i
+    void unpack(size_t i, const PixelBox& src, size_t y, size_t z) {
+        PixelBox srcrow(src.getWidth(), 1, 1, src.format,
+            (uchar*)src.getTopLeftFrontPixelPtr() +
+            PixelUtil::getNumElemBytes(src.format)*(y*src.rowPitch + z*src.slicePitch));
+        PixelUtil::bulkPixelConversion(srcrow, PixelBox(src.getWidth(), 1, 1, PF_FLOAT32_RGBA, row(i)));
+    }
+    // packs row i into a row of dst
+    void pack(size_t i, const PixelBox& dst, size_t y, size_t z) {
+        float* prow = row(i);
+        if (!PixelUtil::isFloatingPoint(dst.format)) {
+            // filters with negative lobes overshoot
+            for (size_t k = 0; k < width * 4; k++)
+                prow[k] = Math::saturate(prow[k]);
+        }
+        PixelBox dstrow(dst.getWidth(), 1, 1, dst.format,
+            (uchar*)dst.getTopLeftFrontPixelPtr() +
+            PixelUtil::getNumElemBytes(dst.format)*(y*dst.rowPitch + z*dst.slicePitch));
+        PixelUtil::bulkPixelConversion(PixelBox(dst.getWidth(), 1, 1, PF_FLOAT32_RGBA, prow), dstrow);
+    }
+};
+
+
+// box filter for every format, through floating point rows
+struct BoxDownsampler {
+    static void downsample(const PixelBox& src, const PixelBox& dst, size_t rowBegin, size_t rowEnd) {
+        bool halvex = src.getWidth() > 1, halvey = src.getHeight() > 1, halvez = src.getDepth() > 1;
+        size_t numSlices = halvez ? 2 : 1, numRows = halvey ? 2 : 1;
+        size_t dstwidth = dst.getWidth();
+        float scale = 1.0f / (numSlices * numRows * (halvex ? 2 : 1));
+
+        FloatRows rows;
+        rows.resize(numSlices * numRows + 1, src.getWidth());
+        float* accum = rows.row(numSlices * numRows);
+
+        for (size_t z = 0; z < dst.getDepth(); z++) {
+            for (size_t y = rowBegin; y < rowEnd; y++) {
+                for (size_t sz = 0; sz < numSlices; sz++)
+                    for (size_t sy = 0; sy < numRows; sy++)
+                        rows.unpack(sz*numRows + sy, src,
+                            (halvey ? 2*y : 0) + sy, (halvez ? 2*z : 0) + sz);
+
+                for (size_t x = 0; x < dstwidth; x++) {
+                    size_t sx1 = (halvex ? 2*x : x) * 4, sx2 = (halvex ? 2*x+1 : x) * 4;
+                    for (size_t k = 0; k < 4; k++) {
+                        float sum = 0;
+                        for (size_t r = 0; r < numSlices * numRows; r++)
+                            sum += rows.row(r)[sx1+k] + (halvex ? rows.row(r)[sx2+k] : 0);
+                        accum[x*4+k] = sum * scale;
+                    }
+                }
+                rows.pack(numSlices * numRows, dst, y, z);
+            }
+        }
+    }
+};
+
+
+// Kaiser windowed sinc filter for 2D images, sharper than the box filter.
+// 12 taps along each halved axis, separable. volumes use the box filter.
+struct KaiserDownsampler {
+    enum { RADIUS = 6, TAPS = 2 * RADIUS };
+
+    static void computeWeights(float* weights) {
+        // source pixel k - RADIUS + 1 relative to the first of the two source
+        // pixels under the destination pixel; its center is (k - RADIUS + 0.5)
+        // source pixels, half as many destination pixels, away
+        const float alpha = 4.0f;
+        const float width = RADIUS / 2.0f;
+        float sum = 0;
+        for (int k = 0; k < TAPS; k++) {
+            float t = (k - RADIUS + 0.5f) / 2.0f;
+            float sinc = Math::Sin(Math::PI * t) / (Math::PI * t);
+            float w = 1.0f - (t / width) * (t / width);
+            weights[k] = sinc * besselI0(alpha * Math::Sqrt(std::max(w, 0.0f))) / besselI0(alpha);
+            sum += weights[k];
+        }
+        for (int k = 0; k < TAPS; k++)
+            weights[k] /= sum;
+    }
+
+    // modified Bessel function of the first kind, order 0
+    static float besselI0(float x) {
+        float sum = 1.0f, term = 1.0f, halfx = x / 2.0f;
+        for (int i = 1; i < 32 && term > sum * 1e-8f; i++) {
+            term *= (halfx / i) * (halfx / i);
+            sum += term;
+        }
+        return sum;
+    }
+
+    static void downsample(const PixelBox& src, const PixelBox& dst, size_t rowBegin, size_t rowEnd) {
+        if (src.getDepth() > 1 || dst.getDepth() > 1) {
+            BoxDownsampler::downsample(src, dst, rowBegin, rowEnd);
+            return;
+        }
+
+        float weights[TAPS];
+        computeWeights(weights);
+
+        bool halvex = src.getWidth() > 1, halvey = src.getHeight() > 1;
+        size_t srcwidth = src.getWidth(), srcheight = src.getHeight();
+        size_t dstwidth = dst.getWidth();
+
+        // the source rows under the band, filtered horizontally
+        size_t firstRow = halvey ? std::max<ptrdiff_t>(2*(ptrdiff_t)rowBegin - RADIUS + 1, 0) : 0;
+        size_t lastRow = halvey ? std::min<size_t>(2*(rowEnd-1) + RADIUS, srcheight - 1) : 0;
+        FloatRows srcrow, filtered;
+        srcrow.resize(2, srcwidth);
+        filtered.resize(lastRow - firstRow + 1, dstwidth);
+        for (size_t sy = firstRow; sy <= lastRow; sy++) {
+            srcrow.unpack(0, src, sy, 0);
+            const float* psrc = srcrow.row(0);
+            float* pfiltered = filtered.row(sy - firstRow);
+            for (size_t x = 0; x < dstwidth; x++) {
+                if (halvex)
+                    filterPixel(psrc, 2*(ptrdiff_t)x - RADIUS + 1, 4, srcwidth, weights, pfiltered + x*4);
+                else
+                    memcpy(pfiltered + x*4, psrc + x*4, sizeof(float)*4);
+            }
+        }
+
+        // vertically, from the filtered rows
+        float* accum = srcrow.row(1);
+        for (size_t y = rowBegin; y < rowEnd; y++) {
+            if (halvey) {
+                for (size_t x = 0; x < dstwidth; x++) {
+                    filterPixel(filtered.row(0) + x*4,
+                        2*(ptrdiff_t)y - RADIUS + 1 - (ptrdiff_t)firstRow, dstwidth*4,
+                        lastRow - firstRow + 1, weights, accum + x*4);
+                }
+                srcrow.pack(1, dst, y, 0);
+            } else {
+                filtered.pack(0, dst, y, 0);
+            }
+        }
+    }
+
+    // one output pixel from TAPS pixels starting at first, which are
+    // stride floats apart and clamped to [0, count)
+    static void filterPixel(const float* pixels, ptrdiff_t first, size_t stride, size_t count,
+        const float* weights, float* out) {
+#if OGRE_RESAMPLER_SSE2
+        __m128 accum = _mm_setzero_ps();
+        for (int k = 0; k < TAPS; k++) {
+            ptrdiff_t i = std::min<ptrdiff_t>(std::max<ptrdiff_t>(first + k, 0), count - 1);
+            accum = _mm_add_ps(accum, _mm_mul_ps(_mm_loadu_ps(pixels + i*stride), _mm_set1_ps(weights[k])));
+        }
+        _mm_storeu_ps(out, accum);
+#else
+        float accum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (int k = 0; k < TAPS; k++) {
+            ptrdiff_t i = std::min<ptrdiff_t>(std::max<ptrdiff_t>(first + k, 0), count - 1);
+            const float* p = pixels + i*stride;
+            accum[0] += p[0]*weights[k]; accum[1] += p[1]*weights[k];
+            accum[2] += p[2]*weights[k]; accum[3] += p[3]*weights[k];
+        }
+        memcpy(out, accum, sizeof(accum));
+#endif
+    }
 };
 /** @} */
 /** @} */
@@ -821,16 +821,25 @@ namespace Ogre {
             dest->vertexCount,
             pMesh->mVertexBufferUsage,
             pMesh->mVertexBufferShadowBuffer);
-        void* pBuf = vbuf->lock(HardwareBuffer::HBL_DISCARD);
-        stream->read(pBuf, dest->vertexCount * vertexSize);
-
-        // endian conversion for OSX
-        flipFromLittleEndian(
-            pBuf,
-            dest->vertexCount,
-            vertexSize,
-            dest->vertexDeclaration->findElementsBySource(bindIndex));
-        vbuf->unlock();
+        const size_t bufferSize = dest->vertexCount * vertexSize;
+        if (const void* pSrc = readInPlace(stream, bufferSize))
+        {
+            // Native vertex data held in memory, upload it directly
+            vbuf->writeData(0, bufferSize, pSrc, true);
+        }
+        else
+        {
+            void* pBuf = vbuf->lock(HardwareBuffer::HBL_DISCARD);
+            stream->read(pBuf, bufferSize);
+
+            // endian conversion for OSX
+            flipFromLittleEndian(
+                pBuf,
+                dest->vertexCount,
+                vertexSize,
+                dest->vertexDeclaration->findElementsBySource(bindIndex));
+            vbuf->unlock();
+        }
 
         // Set binding
         dest->vertexBufferBinding->setBinding(bindIndex, vbuf);
@@ -1025,13 +1034,6 @@ namespace Ogre {
                         sm->indexData->indexCount,
                         pMesh->mIndexBufferUsage,
                         pMesh->mIndexBufferShadowBuffer);
-                // unsigned int* faceVertexIndices
-                unsigned int* pIdx = static_cast<unsigned int*>(
-                    ibuf->lock(HardwareBuffer::HBL_DISCARD)
-                    );
-                readInts(stream, pIdx, sm->indexData->indexCount);
-                ibuf->unlock();
-
             }
             else // 16-bit
             {
@@ -1041,13 +1043,9 @@ namespace Ogre {
                         sm->indexData->indexCount,
                         pMesh->mIndexBufferUsage,
                         pMesh->mIndexBufferShadowBuffer);
-                // unsigned short* faceVertexIndices
-                unsigned short* pIdx = static_cast<unsigned short*>(
-                    ibuf->lock(HardwareBuffer::HBL_DISCARD)
-                    );
-                readShorts(stream, pIdx, sm->indexData->indexCount);
-                ibuf->unlock();
             }
+            // unsigned short*/int* faceVertexIndices
+            readIndexBufferData(stream, ibuf);
         }
         sm->indexData->indexBuffer = ibuf;
 
@@ -1605,19 +1603,9 @@ namespace Ogre {
                 indexData->indexBuffer = HardwareBufferManager::getSingleton().
                     createIndexBuffer(idx32Bit ? HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT,
                     buffIndexCount, pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
-                void* pIdx = static_cast<unsigned int*>(indexData->indexBuffer->lock(
-                    0, indexData->indexBuffer->getSizeInBytes(), HardwareBuffer::HBL_DISCARD));
 
                 // unsigned short*/int* faceIndexes;  ((v1, v2, v3) * numFaces)
-                if (idx32Bit)
-                {
-                    readInts(stream, (uint32*)pIdx, buffIndexCount);
-                }
-                else
-                {
-                    readShorts(stream, (uint16*)pIdx, buffIndexCount);
-                }
-                indexData->indexBuffer->unlock();
+                readIndexBufferData(stream, indexData->indexBuffer);
             }
         }
     }
@@ -2679,14 +2667,42 @@ namespace Ogre {
                 vertexSize, vertexCount,
                 HardwareBuffer::HBU_STATIC, true);
         // float x,y,z          // repeat by number of vertices in original geometry
-        float* pDst = static_cast<float*>(
-            vbuf->lock(HardwareBuffer::HBL_DISCARD));
-        readFloats(stream, pDst, vertexCount * (includesNormals ? 6 : 3));
-        vbuf->unlock();
+        if (const void* pSrc = readInPlace(stream, vbuf->getSizeInBytes()))
+        {
+            vbuf->writeData(0, vbuf->getSizeInBytes(), pSrc, true);
+        }
+        else
+        {
+            float* pDst = static_cast<float*>(
+                vbuf->lock(HardwareBuffer::HBL_DISCARD));
+            readFloats(stream, pDst, vertexCount * (includesNormals ? 6 : 3));
+            vbuf->unlock();
+        }
         kf->setVertexBuffer(vbuf);
 
     }
     //---------------------------------------------------------------------
+    void MeshSerializerImpl::readIndexBufferData(DataStreamPtr& stream,
+        const HardwareIndexBufferSharedPtr& ibuf)
+    {
+        if (const void* pSrc = readInPlace(stream, ibuf->getSizeInBytes()))
+        {
+            ibuf->writeData(0, ibuf->getSizeInBytes(), pSrc, true);
+            return;
+        }
+
+        void* pIdx = ibuf->lock(HardwareBuffer::HBL_DISCARD);
+        if (ibuf->getType() == HardwareIndexBuffer::IT_32BIT)
+        {
+            readInts(stream, static_cast<uint32*>(pIdx), ibuf->getNumIndexes());
+        }
+        else
+        {
+            readShorts(stream, static_cast<uint16*>(pIdx), ibuf->getNumIndexes());
+        }
+        ibuf->unlock();
+    }
+    //---------------------------------------------------------------------
     void MeshSerializerImpl::readPoseKeyFrame(DataStreamPtr& stream, VertexAnimationTrack* track)
     {
         // float time
@@ -3037,29 +3053,14 @@ namespace Ogre {
                     indexData->indexBuffer = HardwareBufferManager::getSingleton().
                         createIndexBuffer(HardwareIndexBuffer::IT_32BIT, indexData->indexCount,
                         pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
-                    unsigned int* pIdx = static_cast<unsigned int*>(
-                        indexData->indexBuffer->lock(
-                        0,
-                        indexData->indexBuffer->getSizeInBytes(),
-                        HardwareBuffer::HBL_DISCARD));
-
-                    readInts(stream, pIdx, indexData->indexCount);
-                    indexData->indexBuffer->unlock();
-
                 }
                 else
                 {
                     indexData->indexBuffer = HardwareBufferManager::getSingleton().
                         createIndexBuffer(HardwareIndexBuffer::IT_16BIT, indexData->indexCount,
                         pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
-                    unsigned short* pIdx = static_cast<unsigned short*>(
-                        indexData->indexBuffer->lock(
-                        0,
-                        indexData->indexBuffer->getSizeInBytes(),
-                        HardwareBuffer::HBL_DISCARD));
-                    readShorts(stream, pIdx, indexData->indexCount);
-                    indexData->indexBuffer->unlock();
                 }
+                readIndexBufferData(stream, indexData->indexBuffer);
             }
         }
         popInnerChunk(stream);
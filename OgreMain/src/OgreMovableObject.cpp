@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "OgreEntity.h"
 #include "OgreRoot.h"
 #include "OgreSceneManager.h"
+#include "OgreSceneQueryBroadphase.h"
 #include "OgreCamera.h"
 #include "OgreLodListener.h"
 #include "OgreTechnique.h"
@@ -66,6 +67,7 @@ namespace Ogre {
         , mListener(0)
         , mLightListUpdated(0)
         , mLightMask(0xFFFFFFFF)
+        , mSceneQueryProxy(SceneQueryBroadphase::NO_PROXY)
     {
         if (Root::getSingletonPtr())
             mMinPixelSize = Root::getSingleton().getDefaultMinPixelSize();
@@ -94,6 +96,7 @@ namespace Ogre {
         , mListener(0)
         , mLightListUpdated(0)
         , mLightMask(0xFFFFFFFF)
+        , mSceneQueryProxy(SceneQueryBroadphase::NO_PROXY)
     {
         if (Root::getSingletonPtr())
             mMinPixelSize = Root::getSingleton().getDefaultMinPixelSize();
@@ -107,6 +110,12 @@ namespace Ogre {
             mListener->objectDestroyed(this);
         }
 
+        // Objects destroyed without their manager must leave its broadphase
+        if (mSceneQueryProxy != SceneQueryBroadphase::NO_PROXY)
+        {
+            mManager->_getSceneQueryBroadphase()->removeObject(this);
+        }
+
         if (mParentNode)
         {
             // detach from parent
@@ -216,6 +225,12 @@ namespace Ogre {
         // counter by one for minimise overhead
         --mLightListUpdated;
 
+        // The bounds used by the scene queries changed
+        if (mSceneQueryProxy != SceneQueryBroadphase::NO_PROXY)
+        {
+            mManager->_getSceneQueryBroadphase()->_notifyObjectMoved(this);
+        }
+
         // Notify listener if exists
         if (mListener)
         {
@@ -0,0 +1,295 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreNodeTransformArray.h"
+#include "OgreNode.h"
+#include "OgreOptimisedUtil.h"
+
+// Number of nodes gathered before running the transform kernel
+#define OGRE_NODE_TRANSFORM_BATCH_SIZE 64
+
+namespace Ogre {
+
+    //-----------------------------------------------------------------------
+    NodeTransformArray::NodeTransformArray()
+    {
+    }
+    //-----------------------------------------------------------------------
+    NodeTransformArray::~NodeTransformArray()
+    {
+        clear();
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformArray::clear(void)
+    {
+        for (LevelList::iterator i = mLevels.begin(); i != mLevels.end(); ++i)
+        {
+            OGRE_FREE_SIMD(i->transforms, MEMCATEGORY_SCENE_CONTROL);
+        }
+        mLevels.clear();
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformArray::rebuild(Node* root)
+    {
+        clear();
+
+        if (!root)
+            return;
+
+        // Breadth first, so the children of a node are contiguous in the
+        // next level and parents are visited in the order they are stored
+        Level level;
+        level.nodes.push_back(root);
+        level.parents.push_back(0);
+        while (!level.nodes.empty())
+        {
+            Level next;
+            for (size_t i = 0; i < level.nodes.size(); ++i)
+            {
+                Node::ChildNodeMap::const_iterator it, itend;
+                itend = level.nodes[i]->mChildren.end();
+                for (it = level.nodes[i]->mChildren.begin(); it != itend; ++it)
+                {
+                    next.nodes.push_back(it->second);
+                    next.parents.push_back(static_cast<uint32>(i));
+                }
+            }
+
+            const size_t numNodes = level.nodes.size();
+            level.states.resize(numNodes, 0);
+            level.stride = (numNodes + 3) & ~size_t(3);
+            level.transforms = static_cast<Real*>(OGRE_MALLOC_SIMD(
+                sizeof(Real) * NUM_TRANSFORM_STREAMS * level.stride, MEMCATEGORY_SCENE_CONTROL));
+            mLevels.push_back(level);
+
+            level.nodes.swap(next.nodes);
+            level.parents.swap(next.parents);
+            level.states.clear();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformArray::updateLevel(size_t levelIndex, size_t begin, size_t end)
+    {
+        Level& level = mLevels[levelIndex];
+        const Level* parentLevel = levelIndex ? &mLevels[levelIndex - 1] : 0;
+
+        uint32 batch[OGRE_NODE_TRANSFORM_BATCH_SIZE];
+        size_t batchSize = 0;
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            Node* node = level.nodes[i];
+
+            // Work out whether Node::_update would reach this node, and with
+            // which value of parentHasChanged
+            bool parentHasChanged = false;
+            if (parentLevel)
+            {
+                const uint32 parentIndex = level.parents[i];
+                const uint8 parentState = parentLevel->states[parentIndex];
+                if (parentState & STATE_UPDATE_ALL_CHILDREN)
+                {
+                    parentHasChanged = true;
+                }
+                else if (!(parentState & STATE_UPDATE_SELECTED_CHILDREN) ||
+                    parentLevel->nodes[parentIndex]->mChildrenToUpdate.count(node) == 0)
+                {
+                    level.states[i] = 0;
+                    continue;
+                }
+            }
+
+            uint8 state = STATE_VISITED;
+            if (node->mNeedChildUpdate || parentHasChanged)
+                state |= STATE_UPDATE_ALL_CHILDREN;
+            else if (!node->mChildrenToUpdate.empty())
+                state |= STATE_UPDATE_SELECTED_CHILDREN;
+
+            if (node->mNeedParentUpdate || parentHasChanged)
+            {
+                state |= STATE_TRANSFORM_UPDATED;
+                batch[batchSize++] = static_cast<uint32>(i);
+                if (batchSize == OGRE_NODE_TRANSFORM_BATCH_SIZE)
+                {
+                    updateTransforms(level, parentLevel, batch, batchSize);
+                    batchSize = 0;
+                }
+            }
+            else
+            {
+                // Up to date, but the derived transform may have been refreshed
+                // on demand since the last update; children read it from here
+                storeTransform(level, i, node);
+            }
+            level.states[i] = state;
+        }
+
+        if (batchSize)
+            updateTransforms(level, parentLevel, batch, batchSize);
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformArray::updateTransforms(Level& level, const Level* parentLevel,
+        const uint32* indices, size_t count)
+    {
+        if (!parentLevel)
+        {
+            // Root node, no parent
+            for (size_t i = 0; i < count; ++i)
+            {
+                Node* node = level.nodes[indices[i]];
+                node->mDerivedOrientation = node->mOrientation;
+                node->mDerivedPosition = node->mPosition;
+                node->mDerivedScale = node->mScale;
+                node->mCachedTransformOutOfDate = true;
+                node->mNeedParentUpdate = false;
+                storeTransform(level, indices[i], node);
+            }
+            return;
+        }
+
+        const size_t batchStride = OGRE_NODE_TRANSFORM_BATCH_SIZE;
+        OGRE_SIMD_ALIGNED_DECL(Real, parentBlock[NUM_TRANSFORM_STREAMS * batchStride]);
+        OGRE_SIMD_ALIGNED_DECL(Real, localBlock[(NUM_TRANSFORM_STREAMS + 2) * batchStride]);
+        OGRE_SIMD_ALIGNED_DECL(Real, derivedBlock[NUM_TRANSFORM_STREAMS * batchStride]);
+
+        // Gather
+        const Real* parentTransforms = parentLevel->transforms;
+        const size_t parentStride = parentLevel->stride;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t index = indices[i];
+            const uint32 parentIndex = level.parents[index];
+            for (size_t s = 0; s < NUM_TRANSFORM_STREAMS; ++s)
+            {
+                parentBlock[s * batchStride + i] = parentTransforms[s * parentStride + parentIndex];
+            }
+
+            const Node* node = level.nodes[index];
+            Real* local = localBlock + i;
+            local[0] = node->mPosition.x;
+            local[batchStride] = node->mPosition.y;
+            local[2 * batchStride] = node->mPosition.z;
+            local[3 * batchStride] = node->mOrientation.w;
+            local[4 * batchStride] = node->mOrientation.x;
+            local[5 * batchStride] = node->mOrientation.y;
+            local[6 * batchStride] = node->mOrientation.z;
+            local[7 * batchStride] = node->mScale.x;
+            local[8 * batchStride] = node->mScale.y;
+            local[9 * batchStride] = node->mScale.z;
+            local[10 * batchStride] = node->mInheritOrientation ? 1 : 0;
+            local[11 * batchStride] = node->mInheritScale ? 1 : 0;
+        }
+        // Zero the unused lanes of a partial batch, the kernel works on whole batches
+        for (size_t i = count; i < batchStride; ++i)
+        {
+            for (size_t s = 0; s < NUM_TRANSFORM_STREAMS; ++s)
+            {
+                parentBlock[s * batchStride + i] = 0;
+            }
+            for (size_t s = 0; s < NUM_TRANSFORM_STREAMS + 2; ++s)
+            {
+                localBlock[s * batchStride + i] = 0;
+            }
+        }
+
+        OptimisedUtil::getImplementation()->concatenateNodeTransforms(
+            parentBlock, localBlock, derivedBlock, batchStride, count);
+
+        // Scatter
+        Real* transforms = level.transforms;
+        const size_t stride = level.stride;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t index = indices[i];
+            for (size_t s = 0; s < NUM_TRANSFORM_STREAMS; ++s)
+            {
+                transforms[s * stride + index] = derivedBlock[s * batchStride + i];
+            }
+
+            Node* node = level.nodes[index];
+            const Real* derived = derivedBlock + i;
+            node->mDerivedPosition.x = derived[0];
+            node->mDerivedPosition.y = derived[batchStride];
+            node->mDerivedPosition.z = derived[2 * batchStride];
+            node->mDerivedOrientation.w = derived[3 * batchStride];
+            node->mDerivedOrientation.x = derived[4 * batchStride];
+            node->mDerivedOrientation.y = derived[5 * batchStride];
+            node->mDerivedOrientation.z = derived[6 * batchStride];
+            node->mDerivedScale.x = derived[7 * batchStride];
+            node->mDerivedScale.y = derived[8 * batchStride];
+            node->mDerivedScale.z = derived[9 * batchStride];
+            node->mCachedTransformOutOfDate = true;
+            node->mNeedParentUpdate = false;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformArray::storeTransform(Level& level, size_t index, const Node* node)
+    {
+        Real* transforms = level.transforms + index;
+        const size_t stride = level.stride;
+        transforms[0] = node->mDerivedPosition.x;
+        transforms[stride] = node->mDerivedPosition.y;
+        transforms[2 * stride] = node->mDerivedPosition.z;
+        transforms[3 * stride] = node->mDerivedOrientation.w;
+        transforms[4 * stride] = node->mDerivedOrientation.x;
+        transforms[5 * stride] = node->mDerivedOrientation.y;
+        transforms[6 * stride] = node->mDerivedOrientation.z;
+        transforms[7 * stride] = node->mDerivedScale.x;
+        transforms[8 * stride] = node->mDerivedScale.y;
+        transforms[9 * stride] = node->mDerivedScale.z;
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformArray::finishUpdate(void)
+    {
+        for (LevelList::iterator l = mLevels.begin(); l != mLevels.end(); ++l)
+        {
+            const size_t numNodes = l->nodes.size();
+            for (size_t i = 0; i < numNodes; ++i)
+            {
+                const uint8 state = l->states[i];
+                if (!(state & STATE_VISITED))
+                    continue;
+
+                Node* node = l->nodes[i];
+                node->mParentNotified = false;
+                node->mChildrenToUpdate.clear();
+                node->mNeedChildUpdate = false;
+
+                if (state & STATE_TRANSFORM_UPDATED)
+                {
+                    node->derivedTransformUpdatedImpl();
+                    if (node->mListener)
+                    {
+                        node->mListener->nodeUpdated(node);
+                    }
+                }
+            }
+        }
+    }
+
+}
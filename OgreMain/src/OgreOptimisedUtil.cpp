@@ -348,6 +348,62 @@ namespace Ogre {
             ++index;    // So we can put break point here even if in release build
         }
 
+        virtual void concatenateNodeTransforms(
+            const Real* parentTransforms,
+            const Real* localTransforms,
+            Real* derivedTransforms,
+            size_t stride,
+            size_t numNodes)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->concatenateNodeTransforms(
+                parentTransforms,
+                localTransforms,
+                derivedTransforms,
+                stride,
+                numNodes);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void interpolateNodeKeyFrames(
+            const Real* keyFrames1,
+            const Real* keyFrames2,
+            const Real* params,
+            Real* transforms,
+            size_t stride,
+            size_t numNodes)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->interpolateNodeKeyFrames(
+                keyFrames1,
+                keyFrames2,
+                params,
+                transforms,
+                stride,
+                numNodes);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
     };
 #endif // __DO_PROFILE__
 
@@ -31,6 +31,7 @@ THE SOFTWARE.
 
 #include "OgreVector3.h"
 #include "OgreMatrix4.h"
+#include "OgreQuaternion.h"
 
 namespace Ogre {
 
@@ -94,6 +95,23 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::concatenateNodeTransforms
+        virtual void concatenateNodeTransforms(
+            const Real* parentTransforms,
+            const Real* localTransforms,
+            Real* derivedTransforms,
+            size_t stride,
+            size_t numNodes);
+
+        /// @copydoc OptimisedUtil::interpolateNodeKeyFrames
+        virtual void interpolateNodeKeyFrames(
+            const Real* keyFrames1,
+            const Real* keyFrames2,
+            const Real* params,
+            Real* transforms,
+            size_t stride,
+            size_t numNodes);
     };
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -392,6 +410,92 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::concatenateNodeTransforms(
+        const Real* pParent,
+        const Real* pLocal,
+        Real* pDerived,
+        size_t stride,
+        size_t numNodes)
+    {
+        for (size_t i = 0; i < numNodes; ++i)
+        {
+            const Vector3 parentPosition(pParent[i], pParent[stride + i], pParent[2*stride + i]);
+            const Quaternion parentOrientation(pParent[3*stride + i], pParent[4*stride + i],
+                pParent[5*stride + i], pParent[6*stride + i]);
+            const Vector3 parentScale(pParent[7*stride + i], pParent[8*stride + i], pParent[9*stride + i]);
+
+            const Vector3 position(pLocal[i], pLocal[stride + i], pLocal[2*stride + i]);
+            const Quaternion orientation(pLocal[3*stride + i], pLocal[4*stride + i],
+                pLocal[5*stride + i], pLocal[6*stride + i]);
+            const Vector3 scale(pLocal[7*stride + i], pLocal[8*stride + i], pLocal[9*stride + i]);
+
+            // Same sequence of operations as Node::updateFromParentImpl
+            const Quaternion derivedOrientation = pLocal[10*stride + i] != 0 ?
+                parentOrientation * orientation : orientation;
+            const Vector3 derivedScale = pLocal[11*stride + i] != 0 ?
+                parentScale * scale : scale;
+            Vector3 derivedPosition = parentOrientation * (parentScale * position);
+            derivedPosition += parentPosition;
+
+            pDerived[i] = derivedPosition.x;
+            pDerived[stride + i] = derivedPosition.y;
+            pDerived[2*stride + i] = derivedPosition.z;
+            pDerived[3*stride + i] = derivedOrientation.w;
+            pDerived[4*stride + i] = derivedOrientation.x;
+            pDerived[5*stride + i] = derivedOrientation.y;
+            pDerived[6*stride + i] = derivedOrientation.z;
+            pDerived[7*stride + i] = derivedScale.x;
+            pDerived[8*stride + i] = derivedScale.y;
+            pDerived[9*stride + i] = derivedScale.z;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::interpolateNodeKeyFrames(
+        const Real* pKeys1,
+        const Real* pKeys2,
+        const Real* pParams,
+        Real* pResult,
+        size_t stride,
+        size_t numNodes)
+    {
+        for (size_t i = 0; i < numNodes; ++i)
+        {
+            const Real t = pParams[i];
+            if (t == 0)
+            {
+                for (size_t s = 0; s < 10; ++s)
+                    pResult[s*stride + i] = pKeys1[s*stride + i];
+                continue;
+            }
+
+            const Vector3 position1(pKeys1[i], pKeys1[stride + i], pKeys1[2*stride + i]);
+            const Quaternion rotation1(pKeys1[3*stride + i], pKeys1[4*stride + i],
+                pKeys1[5*stride + i], pKeys1[6*stride + i]);
+            const Vector3 scale1(pKeys1[7*stride + i], pKeys1[8*stride + i], pKeys1[9*stride + i]);
+
+            const Vector3 position2(pKeys2[i], pKeys2[stride + i], pKeys2[2*stride + i]);
+            const Quaternion rotation2(pKeys2[3*stride + i], pKeys2[4*stride + i],
+                pKeys2[5*stride + i], pKeys2[6*stride + i]);
+            const Vector3 scale2(pKeys2[7*stride + i], pKeys2[8*stride + i], pKeys2[9*stride + i]);
+
+            // Same expressions as NodeAnimationTrack::getInterpolatedKeyFrame
+            const Quaternion rotation = Quaternion::nlerp(t, rotation1, rotation2, pParams[stride + i] != 0);
+            const Vector3 position = position1 + ((position2 - position1) * t);
+            const Vector3 scale = scale1 + ((scale2 - scale1) * t);
+
+            pResult[i] = position.x;
+            pResult[stride + i] = position.y;
+            pResult[2*stride + i] = position.z;
+            pResult[3*stride + i] = rotation.w;
+            pResult[4*stride + i] = rotation.x;
+            pResult[5*stride + i] = rotation.y;
+            pResult[6*stride + i] = rotation.z;
+            pResult[7*stride + i] = scale.x;
+            pResult[8*stride + i] = scale.y;
+            pResult[9*stride + i] = scale.z;
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilGeneral(void)
@@ -132,6 +132,21 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+        /// @copydoc OptimisedUtil::concatenateNodeTransforms
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE concatenateNodeTransforms(
+            const Real* parentTransforms,
+            const Real* localTransforms,
+            Real* derivedTransforms,
+            size_t stride,
+            size_t numNodes);
+        /// @copydoc OptimisedUtil::interpolateNodeKeyFrames
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE interpolateNodeKeyFrames(
+            const Real* keyFrames1,
+            const Real* keyFrames2,
+            const Real* params,
+            Real* transforms,
+            size_t stride,
+            size_t numNodes);
     };
 
 #if defined(__OGRE_SIMD_ALIGN_STACK)
@@ -271,6 +286,42 @@ namespace Ogre {
                 destPositions,
                 numVertices);
         }
+        /// @copydoc OptimisedUtil::concatenateNodeTransforms
+        virtual void concatenateNodeTransforms(
+            const Real* parentTransforms,
+            const Real* localTransforms,
+            Real* derivedTransforms,
+            size_t stride,
+            size_t numNodes)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->concatenateNodeTransforms(
+                parentTransforms,
+                localTransforms,
+                derivedTransforms,
+                stride,
+                numNodes);
+        }
+        /// @copydoc OptimisedUtil::interpolateNodeKeyFrames
+        virtual void interpolateNodeKeyFrames(
+            const Real* keyFrames1,
+            const Real* keyFrames2,
+            const Real* params,
+            Real* transforms,
+            size_t stride,
+            size_t numNodes)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->interpolateNodeKeyFrames(
+                keyFrames1,
+                keyFrames2,
+                params,
+                transforms,
+                stride,
+                numNodes);
+        }
     };
 #endif  // !defined(__OGRE_SIMD_ALIGN_STACK)
 
@@ -2136,6 +2187,192 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilSSE::concatenateNodeTransforms(
+        const Real* pParent,
+        const Real* pLocal,
+        Real* pDerived,
+        size_t stride,
+        size_t numNodes)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        assert(_isAlignedForSSE(pParent) && _isAlignedForSSE(pLocal) && _isAlignedForSSE(pDerived));
+        assert((stride & 3) == 0 && numNodes <= stride);
+
+        // Streams are padded to a multiple of four, so the last group is
+        // processed whole; the padding lanes are don't-care values.
+        //
+        // The expressions below mirror Node::updateFromParentImpl term by
+        // term (Quaternion * Quaternion, Quaternion * Vector3), so every lane
+        // yields exactly the value the scalar path would produce.
+
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 two = _mm_set_ps1(2.0f);
+
+        for (size_t i = 0; i < numNodes; i += 4)
+        {
+            // Parent derived transform
+            const __m128 ppx = _mm_load_ps(pParent + i);
+            const __m128 ppy = _mm_load_ps(pParent + stride + i);
+            const __m128 ppz = _mm_load_ps(pParent + 2*stride + i);
+            const __m128 pqw = _mm_load_ps(pParent + 3*stride + i);
+            const __m128 pqx = _mm_load_ps(pParent + 4*stride + i);
+            const __m128 pqy = _mm_load_ps(pParent + 5*stride + i);
+            const __m128 pqz = _mm_load_ps(pParent + 6*stride + i);
+            const __m128 psx = _mm_load_ps(pParent + 7*stride + i);
+            const __m128 psy = _mm_load_ps(pParent + 8*stride + i);
+            const __m128 psz = _mm_load_ps(pParent + 9*stride + i);
+
+            // Local transform
+            const __m128 lpx = _mm_load_ps(pLocal + i);
+            const __m128 lpy = _mm_load_ps(pLocal + stride + i);
+            const __m128 lpz = _mm_load_ps(pLocal + 2*stride + i);
+            const __m128 lqw = _mm_load_ps(pLocal + 3*stride + i);
+            const __m128 lqx = _mm_load_ps(pLocal + 4*stride + i);
+            const __m128 lqy = _mm_load_ps(pLocal + 5*stride + i);
+            const __m128 lqz = _mm_load_ps(pLocal + 6*stride + i);
+            const __m128 lsx = _mm_load_ps(pLocal + 7*stride + i);
+            const __m128 lsy = _mm_load_ps(pLocal + 8*stride + i);
+            const __m128 lsz = _mm_load_ps(pLocal + 9*stride + i);
+            const __m128 inheritOrientation = _mm_cmpneq_ps(_mm_load_ps(pLocal + 10*stride + i), zero);
+            const __m128 inheritScale = _mm_cmpneq_ps(_mm_load_ps(pLocal + 11*stride + i), zero);
+
+            // Orientation: parentOrientation * orientation
+            __m128 qw = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(
+                _mm_mul_ps(pqw, lqw), _mm_mul_ps(pqx, lqx)), _mm_mul_ps(pqy, lqy)), _mm_mul_ps(pqz, lqz));
+            __m128 qx = _mm_sub_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(pqw, lqx), _mm_mul_ps(pqx, lqw)), _mm_mul_ps(pqy, lqz)), _mm_mul_ps(pqz, lqy));
+            __m128 qy = _mm_sub_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(pqw, lqy), _mm_mul_ps(pqy, lqw)), _mm_mul_ps(pqz, lqx)), _mm_mul_ps(pqx, lqz));
+            __m128 qz = _mm_sub_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(pqw, lqz), _mm_mul_ps(pqz, lqw)), _mm_mul_ps(pqx, lqy)), _mm_mul_ps(pqy, lqx));
+            qw = _mm_or_ps(_mm_and_ps(inheritOrientation, qw), _mm_andnot_ps(inheritOrientation, lqw));
+            qx = _mm_or_ps(_mm_and_ps(inheritOrientation, qx), _mm_andnot_ps(inheritOrientation, lqx));
+            qy = _mm_or_ps(_mm_and_ps(inheritOrientation, qy), _mm_andnot_ps(inheritOrientation, lqy));
+            qz = _mm_or_ps(_mm_and_ps(inheritOrientation, qz), _mm_andnot_ps(inheritOrientation, lqz));
+
+            // Scale: parentScale * scale
+            __m128 sx = _mm_mul_ps(psx, lsx);
+            __m128 sy = _mm_mul_ps(psy, lsy);
+            __m128 sz = _mm_mul_ps(psz, lsz);
+            sx = _mm_or_ps(_mm_and_ps(inheritScale, sx), _mm_andnot_ps(inheritScale, lsx));
+            sy = _mm_or_ps(_mm_and_ps(inheritScale, sy), _mm_andnot_ps(inheritScale, lsy));
+            sz = _mm_or_ps(_mm_and_ps(inheritScale, sz), _mm_andnot_ps(inheritScale, lsz));
+
+            // Position: parentOrientation * (parentScale * position) + parentPosition
+            const __m128 vx = _mm_mul_ps(psx, lpx);
+            const __m128 vy = _mm_mul_ps(psy, lpy);
+            const __m128 vz = _mm_mul_ps(psz, lpz);
+            __m128 uvx = _mm_sub_ps(_mm_mul_ps(pqy, vz), _mm_mul_ps(pqz, vy));
+            __m128 uvy = _mm_sub_ps(_mm_mul_ps(pqz, vx), _mm_mul_ps(pqx, vz));
+            __m128 uvz = _mm_sub_ps(_mm_mul_ps(pqx, vy), _mm_mul_ps(pqy, vx));
+            __m128 uuvx = _mm_sub_ps(_mm_mul_ps(pqy, uvz), _mm_mul_ps(pqz, uvy));
+            __m128 uuvy = _mm_sub_ps(_mm_mul_ps(pqz, uvx), _mm_mul_ps(pqx, uvz));
+            __m128 uuvz = _mm_sub_ps(_mm_mul_ps(pqx, uvy), _mm_mul_ps(pqy, uvx));
+            const __m128 w2 = _mm_mul_ps(two, pqw);
+            uvx = _mm_mul_ps(uvx, w2);
+            uvy = _mm_mul_ps(uvy, w2);
+            uvz = _mm_mul_ps(uvz, w2);
+            uuvx = _mm_mul_ps(uuvx, two);
+            uuvy = _mm_mul_ps(uuvy, two);
+            uuvz = _mm_mul_ps(uuvz, two);
+
+            _mm_store_ps(pDerived + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(vx, uvx), uuvx), ppx));
+            _mm_store_ps(pDerived + stride + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(vy, uvy), uuvy), ppy));
+            _mm_store_ps(pDerived + 2*stride + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(vz, uvz), uuvz), ppz));
+            _mm_store_ps(pDerived + 3*stride + i, qw);
+            _mm_store_ps(pDerived + 4*stride + i, qx);
+            _mm_store_ps(pDerived + 5*stride + i, qy);
+            _mm_store_ps(pDerived + 6*stride + i, qz);
+            _mm_store_ps(pDerived + 7*stride + i, sx);
+            _mm_store_ps(pDerived + 8*stride + i, sy);
+            _mm_store_ps(pDerived + 9*stride + i, sz);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::interpolateNodeKeyFrames(
+        const Real* pKeys1,
+        const Real* pKeys2,
+        const Real* pParams,
+        Real* pResult,
+        size_t stride,
+        size_t numNodes)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        assert(_isAlignedForSSE(pKeys1) && _isAlignedForSSE(pKeys2) &&
+            _isAlignedForSSE(pParams) && _isAlignedForSSE(pResult));
+        assert((stride & 3) == 0 && numNodes <= stride);
+
+        // As in concatenateNodeTransforms the last group is processed whole.
+        //
+        // The expressions below mirror Quaternion::nlerp and the linear
+        // interpolation of NodeAnimationTrack::getInterpolatedKeyFrame term
+        // by term, so every lane yields exactly the value the scalar path
+        // would produce.
+
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set_ps1(1.0f);
+        const __m128 signMask = _mm_set_ps1(-0.0f);
+
+        for (size_t i = 0; i < numNodes; i += 4)
+        {
+            const __m128 t = _mm_load_ps(pParams + i);
+            const __m128 shortestPath = _mm_cmpneq_ps(_mm_load_ps(pParams + stride + i), zero);
+            // Lanes exactly on the first keyframe take it unchanged
+            const __m128 onKey = _mm_cmpeq_ps(t, zero);
+
+            // Position and scale: base + ((next - base) * t)
+            static const size_t linearStreams[6] = { 0, 1, 2, 7, 8, 9 };
+            for (size_t j = 0; j < 6; ++j)
+            {
+                const size_t s = linearStreams[j];
+                const __m128 k1 = _mm_load_ps(pKeys1 + s*stride + i);
+                const __m128 k2 = _mm_load_ps(pKeys2 + s*stride + i);
+                const __m128 r = _mm_add_ps(k1, _mm_mul_ps(_mm_sub_ps(k2, k1), t));
+                _mm_store_ps(pResult + s*stride + i,
+                    _mm_or_ps(_mm_and_ps(onKey, k1), _mm_andnot_ps(onKey, r)));
+            }
+
+            // Rotation: Quaternion::nlerp
+            const __m128 pw = _mm_load_ps(pKeys1 + 3*stride + i);
+            const __m128 px = _mm_load_ps(pKeys1 + 4*stride + i);
+            const __m128 py = _mm_load_ps(pKeys1 + 5*stride + i);
+            const __m128 pz = _mm_load_ps(pKeys1 + 6*stride + i);
+            __m128 qw = _mm_load_ps(pKeys2 + 3*stride + i);
+            __m128 qx = _mm_load_ps(pKeys2 + 4*stride + i);
+            __m128 qy = _mm_load_ps(pKeys2 + 5*stride + i);
+            __m128 qz = _mm_load_ps(pKeys2 + 6*stride + i);
+
+            const __m128 cosine = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(pw, qw), _mm_mul_ps(px, qx)), _mm_mul_ps(py, qy)), _mm_mul_ps(pz, qz));
+            const __m128 negate = _mm_and_ps(
+                _mm_and_ps(_mm_cmplt_ps(cosine, zero), shortestPath), signMask);
+            qw = _mm_xor_ps(qw, negate);
+            qx = _mm_xor_ps(qx, negate);
+            qy = _mm_xor_ps(qy, negate);
+            qz = _mm_xor_ps(qz, negate);
+
+            __m128 rw = _mm_add_ps(pw, _mm_mul_ps(t, _mm_sub_ps(qw, pw)));
+            __m128 rx = _mm_add_ps(px, _mm_mul_ps(t, _mm_sub_ps(qx, px)));
+            __m128 ry = _mm_add_ps(py, _mm_mul_ps(t, _mm_sub_ps(qy, py)));
+            __m128 rz = _mm_add_ps(pz, _mm_mul_ps(t, _mm_sub_ps(qz, pz)));
+
+            const __m128 norm = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(rw, rw), _mm_mul_ps(rx, rx)), _mm_mul_ps(ry, ry)), _mm_mul_ps(rz, rz));
+            const __m128 factor = _mm_div_ps(one, _mm_sqrt_ps(norm));
+            rw = _mm_mul_ps(rw, factor);
+            rx = _mm_mul_ps(rx, factor);
+            ry = _mm_mul_ps(ry, factor);
+            rz = _mm_mul_ps(rz, factor);
+
+            _mm_store_ps(pResult + 3*stride + i, _mm_or_ps(_mm_and_ps(onKey, pw), _mm_andnot_ps(onKey, rw)));
+            _mm_store_ps(pResult + 4*stride + i, _mm_or_ps(_mm_and_ps(onKey, px), _mm_andnot_ps(onKey, rx)));
+            _mm_store_ps(pResult + 5*stride + i, _mm_or_ps(_mm_and_ps(onKey, py), _mm_andnot_ps(onKey, ry)));
+            _mm_store_ps(pResult + 6*stride + i, _mm_or_ps(_mm_and_ps(onKey, pz), _mm_andnot_ps(onKey, rz)));
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilSSE(void)
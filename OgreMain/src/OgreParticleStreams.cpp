@@ -0,0 +1,161 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreParticleStreams.h"
+#include "OgreParticle.h"
+
+namespace Ogre {
+
+    //-----------------------------------------------------------------------
+    ParticleStreams::ParticleStreams()
+        : mData(0)
+        , mCapacity(0)
+    {
+    }
+    //-----------------------------------------------------------------------
+    ParticleStreams::~ParticleStreams()
+    {
+        OGRE_FREE_SIMD(mData, MEMCATEGORY_GENERAL);
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::reserve(size_t capacity)
+    {
+        if (capacity <= mCapacity)
+            return;
+
+        const size_t newCapacity = (capacity + 3) & ~size_t(3);
+        Real* newData = static_cast<Real*>(OGRE_MALLOC_SIMD(
+            sizeof(Real) * PS_COUNT * newCapacity, MEMCATEGORY_GENERAL));
+        if (mData)
+        {
+            for (size_t s = 0; s < PS_COUNT; ++s)
+            {
+                memcpy(newData + s * newCapacity, mData + s * mCapacity, sizeof(Real) * mParticles.size());
+            }
+            OGRE_FREE_SIMD(mData, MEMCATEGORY_GENERAL);
+        }
+        mData = newData;
+        mCapacity = newCapacity;
+    }
+    //-----------------------------------------------------------------------
+    size_t ParticleStreams::add(Particle* particle)
+    {
+        const size_t index = mParticles.size();
+        if (index == mCapacity)
+            reserve(std::max(mCapacity * 2, size_t(16)));
+
+        mParticles.push_back(particle);
+        loadParticle(index);
+        return index;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::remove(size_t index)
+    {
+        const size_t last = mParticles.size() - 1;
+        if (index != last)
+        {
+            mParticles[index] = mParticles[last];
+            for (size_t s = 0; s < PS_COUNT; ++s)
+            {
+                Real* stream = mData + s * mCapacity;
+                stream[index] = stream[last];
+            }
+        }
+        mParticles.pop_back();
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::clear(void)
+    {
+        mParticles.clear();
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::loadParticle(size_t index)
+    {
+        const Particle* p = mParticles[index];
+        Real* data = mData + index;
+        data[PS_POSITION_X * mCapacity] = p->mPosition.x;
+        data[PS_POSITION_Y * mCapacity] = p->mPosition.y;
+        data[PS_POSITION_Z * mCapacity] = p->mPosition.z;
+        data[PS_DIRECTION_X * mCapacity] = p->mDirection.x;
+        data[PS_DIRECTION_Y * mCapacity] = p->mDirection.y;
+        data[PS_DIRECTION_Z * mCapacity] = p->mDirection.z;
+        data[PS_COLOUR_R * mCapacity] = p->mColour.r;
+        data[PS_COLOUR_G * mCapacity] = p->mColour.g;
+        data[PS_COLOUR_B * mCapacity] = p->mColour.b;
+        data[PS_COLOUR_A * mCapacity] = p->mColour.a;
+        data[PS_TIME_TO_LIVE * mCapacity] = p->mTimeToLive;
+        data[PS_TOTAL_TIME_TO_LIVE * mCapacity] = p->mTotalTimeToLive;
+        data[PS_ROTATION * mCapacity] = p->mRotation.valueRadians();
+        data[PS_ROTATION_SPEED * mCapacity] = p->mRotationSpeed.valueRadians();
+        data[PS_WIDTH * mCapacity] = p->mWidth;
+        data[PS_HEIGHT * mCapacity] = p->mHeight;
+        data[PS_OWN_DIMENSIONS * mCapacity] = p->mOwnDimensions ? 1 : 0;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::loadParticles(void)
+    {
+        const size_t count = mParticles.size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            loadParticle(i);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::storeParticle(size_t index) const
+    {
+        Particle* p = mParticles[index];
+        const Real* data = mData + index;
+        p->mPosition.x = data[PS_POSITION_X * mCapacity];
+        p->mPosition.y = data[PS_POSITION_Y * mCapacity];
+        p->mPosition.z = data[PS_POSITION_Z * mCapacity];
+        p->mDirection.x = data[PS_DIRECTION_X * mCapacity];
+        p->mDirection.y = data[PS_DIRECTION_Y * mCapacity];
+        p->mDirection.z = data[PS_DIRECTION_Z * mCapacity];
+        p->mColour.r = static_cast<float>(data[PS_COLOUR_R * mCapacity]);
+        p->mColour.g = static_cast<float>(data[PS_COLOUR_G * mCapacity]);
+        p->mColour.b = static_cast<float>(data[PS_COLOUR_B * mCapacity]);
+        p->mColour.a = static_cast<float>(data[PS_COLOUR_A * mCapacity]);
+        p->mTimeToLive = data[PS_TIME_TO_LIVE * mCapacity];
+        p->mTotalTimeToLive = data[PS_TOTAL_TIME_TO_LIVE * mCapacity];
+        p->mRotation = Radian(data[PS_ROTATION * mCapacity]);
+        p->mRotationSpeed = Radian(data[PS_ROTATION_SPEED * mCapacity]);
+        p->mWidth = data[PS_WIDTH * mCapacity];
+        p->mHeight = data[PS_HEIGHT * mCapacity];
+        p->mOwnDimensions = data[PS_OWN_DIMENSIONS * mCapacity] != 0;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::storeParticles(void) const
+    {
+        const size_t count = mParticles.size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            storeParticle(i);
+        }
+    }
+
+}
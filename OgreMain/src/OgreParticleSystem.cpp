@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreParticleEmitter.h"
 #include "OgreParticleAffector.h"
 #include "OgreParticle.h"
+#include "OgreParticleStreams.h"
 #include "OgreIteratorWrappers.h"
 #include "OgreCamera.h"
 #include "OgreStringConverter.h"
@@ -55,6 +56,7 @@ namespace Ogre {
     ParticleSystem::CmdLocalSpace ParticleSystem::msLocalSpaceCmd;
     ParticleSystem::CmdIterationInterval ParticleSystem::msIterationIntervalCmd;
     ParticleSystem::CmdNonvisibleTimeout ParticleSystem::msNonvisibleTimeoutCmd;
+    ParticleSystem::CmdContiguousStorage ParticleSystem::msContiguousStorageCmd;
 
     RadixSort<ParticleSystem::ActiveParticleList, Particle*, float> ParticleSystem::mRadixSorter;
 
@@ -99,7 +101,11 @@ namespace Ogre {
         mRenderer(0),
         mCullIndividual(false),
         mPoolSize(0),
-        mEmittedEmitterPoolSize(0)
+        mEmittedEmitterPoolSize(0),
+        mParticleStreams(0),
+        mParticlesOutOfDate(false),
+        mParticleStreamsOutOfDate(false),
+        mActiveParticleListOutOfDate(false)
     {
         initParameters();
 
@@ -132,7 +138,11 @@ namespace Ogre {
         mRenderer(0), 
         mCullIndividual(false),
         mPoolSize(0),
-        mEmittedEmitterPoolSize(0)
+        mEmittedEmitterPoolSize(0),
+        mParticleStreams(0),
+        mParticlesOutOfDate(false),
+        mParticleStreamsOutOfDate(false),
+        mActiveParticleListOutOfDate(false)
     {
         setDefaultDimensions( 100, 100 );
         setMaterialName( "BaseWhite" );
@@ -167,6 +177,7 @@ namespace Ogre {
         {
             OGRE_DELETE *i;
         }
+        OGRE_DELETE mParticleStreams;
 
         if (mRenderer)
         {
@@ -295,6 +306,7 @@ namespace Ogre {
         mIterationIntervalSet = rhs.mIterationIntervalSet;
         mNonvisibleTimeout = rhs.mNonvisibleTimeout;
         mNonvisibleTimeoutSet = rhs.mNonvisibleTimeoutSet;
+        setContiguousParticleStorage(rhs.getContiguousParticleStorage());
         // last frame visible and time since last visible should be left default
 
         setRenderer(rhs.getRendererName());
@@ -443,6 +455,12 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ParticleSystem::_expire(Real timeElapsed)
     {
+        if (mParticleStreams)
+        {
+            _expireStreams(timeElapsed);
+            return;
+        }
+
         ActiveParticleList::iterator i, itEnd;
         Particle* pParticle;
         ParticleEmitter* pParticleEmitter;
@@ -578,14 +596,16 @@ namespace Ogre {
             // The particle is a visual particle if the emit_emitter property of the emitter isn't set 
             Particle* p = 0;
             String  emitterName = emitter->getEmittedEmitter();
+            // New particles are copied to the contiguous storage one by one
+            // below, the others are unchanged
             if (emitterName == BLANKSTRING)
-                p = createParticle();
+                p = createParticleImpl();
             else
-                p = createEmitterParticle(emitterName);
+                p = createEmitterParticleImpl(emitterName);
 
             // Only continue if the particle was really created (not null)
             if (!p)
-                return;
+                break;
 
             emitter->_initParticle(p);
 
@@ -616,6 +636,12 @@ namespace Ogre {
                 pParticleEmitter->setPosition(p->mPosition);
             }
 
+            if (mParticleStreams)
+            {
+                // Particles are always appended
+                mParticleStreams->loadParticle(mParticleStreams->size() - 1);
+            }
+
             // Notify renderer
             mRenderer->_notifyParticleEmitted(p);
         }
@@ -623,6 +649,12 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ParticleSystem::_applyMotion(Real timeElapsed)
     {
+        if (mParticleStreams)
+        {
+            _applyMotionStreams(timeElapsed);
+            return;
+        }
+
         ActiveParticleList::iterator i, itEnd;
         Particle* pParticle;
         ParticleEmitter* pParticleEmitter;
@@ -652,6 +684,29 @@ namespace Ogre {
         ParticleAffectorList::iterator i, itEnd;
         
         itEnd = mAffectors.end();
+        if (mParticleStreams)
+        {
+            for (i = mAffectors.begin(); i != itEnd; ++i)
+            {
+                if ((*i)->_supportsParticleStreams())
+                {
+                    updateStreamsFromParticles();
+                    (*i)->_affectParticleStreams(this, timeElapsed, *mParticleStreams);
+                    // Unless the affector went through the particle instances, the
+                    // streams now hold the latest state
+                    if (!mParticleStreamsOutOfDate)
+                        mParticlesOutOfDate = true;
+                }
+                else
+                {
+                    // Goes through _getIterator, the streams are reloaded
+                    // when the next pass needs them
+                    (*i)->_affectParticles(this, timeElapsed);
+                }
+            }
+            return;
+        }
+
         for (i = mAffectors.begin(); i != itEnd; ++i)
         {
             (*i)->_affectParticles(this, timeElapsed);
@@ -659,6 +714,155 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void ParticleSystem::_expireStreams(Real timeElapsed)
+    {
+        updateStreamsFromParticles();
+
+        // Age all particles first; those whose time to live was below the
+        // elapsed time are now negative
+        Real* timeToLive = mParticleStreams->getStream(ParticleStreams::PS_TIME_TO_LIVE);
+        const size_t count = mParticleStreams->size();
+        size_t numExpired = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            timeToLive[i] -= timeElapsed;
+            numExpired += timeToLive[i] < 0;
+        }
+        mParticlesOutOfDate = true;
+
+        if (!numExpired)
+            return;
+
+        for (size_t i = 0; i < mParticleStreams->size(); )
+        {
+            if (timeToLive[i] >= 0)
+            {
+                ++i;
+                continue;
+            }
+
+            Particle* pParticle = mParticleStreams->getParticle(i);
+            mParticleStreams->storeParticle(i);
+
+            // Notify renderer
+            mRenderer->_notifyParticleExpired(pParticle);
+
+            // The list only needs to lose a node, its values are refreshed later
+            if (pParticle->mParticleType == Particle::Visual)
+            {
+                mFreeParticles.splice(mFreeParticles.end(), mActiveParticles, --mActiveParticles.end());
+                mFreeParticles.back() = pParticle;
+            }
+            else
+            {
+                // For now, it can only be an emitted emitter
+                ParticleEmitter* pParticleEmitter = static_cast<ParticleEmitter*>(pParticle);
+                list<ParticleEmitter*>::type* fee = findFreeEmittedEmitter(pParticleEmitter->getName());
+                fee->push_back(pParticleEmitter);
+
+                // Also erase from mActiveEmittedEmitters
+                removeFromActiveEmittedEmitters (pParticleEmitter);
+
+                mActiveParticles.pop_back();
+            }
+
+            // The last particle takes this slot
+            mParticleStreams->remove(i);
+        }
+        mActiveParticleListOutOfDate = true;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_applyMotionStreams(Real timeElapsed)
+    {
+        updateStreamsFromParticles();
+
+        const size_t count = mParticleStreams->size();
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            Real* position = mParticleStreams->getStream(
+                static_cast<ParticleStreams::Stream>(ParticleStreams::PS_POSITION_X + axis));
+            const Real* direction = mParticleStreams->getStream(
+                static_cast<ParticleStreams::Stream>(ParticleStreams::PS_DIRECTION_X + axis));
+            for (size_t i = 0; i < count; ++i)
+            {
+                position[i] += direction[i] * timeElapsed;
+            }
+        }
+        mParticlesOutOfDate = true;
+
+        // The renderer and the emitted emitters work on the Particle instances
+        updateParticlesFromStreams();
+
+        ActiveEmittedEmitterList::iterator i, itEnd = mActiveEmittedEmitters.end();
+        for (i = mActiveEmittedEmitters.begin(); i != itEnd; ++i)
+        {
+            // Follow the particle side of the emitter
+            const Particle* pParticle = *i;
+            (*i)->setPosition(pParticle->mPosition);
+        }
+
+        // Notify renderer
+        mRenderer->_notifyParticleMoved(mActiveParticles);
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::updateParticlesFromStreams(void)
+    {
+        if (mParticlesOutOfDate)
+        {
+            mParticleStreams->storeParticles();
+            mParticlesOutOfDate = false;
+        }
+
+        if (mActiveParticleListOutOfDate)
+        {
+            // The list has one node per slot already
+            const vector<Particle*>::type& particles = mParticleStreams->getParticles();
+            vector<Particle*>::type::const_iterator p = particles.begin();
+            ActiveParticleList::iterator i, itEnd = mActiveParticles.end();
+            for (i = mActiveParticles.begin(); i != itEnd; ++i, ++p)
+            {
+                *i = *p;
+            }
+            mActiveParticleListOutOfDate = false;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::updateStreamsFromParticles(void)
+    {
+        if (mParticleStreamsOutOfDate)
+        {
+            mParticleStreams->loadParticles();
+            mParticleStreamsOutOfDate = false;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::setContiguousParticleStorage(bool enabled)
+    {
+        if (enabled == (mParticleStreams != 0))
+            return;
+
+        if (enabled)
+        {
+            mParticleStreams = OGRE_NEW ParticleStreams();
+            mParticleStreams->reserve(mPoolSize);
+            ActiveParticleList::iterator i, itEnd = mActiveParticles.end();
+            for (i = mActiveParticles.begin(); i != itEnd; ++i)
+            {
+                mParticleStreams->add(*i);
+            }
+        }
+        else
+        {
+            updateParticlesFromStreams();
+            OGRE_DELETE mParticleStreams;
+            mParticleStreams = 0;
+        }
+
+        mParticlesOutOfDate = false;
+        mParticleStreamsOutOfDate = false;
+        mActiveParticleListOutOfDate = false;
+    }
+    //-----------------------------------------------------------------------
     void ParticleSystem::increasePool(size_t size)
     {
         size_t oldSize = mParticlePool.size();
@@ -683,25 +887,56 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     ParticleIterator ParticleSystem::_getIterator(void)
     {
+        if (mParticleStreams)
+        {
+            // The caller may change any particle
+            updateParticlesFromStreams();
+            mParticleStreamsOutOfDate = true;
+        }
         return ParticleIterator(mActiveParticles.begin(), mActiveParticles.end());
     }
     //-----------------------------------------------------------------------
     Particle* ParticleSystem::getParticle(size_t index) 
     {
         assert (index < mActiveParticles.size() && "Index out of bounds!");
+        if (mParticleStreams)
+        {
+            // The caller may change the particle
+            updateParticlesFromStreams();
+            mParticleStreamsOutOfDate = true;
+        }
         ActiveParticleList::iterator i = mActiveParticles.begin();
         std::advance(i, index);
         return *i;
     }
     //-----------------------------------------------------------------------
     Particle* ParticleSystem::createParticle(void)
+    {
+        if (!mParticleStreams)
+            return createParticleImpl();
+
+        // The caller initialises the particle, whose slot is reloaded with
+        // all the others
+        updateParticlesFromStreams();
+        Particle* p = createParticleImpl();
+        if (p)
+            mParticleStreamsOutOfDate = true;
+        return p;
+    }
+    //-----------------------------------------------------------------------
+    Particle* ParticleSystem::createParticleImpl(void)
     {
         Particle* p = 0;
         if (!mFreeParticles.empty())
         {
             // Fast creation (don't use superclass since emitter will init)
             p = mFreeParticles.front();
+            // Both the list and the slots are appended to, so they stay in step
             mActiveParticles.splice(mActiveParticles.end(), mFreeParticles, mFreeParticles.begin());
+            if (mParticleStreams)
+            {
+                mParticleStreams->add(p);
+            }
 
             p->_notifyOwner(this);
         }
@@ -711,6 +946,20 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     Particle* ParticleSystem::createEmitterParticle(const String& emitterName)
+    {
+        if (!mParticleStreams)
+            return createEmitterParticleImpl(emitterName);
+
+        // The caller initialises the particle, whose slot is reloaded with
+        // all the others
+        updateParticlesFromStreams();
+        Particle* p = createEmitterParticleImpl(emitterName);
+        if (p)
+            mParticleStreamsOutOfDate = true;
+        return p;
+    }
+    //-----------------------------------------------------------------------
+    Particle* ParticleSystem::createEmitterParticleImpl(const String& emitterName)
     {
         // Get the appropriate list and retrieve an emitter 
         Particle* p = 0;
@@ -721,6 +970,10 @@ namespace Ogre {
             p->mParticleType = Particle::Emitter;
             fee->pop_front();
             mActiveParticles.push_back(p);
+            if (mParticleStreams)
+            {
+                mParticleStreams->add(p);
+            }
 
             // Also add to mActiveEmittedEmitters. This is needed to traverse through all active emitters
             // that are emitted. Don't use mActiveParticles for that (although they are added to
@@ -737,6 +990,10 @@ namespace Ogre {
     {
         if (mRenderer)
         {
+            if (mParticleStreams)
+            {
+                updateParticlesFromStreams();
+            }
             mRenderer->_updateRenderQueue(queue, mActiveParticles, mCullIndividual);
         }
     }
@@ -813,6 +1070,12 @@ namespace Ogre {
                 PT_REAL),
                 &msNonvisibleTimeoutCmd);
 
+            dict->addParameter(ParameterDef("contiguous_storage", 
+                "Sets whether the live particles are simulated in contiguous arrays "
+                "rather than through a linked list.",
+                PT_BOOL),
+                &msContiguousStorageCmd);
+
         }
     }
     //-----------------------------------------------------------------------
@@ -821,6 +1084,11 @@ namespace Ogre {
 
         if (mParentNode && (mBoundsAutoUpdate || mBoundsUpdateTime > 0.0f))
         {
+            if (mParticleStreams)
+            {
+                updateParticlesFromStreams();
+            }
+
             if (mActiveParticles.empty())
             {
                 // No particles, reset to null if auto update bounds
@@ -1041,6 +1309,13 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ParticleSystem::clear()
     {
+        if (mParticleStreams)
+        {
+            updateParticlesFromStreams();
+            mParticleStreams->clear();
+            mParticleStreamsOutOfDate = false;
+        }
+
         // Notify renderer if exists
         if (mRenderer)
         {
@@ -1212,6 +1487,11 @@ namespace Ogre {
     {
         if (mRenderer)
         {
+            if (mParticleStreams)
+            {
+                updateParticlesFromStreams();
+            }
+
             SortMode sortMode = mRenderer->_getSortMode();
             if (sortMode == SM_DIRECTION)
             {
@@ -1608,6 +1888,17 @@ namespace Ogre {
         static_cast<ParticleSystem*>(target)->setNonVisibleUpdateTimeout(
             StringConverter::parseReal(val));
     }
+    //-----------------------------------------------------------------------
+    String ParticleSystem::CmdContiguousStorage::doGet(const void* target) const
+    {
+        return StringConverter::toString(
+            static_cast<const ParticleSystem*>(target)->getContiguousParticleStorage());
+    }
+    void ParticleSystem::CmdContiguousStorage::doSet(void* target, const String& val)
+    {
+        static_cast<ParticleSystem*>(target)->setContiguousParticleStorage(
+            StringConverter::parseBool(val));
+    }
    //-----------------------------------------------------------------------
     ParticleAffector::~ParticleAffector() 
     {
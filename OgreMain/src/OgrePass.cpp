@@ -112,6 +112,7 @@ namespace Ogre {
     OGRE_STATIC_MUTEX_INSTANCE(Pass::msPassGraveyardMutex);
 
     Pass::HashFunc* Pass::msHashFunc = &sMinTextureStateChangeHashFunc;
+    AtomicScalar<uint32> Pass::msLastId(0);
     //-----------------------------------------------------------------------------
     Pass::HashFunc* Pass::getBuiltinHashFunction(BuiltinHashFunction builtin)
     {
@@ -217,6 +218,10 @@ namespace Ogre {
         , mIlluminationStage(IS_UNKNOWN)
 		, mRenderStateHashDirty(true)
 		, mRenderStateHash(0)
+        , mRenderStateChangeCount(0)
+        , mProgramSortHash(0)
+        , mTextureSortHash(0)
+        , mId(++msLastId)
     {
         mPointAttenuationCoeffs[0] = 1.0f;
         mPointAttenuationCoeffs[1] = mPointAttenuationCoeffs[2] = 0.0f;
@@ -234,7 +239,9 @@ namespace Ogre {
         mShadowCasterFragmentProgramUsage(0), mShadowReceiverVertexProgramUsage(0), mFragmentProgramUsage(0), 
         mShadowReceiverFragmentProgramUsage(0), mGeometryProgramUsage(0), mTessellationHullProgramUsage(0)
         , mTessellationDomainProgramUsage(0), mComputeProgramUsage(0), mQueuedForDeletion(false), mPassIterationCount(1)
+        , mId(++msLastId)
     {
+        mRenderStateChangeCount = 0;
         *this = oth;
         mParent = parent;
         mIndex = index;
@@ -328,6 +335,9 @@ namespace Ogre {
         mLightMask = oth.mLightMask;
 		mRenderStateHashDirty = oth.mRenderStateHashDirty;
 		mRenderStateHash = oth.mRenderStateHash;
+        ++mRenderStateChangeCount;
+        mProgramSortHash = oth.mProgramSortHash;
+        mTextureSortHash = oth.mTextureSortHash;
 
         OGRE_DELETE mVertexProgramUsage;
         if (oth.mVertexProgramUsage)
@@ -496,11 +506,13 @@ namespace Ogre {
     void Pass::setPointSize(Real ps)
     {
         mPointSize = ps;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     void Pass::setPointSpritesEnabled(bool enabled)
     {
         mPointSpritesEnabled = enabled;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     bool Pass::getPointSpritesEnabled(void) const
@@ -515,6 +527,7 @@ namespace Ogre {
         mPointAttenuationCoeffs[0] = constant;
         mPointAttenuationCoeffs[1] = linear;
         mPointAttenuationCoeffs[2] = quadratic;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     bool Pass::isPointAttenuationEnabled(void) const
@@ -540,6 +553,7 @@ namespace Ogre {
     void Pass::setPointMinSize(Real min)
     {
         mPointMinSize = min;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     Real Pass::getPointMinSize(void) const
@@ -550,6 +564,7 @@ namespace Ogre {
     void Pass::setPointMaxSize(Real max)
     {
         mPointMaxSize = max;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     Real Pass::getPointMaxSize(void) const
@@ -562,12 +577,13 @@ namespace Ogre {
         mAmbient.r = red;
         mAmbient.g = green;
         mAmbient.b = blue;
-
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     void Pass::setAmbient(const ColourValue& ambient)
     {
         mAmbient = ambient;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     void Pass::setDiffuse(Real red, Real green, Real blue, Real alpha)
@@ -576,11 +592,13 @@ namespace Ogre {
         mDiffuse.g = green;
         mDiffuse.b = blue;
         mDiffuse.a = alpha;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     void Pass::setDiffuse(const ColourValue& diffuse)
     {
         mDiffuse = diffuse;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     void Pass::setSpecular(Real red, Real green, Real blue, Real alpha)
@@ -589,16 +607,19 @@ namespace Ogre {
         mSpecular.g = green;
         mSpecular.b = blue;
         mSpecular.a = alpha;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     void Pass::setSpecular(const ColourValue& specular)
     {
         mSpecular = specular;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     void Pass::setShininess(Real val)
     {
         mShininess = val;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     void Pass::setSelfIllumination(Real red, Real green, Real blue)
@@ -606,17 +627,19 @@ namespace Ogre {
         mEmissive.r = red;
         mEmissive.g = green;
         mEmissive.b = blue;
-
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     void Pass::setSelfIllumination(const ColourValue& selfIllum)
     {
         mEmissive = selfIllum;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     void Pass::setVertexColourTracking(TrackVertexColourType tracking)
     {
         mTracking = tracking;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     Real Pass::getPointSize(void) const
@@ -916,6 +939,7 @@ namespace Ogre {
         mDestBlendFactor = destFactor;
 
         mSeparateBlend = false;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     void Pass::setSeparateSceneBlending( const SceneBlendFactor sourceFactor, const SceneBlendFactor destFactor, const SceneBlendFactor sourceFactorAlpha, const SceneBlendFactor destFactorAlpha )
@@ -926,6 +950,7 @@ namespace Ogre {
         mDestBlendFactorAlpha = destFactorAlpha;
 
         mSeparateBlend = true;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     SceneBlendFactor Pass::getSourceBlendFactor(void) const
@@ -957,6 +982,7 @@ namespace Ogre {
     {
         mBlendOperation = op;
         mSeparateBlendOperation = false;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     void Pass::setSeparateSceneBlendingOperation(SceneBlendOperation op, SceneBlendOperation alphaOp)
@@ -964,6 +990,7 @@ namespace Ogre {
         mBlendOperation = op;
         mAlphaBlendOperation = alphaOp;
         mSeparateBlendOperation = true;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     SceneBlendOperation Pass::getSceneBlendingOperation() const
@@ -1002,6 +1029,7 @@ namespace Ogre {
 	void Pass::setRenderStateHashDirty()
 	{
 		mRenderStateHashDirty = true;
+        ++mRenderStateChangeCount;
 	}
 
     //-----------------------------------------------------------------------
@@ -1132,6 +1160,7 @@ namespace Ogre {
     void Pass::setStartLight(unsigned short startLight)
     {
         mStartLight = startLight;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     unsigned short Pass::getStartLight(void) const
@@ -1170,6 +1199,7 @@ namespace Ogre {
     void Pass::setShadingMode(ShadeOptions mode)
     {
         mShadeOptions = mode;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     ShadeOptions Pass::getShadingMode(void) const
@@ -1180,6 +1210,7 @@ namespace Ogre {
     void Pass::setPolygonMode(PolygonMode mode)
     {
         mPolygonMode = mode;
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     PolygonMode Pass::getPolygonMode(void) const
@@ -1208,6 +1239,7 @@ namespace Ogre {
             mFogEnd = end;
             mFogDensity = density;
         }
+        setRenderStateHashDirty();
     }
     //-----------------------------------------------------------------------
     bool Pass::getFogOverride(void) const
@@ -1902,10 +1934,73 @@ namespace Ogre {
            the first 2 gives us the most benefit for now.
        */
         mHash = (*msHashFunc)(this);
+
+        // Hashes for getRenderStateKey, which sorts on all the programs and textures
+        _StringHash H;
+        {
+            OGRE_LOCK_MUTEX(mGpuProgramChangeMutex);
+            uint32 programHash = 0;
+            if (hasVertexProgram())
+                programHash = programHash * 31 + static_cast<uint32>(H(getVertexProgramName()));
+            if (hasFragmentProgram())
+                programHash = programHash * 31 + static_cast<uint32>(H(getFragmentProgramName()));
+            if (hasGeometryProgram())
+                programHash = programHash * 31 + static_cast<uint32>(H(getGeometryProgramName()));
+            if (hasTessellationHullProgram())
+                programHash = programHash * 31 + static_cast<uint32>(H(getTessellationHullProgramName()));
+            if (hasTessellationDomainProgram())
+                programHash = programHash * 31 + static_cast<uint32>(H(getTessellationDomainProgramName()));
+            if (hasComputeProgram())
+                programHash = programHash * 31 + static_cast<uint32>(H(getComputeProgramName()));
+            mProgramSortHash = static_cast<uint16>(programHash % (1 << 14));
+        }
+        {
+            OGRE_LOCK_MUTEX(mTexUnitChangeMutex);
+            uint32 textureHash = 0;
+            for (TextureUnitStates::const_iterator i = mTextureUnitStates.begin();
+                i != mTextureUnitStates.end(); ++i)
+            {
+                textureHash = textureHash * 31 + static_cast<uint32>(H((*i)->getTextureName()));
+            }
+            mTextureSortHash = static_cast<uint16>(textureHash % (1 << 14));
+        }
+    }
+    //-----------------------------------------------------------------------
+    uint64 Pass::getRenderStateKey(void) const
+    {
+        // Blending and depth state is cheap to get, so it's always up to date
+        uint32 stateHash = mSourceBlendFactor;
+        stateHash = stateHash * 31 + mDestBlendFactor;
+        stateHash = stateHash * 31 + mSourceBlendFactorAlpha;
+        stateHash = stateHash * 31 + mDestBlendFactorAlpha;
+        stateHash = stateHash * 31 + mBlendOperation;
+        stateHash = stateHash * 31 + mAlphaBlendOperation;
+        stateHash = stateHash * 31 + mDepthFunc;
+        stateHash = stateHash * 31 + mAlphaRejectFunc;
+        stateHash = stateHash * 4 + (mDepthCheck ? 2 : 0) + (mDepthWrite ? 1 : 0);
+        stateHash = stateHash * 2 + (mColourWrite ? 1 : 0);
+
+        uint64 state = static_cast<uint64>(stateHash % 251) << 24;
+
+        // A custom hash function knows best which passes should be adjacent
+        if (msHashFunc != getBuiltinHashFunction(MIN_TEXTURE_CHANGE) &&
+            msHashFunc != getBuiltinHashFunction(MIN_GPU_PROGRAM_CHANGE))
+        {
+            return (static_cast<uint64>(mHash) << 32) | state;
+        }
+
+        uint64 first = mTextureSortHash, second = mProgramSortHash;
+        if (msHashFunc == getBuiltinHashFunction(MIN_GPU_PROGRAM_CHANGE))
+            std::swap(first, second);
+
+        return (static_cast<uint64>(std::min<unsigned short>(mIndex, 15)) << 60) |
+            (first << 46) | (second << 32) | state;
     }
     //-----------------------------------------------------------------------
     void Pass::_dirtyHash(void)
     {
+        // Textures or programs changed, so a cached render state is stale too
+        ++mRenderStateChangeCount;
         Material* mat = mParent->getParent();
         if (mat->isLoading() || mat->isLoaded())
         {
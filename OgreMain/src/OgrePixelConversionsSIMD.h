@@ -0,0 +1,420 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __PixelConversionsSIMD_H__
+#define __PixelConversionsSIMD_H__
+
+// this file is inlined into OgrePixelFormat.cpp!
+// do not include anywhere else.
+
+#if __OGRE_HAVE_SSE && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#   include <emmintrin.h>
+#   define OGRE_PIXELCONVERSION_SSE2 1
+#else
+#   define OGRE_PIXELCONVERSION_SSE2 0
+#endif
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Image
+    *  @{
+    */
+
+/// Converts a row of count consecutive pixels
+typedef void (*RowConversion)(const uint8* src, uint8* dst, size_t count);
+
+/// Vectorised row conversion between two formats
+struct RowConverter
+{
+    PixelFormat srcFormat;
+    PixelFormat dstFormat;
+    RowConversion convert;
+};
+
+#if OGRE_PIXELCONVERSION_SSE2
+
+// every kernel gives exactly the result of unpackColour followed by
+// packColour, which the fallback of PixelUtil::bulkPixelConversion uses.
+// byte layouts assume a little endian CPU, as every SSE2 one is.
+
+// bit offsets of the channels of 8 bits per channel formats, read as a
+// 32 bit integer; a negative alpha offset means the format has no alpha
+struct LayoutARGB { enum { bytes = 4, r = 16, g = 8, b = 0, a = 24 }; };
+struct LayoutABGR { enum { bytes = 4, r = 0, g = 8, b = 16, a = 24 }; };
+struct LayoutBGRA { enum { bytes = 4, r = 8, g = 16, b = 24, a = 0 }; };
+struct LayoutRGBA { enum { bytes = 4, r = 24, g = 16, b = 8, a = 0 }; };
+struct LayoutXRGB { enum { bytes = 4, r = 16, g = 8, b = 0, a = -1 }; };
+struct LayoutXBGR { enum { bytes = 4, r = 0, g = 8, b = 16, a = -1 }; };
+struct LayoutRGB { enum { bytes = 3, r = 16, g = 8, b = 0, a = -1 }; };
+struct LayoutBGR { enum { bytes = 3, r = 0, g = 8, b = 16, a = -1 }; };
+
+// moves the byte at bit offset from of every 32 bit lane to bit offset to,
+// clearing the rest of the lane
+template <int from, int to> inline __m128i moveByte(__m128i v)
+{
+    const __m128i mask = _mm_set1_epi32(static_cast<int>(0xFFu << to));
+    if (from > to)
+        v = _mm_srli_epi32(v, from > to ? from - to : 0);
+    else if (from < to)
+        v = _mm_slli_epi32(v, to > from ? to - from : 0);
+    return _mm_and_si128(v, mask);
+}
+
+// reorders the channels of 4 pixels of layout S into layout D, with an
+// opaque alpha when S has none
+template <class S, class D> inline __m128i swizzle(__m128i v)
+{
+    __m128i rgb = _mm_or_si128(moveByte<S::r, D::r>(v),
+        _mm_or_si128(moveByte<S::g, D::g>(v), moveByte<S::b, D::b>(v)));
+    if (S::a < 0)
+        return _mm_or_si128(rgb, _mm_set1_epi32(static_cast<int>(0xFFu << D::a)));
+    return _mm_or_si128(rgb, moveByte<(S::a < 0 ? 0 : S::a), D::a>(v));
+}
+
+// scalar version of swizzle for the pixels at the end of a row
+template <class S, class D> inline uint32 swizzlePixel(const uint8* src)
+{
+    uint32 v = 0;
+    memcpy(&v, src, S::bytes);
+    uint32 result = (((v >> S::r) & 0xFF) << D::r) | (((v >> S::g) & 0xFF) << D::g) |
+        (((v >> S::b) & 0xFF) << D::b);
+    if (S::a < 0)
+        return result | (0xFFu << D::a);
+    return result | (((v >> (S::a < 0 ? 0 : S::a)) & 0xFF) << D::a);
+}
+
+// loads 4 pixels of S in the low 24 or all 32 bits of each lane; pixels of
+// 3 bytes read 4 bytes past the 4th pixel
+template <class S> inline __m128i loadPixels(const uint8* src)
+{
+    __m128i v = _mm_loadu_si128((const __m128i*)src);
+    if (S::bytes == 4)
+        return v;
+    __m128i p01 = _mm_unpacklo_epi32(v, _mm_srli_si128(v, 3));
+    __m128i p23 = _mm_unpacklo_epi32(_mm_srli_si128(v, 6), _mm_srli_si128(v, 9));
+    return _mm_unpacklo_epi64(p01, p23);
+}
+
+// number of pixels at the start of a row that loadPixels may read 4 at a time
+template <class S> inline size_t vectorPixels(size_t count)
+{
+    if (S::bytes == 4)
+        return count & ~size_t(3);
+    return count < 6 ? 0 : (count - 2) & ~size_t(3);
+}
+
+// 8 bits per channel to 8 bits per channel, dropping or adding alpha
+template <class S, class D> struct ByteSwizzle
+{
+    static void convert(const uint8* src, uint8* dst, size_t count)
+    {
+        size_t x = 0;
+        for (size_t end = vectorPixels<S>(count); x < end; x += 4)
+            _mm_storeu_si128((__m128i*)(dst + 4*x), swizzle<S, D>(loadPixels<S>(src + S::bytes*x)));
+        for (; x < count; ++x)
+        {
+            uint32 v = swizzlePixel<S, D>(src + S::bytes*x);
+            memcpy(dst + 4*x, &v, 4);
+        }
+    }
+};
+
+// PF_L8 to 8 bits per channel, luminance in every colour channel
+template <class D> struct LuminanceToBytes
+{
+    static void convert(const uint8* src, uint8* dst, size_t count)
+    {
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFFu << D::a));
+        size_t x = 0;
+        for (; x + 16 <= count; x += 16)
+        {
+            __m128i l = _mm_loadu_si128((const __m128i*)(src + x));
+            __m128i lo = _mm_unpacklo_epi8(l, l), hi = _mm_unpackhi_epi8(l, l);
+            _mm_storeu_si128((__m128i*)(dst + 4*x), _mm_or_si128(_mm_unpacklo_epi16(lo, lo), alpha));
+            _mm_storeu_si128((__m128i*)(dst + 4*x + 16), _mm_or_si128(_mm_unpackhi_epi16(lo, lo), alpha));
+            _mm_storeu_si128((__m128i*)(dst + 4*x + 32), _mm_or_si128(_mm_unpacklo_epi16(hi, hi), alpha));
+            _mm_storeu_si128((__m128i*)(dst + 4*x + 48), _mm_or_si128(_mm_unpackhi_epi16(hi, hi), alpha));
+        }
+        for (; x < count; ++x)
+        {
+            uint32 v = src[x] * 0x01010101u | (0xFFu << D::a);
+            memcpy(dst + 4*x, &v, 4);
+        }
+    }
+};
+
+// 8 bits per channel to PF_L8, which keeps the red channel
+template <class S> struct BytesToLuminance
+{
+    static void convert(const uint8* src, uint8* dst, size_t count)
+    {
+        size_t x = 0;
+        for (; x + 16 <= count; x += 16)
+        {
+            __m128i p0 = moveByte<S::r, 0>(_mm_loadu_si128((const __m128i*)(src + 4*x)));
+            __m128i p1 = moveByte<S::r, 0>(_mm_loadu_si128((const __m128i*)(src + 4*x + 16)));
+            __m128i p2 = moveByte<S::r, 0>(_mm_loadu_si128((const __m128i*)(src + 4*x + 32)));
+            __m128i p3 = moveByte<S::r, 0>(_mm_loadu_si128((const __m128i*)(src + 4*x + 48)));
+            _mm_storeu_si128((__m128i*)(dst + x),
+                _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3)));
+        }
+        for (; x < count; ++x)
+            dst[x] = src[4*x + S::r / 8];
+    }
+};
+
+// 8 bits per channel to PF_FLOAT32_RGBA, dividing by 255 as
+// Bitwise::fixedToFloat does
+template <class S> struct BytesToFloat
+{
+    static void convert(const uint8* src, uint8* dst, size_t count)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128 scale = _mm_set1_ps(255.0f);
+        float* pdst = (float*)dst;
+        size_t x = 0;
+        for (size_t end = vectorPixels<S>(count); x < end; x += 4, pdst += 16)
+        {
+            // bytes in R, G, B, A order
+            __m128i v = swizzle<S, LayoutABGR>(loadPixels<S>(src + S::bytes*x));
+            __m128i lo = _mm_unpacklo_epi8(v, zero), hi = _mm_unpackhi_epi8(v, zero);
+            _mm_storeu_ps(pdst, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+            _mm_storeu_ps(pdst + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+            _mm_storeu_ps(pdst + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+            _mm_storeu_ps(pdst + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+        }
+        for (; x < count; ++x, pdst += 4)
+        {
+            uint32 v = swizzlePixel<S, LayoutABGR>(src + S::bytes*x);
+            for (int k = 0; k < 4; ++k)
+                pdst[k] = (float)((v >> (8*k)) & 0xFF) / 255.0f;
+        }
+    }
+};
+
+// PF_FLOAT32_RGBA to 8 bits per channel, clamping and truncating as
+// Bitwise::floatToFixed does
+template <class D> struct FloatToBytes
+{
+    static inline __m128i toFixed(const float* src)
+    {
+        // max returns 0 for NaN, as the scalar comparisons do
+        __m128 v = _mm_max_ps(_mm_loadu_ps(src), _mm_setzero_ps());
+        v = _mm_min_ps(_mm_mul_ps(v, _mm_set1_ps(256.0f)), _mm_set1_ps(255.0f));
+        return _mm_cvttps_epi32(v);
+    }
+
+    static void convert(const uint8* src, uint8* dst, size_t count)
+    {
+        const float* psrc = (const float*)src;
+        size_t x = 0;
+        for (; x + 4 <= count; x += 4, psrc += 16)
+        {
+            __m128i p01 = _mm_packs_epi32(toFixed(psrc), toFixed(psrc + 4));
+            __m128i p23 = _mm_packs_epi32(toFixed(psrc + 8), toFixed(psrc + 12));
+            // bytes in R, G, B, A order
+            __m128i v = _mm_packus_epi16(p01, p23);
+            _mm_storeu_si128((__m128i*)(dst + 4*x), swizzle<LayoutABGR, D>(v));
+        }
+        for (; x < count; ++x, psrc += 4)
+        {
+            uint8 rgba[4];
+            for (int k = 0; k < 4; ++k)
+                rgba[k] = static_cast<uint8>(Bitwise::floatToFixed(psrc[k], 8));
+            uint32 v = swizzlePixel<LayoutABGR, D>(rgba);
+            memcpy(dst + 4*x, &v, 4);
+        }
+    }
+};
+
+// PF_FLOAT16_* to PF_FLOAT32_* with the same channels. lanes of zero and
+// normal halves are converted in registers; groups with denormals,
+// infinities or NaNs go through Bitwise::halfToFloatI.
+template <unsigned int channels> struct HalfToFloat
+{
+    static void convert(const uint8* src, uint8* dst, size_t count)
+    {
+        const uint16* psrc = (const uint16*)src;
+        uint32* pdst = (uint32*)dst;
+        const size_t numElems = count * channels;
+        const __m128i zero = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 8 <= numElems; i += 8)
+        {
+            __m128i h = _mm_loadu_si128((const __m128i*)(psrc + i));
+            __m128i exponent = _mm_and_si128(h, _mm_set1_epi16(0x7C00));
+            __m128i magnitude = _mm_and_si128(h, _mm_set1_epi16(0x7FFF));
+            __m128i isZero = _mm_cmpeq_epi16(magnitude, zero);
+            __m128i isNormal = _mm_andnot_si128(
+                _mm_or_si128(_mm_cmpeq_epi16(exponent, zero), _mm_cmpeq_epi16(exponent, _mm_set1_epi16(0x7C00))),
+                _mm_set1_epi16(-1));
+            if (_mm_movemask_epi8(_mm_or_si128(isZero, isNormal)) != 0xFFFF)
+            {
+                for (size_t k = i; k < i + 8; ++k)
+                    pdst[k] = Bitwise::halfToFloatI(psrc[k]);
+                continue;
+            }
+
+            // sign moves to bit 31, exponent and mantissa shift by 13 and
+            // get rebiased from 15 to 127
+            magnitude = _mm_and_si128(magnitude, isNormal);
+            __m128i bias = _mm_and_si128(_mm_unpacklo_epi16(isNormal, isNormal), _mm_set1_epi32((127 - 15) << 23));
+            __m128i lo = _mm_add_epi32(_mm_slli_epi32(_mm_unpacklo_epi16(magnitude, zero), 13), bias);
+            bias = _mm_and_si128(_mm_unpackhi_epi16(isNormal, isNormal), _mm_set1_epi32((127 - 15) << 23));
+            __m128i hi = _mm_add_epi32(_mm_slli_epi32(_mm_unpackhi_epi16(magnitude, zero), 13), bias);
+            __m128i sign = _mm_and_si128(h, _mm_set1_epi16(static_cast<short>(0x8000)));
+            lo = _mm_or_si128(lo, _mm_unpacklo_epi16(zero, sign));
+            hi = _mm_or_si128(hi, _mm_unpackhi_epi16(zero, sign));
+            _mm_storeu_si128((__m128i*)(pdst + i), lo);
+            _mm_storeu_si128((__m128i*)(pdst + i + 4), hi);
+        }
+        for (; i < numElems; ++i)
+            pdst[i] = Bitwise::halfToFloatI(psrc[i]);
+    }
+};
+
+// PF_FLOAT32_* to PF_FLOAT16_* with the same channels. lanes which are
+// normal halves, or too small for a denormal, are converted in registers;
+// other groups go through Bitwise::floatToHalfI.
+template <unsigned int channels> struct FloatToHalf
+{
+    static inline __m128i toHalf(__m128i f, __m128i& valid)
+    {
+        // biased float exponents 113 to 142 are normal halves, below 102 is 0
+        __m128i exponent = _mm_srli_epi32(_mm_and_si128(f, _mm_set1_epi32(0x7F800000)), 23);
+        __m128i isNormal = _mm_and_si128(_mm_cmpgt_epi32(exponent, _mm_set1_epi32(112)),
+            _mm_cmplt_epi32(exponent, _mm_set1_epi32(143)));
+        __m128i isTiny = _mm_cmplt_epi32(exponent, _mm_set1_epi32(102));
+        valid = _mm_and_si128(valid, _mm_or_si128(isNormal, isTiny));
+
+        __m128i magnitude = _mm_sub_epi32(_mm_srli_epi32(_mm_and_si128(f, _mm_set1_epi32(0x7FFFFFFF)), 13),
+            _mm_set1_epi32((127 - 15) << 10));
+        __m128i sign = _mm_and_si128(_mm_srli_epi32(f, 16), _mm_set1_epi32(0x8000));
+        __m128i half = _mm_and_si128(_mm_or_si128(magnitude, sign), isNormal);
+        // sign extend so that the saturating pack keeps all 16 bits
+        return _mm_srai_epi32(_mm_slli_epi32(half, 16), 16);
+    }
+
+    static void convert(const uint8* src, uint8* dst, size_t count)
+    {
+        const uint32* psrc = (const uint32*)src;
+        uint16* pdst = (uint16*)dst;
+        const size_t numElems = count * channels;
+        size_t i = 0;
+        for (; i + 8 <= numElems; i += 8)
+        {
+            __m128i valid = _mm_set1_epi32(-1);
+            __m128i lo = toHalf(_mm_loadu_si128((const __m128i*)(psrc + i)), valid);
+            __m128i hi = toHalf(_mm_loadu_si128((const __m128i*)(psrc + i + 4)), valid);
+            if (_mm_movemask_epi8(valid) != 0xFFFF)
+            {
+                for (size_t k = i; k < i + 8; ++k)
+                    pdst[k] = Bitwise::floatToHalfI(psrc[k]);
+                continue;
+            }
+            _mm_storeu_si128((__m128i*)(pdst + i), _mm_packs_epi32(lo, hi));
+        }
+        for (; i < numElems; ++i)
+            pdst[i] = Bitwise::floatToHalfI(psrc[i]);
+    }
+};
+
+#define OGRE_SWIZZLE(from, to, layoutFrom, layoutTo) \
+    { PF_##from, PF_##to, ByteSwizzle<Layout##layoutFrom, Layout##layoutTo>::convert }
+#define OGRE_BYTES_FLOAT(format, layout) \
+    { PF_##format, PF_FLOAT32_RGBA, BytesToFloat<Layout##layout>::convert }, \
+    { PF_FLOAT32_RGBA, PF_##format, FloatToBytes<Layout##layout>::convert }
+#define OGRE_LUMINANCE(format, layout) \
+    { PF_L8, PF_##format, LuminanceToBytes<Layout##layout>::convert }, \
+    { PF_##format, PF_L8, BytesToLuminance<Layout##layout>::convert }
+#define OGRE_HALF_FLOAT(channels, suffix) \
+    { PF_FLOAT16_##suffix, PF_FLOAT32_##suffix, HalfToFloat<channels>::convert }, \
+    { PF_FLOAT32_##suffix, PF_FLOAT16_##suffix, FloatToHalf<channels>::convert }
+
+/// Kernels needing SSE2, for PixelUtil::bulkPixelConversion
+static const RowConverter sse2RowConverters[] =
+{
+    OGRE_SWIZZLE(A8R8G8B8, A8B8G8R8, ARGB, ABGR),
+    OGRE_SWIZZLE(A8R8G8B8, B8G8R8A8, ARGB, BGRA),
+    OGRE_SWIZZLE(A8R8G8B8, R8G8B8A8, ARGB, RGBA),
+    OGRE_SWIZZLE(A8B8G8R8, A8R8G8B8, ABGR, ARGB),
+    OGRE_SWIZZLE(A8B8G8R8, B8G8R8A8, ABGR, BGRA),
+    OGRE_SWIZZLE(A8B8G8R8, R8G8B8A8, ABGR, RGBA),
+    OGRE_SWIZZLE(B8G8R8A8, A8R8G8B8, BGRA, ARGB),
+    OGRE_SWIZZLE(B8G8R8A8, A8B8G8R8, BGRA, ABGR),
+    OGRE_SWIZZLE(B8G8R8A8, R8G8B8A8, BGRA, RGBA),
+    OGRE_SWIZZLE(R8G8B8A8, A8R8G8B8, RGBA, ARGB),
+    OGRE_SWIZZLE(R8G8B8A8, A8B8G8R8, RGBA, ABGR),
+    OGRE_SWIZZLE(R8G8B8A8, B8G8R8A8, RGBA, BGRA),
+    OGRE_SWIZZLE(X8R8G8B8, A8R8G8B8, XRGB, ARGB),
+    OGRE_SWIZZLE(X8R8G8B8, A8B8G8R8, XRGB, ABGR),
+    OGRE_SWIZZLE(X8R8G8B8, B8G8R8A8, XRGB, BGRA),
+    OGRE_SWIZZLE(X8R8G8B8, R8G8B8A8, XRGB, RGBA),
+    OGRE_SWIZZLE(X8B8G8R8, A8R8G8B8, XBGR, ARGB),
+    OGRE_SWIZZLE(X8B8G8R8, A8B8G8R8, XBGR, ABGR),
+    OGRE_SWIZZLE(X8B8G8R8, B8G8R8A8, XBGR, BGRA),
+    OGRE_SWIZZLE(X8B8G8R8, R8G8B8A8, XBGR, RGBA),
+    OGRE_SWIZZLE(R8G8B8, A8R8G8B8, RGB, ARGB),
+    OGRE_SWIZZLE(R8G8B8, A8B8G8R8, RGB, ABGR),
+    OGRE_SWIZZLE(R8G8B8, B8G8R8A8, RGB, BGRA),
+    OGRE_SWIZZLE(R8G8B8, R8G8B8A8, RGB, RGBA),
+    OGRE_SWIZZLE(B8G8R8, A8R8G8B8, BGR, ARGB),
+    OGRE_SWIZZLE(B8G8R8, A8B8G8R8, BGR, ABGR),
+    OGRE_SWIZZLE(B8G8R8, B8G8R8A8, BGR, BGRA),
+    OGRE_SWIZZLE(B8G8R8, R8G8B8A8, BGR, RGBA),
+    OGRE_LUMINANCE(A8R8G8B8, ARGB),
+    OGRE_LUMINANCE(A8B8G8R8, ABGR),
+    OGRE_LUMINANCE(B8G8R8A8, BGRA),
+    OGRE_LUMINANCE(R8G8B8A8, RGBA),
+    OGRE_BYTES_FLOAT(A8R8G8B8, ARGB),
+    OGRE_BYTES_FLOAT(A8B8G8R8, ABGR),
+    OGRE_BYTES_FLOAT(B8G8R8A8, BGRA),
+    OGRE_BYTES_FLOAT(R8G8B8A8, RGBA),
+    { PF_X8R8G8B8, PF_FLOAT32_RGBA, BytesToFloat<LayoutXRGB>::convert },
+    { PF_X8B8G8R8, PF_FLOAT32_RGBA, BytesToFloat<LayoutXBGR>::convert },
+    { PF_R8G8B8, PF_FLOAT32_RGBA, BytesToFloat<LayoutRGB>::convert },
+    { PF_B8G8R8, PF_FLOAT32_RGBA, BytesToFloat<LayoutBGR>::convert },
+    OGRE_HALF_FLOAT(1, R),
+    OGRE_HALF_FLOAT(2, GR),
+    OGRE_HALF_FLOAT(3, RGB),
+    OGRE_HALF_FLOAT(4, RGBA)
+};
+
+#undef OGRE_SWIZZLE
+#undef OGRE_BYTES_FLOAT
+#undef OGRE_LUMINANCE
+#undef OGRE_HALF_FLOAT
+
+#endif
+
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -27,16 +27,95 @@ THE SOFTWARE.
 */
 #include "OgreStableHeaders.h"
 #include "OgrePixelFormat.h"
+#include "OgreBlockCompression.h"
 #include "OgreBitwise.h"
 #include "OgreColourValue.h"
 #include "OgreException.h"
 #include "OgrePixelFormatDescriptions.h"
+#include "OgrePlatformInformation.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+#include "Threading/OgreTaskScheduler.h"
 
 namespace {
 #include "OgrePixelConversions.h"
 }
+#include "OgrePixelConversionsSIMD.h"
 
 namespace Ogre {
+    namespace
+    {
+        /// Boxes with fewer pixels are converted on the calling thread
+        const size_t PARALLEL_CONVERSION_MIN_PIXELS = 256 * 1024;
+        /// Number of pixels worth converting in a task of their own
+        const size_t CONVERSION_GRAIN_PIXELS = 32 * 1024;
+
+        /// Vectorised conversion between the formats for this CPU, if any
+        RowConversion getRowConversion(PixelFormat srcFormat, PixelFormat dstFormat)
+        {
+#if OGRE_PIXELCONVERSION_SSE2
+            static const bool hasSSE2 =
+                (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE2) != 0;
+            if (hasSSE2)
+            {
+                const size_t numConverters = sizeof(sse2RowConverters) / sizeof(sse2RowConverters[0]);
+                for (size_t i = 0; i < numConverters; ++i)
+                {
+                    if (sse2RowConverters[i].srcFormat == srcFormat &&
+                        sse2RowConverters[i].dstFormat == dstFormat)
+                        return sse2RowConverters[i].convert;
+                }
+            }
+#endif
+            return 0;
+        }
+
+        /// Converts a box one row at a time
+        void convertRows(RowConversion convert, const PixelBox& src, const PixelBox& dst)
+        {
+            const size_t srcPixelSize = PixelUtil::getNumElemBytes(src.format);
+            const size_t dstPixelSize = PixelUtil::getNumElemBytes(dst.format);
+            const uint8* srcptr = static_cast<const uint8*>(src.data)
+                + (src.left + src.top * src.rowPitch + src.front * src.slicePitch) * srcPixelSize;
+            uint8* dstptr = static_cast<uint8*>(dst.data)
+                + (dst.left + dst.top * dst.rowPitch + dst.front * dst.slicePitch) * dstPixelSize;
+
+            const size_t width = src.getWidth();
+            for (size_t z = 0; z < src.getDepth(); ++z)
+            {
+                for (size_t y = 0; y < src.getHeight(); ++y)
+                {
+                    convert(srcptr + (z * src.slicePitch + y * src.rowPitch) * srcPixelSize,
+                        dstptr + (z * dst.slicePitch + y * dst.rowPitch) * dstPixelSize, width);
+                }
+            }
+        }
+
+        /// Converts stripes of rows of a box, indices running over the rows of every slice
+        struct ConvertStripes
+        {
+            const PixelBox* src;
+            const PixelBox* dst;
+
+            void operator()(size_t begin, size_t end) const
+            {
+                const size_t height = src->getHeight();
+                while (begin < end)
+                {
+                    const size_t z = begin / height;
+                    const size_t y = begin - z * height;
+                    const size_t rows = std::min(height - y, end - begin);
+                    PixelBox srcStripe = src->getSubVolume(Box(src->left, src->top + y, src->front + z,
+                        src->right, src->top + y + rows, src->front + z + 1));
+                    PixelBox dstStripe = dst->getSubVolume(Box(dst->left, dst->top + y, dst->front + z,
+                        dst->right, dst->top + y + rows, dst->front + z + 1));
+                    // Stripes are too small to be split again
+                    PixelUtil::bulkPixelConversion(srcStripe, dstStripe);
+                    begin += rows;
+                }
+            }
+        };
+    }
 
     //-----------------------------------------------------------------------
     size_t PixelBox::getConsecutiveSize() const
@@ -136,8 +215,9 @@ namespace Ogre {
 
                 case PF_ETC1_RGB8:
                 case PF_ETC2_RGB8:
-                case PF_ETC2_RGBA8:
                 case PF_ETC2_RGB8A1:
+                    return ((width + 3) / 4) * ((height + 3) / 4) * 8;
+                case PF_ETC2_RGBA8:
                     return ((width * height) >> 1);
                 case PF_ATC_RGB:
                     return ((width + 3) / 4) * ((height + 3) / 4) * 8;
@@ -697,7 +777,26 @@ namespace Ogre {
                src.getHeight() == dst.getHeight() &&
                src.getDepth() == dst.getDepth());
 
-        // Check for compressed formats, we don't support decompression, compression or recoding
+        // Large boxes are converted in stripes of rows on the scheduler of the
+        // Root's work queue, if it has one
+        const size_t numRows = src.getHeight() * src.getDepth();
+        if(numRows > 1 && src.getWidth() * numRows >= PARALLEL_CONVERSION_MIN_PIXELS &&
+           !isCompressed(src.format) && !isCompressed(dst.format))
+        {
+            Root* root = Root::getSingletonPtr();
+            WorkQueue* queue = root ? root->getWorkQueue() : 0;
+            TaskScheduler* scheduler = queue ? queue->getTaskScheduler() : 0;
+            if(scheduler && scheduler->getNumThreads() > 0)
+            {
+                ConvertStripes stripes = { &src, &dst };
+                size_t grain = std::max<size_t>(CONVERSION_GRAIN_PIXELS / src.getWidth(), 1);
+                scheduler->parallelFor(0, numRows, grain, stripes);
+                return;
+            }
+        }
+
+        // Check for compressed formats, block compression handles the formats it
+        // can encode or decode, we don't support recoding
         if(PixelUtil::isCompressed(src.format) || PixelUtil::isCompressed(dst.format))
         {
             if(src.format == dst.format)
@@ -705,10 +804,21 @@ namespace Ogre {
                 memcpy(dst.data, src.data, src.getConsecutiveSize());
                 return;
             }
+            else if(!PixelUtil::isCompressed(src.format) && BlockCompression::canCompress(dst.format))
+            {
+                BlockCompression::compress(src, dst);
+                return;
+            }
+            else if(!PixelUtil::isCompressed(dst.format) && BlockCompression::canDecompress(src.format))
+            {
+                BlockCompression::decompress(src, dst);
+                return;
+            }
             else
             {
                 OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
-                    "This method can not be used to compress or decompress images",
+                    "This method can not be used to compress or decompress images from " +
+                    PixelUtil::getFormatName(src.format) + " to " + PixelUtil::getFormatName(dst.format),
                     "PixelUtil::bulkPixelConversion");
             }
         }
@@ -776,6 +886,13 @@ namespace Ogre {
             return;
         }
 
+        // Is there a vectorised conversion?
+        if(RowConversion convert = getRowConversion(src.format, dst.format))
+        {
+            convertRows(convert, src, dst);
+            return;
+        }
+
 // NB VC6 can't handle the templates required for optimised conversion, tough
 #if OGRE_COMPILER != OGRE_COMPILER_MSVC || OGRE_COMP_VER >= 1300
         // Is there a specialized, inlined, conversion?
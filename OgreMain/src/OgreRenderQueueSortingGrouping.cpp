@@ -36,6 +36,8 @@ namespace Ogre {
         RenderablePass, uint32> QueuedRenderableCollection::msRadixSorter1;
     RadixSort<QueuedRenderableCollection::RenderablePassList,
         RenderablePass, float> QueuedRenderableCollection::msRadixSorter2;
+    RadixSort<QueuedRenderableCollection::PassGroupEntryList,
+        QueuedRenderableCollection::PassGroupEntry, uint64> QueuedRenderableCollection::msRadixSorter3;
 
 
     //-----------------------------------------------------------------------
@@ -212,43 +214,13 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void RenderPriorityGroup::clear(void)
     {
-        // Delete queue groups which are using passes which are to be
-        // deleted, we won't need these any more and they clutter up 
-        // the list and can cause problems with future clones
-        {
-            // Hmm, a bit hacky but least obtrusive for now
-                    OGRE_LOCK_MUTEX(Pass::msPassGraveyardMutex);
-            const Pass::PassSet& graveyardList = Pass::getPassGraveyard();
-            Pass::PassSet::const_iterator gi, giend;
-            giend = graveyardList.end();
-            for (gi = graveyardList.begin(); gi != giend; ++gi)
-            {
-                removePassEntry(*gi);
-            }
-        }
+        // Pass group entries don't outlive the queue contents, so passes which
+        // are to be deleted or have their hashes recalculated need no separate
+        // removal; we do NOT clear the graveyard or the dirty list here, because
+        // it needs to be acted on for all groups, the parent queue takes care 
+        // of this afterwards
 
-        // Now remove any dirty passes, these will have their hashes recalculated
-        // by the parent queue after all groups have been processed
-        // If we don't do this, the std::map will become inconsistent for new insterts
-        {
-            // Hmm, a bit hacky but least obtrusive for now
-                    OGRE_LOCK_MUTEX(Pass::msDirtyHashListMutex);
-            const Pass::PassSet& dirtyList = Pass::getDirtyHashList();
-            Pass::PassSet::const_iterator di, diend;
-            diend = dirtyList.end();
-            for (di = dirtyList.begin(); di != diend; ++di)
-            {
-                removePassEntry(*di);
-            }
-        }
-        // NB we do NOT clear the graveyard or the dirty list here, because 
-        // it needs to be acted on for all groups, the parent queue takes 
-        // care of this afterwards
-
-        // Now empty the remaining collections
-        // Note that groups don't get deleted, just emptied hence the difference
-        // between the pass groups which are removed above, and clearing done
-        // here
+        // Now empty the collections
         mSolidsBasic.clear();
         mSolidsDecal.clear();
         mSolidsDiffuseSpecular.clear();
@@ -285,43 +257,27 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     QueuedRenderableCollection::~QueuedRenderableCollection(void)
     {
-        // destroy all the pass map entries (rather than clearing)
-        PassGroupRenderableMap::iterator i, iend;
-        iend = mGrouped.end();
-        for (i = mGrouped.begin(); i != iend; ++i)
-        {
-            // Free the list associated with this pass
-            OGRE_DELETE_T(i->second, RenderableList, MEMCATEGORY_SCENE_CONTROL);
-        }
-        
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::clear(void)
     {
-        PassGroupRenderableMap::iterator i, iend;
-        iend = mGrouped.end();
-        for (i = mGrouped.begin(); i != iend; ++i)
-        {
-            // Clear the list associated with this pass, but leave the pass entry
-            i->second->clear();
-        }
-
-        // Clear sorted list
+        // Clear grouped and sorted lists, the memory stays allocated
+        mGrouped.clear();
         mSortedDescending.clear();
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::removePassGroup(Pass* p)
     {
-        PassGroupRenderableMap::iterator i;
-
-        i = mGrouped.find(p);
-        if (i != mGrouped.end())
+        // Compact the entries which don't use this pass
+        PassGroupEntryList::iterator i, iend, dest;
+        iend = mGrouped.end();
+        dest = mGrouped.begin();
+        for (i = mGrouped.begin(); i != iend; ++i)
         {
-            // free memory
-            OGRE_DELETE_T(i->second, RenderableList, MEMCATEGORY_SCENE_CONTROL);
-            // erase from map
-            mGrouped.erase(i);
+            if (i->pass != p)
+                *dest++ = *i;
         }
+        mGrouped.erase(dest, iend);
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::sort(const Camera* cam)
@@ -358,7 +314,36 @@ namespace Ogre {
             }
         }
 
-        // Nothing needs to be done for pass groups, they auto-organise
+        if (mOrganisationMode & OM_PASS_GROUP)
+        {
+            // Fill in the depths, grouping by pass then going front to back
+            // within each pass reduces overdraw
+            PassGroupEntryList::iterator i, iend;
+            iend = mGrouped.end();
+            for (i = mGrouped.begin(); i != iend; ++i)
+            {
+                // The top bits of a positive float order the same way as the value
+                float depth = std::max(0.0f, 
+                    static_cast<float>(i->renderable->getSquaredViewDepth(cam)));
+                uint32 depthBits;
+                memcpy(&depthBits, &depth, sizeof(uint32));
+                i->depth = static_cast<uint16>(depthBits >> 16);
+            }
+
+            // Same tipping point as above; the radix sort skips the bytes of 
+            // the keys which are the same for every entry, and is stable, so 
+            // sorting on the pass and depth first leaves them ordered within 
+            // each key
+            if (mGrouped.size() > 2000)
+            {
+                msRadixSorter3.sort(mGrouped, RadixSortFunctorPassDepth());
+                msRadixSorter3.sort(mGrouped, RadixSortFunctorKey());
+            }
+            else
+            {
+                std::stable_sort(mGrouped.begin(), mGrouped.end(), PassGroupKeyLess());
+            }
+        }
 
     }
     //-----------------------------------------------------------------------
@@ -372,24 +357,8 @@ namespace Ogre {
 
         if (mOrganisationMode & OM_PASS_GROUP)
         {
-            PassGroupRenderableMap::iterator i = mGrouped.find(pass);
-            if (i == mGrouped.end())
-            {
-                std::pair<PassGroupRenderableMap::iterator, bool> retPair;
-                // Create new pass entry, build a new list
-                // Note that this pass and list are never destroyed until the 
-                // engine shuts down, or a pass is destroyed or has it's hash
-                // recalculated, although the lists will be cleared
-                retPair = mGrouped.insert(
-                    PassGroupRenderableMap::value_type(
-                        pass, OGRE_NEW_T(RenderableList, MEMCATEGORY_SCENE_CONTROL)() ));
-                assert(retPair.second && 
-                    "Error inserting new pass entry into PassGroupRenderableMap");
-                i = retPair.first;
-            }
-            // Insert renderable
-            i->second->push_back(rend);
-            
+            // The depth is filled in when sorting
+            mGrouped.push_back(PassGroupEntry(pass->getRenderStateKey(), pass, rend));
         }
         
     }
@@ -431,24 +400,25 @@ namespace Ogre {
     void QueuedRenderableCollection::acceptVisitorGrouped(
         QueuedRenderableVisitor* visitor) const
     {
-        PassGroupRenderableMap::const_iterator ipass, ipassend;
-        ipassend = mGrouped.end();
-        for (ipass = mGrouped.begin(); ipass != ipassend; ++ipass)
+        // Sorted entries with the same pass are adjacent, visit the pass 
+        // whenever it changes
+        const Pass* currentPass = 0;
+        bool skipPass = false;
+        PassGroupEntryList::const_iterator i, iend;
+        iend = mGrouped.end();
+        for (i = mGrouped.begin(); i != iend; ++i)
         {
-            // Fast bypass if this group is now empty
-            if (ipass->second->empty()) continue;
-
-            // Visit Pass - allow skip
-            if (!visitor->visit(ipass->first))
-                continue;
+            if (i->pass != currentPass)
+            {
+                currentPass = i->pass;
+                // Visit Pass - allow skip
+                skipPass = !visitor->visit(currentPass);
+            }
 
-            RenderableList* rendList = ipass->second;
-            RenderableList::const_iterator irend, irendend;
-            irendend = rendList->end();
-            for (irend = rendList->begin(); irend != irendend; ++irend)
+            if (!skipPass)
             {
                 // Visit Renderable
-                visitor->visit(const_cast<Renderable*>(*irend));
+                visitor->visit(i->renderable);
             }
         } 
 
@@ -485,28 +455,7 @@ namespace Ogre {
     {
         mSortedDescending.insert( mSortedDescending.end(), rhs.mSortedDescending.begin(), rhs.mSortedDescending.end() );
 
-        PassGroupRenderableMap::const_iterator srcGroup;
-        for( srcGroup = rhs.mGrouped.begin(); srcGroup != rhs.mGrouped.end(); ++srcGroup )
-        {
-            PassGroupRenderableMap::iterator dstGroup = mGrouped.find( srcGroup->first );
-            if (dstGroup == mGrouped.end())
-            {
-                std::pair<PassGroupRenderableMap::iterator, bool> retPair;
-                // Create new pass entry, build a new list
-                // Note that this pass and list are never destroyed until the 
-                // engine shuts down, or a pass is destroyed or has it's hash
-                // recalculated, although the lists will be cleared
-                retPair = mGrouped.insert(
-                    PassGroupRenderableMap::value_type(
-                        srcGroup->first, OGRE_NEW_T(RenderableList, MEMCATEGORY_SCENE_CONTROL)() ));
-                assert(retPair.second && 
-                    "Error inserting new pass entry into PassGroupRenderableMap");
-                dstGroup = retPair.first;
-            }
-
-            // Insert renderable
-            dstGroup->second->insert( dstGroup->second->end(), srcGroup->second->begin(), srcGroup->second->end() );
-        }
+        mGrouped.insert( mGrouped.end(), rhs.mGrouped.begin(), rhs.mGrouped.end() );
     }
 
 
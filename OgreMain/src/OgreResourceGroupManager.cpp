@@ -34,6 +34,10 @@ THE SOFTWARE.
 #include "OgreScriptLoader.h"
 #include "OgreSceneManager.h"
 #include "OgreResourceManager.h"
+#include "Threading/OgreTaskScheduler.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+#include "OgreFileSystem.h"
 
 namespace Ogre {
 
@@ -56,7 +60,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     ResourceGroupManager::ResourceGroupManager()
-        : mLoadingListener(0), mCurrentGroup(0)
+        : mLoadingListener(0), mNumScriptParsingThreads(1), mCurrentGroup(0)
     {
         // Create the 'General' group
         createResourceGroup(DEFAULT_RESOURCE_GROUP_NAME);
@@ -691,47 +695,44 @@ namespace Ogre {
 
         OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME); // lock group mutex
 
-        Archive* pArch = 0;
-        ResourceLocationIndex::iterator rit = grp->resourceIndexCaseSensitive.find(resourceName);
-        if (rit != grp->resourceIndexCaseSensitive.end())
+        if (!grp->prefetchedResources.empty())
+        {
+            PrefetchedResourceMap::iterator pi = grp->prefetchedResources.find(resourceName);
+            if (pi != grp->prefetchedResources.end())
+            {
+                // Read ahead, handed out once
+                DataStreamPtr stream = pi->second.stream;
+                grp->prefetchedResources.erase(pi);
+                if (mLoadingListener)
+                    mLoadingListener->resourceStreamOpened(resourceName, groupName, resourceBeingLoaded, stream);
+                return stream;
+            }
+        }
+
+        String lcaseResourceName;
+        Archive* pArch = grp->findInIndex(resourceName, lcaseResourceName);
+        if (pArch)
         {
             // Found in the index
-            pArch = rit->second;
             DataStreamPtr stream = pArch->open(resourceName);
             if (mLoadingListener)
                 mLoadingListener->resourceStreamOpened(resourceName, groupName, resourceBeingLoaded, stream);
             return stream;
         }
-        else 
+        else
         {
-            // try case insensitive
-            String lcResourceName = resourceName;
-            StringUtil::toLowerCase(lcResourceName);
-            rit = grp->resourceIndexCaseInsensitive.find(lcResourceName);
-            if (rit != grp->resourceIndexCaseInsensitive.end())
-            {
-                // Found in the index
-                pArch = rit->second;
-                DataStreamPtr stream = pArch->open(resourceName);
-                if (mLoadingListener)
-                    mLoadingListener->resourceStreamOpened(resourceName, groupName, resourceBeingLoaded, stream);
-                return stream;
-            }
-            else
+            // Search the hard way
+            LocationList::iterator li, liend;
+            liend = grp->locationList.end();
+            for (li = grp->locationList.begin(); li != liend; ++li)
             {
-                // Search the hard way
-                LocationList::iterator li, liend;
-                liend = grp->locationList.end();
-                for (li = grp->locationList.begin(); li != liend; ++li)
+                Archive* arch = (*li)->archive;
+                if (arch->exists(resourceName))
                 {
-                    Archive* arch = (*li)->archive;
-                    if (arch->exists(resourceName))
-                    {
-                        DataStreamPtr ptr = arch->open(resourceName);
-                        if (mLoadingListener)
-                            mLoadingListener->resourceStreamOpened(resourceName, groupName, resourceBeingLoaded, ptr);
-                        return ptr;
-                    }
+                    DataStreamPtr ptr = arch->open(resourceName);
+                    if (mLoadingListener)
+                        mLoadingListener->resourceStreamOpened(resourceName, groupName, resourceBeingLoaded, ptr);
+                    return ptr;
                 }
             }
         }
@@ -740,7 +741,7 @@ namespace Ogre {
         // Not found
         if (searchGroupsIfNotFound)
         {
-            ResourceGroup* foundGrp = findGroupContainingResourceImpl(resourceName); 
+            ResourceGroup* foundGrp = findGroupContainingResourceImpl(resourceName, lcaseResourceName);
             if (foundGrp)
             {
                 if (resourceBeingLoaded)
@@ -804,6 +805,153 @@ namespace Ogre {
         
     }
     //---------------------------------------------------------------------
+    namespace
+    {
+        /// A resource being read by ResourceGroupManager::prefetchResources
+        struct PrefetchItem
+        {
+            String name;
+            Archive* archive;
+            DataStreamPtr stream;
+        };
+        typedef vector<PrefetchItem>::type PrefetchItemList;
+
+        void readAhead(PrefetchItem& item)
+        {
+            try
+            {
+                // Read through the stream of the archive, mapped files included
+                DataStreamPtr stream = item.archive->open(item.name);
+                if (!stream.isNull())
+                    item.stream.bind(OGRE_NEW MemoryDataStream(item.name, stream));
+            }
+            catch (Exception&)
+            {
+                // Left to openResource to report
+                item.stream.setNull();
+            }
+        }
+
+        /// Reads a range of resources
+        struct PrefetchFunction
+        {
+            PrefetchItemList* items;
+
+            void operator()(size_t begin, size_t end) const
+            {
+                for (size_t i = begin; i < end; ++i)
+                    readAhead((*items)[i]);
+            }
+        };
+    }
+    //---------------------------------------------------------------------
+    void ResourceGroupManager::prefetchResources(const StringVector& resourceNames,
+        const String& groupName)
+    {
+        // Locate the resources
+        PrefetchItemList items, threadSafeItems;
+        {
+            OGRE_LOCK_AUTO_MUTEX;
+            ResourceGroup* grp = getResourceGroup(groupName);
+            if (!grp)
+            {
+                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, 
+                    "Cannot locate a resource group called '" + groupName + "'", 
+                    "ResourceGroupManager::prefetchResources");
+            }
+
+            OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME); // lock group mutex
+
+            for (StringVector::const_iterator i = resourceNames.begin(); i != resourceNames.end(); ++i)
+            {
+                if (grp->prefetchedResources.find(*i) != grp->prefetchedResources.end())
+                    continue;
+
+                PrefetchItem item;
+                item.name = *i;
+                String lcaseName;
+                item.archive = grp->findInIndex(*i, lcaseName);
+                for (LocationList::iterator li = grp->locationList.begin();
+                    !item.archive && li != grp->locationList.end(); ++li)
+                {
+                    if ((*li)->archive->exists(*i))
+                        item.archive = (*li)->archive;
+                }
+                if (!item.archive)
+                    continue;
+
+                // Other archives are read here, they may not be thread safe
+                if (dynamic_cast<FileSystemArchive*>(item.archive) || item.archive->getType() == "Zip")
+                    threadSafeItems.push_back(item);
+                else
+                    items.push_back(item);
+            }
+        }
+
+        for (PrefetchItemList::iterator i = items.begin(); i != items.end(); ++i)
+            readAhead(*i);
+
+        PrefetchFunction prefetch;
+        prefetch.items = &threadSafeItems;
+        Root* root = Root::getSingletonPtr();
+        WorkQueue* queue = root ? root->getWorkQueue() : 0;
+        TaskScheduler* scheduler = queue ? queue->getTaskScheduler() : 0;
+        DefaultWorkQueueBase* defaultQueue = dynamic_cast<DefaultWorkQueueBase*>(queue);
+        if (scheduler && scheduler->getNumThreads())
+        {
+            scheduler->parallelFor(0, threadSafeItems.size(), 4, prefetch);
+        }
+        else if (defaultQueue && threadSafeItems.size() > 4)
+        {
+            // The queue keeps its threads to itself, start as many for the occasion
+            TaskScheduler localScheduler;
+            localScheduler.startup(defaultQueue->getWorkerThreadCount());
+            localScheduler.parallelFor(0, threadSafeItems.size(), 4, prefetch);
+            localScheduler.shutdown();
+        }
+        else
+        {
+            prefetch(0, threadSafeItems.size());
+        }
+        items.insert(items.end(), threadSafeItems.begin(), threadSafeItems.end());
+
+        // Keep what was read, as long as its location is still part of the group
+        OGRE_LOCK_AUTO_MUTEX;
+        ResourceGroup* grp = getResourceGroup(groupName);
+        if (!grp)
+            return;
+
+        OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME); // lock group mutex
+
+        set<Archive*>::type archives;
+        for (LocationList::iterator li = grp->locationList.begin(); li != grp->locationList.end(); ++li)
+            archives.insert((*li)->archive);
+        for (PrefetchItemList::iterator i = items.begin(); i != items.end(); ++i)
+        {
+            if (!i->stream.isNull() && archives.find(i->archive) != archives.end())
+            {
+                PrefetchedResource& prefetched = grp->prefetchedResources[i->name];
+                prefetched.archive = i->archive;
+                prefetched.stream = i->stream;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void ResourceGroupManager::clearPrefetchedResources(const String& groupName)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        ResourceGroup* grp = getResourceGroup(groupName);
+        if (!grp)
+        {
+            OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, 
+                "Cannot locate a resource group called '" + groupName + "'", 
+                "ResourceGroupManager::clearPrefetchedResources");
+        }
+
+        OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME); // lock group mutex
+        grp->prefetchedResources.clear();
+    }
+    //---------------------------------------------------------------------
     DataStreamPtr ResourceGroupManager::createResource(const String& filename, 
         const String& groupName, bool overwrite, const String& locationPattern)
     {
@@ -1053,46 +1201,68 @@ namespace Ogre {
         // Fire scripting event
         fireResourceGroupScriptingStarted(grp->name, scriptCount);
 
-        // Iterate over scripts and parse
-        // Note we respect original ordering
-        for (ScriptLoaderFileList::iterator slfli = scriptLoaderFileList.begin();
-            slfli != scriptLoaderFileList.end(); ++slfli)
+        if (mNumScriptParsingThreads > 1 && !mLoadingListener && scriptCount > 1)
         {
-            ScriptLoader* su = slfli->first;
-            // Iterate over each list
-            for (FileListList::iterator flli = slfli->second->begin(); flli != slfli->second->end(); ++flli)
+            // Flatten the scripts, keeping the original ordering
+            ScriptLoaderFileVector scripts;
+            scripts.reserve(scriptCount);
+            for (ScriptLoaderFileList::iterator slfli = scriptLoaderFileList.begin();
+                slfli != scriptLoaderFileList.end(); ++slfli)
             {
-                // Iterate over each item in the list
-                for (FileInfoList::iterator fii = (*flli)->begin(); fii != (*flli)->end(); ++fii)
+                for (FileListList::iterator flli = slfli->second->begin(); flli != slfli->second->end(); ++flli)
                 {
-                    bool skipScript = false;
-                    fireScriptStarted(fii->filename, skipScript);
-                    if(skipScript)
+                    for (FileInfoList::iterator fii = (*flli)->begin(); fii != (*flli)->end(); ++fii)
                     {
-                        LogManager::getSingleton().logMessage(
-                            "Skipping script " + fii->filename);
+                        scripts.push_back(ScriptLoaderFile(slfli->first, &*fii));
                     }
-                    else
+                }
+            }
+            parseScriptsParallel(grp, scripts);
+        }
+        else
+        {
+            // Iterate over scripts and parse
+            // Note we respect original ordering
+            for (ScriptLoaderFileList::iterator slfli = scriptLoaderFileList.begin();
+                slfli != scriptLoaderFileList.end(); ++slfli)
+            {
+                ScriptLoader* su = slfli->first;
+                // Iterate over each list
+                for (FileListList::iterator flli = slfli->second->begin(); flli != slfli->second->end(); ++flli)
+                {
+                    // Iterate over each item in the list
+                    for (FileInfoList::iterator fii = (*flli)->begin(); fii != (*flli)->end(); ++fii)
                     {
-                        LogManager::getSingleton().logMessage(
-                            "Parsing script " + fii->filename);
-                        DataStreamPtr stream = fii->archive->open(fii->filename);
-                        if (!stream.isNull())
+                        bool skipScript = false;
+                        fireScriptStarted(fii->filename, skipScript);
+                        if(skipScript)
                         {
-                            if (mLoadingListener)
-                                mLoadingListener->resourceStreamOpened(fii->filename, grp->name, 0, stream);
-
-                            if(fii->archive->getType() == "FileSystem" && stream->size() <= 1024 * 1024)
+                            LogManager::getSingleton().logMessage(
+                                "Skipping script " + fii->filename);
+                        }
+                        else
+                        {
+                            LogManager::getSingleton().logMessage(
+                                "Parsing script " + fii->filename);
+                            DataStreamPtr stream = fii->archive->open(fii->filename);
+                            if (!stream.isNull())
                             {
-                                DataStreamPtr cachedCopy;
-                                cachedCopy.bind(OGRE_NEW MemoryDataStream(stream->getName(), stream));
-                                su->parseScript(cachedCopy, grp->name);
+                                if (mLoadingListener)
+                                    mLoadingListener->resourceStreamOpened(fii->filename, grp->name, 0, stream);
+
+                                if(fii->archive->getType() == "FileSystem" && stream->size() <= 1024 * 1024 &&
+                                   !dynamic_cast<MemoryDataStream*>(stream.get()))
+                                {
+                                    DataStreamPtr cachedCopy;
+                                    cachedCopy.bind(OGRE_NEW MemoryDataStream(stream->getName(), stream));
+                                    su->parseScript(cachedCopy, grp->name);
+                                }
+                                else
+                                    su->parseScript(stream, grp->name);
                             }
-                            else
-                                su->parseScript(stream, grp->name);
                         }
+                        fireScriptEnded(fii->filename, skipScript);
                     }
-                    fireScriptEnded(fii->filename, skipScript);
                 }
             }
         }
@@ -1102,6 +1272,143 @@ namespace Ogre {
             "Finished parsing scripts for resource group " + grp->name);
     }
     //-----------------------------------------------------------------------
+    namespace
+    {
+        /// A script parsed by ResourceGroupManager::parseScriptsParallel
+        struct ScriptEntry
+        {
+            ScriptLoader* loader;
+            const FileInfo* fileInfo;
+            /// The script read into memory, if its loader prepares scripts
+            DataStreamPtr stream;
+            ScriptLoader::PreparedScript* prepared;
+        };
+        typedef vector<ScriptEntry>::type ScriptEntryList;
+
+        /// Prepares a range of scripts
+        struct PrepareScriptsFunction
+        {
+            ScriptEntryList* scripts;
+            const String* groupName;
+
+            void operator()(size_t begin, size_t end) const
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    ScriptEntry& entry = (*scripts)[i];
+                    if (entry.stream.isNull())
+                        continue;
+                    try
+                    {
+                        entry.prepared = entry.loader->prepareScript(entry.stream, *groupName);
+                    }
+                    catch (...)
+                    {
+                        // Parsed again in turn, which raises the error at the
+                        // point it would have been raised without preparing
+                        entry.prepared = 0;
+                    }
+                }
+            }
+        };
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::parseScriptsParallel(ResourceGroup* grp, const ScriptLoaderFileVector& scriptFiles)
+    {
+        ScriptEntryList scripts(scriptFiles.size());
+        for (size_t i = 0; i < scriptFiles.size(); ++i)
+        {
+            scripts[i].loader = scriptFiles[i].first;
+            scripts[i].fileInfo = scriptFiles[i].second;
+            scripts[i].prepared = 0;
+        }
+
+        typedef set<ScriptLoader*>::type ScriptLoaderSet;
+        ScriptLoaderSet preparingLoaders;
+
+        try
+        {
+            for (ScriptEntryList::iterator i = scripts.begin(); i != scripts.end(); ++i)
+            {
+                if (preparingLoaders.find(i->loader) == preparingLoaders.end() &&
+                    i->loader->beginPreparingScripts())
+                {
+                    preparingLoaders.insert(i->loader);
+                }
+            }
+
+            // Archives aren't necessarily thread safe, so the scripts are all
+            // read here and parsed from memory
+            for (ScriptEntryList::iterator i = scripts.begin(); i != scripts.end(); ++i)
+            {
+                if (preparingLoaders.find(i->loader) == preparingLoaders.end())
+                    continue;
+                DataStreamPtr stream = i->fileInfo->archive->open(i->fileInfo->filename);
+                if (stream.isNull())
+                    continue;
+                if (dynamic_cast<MemoryDataStream*>(stream.get()))
+                    i->stream = stream;
+                else
+                    i->stream.bind(OGRE_NEW MemoryDataStream(stream->getName(), stream));
+            }
+
+            PrepareScriptsFunction prepare;
+            prepare.scripts = &scripts;
+            prepare.groupName = &grp->name;
+            TaskScheduler scheduler;
+            scheduler.startup(mNumScriptParsingThreads - 1);
+            scheduler.parallelFor(0, scripts.size(), 1, prepare);
+            scheduler.shutdown();
+
+            for (ScriptEntryList::iterator i = scripts.begin(); i != scripts.end(); ++i)
+            {
+                const String& filename = i->fileInfo->filename;
+                bool skipScript = false;
+                fireScriptStarted(filename, skipScript);
+                if(skipScript)
+                {
+                    LogManager::getSingleton().logMessage(
+                        "Skipping script " + filename);
+                }
+                else
+                {
+                    LogManager::getSingleton().logMessage(
+                        "Parsing script " + filename);
+                    if (i->prepared)
+                    {
+                        i->loader->parsePreparedScript(i->prepared, grp->name);
+                    }
+                    else
+                    {
+                        DataStreamPtr stream = i->stream;
+                        if (stream.isNull())
+                            stream = i->fileInfo->archive->open(filename);
+                        else
+                            stream->seek(0);
+                        if (!stream.isNull())
+                            i->loader->parseScript(stream, grp->name);
+                    }
+                }
+                fireScriptEnded(filename, skipScript);
+
+                OGRE_DELETE i->prepared;
+                i->prepared = 0;
+                i->stream.setNull();
+            }
+        }
+        catch (...)
+        {
+            for (ScriptEntryList::iterator i = scripts.begin(); i != scripts.end(); ++i)
+                OGRE_DELETE i->prepared;
+            for (ScriptLoaderSet::iterator i = preparingLoaders.begin(); i != preparingLoaders.end(); ++i)
+                (*i)->endPreparingScripts();
+            throw;
+        }
+
+        for (ScriptLoaderSet::iterator i = preparingLoaders.begin(); i != preparingLoaders.end(); ++i)
+            (*i)->endPreparingScripts();
+    }
+    //-----------------------------------------------------------------------
     void ResourceGroupManager::createDeclaredResources(ResourceGroup* grp)
     {
 
@@ -1313,6 +1620,8 @@ namespace Ogre {
             mCurrentGroup = grp;
             groupSet = true;
         }
+        // release what was read ahead
+        grp->prefetchedResources.clear();
         // delete all the load list entries
         ResourceGroup::LoadResourceOrderMap::iterator j, jend;
         jend = grp->loadResourceOrderMap.end();
@@ -1668,44 +1977,33 @@ namespace Ogre {
                 "ResourceGroupManager::resourceExists");
         }
 
-        return resourceExists(grp, resourceName);
+        String lcaseResourceName;
+        return resourceExists(grp, resourceName, lcaseResourceName);
     }
     //-----------------------------------------------------------------------
-    bool ResourceGroupManager::resourceExists(ResourceGroup* grp, const String& resourceName)
+    bool ResourceGroupManager::resourceExists(ResourceGroup* grp, const String& resourceName,
+        String& lcaseResourceName)
     {
 
             OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME); // lock group mutex
 
         // Try indexes first
-        ResourceLocationIndex::iterator rit = grp->resourceIndexCaseSensitive.find(resourceName);
-        if (rit != grp->resourceIndexCaseSensitive.end())
+        if (grp->findInIndex(resourceName, lcaseResourceName))
         {
             // Found in the index
             return true;
         }
-        else 
+        else
         {
-            // try case insensitive
-            String lcResourceName = resourceName;
-            StringUtil::toLowerCase(lcResourceName);
-            rit = grp->resourceIndexCaseInsensitive.find(lcResourceName);
-            if (rit != grp->resourceIndexCaseInsensitive.end())
-            {
-                // Found in the index
-                return true;
-            }
-            else
+            // Search the hard way
+            LocationList::iterator li, liend;
+            liend = grp->locationList.end();
+            for (li = grp->locationList.begin(); li != liend; ++li)
             {
-                // Search the hard way
-                LocationList::iterator li, liend;
-                liend = grp->locationList.end();
-                for (li = grp->locationList.begin(); li != liend; ++li)
+                Archive* arch = (*li)->archive;
+                if (arch->exists(resourceName))
                 {
-                    Archive* arch = (*li)->archive;
-                    if (arch->exists(resourceName))
-                    {
-                        return true;
-                    }
+                    return true;
                 }
             }
         }
@@ -1736,35 +2034,25 @@ namespace Ogre {
             OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME); // lock group mutex
 
         // Try indexes first
-        ResourceLocationIndex::iterator rit = grp->resourceIndexCaseSensitive.find(resourceName);
-        if (rit != grp->resourceIndexCaseSensitive.end())
+        String lcaseResourceName;
+        Archive* pArch = grp->findInIndex(resourceName, lcaseResourceName);
+        if (pArch)
         {
-            return rit->second->getModifiedTime(resourceName);
+            return pArch->getModifiedTime(resourceName);
         }
-        else 
+        else
         {
-            // try case insensitive
-            String lcResourceName = resourceName;
-            StringUtil::toLowerCase(lcResourceName);
-            rit = grp->resourceIndexCaseInsensitive.find(lcResourceName);
-            if (rit != grp->resourceIndexCaseInsensitive.end())
-            {
-                return rit->second->getModifiedTime(resourceName);
-            }
-            else
+            // Search the hard way
+            LocationList::iterator li, liend;
+            liend = grp->locationList.end();
+            for (li = grp->locationList.begin(); li != liend; ++li)
             {
-                // Search the hard way
-                LocationList::iterator li, liend;
-                liend = grp->locationList.end();
-                for (li = grp->locationList.begin(); li != liend; ++li)
-                {
-                    Archive* arch = (*li)->archive;
-                    time_t testTime = arch->getModifiedTime(resourceName);
+                Archive* arch = (*li)->archive;
+                time_t testTime = arch->getModifiedTime(resourceName);
 
-                    if (testTime > 0)
-                    {
-                        return testTime;
-                    }
+                if (testTime > 0)
+                {
+                    return testTime;
                 }
             }
         }
@@ -1773,7 +2061,7 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     ResourceGroupManager::ResourceGroup* 
-    ResourceGroupManager::findGroupContainingResourceImpl(const String& filename)
+    ResourceGroupManager::findGroupContainingResourceImpl(const String& filename, String& lcaseFilename)
     {
             OGRE_LOCK_AUTO_MUTEX;
 
@@ -1785,7 +2073,7 @@ namespace Ogre {
 
                 OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME); // lock group mutex
                 
-            if (resourceExists(grp, filename))
+            if (resourceExists(grp, filename, lcaseFilename))
                 return grp;
         }
         // Not found
@@ -1794,7 +2082,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     bool ResourceGroupManager::resourceExistsInAnyGroup(const String& filename)
     {
-        ResourceGroup* grp = findGroupContainingResourceImpl(filename);
+        String lcaseFilename;
+        ResourceGroup* grp = findGroupContainingResourceImpl(filename, lcaseFilename);
         if (!grp)
             return false;
         return true;
@@ -1802,7 +2091,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     const String& ResourceGroupManager::findGroupContainingResource(const String& filename)
     {
-        ResourceGroup* grp = findGroupContainingResourceImpl(filename);
+        String lcaseFilename;
+        ResourceGroup* grp = findGroupContainingResourceImpl(filename, lcaseFilename);
         if (!grp)
         {
             OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND,
@@ -1975,6 +2265,11 @@ namespace Ogre {
     {
         return mLoadingListener;
     }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::setNumScriptParsingThreads(size_t numThreads)
+    {
+        mNumScriptParsingThreads = std::max<size_t>(numThreads, 1);
+    }
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     void ResourceGroupManager::ResourceGroup::addToIndex(const String& filename, Archive* arch)
@@ -2009,6 +2304,16 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void ResourceGroupManager::ResourceGroup::removeFromIndex(Archive* arch)
     {
+        // Drop what was read ahead from the archive
+        PrefetchedResourceMap::iterator pi = this->prefetchedResources.begin();
+        while (pi != this->prefetchedResources.end())
+        {
+            if (pi->second.archive == arch)
+                this->prefetchedResources.erase(pi++);
+            else
+                ++pi;
+        }
+
         // Delete indexes
         ResourceLocationIndex::iterator rit, ritend;
         ritend = this->resourceIndexCaseInsensitive.end();
@@ -2040,6 +2345,29 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    Archive* ResourceGroupManager::ResourceGroup::findInIndex(const String& filename,
+        String& lcaseFilename) const
+    {
+        // internal, assumes mutex lock has already been obtained
+        ResourceLocationIndex::const_iterator i = this->resourceIndexCaseSensitive.find(filename);
+        if (i != this->resourceIndexCaseSensitive.end())
+            return i->second;
+
+        // try case insensitive, only folding the name if there are such archives
+        // and no earlier lookup of the same name did already
+        if (!this->resourceIndexCaseInsensitive.empty())
+        {
+            if (lcaseFilename.empty())
+            {
+                lcaseFilename = filename;
+                StringUtil::toLowerCase(lcaseFilename);
+            }
+            i = this->resourceIndexCaseInsensitive.find(lcaseFilename);
+            if (i != this->resourceIndexCaseInsensitive.end())
+                return i->second;
+        }
+        return 0;
+    }
     //-----------------------------------------------------------------------
     ScriptLoader::~ScriptLoader()
     {
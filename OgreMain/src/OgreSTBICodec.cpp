@@ -105,11 +105,20 @@ namespace Ogre {
     //---------------------------------------------------------------------
     Codec::DecodeResult STBIImageCodec::decode(DataStreamPtr& input) const
     {
-        // Buffer stream into memory (TODO: override IO functions instead?)
-        MemoryDataStream memStream(input, true);
+        // Decode in place if the stream is held in memory (eg. a mapped
+        // file), else buffer it into memory (TODO: override IO functions instead?)
+        MemoryDataStreamPtr buffered;
+        MemoryDataStream* memStream = dynamic_cast<MemoryDataStream*>(input.get());
+        if (!memStream)
+        {
+            buffered.bind(OGRE_NEW MemoryDataStream(input, true));
+            memStream = buffered.get();
+        }
+        uchar* pSrc = memStream->getCurrentPtr();
+        size_t srcSize = memStream->size() - memStream->tell();
 
         int width, height, components;
-        stbi_uc* pixelData = stbi_load_from_memory(memStream.getPtr(), static_cast<int>(memStream.size()), &width, &height, &components, 0);
+        stbi_uc* pixelData = stbi_load_from_memory(pSrc, static_cast<int>(srcSize), &width, &height, &components, 0);
         
         
         if (!pixelData)
@@ -64,11 +64,20 @@ THE SOFTWARE.
 #include "OgreLodListener.h"
 #include "OgreInstancedGeometry.h"
 #include "OgreUnifiedHighLevelGpuProgram.h"
+#include "OgreNodeTransformArray.h"
+#include "OgreSoftwareSkinningBatch.h"
+#include "Threading/OgreBarrier.h"
+#include "OgreSpatialLightIndex.h"
+#include "OgreSceneQueryBroadphase.h"
 
 // This class implements the most basic scene manager
 
 #include <cstdio>
 
+// Number of lights affecting the frustum from which _populateLightList uses
+// the spatial light index
+#define OGRE_SPATIAL_LIGHT_INDEX_THRESHOLD 8
+
 namespace Ogre {
 
 //-----------------------------------------------------------------------
@@ -88,6 +97,20 @@ mAmbientLight(ColourValue::Black),
 mCameraInProgress(0),
 mCurrentViewport(0),
 mSceneRoot(0),
+mParallelSceneGraphUpdate(false),
+mNodeTransformArray(0),
+mSceneGraphStructureVersion(0),
+mNodeTransformArrayVersion(0),
+mNodeTransformLevel(0),
+mParallelFrustumCulling(false),
+mCullCamera(0),
+mBatchedSoftwareSkinning(false),
+mSoftwareSkinningBatch(0),
+mGatherSoftwareSkinning(false),
+mNumWorkerThreads(1),
+mWorkerThreadsBarrier(0),
+mWorkerThreadTask(WTT_UPDATE_NODE_TRANSFORMS),
+mExitWorkerThreads(false),
 mSkyPlaneEntity(0),
 mSkyBoxObj(0),
 mSkyPlaneNode(0),
@@ -109,6 +132,11 @@ mResetIdentityProj(false),
 mNormaliseNormalsOnScale(true),
 mFlipCullingOnNegativeScale(true),
 mLightsDirtyCounter(0),
+mUseSpatialLightIndex(true),
+mLightIndex(0),
+mLightIndexDirtyCounter(0),
+mUseSceneQueryBroadphase(true),
+mSceneQueryBroadphase(0),
 mMovableNameGenerator("Ogre/MO"),
 mShadowCasterPlainBlackPass(0),
 mShadowReceiverPass(0),
@@ -151,8 +179,17 @@ mCameraRelativeRendering(false),
 mLastLightHash(0),
 mLastLightLimit(0),
 mLastLightHashGpuProgram(0),
-mGpuParamsDirty((uint16)GPV_ALL)
-{
+mGpuParamsDirty((uint16)GPV_ALL),
+mLastPassRequested(0),
+mLastPassSet(0),
+mLastPassRequestedChangeCount(0),
+mLastPassSetChangeCount(0),
+mLastPassIlluminationStage(IRS_NONE),
+mLastObjectPolygonMode(0),
+mLastObjectNormaliseNormals(-1),
+mRenderStateStatsFrame(0)
+{
+    memset(&mRenderStateStats, 0, sizeof(RenderStateStats));
 
     // init sky
     for (size_t i = 0; i < 5; ++i)
@@ -188,6 +225,7 @@ mGpuParamsDirty((uint16)GPV_ALL)
 SceneManager::~SceneManager()
 {
     fireSceneManagerDestroyed();
+    stopWorkerThreads();
     destroyShadowTextures();
     clearScene();
     destroyAllCameras();
@@ -212,6 +250,10 @@ SceneManager::~SceneManager()
     OGRE_DELETE mShadowCasterAABBQuery;
     OGRE_DELETE mRenderQueue;
     OGRE_DELETE mAutoParamDataSource;
+    OGRE_DELETE mNodeTransformArray;
+    OGRE_DELETE mSoftwareSkinningBatch;
+    OGRE_DELETE mLightIndex;
+    OGRE_DELETE mSceneQueryBroadphase;
 }
 //-----------------------------------------------------------------------
 RenderQueue* SceneManager::getRenderQueue(void)
@@ -343,7 +385,8 @@ void SceneManager::destroyCamera(const String& name)
             mShadowCamLightMapping.erase( camLightIt );
 
         // Notify render system
-        mDestRenderSystem->_notifyCameraRemoved(i->second);
+        if (mDestRenderSystem)
+            mDestRenderSystem->_notifyCameraRemoved(i->second);
         OGRE_DELETE i->second;
         mCameras.erase(i);
     }
@@ -427,10 +470,35 @@ bool SceneManager::lightLess::operator()(const Light* a, const Light* b) const
     return a->tempSquareDist < b->tempSquareDist;
 }
 //-----------------------------------------------------------------------
+static inline void addLightIfAffecting(Light* lt, const Vector3& position, Real radius,
+                                       uint32 lightMask, LightList& destList)
+{
+    // check whether or not this light is suppose to be taken into consideration for the current light mask set for this operation
+    if(!(lt->getLightMask() & lightMask))
+        return; //skip this light
+
+    // Calc squared distance
+    lt->_calcTempSquareDist(position);
+
+    if (lt->getType() == Light::LT_DIRECTIONAL)
+    {
+        // Always included
+        destList.push_back(lt);
+    }
+    else
+    {
+        // only add in-range lights
+        if (lt->isInLightRange(Sphere(position,radius)))
+        {
+            destList.push_back(lt);
+        }
+    }
+}
+//-----------------------------------------------------------------------
 void SceneManager::_populateLightList(const Vector3& position, Real radius, 
                                       LightList& destList, uint32 lightMask)
 {
-    // Really basic trawl of the lights, then sort
+    // Trawl of the lights near the position, then sort
     // Subclasses could do something smarter
 
     // Pick up the lights that affecting frustum only, which should has been
@@ -441,29 +509,32 @@ void SceneManager::_populateLightList(const Vector3& position, Real radius,
     destList.clear();
     destList.reserve(candidateLights.size());
 
-    LightList::const_iterator it;
-    for (it = candidateLights.begin(); it != candidateLights.end(); ++it)
+    if (mUseSpatialLightIndex && candidateLights.size() >= OGRE_SPATIAL_LIGHT_INDEX_THRESHOLD)
     {
-        Light* lt = *it;
-        // check whether or not this light is suppose to be taken into consideration for the current light mask set for this operation
-        if(!(lt->getLightMask() & lightMask))
-            continue; //skip this light
-
-        // Calc squared distance
-        lt->_calcTempSquareDist(position);
+        // Only test the lights the index finds near the sphere, in the same
+        // order as the candidate list so the result is unchanged
+        if (!mLightIndex)
+            mLightIndex = OGRE_NEW SpatialLightIndex();
+        if (mLightIndexDirtyCounter != mLightsDirtyCounter ||
+            mLightIndex->getNumLights() != candidateLights.size())
+        {
+            mLightIndex->build(candidateLights);
+            mLightIndexDirtyCounter = mLightsDirtyCounter;
+        }
 
-        if (lt->getType() == Light::LT_DIRECTIONAL)
+        mLightIndex->query(position, radius, mLightIndexQuery);
+        vector<uint32>::type::const_iterator i, iend = mLightIndexQuery.end();
+        for (i = mLightIndexQuery.begin(); i != iend; ++i)
         {
-            // Always included
-            destList.push_back(lt);
+            addLightIfAffecting(candidateLights[*i], position, radius, lightMask, destList);
         }
-        else
+    }
+    else
+    {
+        LightList::const_iterator it;
+        for (it = candidateLights.begin(); it != candidateLights.end(); ++it)
         {
-            // only add in-range lights
-            if (lt->isInLightRange(Sphere(position,radius)))
-            {
-                destList.push_back(lt);
-            }
+            addLightIfAffecting(*it, position, radius, lightMask, destList);
         }
     }
 
@@ -944,6 +1015,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
 
     if (!mSuppressRenderStateChanges || evenIfSuppressed)
     {
+        const Pass* requestedPass = pass;
         if (mIlluminationStage == IRS_RENDER_TO_TEXTURE && shadowDerivation)
         {
             // Derive a special shadow caster pass from this one
@@ -954,6 +1026,20 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
             pass = deriveShadowReceiverPass(pass);
         }
 
+        // Skip the state changes if this pass is still set and unchanged, e.g. 
+        // consecutive sorted objects which share a material
+        if (requestedPass == mLastPassRequested && pass == mLastPassSet &&
+            mIlluminationStage == mLastPassIlluminationStage &&
+            requestedPass->getRenderStateChangeCount() == mLastPassRequestedChangeCount &&
+            pass->getRenderStateChangeCount() == mLastPassSetChangeCount)
+        {
+            mAutoParamDataSource->setCurrentPass(pass);
+            mAutoParamDataSource->setPassNumber(pass->getIndex());
+            mGpuParamsDirty |= (uint16)GPV_GLOBAL;
+            ++mRenderStateStats.redundantPassChanges;
+            return pass;
+        }
+
         // Tell params about current pass
         mAutoParamDataSource->setCurrentPass(pass);
 
@@ -1281,6 +1367,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         mDestRenderSystem->setShadingType(pass->getShadingMode());
         // Polygon mode
         mDestRenderSystem->_setPolygonMode(pass->getPolygonMode());
+        mLastObjectPolygonMode = pass->getPolygonMode();
 
         // set pass number
         mAutoParamDataSource->setPassNumber( pass->getIndex() );
@@ -1288,6 +1375,14 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         // mark global params as dirty
         mGpuParamsDirty |= (uint16)GPV_GLOBAL;
 
+        // Remember what was set, after any texture unit changes made above
+        mLastPassRequested = requestedPass;
+        mLastPassSet = pass;
+        mLastPassRequestedChangeCount = requestedPass->getRenderStateChangeCount();
+        mLastPassSetChangeCount = pass->getRenderStateChangeCount();
+        mLastPassIlluminationStage = mIlluminationStage;
+        ++mRenderStateStats.passChanges;
+
     }
 
     return pass;
@@ -1369,6 +1464,16 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
     // However don't call setViewport just yet (see below)
     mCurrentViewport = vp;
 
+    // Render state counters cover a whole frame, which may render several scenes
+    unsigned long frameNumber = Root::getSingleton().getNextFrameNumber();
+    if (frameNumber != mRenderStateStatsFrame)
+    {
+        memset(&mRenderStateStats, 0, sizeof(RenderStateStats));
+        mRenderStateStatsFrame = frameNumber;
+    }
+    // Other scenes or the application may have changed state since we last rendered
+    _markRenderStateDirty();
+
 	// Set current draw buffer (default is CBT_BACK)
 	mDestRenderSystem->setDrawBuffer(mCurrentViewport->getDrawBuffer());
 	
@@ -1516,8 +1621,11 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
             // Parse the scene and tag visibles
             firePreFindVisibleObjects(vp);
+            mGatherSoftwareSkinning = mBatchedSoftwareSkinning;
             _findVisibleObjects(camera, &(camVisObjIt->second),
                 mIlluminationStage == IRS_RENDER_TO_TEXTURE? true : false);
+            mGatherSoftwareSkinning = false;
+            flushSoftwareSkinning();
             firePostFindVisibleObjects(vp);
 
             mAutoParamDataSource->setMainCamBoundsInfo(&(camVisObjIt->second));
@@ -2232,24 +2340,277 @@ void SceneManager::_updateSceneGraph(Camera* cam)
     // Process queued needUpdate calls 
     Node::processQueuedUpdates();
 
-    // Cascade down the graph updating transforms & world bounds
-    // In this implementation, just update from the root
-    // Smarter SceneManager subclasses may choose to update only
-    //   certain scene graph branches
-    getRootSceneNode()->_update(true, false);
+#if !OGRE_NODE_INHERIT_TRANSFORM
+    if (mParallelSceneGraphUpdate && isParallelSceneGraphUpdateSupported())
+    {
+        updateSceneGraphParallel();
+    }
+    else
+#endif
+    {
+        // Cascade down the graph updating transforms & world bounds
+        // In this implementation, just update from the root
+        // Smarter SceneManager subclasses may choose to update only
+        //   certain scene graph branches
+        getRootSceneNode()->_update(true, false);
+    }
 
     firePostUpdateSceneGraph(cam);
 }
 //-----------------------------------------------------------------------
+void SceneManager::refreshNodeTransformArray(void)
+{
+    if (!mNodeTransformArray || mNodeTransformArrayVersion != mSceneGraphStructureVersion)
+    {
+        if (!mNodeTransformArray)
+            mNodeTransformArray = OGRE_NEW NodeTransformArray();
+        mNodeTransformArray->rebuild(getRootSceneNode());
+        mNodeTransformArrayVersion = mSceneGraphStructureVersion;
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::updateSceneGraphParallel(void)
+{
+    refreshNodeTransformArray();
+
+    // Each level only depends on the previous one
+    const size_t numLevels = mNodeTransformArray->getNumLevels();
+    for (mNodeTransformLevel = 0; mNodeTransformLevel < numLevels; ++mNodeTransformLevel)
+    {
+        fireWorkerThreadsAndWait(WTT_UPDATE_NODE_TRANSFORMS);
+    }
+
+    // Raises the events the recursive update would have raised
+    mNodeTransformArray->finishUpdate();
+
+    // Bounds are merged bottom-up; scene managers commonly update their
+    // spatial structures from _updateBounds, so this stays single threaded
+    for (size_t level = numLevels; level-- > 0; )
+    {
+        const size_t numNodes = mNodeTransformArray->getNumNodes(level);
+        for (size_t i = 0; i < numNodes; ++i)
+        {
+            if (mNodeTransformArray->wasVisited(level, i))
+            {
+                static_cast<SceneNode*>(mNodeTransformArray->getNode(level, i))->_updateBounds();
+            }
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::setParallelSceneGraphUpdate(bool enabled)
+{
+    mParallelSceneGraphUpdate = enabled;
+    if (!mParallelSceneGraphUpdate && !mParallelFrustumCulling)
+    {
+        OGRE_DELETE mNodeTransformArray;
+        mNodeTransformArray = 0;
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::setParallelFrustumCulling(bool enabled)
+{
+    mParallelFrustumCulling = enabled;
+    if (!mParallelSceneGraphUpdate && !mParallelFrustumCulling)
+    {
+        OGRE_DELETE mNodeTransformArray;
+        mNodeTransformArray = 0;
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::setBatchedSoftwareSkinning(bool enabled)
+{
+    mBatchedSoftwareSkinning = enabled;
+    if (enabled && !mSoftwareSkinningBatch)
+        mSoftwareSkinningBatch = OGRE_NEW SoftwareSkinningBatch();
+}
+//-----------------------------------------------------------------------
+void SceneManager::flushSoftwareSkinning(void)
+{
+    if (!mSoftwareSkinningBatch || mSoftwareSkinningBatch->empty())
+        return;
+
+    fireWorkerThreadsAndWait(WTT_SOFTWARE_SKINNING);
+    mSoftwareSkinningBatch->finish();
+}
+//-----------------------------------------------------------------------
+void SceneManager::setNumWorkerThreads(size_t numThreads)
+{
+    numThreads = std::max<size_t>(numThreads, 1);
+    if (numThreads != mNumWorkerThreads)
+    {
+        stopWorkerThreads();
+        mNumWorkerThreads = numThreads;
+        startWorkerThreads();
+    }
+}
+//-----------------------------------------------------------------------
+unsigned long updateWorkerThread(ThreadHandle* threadHandle)
+{
+    SceneManager* sceneManager = reinterpret_cast<SceneManager*>(threadHandle->getUserParam());
+    return sceneManager->_updateWorkerThread(threadHandle);
+}
+THREAD_DECLARE(updateWorkerThread);
+//-----------------------------------------------------------------------
+void SceneManager::startWorkerThreads(void)
+{
+    if (mNumWorkerThreads <= 1)
+        return;
+
+    mExitWorkerThreads = false;
+    mWorkerThreadsBarrier = OGRE_NEW_T(Barrier, MEMCATEGORY_GENERAL)(mNumWorkerThreads);
+    mWorkerThreads.reserve(mNumWorkerThreads - 1);
+    for (size_t i = 1; i < mNumWorkerThreads; ++i)
+    {
+        mWorkerThreads.push_back(Threads::CreateThread(THREAD_GET(updateWorkerThread), i, this));
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::stopWorkerThreads(void)
+{
+    if (mWorkerThreads.empty())
+        return;
+
+    // Wake the threads up, they will see the exit flag and return
+    mExitWorkerThreads = true;
+    mWorkerThreadsBarrier->sync();
+    Threads::WaitForThreads(mWorkerThreads);
+    mWorkerThreads.clear();
+
+    OGRE_DELETE_T(mWorkerThreadsBarrier, Barrier, MEMCATEGORY_GENERAL);
+    mWorkerThreadsBarrier = 0;
+}
+//-----------------------------------------------------------------------
+void SceneManager::fireWorkerThreadsAndWait(WorkerThreadTask task)
+{
+    if (mWorkerThreads.empty())
+    {
+        executeWorkerThreadTask(task, 0, 1);
+        return;
+    }
+
+    mWorkerThreadTask = task;
+    mWorkerThreadsBarrier->sync(); // Wake up the worker threads
+    executeWorkerThreadTask(task, 0, mNumWorkerThreads);
+    mWorkerThreadsBarrier->sync(); // Wait for them to finish
+}
+//-----------------------------------------------------------------------
+unsigned long SceneManager::_updateWorkerThread(ThreadHandle* threadHandle)
+{
+    const size_t threadIdx = threadHandle->getThreadIdx();
+    for (;;)
+    {
+        mWorkerThreadsBarrier->sync();
+        if (mExitWorkerThreads)
+            break;
+
+        executeWorkerThreadTask(mWorkerThreadTask, threadIdx, mNumWorkerThreads);
+        mWorkerThreadsBarrier->sync();
+    }
+
+    return 0;
+}
+//-----------------------------------------------------------------------
+void SceneManager::executeWorkerThreadTask(WorkerThreadTask task, size_t threadIdx, size_t numThreads)
+{
+    switch (task)
+    {
+    case WTT_UPDATE_NODE_TRANSFORMS:
+        {
+            // Split the level in contiguous ranges, rounded up to 16 nodes to
+            // limit false sharing between threads
+            const size_t numNodes = mNodeTransformArray->getNumNodes(mNodeTransformLevel);
+            const size_t numPerThread = ((numNodes + numThreads - 1) / numThreads + 15) & ~size_t(15);
+            const size_t begin = std::min(threadIdx * numPerThread, numNodes);
+            const size_t end = std::min(begin + numPerThread, numNodes);
+            if (begin < end)
+                mNodeTransformArray->updateLevel(mNodeTransformLevel, begin, end);
+        }
+        break;
+    case WTT_CULL_FRUSTUM:
+        cullFrustumThread(threadIdx, numThreads);
+        break;
+    case WTT_SOFTWARE_SKINNING:
+        mSoftwareSkinningBatch->execute(threadIdx, numThreads);
+        break;
+    }
+}
+//-----------------------------------------------------------------------
 void SceneManager::_findVisibleObjects(
     Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
 {
+    if (mParallelFrustumCulling)
+    {
+        findVisibleObjectsParallel(cam, visibleBounds, onlyShadowCasters);
+        return;
+    }
+
     // Tell nodes to find, cascade down all nodes
     getRootSceneNode()->_findVisibleObjects(cam, getRenderQueue(), visibleBounds, true, 
         mDisplayNodes, onlyShadowCasters);
 
 }
 //-----------------------------------------------------------------------
+void SceneManager::findVisibleObjectsParallel(
+    Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+{
+    refreshNodeTransformArray();
+
+    // Bring the frustum planes up to date, so the worker threads only read them
+    cam->getFrustumPlane(FRUSTUM_PLANE_NEAR);
+
+    mCullCamera = cam;
+    mVisibleNodesPerThread.resize(mNumWorkerThreads);
+    fireWorkerThreadsAndWait(WTT_CULL_FRUSTUM);
+    mCullCamera = 0;
+
+    // Queue the visible nodes chunk by chunk, so the order does not depend
+    // on the thread timings
+    RenderQueue* queue = getRenderQueue();
+    for (size_t i = 0; i < mNumWorkerThreads; ++i)
+    {
+        SceneNodeArray::const_iterator it, itend;
+        itend = mVisibleNodesPerThread[i].end();
+        for (it = mVisibleNodesPerThread[i].begin(); it != itend; ++it)
+        {
+            (*it)->_addToRenderQueue(cam, queue, onlyShadowCasters, visibleBounds);
+            (*it)->_addDebugRenderablesToQueue(queue, mDisplayNodes);
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::cullFrustumThread(size_t threadIdx, size_t numThreads)
+{
+    SceneNodeArray& visibleNodes = mVisibleNodesPerThread[threadIdx];
+    visibleNodes.clear();
+
+    // The world bounds of a node enclose those of its descendants, so testing
+    // every node on its own finds the same nodes as the recursive search
+    const size_t numLevels = mNodeTransformArray->getNumLevels();
+    size_t numNodes = 0;
+    for (size_t level = 0; level < numLevels; ++level)
+        numNodes += mNodeTransformArray->getNumNodes(level);
+
+    const size_t numPerThread = (numNodes + numThreads - 1) / numThreads;
+    const size_t begin = std::min(threadIdx * numPerThread, numNodes);
+    const size_t end = std::min(begin + numPerThread, numNodes);
+
+    size_t levelStart = 0;
+    for (size_t level = 0; level < numLevels && levelStart < end; ++level)
+    {
+        const size_t levelSize = mNodeTransformArray->getNumNodes(level);
+        const size_t first = std::max(begin, levelStart) - levelStart;
+        const size_t last = std::min(end, levelStart + levelSize);
+        for (size_t i = first; i + levelStart < last; ++i)
+        {
+            SceneNode* node = static_cast<SceneNode*>(mNodeTransformArray->getNode(level, i));
+            if (mCullCamera->isVisible(node->_getWorldAABB()))
+                visibleNodes.push_back(node);
+        }
+        levelStart += levelSize;
+    }
+}
+//-----------------------------------------------------------------------
 void SceneManager::_renderVisibleObjects(void)
 {
     RenderQueueInvocationSequence* invocationSequence = 
@@ -3014,6 +3375,8 @@ void SceneManager::renderObjects(const QueuedRenderableCollection& objs,
     mActiveQueuedRenderableVisitor->manualLightList = manualLightList;
     mActiveQueuedRenderableVisitor->transparentShadowCastersMode = false;
     mActiveQueuedRenderableVisitor->scissoring = lightScissoringClipping;
+    // Shadow and light iteration code changes state between collections
+    _markRenderStateDirty();
     // Use visitor
     objs.acceptVisitor(mActiveQueuedRenderableVisitor, om);
 }
@@ -3206,11 +3569,13 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
         // Sort out normalisation
         // Assume first world matrix representative - shaders that use multiple
         // matrices should control renormalisation themselves
-        if ((pass->getNormaliseNormals() || mNormaliseNormalsOnScale)
-            && mTempXform[0].hasScale())
-            mDestRenderSystem->setNormaliseNormals(true);
-        else
-            mDestRenderSystem->setNormaliseNormals(false);
+        int normaliseNormals = ((pass->getNormaliseNormals() || mNormaliseNormalsOnScale)
+            && mTempXform[0].hasScale()) ? 1 : 0;
+        if (normaliseNormals != mLastObjectNormaliseNormals)
+        {
+            mDestRenderSystem->setNormaliseNormals(normaliseNormals != 0);
+            mLastObjectNormaliseNormals = normaliseNormals;
+        }
 
         // Sort out negative scaling
         // Assume first world matrix representative 
@@ -3253,7 +3618,11 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
                 reqMode = camPolyMode;
             }
         }
-        mDestRenderSystem->_setPolygonMode(reqMode);
+        if (reqMode != mLastObjectPolygonMode)
+        {
+            mDestRenderSystem->_setPolygonMode(reqMode);
+            mLastObjectPolygonMode = reqMode;
+        }
 
         if (doLightIteration)
         {
@@ -3351,6 +3720,8 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
                                 // Have to set TU on rendersystem right now, although
                                 // autoparams will be set later
                                 mDestRenderSystem->_setTextureUnitSettings(tuindex, *tu);
+                                // ... so the pass no longer matches what _setPass set
+                                _markRenderStateDirty();
                             }
                         }
 
@@ -3469,6 +3840,7 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
 
                     // Set modified depth bias right away
                     mDestRenderSystem->_setDepthBias(depthBiasBase, pass->getDepthBiasSlopeScale());
+                    _markRenderStateDirty();
 
                     // Set to increment internally too if rendersystem iterates
                     mDestRenderSystem->setDeriveDepthBias(true, 
@@ -3564,6 +3936,7 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
 			ro.renderStateHash = pass->getRenderStateHash();
             try
             {
+                ++mRenderStateStats.draws;
                 mDestRenderSystem->_render(ro);
             }
             catch (RenderingAPIException& e)
@@ -3609,6 +3982,8 @@ void SceneManager::setFog(FogMode mode, const ColourValue& colour, Real density,
     mFogStart = start;
     mFogEnd = end;
     mFogDensity = density;
+    // Passes take the scene fog when set
+    _markRenderStateDirty();
 }
 //-----------------------------------------------------------------------
 FogMode SceneManager::getFogMode(void) const
@@ -3830,6 +4205,8 @@ void SceneManager::manualRender(RenderOperation* rend,
                                 const Matrix4& viewMatrix, const Matrix4& projMatrix, 
                                 bool doBeginEndFrame) 
 {
+    // May be called outside scene rendering, so don't trust the current state
+    _markRenderStateDirty();
     if (vp)
         mDestRenderSystem->_setViewport(vp);
 
@@ -3859,6 +4236,7 @@ void SceneManager::manualRender(RenderOperation* rend,
         updateGpuProgramParameters(pass);
     }
 	rend->renderStateHash = pass->getRenderStateHash();
+    ++mRenderStateStats.draws;
     mDestRenderSystem->_render(*rend);
 
     if (doBeginEndFrame)
@@ -3871,6 +4249,8 @@ void SceneManager::manualRender(Renderable* rend, const Pass* pass, Viewport* vp
     const Matrix4& projMatrix,bool doBeginEndFrame,
     bool lightScissoringClipping, bool doLightIteration, const LightList* manualLightList)
 {
+    // May be called outside scene rendering, so don't trust the current state
+    _markRenderStateDirty();
     if (vp)
         mDestRenderSystem->_setViewport(vp);
 
@@ -4119,6 +4499,9 @@ void SceneManager::fireRenderSingleObject(Renderable* rend, const Pass* pass,
     {
         (*i)->notifyRenderSingleObject(rend, pass, source, pLightList, suppressRenderStateChanges);
     }
+    // Listeners may change render state
+    if (!mRenderObjectListeners.empty())
+        _markRenderStateDirty();
 }
 //---------------------------------------------------------------------
 void SceneManager::fireShadowTexturesUpdated(size_t numberOfShadowTextures)
@@ -4307,6 +4690,7 @@ void SceneManager::_suppressShadows(bool suppress)
 void SceneManager::_suppressRenderStateChanges(bool suppress)
 {
     mSuppressRenderStateChanges = suppress;
+    _markRenderStateDirty();
 }
 //---------------------------------------------------------------------
 void SceneManager::updateRenderQueueSplitOptions(void)
@@ -5706,6 +6090,8 @@ void SceneManager::renderShadowVolumesToStencil(const Light* light,
     mDestRenderSystem->setStencilCheckEnabled(false);
 
     mDestRenderSystem->unbindGpuProgram(GPT_VERTEX_PROGRAM);
+    // state no longer matches the last pass set
+    _markRenderStateDirty();
 
     if (scissored == CLIPPED_SOME)
     {
@@ -6472,6 +6858,7 @@ void SceneManager::_resumeRendering(SceneManager::RenderContext* context)
     }
     mCameraInProgress = context->camera;
     mDestRenderSystem->_resumeFrame(context->rsContext);
+    _markRenderStateDirty();
 
     // Set rasterisation mode
     mDestRenderSystem->_setPolygonMode(mCameraInProgress->getPolygonMode());
@@ -6800,6 +7187,48 @@ void SceneManager::destroyQuery(SceneQuery* query)
     OGRE_DELETE query;
 }
 //---------------------------------------------------------------------
+void SceneManager::setUseSceneQueryBroadphase(bool enabled)
+{
+    mUseSceneQueryBroadphase = enabled;
+    if (!enabled)
+    {
+        OGRE_DELETE mSceneQueryBroadphase;
+        mSceneQueryBroadphase = 0;
+    }
+}
+//---------------------------------------------------------------------
+SceneQueryBroadphase* SceneManager::_updateSceneQueryBroadphase(void)
+{
+    if (!mUseSceneQueryBroadphase)
+        return 0;
+
+    if (!mSceneQueryBroadphase)
+    {
+        mSceneQueryBroadphase = OGRE_NEW SceneQueryBroadphase(this);
+
+        // Register the objects the queries iterated over, those of the
+        // types with a factory; the collections keep it up to date
+        OGRE_LOCK_MUTEX(mMovableObjectCollectionMapMutex);
+        Root& root = Root::getSingleton();
+        for (MovableObjectCollectionMap::iterator ci = mMovableObjectCollectionMap.begin();
+            ci != mMovableObjectCollectionMap.end(); ++ci)
+        {
+            if (!root.hasMovableObjectFactory(ci->first))
+                continue;
+
+            OGRE_LOCK_MUTEX(ci->second->mutex);
+            MovableObjectMap& objects = ci->second->map;
+            for (MovableObjectMap::iterator i = objects.begin(); i != objects.end(); ++i)
+            {
+                mSceneQueryBroadphase->addObject(i->second);
+            }
+        }
+    }
+
+    mSceneQueryBroadphase->update();
+    return mSceneQueryBroadphase;
+}
+//---------------------------------------------------------------------
 SceneManager::MovableObjectCollection* 
 SceneManager::getMovableObjectCollection(const String& typeName)
 {
@@ -6867,6 +7296,8 @@ MovableObject* SceneManager::createMovableObject(const String& name,
 
         MovableObject* newObj = factory->createInstance(name, this, params);
         objectMap->map[name] = newObj;
+        if (mSceneQueryBroadphase)
+            mSceneQueryBroadphase->addObject(newObj);
         return newObj;
     }
 
@@ -6896,6 +7327,8 @@ void SceneManager::destroyMovableObject(const String& name, const String& typeNa
         MovableObjectMap::iterator mi = objectMap->map.find(name);
         if (mi != objectMap->map.end())
         {
+            if (mSceneQueryBroadphase)
+                mSceneQueryBroadphase->removeObject(mi->second);
             factory->destroyInstance(mi->second);
             objectMap->map.erase(mi);
         }
@@ -6919,6 +7352,8 @@ void SceneManager::destroyAllMovableObjectsByType(const String& typeName)
         MovableObjectMap::iterator i = objectMap->map.begin();
         for (; i != objectMap->map.end(); ++i)
         {
+            if (mSceneQueryBroadphase)
+                mSceneQueryBroadphase->removeObject(i->second);
             // Only destroy our own
             if (i->second->_getManager() == this)
             {
@@ -6934,6 +7369,10 @@ void SceneManager::destroyAllMovableObjects(void)
     // Lock collection mutex
     OGRE_LOCK_MUTEX(mMovableObjectCollectionMapMutex);
 
+    // Every registered object goes
+    if (mSceneQueryBroadphase)
+        mSceneQueryBroadphase->removeAllObjects();
+
     MovableObjectCollectionMap::iterator ci = mMovableObjectCollectionMap.begin();
 
     for(;ci != mMovableObjectCollectionMap.end(); ++ci)
@@ -7030,6 +7469,8 @@ void SceneManager::injectMovableObject(MovableObject* m)
             OGRE_LOCK_MUTEX(objectMap->mutex);
 
         objectMap->map[m->getName()] = m;
+        if (mSceneQueryBroadphase && Root::getSingleton().hasMovableObjectFactory(m->getMovableType()))
+            mSceneQueryBroadphase->addObject(m);
     }
 }
 //---------------------------------------------------------------------
@@ -7041,6 +7482,8 @@ void SceneManager::extractMovableObject(const String& name, const String& typeNa
         MovableObjectMap::iterator mi = objectMap->map.find(name);
         if (mi != objectMap->map.end())
         {
+            if (mSceneQueryBroadphase)
+                mSceneQueryBroadphase->removeObject(mi->second);
             // no delete
             objectMap->map.erase(mi);
         }
@@ -7058,6 +7501,11 @@ void SceneManager::extractAllMovableObjectsByType(const String& typeName)
     MovableObjectCollection* objectMap = getMovableObjectCollection(typeName);
     {
             OGRE_LOCK_MUTEX(objectMap->mutex);
+        if (mSceneQueryBroadphase)
+        {
+            for (MovableObjectMap::iterator i = objectMap->map.begin(); i != objectMap->map.end(); ++i)
+                mSceneQueryBroadphase->removeObject(i->second);
+        }
         // no deletion
         objectMap->map.clear();
     }
@@ -7067,6 +7515,8 @@ void SceneManager::_injectRenderWithPass(Pass *pass, Renderable *rend, bool shad
     bool doLightIteration, const LightList* manualLightList)
 {
     // render something as if it came from the current queue
+    // the caller may have changed state directly since the last pass
+    _markRenderStateDirty();
     const Pass *usedPass = _setPass(pass, false, shadowDerivation);
     renderSingleObject(rend, usedPass, false, doLightIteration, manualLightList);
 }
@@ -7269,6 +7719,7 @@ void SceneManager::bindGpuProgram(GpuProgram* prog)
     // Hash == 1 is almost impossible to achieve otherwise
     mLastLightHashGpuProgram = 1;
     mGpuParamsDirty = (uint16)GPV_ALL;
+    ++mRenderStateStats.gpuProgramBinds;
     mDestRenderSystem->bindGpuProgram(prog);
 }
 //---------------------------------------------------------------------
@@ -7277,6 +7728,13 @@ void SceneManager::_markGpuParamsDirty(uint16 mask)
     mGpuParamsDirty |= mask;
 }
 //---------------------------------------------------------------------
+void SceneManager::_markRenderStateDirty(void)
+{
+    mLastPassRequested = 0;
+    mLastObjectPolygonMode = 0;
+    mLastObjectNormaliseNormals = -1;
+}
+//---------------------------------------------------------------------
 void SceneManager::updateGpuProgramParameters(const Pass* pass)
 {
     if (pass->isProgrammable())
@@ -7339,7 +7797,10 @@ void SceneManager::_issueRenderOp(const Pass* pass, Renderable* rend, bool passT
 		 ro.renderStateHash = pass->getRenderStateHash();		 
 
         if (rend->preRender(this, mDestRenderSystem))
+        {
+            ++mRenderStateStats.draws;
             mDestRenderSystem->_render(ro);
+        }
         
         rend->postRender(this, mDestRenderSystem);
 }
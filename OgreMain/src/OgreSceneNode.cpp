@@ -88,6 +88,9 @@ namespace Ogre {
     {
         Node::setParent(parent);
 
+        if (mCreator)
+            mCreator->_notifySceneGraphStructureChanged();
+
         if (parent)
         {
             SceneNode* sceneParent = static_cast<SceneNode*>(parent);
@@ -279,14 +282,7 @@ namespace Ogre {
             return;
 
         // Add all entities
-        ObjectMap::iterator iobj;
-        ObjectMap::iterator iobjend = mObjectsByName.end();
-        for (iobj = mObjectsByName.begin(); iobj != iobjend; ++iobj)
-        {
-            MovableObject* mo = iobj->second;
-
-            queue->processVisibleObject(mo, cam, onlyShadowCasters, visibleBounds);
-        }
+        _addToRenderQueue(cam, queue, onlyShadowCasters, visibleBounds);
 
         if (includeChildren)
         {
@@ -300,6 +296,24 @@ namespace Ogre {
             }
         }
 
+        _addDebugRenderablesToQueue(queue, displayNodes);
+    }
+    //-----------------------------------------------------------------------
+    void SceneNode::_addToRenderQueue(Camera* cam, RenderQueue* queue,
+        bool onlyShadowCasters, VisibleObjectsBoundsInfo* visibleBounds)
+    {
+        ObjectMap::iterator iobj;
+        ObjectMap::iterator iobjend = mObjectsByName.end();
+        for (iobj = mObjectsByName.begin(); iobj != iobjend; ++iobj)
+        {
+            MovableObject* mo = iobj->second;
+
+            queue->processVisibleObject(mo, cam, onlyShadowCasters, visibleBounds);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneNode::_addDebugRenderablesToQueue(RenderQueue* queue, bool displayNodes)
+    {
         if (displayNodes)
         {
             // Include self in the render queue
@@ -352,7 +366,11 @@ namespace Ogre {
     void SceneNode::updateFromParentImpl(void) const
     {
         Node::updateFromParentImpl();
-
+        derivedTransformUpdatedImpl();
+    }
+    //-----------------------------------------------------------------------
+    void SceneNode::derivedTransformUpdatedImpl(void) const
+    {
         // Notify objects that it has been moved
         ObjectMap::const_iterator i;
         for (i = mObjectsByName.begin(); i != mObjectsByName.end(); ++i)
@@ -0,0 +1,754 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreSceneQueryBroadphase.h"
+#include "OgreMovableObject.h"
+#include "OgreNode.h"
+#include "OgreRay.h"
+#include "OgreSphere.h"
+
+namespace Ogre {
+
+    /// Depth of the traversal stack, balanced trees stay far below it
+    static const size_t MAX_TREE_DEPTH = 256;
+    //-----------------------------------------------------------------------
+    static inline Real getArea(const Vector3& minimum, const Vector3& maximum)
+    {
+        // Half the surface area, only compared with each other
+        const Vector3 d = maximum - minimum;
+        return d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+    //-----------------------------------------------------------------------
+    static inline Real getMergedArea(const Vector3& minA, const Vector3& maxA,
+        const Vector3& minB, const Vector3& maxB)
+    {
+        Vector3 minimum = minA, maximum = maxA;
+        minimum.makeFloor(minB);
+        maximum.makeCeil(maxB);
+        return getArea(minimum, maximum);
+    }
+    //-----------------------------------------------------------------------
+    /// Accepts the nodes overlapping a box
+    struct BoxTest
+    {
+        Vector3 minimum;
+        Vector3 maximum;
+
+        bool operator()(const Vector3& nodeMin, const Vector3& nodeMax) const
+        {
+            return nodeMin.x <= maximum.x && nodeMax.x >= minimum.x &&
+                nodeMin.y <= maximum.y && nodeMax.y >= minimum.y &&
+                nodeMin.z <= maximum.z && nodeMax.z >= minimum.z;
+        }
+    };
+    //-----------------------------------------------------------------------
+    /// Accepts the nodes overlapping a sphere
+    struct SphereTest
+    {
+        Vector3 centre;
+        Real radiusSquared;
+
+        bool operator()(const Vector3& nodeMin, const Vector3& nodeMax) const
+        {
+            Vector3 closest = centre;
+            closest.makeCeil(nodeMin);
+            closest.makeFloor(nodeMax);
+            return closest.squaredDistance(centre) <= radiusSquared;
+        }
+    };
+    //-----------------------------------------------------------------------
+    /// Accepts the nodes hit by a ray, with the slab test
+    struct RayTest
+    {
+        Vector3 origin;
+        Vector3 direction;
+        Vector3 invDirection;
+
+        bool operator()(const Vector3& nodeMin, const Vector3& nodeMax) const
+        {
+            Real tMin = 0;
+            Real tMax = Math::POS_INFINITY;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (direction[axis] == 0)
+                {
+                    if (origin[axis] < nodeMin[axis] || origin[axis] > nodeMax[axis])
+                        return false;
+                }
+                else
+                {
+                    Real t1 = (nodeMin[axis] - origin[axis]) * invDirection[axis];
+                    Real t2 = (nodeMax[axis] - origin[axis]) * invDirection[axis];
+                    if (t1 > t2)
+                        std::swap(t1, t2);
+                    tMin = std::max(tMin, t1);
+                    tMax = std::min(tMax, t2);
+                    if (tMin > tMax)
+                        return false;
+                }
+            }
+            return true;
+        }
+    };
+    //-----------------------------------------------------------------------
+    /// Accepts the nodes intersecting any of a list of volumes
+    struct VolumeTest
+    {
+        const PlaneBoundedVolumeList* volumes;
+
+        bool operator()(const Vector3& nodeMin, const Vector3& nodeMax) const
+        {
+            const Vector3 centre = (nodeMin + nodeMax) * 0.5f;
+            const Vector3 halfSize = (nodeMax - nodeMin) * 0.5f;
+            for (PlaneBoundedVolumeList::const_iterator v = volumes->begin(); v != volumes->end(); ++v)
+            {
+                PlaneBoundedVolume::PlaneList::const_iterator p = v->planes.begin();
+                for (; p != v->planes.end(); ++p)
+                {
+                    if (p->getSide(centre, halfSize) == v->outside)
+                        break;
+                }
+                if (p == v->planes.end())
+                    return true;
+            }
+            return false;
+        }
+    };
+    //-----------------------------------------------------------------------
+    SceneQueryBroadphase::SceneQueryBroadphase(SceneManager* owner)
+        : mOwner(owner)
+        , mMarginFactor(0.1f)
+        , mRoot(-1)
+        , mFreeNode(-1)
+        , mNumObjects(0)
+    {
+    }
+    //-----------------------------------------------------------------------
+    SceneQueryBroadphase::~SceneQueryBroadphase()
+    {
+        removeAllObjects();
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadphase::addObject(MovableObject* obj)
+    {
+        OGRE_LOCK_MUTEX(mMutex);
+
+        // Movements are only notified to the manager of the object
+        if (obj->_getManager() != mOwner)
+        {
+            mForeignObjects.push_back(obj);
+            return;
+        }
+        if (obj->_getSceneQueryProxy() != NO_PROXY)
+            return;
+
+        uint32 index;
+        if (!mFreeProxies.empty())
+        {
+            index = mFreeProxies.back();
+            mFreeProxies.pop_back();
+        }
+        else
+        {
+            index = static_cast<uint32>(mProxies.size());
+            Proxy proxy;
+            proxy.dirty = false;
+            mProxies.push_back(proxy);
+        }
+
+        Proxy& proxy = mProxies[index];
+        proxy.object = obj;
+        proxy.leaf = -1;
+        proxy.unbounded = false;
+        // Inserted on the next update, once the bounds are known
+        if (!proxy.dirty)
+        {
+            proxy.dirty = true;
+            mDirtyProxies.push_back(index);
+        }
+        obj->_setSceneQueryProxy(index);
+        ++mNumObjects;
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadphase::removeObject(MovableObject* obj)
+    {
+        OGRE_LOCK_MUTEX(mMutex);
+
+        if (obj->_getManager() != mOwner)
+        {
+            ObjectList::iterator i = std::find(mForeignObjects.begin(), mForeignObjects.end(), obj);
+            if (i != mForeignObjects.end())
+                mForeignObjects.erase(i);
+            return;
+        }
+
+        const uint32 index = obj->_getSceneQueryProxy();
+        if (index == NO_PROXY)
+            return;
+
+        Proxy& proxy = mProxies[index];
+        if (proxy.leaf != -1)
+        {
+            removeLeaf(proxy.leaf);
+            freeNode(proxy.leaf);
+            proxy.leaf = -1;
+        }
+        setUnbounded(index, false);
+        // A pending entry in mDirtyProxies skips the empty slot, or refreshes
+        // the object reusing it
+        proxy.object = 0;
+        mFreeProxies.push_back(index);
+        --mNumObjects;
+        obj->_setSceneQueryProxy(NO_PROXY);
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadphase::removeAllObjects(void)
+    {
+        OGRE_LOCK_MUTEX(mMutex);
+
+        for (ProxyList::iterator i = mProxies.begin(); i != mProxies.end(); ++i)
+        {
+            if (i->object)
+                i->object->_setSceneQueryProxy(NO_PROXY);
+        }
+        mProxies.clear();
+        mFreeProxies.clear();
+        mDirtyProxies.clear();
+        mUnboundedProxies.clear();
+        mForeignObjects.clear();
+        mNodes.clear();
+        mRoot = -1;
+        mFreeNode = -1;
+        mNumObjects = 0;
+    }
+    //-----------------------------------------------------------------------
+    size_t SceneQueryBroadphase::getHeight(void) const
+    {
+        return mRoot == -1 ? 0 : static_cast<size_t>(mNodes[mRoot].height);
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadphase::_notifyObjectMoved(MovableObject* obj)
+    {
+        OGRE_LOCK_MUTEX(mMutex);
+
+        const uint32 index = obj->_getSceneQueryProxy();
+        if (index != NO_PROXY && !mProxies[index].dirty)
+        {
+            mProxies[index].dirty = true;
+            mDirtyProxies.push_back(index);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadphase::update(void)
+    {
+        OGRE_LOCK_MUTEX(mMutex);
+
+        // Refreshing may update nodes and notify more movements, which get
+        // appended and handled by the same loop
+        for (size_t i = 0; i < mDirtyProxies.size(); ++i)
+        {
+            const uint32 index = mDirtyProxies[i];
+            mProxies[index].dirty = false;
+            if (mProxies[index].object)
+                refreshProxy(index);
+        }
+        mDirtyProxies.clear();
+    }
+    //-----------------------------------------------------------------------
+    bool SceneQueryBroadphase::getObjectBounds(MovableObject* obj,
+        Vector3& minimum, Vector3& maximum, bool& unbounded) const
+    {
+        // The bounds cached by the last update, which the queries test
+        const AxisAlignedBox& box = obj->getWorldBoundingBox();
+        unbounded = box.isInfinite();
+        if (unbounded)
+            return false;
+
+        bool valid = !box.isNull();
+        if (valid)
+        {
+            minimum = box.getMinimum();
+            maximum = box.getMaximum();
+        }
+
+        // Sphere queries test the bounding radius around the parent node
+        if (obj->isAttached())
+        {
+            const Real radius = obj->getBoundingRadius();
+            if (Math::isNaN(radius) || radius >= Math::POS_INFINITY)
+            {
+                unbounded = true;
+                return false;
+            }
+            const Vector3& centre = obj->getParentNode()->_getDerivedPosition();
+            const Vector3 extent(radius, radius, radius);
+            if (valid)
+            {
+                minimum.makeFloor(centre - extent);
+                maximum.makeCeil(centre + extent);
+            }
+            else
+            {
+                minimum = centre - extent;
+                maximum = centre + extent;
+                valid = true;
+            }
+        }
+        return valid;
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadphase::refreshProxy(uint32 index)
+    {
+        Vector3 minimum, maximum;
+        bool unbounded;
+        // May update the parent node, whose listeners may register objects
+        const bool bounded = getObjectBounds(mProxies[index].object, minimum, maximum, unbounded);
+        setUnbounded(index, unbounded);
+
+        int32 leaf = mProxies[index].leaf;
+        if (!bounded)
+        {
+            if (leaf != -1)
+            {
+                removeLeaf(leaf);
+                freeNode(leaf);
+                mProxies[index].leaf = -1;
+            }
+            return;
+        }
+
+        // Margin relative to the size, plus enough to cover rounding far from the origin
+        const Vector3 size = maximum - minimum;
+        Real scale = std::max(minimum.absDotProduct(Vector3::UNIT_SCALE), maximum.absDotProduct(Vector3::UNIT_SCALE));
+        const Real margin = size.length() * mMarginFactor + scale * 1e-5f;
+
+        if (leaf != -1)
+        {
+            const TreeNode& node = mNodes[leaf];
+            if (node.minimum.x <= minimum.x && node.minimum.y <= minimum.y && node.minimum.z <= minimum.z &&
+                node.maximum.x >= maximum.x && node.maximum.y >= maximum.y && node.maximum.z >= maximum.z)
+            {
+                // Still inside, unless it shrank a lot
+                const Real fatLength = (node.maximum - node.minimum).length();
+                if (fatLength <= 2 * (size.length() + 2 * margin))
+                    return;
+            }
+            removeLeaf(leaf);
+        }
+        else
+        {
+            leaf = allocateNode();
+            mNodes[leaf].proxy = index;
+            mProxies[index].leaf = leaf;
+        }
+
+        const Vector3 extent(margin, margin, margin);
+        mNodes[leaf].minimum = minimum - extent;
+        mNodes[leaf].maximum = maximum + extent;
+        insertLeaf(leaf);
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadphase::setUnbounded(uint32 index, bool unbounded)
+    {
+        Proxy& proxy = mProxies[index];
+        if (proxy.unbounded == unbounded)
+            return;
+
+        proxy.unbounded = unbounded;
+        if (unbounded)
+        {
+            mUnboundedProxies.push_back(index);
+        }
+        else
+        {
+            mUnboundedProxies.erase(std::find(mUnboundedProxies.begin(), mUnboundedProxies.end(), index));
+        }
+    }
+    //-----------------------------------------------------------------------
+    int32 SceneQueryBroadphase::allocateNode(void)
+    {
+        int32 node;
+        if (mFreeNode != -1)
+        {
+            node = mFreeNode;
+            mFreeNode = mNodes[node].parent;
+        }
+        else
+        {
+            node = static_cast<int32>(mNodes.size());
+            mNodes.push_back(TreeNode());
+        }
+
+        TreeNode& treeNode = mNodes[node];
+        treeNode.parent = -1;
+        treeNode.child1 = -1;
+        treeNode.child2 = -1;
+        treeNode.height = 0;
+        treeNode.proxy = NO_PROXY;
+        return node;
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadphase::freeNode(int32 node)
+    {
+        mNodes[node].parent = mFreeNode;
+        mNodes[node].height = -1;
+        mFreeNode = node;
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadphase::insertLeaf(int32 leaf)
+    {
+        if (mRoot == -1)
+        {
+            mRoot = leaf;
+            mNodes[leaf].parent = -1;
+            return;
+        }
+
+        // Find the sibling with the least increase of surface area
+        const Vector3 leafMin = mNodes[leaf].minimum;
+        const Vector3 leafMax = mNodes[leaf].maximum;
+        int32 index = mRoot;
+        while (!mNodes[index].isLeaf())
+        {
+            const TreeNode& node = mNodes[index];
+            const Real area = getArea(node.minimum, node.maximum);
+            const Real combinedArea = getMergedArea(node.minimum, node.maximum, leafMin, leafMax);
+
+            // Cost of a new parent for this node and the leaf
+            const Real cost = 2 * combinedArea;
+            // Minimum cost of pushing the leaf further down
+            const Real inheritanceCost = 2 * (combinedArea - area);
+
+            Real childCost[2];
+            const int32 children[2] = { node.child1, node.child2 };
+            for (int c = 0; c < 2; ++c)
+            {
+                const TreeNode& child = mNodes[children[c]];
+                childCost[c] = getMergedArea(child.minimum, child.maximum, leafMin, leafMax) + inheritanceCost;
+                if (!child.isLeaf())
+                    childCost[c] -= getArea(child.minimum, child.maximum);
+            }
+
+            if (cost < childCost[0] && cost < childCost[1])
+                break;
+            index = childCost[0] < childCost[1] ? children[0] : children[1];
+        }
+        const int32 sibling = index;
+
+        // New parent of the sibling and the leaf
+        const int32 oldParent = mNodes[sibling].parent;
+        const int32 newParent = allocateNode();
+        TreeNode& parentNode = mNodes[newParent];
+        parentNode.parent = oldParent;
+        parentNode.minimum = leafMin;
+        parentNode.minimum.makeFloor(mNodes[sibling].minimum);
+        parentNode.maximum = leafMax;
+        parentNode.maximum.makeCeil(mNodes[sibling].maximum);
+        parentNode.height = mNodes[sibling].height + 1;
+        parentNode.child1 = sibling;
+        parentNode.child2 = leaf;
+
+        if (oldParent != -1)
+        {
+            if (mNodes[oldParent].child1 == sibling)
+                mNodes[oldParent].child1 = newParent;
+            else
+                mNodes[oldParent].child2 = newParent;
+        }
+        else
+        {
+            mRoot = newParent;
+        }
+        mNodes[sibling].parent = newParent;
+        mNodes[leaf].parent = newParent;
+
+        // Refit and rebalance the ancestors
+        index = newParent;
+        while (index != -1)
+        {
+            index = balance(index);
+
+            TreeNode& node = mNodes[index];
+            const TreeNode& child1 = mNodes[node.child1];
+            const TreeNode& child2 = mNodes[node.child2];
+            node.height = 1 + std::max(child1.height, child2.height);
+            node.minimum = child1.minimum;
+            node.minimum.makeFloor(child2.minimum);
+            node.maximum = child1.maximum;
+            node.maximum.makeCeil(child2.maximum);
+
+            index = node.parent;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadphase::removeLeaf(int32 leaf)
+    {
+        if (leaf == mRoot)
+        {
+            mRoot = -1;
+            return;
+        }
+
+        const int32 parent = mNodes[leaf].parent;
+        const int32 grandParent = mNodes[parent].parent;
+        const int32 sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+        if (grandParent == -1)
+        {
+            mRoot = sibling;
+            mNodes[sibling].parent = -1;
+            freeNode(parent);
+            return;
+        }
+
+        // The sibling takes the place of the parent
+        if (mNodes[grandParent].child1 == parent)
+            mNodes[grandParent].child1 = sibling;
+        else
+            mNodes[grandParent].child2 = sibling;
+        mNodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        int32 index = grandParent;
+        while (index != -1)
+        {
+            index = balance(index);
+
+            TreeNode& node = mNodes[index];
+            const TreeNode& child1 = mNodes[node.child1];
+            const TreeNode& child2 = mNodes[node.child2];
+            node.height = 1 + std::max(child1.height, child2.height);
+            node.minimum = child1.minimum;
+            node.minimum.makeFloor(child2.minimum);
+            node.maximum = child1.maximum;
+            node.maximum.makeCeil(child2.maximum);
+
+            index = node.parent;
+        }
+    }
+    //-----------------------------------------------------------------------
+    int32 SceneQueryBroadphase::balance(int32 iA)
+    {
+        TreeNode* A = &mNodes[iA];
+        if (A->isLeaf() || A->height < 2)
+            return iA;
+
+        const int32 iB = A->child1;
+        const int32 iC = A->child2;
+        TreeNode* B = &mNodes[iB];
+        TreeNode* C = &mNodes[iC];
+        const int32 difference = C->height - B->height;
+
+        if (difference > 1)
+        {
+            // Rotate C up
+            const int32 iF = C->child1;
+            const int32 iG = C->child2;
+            const TreeNode* F = &mNodes[iF];
+            const TreeNode* G = &mNodes[iG];
+
+            C->child1 = iA;
+            C->parent = A->parent;
+            A->parent = iC;
+            if (C->parent != -1)
+            {
+                if (mNodes[C->parent].child1 == iA)
+                    mNodes[C->parent].child1 = iC;
+                else
+                    mNodes[C->parent].child2 = iC;
+            }
+            else
+            {
+                mRoot = iC;
+            }
+
+            // The highest child of C stays below it, the other goes to A
+            const int32 iKeep = F->height > G->height ? iF : iG;
+            const int32 iGive = iKeep == iF ? iG : iF;
+            const TreeNode& keep = mNodes[iKeep];
+            TreeNode& give = mNodes[iGive];
+            C->child2 = iKeep;
+            A->child2 = iGive;
+            give.parent = iA;
+
+            A->minimum = B->minimum;
+            A->minimum.makeFloor(give.minimum);
+            A->maximum = B->maximum;
+            A->maximum.makeCeil(give.maximum);
+            A->height = 1 + std::max(B->height, give.height);
+            C->minimum = A->minimum;
+            C->minimum.makeFloor(keep.minimum);
+            C->maximum = A->maximum;
+            C->maximum.makeCeil(keep.maximum);
+            C->height = 1 + std::max(A->height, keep.height);
+            return iC;
+        }
+
+        if (difference < -1)
+        {
+            // Rotate B up
+            const int32 iD = B->child1;
+            const int32 iE = B->child2;
+            const TreeNode* D = &mNodes[iD];
+            const TreeNode* E = &mNodes[iE];
+
+            B->child1 = iA;
+            B->parent = A->parent;
+            A->parent = iB;
+            if (B->parent != -1)
+            {
+                if (mNodes[B->parent].child1 == iA)
+                    mNodes[B->parent].child1 = iB;
+                else
+                    mNodes[B->parent].child2 = iB;
+            }
+            else
+            {
+                mRoot = iB;
+            }
+
+            // The highest child of B stays below it, the other goes to A
+            const int32 iKeep = D->height > E->height ? iD : iE;
+            const int32 iGive = iKeep == iD ? iE : iD;
+            const TreeNode& keep = mNodes[iKeep];
+            TreeNode& give = mNodes[iGive];
+            B->child2 = iKeep;
+            A->child1 = iGive;
+            give.parent = iA;
+
+            A->minimum = C->minimum;
+            A->minimum.makeFloor(give.minimum);
+            A->maximum = C->maximum;
+            A->maximum.makeCeil(give.maximum);
+            A->height = 1 + std::max(C->height, give.height);
+            B->minimum = A->minimum;
+            B->minimum.makeFloor(keep.minimum);
+            B->maximum = A->maximum;
+            B->maximum.makeCeil(keep.maximum);
+            B->height = 1 + std::max(A->height, keep.height);
+            return iB;
+        }
+
+        return iA;
+    }
+    //-----------------------------------------------------------------------
+    template <typename Test>
+    void SceneQueryBroadphase::query(const Test& test, ObjectList& result) const
+    {
+        if (mRoot != -1)
+        {
+            int32 stack[MAX_TREE_DEPTH];
+            size_t count = 0;
+            stack[count++] = mRoot;
+            while (count > 0)
+            {
+                const TreeNode& node = mNodes[stack[--count]];
+                if (!test(node.minimum, node.maximum))
+                    continue;
+
+                if (node.isLeaf())
+                {
+                    result.push_back(mProxies[node.proxy].object);
+                }
+                else
+                {
+                    assert(count + 2 <= MAX_TREE_DEPTH);
+                    stack[count++] = node.child1;
+                    stack[count++] = node.child2;
+                }
+            }
+        }
+
+        for (ProxyIndexList::const_iterator i = mUnboundedProxies.begin(); i != mUnboundedProxies.end(); ++i)
+        {
+            result.push_back(mProxies[*i].object);
+        }
+        result.insert(result.end(), mForeignObjects.begin(), mForeignObjects.end());
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadphase::findObjects(const AxisAlignedBox& box, ObjectList& result) const
+    {
+        result.clear();
+        if (box.isNull())
+            return;
+        if (box.isInfinite())
+        {
+            getObjects(result);
+            return;
+        }
+
+        BoxTest test;
+        test.minimum = box.getMinimum();
+        test.maximum = box.getMaximum();
+        query(test, result);
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadphase::findObjects(const Sphere& sphere, ObjectList& result) const
+    {
+        result.clear();
+
+        SphereTest test;
+        test.centre = sphere.getCenter();
+        test.radiusSquared = sphere.getRadius() * sphere.getRadius();
+        query(test, result);
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadphase::findObjects(const Ray& ray, ObjectList& result) const
+    {
+        result.clear();
+
+        RayTest test;
+        test.origin = ray.getOrigin();
+        test.direction = ray.getDirection();
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            test.invDirection[axis] = test.direction[axis] == 0 ? 0 : 1 / test.direction[axis];
+        }
+        query(test, result);
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadphase::findObjects(const PlaneBoundedVolumeList& volumes, ObjectList& result) const
+    {
+        result.clear();
+
+        VolumeTest test;
+        test.volumes = &volumes;
+        query(test, result);
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadphase::getObjects(ObjectList& result) const
+    {
+        result.clear();
+        for (ProxyList::const_iterator i = mProxies.begin(); i != mProxies.end(); ++i)
+        {
+            if (i->object)
+                result.push_back(i->object);
+        }
+        result.insert(result.end(), mForeignObjects.begin(), mForeignObjects.end());
+    }
+}
@@ -32,6 +32,15 @@ THE SOFTWARE.
 #include "OgreScriptTranslator.h"
 #include "OgreLogManager.h"
 #include "OgreResourceGroupManager.h"
+#include "OgreStreamSerialiser.h"
+#include "OgreIdString.h"
+#include "Hash/MurmurHash3.h"
+
+#if OGRE_ARCH_TYPE == OGRE_ARCHITECTURE_32
+        #define OGRE_HASH128_FUNC MurmurHash3_x86_128
+#else
+        #define OGRE_HASH128_FUNC MurmurHash3_x64_128
+#endif
 
 namespace Ogre
 {
@@ -275,7 +284,7 @@ namespace Ogre
     }
 
     ScriptCompiler::ScriptCompiler()
-        :mListener(0)
+        :mCacheRecording(false), mListener(0)
     {
         initWordMap();
     }
@@ -356,6 +365,11 @@ namespace Ogre
 
         // Convert our nodes to an AST
         AbstractNodeListPtr ast = convertToAST(nodes);
+        return compileAST(ast);
+    }
+
+    bool ScriptCompiler::compileAST(AbstractNodeListPtr &ast)
+    {
         // Processes the imports for this script
         processImports(ast);
         // Process object inheritance
@@ -363,6 +377,12 @@ namespace Ogre
         // Process variable expansion
         processVariables(ast.get());
 
+        addToCache(ast);
+        return translateAST(ast);
+    }
+
+    bool ScriptCompiler::translateAST(const AbstractNodeListPtr &ast)
+    {
         // Allows early bail-out through the listener
         if(mListener && !mListener->postConversion(this, ast))
             return mErrors.empty();
@@ -386,6 +406,198 @@ namespace Ogre
         return mErrors.empty();
     }
 
+    void ScriptCompiler::_prepare(const DataStreamPtr &stream, PreparedScript &script)
+    {
+        ScriptLexer lexer;
+        ScriptParser parser;
+        script.cst = parser.parse(lexer.tokenize(stream, stream->getName()));
+
+        // A listener may intercept the tree before it is converted, which is
+        // then left to _compilePrepared
+        if(!mListener)
+        {
+            AbstractTreeBuilder builder(this, &script);
+            AbstractTreeBuilder::visit(&builder, *script.cst.get());
+            script.ast = builder.getResult();
+        }
+    }
+
+    bool ScriptCompiler::_compilePrepared(PreparedScript &script, const String &group)
+    {
+        // Set up the compilation context
+        mGroup = group;
+
+        // Clear the past errors
+        mErrors.clear();
+
+        // Clear the environment
+        mEnv.clear();
+
+        AbstractNodeListPtr ast;
+        if(script.ast.isNull() || mListener)
+        {
+            if(mListener)
+                mListener->preConversion(this, script.cst);
+            ast = convertToAST(script.cst);
+        }
+        else
+        {
+            // Restore the outcome of the conversion done ahead
+            mEnv.insert(script.env.begin(), script.env.end());
+            for(ErrorList::iterator i = script.errors.begin(); i != script.errors.end(); ++i)
+                addError((*i)->code, (*i)->file, (*i)->line, (*i)->message);
+            ast = script.ast;
+        }
+        return compileAST(ast);
+    }
+
+    bool ScriptCompiler::_compileCached(const DataStreamPtr &stream, const String &group)
+    {
+        mCacheRecording = false;
+
+        ScriptLexer lexer;
+        ScriptParser parser;
+        ScriptCompilerManager *manager = ScriptCompilerManager::getSingletonPtr();
+        if(mListener || !manager || !manager->getScriptCacheEnabled())
+            return compile(parser.parse(lexer.tokenize(stream, stream->getName())), group);
+
+        // The script is hashed, then parsed from the same memory if it isn't cached
+        DataStreamPtr source = stream;
+        if(!dynamic_cast<MemoryDataStream*>(source.get()))
+        {
+            DataStreamPtr fileStream = stream;
+            source.bind(OGRE_NEW MemoryDataStream(stream->getName(), fileStream));
+        }
+        const Hash hash = _computeHash(source->getName(), source);
+
+        CachedScriptPtr cached = manager->_getCachedScript(hash);
+        if(!cached.isNull() && compileFromCache(*cached, group))
+            return mErrors.empty();
+
+        ConcreteNodeListPtr nodes = parser.parse(lexer.tokenize(source, source->getName()));
+        mCacheHash = hash;
+        mCacheDependencies.clear();
+        mCacheRecording = true;
+        bool result;
+        try
+        {
+            result = compile(nodes, group);
+        }
+        catch(...)
+        {
+            mCacheRecording = false;
+            throw;
+        }
+        mCacheRecording = false;
+        return result;
+    }
+
+    ScriptCompiler::Hash ScriptCompiler::_computeHash(const String &name, const DataStreamPtr &stream)
+    {
+        Hash hashVal[2];
+        OGRE_HASH128_FUNC( name.c_str(), static_cast<int>(name.size()), IdString::Seed, &hashVal[0] );
+
+        MemoryDataStream *memStream = dynamic_cast<MemoryDataStream*>(stream.get());
+        if(memStream)
+        {
+            OGRE_HASH128_FUNC( memStream->getPtr(), static_cast<int>(memStream->size()), IdString::Seed, &hashVal[1] );
+        }
+        else
+        {
+            DataStreamPtr source = stream;
+            MemoryDataStream contents(source);
+            OGRE_HASH128_FUNC( contents.getPtr(), static_cast<int>(contents.size()), IdString::Seed, &hashVal[1] );
+        }
+
+        Hash retVal;
+        OGRE_HASH128_FUNC( hashVal, sizeof( hashVal ), IdString::Seed, &retVal );
+        return retVal;
+    }
+
+    void ScriptCompiler::addToCache(const AbstractNodeListPtr &ast)
+    {
+        if(!mCacheRecording)
+            return;
+        mCacheRecording = false;
+
+        // Translators may modify the tree, so the cache gets its own copy
+        CachedScriptPtr script(OGRE_NEW CachedScript());
+        script->dependencies = mCacheDependencies;
+        script->errors = mErrors;
+        script->nodes = AbstractNodeListPtr(OGRE_NEW_T(AbstractNodeList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+        for(AbstractNodeList::const_iterator i = ast->begin(); i != ast->end(); ++i)
+            script->nodes->push_back(AbstractNodePtr((*i)->clone()));
+
+        ScriptCompilerManager::getSingleton()._addCachedScript(mCacheHash, script);
+    }
+
+    bool ScriptCompiler::compileFromCache(const CachedScript &script, const String &group)
+    {
+        // The tree is out of date as soon as one of the imported scripts changed,
+        // or one which was missing turns up
+        const Hash missing = { { 0, 0 } };
+        for(DependencyList::const_iterator i = script.dependencies.begin(); i != script.dependencies.end(); ++i)
+        {
+            DataStreamPtr stream;
+            try
+            {
+                stream = ResourceGroupManager::getSingleton().openResource(i->first, group);
+            }
+            catch(Exception&)
+            {
+                if(!(i->second == missing))
+                    return false;
+            }
+            if(stream.isNull() ? !(i->second == missing) : !(_computeHash(i->first, stream) == i->second))
+                return false;
+        }
+
+        // Set up the compilation context
+        mGroup = group;
+        mErrors.clear();
+        mEnv.clear();
+
+        for(ErrorList::const_iterator i = script.errors.begin(); i != script.errors.end(); ++i)
+            addError((*i)->code, (*i)->file, (*i)->line, (*i)->message);
+
+        AbstractNodeListPtr ast(OGRE_NEW_T(AbstractNodeList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+        for(AbstractNodeList::const_iterator i = script.nodes->begin(); i != script.nodes->end(); ++i)
+            ast->push_back(AbstractNodePtr((*i)->clone()));
+        assignIds(*ast);
+
+        translateAST(ast);
+        return true;
+    }
+
+    void ScriptCompiler::assignIds(AbstractNodeList &nodes)
+    {
+        // Word ids aren't cached, custom ones may be registered in a different order
+        for(AbstractNodeList::iterator i = nodes.begin(); i != nodes.end(); ++i)
+        {
+            if((*i)->type == ANT_ATOM)
+            {
+                AtomAbstractNode *atom = static_cast<AtomAbstractNode*>((*i).get());
+                IdMap::const_iterator id = mIds.find(atom->value);
+                atom->id = id != mIds.end() ? id->second : 0;
+            }
+            else if((*i)->type == ANT_OBJECT)
+            {
+                ObjectAbstractNode *obj = static_cast<ObjectAbstractNode*>((*i).get());
+                IdMap::const_iterator id = mIds.find(obj->cls);
+                obj->id = id != mIds.end() ? id->second : 0;
+                assignIds(obj->children);
+                assignIds(obj->values);
+            }
+            else if((*i)->type == ANT_PROPERTY)
+            {
+                PropertyAbstractNode *prop = static_cast<PropertyAbstractNode*>((*i).get());
+                IdMap::const_iterator id = mIds.find(prop->name);
+                prop->id = id != mIds.end() ? id->second : 0;
+                assignIds(prop->values);
+            }
+        }
+    }
+
     AbstractNodeListPtr ScriptCompiler::_generateAST(const String &str, const String &source, bool doImports, bool doObjects, bool doVariables)
     {
         // Clear the past errors
@@ -592,10 +804,26 @@ namespace Ogre
         if(nodes.isNull() && ResourceGroupManager::getSingletonPtr())
         {
             DataStreamPtr stream = ResourceGroupManager::getSingleton().openResource(name, mGroup);
+            if(stream.isNull() && mCacheRecording)
+            {
+                // The cached script is only valid while this one stays missing
+                Hash missing = { { 0, 0 } };
+                mCacheDependencies.push_back(std::make_pair(name, missing));
+            }
             if(!stream.isNull())
             {
+                if(mCacheRecording)
+                {
+                    // The cached script depends on this one
+                    if(!dynamic_cast<MemoryDataStream*>(stream.get()))
+                    {
+                        DataStreamPtr fileStream = stream;
+                        stream.bind(OGRE_NEW MemoryDataStream(name, fileStream));
+                    }
+                    mCacheDependencies.push_back(std::make_pair(name, _computeHash(name, stream)));
+                }
                 ScriptLexer lexer;
-                ScriptTokenListPtr tokens = lexer.tokenize(stream->getAsString(), name);
+                ScriptTokenListPtr tokens = lexer.tokenize(stream, name);
                 ScriptParser parser;
                 nodes = parser.parse(tokens);
             }
@@ -1303,9 +1531,27 @@ namespace Ogre
     }
 
     // AbstractTreeeBuilder
-    ScriptCompiler::AbstractTreeBuilder::AbstractTreeBuilder(ScriptCompiler *compiler)
-        :mNodes(OGRE_NEW_T(AbstractNodeList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T), mCurrent(0), mCompiler(compiler)
+    ScriptCompiler::AbstractTreeBuilder::AbstractTreeBuilder(ScriptCompiler *compiler, PreparedScript *prepared)
+        :mNodes(OGRE_NEW_T(AbstractNodeList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T), mCurrent(0), mCompiler(compiler),
+        mPrepared(prepared)
+    {
+    }
+
+    void ScriptCompiler::AbstractTreeBuilder::addError(uint32 code, const String &file, int line, const String &msg)
     {
+        if(mPrepared)
+        {
+            ErrorPtr err(OGRE_NEW Error());
+            err->code = code;
+            err->file = file;
+            err->line = line;
+            err->message = msg;
+            mPrepared->errors.push_back(err);
+        }
+        else
+        {
+            mCompiler->addError(code, file, line, msg);
+        }
     }
 
     const AbstractNodeListPtr &ScriptCompiler::AbstractTreeBuilder::getResult() const
@@ -1322,12 +1568,12 @@ namespace Ogre
         {
             if(node->children.size() > 2)
             {
-                mCompiler->addError(CE_FEWERPARAMETERSEXPECTED, node->file, node->line);
+                addError(CE_FEWERPARAMETERSEXPECTED, node->file, node->line);
                 return;
             }
             if(node->children.size() < 2)
             {
-                mCompiler->addError(CE_STRINGEXPECTED, node->file, node->line);
+                addError(CE_STRINGEXPECTED, node->file, node->line);
                 return;
             }
 
@@ -1348,17 +1594,17 @@ namespace Ogre
         {
             if(node->children.size() > 2)
             {
-                mCompiler->addError(CE_FEWERPARAMETERSEXPECTED, node->file, node->line);
+                addError(CE_FEWERPARAMETERSEXPECTED, node->file, node->line);
                 return;
             }
             if(node->children.size() < 2)
             {
-                mCompiler->addError(CE_STRINGEXPECTED, node->file, node->line);
+                addError(CE_STRINGEXPECTED, node->file, node->line);
                 return;
             }
             if(node->children.front()->type != CNT_VARIABLE)
             {
-                mCompiler->addError(CE_VARIABLEEXPECTED, node->children.front()->file, node->children.front()->line);
+                addError(CE_VARIABLEEXPECTED, node->children.front()->file, node->children.front()->line);
                 return;
             }
 
@@ -1375,7 +1621,10 @@ namespace Ogre
             }
             else
             {
-                mCompiler->mEnv.insert(std::make_pair(name, value));
+                if(mPrepared)
+                    mPrepared->env.insert(std::make_pair(name, value));
+                else
+                    mCompiler->mEnv.insert(std::make_pair(name, value));
             }
         }
         // variable = $*, no children
@@ -1383,7 +1632,7 @@ namespace Ogre
         {
             if(!node->children.empty())
             {
-                mCompiler->addError(CE_FEWERPARAMETERSEXPECTED, node->file, node->line);
+                addError(CE_FEWERPARAMETERSEXPECTED, node->file, node->line);
                 return;
             }
 
@@ -1414,7 +1663,7 @@ namespace Ogre
             {
                 if(node->children.size() < 2)
                 {
-                    mCompiler->addError(CE_STRINGEXPECTED, node->file, node->line);
+                    addError(CE_STRINGEXPECTED, node->file, node->line);
                     return;
                 }
 
@@ -1493,7 +1742,7 @@ namespace Ogre
                 }
                 else
                 {
-                    mCompiler->addError(CE_UNEXPECTEDTOKEN, impl->file, impl->line, "token class, " + impl->cls + ", unrecognized.");
+                    addError(CE_UNEXPECTEDTOKEN, impl->file, impl->line, "token class, " + impl->cls + ", unrecognized.");
                 }
 
                 asn = AbstractNodePtr(impl);
@@ -1574,6 +1823,9 @@ namespace Ogre
 
     // ScriptCompilerManager
     template<> ScriptCompilerManager *Singleton<ScriptCompilerManager>::msSingleton = 0;
+
+    const uint32 ScriptCompilerManager::SCRIPTCACHE_CHUNK_ID = StreamSerialiser::makeIdentifier("SCCH");
+    const uint16 ScriptCompilerManager::SCRIPTCACHE_CHUNK_VERSION = 1;
     
     ScriptCompilerManager* ScriptCompilerManager::getSingletonPtr(void)
     {
@@ -1586,7 +1838,8 @@ namespace Ogre
     }
     //-----------------------------------------------------------------------
     ScriptCompilerManager::ScriptCompilerManager()
-        :mListener(0), OGRE_THREAD_POINTER_INIT(mScriptCompiler)
+        :mListener(0), OGRE_THREAD_POINTER_INIT(mScriptCompiler), mPreparingCompiler(0),
+        mScriptCacheEnabled(false), mScriptCacheDirty(false)
     {
             OGRE_LOCK_AUTO_MUTEX;
         mScriptPatterns.push_back("*.program");
@@ -1698,7 +1951,383 @@ namespace Ogre
                     OGRE_LOCK_AUTO_MUTEX;
             OGRE_THREAD_POINTER_GET(mScriptCompiler)->setListener(mListener);
         }
-        OGRE_THREAD_POINTER_GET(mScriptCompiler)->compile(stream->getAsString(), stream->getName(), groupName);
+        OGRE_THREAD_POINTER_GET(mScriptCompiler)->_compileCached(stream, groupName);
+    }
+    //-----------------------------------------------------------------------
+    bool ScriptCompilerManager::beginPreparingScripts(void)
+    {
+        // Cached scripts skip the work which would be prepared
+        if (mScriptCacheEnabled)
+            return false;
+
+#if OGRE_THREAD_SUPPORT
+        if (!OGRE_THREAD_POINTER_GET(mScriptCompiler))
+        {
+            OGRE_THREAD_POINTER_SET(mScriptCompiler, OGRE_NEW ScriptCompiler());
+        }
+#endif
+        // The scripts are prepared by the compiler of this thread, which
+        // compiles them afterwards; its listener must not change meanwhile
+        mPreparingCompiler = OGRE_THREAD_POINTER_GET(mScriptCompiler);
+        {
+                    OGRE_LOCK_AUTO_MUTEX;
+            mPreparingCompiler->setListener(mListener);
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    ScriptLoader::PreparedScript* ScriptCompilerManager::prepareScript(DataStreamPtr& stream, const String& groupName)
+    {
+        (void)groupName;
+        ScriptCompiler::PreparedScript* script = OGRE_NEW ScriptCompiler::PreparedScript();
+        try
+        {
+            mPreparingCompiler->_prepare(stream, *script);
+        }
+        catch (...)
+        {
+            OGRE_DELETE script;
+            throw;
+        }
+        return script;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::parsePreparedScript(ScriptLoader::PreparedScript* script, const String& groupName)
+    {
+        mPreparingCompiler->_compilePrepared(
+            *static_cast<ScriptCompiler::PreparedScript*>(script), groupName);
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::endPreparingScripts(void)
+    {
+        mPreparingCompiler = 0;
+    }
+    //-----------------------------------------------------------------------
+    namespace
+    {
+        typedef map<String, uint32>::type FileIndexMap;
+
+        /// Files are written once, then referred to by index
+        void writeCachedFile(StreamSerialiser& stream, const String& file, FileIndexMap& files)
+        {
+            FileIndexMap::iterator i = files.find(file);
+            if (i != files.end())
+            {
+                stream.write(&i->second);
+                return;
+            }
+            uint32 index = static_cast<uint32>(files.size());
+            files.insert(std::make_pair(file, index));
+            stream.write(&index);
+            stream.write(&file);
+        }
+        //-----------------------------------------------------------------------
+        const String& readCachedFile(StreamSerialiser& stream, StringVector& files)
+        {
+            uint32 index;
+            stream.read(&index);
+            if (index == files.size())
+            {
+                files.push_back(BLANKSTRING);
+                stream.read(&files.back());
+            }
+            else if (index > files.size())
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Corrupt script cache",
+                    "ScriptCompilerManager::loadScriptCache");
+            }
+            return files[index];
+        }
+        //-----------------------------------------------------------------------
+        void writeCachedNodes(StreamSerialiser& stream, const AbstractNodeList& nodes, FileIndexMap& files);
+        void readCachedNodes(StreamSerialiser& stream, AbstractNodeList& nodes, AbstractNode* parent,
+                             StringVector& files);
+        //-----------------------------------------------------------------------
+        void writeCachedNode(StreamSerialiser& stream, const AbstractNode* node, FileIndexMap& files)
+        {
+            uint8 type = static_cast<uint8>(node->type);
+            stream.write(&type);
+            writeCachedFile(stream, node->file, files);
+            uint32 line = node->line;
+            stream.write(&line);
+
+            switch (node->type)
+            {
+            case ANT_ATOM:
+                stream.write(&static_cast<const AtomAbstractNode*>(node)->value);
+                break;
+            case ANT_OBJECT:
+                {
+                    const ObjectAbstractNode* obj = static_cast<const ObjectAbstractNode*>(node);
+                    stream.write(&obj->name);
+                    stream.write(&obj->cls);
+                    uint32 count = static_cast<uint32>(obj->bases.size());
+                    stream.write(&count);
+                    for (vector<String>::type::const_iterator i = obj->bases.begin(); i != obj->bases.end(); ++i)
+                        stream.write(&*i);
+                    stream.write(&obj->abstract);
+                    const map<String,String>::type& vars = obj->getVariables();
+                    count = static_cast<uint32>(vars.size());
+                    stream.write(&count);
+                    for (map<String,String>::type::const_iterator i = vars.begin(); i != vars.end(); ++i)
+                    {
+                        stream.write(&i->first);
+                        stream.write(&i->second);
+                    }
+                    writeCachedNodes(stream, obj->values, files);
+                    writeCachedNodes(stream, obj->children, files);
+                }
+                break;
+            case ANT_PROPERTY:
+                {
+                    const PropertyAbstractNode* prop = static_cast<const PropertyAbstractNode*>(node);
+                    stream.write(&prop->name);
+                    writeCachedNodes(stream, prop->values, files);
+                }
+                break;
+            case ANT_IMPORT:
+                stream.write(&static_cast<const ImportAbstractNode*>(node)->target);
+                stream.write(&static_cast<const ImportAbstractNode*>(node)->source);
+                break;
+            case ANT_VARIABLE_ACCESS:
+                stream.write(&static_cast<const VariableAccessAbstractNode*>(node)->name);
+                break;
+            default:
+                break;
+            }
+        }
+        //-----------------------------------------------------------------------
+        AbstractNodePtr readCachedNode(StreamSerialiser& stream, AbstractNode* parent, StringVector& files)
+        {
+            uint8 type;
+            stream.read(&type);
+
+            AbstractNodePtr node;
+            switch (type)
+            {
+            case ANT_ATOM:
+                node = AbstractNodePtr(OGRE_NEW AtomAbstractNode(parent));
+                break;
+            case ANT_OBJECT:
+                node = AbstractNodePtr(OGRE_NEW ObjectAbstractNode(parent));
+                break;
+            case ANT_PROPERTY:
+                node = AbstractNodePtr(OGRE_NEW PropertyAbstractNode(parent));
+                break;
+            case ANT_IMPORT:
+                node = AbstractNodePtr(OGRE_NEW ImportAbstractNode());
+                node->parent = parent;
+                break;
+            case ANT_VARIABLE_ACCESS:
+                node = AbstractNodePtr(OGRE_NEW VariableAccessAbstractNode(parent));
+                break;
+            default:
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Corrupt script cache",
+                    "ScriptCompilerManager::loadScriptCache");
+            }
+
+            node->file = readCachedFile(stream, files);
+            uint32 line;
+            stream.read(&line);
+            node->line = line;
+
+            switch (type)
+            {
+            case ANT_ATOM:
+                stream.read(&static_cast<AtomAbstractNode*>(node.get())->value);
+                break;
+            case ANT_OBJECT:
+                {
+                    ObjectAbstractNode* obj = static_cast<ObjectAbstractNode*>(node.get());
+                    stream.read(&obj->name);
+                    stream.read(&obj->cls);
+                    uint32 count;
+                    stream.read(&count);
+                    obj->bases.resize(count);
+                    for (uint32 i = 0; i < count; ++i)
+                        stream.read(&obj->bases[i]);
+                    stream.read(&obj->abstract);
+                    stream.read(&count);
+                    for (uint32 i = 0; i < count; ++i)
+                    {
+                        String name, value;
+                        stream.read(&name);
+                        stream.read(&value);
+                        obj->setVariable(name, value);
+                    }
+                    readCachedNodes(stream, obj->values, obj, files);
+                    readCachedNodes(stream, obj->children, obj, files);
+                }
+                break;
+            case ANT_PROPERTY:
+                {
+                    PropertyAbstractNode* prop = static_cast<PropertyAbstractNode*>(node.get());
+                    stream.read(&prop->name);
+                    readCachedNodes(stream, prop->values, prop, files);
+                }
+                break;
+            case ANT_IMPORT:
+                stream.read(&static_cast<ImportAbstractNode*>(node.get())->target);
+                stream.read(&static_cast<ImportAbstractNode*>(node.get())->source);
+                break;
+            case ANT_VARIABLE_ACCESS:
+                stream.read(&static_cast<VariableAccessAbstractNode*>(node.get())->name);
+                break;
+            }
+            return node;
+        }
+        //-----------------------------------------------------------------------
+        void writeCachedNodes(StreamSerialiser& stream, const AbstractNodeList& nodes, FileIndexMap& files)
+        {
+            uint32 count = static_cast<uint32>(nodes.size());
+            stream.write(&count);
+            for (AbstractNodeList::const_iterator i = nodes.begin(); i != nodes.end(); ++i)
+                writeCachedNode(stream, i->get(), files);
+        }
+        //-----------------------------------------------------------------------
+        void readCachedNodes(StreamSerialiser& stream, AbstractNodeList& nodes, AbstractNode* parent,
+                             StringVector& files)
+        {
+            uint32 count;
+            stream.read(&count);
+            for (uint32 i = 0; i < count; ++i)
+                nodes.push_back(readCachedNode(stream, parent, files));
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::setScriptCacheEnabled(bool enabled)
+    {
+        mScriptCacheEnabled = enabled;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::clearScriptCache(void)
+    {
+            OGRE_LOCK_AUTO_MUTEX;
+        mScriptCache.clear();
+        mScriptCacheDirty = false;
+    }
+    //-----------------------------------------------------------------------
+    ScriptCompiler::CachedScriptPtr ScriptCompilerManager::_getCachedScript(const ScriptCompiler::Hash& hash)
+    {
+            OGRE_LOCK_AUTO_MUTEX;
+        ScriptCacheMap::iterator i = mScriptCache.find(hash);
+        return i != mScriptCache.end() ? i->second : ScriptCompiler::CachedScriptPtr();
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::_addCachedScript(const ScriptCompiler::Hash& hash,
+                                                 const ScriptCompiler::CachedScriptPtr& script)
+    {
+            OGRE_LOCK_AUTO_MUTEX;
+        mScriptCache[hash] = script;
+        mScriptCacheDirty = true;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::saveScriptCache(const DataStreamPtr& stream)
+    {
+        if (!stream->isWriteable())
+        {
+            OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                "Unable to write to stream " + stream->getName(),
+                "ScriptCompilerManager::saveScriptCache");
+        }
+
+            OGRE_LOCK_AUTO_MUTEX;
+        StreamSerialiser serialiser(stream);
+        serialiser.writeChunkBegin(SCRIPTCACHE_CHUNK_ID, SCRIPTCACHE_CHUNK_VERSION);
+
+        FileIndexMap files;
+        uint32 count = static_cast<uint32>(mScriptCache.size());
+        serialiser.write(&count);
+        for (ScriptCacheMap::const_iterator i = mScriptCache.begin(); i != mScriptCache.end(); ++i)
+        {
+            serialiser.write(i->first.hashVal, 2);
+            const ScriptCompiler::CachedScript& script = *i->second;
+
+            count = static_cast<uint32>(script.dependencies.size());
+            serialiser.write(&count);
+            for (ScriptCompiler::DependencyList::const_iterator d = script.dependencies.begin();
+                 d != script.dependencies.end(); ++d)
+            {
+                serialiser.write(&d->first);
+                serialiser.write(d->second.hashVal, 2);
+            }
+
+            count = static_cast<uint32>(script.errors.size());
+            serialiser.write(&count);
+            for (ScriptCompiler::ErrorList::const_iterator e = script.errors.begin(); e != script.errors.end(); ++e)
+            {
+                serialiser.write(&(*e)->code);
+                writeCachedFile(serialiser, (*e)->file, files);
+                int32 line = (*e)->line;
+                serialiser.write(&line);
+                serialiser.write(&(*e)->message);
+            }
+
+            writeCachedNodes(serialiser, *script.nodes, files);
+        }
+
+        serialiser.writeChunkEnd(SCRIPTCACHE_CHUNK_ID);
+        mScriptCacheDirty = false;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::loadScriptCache(const DataStreamPtr& stream)
+    {
+            OGRE_LOCK_AUTO_MUTEX;
+        mScriptCache.clear();
+        mScriptCacheDirty = false;
+
+        StreamSerialiser serialiser(stream);
+        if (!serialiser.readChunkBegin(SCRIPTCACHE_CHUNK_ID, SCRIPTCACHE_CHUNK_VERSION,
+                                       "ScriptCompilerManager::loadScriptCache"))
+            return;
+
+        try
+        {
+            StringVector files;
+            uint32 numScripts;
+            serialiser.read(&numScripts);
+            for (uint32 s = 0; s < numScripts; ++s)
+            {
+                ScriptCompiler::Hash hash;
+                serialiser.read(hash.hashVal, 2);
+                ScriptCompiler::CachedScriptPtr script(OGRE_NEW ScriptCompiler::CachedScript());
+
+                uint32 count;
+                serialiser.read(&count);
+                for (uint32 i = 0; i < count; ++i)
+                {
+                    std::pair<String, ScriptCompiler::Hash> dependency;
+                    serialiser.read(&dependency.first);
+                    serialiser.read(dependency.second.hashVal, 2);
+                    script->dependencies.push_back(dependency);
+                }
+
+                serialiser.read(&count);
+                for (uint32 i = 0; i < count; ++i)
+                {
+                    ScriptCompiler::ErrorPtr err(OGRE_NEW ScriptCompiler::Error());
+                    serialiser.read(&err->code);
+                    err->file = readCachedFile(serialiser, files);
+                    int32 line;
+                    serialiser.read(&line);
+                    err->line = line;
+                    serialiser.read(&err->message);
+                    script->errors.push_back(err);
+                }
+
+                script->nodes = AbstractNodeListPtr(OGRE_NEW_T(AbstractNodeList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+                readCachedNodes(serialiser, *script->nodes, 0, files);
+
+                mScriptCache[hash] = script;
+            }
+        }
+        catch (...)
+        {
+            mScriptCache.clear();
+            throw;
+        }
+
+        serialiser.readChunkEnd(SCRIPTCACHE_CHUNK_ID);
     }
 
     //-------------------------------------------------------------------------
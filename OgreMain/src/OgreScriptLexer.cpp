@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 #include "OgreException.h"
 #include "OgreScriptLexer.h"
+#include "OgreDataStream.h"
 
 namespace Ogre{
 
@@ -36,6 +37,31 @@ namespace Ogre{
     }
 
     ScriptTokenListPtr ScriptLexer::tokenize(const String &str, const String &source)
+    {
+        return tokenize(str.data(), str.size(), source);
+    }
+
+    ScriptTokenListPtr ScriptLexer::tokenize(const DataStreamPtr &stream, const String &source)
+    {
+        MemoryDataStream *memStream = dynamic_cast<MemoryDataStream*>(stream.get());
+        if(memStream)
+        {
+            // Read in place from the current position to the end
+            const char *str = reinterpret_cast<const char*>(memStream->getCurrentPtr());
+            const size_t length = memStream->size() - memStream->tell();
+            memStream->skip(static_cast<long>(length));
+            return tokenize(str, length, source);
+        }
+
+        // Not getAsString, which starts over from the beginning of the stream
+        String str;
+        char buf[4096];
+        while(!stream->eof())
+            str.append(buf, stream->read(buf, sizeof(buf)));
+        return tokenize(str, source);
+    }
+
+    ScriptTokenListPtr ScriptLexer::tokenize(const char *str, size_t length, const String &source)
     {
         // State enums
         enum{ READY = 0, COMMENT, MULTICOMMENT, WORD, QUOTE, VAR, POSSIBLECOMMENT };
@@ -49,7 +75,7 @@ namespace Ogre{
         ScriptTokenListPtr tokens(OGRE_NEW_T(ScriptTokenList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
 
         // Iterate over the input
-        String::const_iterator i = str.begin(), end = str.end();
+        const char *i = str, *end = str + length;
         while(i != end)
         {
             lastc = c;
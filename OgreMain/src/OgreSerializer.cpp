@@ -299,6 +299,20 @@ namespace Ogre {
         return id;
     }
     //---------------------------------------------------------------------
+    const void* Serializer::readInPlace(DataStreamPtr& stream, size_t size)
+    {
+        if (mFlipEndian)
+            return 0;
+
+        MemoryDataStream* memStream = dynamic_cast<MemoryDataStream*>(stream.get());
+        if (!memStream || memStream->size() - memStream->tell() < size)
+            return 0;
+
+        const void* pData = memStream->getCurrentPtr();
+        memStream->skip(static_cast<long>(size));
+        return pData;
+    }
+    //---------------------------------------------------------------------
     void Serializer::readBools(DataStreamPtr& stream, bool* pDest, size_t count)
     {
         //XXX Nasty Hack to convert 1 byte bools to 4 byte bools
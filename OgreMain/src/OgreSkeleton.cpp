@@ -252,12 +252,14 @@ namespace Ogre {
               if(animState->hasBlendMask())
               {
                 anim->apply(this, animState->getTimePosition(), animState->getWeight() * weightFactor,
-                  animState->getBlendMask(), linked ? linked->scale : 1.0f);
+                  animState->getBlendMask(), linked ? linked->scale : 1.0f,
+                  &animState->_getKeyFrameCursor());
               }
               else
               {
                 anim->apply(this, animState->getTimePosition(), 
-                  animState->getWeight() * weightFactor, linked ? linked->scale : 1.0f);
+                  animState->getWeight() * weightFactor, linked ? linked->scale : 1.0f,
+                  &animState->_getKeyFrameCursor());
               }
             }
         }
@@ -930,6 +932,15 @@ namespace Ogre {
                 }
             }
 
+            // Compressed tracks are copied from their keyframes
+            Animation* decompressed = 0;
+            if (srcAnimation->hasCompressedNodeTracks())
+            {
+                decompressed = srcAnimation->clone(srcAnimation->getName());
+                decompressed->decompressNodeTracks();
+                srcAnimation = decompressed;
+            }
+
             // Create target animation
             Animation* dstAnimation = this->createAnimation(srcAnimation->getName(), srcAnimation->getLength());
 
@@ -990,6 +1001,8 @@ namespace Ogre {
                     dstKeyFrame->setScale(deltaTransform.scale);
                 }
             }
+
+            OGRE_DELETE decompressed;
         }
     }
     //---------------------------------------------------------------------
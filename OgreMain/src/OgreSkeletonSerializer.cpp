@@ -68,6 +68,17 @@ namespace Ogre {
     void SkeletonSerializer::exportSkeleton(const Skeleton* pSkeleton, 
         DataStreamPtr stream, SkeletonVersion ver, Endian endianMode)
     {
+        if ((int)ver >= (int)SKELETON_VERSION_1_10)
+        {
+            // Only the compressed track chunk needs the new version, keep the
+            // file readable by older runtimes otherwise
+            bool anyCompressed = false;
+            for (unsigned short i = 0; i < pSkeleton->getNumAnimations() && !anyCompressed; ++i)
+                anyCompressed = pSkeleton->getAnimation(i)->hasCompressedNodeTracks();
+            if (!anyCompressed)
+                ver = SKELETON_VERSION_1_8;
+        }
+
         setWorkingVersion(ver);
         // Decide on endian mode
         determineEndianness(endianMode);
@@ -98,7 +109,18 @@ namespace Ogre {
             Animation* pAnim = pSkeleton->getAnimation(i);
             LogManager::getSingleton().stream()
                 << "Exporting animation: " << pAnim->getName();
-            writeAnimation(pSkeleton, pAnim, ver);
+            if (pAnim->hasCompressedNodeTracks() && (int)ver < (int)SKELETON_VERSION_1_10)
+            {
+                // Older versions have no compressed tracks, write the keyframes
+                Animation* decompressed = pAnim->clone(pAnim->getName());
+                decompressed->decompressNodeTracks();
+                writeAnimation(pSkeleton, decompressed, ver);
+                OGRE_DELETE decompressed;
+            }
+            else
+            {
+                writeAnimation(pSkeleton, pAnim, ver);
+            }
             LogManager::getSingleton().logMessage("Animation exported.");
 
         }
@@ -165,7 +187,9 @@ namespace Ogre {
     {
         if (ver == SKELETON_VERSION_1_0)
             mVersion = "[Serializer_v1.10]";
-        else mVersion = "[Serializer_v1.80]";
+        else if (ver == SKELETON_VERSION_1_8)
+            mVersion = "[Serializer_v1.80]";
+        else mVersion = "[Serializer_v1.100]";
     }
     //---------------------------------------------------------------------
     void SkeletonSerializer::writeSkeleton(const Skeleton* pSkel, SkeletonVersion ver)
@@ -270,10 +294,21 @@ namespace Ogre {
         }
 
         // Write all tracks
-        Animation::NodeTrackIterator trackIt = anim->getNodeTrackIterator();
-        while(trackIt.hasMoreElements())
+        BakedNodeAnimation* compressed = anim->_getCompressedNodeTracks();
+        if (compressed)
         {
-            writeAnimationTrack(pSkel, trackIt.getNext());
+            for (size_t t = 0; t < compressed->getNumTracks(); ++t)
+            {
+                writeCompressedAnimationTrack(pSkel, compressed->_getCompressedTrack(t));
+            }
+        }
+        else
+        {
+            Animation::NodeTrackIterator trackIt = anim->getNodeTrackIterator();
+            while(trackIt.hasMoreElements())
+            {
+                writeAnimationTrack(pSkel, trackIt.getNext());
+            }
         }
         }
         popInnerChunk(mStream);
@@ -318,6 +353,47 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void SkeletonSerializer::writeCompressedAnimationTrack(const Skeleton* pSkel,
+        const BakedNodeAnimation::CompressedTrack& track)
+    {
+        writeChunkHeader(SKELETON_ANIMATION_TRACK_COMPRESSED,
+            calcCompressedAnimationTrackSize(pSkel, track));
+
+        // unsigned short boneIndex     : Index of bone to apply to
+        writeShorts(&track.handle, 1);
+        // unsigned short numKeyFrames  : Number of keyframes
+        writeShorts(&track.numKeyFrames, 1);
+        // unsigned short flags         : 1 if the track has scales, 2 if it has a base rotation
+        uint16 flags = (track.hasScale ? 1 : 0) | (track.hasRotationBase ? 2 : 0);
+        writeShorts(&flags, 1);
+        // Vector3 translateMin, translateStep
+        writeObject(track.translateMin);
+        writeObject(track.translateStep);
+        if (track.hasScale)
+        {
+            // Vector3 scaleMin, scaleStep
+            writeObject(track.scaleMin);
+            writeObject(track.scaleStep);
+        }
+        if (track.hasRotationBase)
+        {
+            // Quaternion rotationBase
+            writeObject(track.rotationBase);
+        }
+        const size_t numValues = 3 * track.numKeyFrames;
+        // float times[numKeyFrames]
+        writeFloats(track.times, track.numKeyFrames);
+        // unsigned short rotations[numKeyFrames * 3]
+        writeShorts(track.rotations, numValues);
+        // unsigned short translations[numKeyFrames * 3]
+        writeShorts(track.translations, numValues);
+        if (track.hasScale)
+        {
+            // unsigned short scales[numKeyFrames * 3]
+            writeShorts(track.scales, numValues);
+        }
+    }
+    //---------------------------------------------------------------------
     size_t SkeletonSerializer::calcBoneSize(const Skeleton* pSkel, 
         const Bone* pBone)
     {
@@ -388,10 +464,21 @@ namespace Ogre {
         }
 
         // Nested animation tracks
-        Animation::NodeTrackIterator trackIt = pAnim->getNodeTrackIterator();
-        while(trackIt.hasMoreElements())
+        BakedNodeAnimation* compressed = pAnim->_getCompressedNodeTracks();
+        if (compressed)
+        {
+            for (size_t t = 0; t < compressed->getNumTracks(); ++t)
+            {
+                size += calcCompressedAnimationTrackSize(pSkel, compressed->_getCompressedTrack(t));
+            }
+        }
+        else
         {
-            size += calcAnimationTrackSize(pSkel, trackIt.getNext());
+            Animation::NodeTrackIterator trackIt = pAnim->getNodeTrackIterator();
+            while(trackIt.hasMoreElements())
+            {
+                size += calcAnimationTrackSize(pSkel, trackIt.getNext());
+            }
         }
 
         return size;
@@ -443,6 +530,35 @@ namespace Ogre {
         return size;
     }
     //---------------------------------------------------------------------
+    size_t SkeletonSerializer::calcCompressedAnimationTrackSize(const Skeleton* pSkel,
+        const BakedNodeAnimation::CompressedTrack& track)
+    {
+        size_t size = SSTREAM_OVERHEAD_SIZE;
+
+        // unsigned short boneIndex, numKeyFrames, flags
+        size += sizeof(uint16) * 3;
+        // Vector3 translateMin, translateStep
+        size += sizeof(float) * 6;
+        // float times[numKeyFrames]
+        size += sizeof(float) * track.numKeyFrames;
+        // unsigned short rotations[numKeyFrames * 3], translations[numKeyFrames * 3]
+        size += sizeof(uint16) * 6 * track.numKeyFrames;
+        if (track.hasScale)
+        {
+            // Vector3 scaleMin, scaleStep
+            size += sizeof(float) * 6;
+            // unsigned short scales[numKeyFrames * 3]
+            size += sizeof(uint16) * 3 * track.numKeyFrames;
+        }
+        if (track.hasRotationBase)
+        {
+            // Quaternion rotationBase
+            size += sizeof(float) * 4;
+        }
+
+        return size;
+    }
+    //---------------------------------------------------------------------
     void SkeletonSerializer::readFileHeader(DataStreamPtr& stream)
     {
         unsigned short headerID;
@@ -455,7 +571,8 @@ namespace Ogre {
             // Read version
             String ver = readString(stream);
             if ((ver != "[Serializer_v1.10]") &&
-                (ver != "[Serializer_v1.80]"))
+                (ver != "[Serializer_v1.80]") &&
+                (ver != "[Serializer_v1.100]"))
             {
                 OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, 
                     "Invalid file: version incompatible, file reports " + String(ver),
@@ -559,9 +676,13 @@ namespace Ogre {
                 }
             }
             
-            while(streamID == SKELETON_ANIMATION_TRACK && !stream->eof())
+            while((streamID == SKELETON_ANIMATION_TRACK ||
+                streamID == SKELETON_ANIMATION_TRACK_COMPRESSED) && !stream->eof())
             {
-                readAnimationTrack(stream, pAnim, pSkel);
+                if (streamID == SKELETON_ANIMATION_TRACK)
+                    readAnimationTrack(stream, pAnim, pSkel);
+                else
+                    readCompressedAnimationTrack(stream, pAnim, pSkel);
 
                 if (!stream->eof())
                 {
@@ -615,6 +736,65 @@ namespace Ogre {
         }
 
 
+    }
+    //---------------------------------------------------------------------
+    void SkeletonSerializer::readCompressedAnimationTrack(DataStreamPtr& stream, Animation* anim,
+        Skeleton* pSkel)
+    {
+        BakedNodeAnimation* compressed = anim->_getCompressedNodeTracks();
+        if (!compressed)
+        {
+            if (anim->getNumNodeTracks())
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                    "Animation " + anim->getName() + " mixes compressed and uncompressed tracks",
+                    "SkeletonSerializer::readCompressedAnimationTrack");
+            }
+            compressed = anim->_createCompressedNodeTracks();
+        }
+
+        BakedNodeAnimation::CompressedTrack track;
+        // unsigned short boneIndex     : Index of bone to apply to
+        readShorts(stream, &track.handle, 1);
+        // unsigned short numKeyFrames  : Number of keyframes
+        readShorts(stream, &track.numKeyFrames, 1);
+        // unsigned short flags         : 1 if the track has scales, 2 if it has a base rotation
+        uint16 flags;
+        readShorts(stream, &flags, 1);
+        track.hasScale = (flags & 1) != 0;
+        track.hasRotationBase = (flags & 2) != 0;
+        // Vector3 translateMin, translateStep
+        readObject(stream, track.translateMin);
+        readObject(stream, track.translateStep);
+        if (track.hasScale)
+        {
+            // Vector3 scaleMin, scaleStep
+            readObject(stream, track.scaleMin);
+            readObject(stream, track.scaleStep);
+        }
+        track.rotationBase = Quaternion::IDENTITY;
+        if (track.hasRotationBase)
+        {
+            // Quaternion rotationBase
+            readObject(stream, track.rotationBase);
+        }
+
+        // Create track, then read the keyframes straight into it
+        NodeAnimationTrack* pTrack = anim->_createCompressedNodeTrack(track.handle, pSkel->getBone(track.handle));
+        compressed->_addCompressedTrack(pTrack, track);
+
+        const size_t numValues = 3 * track.numKeyFrames;
+        // float times[numKeyFrames]
+        readFloats(stream, track.times, track.numKeyFrames);
+        // unsigned short rotations[numKeyFrames * 3]
+        readShorts(stream, track.rotations, numValues);
+        // unsigned short translations[numKeyFrames * 3]
+        readShorts(stream, track.translations, numValues);
+        if (track.hasScale)
+        {
+            // unsigned short scales[numKeyFrames * 3]
+            readShorts(stream, track.scales, numValues);
+        }
     }
     //---------------------------------------------------------------------
     void SkeletonSerializer::readKeyFrame(DataStreamPtr& stream, NodeAnimationTrack* track, 
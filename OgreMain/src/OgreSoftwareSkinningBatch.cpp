@@ -0,0 +1,207 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreSoftwareSkinningBatch.h"
+#include "OgreVertexIndexData.h"
+#include "OgreOptimisedUtil.h"
+#include "OgreRoot.h"
+
+// Number of vertices blended at once, must be a multiple of 4
+#define OGRE_SKINNING_BATCH_CHUNK_SIZE 1024
+
+namespace Ogre {
+
+    //-----------------------------------------------------------------------
+    SoftwareSkinningBatch::SoftwareSkinningBatch()
+        : mNumVertices(0)
+    {
+    }
+    //-----------------------------------------------------------------------
+    SoftwareSkinningBatch::~SoftwareSkinningBatch()
+    {
+        finish();
+    }
+    //-----------------------------------------------------------------------
+    void* SoftwareSkinningBatch::lockBuffer(const HardwareVertexBufferSharedPtr& buffer,
+        HardwareBuffer::LockOptions options)
+    {
+        LockedBufferMap::iterator i = mLockedBuffers.find(buffer.get());
+        if (i != mLockedBuffers.end())
+            return i->second.data;
+
+        LockedBuffer locked;
+        locked.buffer = buffer;
+        if (options == HardwareBuffer::HBL_READ_ONLY)
+            locked.data = buffer->lock(options);
+        else
+            locked.data = buffer->lock(options, Root::getSingleton().getFreqUpdatedBuffersUploadOption());
+        mLockedBuffers.insert(LockedBufferMap::value_type(buffer.get(), locked));
+        return locked.data;
+    }
+    //-----------------------------------------------------------------------
+    void SoftwareSkinningBatch::add(const VertexData* sourceVertexData, const VertexData* targetVertexData,
+        const Matrix4* const* blendMatrices, size_t numMatrices, bool blendNormals)
+    {
+        // Same element and buffer handling as Mesh::softwareVertexBlend
+        const VertexElement* srcElemPos =
+            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        const VertexElement* srcElemNorm =
+            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_NORMAL);
+        const VertexElement* srcElemBlendIndices =
+            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_BLEND_INDICES);
+        const VertexElement* srcElemBlendWeights =
+            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_BLEND_WEIGHTS);
+        assert (srcElemPos && srcElemBlendIndices && srcElemBlendWeights &&
+            "You must supply at least positions, blend indices and blend weights");
+        assert(srcElemBlendIndices->getType() == VET_UBYTE4 &&
+               "Blend indices must be VET_UBYTE4");
+        const VertexElement* destElemPos =
+            targetVertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        const VertexElement* destElemNorm =
+            targetVertexData->vertexDeclaration->findElementBySemantic(VES_NORMAL);
+
+        bool includeNormals = blendNormals && (srcElemNorm != NULL) && (destElemNorm != NULL);
+
+        const VertexBufferBinding* srcBinding = sourceVertexData->vertexBufferBinding;
+        const VertexBufferBinding* destBinding = targetVertexData->vertexBufferBinding;
+        const HardwareVertexBufferSharedPtr& srcPosBuf = srcBinding->getBuffer(srcElemPos->getSource());
+        const HardwareVertexBufferSharedPtr& srcIdxBuf = srcBinding->getBuffer(srcElemBlendIndices->getSource());
+        const HardwareVertexBufferSharedPtr& srcWeightBuf = srcBinding->getBuffer(srcElemBlendWeights->getSource());
+        const HardwareVertexBufferSharedPtr& destPosBuf = destBinding->getBuffer(destElemPos->getSource());
+
+        Blend blend;
+        blend.srcNorm = 0;
+        blend.destNorm = 0;
+        blend.srcNormStride = 0;
+        blend.destNormStride = 0;
+
+        float* pFloat;
+        unsigned char* pByte;
+
+        srcElemPos->baseVertexPointerToElement(lockBuffer(srcPosBuf, HardwareBuffer::HBL_READ_ONLY), &pFloat);
+        blend.srcPos = pFloat;
+        blend.srcPosStride = srcPosBuf->getVertexSize();
+
+        srcElemBlendIndices->baseVertexPointerToElement(lockBuffer(srcIdxBuf, HardwareBuffer::HBL_READ_ONLY), &pByte);
+        blend.blendIndices = pByte;
+        blend.blendIndexStride = srcIdxBuf->getVertexSize();
+
+        srcElemBlendWeights->baseVertexPointerToElement(lockBuffer(srcWeightBuf, HardwareBuffer::HBL_READ_ONLY), &pFloat);
+        blend.blendWeights = pFloat;
+        blend.blendWeightStride = srcWeightBuf->getVertexSize();
+        blend.numWeightsPerVertex = VertexElement::getTypeCount(srcElemBlendWeights->getType());
+
+        HardwareVertexBufferSharedPtr destNormBuf;
+        if (includeNormals)
+        {
+            const HardwareVertexBufferSharedPtr& srcNormBuf = srcBinding->getBuffer(srcElemNorm->getSource());
+            srcElemNorm->baseVertexPointerToElement(lockBuffer(srcNormBuf, HardwareBuffer::HBL_READ_ONLY), &pFloat);
+            blend.srcNorm = pFloat;
+            blend.srcNormStride = srcNormBuf->getVertexSize();
+            destNormBuf = destBinding->getBuffer(destElemNorm->getSource());
+        }
+
+        // Discard only if every byte of the buffer is written
+        const bool discardPos =
+            (destNormBuf != destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize()) ||
+            (destNormBuf == destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize() + destElemNorm->getSize());
+        destElemPos->baseVertexPointerToElement(lockBuffer(destPosBuf,
+            discardPos ? HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL), &pFloat);
+        blend.destPos = pFloat;
+        blend.destPosStride = destPosBuf->getVertexSize();
+
+        if (includeNormals)
+        {
+            const bool discardNorm = destNormBuf->getVertexSize() == destElemNorm->getSize();
+            destElemNorm->baseVertexPointerToElement(lockBuffer(destNormBuf,
+                discardNorm ? HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL), &pFloat);
+            blend.destNorm = pFloat;
+            blend.destNormStride = destNormBuf->getVertexSize();
+        }
+
+        blend.firstMatrix = mBlendMatrices.size();
+        mBlendMatrices.insert(mBlendMatrices.end(), blendMatrices, blendMatrices + numMatrices);
+
+        // Split in chunks, the vertices of a chunk are blended by the same thread
+        const size_t numVertices = targetVertexData->vertexCount;
+        Chunk chunk;
+        chunk.blend = mBlends.size();
+        for (size_t v = 0; v < numVertices; v += OGRE_SKINNING_BATCH_CHUNK_SIZE)
+        {
+            chunk.begin = v;
+            chunk.end = std::min(v + OGRE_SKINNING_BATCH_CHUNK_SIZE, numVertices);
+            mChunks.push_back(chunk);
+        }
+        mBlends.push_back(blend);
+        mNumVertices += numVertices;
+    }
+    //-----------------------------------------------------------------------
+    void SoftwareSkinningBatch::execute(size_t threadIdx, size_t numThreads)
+    {
+        OptimisedUtil* util = OptimisedUtil::getImplementation();
+
+        // Interleaved, since the chunks of one blend are consecutive
+        const size_t numChunks = mChunks.size();
+        for (size_t c = threadIdx; c < numChunks; c += numThreads)
+        {
+            const Chunk& chunk = mChunks[c];
+            const Blend& b = mBlends[chunk.blend];
+            const size_t first = chunk.begin;
+
+            util->softwareVertexSkinning(
+                reinterpret_cast<const float*>(reinterpret_cast<const char*>(b.srcPos) + first * b.srcPosStride),
+                reinterpret_cast<float*>(reinterpret_cast<char*>(b.destPos) + first * b.destPosStride),
+                b.srcNorm ?
+                    reinterpret_cast<const float*>(reinterpret_cast<const char*>(b.srcNorm) + first * b.srcNormStride) : 0,
+                b.destNorm ?
+                    reinterpret_cast<float*>(reinterpret_cast<char*>(b.destNorm) + first * b.destNormStride) : 0,
+                reinterpret_cast<const float*>(reinterpret_cast<const char*>(b.blendWeights) + first * b.blendWeightStride),
+                b.blendIndices + first * b.blendIndexStride,
+                &mBlendMatrices[b.firstMatrix],
+                b.srcPosStride, b.destPosStride,
+                b.srcNormStride, b.destNormStride,
+                b.blendWeightStride, b.blendIndexStride,
+                b.numWeightsPerVertex,
+                chunk.end - first);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SoftwareSkinningBatch::finish(void)
+    {
+        for (LockedBufferMap::iterator i = mLockedBuffers.begin(); i != mLockedBuffers.end(); ++i)
+        {
+            i->second.buffer->unlock();
+        }
+        mLockedBuffers.clear();
+        mBlends.clear();
+        mChunks.clear();
+        mBlendMatrices.clear();
+        mNumVertices = 0;
+    }
+
+}
@@ -0,0 +1,216 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreSpatialLightIndex.h"
+#include "OgreLight.h"
+
+namespace Ogre {
+
+    /// Upper limit of grid cells along each axis
+    static const size_t MAX_CELLS_PER_AXIS = 64;
+    //-----------------------------------------------------------------------
+    static inline size_t getCellCoordinate(Real value, Real minimum, Real invCellSize, size_t resolution)
+    {
+        if (resolution == 1)
+            return 0;
+        Real c = (value - minimum) * invCellSize;
+        if (!(c > 0))
+            return 0;
+        if (c >= resolution)
+            return resolution - 1;
+        return static_cast<size_t>(c);
+    }
+    //-----------------------------------------------------------------------
+    SpatialLightIndex::SpatialLightIndex()
+        : mNumLights(0)
+        , mInvCellSize(Vector3::ZERO)
+        , mQuery(0)
+    {
+        mResolution[0] = mResolution[1] = mResolution[2] = 1;
+    }
+    //-----------------------------------------------------------------------
+    SpatialLightIndex::~SpatialLightIndex()
+    {
+    }
+    //-----------------------------------------------------------------------
+    void SpatialLightIndex::build(const LightList& lights)
+    {
+        mNumLights = lights.size();
+        mGlobalLights.clear();
+        mCellLights.clear();
+        mLightQueries.assign(mNumLights, 0);
+        mQuery = 0;
+
+        // The grid spans the positions of the local lights
+        mBounds.setNull();
+        size_t numLocalLights = 0;
+        for (size_t i = 0; i < mNumLights; ++i)
+        {
+            if (lights[i]->getType() == Light::LT_DIRECTIONAL)
+            {
+                mGlobalLights.push_back(static_cast<uint32>(i));
+            }
+            else
+            {
+                mBounds.merge(lights[i]->getDerivedPosition());
+                ++numLocalLights;
+            }
+        }
+
+        mResolution[0] = mResolution[1] = mResolution[2] = 1;
+        mInvCellSize = Vector3::ZERO;
+        if (!numLocalLights)
+        {
+            mCellStart.assign(2, 0);
+            return;
+        }
+
+        // Aim for about two cells per light, spread over the axes the lights
+        // actually extend along, using cubic cells
+        const Vector3 size = mBounds.getSize();
+        const Real maxExtent = std::max(size.x, std::max(size.y, size.z));
+        if (maxExtent > 0)
+        {
+            int numAxes = 0;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (size[axis] > maxExtent * 1e-3f)
+                    ++numAxes;
+            }
+            const Real cellsAlongMaxExtent = std::min(Real(MAX_CELLS_PER_AXIS),
+                std::max(Real(1), Math::Pow(Real(numLocalLights * 2), Real(1) / numAxes)));
+            const Real cellSize = maxExtent / cellsAlongMaxExtent;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                mResolution[axis] = std::min(MAX_CELLS_PER_AXIS,
+                    std::max(size_t(1), static_cast<size_t>(Math::Ceil(size[axis] / cellSize))));
+                if (mResolution[axis] > 1)
+                    mInvCellSize[axis] = mResolution[axis] / size[axis];
+            }
+        }
+
+        // Count the lights of each cell, then fill the cells
+        const size_t numCells = mResolution[0] * mResolution[1] * mResolution[2];
+        mCellStart.assign(numCells + 1, 0);
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (size_t i = 0; i < mNumLights; ++i)
+            {
+                const Light* light = lights[i];
+                if (light->getType() == Light::LT_DIRECTIONAL)
+                    continue;
+
+                const Vector3& position = light->getDerivedPosition();
+                const Vector3 range(light->getAttenuationRange());
+                size_t cellMin[3], cellMax[3];
+                getCellRange(position - range, position + range, cellMin, cellMax);
+
+                for (size_t z = cellMin[2]; z <= cellMax[2]; ++z)
+                {
+                    for (size_t y = cellMin[1]; y <= cellMax[1]; ++y)
+                    {
+                        for (size_t x = cellMin[0]; x <= cellMax[0]; ++x)
+                        {
+                            const size_t cell = x + mResolution[0] * (y + mResolution[1] * z);
+                            if (pass == 0)
+                                ++mCellStart[cell + 1];
+                            else
+                                mCellLights[mCellStart[cell]++] = static_cast<uint32>(i);
+                        }
+                    }
+                }
+            }
+
+            if (pass == 0)
+            {
+                // Turn the counts into the offsets of the cells
+                for (size_t cell = 0; cell < numCells; ++cell)
+                    mCellStart[cell + 1] += mCellStart[cell];
+                mCellLights.resize(mCellStart[numCells]);
+            }
+        }
+
+        // Filling advanced each offset to the start of the next cell
+        for (size_t cell = numCells; cell > 0; --cell)
+            mCellStart[cell] = mCellStart[cell - 1];
+        mCellStart[0] = 0;
+    }
+    //-----------------------------------------------------------------------
+    void SpatialLightIndex::getCellRange(const Vector3& minimum, const Vector3& maximum,
+        size_t cellMin[3], size_t cellMax[3]) const
+    {
+        const Vector3& gridMin = mBounds.getMinimum();
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            cellMin[axis] = getCellCoordinate(minimum[axis], gridMin[axis], mInvCellSize[axis], mResolution[axis]);
+            cellMax[axis] = getCellCoordinate(maximum[axis], gridMin[axis], mInvCellSize[axis], mResolution[axis]);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SpatialLightIndex::query(const Vector3& centre, Real radius, IndexList& indices)
+    {
+        indices.assign(mGlobalLights.begin(), mGlobalLights.end());
+        if (mCellLights.empty())
+            return;
+
+        if (++mQuery == 0)
+        {
+            // Wrapped around, forget all previous queries
+            std::fill(mLightQueries.begin(), mLightQueries.end(), 0);
+            mQuery = 1;
+        }
+
+        // Slightly enlarged so rounding cannot drop a light touching the sphere
+        const Vector3 extent(radius * Real(1.0001));
+        size_t cellMin[3], cellMax[3];
+        getCellRange(centre - extent, centre + extent, cellMin, cellMax);
+
+        for (size_t z = cellMin[2]; z <= cellMax[2]; ++z)
+        {
+            for (size_t y = cellMin[1]; y <= cellMax[1]; ++y)
+            {
+                for (size_t x = cellMin[0]; x <= cellMax[0]; ++x)
+                {
+                    const size_t cell = x + mResolution[0] * (y + mResolution[1] * z);
+                    for (size_t i = mCellStart[cell]; i < mCellStart[cell + 1]; ++i)
+                    {
+                        const uint32 light = mCellLights[i];
+                        if (mLightQueries[light] != mQuery)
+                        {
+                            mLightQueries[light] = mQuery;
+                            indices.push_back(light);
+                        }
+                    }
+                }
+            }
+        }
+
+        std::sort(indices.begin(), indices.end());
+    }
+
+}
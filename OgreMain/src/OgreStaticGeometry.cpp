@@ -43,6 +43,7 @@ THE SOFTWARE.
 #include "OgreTechnique.h"
 #include "OgreLodStrategy.h"
 #include "OgreIteratorWrappers.h"
+#include "Threading/OgreTaskSchedulerWorkQueue.h"
 
 namespace Ogre {
 
@@ -65,7 +66,8 @@ namespace Ogre {
         mVisible(true),
         mRenderQueueID(RENDER_QUEUE_MAIN),
         mRenderQueueIDSet(false),
-        mVisibilityFlags(Ogre::MovableObject::getDefaultVisibilityFlags())
+        mVisibilityFlags(Ogre::MovableObject::getDefaultVisibilityFlags()),
+        mNextInstanceID(0)
     {
     }
     //--------------------------------------------------------------------------
@@ -285,6 +287,12 @@ namespace Ogre {
     //--------------------------------------------------------------------------
     void StaticGeometry::addEntity(Entity* ent, const Vector3& position,
         const Quaternion& orientation, const Vector3& scale)
+    {
+        addEntityInstance(ent, position, orientation, scale);
+    }
+    //--------------------------------------------------------------------------
+    StaticGeometry::InstanceID StaticGeometry::addEntityInstance(Entity* ent,
+        const Vector3& position, const Quaternion& orientation, const Vector3& scale)
     {
         const MeshPtr& msh = ent->getMesh();
         // Validate
@@ -295,7 +303,8 @@ namespace Ogre {
                 "Using only highest LOD level for mesh " + msh->getName(), LML_CRITICAL);
         }
 
-        AxisAlignedBox sharedWorldBounds;
+        // ids only increase, which keeps the queued submeshes sorted by id
+        InstanceID instance = mNextInstanceID++;
         // queue this entities submeshes and choice of material
         // also build the lists of geometry to be used for the source of lods
         for (uint i = 0; i < ent->getNumSubEntities(); ++i)
@@ -305,6 +314,8 @@ namespace Ogre {
 
             // Get the geometry for this SubMesh
             q->submesh = se->getSubMesh();
+            q->instanceID = instance;
+            q->region = 0;
             q->geometryLodList = determineGeometry(q->submesh);
             q->materialName = se->getMaterialName();
             q->orientation = orientation;
@@ -317,6 +328,39 @@ namespace Ogre {
 
             mQueuedSubMeshes.push_back(q);
         }
+        return instance;
+    }
+    //--------------------------------------------------------------------------
+    namespace
+    {
+        struct QueuedSubMeshInstanceLess
+        {
+            bool operator()(const StaticGeometry::QueuedSubMesh* q,
+                StaticGeometry::InstanceID instance) const
+            {
+                return q->instanceID < instance;
+            }
+        };
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::removeEntity(InstanceID instance)
+    {
+        QueuedSubMeshList::iterator first = std::lower_bound(
+            mQueuedSubMeshes.begin(), mQueuedSubMeshes.end(), instance,
+            QueuedSubMeshInstanceLess());
+        QueuedSubMeshList::iterator last = first;
+        while (last != mQueuedSubMeshes.end() && (*last)->instanceID == instance)
+        {
+            Region* region = (*last)->region;
+            if (region)
+            {
+                region->_removeInstance(instance);
+                mDirtyRegions.insert(region->getID());
+            }
+            OGRE_DELETE *last;
+            ++last;
+        }
+        mQueuedSubMeshes.erase(first, last);
     }
     //--------------------------------------------------------------------------
     StaticGeometry::SubMeshLodGeometryLinkList*
@@ -559,22 +603,139 @@ namespace Ogre {
             Region* region = getRegion(qsm->worldBounds, true);
             region->assign(qsm);
         }
+
+        // Now build every region
+        vector<Region*>::type regions;
+        regions.reserve(mRegionMap.size());
+        for (RegionMap::iterator ri = mRegionMap.begin();
+            ri != mRegionMap.end(); ++ri)
+        {
+            regions.push_back(ri->second);
+        }
+        buildRegions(regions);
+        mBuilt = true;
+
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::update(void)
+    {
+        if (!mBuilt)
+        {
+            build();
+            return;
+        }
+
+        // Allocate the meshes added since the last build to regions
+        for (QueuedSubMeshList::iterator qi = mQueuedSubMeshes.begin();
+            qi != mQueuedSubMeshes.end(); ++qi)
+        {
+            QueuedSubMesh* qsm = *qi;
+            if (!qsm->region)
+            {
+                Region* region = getRegion(qsm->worldBounds, true);
+                region->assign(qsm);
+                mDirtyRegions.insert(region->getID());
+            }
+        }
+
+        // Clear the touched regions, deleting the ones left empty
+        vector<Region*>::type regions;
+        for (set<uint32>::type::iterator di = mDirtyRegions.begin();
+            di != mDirtyRegions.end(); ++di)
+        {
+            RegionMap::iterator ri = mRegionMap.find(*di);
+            assert(ri != mRegionMap.end());
+            Region* region = ri->second;
+            if (region->getNumQueuedSubMeshes() == 0)
+            {
+                mOwner->extractMovableObject(region);
+                OGRE_DELETE region;
+                mRegionMap.erase(ri);
+            }
+            else
+            {
+                region->_clear();
+                regions.push_back(region);
+            }
+        }
+        mDirtyRegions.clear();
+
+        buildRegions(regions);
+    }
+    //--------------------------------------------------------------------------
+    namespace
+    {
+        /// Copies the geometry of a range of buckets
+        struct GeometryBucketCopier
+        {
+            const StaticGeometry::MaterialBucket::GeometryBucketList& buckets;
+            const StaticGeometry::SourceBufferLocks& sources;
+            bool stencilShadows;
+
+            GeometryBucketCopier(
+                const StaticGeometry::MaterialBucket::GeometryBucketList& b,
+                const StaticGeometry::SourceBufferLocks& s, bool stencil)
+                : buckets(b), sources(s), stencilShadows(stencil) {}
+
+            void operator()(size_t begin, size_t end) const
+            {
+                for (size_t i = begin; i < end; ++i)
+                    buckets[i]->_copyGeometry(stencilShadows, sources);
+            }
+        };
+
+        /// Builds a region or bucket on the calling thread only
+        template <typename T>
+        void buildSerially(T* target, bool stencilShadows)
+        {
+            StaticGeometry::SourceBufferLocks sources;
+            StaticGeometry::MaterialBucket::GeometryBucketList buckets;
+            target->_beginBuild(stencilShadows, sources, buckets);
+            GeometryBucketCopier(buckets, sources, stencilShadows)(0, buckets.size());
+            sources.unlockAll();
+            target->_endBuild(stencilShadows);
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::buildRegions(const vector<Region*>::type& regions)
+    {
         bool stencilShadows = false;
         if (mCastShadows && mOwner->isShadowTechniqueStencilBased())
         {
             stencilShadows = true;
         }
 
-        // Now tell each region to build itself
-        for (RegionMap::iterator ri = mRegionMap.begin();
-            ri != mRegionMap.end(); ++ri)
+        // Buffers can only be created and locked from this thread, so do it
+        // up front for all the regions
+        SourceBufferLocks sources;
+        MaterialBucket::GeometryBucketList buckets;
+        for (vector<Region*>::type::const_iterator ri = regions.begin();
+            ri != regions.end(); ++ri)
         {
-            ri->second->build(stencilShadows);
-            
-            // Set the visibility flags on these regions
-            ri->second->setVisibilityFlags(mVisibilityFlags);
+            (*ri)->_beginBuild(stencilShadows, sources, buckets);
         }
 
+        // The buckets write to separate buffers, so the copying and
+        // transforming of the geometry can be spread over the worker threads
+        GeometryBucketCopier copier(buckets, sources, stencilShadows);
+        TaskScheduler* scheduler = 0;
+        Root* root = Root::getSingletonPtr();
+        if (root && root->getWorkQueue())
+            scheduler = root->getWorkQueue()->getTaskScheduler();
+        if (scheduler && buckets.size() > 1)
+            scheduler->parallelFor(0, buckets.size(), 1, copier);
+        else
+            copier(0, buckets.size());
+        sources.unlockAll();
+
+        for (vector<Region*>::type::const_iterator ri = regions.begin();
+            ri != regions.end(); ++ri)
+        {
+            (*ri)->_endBuild(stencilShadows);
+
+            // Set the visibility flags on these regions
+            (*ri)->setVisibilityFlags(mVisibilityFlags);
+        }
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::destroy(void)
@@ -587,6 +748,13 @@ namespace Ogre {
             OGRE_DELETE i->second;
         }
         mRegionMap.clear();
+        mDirtyRegions.clear();
+        for (QueuedSubMeshList::iterator qi = mQueuedSubMeshes.begin();
+            qi != mQueuedSubMeshes.end(); ++qi)
+        {
+            (*qi)->region = 0;
+        }
+        mBuilt = false;
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::reset(void)
@@ -748,7 +916,12 @@ namespace Ogre {
     void StaticGeometry::Region::assign(QueuedSubMesh* qmesh)
     {
         mQueuedSubMeshes.push_back(qmesh);
-
+        qmesh->region = this;
+        mergeLodAndBounds(qmesh);
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::Region::mergeLodAndBounds(QueuedSubMesh* qmesh)
+    {
         // Set/check LOD strategy
         const LodStrategy *lodStrategy = qmesh->submesh->parent->getLodStrategy();
         if (mLodStrategy == 0)
@@ -794,10 +967,19 @@ namespace Ogre {
     //--------------------------------------------------------------------------
     void StaticGeometry::Region::build(bool stencilShadows)
     {
-        // Create a node
-        mNode = mSceneMgr->getRootSceneNode()->createChildSceneNode(mName,
-            mCentre);
-        mNode->attachObject(this);
+        buildSerially(this, stencilShadows);
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::Region::_beginBuild(bool stencilShadows,
+        SourceBufferLocks& sources, MaterialBucket::GeometryBucketList& buckets)
+    {
+        // Create a node, unless this is a rebuild
+        if (!mNode)
+        {
+            mNode = mSceneMgr->getRootSceneNode()->createChildSceneNode(mName,
+                mCentre);
+            mNode->attachObject(this);
+        }
         // We need to create enough LOD buckets to deal with the highest LOD
         // we encountered in all the meshes queued
         for (ushort lod = 0; lod < mLodValues.size(); ++lod)
@@ -814,11 +996,54 @@ namespace Ogre {
                 lodBucket->assign(*qi, lod);
             }
             // now build
-            lodBucket->build(stencilShadows);
+            lodBucket->_beginBuild(stencilShadows, sources, buckets);
         }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::Region::_endBuild(bool stencilShadows)
+    {
+        for (LODBucketList::iterator i = mLodBucketList.begin();
+            i != mLodBucketList.end(); ++i)
+        {
+            (*i)->_endBuild(stencilShadows);
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::Region::_clear(void)
+    {
+        for (LODBucketList::iterator i = mLodBucketList.begin();
+            i != mLodBucketList.end(); ++i)
+        {
+            OGRE_DELETE *i;
+        }
+        mLodBucketList.clear();
+        mCurrentLod = 0;
 
-
-
+        // Recalculate the LOD values and bounds from the remaining meshes
+        mLodValues.clear();
+        mLodStrategy = 0;
+        mAABB.setNull();
+        mBoundingRadius = 0.0f;
+        for (QueuedSubMeshList::iterator qi = mQueuedSubMeshes.begin();
+            qi != mQueuedSubMeshes.end(); ++qi)
+        {
+            mergeLodAndBounds(*qi);
+        }
+        // The bounds changed
+        if (mNode)
+            mNode->needUpdate();
+        _notifyMoved();
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::Region::_removeInstance(InstanceID instance)
+    {
+        QueuedSubMeshList::iterator first = std::lower_bound(
+            mQueuedSubMeshes.begin(), mQueuedSubMeshes.end(), instance,
+            QueuedSubMeshInstanceLess());
+        QueuedSubMeshList::iterator last = first;
+        while (last != mQueuedSubMeshes.end() && (*last)->instanceID == instance)
+            ++last;
+        mQueuedSubMeshes.erase(first, last);
     }
     //--------------------------------------------------------------------------
     const String& StaticGeometry::Region::getMovableType(void) const
@@ -1095,18 +1320,33 @@ namespace Ogre {
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::LODBucket::build(bool stencilShadows)
+    {
+        buildSerially(this, stencilShadows);
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::LODBucket::_beginBuild(bool stencilShadows,
+        SourceBufferLocks& sources, MaterialBucket::GeometryBucketList& buckets)
+    {
+        // Just pass this on to child buckets
+        for (MaterialBucketMap::iterator i = mMaterialBucketMap.begin();
+            i != mMaterialBucketMap.end(); ++i)
+        {
+            i->second->_beginBuild(stencilShadows, sources, buckets);
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::LODBucket::_endBuild(bool stencilShadows)
     {
 
         EdgeListBuilder eb;
         size_t vertexSet = 0;
 
-        // Just pass this on to child buckets
         for (MaterialBucketMap::iterator i = mMaterialBucketMap.begin();
             i != mMaterialBucketMap.end(); ++i)
         {
             MaterialBucket* mat = i->second;
 
-            mat->build(stencilShadows);
+            mat->_endBuild(stencilShadows);
 
             if (stencilShadows)
             {
@@ -1307,6 +1547,12 @@ namespace Ogre {
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::MaterialBucket::build(bool stencilShadows)
+    {
+        buildSerially(this, stencilShadows);
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::MaterialBucket::_beginBuild(bool stencilShadows,
+        SourceBufferLocks& sources, GeometryBucketList& buckets)
     {
         mTechnique = 0;
         mMaterial = MaterialManager::getSingleton().getByName(mMaterialName);
@@ -1317,11 +1563,21 @@ namespace Ogre {
                 "StaticGeometry::MaterialBucket::build");
         }
         mMaterial->load();
-        // tell the geometry buckets to build
+        // tell the geometry buckets to prepare their buffers
+        for (GeometryBucketList::iterator i = mGeometryBucketList.begin();
+            i != mGeometryBucketList.end(); ++i)
+        {
+            (*i)->_beginBuild(stencilShadows, sources);
+            buckets.push_back(*i);
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::MaterialBucket::_endBuild(bool stencilShadows)
+    {
         for (GeometryBucketList::iterator i = mGeometryBucketList.begin();
             i != mGeometryBucketList.end(); ++i)
         {
-            (*i)->build(stencilShadows);
+            (*i)->_endBuild(stencilShadows);
         }
     }
     //--------------------------------------------------------------------------
@@ -1417,7 +1673,7 @@ namespace Ogre {
     StaticGeometry::GeometryBucket::GeometryBucket(MaterialBucket* parent,
         const String& formatString, const VertexData* vData,
         const IndexData* iData)
-        : Renderable(), mParent(parent), mFormatString(formatString)
+        : Renderable(), mParent(parent), mFormatString(formatString), mIndexLock(0)
     {
         // Clone the structure from the example
         mVertexData = vData->clone(false);
@@ -1535,8 +1791,18 @@ namespace Ogre {
     //--------------------------------------------------------------------------
     void StaticGeometry::GeometryBucket::build(bool stencilShadows)
     {
-        // Ok, here's where we transfer the vertices and indexes to the shared
-        // buffers
+        SourceBufferLocks sources;
+        _beginBuild(stencilShadows, sources);
+        _copyGeometry(stencilShadows, sources);
+        sources.unlockAll();
+        _endBuild(stencilShadows);
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::GeometryBucket::_beginBuild(bool stencilShadows,
+        SourceBufferLocks& sources)
+    {
+        // Ok, here's where we create the shared buffers the vertices and 
+        // indexes will be transferred to
         // Shortcuts
         VertexDeclaration* dcl = mVertexData->vertexDeclaration;
         VertexBufferBinding* binds = mVertexData->vertexBufferBinding;
@@ -1545,25 +1811,12 @@ namespace Ogre {
         mIndexData->indexBuffer = HardwareBufferManager::getSingleton()
             .createIndexBuffer(mIndexType, mIndexData->indexCount,
                 HardwareBuffer::HBU_STATIC_WRITE_ONLY);
-        uint32* p32Dest = 0;
-        uint16* p16Dest = 0;
-        if (mIndexType == HardwareIndexBuffer::IT_32BIT)
-        {
-            p32Dest = static_cast<uint32*>(
-                mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
-        }
-        else
-        {
-            p16Dest = static_cast<uint16*>(
-                mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
-        }
+        mIndexLock = mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD);
         // create all vertex buffers, and lock
-        ushort b;
         ushort posBufferIdx = dcl->findElementBySemantic(VES_POSITION)->getSource();
 
-        vector<uchar*>::type destBufferLocks;
-        vector<VertexDeclaration::VertexElementList>::type bufferElements;
-        for (b = 0; b < binds->getBufferCount(); ++b)
+        mVertexLocks.clear();
+        for (ushort b = 0; b < binds->getBufferCount(); ++b)
         {
             size_t vertexCount = mVertexData->vertexCount;
             // Need to double the vertex count for the position buffer
@@ -1581,9 +1834,49 @@ namespace Ogre {
                     vertexCount,
                     HardwareBuffer::HBU_STATIC_WRITE_ONLY);
             binds->setBinding(b, vbuf);
-            uchar* pLock = static_cast<uchar*>(
-                vbuf->lock(HardwareBuffer::HBL_DISCARD));
-            destBufferLocks.push_back(pLock);
+            mVertexLocks.push_back(static_cast<uchar*>(
+                vbuf->lock(HardwareBuffer::HBL_DISCARD)));
+        }
+
+        // Lock the sources, each buffer is locked once however many 
+        // geometry items share it
+        for (QueuedGeometryList::iterator gi = mQueuedGeometry.begin();
+            gi != mQueuedGeometry.end(); ++gi)
+        {
+            SubMeshLodGeometryLink* geometry = (*gi)->geometry;
+            sources.lock(geometry->indexData->indexBuffer.get());
+            VertexBufferBinding* srcBinds = geometry->vertexData->vertexBufferBinding;
+            for (ushort b = 0; b < binds->getBufferCount(); ++b)
+            {
+                sources.lock(srcBinds->getBuffer(b).get());
+            }
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::GeometryBucket::_copyGeometry(bool stencilShadows,
+        const SourceBufferLocks& sources)
+    {
+        // Ok, here's where we transfer the vertices and indexes to the shared
+        // buffers
+        // Shortcuts
+        VertexDeclaration* dcl = mVertexData->vertexDeclaration;
+        VertexBufferBinding* binds = mVertexData->vertexBufferBinding;
+        ushort b;
+
+        uint32* p32Dest = 0;
+        uint16* p16Dest = 0;
+        if (mIndexType == HardwareIndexBuffer::IT_32BIT)
+        {
+            p32Dest = static_cast<uint32*>(mIndexLock);
+        }
+        else
+        {
+            p16Dest = static_cast<uint16*>(mIndexLock);
+        }
+        vector<uchar*>::type destBufferLocks = mVertexLocks;
+        vector<VertexDeclaration::VertexElementList>::type bufferElements;
+        for (b = 0; b < binds->getBufferCount(); ++b)
+        {
             // Pre-cache vertex elements per buffer
             bufferElements.push_back(dcl->findElementsBySource(b));
         }
@@ -1599,31 +1892,22 @@ namespace Ogre {
             QueuedGeometry* geom = *gi;
             // Copy indexes across with offset
             IndexData* srcIdxData = geom->geometry->indexData;
+            const void* pSrcIdx = sources.get(srcIdxData->indexBuffer.get());
             if (mIndexType == HardwareIndexBuffer::IT_32BIT)
             {
-                // Lock source indexes
-                uint32* pSrc = static_cast<uint32*>(
-                    srcIdxData->indexBuffer->lock(
-                        srcIdxData->indexStart * srcIdxData->indexBuffer->getIndexSize(), 
-                        srcIdxData->indexCount * srcIdxData->indexBuffer->getIndexSize(),
-                        HardwareBuffer::HBL_READ_ONLY));
+                const uint32* pSrc = static_cast<const uint32*>(pSrcIdx) +
+                    srcIdxData->indexStart;
 
                 copyIndexes(pSrc, p32Dest, srcIdxData->indexCount, indexOffset);
                 p32Dest += srcIdxData->indexCount;
-                srcIdxData->indexBuffer->unlock();
             }
             else
             {
-                // Lock source indexes
-                uint16* pSrc = static_cast<uint16*>(
-                    srcIdxData->indexBuffer->lock(
-                    srcIdxData->indexStart * srcIdxData->indexBuffer->getIndexSize(), 
-                    srcIdxData->indexCount * srcIdxData->indexBuffer->getIndexSize(),
-                    HardwareBuffer::HBL_READ_ONLY));
+                const uint16* pSrc = static_cast<const uint16*>(pSrcIdx) +
+                    srcIdxData->indexStart;
 
                 copyIndexes(pSrc, p16Dest, srcIdxData->indexCount, indexOffset);
                 p16Dest += srcIdxData->indexCount;
-                srcIdxData->indexBuffer->unlock();
             }
 
             // Now deal with vertex buffers
@@ -1632,11 +1916,11 @@ namespace Ogre {
             VertexBufferBinding* srcBinds = srcVData->vertexBufferBinding;
             for (b = 0; b < binds->getBufferCount(); ++b)
             {
-                // lock source
-                HardwareVertexBufferSharedPtr srcBuf =
+                // source was locked by _beginBuild
+                const HardwareVertexBufferSharedPtr& srcBuf =
                     srcBinds->getBuffer(b);
                 uchar* pSrcBase = static_cast<uchar*>(
-                    srcBuf->lock(HardwareBuffer::HBL_READ_ONLY));
+                    const_cast<void*>(sources.get(srcBuf.get())));
                 // Get buffer lock pointer, we'll update this later
                 uchar* pDstBase = destBufferLocks[b];
                 size_t bufInc = srcBuf->getVertexSize();
@@ -1705,14 +1989,23 @@ namespace Ogre {
 
                 // Update pointer
                 destBufferLocks[b] = pDstBase;
-                srcBuf->unlock();
             }
 
             indexOffset += geom->geometry->vertexData->vertexCount;
         }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::GeometryBucket::_endBuild(bool stencilShadows)
+    {
+        VertexDeclaration* dcl = mVertexData->vertexDeclaration;
+        VertexBufferBinding* binds = mVertexData->vertexBufferBinding;
+        ushort b;
+        ushort posBufferIdx = dcl->findElementBySemantic(VES_POSITION)->getSource();
 
         // Unlock everything
         mIndexData->indexBuffer->unlock();
+        mIndexLock = 0;
+        mVertexLocks.clear();
         for (b = 0; b < binds->getBufferCount(); ++b)
         {
             binds->getBuffer(b)->unlock();
@@ -1768,6 +2061,34 @@ namespace Ogre {
 
     }
     //--------------------------------------------------------------------------
+    //--------------------------------------------------------------------------
+    const void* StaticGeometry::SourceBufferLocks::lock(HardwareBuffer* buffer)
+    {
+        LockMap::iterator i = mLocks.find(buffer);
+        if (i == mLocks.end())
+        {
+            i = mLocks.insert(LockMap::value_type(buffer,
+                buffer->lock(HardwareBuffer::HBL_READ_ONLY))).first;
+        }
+        return i->second;
+    }
+    //--------------------------------------------------------------------------
+    const void* StaticGeometry::SourceBufferLocks::get(HardwareBuffer* buffer) const
+    {
+        LockMap::const_iterator i = mLocks.find(buffer);
+        assert(i != mLocks.end() && "Source buffer was not locked");
+        return i->second;
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::SourceBufferLocks::unlockAll(void)
+    {
+        for (LockMap::iterator i = mLocks.begin(); i != mLocks.end(); ++i)
+        {
+            i->first->unlock();
+        }
+        mLocks.clear();
+    }
+    //--------------------------------------------------------------------------
 
 }
 
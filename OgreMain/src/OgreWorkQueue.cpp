@@ -58,7 +58,7 @@ namespace Ogre {
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     WorkQueue::Response::Response(const Request* rq, bool success, const Any& data, const String& msg)
-        : mRequest(rq), mSuccess(success), mMessages(msg), mData(data)
+        : mRequest(rq), mSuccess(success), mMessages(msg), mData(data), mNextQueued(0)
     {
         
     }
@@ -75,6 +75,8 @@ namespace Ogre {
         , mWorkerRenderSystemAccess(false)
         , mIsRunning(false)
         , mResposeTimeLimitMS(8)
+        , mQueuedResponses(0)
+        , mResponseOrder(0)
         , mWorkerFunc(0)
         , mRequestCount(0)
         , mPaused(false)
@@ -120,11 +122,23 @@ namespace Ogre {
         }
         mRequestQueue.clear();
 
-        for (ResponseQueue::iterator i = mResponseQueue.begin(); i != mResponseQueue.end(); ++i)
+        for (Response* r = getQueuedResponses(); r; )
         {
-            OGRE_DELETE (*i);
+            Response* next = r->mNextQueued;
+            OGRE_DELETE r;
+            r = next;
+        }
+        mQueuedResponses.set(0);
+
+        for (ResponseChannelMap::iterator c = mResponseChannels.begin(); c != mResponseChannels.end(); ++c)
+        {
+            ResponseQueue& responses = c->second.responses;
+            for (ResponseQueue::iterator i = responses.begin(); i != responses.end(); ++i)
+            {
+                OGRE_DELETE i->response;
+            }
         }
-        mResponseQueue.clear();
+        mResponseChannels.clear();
     }
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::addRequestHandler(uint16 channel, RequestHandler* rh)
@@ -320,12 +334,26 @@ namespace Ogre {
         {
                     OGRE_LOCK_MUTEX(mResponseMutex);
 
-            for (ResponseQueue::iterator i = mResponseQueue.begin(); i != mResponseQueue.end(); ++i)
+            // Workers only ever push in front of the list, the rest of it stays
+            // untouched while we hold the lock
+            for (Response* r = getQueuedResponses(); r; r = r->mNextQueued)
             {
-                if( (*i)->getRequest()->getID() == id )
+                if( r->getRequest()->getID() == id )
                 {
-                    (*i)->abortRequest();
-                    break;
+                    r->abortRequest();
+                    return;
+                }
+            }
+            for (ResponseChannelMap::iterator c = mResponseChannels.begin(); c != mResponseChannels.end(); ++c)
+            {
+                ResponseQueue& responses = c->second.responses;
+                for (ResponseQueue::iterator i = responses.begin(); i != responses.end(); ++i)
+                {
+                    if( i->response->getRequest()->getID() == id )
+                    {
+                        i->response->abortRequest();
+                        return;
+                    }
                 }
             }
         }
@@ -374,11 +402,20 @@ namespace Ogre {
         {
                     OGRE_LOCK_MUTEX(mResponseMutex);
 
-            for (ResponseQueue::iterator i = mResponseQueue.begin(); i != mResponseQueue.end(); ++i)
+            for (Response* r = getQueuedResponses(); r; r = r->mNextQueued)
             {
-                if( (*i)->getRequest()->getChannel() == channel )
+                if( r->getRequest()->getChannel() == channel )
                 {
-                    (*i)->abortRequest();
+                    r->abortRequest();
+                }
+            }
+            ResponseChannelMap::iterator c = mResponseChannels.find(channel);
+            if (c != mResponseChannels.end())
+            {
+                ResponseQueue& responses = c->second.responses;
+                for (ResponseQueue::iterator i = responses.begin(); i != responses.end(); ++i)
+                {
+                    i->response->abortRequest();
                 }
             }
         }
@@ -447,9 +484,17 @@ namespace Ogre {
         {
                     OGRE_LOCK_MUTEX(mResponseMutex);
 
-            for (ResponseQueue::iterator i = mResponseQueue.begin(); i != mResponseQueue.end(); ++i)
+            for (Response* r = getQueuedResponses(); r; r = r->mNextQueued)
             {
-                (*i)->abortRequest();
+                r->abortRequest();
+            }
+            for (ResponseChannelMap::iterator c = mResponseChannels.begin(); c != mResponseChannels.end(); ++c)
+            {
+                ResponseQueue& responses = c->second.responses;
+                for (ResponseQueue::iterator i = responses.begin(); i != responses.end(); ++i)
+                {
+                    i->response->abortRequest();
+                }
             }
         }
 
@@ -556,8 +601,7 @@ namespace Ogre {
                     response->abortRequest();
                 }
                 // Queue response
-                OGRE_LOCK_MUTEX(mResponseMutex);
-                mResponseQueue.push_back(response);
+                queueResponse(response);
                 // no need to wake thread, this is processed by the main thread
             }
 
@@ -579,43 +623,223 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::processResponses() 
     {
-        unsigned long msStart = Root::getSingleton().getTimer()->getMilliseconds();
+        Timer* timer = Root::getSingleton().getTimer();
+        unsigned long msStart = timer->getMilliseconds();
         unsigned long msCurrent = 0;
 
+        {
+                    OGRE_LOCK_MUTEX(mResponseMutex);
+
+            // Fresh budgets for every channel
+            for (ResponseChannelMap::iterator c = mResponseChannels.begin(); c != mResponseChannels.end(); ++c)
+            {
+                c->second.responsesUsed = 0;
+                c->second.microsecondsUsed = 0;
+            }
+        }
+
         // keep going until we run out of responses or out of time
         while(true)
         {
             Response* response = 0;
+            ResponseChannel* channel = 0;
+            unsigned long usStart = timer->getMicroseconds();
             {
                             OGRE_LOCK_MUTEX(mResponseMutex);
 
-                if (mResponseQueue.empty())
+                moveQueuedResponses(usStart);
+                response = takeNextResponse(channel, usStart);
+                if (!response)
                     break; // exit loop
-                else
-                {
-                    response = mResponseQueue.front();
-                    mResponseQueue.pop_front();
-                }
             }
 
-            if (response)
-            {
-                processResponse(response);
+            processResponse(response);
 
-                OGRE_DELETE response;
+            OGRE_DELETE response;
 
+            {
+                            OGRE_LOCK_MUTEX(mResponseMutex);
+                // the channel is never removed, the pointer is still valid
+                channel->microsecondsUsed += timer->getMicroseconds() - usStart;
             }
 
             // time limit
             if (mResposeTimeLimitMS)
             {
-                msCurrent = Root::getSingleton().getTimer()->getMilliseconds();
+                msCurrent = timer->getMilliseconds();
                 if (msCurrent - msStart > mResposeTimeLimitMS)
                     break;
             }
         }
     }
     //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::queueResponse(Response* r)
+    {
+        // Lock-free push in front of the list; a swap of the whole list by
+        // moveQueuedResponses is the only other change, so there's no ABA issue.
+        // cas is a full barrier: it releases the response and its mNextQueued
+        // to the thread which takes the list.
+        size_t head;
+        do
+        {
+            head = mQueuedResponses.get();
+            r->mNextQueued = reinterpret_cast<Response*>(head);
+        } while (!mQueuedResponses.cas(head, reinterpret_cast<size_t>(r)));
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::Response* DefaultWorkQueueBase::getQueuedResponses(void)
+    {
+        // get() is a plain load; += 0 is the wrapper's barrier read, which
+        // pairs with the cas publishing the response in queueResponse
+        return reinterpret_cast<Response*>(mQueuedResponses += 0);
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::moveQueuedResponses(unsigned long now)
+    {
+        // The successful cas is a full barrier as well, so every mNextQueued
+        // written before publishing is visible once the list is ours
+        size_t head;
+        do
+        {
+            head = reinterpret_cast<size_t>(getQueuedResponses());
+            if (!head)
+                return;
+        } while (!mQueuedResponses.cas(head, 0));
+
+        // The list is most recent first
+        Response* reversed = 0;
+        for (Response* r = reinterpret_cast<Response*>(head); r; )
+        {
+            Response* next = r->mNextQueued;
+            r->mNextQueued = reversed;
+            reversed = r;
+            r = next;
+        }
+
+        for (Response* r = reversed; r; )
+        {
+            Response* next = r->mNextQueued;
+            r->mNextQueued = 0;
+
+            QueuedResponse queued;
+            queued.response = r;
+            queued.order = mResponseOrder++;
+            queued.time = now;
+            mResponseChannels[r->getRequest()->getChannel()].responses.push_back(queued);
+
+            r = next;
+        }
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::Response* DefaultWorkQueueBase::takeNextResponse(ResponseChannel*& channel, unsigned long now)
+    {
+        // Highest priority first, then oldest, among the channels with budget left
+        channel = 0;
+        for (ResponseChannelMap::iterator c = mResponseChannels.begin(); c != mResponseChannels.end(); ++c)
+        {
+            ResponseChannel& candidate = c->second;
+            if (candidate.responses.empty() ||
+                (candidate.maxResponses && candidate.responsesUsed >= candidate.maxResponses) ||
+                (candidate.maxMicroseconds && candidate.microsecondsUsed >= candidate.maxMicroseconds))
+                continue;
+
+            if (!channel || candidate.priority > channel->priority ||
+                (candidate.priority == channel->priority &&
+                 candidate.responses.front().order < channel->responses.front().order))
+            {
+                channel = &candidate;
+            }
+        }
+
+        if (!channel)
+            return 0;
+
+        const QueuedResponse& queued = channel->responses.front();
+        Response* response = queued.response;
+        const unsigned long latency = now - queued.time;
+        channel->responses.pop_front();
+
+        ++channel->responsesUsed;
+        ++channel->numProcessed;
+        channel->lastLatency = latency;
+        channel->maxLatency = std::max(channel->maxLatency, latency);
+        channel->totalLatency += latency;
+        return response;
+    }
+    //---------------------------------------------------------------------
+    DefaultWorkQueueBase::ResponseChannel::ResponseChannel()
+        : priority(0)
+        , maxResponses(0)
+        , maxMicroseconds(0)
+        , responsesUsed(0)
+        , microsecondsUsed(0)
+        , numProcessed(0)
+        , lastLatency(0)
+        , maxLatency(0)
+        , totalLatency(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::setResponseChannelPriority(uint16 channel, int priority)
+    {
+            OGRE_LOCK_MUTEX(mResponseMutex);
+
+        mResponseChannels[channel].priority = priority;
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::setResponseChannelBudget(uint16 channel, size_t maxResponses,
+        unsigned long maxMilliseconds)
+    {
+            OGRE_LOCK_MUTEX(mResponseMutex);
+
+        ResponseChannel& c = mResponseChannels[channel];
+        c.maxResponses = maxResponses;
+        c.maxMicroseconds = maxMilliseconds * 1000;
+    }
+    //---------------------------------------------------------------------
+    DefaultWorkQueueBase::ResponseChannelStats DefaultWorkQueueBase::getResponseChannelStats(uint16 channel)
+    {
+        ResponseChannelStats stats;
+        stats.queued = 0;
+        stats.processed = 0;
+        stats.lastLatency = 0;
+        stats.maxLatency = 0;
+        stats.averageLatency = 0;
+
+            OGRE_LOCK_MUTEX(mResponseMutex);
+
+        for (Response* r = getQueuedResponses(); r; r = r->mNextQueued)
+        {
+            if (r->getRequest()->getChannel() == channel)
+                ++stats.queued;
+        }
+
+        ResponseChannelMap::const_iterator c = mResponseChannels.find(channel);
+        if (c != mResponseChannels.end())
+        {
+            stats.queued += c->second.responses.size();
+            stats.processed = c->second.numProcessed;
+            stats.lastLatency = c->second.lastLatency;
+            stats.maxLatency = c->second.maxLatency;
+            if (c->second.numProcessed)
+                stats.averageLatency = static_cast<unsigned long>(c->second.totalLatency / c->second.numProcessed);
+        }
+        return stats;
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::resetResponseChannelStats()
+    {
+            OGRE_LOCK_MUTEX(mResponseMutex);
+
+        for (ResponseChannelMap::iterator c = mResponseChannels.begin(); c != mResponseChannels.end(); ++c)
+        {
+            c->second.numProcessed = 0;
+            c->second.lastLatency = 0;
+            c->second.maxLatency = 0;
+            c->second.totalLatency = 0;
+        }
+    }
+    //---------------------------------------------------------------------
     WorkQueue::Response* DefaultWorkQueueBase::processRequest(Request* r)
     {
         RequestHandlerListByChannel handlerListCopy;
@@ -36,6 +36,7 @@ THE SOFTWARE.
 
 #include <zzip/zzip.h>
 #include <zzip/plugin.h>
+#include <zlib.h>
 
 
 namespace Ogre {
@@ -77,6 +78,29 @@ namespace Ogre {
         return errorMsg;
     }
     //-----------------------------------------------------------------------
+    namespace
+    {
+        const uint32 ZIP_LOCAL_HEADER_SIGNATURE = 0x04034b50;
+        const uint32 ZIP_CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+        const uint32 ZIP_END_OF_DIRECTORY_SIGNATURE = 0x06054b50;
+        const size_t ZIP_LOCAL_HEADER_SIZE = 30;
+        const size_t ZIP_CENTRAL_HEADER_SIZE = 46;
+        const size_t ZIP_END_OF_DIRECTORY_SIZE = 22;
+        /// Inflate ahead of small reads rather than calling zlib for each of them
+        const size_t ZIP_INFLATE_AHEAD = 64 * 1024;
+
+        /// Zip fields are little endian and unaligned
+        uint16 readZipUint16(const uchar* p)
+        {
+            return static_cast<uint16>(p[0] | (p[1] << 8));
+        }
+        uint32 readZipUint32(const uchar* p)
+        {
+            return static_cast<uint32>(p[0]) | (static_cast<uint32>(p[1]) << 8) |
+                (static_cast<uint32>(p[2]) << 16) | (static_cast<uint32>(p[3]) << 24);
+        }
+    }
+    //-----------------------------------------------------------------------
     ZipArchive::ZipArchive(const String& name, const String& archType, zzip_plugin_io_handlers* pluginIo)
         : Archive(name, archType), mZzipDir(0), mPluginIo(pluginIo)
     {
@@ -90,8 +114,31 @@ namespace Ogre {
     void ZipArchive::load()
     {
         OGRE_LOCK_AUTO_MUTEX;
-        if (!mZzipDir)
+        if (!mZzipDir && mArchiveData.isNull())
         {
+            // Archives on disk are mapped and read directly where possible,
+            // zziplib opens the others and reports their errors
+            if (!mPluginIo)
+            {
+                bool mapped = false;
+                try
+                {
+                    mArchiveData = MemoryDataStreamPtr(OGRE_NEW MappedFileDataStream(mName, mName));
+                    mapped = readCentralDirectory();
+                }
+                catch (Exception&)
+                {
+                }
+                if (mapped)
+                {
+                    buildIndex();
+                    return;
+                }
+                mArchiveData.setNull();
+                mEntries.clear();
+                mFileList.clear();
+            }
+
             zzip_error_t zzipError;
             mZzipDir = zzip_dir_open_ext_io(mName.c_str(), &zzipError, 0, mPluginIo);
             checkZzipError(zzipError, "opening archive");
@@ -124,7 +171,187 @@ namespace Ogre {
                 mFileList.push_back(info);
 
             }
+            buildIndex();
+
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool ZipArchive::readCentralDirectory(void)
+    {
+        const uchar* data = mArchiveData->getPtr();
+        const size_t size = mArchiveData->size();
+        if (size < ZIP_END_OF_DIRECTORY_SIZE)
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, 
+                mName + " - error whilst opening archive: Zip file is too short.",
+                "ZipArchive::readCentralDirectory");
+        }
+
+        // The end of central directory record is followed by a comment of up to 64K
+        const uchar* end = 0;
+        const size_t searchEnd = size > ZIP_END_OF_DIRECTORY_SIZE + 0xffff ? 
+            size - ZIP_END_OF_DIRECTORY_SIZE - 0xffff : 0;
+        for (size_t pos = size - ZIP_END_OF_DIRECTORY_SIZE + 1; pos-- > searchEnd; )
+        {
+            if (readZipUint32(data + pos) == ZIP_END_OF_DIRECTORY_SIGNATURE &&
+                pos + ZIP_END_OF_DIRECTORY_SIZE + readZipUint16(data + pos + 20) <= size)
+            {
+                end = data + pos;
+                break;
+            }
+        }
+        if (!end)
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, 
+                mName + " - error whilst opening archive: " +
+                "Zip-file's central directory record missing. Is this a 7z file?",
+                "ZipArchive::readCentralDirectory");
+        }
+
+        const size_t numEntries = readZipUint16(end + 10);
+        const size_t directorySize = readZipUint32(end + 12);
+        const size_t directoryOffset = readZipUint32(end + 16);
+        // Multi-disk and zip64 archives are left to zziplib
+        if (readZipUint16(end + 4) != 0 || readZipUint16(end + 6) != 0 ||
+            numEntries == 0xffff || directoryOffset == 0xffffffff ||
+            directoryOffset + directorySize > size)
+            return false;
+
+        mFileList.reserve(numEntries);
+        mEntries.reserve(numEntries);
+        const uchar* header = data + directoryOffset;
+        const uchar* directoryEnd = header + directorySize;
+        for (size_t i = 0; i < numEntries; ++i)
+        {
+            if (header + ZIP_CENTRAL_HEADER_SIZE > directoryEnd ||
+                readZipUint32(header) != ZIP_CENTRAL_HEADER_SIGNATURE)
+                return false;
+
+            const uint16 flags = readZipUint16(header + 8);
+            const size_t nameLength = readZipUint16(header + 28);
+            const size_t extraLength = readZipUint16(header + 30);
+            const size_t commentLength = readZipUint16(header + 32);
+
+            ZipEntry entry;
+            entry.method = readZipUint16(header + 10);
+            entry.compressedSize = readZipUint32(header + 20);
+            entry.uncompressedSize = readZipUint32(header + 24);
+            entry.headerOffset = readZipUint32(header + 42);
+            // Encrypted entries and zip64 sizes
+            if ((flags & 1) || entry.compressedSize == 0xffffffff ||
+                entry.uncompressedSize == 0xffffffff || entry.headerOffset == 0xffffffff)
+                return false;
+
+            const uchar* name = header + ZIP_CENTRAL_HEADER_SIZE;
+            header = name + nameLength + extraLength + commentLength;
+            if (header > directoryEnd)
+                return false;
+
+            FileInfo info;
+            info.archive = this;
+            // Get basename / path
+            info.filename.assign(reinterpret_cast<const char*>(name), nameLength);
+            StringUtil::splitFilename(info.filename, info.basename, info.path);
+            // Get sizes
+            info.compressedSize = entry.compressedSize;
+            info.uncompressedSize = entry.uncompressedSize;
+            // folder entries
+            if (info.basename.empty())
+            {
+                info.filename = info.filename.substr (0, info.filename.length () - 1);
+                StringUtil::splitFilename(info.filename, info.basename, info.path);
+                info.compressedSize = size_t (-1);
+            }
+            else
+            {
+                info.filename = info.basename;
+            }
+            mFileList.push_back(info);
+            mEntries.push_back(entry);
+        }
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void ZipArchive::buildIndex(void)
+    {
+        mEntryIndex.clear();
+        mBaseNameIndex.clear();
+        mFileNameIndex.clear();
+        for (size_t i = 0; i < mFileList.size(); ++i)
+        {
+            const FileInfo& info = mFileList[i];
+            mFileNameIndex.insert(ZipEntryIndex::value_type(info.filename, i));
+            if (info.compressedSize == size_t (-1))
+                continue;
+
+            String name = info.path + info.basename;
+            StringUtil::toLowerCase(name);
+            mEntryIndex.insert(ZipEntryIndex::value_type(name, i));
+
+            name = info.basename;
+            StringUtil::toLowerCase(name);
+            std::pair<ZipEntryIndex::iterator, bool> inserted =
+                mBaseNameIndex.insert(ZipEntryIndex::value_type(name, i));
+            if (!inserted.second)
+                inserted.first->second = size_t (-1);
+        }
+    }
+    //-----------------------------------------------------------------------
+    size_t ZipArchive::findEntry(const String& filename) const
+    {
+        String name = filename;
+        StringUtil::toLowerCase(name);
+        ZipEntryIndex::const_iterator i = mEntryIndex.find(name);
+        if (i != mEntryIndex.end())
+            return i->second;
+
+        // Files may be referred to by base name when that is unique
+        i = mBaseNameIndex.find(name);
+        if (i != mBaseNameIndex.end())
+            return i->second;
+
+        return size_t (-1);
+    }
+    //-----------------------------------------------------------------------
+    DataStreamPtr ZipArchive::openEntry(size_t index) const
+    {
+        const FileInfo& info = mFileList[index];
+        const ZipEntry& entry = mEntries[index];
+        const String name = info.path + info.basename;
+        uchar* data = mArchiveData->getPtr();
+        const size_t size = mArchiveData->size();
+
+        // The local header repeats the name and has its own extra field
+        const uchar* header = data + entry.headerOffset;
+        if (entry.headerOffset + ZIP_LOCAL_HEADER_SIZE > size ||
+            readZipUint32(header) != ZIP_LOCAL_HEADER_SIGNATURE)
+        {
+            LogManager::getSingleton().logMessage(
+                mName + " - Unable to open file " + name + ", error was 'Corrupted archive.'", LML_CRITICAL);
+            return DataStreamPtr();
+        }
+        const size_t dataOffset = entry.headerOffset + ZIP_LOCAL_HEADER_SIZE +
+            readZipUint16(header + 26) + readZipUint16(header + 28);
+        if (dataOffset + entry.compressedSize > size)
+        {
+            LogManager::getSingleton().logMessage(
+                mName + " - Unable to open file " + name + ", error was 'Corrupted archive.'", LML_CRITICAL);
+            return DataStreamPtr();
+        }
 
+        switch (entry.method)
+        {
+        case 0:
+            return DataStreamPtr(OGRE_NEW ZipMappedDataStream(name, mArchiveData,
+                data + dataOffset, entry.uncompressedSize));
+        case Z_DEFLATED:
+            return DataStreamPtr(OGRE_NEW ZipInflateDataStream(name, mArchiveData,
+                data + dataOffset, entry.compressedSize, entry.uncompressedSize));
+        default:
+            LogManager::getSingleton().logMessage(
+                mName + " - Unable to open file " + name + ", error was 'Unsupported compression format.'", LML_CRITICAL);
+            return DataStreamPtr();
         }
     }
     //-----------------------------------------------------------------------
@@ -135,13 +362,33 @@ namespace Ogre {
         {
             zzip_dir_close(mZzipDir);
             mZzipDir = 0;
-            mFileList.clear();
         }
+        // Open streams keep their own reference to the mapping
+        mArchiveData.setNull();
+        mEntries.clear();
+        mEntryIndex.clear();
+        mBaseNameIndex.clear();
+        mFileNameIndex.clear();
+        mFileList.clear();
     
     }
     //-----------------------------------------------------------------------
     DataStreamPtr ZipArchive::open(const String& filename, bool readOnly)
     {
+        // The mapped archive only changes on load and unload, and each stream
+        // inflates on its own
+        if (!mArchiveData.isNull())
+        {
+            size_t index = findEntry(filename);
+            if (index == size_t (-1))
+            {
+                LogManager::getSingleton().logMessage(
+                    mName + " - Unable to open file " + filename + ", error was 'No such file.'", LML_CRITICAL);
+                return DataStreamPtr();
+            }
+            return openEntry(index);
+        }
+
         // zziplib is not threadsafe
         OGRE_LOCK_AUTO_MUTEX;
         String lookUpFileName = filename;
@@ -267,14 +514,6 @@ namespace Ogre {
         return ret;
     }
     //-----------------------------------------------------------------------
-    struct FileNameCompare : public std::binary_function<FileInfo, String, bool>
-    {
-        bool operator()(const Ogre::FileInfo& lhs, const String& filename) const
-        {
-            return lhs.filename == filename;
-        }
-    };
-    //-----------------------------------------------------------------------
     bool ZipArchive::exists(const String& filename)
     {       
         OGRE_LOCK_AUTO_MUTEX;
@@ -285,7 +524,7 @@ namespace Ogre {
             cleanName = tokens[tokens.size() - 1];
         }
 
-        return std::find_if (mFileList.begin(), mFileList.end(), std::bind2nd<FileNameCompare>(FileNameCompare(), cleanName)) != mFileList.end();
+        return mFileNameIndex.find(cleanName) != mFileNameIndex.end();
     }
     //---------------------------------------------------------------------
     time_t ZipArchive::getModifiedTime(const String& filename)
@@ -418,6 +657,130 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    ZipMappedDataStream::ZipMappedDataStream(const String& name, const MemoryDataStreamPtr& archiveData,
+        uchar* data, size_t size)
+        : MemoryDataStream(name, data, size, false, true), mArchiveData(archiveData)
+    {
+    }
+    //-----------------------------------------------------------------------
+    void ZipMappedDataStream::close(void)
+    {
+        MemoryDataStream::close();
+        mArchiveData.setNull();
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    ZipInflateDataStream::ZipInflateDataStream(const String& name, const MemoryDataStreamPtr& archiveData,
+        const uchar* compressedData, size_t compressedSize, size_t uncompressedSize)
+        : DataStream(name), mArchiveData(archiveData), mZStream(0), mBuffer(0), mInflated(0), mPos(0)
+    {
+        mSize = uncompressedSize;
+
+        mZStream = OGRE_ALLOC_T(z_stream, 1, MEMCATEGORY_GENERAL);
+        memset(mZStream, 0, sizeof(z_stream));
+        mZStream->next_in = const_cast<Bytef*>(compressedData);
+        mZStream->avail_in = static_cast<uInt>(compressedSize);
+        // Zip entries are raw deflate data without a zlib header
+        if (inflateInit2(mZStream, -MAX_WBITS) != Z_OK)
+        {
+            OGRE_FREE(mZStream, MEMCATEGORY_GENERAL);
+            mZStream = 0;
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                mName + " - error initialising zlib",
+                "ZipInflateDataStream::ZipInflateDataStream");
+        }
+    }
+    //-----------------------------------------------------------------------
+    ZipInflateDataStream::~ZipInflateDataStream()
+    {
+        close();
+    }
+    //-----------------------------------------------------------------------
+    void ZipInflateDataStream::inflateTo(size_t pos)
+    {
+        if (pos <= mInflated)
+            return;
+
+        int ret = Z_STREAM_END;
+        if (mZStream)
+        {
+            if (!mBuffer)
+                mBuffer = OGRE_ALLOC_T(uchar, mSize, MEMCATEGORY_GENERAL);
+
+            const size_t end = std::min(std::max(pos, mInflated + ZIP_INFLATE_AHEAD), mSize);
+            mZStream->next_out = mBuffer + mInflated;
+            mZStream->avail_out = static_cast<uInt>(end - mInflated);
+            ret = inflate(mZStream, Z_SYNC_FLUSH);
+            mInflated = end - mZStream->avail_out;
+            if (ret == Z_STREAM_END)
+            {
+                inflateEnd(mZStream);
+                OGRE_FREE(mZStream, MEMCATEGORY_GENERAL);
+                mZStream = 0;
+            }
+        }
+
+        if ((ret != Z_OK && ret != Z_STREAM_END) || mInflated < pos)
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                mName + " - error inflating zip data: Corrupted archive.",
+                "ZipInflateDataStream::inflateTo");
+        }
+    }
+    //-----------------------------------------------------------------------
+    size_t ZipInflateDataStream::read(void* buf, size_t count)
+    {
+        count = std::min(count, mSize - mPos);
+        if (!count)
+            return 0;
+        inflateTo(mPos + count);
+        memcpy(buf, mBuffer + mPos, count);
+        mPos += count;
+        return count;
+    }
+    //-----------------------------------------------------------------------
+    void ZipInflateDataStream::skip(long count)
+    {
+        if (count < 0 && static_cast<size_t>(-count) > mPos)
+            mPos = 0;
+        else
+            mPos = std::min(mPos + count, mSize);
+    }
+    //-----------------------------------------------------------------------
+    void ZipInflateDataStream::seek(size_t pos)
+    {
+        mPos = std::min(pos, mSize);
+    }
+    //-----------------------------------------------------------------------
+    size_t ZipInflateDataStream::tell(void) const
+    {
+        return mPos;
+    }
+    //-----------------------------------------------------------------------
+    bool ZipInflateDataStream::eof(void) const
+    {
+        return mPos >= mSize;
+    }
+    //-----------------------------------------------------------------------
+    void ZipInflateDataStream::close(void)
+    {
+        if (mZStream)
+        {
+            inflateEnd(mZStream);
+            OGRE_FREE(mZStream, MEMCATEGORY_GENERAL);
+            mZStream = 0;
+        }
+        if (mBuffer)
+        {
+            OGRE_FREE(mBuffer, MEMCATEGORY_GENERAL);
+            mBuffer = 0;
+        }
+        mArchiveData.setNull();
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
     //  ZipArchiveFactory
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
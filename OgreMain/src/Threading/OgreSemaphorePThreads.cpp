@@ -0,0 +1,65 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+#include "Threading/OgreSemaphore.h"
+
+namespace Ogre
+{
+    Semaphore::Semaphore( size_t initialCount ) : mCount( initialCount )
+    {
+        pthread_mutex_init( &mMutex, 0 );
+        pthread_cond_init( &mCondition, 0 );
+    }
+    //-----------------------------------------------------------------------------------
+    Semaphore::~Semaphore()
+    {
+        pthread_cond_destroy( &mCondition );
+        pthread_mutex_destroy( &mMutex );
+    }
+    //-----------------------------------------------------------------------------------
+    void Semaphore::wait(void)
+    {
+        pthread_mutex_lock( &mMutex );
+        while( !mCount )
+            pthread_cond_wait( &mCondition, &mMutex );
+        --mCount;
+        pthread_mutex_unlock( &mMutex );
+    }
+    //-----------------------------------------------------------------------------------
+    void Semaphore::post( size_t count )
+    {
+        pthread_mutex_lock( &mMutex );
+        mCount += count;
+        if( count == 1 )
+            pthread_cond_signal( &mCondition );
+        else
+            pthread_cond_broadcast( &mCondition );
+        pthread_mutex_unlock( &mMutex );
+    }
+}
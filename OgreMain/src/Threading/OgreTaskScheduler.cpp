@@ -0,0 +1,342 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "Threading/OgreTaskScheduler.h"
+
+namespace Ogre
+{
+    const size_t TaskScheduler::EXTERNAL_THREAD = ~static_cast<size_t>(0);
+
+    //---------------------------------------------------------------------
+    unsigned long taskSchedulerThread(ThreadHandle* threadHandle)
+    {
+        TaskScheduler* scheduler = reinterpret_cast<TaskScheduler*>(threadHandle->getUserParam());
+        scheduler->_threadMain(threadHandle->getThreadIdx());
+        return 0;
+    }
+    THREAD_DECLARE(taskSchedulerThread);
+    //---------------------------------------------------------------------
+    TaskScheduler::TaskGroup::TaskGroup()
+        : mPending(0), mWaiting(false)
+    {
+    }
+    //---------------------------------------------------------------------
+    TaskScheduler::TaskGroup::~TaskGroup()
+    {
+    }
+    //---------------------------------------------------------------------
+    bool TaskScheduler::TaskGroup::isDone(void)
+    {
+        mMutex.lock();
+        const bool done = mPending == 0;
+        mMutex.unlock();
+        return done;
+    }
+    //---------------------------------------------------------------------
+    TaskScheduler::TaskScheduler()
+        : mListener(0), mStartBarrier(0), mNumSleeping(0), mShuttingDown(false), mNextQueue(0)
+    {
+        mQueues.push_back(OGRE_NEW_T(WorkerQueue, MEMCATEGORY_GENERAL)());
+    }
+    //---------------------------------------------------------------------
+    TaskScheduler::~TaskScheduler()
+    {
+        shutdown();
+        OGRE_DELETE_T(mQueues.back(), WorkerQueue, MEMCATEGORY_GENERAL);
+    }
+    //---------------------------------------------------------------------
+    void TaskScheduler::startup(size_t numThreads, Listener* listener)
+    {
+        shutdown();
+        if (!numThreads)
+            return;
+
+        mListener = listener;
+        mShuttingDown = false;
+        mNumSleeping = 0;
+
+        // The queues must exist before any worker looks for a task
+        for (size_t i = 0; i < numThreads; ++i)
+            mQueues.insert(mQueues.begin(), OGRE_NEW_T(WorkerQueue, MEMCATEGORY_GENERAL)());
+
+        mStartBarrier = OGRE_NEW_T(Barrier, MEMCATEGORY_GENERAL)(numThreads + 1);
+        mThreads.reserve(numThreads);
+        for (size_t i = 0; i < numThreads; ++i)
+            mThreads.push_back(Threads::CreateThread(THREAD_GET(taskSchedulerThread), i, this));
+
+        mStartBarrier->sync();
+    }
+    //---------------------------------------------------------------------
+    void TaskScheduler::shutdown(void)
+    {
+        if (mThreads.empty())
+            return;
+
+        mSleepMutex.lock();
+        mShuttingDown = true;
+        const size_t numSleeping = mNumSleeping;
+        mNumSleeping = 0;
+        mSleepMutex.unlock();
+        if (numSleeping)
+            mWakeUp.post(numSleeping);
+
+        Threads::WaitForThreads(mThreads);
+        mThreads.clear();
+
+        // Workers may still be leaving the barrier when startup returns
+        OGRE_DELETE_T(mStartBarrier, Barrier, MEMCATEGORY_GENERAL);
+        mStartBarrier = 0;
+
+        // Workers exit once there's nothing left to run, only the shared queue remains
+        for (size_t i = 0; i + 1 < mQueues.size(); ++i)
+            OGRE_DELETE_T(mQueues[i], WorkerQueue, MEMCATEGORY_GENERAL);
+        mQueues.erase(mQueues.begin(), mQueues.end() - 1);
+        mNextQueue = 0;
+        mListener = 0;
+    }
+    //---------------------------------------------------------------------
+    TaskScheduler::WorkerQueue* TaskScheduler::getQueue(size_t threadIdx) const
+    {
+        return threadIdx < mThreads.size() ? mQueues[threadIdx] : mQueues.back();
+    }
+    //---------------------------------------------------------------------
+    void TaskScheduler::submit(Task* task, TaskGroup* group, size_t threadIdx)
+    {
+        if (group)
+        {
+            group->mMutex.lock();
+            ++group->mPending;
+            group->mMutex.unlock();
+        }
+
+        WorkerQueue* queue = getQueue(threadIdx);
+        queue->mutex.lock();
+        queue->tasks.push_back(QueuedTask(task, group));
+        queue->mutex.unlock();
+
+        wakeWorkers(1);
+    }
+    //---------------------------------------------------------------------
+    void TaskScheduler::submit(Task* const* tasks, size_t count, TaskGroup* group)
+    {
+        if (!count)
+            return;
+
+        if (group)
+        {
+            group->mMutex.lock();
+            group->mPending += count;
+            group->mMutex.unlock();
+        }
+
+        const size_t numThreads = mThreads.size();
+        if (!numThreads)
+        {
+            WorkerQueue* queue = mQueues.back();
+            queue->mutex.lock();
+            for (size_t i = 0; i < count; ++i)
+                queue->tasks.push_back(QueuedTask(tasks[i], group));
+            queue->mutex.unlock();
+            return;
+        }
+
+        // Hand out contiguous runs so every worker starts with its share,
+        // beginning with a different worker every time
+        mSleepMutex.lock();
+        const size_t firstQueue = mNextQueue;
+        mNextQueue = (mNextQueue + 1) % numThreads;
+        mSleepMutex.unlock();
+
+        const size_t numQueues = std::min(count, numThreads);
+        size_t task = 0;
+        for (size_t i = 0; i < numQueues; ++i)
+        {
+            const size_t taskEnd = (count * (i + 1)) / numQueues;
+            WorkerQueue* queue = mQueues[(firstQueue + i) % numThreads];
+            queue->mutex.lock();
+            for (; task < taskEnd; ++task)
+                queue->tasks.push_back(QueuedTask(tasks[task], group));
+            queue->mutex.unlock();
+        }
+
+        wakeWorkers(count);
+    }
+    //---------------------------------------------------------------------
+    void TaskScheduler::wakeWorkers(size_t count)
+    {
+        mSleepMutex.lock();
+        const size_t numWoken = std::min(count, mNumSleeping);
+        mNumSleeping -= numWoken;
+        mSleepMutex.unlock();
+
+        if (numWoken)
+            mWakeUp.post(numWoken);
+    }
+    //---------------------------------------------------------------------
+    bool TaskScheduler::findTask(size_t threadIdx, QueuedTask& outTask)
+    {
+        // Own queue first, newest task as it's the most likely to be in cache
+        WorkerQueue* queue = mQueues[threadIdx];
+        queue->mutex.lock();
+        if (!queue->tasks.empty())
+        {
+            outTask = queue->tasks.back();
+            queue->tasks.pop_back();
+            queue->mutex.unlock();
+            return true;
+        }
+        queue->mutex.unlock();
+
+        // Then steal the oldest task of another queue, shared one included
+        const size_t numQueues = mQueues.size();
+        for (size_t i = 1; i < numQueues; ++i)
+        {
+            queue = mQueues[(threadIdx + i) % numQueues];
+            queue->mutex.lock();
+            if (!queue->tasks.empty())
+            {
+                outTask = queue->tasks.front();
+                queue->tasks.pop_front();
+                queue->mutex.unlock();
+                return true;
+            }
+            queue->mutex.unlock();
+        }
+
+        return false;
+    }
+    //---------------------------------------------------------------------
+    bool TaskScheduler::findGroupTask(const TaskGroup* group, QueuedTask& outTask)
+    {
+        // Only tasks of the group; any other one could take arbitrarily long
+        for (WorkerQueueList::iterator q = mQueues.begin(); q != mQueues.end(); ++q)
+        {
+            WorkerQueue* queue = *q;
+            queue->mutex.lock();
+            for (TaskDeque::iterator i = queue->tasks.begin(); i != queue->tasks.end(); ++i)
+            {
+                if (i->group == group)
+                {
+                    outTask = *i;
+                    queue->tasks.erase(i);
+                    queue->mutex.unlock();
+                    return true;
+                }
+            }
+            queue->mutex.unlock();
+        }
+
+        return false;
+    }
+    //---------------------------------------------------------------------
+    void TaskScheduler::runTask(const QueuedTask& task, size_t threadIdx)
+    {
+        task.task->execute(threadIdx);
+
+        if (task.group)
+        {
+            // The waiting thread may destroy the group as soon as it's unlocked
+            TaskGroup* group = task.group;
+            group->mMutex.lock();
+            if (--group->mPending == 0 && group->mWaiting)
+            {
+                group->mWaiting = false;
+                group->mCompleted.post();
+            }
+            group->mMutex.unlock();
+        }
+    }
+    //---------------------------------------------------------------------
+    void TaskScheduler::wait(TaskGroup& group, size_t threadIdx)
+    {
+        if (threadIdx >= mThreads.size())
+            threadIdx = EXTERNAL_THREAD;
+
+        QueuedTask task;
+        for (;;)
+        {
+            if (findGroupTask(&group, task))
+            {
+                runTask(task, threadIdx);
+                continue;
+            }
+
+            // Remaining tasks are running on other threads
+            group.mMutex.lock();
+            if (!group.mPending)
+            {
+                group.mMutex.unlock();
+                break;
+            }
+            group.mWaiting = true;
+            group.mMutex.unlock();
+            group.mCompleted.wait();
+        }
+    }
+    //---------------------------------------------------------------------
+    void TaskScheduler::_threadMain(size_t threadIdx)
+    {
+        if (mListener)
+            mListener->workerThreadStarted(threadIdx);
+        mStartBarrier->sync();
+
+        QueuedTask task;
+        for (;;)
+        {
+            if (findTask(threadIdx, task))
+            {
+                runTask(task, threadIdx);
+                continue;
+            }
+
+            mSleepMutex.lock();
+            if (mShuttingDown)
+            {
+                mSleepMutex.unlock();
+                break;
+            }
+
+            // A task submitted before we are counted as sleeping wouldn't wake
+            // us up, look again. Submitters only call wakeWorkers after queueing
+            // their task, so anything queued after this look sees the count.
+            if (findTask(threadIdx, task))
+            {
+                mSleepMutex.unlock();
+                runTask(task, threadIdx);
+                continue;
+            }
+            ++mNumSleeping;
+            mSleepMutex.unlock();
+
+            mWakeUp.wait();
+        }
+
+        if (mListener)
+            mListener->workerThreadStopped(threadIdx);
+    }
+}
@@ -0,0 +1,172 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "Threading/OgreTaskSchedulerWorkQueue.h"
+#include "OgreLogManager.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+
+namespace Ogre
+{
+    //---------------------------------------------------------------------
+    TaskSchedulerWorkQueue::TaskSchedulerWorkQueue(const String& name)
+    : DefaultWorkQueueBase(name), mRequestTask(this)
+    {
+    }
+    //---------------------------------------------------------------------
+    TaskSchedulerWorkQueue::~TaskSchedulerWorkQueue()
+    {
+        shutdown();
+    }
+    //---------------------------------------------------------------------
+    void TaskSchedulerWorkQueue::startup(bool forceRestart)
+    {
+        if (mIsRunning)
+        {
+            if (forceRestart)
+                shutdown();
+            else
+                return;
+        }
+
+        mShuttingDown = false;
+
+        LogManager::getSingleton().stream() <<
+            "TaskSchedulerWorkQueue('" << mName << "') initialising on thread " <<
+#if OGRE_THREAD_SUPPORT
+            OGRE_THREAD_CURRENT_ID
+#else
+            "main"
+#endif
+            << ".";
+
+#if OGRE_THREAD_SUPPORT
+        if (mWorkerRenderSystemAccess)
+            Root::getSingleton().getRenderSystem()->preExtraThreadsStarted();
+
+        // Returns once every worker is registered with the render system
+        mScheduler.startup(mWorkerThreadCount, this);
+
+        if (mWorkerRenderSystemAccess)
+            Root::getSingleton().getRenderSystem()->postExtraThreadsStarted();
+
+        // Requests queued while there were no workers weren't submitted
+        if (mScheduler.getNumThreads())
+        {
+            size_t numPending;
+            {
+                OGRE_LOCK_MUTEX(mRequestMutex);
+                numPending = mRequestQueue.size();
+            }
+            for (size_t i = 0; i < numPending; ++i)
+                mScheduler.submit(&mRequestTask);
+        }
+#endif
+
+        mIsRunning = true;
+    }
+    //---------------------------------------------------------------------
+    void TaskSchedulerWorkQueue::shutdown()
+    {
+        if( !mIsRunning )
+            return;
+
+        LogManager::getSingleton().stream() <<
+            "TaskSchedulerWorkQueue('" << mName << "') shutting down on thread " <<
+#if OGRE_THREAD_SUPPORT
+            OGRE_THREAD_CURRENT_ID
+#else
+            "main"
+#endif
+            << ".";
+
+        mShuttingDown = true;
+        abortAllRequests();
+        // The remaining request tasks find an empty queue
+        mScheduler.shutdown();
+
+        mIsRunning = false;
+    }
+    //---------------------------------------------------------------------
+    void TaskSchedulerWorkQueue::workerThreadStarted(size_t threadIdx)
+    {
+        LogManager::getSingleton().stream() << 
+            "TaskSchedulerWorkQueue('" << getName() << "') - worker " 
+            << threadIdx << " starting.";
+
+        // Initialise the thread for RS if necessary
+        if (mWorkerRenderSystemAccess)
+            Root::getSingleton().getRenderSystem()->registerThread();
+    }
+    //---------------------------------------------------------------------
+    void TaskSchedulerWorkQueue::workerThreadStopped(size_t threadIdx)
+    {
+        LogManager::getSingleton().stream() << 
+            "TaskSchedulerWorkQueue('" << getName() << "') - worker " 
+            << threadIdx << " stopped.";
+    }
+    //---------------------------------------------------------------------
+    void TaskSchedulerWorkQueue::processResponses()
+    {
+        if (!mScheduler.getNumThreads())
+        {
+            // Nothing else runs the requests, do it here; those queued by the
+            // handlers wait for the next call
+            size_t numPending;
+            {
+                OGRE_LOCK_MUTEX(mRequestMutex);
+                numPending = mRequestQueue.size();
+            }
+            for (size_t i = 0; i < numPending; ++i)
+                _processNextRequest();
+        }
+
+        DefaultWorkQueueBase::processResponses();
+    }
+    //---------------------------------------------------------------------
+    void TaskSchedulerWorkQueue::notifyWorkers()
+    {
+        // One task per request; whichever worker runs it takes the oldest request.
+        // Without workers the requests are run by processResponses instead.
+        if (mScheduler.getNumThreads())
+            mScheduler.submit(&mRequestTask);
+    }
+    //---------------------------------------------------------------------
+    void TaskSchedulerWorkQueue::_threadMain()
+    {
+        _processNextRequest();
+    }
+    //---------------------------------------------------------------------
+    void TaskSchedulerWorkQueue::RequestTask::execute(size_t threadIdx)
+    {
+        (void)threadIdx;
+        if (!mQueue->isShuttingDown())
+            mQueue->_processNextRequest();
+    }
+
+}
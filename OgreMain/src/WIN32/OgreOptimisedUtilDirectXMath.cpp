@@ -159,8 +159,18 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::concatenateNodeTransforms
+        virtual void concatenateNodeTransforms(
+            const Real* parentTransforms,
+            const Real* localTransforms,
+            Real* derivedTransforms,
+            size_t stride,
+            size_t numNodes);
     };
 
+    extern OptimisedUtil* _getOptimisedUtilGeneral(void);
+
 //---------------------------------------------------------------------
 // DirectXMath helpers.
 //---------------------------------------------------------------------
@@ -2032,6 +2042,19 @@ static FORCEINLINE bool _isAlignedForDirectXMath(const void *p)
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilDirectXMath::concatenateNodeTransforms(
+        const Real* parentTransforms,
+        const Real* localTransforms,
+        Real* derivedTransforms,
+        size_t stride,
+        size_t numNodes)
+    {
+        // Results must match Node::updateFromParentImpl exactly, which the
+        // general implementation guarantees.
+        _getOptimisedUtilGeneral()->concatenateNodeTransforms(
+            parentTransforms, localTransforms, derivedTransforms, stride, numNodes);
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilDirectXMath(void)
@@ -99,6 +99,9 @@ namespace Ogre {
         /** Frees up allocated memory for geometry caches. */
         void freeMemory(void);
 
+        /// BspSceneNode overrides _update, so the parallel update cannot be used.
+        bool isParallelSceneGraphUpdateSupported(void) const { return false; }
+
         /** Adds a bounding box to draw if turned on. */
         void addBoundingBox(const AxisAlignedBox& aab, bool visible);
 
@@ -39,7 +39,7 @@ email                : janders@users.sf.net
 
 #include "OgreAxisAlignedBox.h"
 
-#include <list>
+#include <vector>
 
 namespace Ogre
 {
@@ -48,18 +48,37 @@ class OctreeNode;
 
 /** Octree datastructure for managing scene nodes.
 @remarks
-This is a loose octree implementation, meaning that each
-octant child of the octree actually overlaps it's siblings by a factor
-of .5.  This guarantees that any thing that is half the size of the parent will
-fit completely into a child, with no splitting necessary.
+This is a loose octree implementation, meaning that the culling bounds of each
+octant are its real bounds scaled by a looseness factor about its centre. With
+the default factor of 2 each child octant overlaps its siblings by a factor of .5,
+which guarantees that anything half the size of the parent will fit completely
+into a child, with no splitting necessary. A node is only moved to a different
+octant once it leaves the loose bounds of the octant it is in, so objects moving
+about a little rarely change octant.
+@par
+Octants are not allocated individually but taken from an OctreePool, and the
+nodes of each octant are kept in a vector so that walking the tree touches
+contiguous memory.
 */
 
 class Octree : public NodeAlloc
 {
 public:
-    Octree( Octree * p );
+    Octree( Octree * p = 0 );
     ~Octree();
 
+    /** Resets this octant so that it can be reused from the pool.
+    @remarks
+    Children are not released; they belong to the same pool as this octant.
+    */
+    void _reset( Octree * p );
+
+    /** Sets the real bounds of this octant and derives the loose culling bounds from them.
+    @param box The real bounds of the octant
+    @param looseness The factor the culling bounds are scaled by, at least 1
+    */
+    void _setBounds( const AxisAlignedBox &box, Real looseness );
+
     /** Adds an Octree scene node to this octree level.
     @remarks
     This is called by the OctreeSceneManager after
@@ -71,6 +90,13 @@ public:
     */
     void _removeNode( OctreeNode * );
 
+    /** Removes the nodes of this octant and all its children.
+    @remarks
+    The nodes no longer refer to any octant afterwards, which is needed
+    before the octants are returned to the pool while nodes survive.
+    */
+    void _removeAllNodes();
+
     /** Returns the number of scene nodes attached to this octree
     */
     int numNodes()
@@ -78,6 +104,13 @@ public:
         return mNumNodes;
     };
 
+    /** Returns the parent of this octant, or 0 for the root of the octree
+    */
+    Octree * getParent() const
+    {
+        return mParent;
+    }
+
     /** The bounding box of the octree
     @remarks
     This is used for octant index determination and rendering, but not culling
@@ -93,6 +126,15 @@ public:
     */
     Vector3 mHalfSize;
 
+    /** The loose bounds of the octree, used for culling.
+    @remarks
+    This is infinite for the root octree, which holds the nodes outside the octree too.
+    */
+    AxisAlignedBox mCullBox;
+
+    /// Depth of this octant in the octree, the root being at 0
+    int mDepth;
+
     /** 3D array of children of this octree.
     @remarks
     Children are dynamically created as needed when nodes are inserted in the Octree.
@@ -107,6 +149,15 @@ public:
     */
     bool _isTwiceSize( const AxisAlignedBox &box ) const;
 
+    /** Determines if the given box lies entirely within the loose bounds of this octree.
+    @remarks
+    Nodes attached to an octant are always contained by its culling bounds.
+    */
+    bool _isContained( const AxisAlignedBox &box ) const
+    {
+        return mCullBox.contains( box );
+    }
+
     /**  Returns the appropriate indexes for the child of this octree into which the box will fit.
     @remarks
     This is used by the OctreeSceneManager to determine which child to traverse next when
@@ -115,6 +166,17 @@ public:
     */
     void _getChildIndexes( const AxisAlignedBox &, int *x, int *y, int *z ) const;
 
+    /** Gets the real bounds of the child at the given indexes, whether or not it exists yet.
+    */
+    void _getChildBounds( int x, int y, int z, AxisAlignedBox * ) const;
+
+    /** Determines if the given box fits into the loose bounds of the child its center falls in.
+    @param box The box to place
+    @param looseness The looseness factor of the octree
+    @param x, y, z Set to the indexes of the child the box belongs to
+    */
+    bool _fitsInChild( const AxisAlignedBox &box, Real looseness, int *x, int *y, int *z ) const;
+
     /** Creates the AxisAlignedBox used for culling this octree.
     @remarks
     Since it's a loose octree, the culling bounds can be different than the actual bounds of the octree.
@@ -122,8 +184,11 @@ public:
     void _getCullBounds( AxisAlignedBox * ) const;
 
 
-    typedef list< OctreeNode * >::type NodeList;
+    typedef vector< OctreeNode * >::type NodeList;
     /** Public list of SceneNodes attached to this particular octree
+    @remarks
+    Nodes know their index in this list, so removal swaps the last node into
+    the vacated slot; the order of the nodes is therefore not preserved.
     */
     NodeList mNodes;
 
@@ -155,6 +220,46 @@ protected:
 
 };
 
+/** Allocates the octants of an octree from contiguous blocks.
+@remarks
+Octants are handed out in the order they are requested, which keeps the
+octants created while inserting a node close to each other in memory.
+Individual octants are never released; instead the whole pool is reset
+when the octree is rebuilt, and its memory is reused.
+*/
+class OctreePool : public NodeAlloc
+{
+public:
+    OctreePool();
+    ~OctreePool();
+
+    /** Takes a fresh octant from the pool.
+    @param parent The parent of the new octant, or 0 for a root
+    */
+    Octree * allocate( Octree * parent );
+
+    /** Returns all octants to the pool, keeping the allocated memory.
+    */
+    void reset();
+
+    /** Returns the number of octants currently handed out.
+    */
+    size_t getNumOctants() const
+    {
+        return mNumOctants;
+    }
+
+    /// Number of octants allocated at once when the pool runs out
+    static const size_t BLOCK_SIZE = 256;
+
+protected:
+    typedef vector< Octree * >::type BlockList;
+    /// Blocks of BLOCK_SIZE octants each
+    BlockList mBlocks;
+    /// Number of octants handed out since the last reset
+    size_t mNumOctants;
+};
+
 }
 
 #endif
@@ -86,14 +86,23 @@ public:
         mOctant = o;
     };
 
-    /** Determines if the center of this node is within the given box
+    /** Returns the position of this OctreeNode in the node list of its octant
     */
-    bool _isIn( AxisAlignedBox &box );
+    size_t _getOctantIndex() const
+    {
+        return mOctantIndex;
+    }
+
+    /** Sets the position of this OctreeNode in the node list of its octant
+    */
+    void _setOctantIndex( size_t index )
+    {
+        mOctantIndex = index;
+    }
 
-    /** Adds all the attached scenenodes to the render queue
+    /** Determines if the center of this node is within the given box
     */
-    virtual void _addToRenderQueue( Camera* cam, RenderQueue * q, bool onlyShadowCasters, 
-        VisibleObjectsBoundsInfo* visibleBounds);
+    bool _isIn( AxisAlignedBox &box );
 
     /** Sets up the LegacyRenderOperation for rendering this scene node as geometry.
     @remarks
@@ -130,6 +139,8 @@ protected:
 
     ///Octree this node is attached to.
     Octree *mOctant;
+    ///Position of this node in the node list of its octant
+    size_t mOctantIndex;
 
     /// Preallocated corners for rendering
     Real mCorners[ 24 ];
@@ -159,7 +159,13 @@ public:
         Options are:
         "Size", AxisAlignedBox *;
         "Depth", int *;
+        "Looseness", Real *;
         "ShowOctree", bool *;
+    @par
+        "Looseness" is the factor the culling bounds of each octant are scaled
+        by, relative to its real bounds. Larger values let nodes settle deeper
+        in the octree and move further before changing octant, at the cost of
+        octants overlapping more. It can't be less than 1, and defaults to 2.
     */
 
     virtual bool setOption( const String &, const void * );
@@ -188,6 +194,9 @@ protected:
     /// The root octree
     Octree *mOctree;
 
+    /// Storage for all the octants of the octree
+    OctreePool mOctantPool;
+
     /// List of boxes to be rendered
     BoxList mBoxes;
 
@@ -196,6 +205,8 @@ protected:
 
     /// Max depth for the tree
     int mMaxDepth;
+    /// Scale of the culling bounds of an octant relative to its real bounds
+    Real mLooseness;
     /// Size of the octree
     AxisAlignedBox mBox;
 
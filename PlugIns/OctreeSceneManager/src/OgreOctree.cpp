@@ -82,9 +82,69 @@ void Octree::_getChildIndexes( const AxisAlignedBox &box, int *x, int *y, int *z
 
 }
 
+/** Grows the box by ( looseness - 1 ) halves of its size on each side.
+*/
+static void _getLooseBounds( const AxisAlignedBox &box, Real looseness, AxisAlignedBox *b )
+{
+    Vector3 grow = box.getHalfSize() * ( std::max( looseness, Real( 1 ) ) - 1 );
+    b -> setExtents( box.getMinimum() - grow, box.getMaximum() + grow );
+}
+
+void Octree::_getChildBounds( int x, int y, int z, AxisAlignedBox *b ) const
+{
+    const Vector3& octantMin = mBox.getMinimum();
+    const Vector3& octantMax = mBox.getMaximum();
+    Vector3 center = octantMax.midPoint( octantMin );
+
+    Vector3 min, max;
+
+    min.x = x == 0 ? octantMin.x : center.x;
+    max.x = x == 0 ? center.x : octantMax.x;
+
+    min.y = y == 0 ? octantMin.y : center.y;
+    max.y = y == 0 ? center.y : octantMax.y;
+
+    min.z = z == 0 ? octantMin.z : center.z;
+    max.z = z == 0 ? center.z : octantMax.z;
+
+    b -> setExtents( min, max );
+}
+
+/** The box belongs to the child its center falls in, and fits if it
+* doesn't poke out of the loose bounds of that child.
+*/
+bool Octree::_fitsInChild( const AxisAlignedBox &box, Real looseness, int *x, int *y, int *z ) const
+{
+    // infinite boxes never fit in a child - always root node
+    if ( box.isNull() || box.isInfinite() )
+        return false;
+
+    _getChildIndexes( box, x, y, z );
+
+    AxisAlignedBox child;
+    _getChildBounds( *x, *y, *z, &child );
+    _getLooseBounds( child, looseness, &child );
+
+    return child.contains( box );
+}
+
 Octree::Octree( Octree * parent ) 
     : mWireBoundingBox(0),
       mHalfSize( 0, 0, 0 )
+{
+    _reset( parent );
+}
+
+Octree::~Octree()
+{
+    // children are owned by the OctreePool
+    if(mWireBoundingBox)
+        OGRE_DELETE mWireBoundingBox;
+
+    mParent = 0;
+}
+
+void Octree::_reset( Octree * parent )
 {
     //initialize all children to null.
     for ( int i = 0; i < 2; i++ )
@@ -98,33 +158,29 @@ Octree::Octree( Octree * parent )
         }
     }
 
+    // keeps the capacity of the node list
+    mNodes.clear();
+
     mParent = parent;
+    mDepth = parent ? parent -> mDepth + 1 : 0;
     mNumNodes = 0;
 }
 
-Octree::~Octree()
+void Octree::_setBounds( const AxisAlignedBox &box, Real looseness )
 {
-    //initialize all children to null.
-    for ( int i = 0; i < 2; i++ )
-    {
-        for ( int j = 0; j < 2; j++ )
-        {
-            for ( int k = 0; k < 2; k++ )
-            {
-                if ( mChildren[ i ][ j ][ k ] != 0 )
-                    OGRE_DELETE mChildren[ i ][ j ][ k ];
-            }
-        }
-    }
+    mBox = box;
+    mHalfSize = box.getHalfSize();
 
-    if(mWireBoundingBox)
-        OGRE_DELETE mWireBoundingBox;
-
-    mParent = 0;
+    // the root also holds everything outside the octree, so it can't be culled
+    if ( mParent == 0 )
+        mCullBox.setInfinite();
+    else
+        _getLooseBounds( box, looseness, &mCullBox );
 }
 
 void Octree::_addNode( OctreeNode * n )
 {
+    n -> _setOctantIndex( mNodes.size() );
     mNodes.push_back( n );
     n -> setOctant( this );
 
@@ -135,16 +191,47 @@ void Octree::_addNode( OctreeNode * n )
 
 void Octree::_removeNode( OctreeNode * n )
 {
-    mNodes.erase( std::find( mNodes.begin(), mNodes.end(), n ) );
+    size_t index = n -> _getOctantIndex();
+    assert( index < mNodes.size() && mNodes[ index ] == n );
+
+    // move the last node into the vacated slot
+    OctreeNode * last = mNodes.back();
+    mNodes[ index ] = last;
+    last -> _setOctantIndex( index );
+    mNodes.pop_back();
+
     n -> setOctant( 0 );
 
     //update total counts.
     _unref();
 }
 
+void Octree::_removeAllNodes()
+{
+    for ( NodeList::iterator it = mNodes.begin(); it != mNodes.end(); ++it )
+    {
+        ( *it ) -> setOctant( 0 );
+        ( *it ) -> _setOctantIndex( 0 );
+    }
+    mNodes.clear();
+    mNumNodes = 0;
+
+    for ( int i = 0; i < 2; i++ )
+    {
+        for ( int j = 0; j < 2; j++ )
+        {
+            for ( int k = 0; k < 2; k++ )
+            {
+                if ( mChildren[ i ][ j ][ k ] != 0 )
+                    mChildren[ i ][ j ][ k ] -> _removeAllNodes();
+            }
+        }
+    }
+}
+
 void Octree::_getCullBounds( AxisAlignedBox *b ) const
 {
-    b -> setExtents( mBox.getMinimum() - mHalfSize, mBox.getMaximum() + mHalfSize );
+    *b = mCullBox;
 }
 
 WireBoundingBox* Octree::getWireBoundingBox()
@@ -157,4 +244,34 @@ WireBoundingBox* Octree::getWireBoundingBox()
     return mWireBoundingBox;
 }
 
+//-----------------------------------------------------------------------
+OctreePool::OctreePool()
+    : mNumOctants( 0 )
+{
+}
+//-----------------------------------------------------------------------
+OctreePool::~OctreePool()
+{
+    for ( BlockList::iterator i = mBlocks.begin(); i != mBlocks.end(); ++i )
+        OGRE_DELETE [] *i;
+}
+//-----------------------------------------------------------------------
+Octree * OctreePool::allocate( Octree * parent )
+{
+    size_t block = mNumOctants / BLOCK_SIZE;
+    if ( block == mBlocks.size() )
+        mBlocks.push_back( OGRE_NEW Octree[ BLOCK_SIZE ] );
+
+    Octree * octant = &mBlocks[ block ][ mNumOctants % BLOCK_SIZE ];
+    ++mNumOctants;
+
+    octant -> _reset( parent );
+    return octant;
+}
+//-----------------------------------------------------------------------
+void OctreePool::reset()
+{
+    mNumOctants = 0;
+}
+
 }
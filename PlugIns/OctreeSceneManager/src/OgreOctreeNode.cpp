@@ -50,11 +50,13 @@ unsigned long OctreeNode::mColors[ 8 ] = {green, green, green, green, green, gre
 OctreeNode::OctreeNode( SceneManager* creator ) : SceneNode( creator )
 {
     mOctant = 0;
+    mOctantIndex = 0;
 }
 
 OctreeNode::OctreeNode( SceneManager* creator, const String& name ) : SceneNode( creator, name )
 {
     mOctant = 0;
+    mOctantIndex = 0;
 }
 
 OctreeNode::~OctreeNode()
@@ -167,24 +169,6 @@ bool OctreeNode::_isIn( AxisAlignedBox &box )
 
 }
 
-/** Adds the attached objects of this OctreeScene node into the queue. */
-void OctreeNode::_addToRenderQueue( Camera* cam, RenderQueue *queue, 
-    bool onlyShadowCasters, VisibleObjectsBoundsInfo* visibleBounds )
-{
-    ObjectMap::iterator mit = mObjectsByName.begin();
-
-    while ( mit != mObjectsByName.end() )
-    {
-        MovableObject * mo = mit->second;
-        
-        queue->processVisibleObject(mo, cam, onlyShadowCasters, visibleBounds);
-
-        ++mit;
-    }
-
-}
-
-
 void OctreeNode::getRenderOperation( RenderOperation& rend )
 {
 
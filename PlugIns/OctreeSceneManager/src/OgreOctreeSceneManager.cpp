@@ -239,11 +239,12 @@ Intersection intersect( const Sphere &one, const AxisAlignedBox &two )
 
     float s, d = 0;
 
-    Vector3 mndistance = ( twoMin - scenter );
-    Vector3 mxdistance = ( twoMax - scenter );
+    // the box is inside if its corner farthest from the centre is
+    Vector3 farthest;
+    for ( int i = 0 ; i < 3 ; i++ )
+        farthest[ i ] = std::max( scenter[ i ] - twoMin[ i ], twoMax[ i ] - scenter[ i ] );
 
-    if ( mndistance.squaredLength() < sradius &&
-            mxdistance.squaredLength() < sradius )
+    if ( farthest.squaredLength() < sradius )
     {
         return INSIDE;
     }
@@ -295,6 +296,7 @@ OctreeSceneManager::OctreeSceneManager(const String& name) : SceneManager(name)
     AxisAlignedBox b( -10000, -10000, -10000, 10000, 10000, 10000 );
     int depth = 8; 
     mOctree = 0;
+    mLooseness = 2;
     init( b, depth );
 }
 
@@ -302,6 +304,7 @@ OctreeSceneManager::OctreeSceneManager(const String& name, AxisAlignedBox &box,
 : SceneManager(name)
 {
     mOctree = 0;
+    mLooseness = 2;
     init( box, max_depth );
 }
 
@@ -313,21 +316,15 @@ const String& OctreeSceneManager::getTypeName(void) const
 void OctreeSceneManager::init( AxisAlignedBox &box, int depth )
 {
 
-    if ( mOctree != 0 )
-        OGRE_DELETE mOctree;
+    // all octants are released at once, their memory is kept for the new octree
+    mOctantPool.reset();
 
-    mOctree = OGRE_NEW Octree( 0 );
+    mOctree = mOctantPool.allocate( 0 );
 
     mMaxDepth = depth;
     mBox = box;
 
-    mOctree -> mBox = box;
-
-    Vector3 min = box.getMinimum();
-
-    Vector3 max = box.getMaximum();
-
-    mOctree -> mHalfSize = ( max - min ) / 2;
+    mOctree -> _setBounds( box, mLooseness );
 
 
     mShowBoxes = false;
@@ -351,11 +348,8 @@ void OctreeSceneManager::init( AxisAlignedBox &box, int depth )
 OctreeSceneManager::~OctreeSceneManager()
 {
 
-    if ( mOctree )
-    {
-        OGRE_DELETE mOctree;
-        mOctree = 0;
-    }
+    // the octants themselves are freed along with mOctantPool
+    mOctree = 0;
 }
 
 Camera * OctreeSceneManager::createCamera( const String &name )
@@ -399,6 +393,7 @@ bool OctreeSceneManager::getOptionKeys( StringVector & refKeys )
     refKeys.push_back( "Size" );
     refKeys.push_back( "ShowOctree" );
     refKeys.push_back( "Depth" );
+    refKeys.push_back( "Looseness" );
 
     return true;
 }
@@ -415,26 +410,39 @@ void OctreeSceneManager::_updateOctreeNode( OctreeNode * onode )
     if (!mOctree)
         return;
 
-    if ( onode -> getOctant() == 0 )
+    Octree * octant = onode -> getOctant();
+
+    if ( octant == 0 )
     {
-        //if outside the octree, force into the root node.
-        if ( ! onode -> _isIn( mOctree -> mBox ) )
-            mOctree->_addNode( onode );
-        else
-            _addOctreeNode( onode, mOctree );
+        //nodes that fit nowhere else end up in the root node.
+        _addOctreeNode( onode, mOctree );
         return ;
     }
 
-    if ( ! onode -> _isIn( onode -> getOctant() -> mBox ) )
+    if ( octant == mOctree )
     {
-        _removeOctreeNode( onode );
-
-        //if outside the octree, force into the root node.
-        if ( ! onode -> _isIn( mOctree -> mBox ) )
-            mOctree->_addNode( onode );
-        else
-            _addOctreeNode( onode, mOctree );
+        // the root holds anything, but move the node down if it now fits in a child
+        int x, y, z;
+        if ( mMaxDepth == 0 || ! mOctree -> _fitsInChild( box, mLooseness, &x, &y, &z ) )
+            return ;
+    }
+    else if ( octant -> _isContained( box ) )
+    {
+        // still within the loose bounds, no need to move
+        return ;
     }
+
+    _removeOctreeNode( onode );
+
+    // only climb as far as needed to find an octant containing the node again
+    Octree * target = octant -> getParent();
+    while ( target != 0 && target != mOctree && ! target -> _isContained( box ) )
+        target = target -> getParent();
+
+    if ( target == 0 )
+        target = mOctree;
+
+    _addOctreeNode( onode, target, target -> mDepth );
 }
 
 /** Only removes the node from the octree.  It leaves the octree, even if it's empty.
@@ -466,58 +474,20 @@ void OctreeSceneManager::_addOctreeNode( OctreeNode * n, Octree *octant, int dep
     const AxisAlignedBox& bx = n -> _getWorldAABB();
 
 
-    //if the octree is twice as big as the scene node,
-    //we will add it to a child.
-    if ( ( depth < mMaxDepth ) && octant -> _isTwiceSize( bx ) )
+    //if the node fits into the loose bounds of a child,
+    //we will add it to that child.
+    int x, y, z;
+    if ( ( depth < mMaxDepth ) && octant -> _fitsInChild( bx, mLooseness, &x, &y, &z ) )
     {
-        int x, y, z;
-        octant -> _getChildIndexes( bx, &x, &y, &z );
-
         if ( octant -> mChildren[ x ][ y ][ z ] == 0 )
         {
-            octant -> mChildren[ x ][ y ][ z ] = OGRE_NEW Octree( octant );
-            const Vector3& octantMin = octant -> mBox.getMinimum();
-            const Vector3& octantMax = octant -> mBox.getMaximum();
-            Vector3 min, max;
-
-            if ( x == 0 )
-            {
-                min.x = octantMin.x;
-                max.x = ( octantMin.x + octantMax.x ) / 2;
-            }
-
-            else
-            {
-                min.x = ( octantMin.x + octantMax.x ) / 2;
-                max.x = octantMax.x;
-            }
-
-            if ( y == 0 )
-            {
-                min.y = octantMin.y;
-                max.y = ( octantMin.y + octantMax.y ) / 2;
-            }
+            Octree * child = mOctantPool.allocate( octant );
 
-            else
-            {
-                min.y = ( octantMin.y + octantMax.y ) / 2;
-                max.y = octantMax.y;
-            }
-
-            if ( z == 0 )
-            {
-                min.z = octantMin.z;
-                max.z = ( octantMin.z + octantMax.z ) / 2;
-            }
-
-            else
-            {
-                min.z = ( octantMin.z + octantMax.z ) / 2;
-                max.z = octantMax.z;
-            }
+            AxisAlignedBox childBox;
+            octant -> _getChildBounds( x, y, z, &childBox );
+            child -> _setBounds( childBox, mLooseness );
 
-            octant -> mChildren[ x ][ y ][ z ] -> mBox.setExtents( min, max );
-            octant -> mChildren[ x ][ y ][ z ] -> mHalfSize = ( max - min ) / 2;
+            octant -> mChildren[ x ][ y ][ z ] = child;
         }
 
         _addOctreeNode( n, octant -> mChildren[ x ][ y ][ z ], ++depth );
@@ -1009,14 +979,11 @@ void OctreeSceneManager::resize( const AxisAlignedBox &box )
 
     _findNodes( mOctree->mBox, nodes, 0, true, mOctree );
 
-    OGRE_DELETE mOctree;
-
-    mOctree = OGRE_NEW Octree( 0 );
-    mOctree->mBox = box;
+    // reuse the memory of the old octants for the new octree
+    mOctantPool.reset();
 
-    const Vector3 &min = box.getMinimum();
-    const Vector3 &max = box.getMaximum();
-    mOctree->mHalfSize = ( max - min ) * 0.5f;
+    mOctree = mOctantPool.allocate( 0 );
+    mOctree->_setBounds( box, mLooseness );
 
     it = nodes.begin();
 
@@ -1047,6 +1014,14 @@ bool OctreeSceneManager::setOption( const String & key, const void * val )
         return true;
     }
 
+    else if ( key == "Looseness" )
+    {
+        mLooseness = std::max( * static_cast < const Real * > ( val ), Real( 1 ) );
+        AxisAlignedBox box = mOctree->mBox;
+        resize(box);
+        return true;
+    }
+
     else if ( key == "ShowOctree" )
     {
         mShowBoxes = * static_cast < const bool * > ( val );
@@ -1074,6 +1049,12 @@ bool OctreeSceneManager::getOption( const String & key, void *val )
         return true;
     }
 
+    else if ( key == "Looseness" )
+    {
+        * static_cast < Real * > ( val ) = mLooseness;
+        return true;
+    }
+
     else if ( key == "ShowOctree" )
     {
 
@@ -1088,6 +1069,10 @@ bool OctreeSceneManager::getOption( const String & key, void *val )
 
 void OctreeSceneManager::clearScene(void)
 {
+    // init returns the octants to the pool, so nodes surviving the clear
+    // (like the root) must not refer to them anymore
+    mOctree -> _removeAllNodes();
+
     SceneManager::clearScene();
     init(mBox, mMaxDepth);
 
@@ -323,6 +323,9 @@ namespace Ogre
         /// @see SceneManager::prepareShadowTextures.
         virtual void prepareShadowTextures(Camera* cam, Viewport* vp, const LightList* lightList = 0);
 
+        /// PCZSceneNode overrides _update, so the parallel update cannot be used.
+        virtual bool isParallelSceneGraphUpdateSupported(void) const { return false; }
+
     protected:
         /// Type of default zone to be used
         String mDefaultZoneTypeName;
@@ -123,6 +123,12 @@ namespace Ogre {
         /** See ParticleAffector. */
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
 
+        /** See ParticleAffector. */
+        void _affectParticleStreams(ParticleSystem* pSystem, Real timeElapsed, ParticleStreams& streams);
+
+        /** See ParticleAffector. */
+        bool _supportsParticleStreams(void) const { return true; }
+
         /** Sets the colour adjustment to be made per second to particles. 
         @param red, green, blue, alpha
             Sets the adjustment to be made to each of the colour components per second. These
@@ -73,6 +73,12 @@ namespace Ogre {
         /** See ParticleAffector. */
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
 
+        /** See ParticleAffector. */
+        void _affectParticleStreams(ParticleSystem* pSystem, Real timeElapsed, ParticleStreams& streams);
+
+        /** See ParticleAffector. */
+        bool _supportsParticleStreams(void) const { return true; }
+
         void setColourAdjust(size_t index, ColourValue colour);
         ColourValue getColourAdjust(size_t index) const;
         
@@ -76,6 +76,12 @@ namespace Ogre {
         /** See ParticleAffector. */
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
 
+        /** See ParticleAffector. */
+        void _affectParticleStreams(ParticleSystem* pSystem, Real timeElapsed, ParticleStreams& streams);
+
+        /** See ParticleAffector. */
+        bool _supportsParticleStreams(void) const { return true; }
+
         /** Sets the plane point of the deflector plane. */
         void setPlanePoint(const Vector3& pos);
 
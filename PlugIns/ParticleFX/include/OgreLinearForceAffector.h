@@ -80,6 +80,12 @@ namespace Ogre {
         /** See ParticleAffector. */
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
 
+        /** See ParticleAffector. */
+        void _affectParticleStreams(ParticleSystem* pSystem, Real timeElapsed, ParticleStreams& streams);
+
+        /** See ParticleAffector. */
+        bool _supportsParticleStreams(void) const { return true; }
+
 
         /** Sets the force vector to apply to the particles in a system. */
         void setForceVector(const Vector3& force);
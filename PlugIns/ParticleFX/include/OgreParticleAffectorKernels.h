@@ -0,0 +1,161 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ParticleAffectorKernels_H__
+#define __ParticleAffectorKernels_H__
+
+#include "OgreParticleFXPrerequisites.h"
+
+namespace Ogre {
+
+    /** Array kernels used by the built-in affectors on contiguous particle storage.
+    @remarks
+        Each kernel processes 'count' particles held in ParticleStreams streams,
+        which are SIMD aligned and padded to a multiple of 4 values, and produces
+        exactly the values the per particle loop of the affector would.
+    @par
+        As with OptimisedUtil, the best implementation for the CPU is picked
+        at run time.
+    @note
+        This class is supposed used by the built-in affectors only.
+    */
+    class _OgreParticleFXExport ParticleAffectorKernels
+    {
+    private:
+        /// Privated copy constructor, to prevent misuse
+        ParticleAffectorKernels(const ParticleAffectorKernels& rhs); /* do nothing, should not use */
+        /// Privated operator=, to prevent misuse
+        ParticleAffectorKernels& operator=(const ParticleAffectorKernels& rhs); /* do not use */
+
+    protected:
+        /// Store a pointer to the implementation
+        static ParticleAffectorKernels* msImplementation;
+
+        /// Detect best implementation based on run-time environment
+        static ParticleAffectorKernels* _detectImplementation(void);
+
+    public:
+        // Default constructor
+        ParticleAffectorKernels(void) {}
+        // Destructor
+        virtual ~ParticleAffectorKernels() {}
+
+        /** Gets the implementation of this class. */
+        static ParticleAffectorKernels* getImplementation(void) { return msImplementation; }
+
+        /// The implementations which may be selected
+        enum Implementation
+        {
+            /// Plain C++, available everywhere
+            KI_GENERAL,
+            /// SSE, if built in and supported by the CPU
+            KI_SSE,
+            /// The best one for the CPU, which is the default
+            KI_BEST
+        };
+
+        /** Selects the implementation used by the affectors.
+        @remarks
+            This is meant for comparing the implementations, e.g. in tests;
+            it must not be called while particle systems are being updated.
+        @return false if the implementation is not available, in which case
+            the current one is kept.
+        */
+        static bool _selectImplementation(Implementation impl);
+
+        /** Adds a vector to a vector stream triple, as LinearForceAffector::FA_ADD. */
+        virtual void addVector(Real* x, Real* y, Real* z,
+            const Vector3& v, size_t count) = 0;
+
+        /** Averages a vector stream triple with a vector, as LinearForceAffector::FA_AVERAGE. */
+        virtual void averageVector(Real* x, Real* y, Real* z,
+            const Vector3& v, size_t count) = 0;
+
+        /** Adds an adjustment to the colour streams and clamps them to [0, 1],
+            as ColourFaderAffector.
+        @param colour The red, green, blue and alpha streams.
+        @param adjust The red, green, blue and alpha adjustments.
+        */
+        virtual void adjustColours(Real* const colour[4], const float adjust[4],
+            size_t count) = 0;
+
+        /** Adds one of two adjustments to the colour streams and clamps them to
+            [0, 1], as ColourFaderAffector2.
+        @param colour The red, green, blue and alpha streams.
+        @param timeToLive The time to live stream.
+        @param threshold Particles whose time to live is above it use adjust1,
+            the others adjust2.
+        @param adjust1, adjust2 The red, green, blue and alpha adjustments.
+        */
+        virtual void adjustColoursByTime(Real* const colour[4], const Real* timeToLive,
+            Real threshold, const float adjust1[4], const float adjust2[4],
+            size_t count) = 0;
+
+        /** Sets the colour streams by interpolating between stages according to
+            the age of the particles, as ColourInterpolatorAffector.
+        @param colour The red, green, blue and alpha streams.
+        @param timeToLive, totalTimeToLive The time to live streams.
+        @param times The relative time of each stage.
+        @param colours The colour of each stage.
+        @param numStages The number of stages, at least 2.
+        */
+        virtual void interpolateColours(Real* const colour[4], const Real* timeToLive,
+            const Real* totalTimeToLive, const Real* times, const ColourValue* colours,
+            size_t numStages, size_t count) = 0;
+
+        /** Grows the dimension streams and flags them as own dimensions, as
+            ScaleAffector.
+        @param width, height The dimension streams.
+        @param ownDimensions The own dimensions stream; where it is 0 the
+            default dimensions are used as starting point.
+        @param defaultWidth, defaultHeight The default dimensions of the system.
+        @param adjust The amount added to both dimensions.
+        */
+        virtual void scaleDimensions(Real* width, Real* height, Real* ownDimensions,
+            Real defaultWidth, Real defaultHeight, Real adjust, size_t count) = 0;
+
+        /** Advances the rotation stream by the rotation speed, as RotationAffector.
+        @return true if any of the new rotations is not zero.
+        */
+        virtual bool rotate(Real* rotation, const Real* rotationSpeed,
+            Real timeElapsed, size_t count) = 0;
+
+        /** Bounces the particles crossing a plane during the time step, as
+            DeflectorPlaneAffector.
+        @param position, direction The position and direction stream triples.
+        @param planeNormal The normal of the plane.
+        @param planeDistance The signed distance of the plane from the origin.
+        @param bounce The amount of speed kept after bouncing.
+        */
+        virtual void deflect(Real* const position[3], Real* const direction[3],
+            const Vector3& planeNormal, Real planeDistance, Real bounce,
+            Real timeElapsed, size_t count) = 0;
+    };
+
+}
+
+#endif
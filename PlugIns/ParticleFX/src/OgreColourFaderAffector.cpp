@@ -26,9 +26,11 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreColourFaderAffector.h"
+#include "OgreParticleAffectorKernels.h"
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleStreams.h"
 
 
 namespace Ogre {
@@ -90,6 +92,25 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void ColourFaderAffector::_affectParticleStreams(ParticleSystem* pSystem, Real timeElapsed, ParticleStreams& streams)
+    {
+        (void)pSystem;
+        Real* const colour[4] = {
+            streams.getStream(ParticleStreams::PS_COLOUR_R),
+            streams.getStream(ParticleStreams::PS_COLOUR_G),
+            streams.getStream(ParticleStreams::PS_COLOUR_B),
+            streams.getStream(ParticleStreams::PS_COLOUR_A) };
+
+        // Scale adjustments by time
+        const float adjust[4] = {
+            static_cast<float>(mRedAdj * timeElapsed),
+            static_cast<float>(mGreenAdj * timeElapsed),
+            static_cast<float>(mBlueAdj * timeElapsed),
+            static_cast<float>(mAlphaAdj * timeElapsed) };
+
+        ParticleAffectorKernels::getImplementation()->adjustColours(colour, adjust, streams.size());
+    }
+    //-----------------------------------------------------------------------
     void ColourFaderAffector::setAdjust(float red, float green, float blue, float alpha)
     {
         mRedAdj = red;
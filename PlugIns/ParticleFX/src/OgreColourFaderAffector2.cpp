@@ -26,9 +26,11 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreColourFaderAffector2.h"
+#include "OgreParticleAffectorKernels.h"
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleStreams.h"
 
 
 namespace Ogre {
@@ -139,6 +141,32 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void ColourFaderAffector2::_affectParticleStreams(ParticleSystem* pSystem, Real timeElapsed, ParticleStreams& streams)
+    {
+        (void)pSystem;
+        Real* const colour[4] = {
+            streams.getStream(ParticleStreams::PS_COLOUR_R),
+            streams.getStream(ParticleStreams::PS_COLOUR_G),
+            streams.getStream(ParticleStreams::PS_COLOUR_B),
+            streams.getStream(ParticleStreams::PS_COLOUR_A) };
+
+        // Scale adjustments by time
+        const float adjust1[4] = {
+            static_cast<float>(mRedAdj1   * timeElapsed),
+            static_cast<float>(mGreenAdj1 * timeElapsed),
+            static_cast<float>(mBlueAdj1  * timeElapsed),
+            static_cast<float>(mAlphaAdj1 * timeElapsed) };
+        const float adjust2[4] = {
+            static_cast<float>(mRedAdj2   * timeElapsed),
+            static_cast<float>(mGreenAdj2 * timeElapsed),
+            static_cast<float>(mBlueAdj2  * timeElapsed),
+            static_cast<float>(mAlphaAdj2 * timeElapsed) };
+
+        ParticleAffectorKernels::getImplementation()->adjustColoursByTime(colour,
+            streams.getStream(ParticleStreams::PS_TIME_TO_LIVE), StateChangeVal,
+            adjust1, adjust2, streams.size());
+    }
+    //-----------------------------------------------------------------------
     void ColourFaderAffector2::setAdjust1(float red, float green, float blue, float alpha)
     {
         mRedAdj1 = red;
@@ -26,9 +26,11 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreColourInterpolatorAffector.h"
+#include "OgreParticleAffectorKernels.h"
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleStreams.h"
 
 
 namespace Ogre {
@@ -112,6 +114,22 @@ namespace Ogre {
         }
     }
     
+    //-----------------------------------------------------------------------
+    void ColourInterpolatorAffector::_affectParticleStreams(ParticleSystem* pSystem, Real timeElapsed, ParticleStreams& streams)
+    {
+        (void)pSystem;
+        (void)timeElapsed;
+        Real* const colour[4] = {
+            streams.getStream(ParticleStreams::PS_COLOUR_R),
+            streams.getStream(ParticleStreams::PS_COLOUR_G),
+            streams.getStream(ParticleStreams::PS_COLOUR_B),
+            streams.getStream(ParticleStreams::PS_COLOUR_A) };
+
+        ParticleAffectorKernels::getImplementation()->interpolateColours(colour,
+            streams.getStream(ParticleStreams::PS_TIME_TO_LIVE),
+            streams.getStream(ParticleStreams::PS_TOTAL_TIME_TO_LIVE),
+            mTimeAdj, mColourAdj, MAX_STAGES, streams.size());
+    }
     //-----------------------------------------------------------------------
     void ColourInterpolatorAffector::setColourAdjust(size_t index, ColourValue colour)
     {
@@ -26,8 +26,10 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreDeflectorPlaneAffector.h"
+#include "OgreParticleAffectorKernels.h"
 #include "OgreParticleSystem.h"
 #include "OgreParticle.h"
+#include "OgreParticleStreams.h"
 #include "OgreStringConverter.h"
 
 
@@ -92,6 +94,25 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void DeflectorPlaneAffector::_affectParticleStreams(ParticleSystem* pSystem, Real timeElapsed, ParticleStreams& streams)
+    {
+        (void)pSystem;
+        // precalculate distance of plane from origin
+        Real planeDistance = - mPlaneNormal.dotProduct(mPlanePoint) / Math::Sqrt(mPlaneNormal.dotProduct(mPlaneNormal));
+
+        Real* const position[3] = {
+            streams.getStream(ParticleStreams::PS_POSITION_X),
+            streams.getStream(ParticleStreams::PS_POSITION_Y),
+            streams.getStream(ParticleStreams::PS_POSITION_Z) };
+        Real* const direction[3] = {
+            streams.getStream(ParticleStreams::PS_DIRECTION_X),
+            streams.getStream(ParticleStreams::PS_DIRECTION_Y),
+            streams.getStream(ParticleStreams::PS_DIRECTION_Z) };
+
+        ParticleAffectorKernels::getImplementation()->deflect(position, direction,
+            mPlaneNormal, planeDistance, mBounce, timeElapsed, streams.size());
+    }
+    //-----------------------------------------------------------------------
     void DeflectorPlaneAffector::setPlanePoint(const Vector3& pos)
     {
         mPlanePoint = pos;
@@ -26,8 +26,10 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreLinearForceAffector.h"
+#include "OgreParticleAffectorKernels.h"
 #include "OgreParticleSystem.h"
 #include "OgreParticle.h"
+#include "OgreParticleStreams.h"
 #include "OgreStringConverter.h"
 
 
@@ -95,6 +97,24 @@ namespace Ogre {
         
     }
     //-----------------------------------------------------------------------
+    void LinearForceAffector::_affectParticleStreams(ParticleSystem* pSystem, Real timeElapsed, ParticleStreams& streams)
+    {
+        (void)pSystem;
+        ParticleAffectorKernels* kernels = ParticleAffectorKernels::getImplementation();
+        Real* x = streams.getStream(ParticleStreams::PS_DIRECTION_X);
+        Real* y = streams.getStream(ParticleStreams::PS_DIRECTION_Y);
+        Real* z = streams.getStream(ParticleStreams::PS_DIRECTION_Z);
+
+        if (mForceApplication == FA_ADD)
+        {
+            kernels->addVector(x, y, z, mForceVector * timeElapsed, streams.size());
+        }
+        else // FA_AVERAGE
+        {
+            kernels->averageVector(x, y, z, mForceVector, streams.size());
+        }
+    }
+    //-----------------------------------------------------------------------
     void LinearForceAffector::setForceVector(const Vector3& force)
     {
         mForceVector = force;
@@ -0,0 +1,82 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreParticleAffectorKernels.h"
+#include "OgrePlatformInformation.h"
+
+namespace Ogre {
+
+    //-------------------------------------------------------------------------
+    // External functions
+    extern ParticleAffectorKernels* _getParticleAffectorKernelsGeneral(void);
+#if __OGRE_HAVE_SSE
+    extern ParticleAffectorKernels* _getParticleAffectorKernelsSSE(void);
+#endif
+
+    //---------------------------------------------------------------------
+    ParticleAffectorKernels* ParticleAffectorKernels::msImplementation = ParticleAffectorKernels::_detectImplementation();
+
+    //---------------------------------------------------------------------
+    ParticleAffectorKernels* ParticleAffectorKernels::_detectImplementation(void)
+    {
+#if __OGRE_HAVE_SSE
+        if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE)
+        {
+            return _getParticleAffectorKernelsSSE();
+        }
+        else
+#endif  // __OGRE_HAVE_SSE
+        {
+            return _getParticleAffectorKernelsGeneral();
+        }
+    }
+    //---------------------------------------------------------------------
+    bool ParticleAffectorKernels::_selectImplementation(Implementation impl)
+    {
+        switch (impl)
+        {
+        case KI_GENERAL:
+            msImplementation = _getParticleAffectorKernelsGeneral();
+            return true;
+        case KI_SSE:
+#if __OGRE_HAVE_SSE
+            if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE)
+            {
+                msImplementation = _getParticleAffectorKernelsSSE();
+                return true;
+            }
+#endif  // __OGRE_HAVE_SSE
+            return false;
+        case KI_BEST:
+            msImplementation = _detectImplementation();
+            return true;
+        }
+
+        return false;
+    }
+
+}
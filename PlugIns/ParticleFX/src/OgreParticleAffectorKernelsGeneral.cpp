@@ -0,0 +1,279 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreParticleAffectorKernels.h"
+#include "OgreVector3.h"
+#include "OgreColourValue.h"
+
+namespace Ogre {
+
+//-------------------------------------------------------------------------
+// Local classes
+//-------------------------------------------------------------------------
+
+    /** General implementation of ParticleAffectorKernels.
+    @note
+        Don't use this class directly, use ParticleAffectorKernels instead.
+    */
+    class _OgrePrivate ParticleAffectorKernelsGeneral : public ParticleAffectorKernels
+    {
+    public:
+        /// @copydoc ParticleAffectorKernels::addVector
+        virtual void addVector(Real* x, Real* y, Real* z,
+            const Vector3& v, size_t count);
+
+        /// @copydoc ParticleAffectorKernels::averageVector
+        virtual void averageVector(Real* x, Real* y, Real* z,
+            const Vector3& v, size_t count);
+
+        /// @copydoc ParticleAffectorKernels::adjustColours
+        virtual void adjustColours(Real* const colour[4], const float adjust[4],
+            size_t count);
+
+        /// @copydoc ParticleAffectorKernels::adjustColoursByTime
+        virtual void adjustColoursByTime(Real* const colour[4], const Real* timeToLive,
+            Real threshold, const float adjust1[4], const float adjust2[4],
+            size_t count);
+
+        /// @copydoc ParticleAffectorKernels::interpolateColours
+        virtual void interpolateColours(Real* const colour[4], const Real* timeToLive,
+            const Real* totalTimeToLive, const Real* times, const ColourValue* colours,
+            size_t numStages, size_t count);
+
+        /// @copydoc ParticleAffectorKernels::scaleDimensions
+        virtual void scaleDimensions(Real* width, Real* height, Real* ownDimensions,
+            Real defaultWidth, Real defaultHeight, Real adjust, size_t count);
+
+        /// @copydoc ParticleAffectorKernels::rotate
+        virtual bool rotate(Real* rotation, const Real* rotationSpeed,
+            Real timeElapsed, size_t count);
+
+        /// @copydoc ParticleAffectorKernels::deflect
+        virtual void deflect(Real* const position[3], Real* const direction[3],
+            const Vector3& planeNormal, Real planeDistance, Real bounce,
+            Real timeElapsed, size_t count);
+    };
+    //---------------------------------------------------------------------
+    // Colours are held as float by the particles, so adjust them in float
+    static inline Real adjustWithClamp(Real component, float adjust)
+    {
+        float value = static_cast<float>(component) + adjust;
+        // Limit to 0
+        if (value < 0.0)
+        {
+            value = 0.0f;
+        }
+        // Limit to 1
+        else if (value > 1.0)
+        {
+            value = 1.0f;
+        }
+        return value;
+    }
+    //---------------------------------------------------------------------
+    void ParticleAffectorKernelsGeneral::addVector(Real* x, Real* y, Real* z,
+        const Vector3& v, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            x[i] += v.x;
+            y[i] += v.y;
+            z[i] += v.z;
+        }
+    }
+    //---------------------------------------------------------------------
+    void ParticleAffectorKernelsGeneral::averageVector(Real* x, Real* y, Real* z,
+        const Vector3& v, size_t count)
+    {
+        // Same as Vector3::operator/, which multiplies by the inverse
+        const Real half = 0.5f;
+        for (size_t i = 0; i < count; ++i)
+        {
+            x[i] = (x[i] + v.x) * half;
+            y[i] = (y[i] + v.y) * half;
+            z[i] = (z[i] + v.z) * half;
+        }
+    }
+    //---------------------------------------------------------------------
+    void ParticleAffectorKernelsGeneral::adjustColours(Real* const colour[4],
+        const float adjust[4], size_t count)
+    {
+        for (size_t c = 0; c < 4; ++c)
+        {
+            Real* component = colour[c];
+            const float adj = adjust[c];
+            for (size_t i = 0; i < count; ++i)
+            {
+                component[i] = adjustWithClamp(component[i], adj);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void ParticleAffectorKernelsGeneral::adjustColoursByTime(Real* const colour[4],
+        const Real* timeToLive, Real threshold, const float adjust1[4], const float adjust2[4],
+        size_t count)
+    {
+        for (size_t c = 0; c < 4; ++c)
+        {
+            Real* component = colour[c];
+            const float adj1 = adjust1[c];
+            const float adj2 = adjust2[c];
+            for (size_t i = 0; i < count; ++i)
+            {
+                component[i] = adjustWithClamp(component[i],
+                    timeToLive[i] > threshold ? adj1 : adj2);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void ParticleAffectorKernelsGeneral::interpolateColours(Real* const colour[4],
+        const Real* timeToLive, const Real* totalTimeToLive, const Real* times,
+        const ColourValue* colours, size_t numStages, size_t count)
+    {
+        Real* r = colour[0];
+        Real* g = colour[1];
+        Real* b = colour[2];
+        Real* a = colour[3];
+        const size_t last = numStages - 1;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            Real particleTime = 1.0f - (timeToLive[i] / totalTimeToLive[i]);
+
+            const ColourValue* result = 0;
+            if (particleTime <= times[0])
+            {
+                result = &colours[0];
+            }
+            else if (particleTime >= times[last])
+            {
+                result = &colours[last];
+            }
+
+            if (result)
+            {
+                r[i] = result->r;
+                g[i] = result->g;
+                b[i] = result->b;
+                a[i] = result->a;
+                continue;
+            }
+
+            for (size_t s = 0; s < last; ++s)
+            {
+                if (particleTime >= times[s] && particleTime < times[s + 1])
+                {
+                    particleTime -= times[s];
+                    particleTime /= (times[s + 1] - times[s]);
+                    r[i] = static_cast<float>((colours[s + 1].r * particleTime) + (colours[s].r * (1.0f - particleTime)));
+                    g[i] = static_cast<float>((colours[s + 1].g * particleTime) + (colours[s].g * (1.0f - particleTime)));
+                    b[i] = static_cast<float>((colours[s + 1].b * particleTime) + (colours[s].b * (1.0f - particleTime)));
+                    a[i] = static_cast<float>((colours[s + 1].a * particleTime) + (colours[s].a * (1.0f - particleTime)));
+                    break;
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void ParticleAffectorKernelsGeneral::scaleDimensions(Real* width, Real* height,
+        Real* ownDimensions, Real defaultWidth, Real defaultHeight, Real adjust, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (ownDimensions[i] != 0)
+            {
+                width[i] += adjust;
+                height[i] += adjust;
+            }
+            else
+            {
+                width[i] = defaultWidth + adjust;
+                height[i] = defaultHeight + adjust;
+                ownDimensions[i] = 1;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    bool ParticleAffectorKernelsGeneral::rotate(Real* rotation, const Real* rotationSpeed,
+        Real timeElapsed, size_t count)
+    {
+        bool rotated = false;
+        for (size_t i = 0; i < count; ++i)
+        {
+            rotation[i] = rotation[i] + (timeElapsed * rotationSpeed[i]);
+            rotated |= rotation[i] != 0;
+        }
+        return rotated;
+    }
+    //---------------------------------------------------------------------
+    void ParticleAffectorKernelsGeneral::deflect(Real* const position[3],
+        Real* const direction[3], const Vector3& planeNormal, Real planeDistance,
+        Real bounce, Real timeElapsed, size_t count)
+    {
+        Real* px = position[0];
+        Real* py = position[1];
+        Real* pz = position[2];
+        Real* dx = direction[0];
+        Real* dy = direction[1];
+        Real* dz = direction[2];
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Vector3 pos(px[i], py[i], pz[i]);
+            const Vector3 dir(dx[i], dy[i], dz[i]);
+
+            Vector3 step(dir * timeElapsed);
+            if (planeNormal.dotProduct(pos + step) + planeDistance <= 0.0)
+            {
+                Real a = planeNormal.dotProduct(pos) + planeDistance;
+                if (a > 0.0)
+                {
+                    // for intersection point
+                    Vector3 stepPart = step * (- a / step.dotProduct(planeNormal));
+                    // set new position
+                    Vector3 newPos = (pos + stepPart) + ((stepPart - step) * bounce);
+                    // reflect direction vector
+                    Vector3 newDir = (dir - (2.0f * dir.dotProduct(planeNormal) * planeNormal)) * bounce;
+
+                    px[i] = newPos.x;
+                    py[i] = newPos.y;
+                    pz[i] = newPos.z;
+                    dx[i] = newDir.x;
+                    dy[i] = newDir.y;
+                    dz[i] = newDir.z;
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    extern ParticleAffectorKernels* _getParticleAffectorKernelsGeneral(void)
+    {
+        static ParticleAffectorKernelsGeneral msParticleAffectorKernelsGeneral;
+        return &msParticleAffectorKernelsGeneral;
+    }
+
+}
@@ -0,0 +1,338 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreParticleAffectorKernels.h"
+#include "OgrePlatformInformation.h"
+
+#if __OGRE_HAVE_SSE
+
+#include "OgreVector3.h"
+#include "OgreColourValue.h"
+
+// Keep this include last, as OgreOptimisedUtilSSE.cpp does with OgreSIMDHelper.h
+#include <xmmintrin.h>
+
+// Streams are aligned and padded to a multiple of 4 values, so all
+// kernels below process whole groups of 4 particles; the values computed
+// for the padding are never read back.
+
+namespace Ogre {
+
+//-------------------------------------------------------------------------
+// Local classes
+//-------------------------------------------------------------------------
+
+    /** SSE implementation of ParticleAffectorKernels.
+    @note
+        Don't use this class directly, use ParticleAffectorKernels instead.
+    */
+    class _OgrePrivate ParticleAffectorKernelsSSE : public ParticleAffectorKernels
+    {
+    public:
+        /// @copydoc ParticleAffectorKernels::addVector
+        virtual void addVector(Real* x, Real* y, Real* z,
+            const Vector3& v, size_t count);
+
+        /// @copydoc ParticleAffectorKernels::averageVector
+        virtual void averageVector(Real* x, Real* y, Real* z,
+            const Vector3& v, size_t count);
+
+        /// @copydoc ParticleAffectorKernels::adjustColours
+        virtual void adjustColours(Real* const colour[4], const float adjust[4],
+            size_t count);
+
+        /// @copydoc ParticleAffectorKernels::adjustColoursByTime
+        virtual void adjustColoursByTime(Real* const colour[4], const Real* timeToLive,
+            Real threshold, const float adjust1[4], const float adjust2[4],
+            size_t count);
+
+        /// @copydoc ParticleAffectorKernels::interpolateColours
+        virtual void interpolateColours(Real* const colour[4], const Real* timeToLive,
+            const Real* totalTimeToLive, const Real* times, const ColourValue* colours,
+            size_t numStages, size_t count);
+
+        /// @copydoc ParticleAffectorKernels::scaleDimensions
+        virtual void scaleDimensions(Real* width, Real* height, Real* ownDimensions,
+            Real defaultWidth, Real defaultHeight, Real adjust, size_t count);
+
+        /// @copydoc ParticleAffectorKernels::rotate
+        virtual bool rotate(Real* rotation, const Real* rotationSpeed,
+            Real timeElapsed, size_t count);
+
+        /// @copydoc ParticleAffectorKernels::deflect
+        virtual void deflect(Real* const position[3], Real* const direction[3],
+            const Vector3& planeNormal, Real planeDistance, Real bounce,
+            Real timeElapsed, size_t count);
+    };
+    //---------------------------------------------------------------------
+    /// Picks a where mask is set, b elsewhere
+    static FORCEINLINE __m128 select(__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+    //---------------------------------------------------------------------
+    /// Adds and clamps to [0, 1]; the operand order keeps NaN as the scalar code does
+    static FORCEINLINE __m128 adjustWithClamp(__m128 value, __m128 adjust)
+    {
+        value = _mm_add_ps(value, adjust);
+        value = _mm_max_ps(_mm_setzero_ps(), value);
+        return _mm_min_ps(_mm_set1_ps(1.0f), value);
+    }
+    //---------------------------------------------------------------------
+    void ParticleAffectorKernelsSSE::addVector(Real* x, Real* y, Real* z,
+        const Vector3& v, size_t count)
+    {
+        const __m128 vx = _mm_set1_ps(v.x);
+        const __m128 vy = _mm_set1_ps(v.y);
+        const __m128 vz = _mm_set1_ps(v.z);
+        for (size_t i = 0; i < count; i += 4)
+        {
+            _mm_store_ps(x + i, _mm_add_ps(_mm_load_ps(x + i), vx));
+            _mm_store_ps(y + i, _mm_add_ps(_mm_load_ps(y + i), vy));
+            _mm_store_ps(z + i, _mm_add_ps(_mm_load_ps(z + i), vz));
+        }
+    }
+    //---------------------------------------------------------------------
+    void ParticleAffectorKernelsSSE::averageVector(Real* x, Real* y, Real* z,
+        const Vector3& v, size_t count)
+    {
+        const __m128 vx = _mm_set1_ps(v.x);
+        const __m128 vy = _mm_set1_ps(v.y);
+        const __m128 vz = _mm_set1_ps(v.z);
+        const __m128 half = _mm_set1_ps(0.5f);
+        for (size_t i = 0; i < count; i += 4)
+        {
+            _mm_store_ps(x + i, _mm_mul_ps(_mm_add_ps(_mm_load_ps(x + i), vx), half));
+            _mm_store_ps(y + i, _mm_mul_ps(_mm_add_ps(_mm_load_ps(y + i), vy), half));
+            _mm_store_ps(z + i, _mm_mul_ps(_mm_add_ps(_mm_load_ps(z + i), vz), half));
+        }
+    }
+    //---------------------------------------------------------------------
+    void ParticleAffectorKernelsSSE::adjustColours(Real* const colour[4],
+        const float adjust[4], size_t count)
+    {
+        for (size_t c = 0; c < 4; ++c)
+        {
+            Real* component = colour[c];
+            const __m128 adj = _mm_set1_ps(adjust[c]);
+            for (size_t i = 0; i < count; i += 4)
+            {
+                _mm_store_ps(component + i, adjustWithClamp(_mm_load_ps(component + i), adj));
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void ParticleAffectorKernelsSSE::adjustColoursByTime(Real* const colour[4],
+        const Real* timeToLive, Real threshold, const float adjust1[4], const float adjust2[4],
+        size_t count)
+    {
+        const __m128 limit = _mm_set1_ps(threshold);
+        for (size_t c = 0; c < 4; ++c)
+        {
+            Real* component = colour[c];
+            const __m128 adj1 = _mm_set1_ps(adjust1[c]);
+            const __m128 adj2 = _mm_set1_ps(adjust2[c]);
+            for (size_t i = 0; i < count; i += 4)
+            {
+                const __m128 mask = _mm_cmpgt_ps(_mm_load_ps(timeToLive + i), limit);
+                _mm_store_ps(component + i, adjustWithClamp(_mm_load_ps(component + i),
+                    select(mask, adj1, adj2)));
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void ParticleAffectorKernelsSSE::interpolateColours(Real* const colour[4],
+        const Real* timeToLive, const Real* totalTimeToLive, const Real* times,
+        const ColourValue* colours, size_t numStages, size_t count)
+    {
+        const size_t last = numStages - 1;
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 firstTime = _mm_set1_ps(times[0]);
+        const __m128 lastTime = _mm_set1_ps(times[last]);
+
+        for (size_t i = 0; i < count; i += 4)
+        {
+            const __m128 t = _mm_sub_ps(one, _mm_div_ps(
+                _mm_load_ps(timeToLive + i), _mm_load_ps(totalTimeToLive + i)));
+
+            // Particles outside all stages keep their colour
+            __m128 result[4];
+            for (size_t c = 0; c < 4; ++c)
+                result[c] = _mm_load_ps(colour[c] + i);
+
+            // Before the first and after the last stage
+            __m128 done = _mm_cmple_ps(t, firstTime);
+            const __m128 after = _mm_andnot_ps(done, _mm_cmpge_ps(t, lastTime));
+            for (size_t c = 0; c < 4; ++c)
+            {
+                result[c] = select(done, _mm_set1_ps(colours[0][c]), result[c]);
+                result[c] = select(after, _mm_set1_ps(colours[last][c]), result[c]);
+            }
+            done = _mm_or_ps(done, after);
+
+            // First stage containing the time
+            for (size_t s = 0; s < last && _mm_movemask_ps(done) != 0xF; ++s)
+            {
+                const __m128 t0 = _mm_set1_ps(times[s]);
+                const __m128 t1 = _mm_set1_ps(times[s + 1]);
+                const __m128 inside = _mm_andnot_ps(done,
+                    _mm_and_ps(_mm_cmpge_ps(t, t0), _mm_cmplt_ps(t, t1)));
+                if (!_mm_movemask_ps(inside))
+                    continue;
+
+                const __m128 u = _mm_div_ps(_mm_sub_ps(t, t0), _mm_sub_ps(t1, t0));
+                const __m128 v = _mm_sub_ps(one, u);
+                for (size_t c = 0; c < 4; ++c)
+                {
+                    const __m128 value = _mm_add_ps(
+                        _mm_mul_ps(_mm_set1_ps(colours[s + 1][c]), u),
+                        _mm_mul_ps(_mm_set1_ps(colours[s][c]), v));
+                    result[c] = select(inside, value, result[c]);
+                }
+                done = _mm_or_ps(done, inside);
+            }
+
+            for (size_t c = 0; c < 4; ++c)
+                _mm_store_ps(colour[c] + i, result[c]);
+        }
+    }
+    //---------------------------------------------------------------------
+    void ParticleAffectorKernelsSSE::scaleDimensions(Real* width, Real* height,
+        Real* ownDimensions, Real defaultWidth, Real defaultHeight, Real adjust, size_t count)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 defWidth = _mm_set1_ps(defaultWidth);
+        const __m128 defHeight = _mm_set1_ps(defaultHeight);
+        const __m128 adj = _mm_set1_ps(adjust);
+        for (size_t i = 0; i < count; i += 4)
+        {
+            const __m128 own = _mm_cmpneq_ps(_mm_load_ps(ownDimensions + i), zero);
+            const __m128 w = select(own, _mm_load_ps(width + i), defWidth);
+            const __m128 h = select(own, _mm_load_ps(height + i), defHeight);
+            _mm_store_ps(width + i, _mm_add_ps(w, adj));
+            _mm_store_ps(height + i, _mm_add_ps(h, adj));
+            _mm_store_ps(ownDimensions + i, one);
+        }
+    }
+    //---------------------------------------------------------------------
+    bool ParticleAffectorKernelsSSE::rotate(Real* rotation, const Real* rotationSpeed,
+        Real timeElapsed, size_t count)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 t = _mm_set1_ps(timeElapsed);
+        int rotated = 0;
+        for (size_t i = 0; i < count; i += 4)
+        {
+            const __m128 r = _mm_add_ps(_mm_load_ps(rotation + i),
+                _mm_mul_ps(t, _mm_load_ps(rotationSpeed + i)));
+            _mm_store_ps(rotation + i, r);
+
+            // Ignore the padding of the last group
+            const int valid = count - i >= 4 ? 0xF : (1 << (count - i)) - 1;
+            rotated |= _mm_movemask_ps(_mm_cmpneq_ps(r, zero)) & valid;
+        }
+        return rotated != 0;
+    }
+    //---------------------------------------------------------------------
+    void ParticleAffectorKernelsSSE::deflect(Real* const position[3],
+        Real* const direction[3], const Vector3& planeNormal, Real planeDistance,
+        Real bounce, Real timeElapsed, size_t count)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 two = _mm_set1_ps(2.0f);
+        const __m128 nx = _mm_set1_ps(planeNormal.x);
+        const __m128 ny = _mm_set1_ps(planeNormal.y);
+        const __m128 nz = _mm_set1_ps(planeNormal.z);
+        const __m128 dist = _mm_set1_ps(planeDistance);
+        const __m128 b = _mm_set1_ps(bounce);
+        const __m128 t = _mm_set1_ps(timeElapsed);
+
+        for (size_t i = 0; i < count; i += 4)
+        {
+            const __m128 px = _mm_load_ps(position[0] + i);
+            const __m128 py = _mm_load_ps(position[1] + i);
+            const __m128 pz = _mm_load_ps(position[2] + i);
+            const __m128 dx = _mm_load_ps(direction[0] + i);
+            const __m128 dy = _mm_load_ps(direction[1] + i);
+            const __m128 dz = _mm_load_ps(direction[2] + i);
+
+            // Step of this frame
+            const __m128 sx = _mm_mul_ps(dx, t);
+            const __m128 sy = _mm_mul_ps(dy, t);
+            const __m128 sz = _mm_mul_ps(dz, t);
+
+            // Ends behind the plane...
+            const __m128 endDist = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(nx, _mm_add_ps(px, sx)),
+                _mm_mul_ps(ny, _mm_add_ps(py, sy))),
+                _mm_mul_ps(nz, _mm_add_ps(pz, sz))), dist);
+            // ...and starts in front of it
+            const __m128 a = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(nx, px), _mm_mul_ps(ny, py)), _mm_mul_ps(nz, pz)), dist);
+            const __m128 mask = _mm_and_ps(_mm_cmple_ps(endDist, zero), _mm_cmpgt_ps(a, zero));
+            if (!_mm_movemask_ps(mask))
+                continue;
+
+            // Intersection point
+            const __m128 stepDot = _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(sx, nx), _mm_mul_ps(sy, ny)), _mm_mul_ps(sz, nz));
+            const __m128 k = _mm_div_ps(_mm_sub_ps(zero, a), stepDot);
+            const __m128 ix = _mm_mul_ps(sx, k);
+            const __m128 iy = _mm_mul_ps(sy, k);
+            const __m128 iz = _mm_mul_ps(sz, k);
+
+            // New position
+            const __m128 npx = _mm_add_ps(_mm_add_ps(px, ix), _mm_mul_ps(_mm_sub_ps(ix, sx), b));
+            const __m128 npy = _mm_add_ps(_mm_add_ps(py, iy), _mm_mul_ps(_mm_sub_ps(iy, sy), b));
+            const __m128 npz = _mm_add_ps(_mm_add_ps(pz, iz), _mm_mul_ps(_mm_sub_ps(iz, sz), b));
+
+            // Reflected direction
+            const __m128 dirDot = _mm_mul_ps(two, _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(dx, nx), _mm_mul_ps(dy, ny)), _mm_mul_ps(dz, nz)));
+            const __m128 ndx = _mm_mul_ps(_mm_sub_ps(dx, _mm_mul_ps(dirDot, nx)), b);
+            const __m128 ndy = _mm_mul_ps(_mm_sub_ps(dy, _mm_mul_ps(dirDot, ny)), b);
+            const __m128 ndz = _mm_mul_ps(_mm_sub_ps(dz, _mm_mul_ps(dirDot, nz)), b);
+
+            _mm_store_ps(position[0] + i, select(mask, npx, px));
+            _mm_store_ps(position[1] + i, select(mask, npy, py));
+            _mm_store_ps(position[2] + i, select(mask, npz, pz));
+            _mm_store_ps(direction[0] + i, select(mask, ndx, dx));
+            _mm_store_ps(direction[1] + i, select(mask, ndy, dy));
+            _mm_store_ps(direction[2] + i, select(mask, ndz, dz));
+        }
+    }
+    //---------------------------------------------------------------------
+    extern ParticleAffectorKernels* _getParticleAffectorKernelsSSE(void)
+    {
+        static ParticleAffectorKernelsSSE msParticleAffectorKernelsSSE;
+        return &msParticleAffectorKernelsSSE;
+    }
+
+}
+
+#endif // __OGRE_HAVE_SSE
@@ -26,9 +26,11 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreRotationAffector.h"
+#include "OgreParticleAffectorKernels.h"
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleStreams.h"
 
 
 namespace Ogre {
@@ -107,6 +109,18 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void RotationAffector::_affectParticleStreams(ParticleSystem* pSystem, Real timeElapsed, ParticleStreams& streams)
+    {
+        // Once for all particles, as Particle::setRotation would
+        if (ParticleAffectorKernels::getImplementation()->rotate(
+            streams.getStream(ParticleStreams::PS_ROTATION),
+            streams.getStream(ParticleStreams::PS_ROTATION_SPEED),
+            timeElapsed, streams.size()))
+        {
+            pSystem->_notifyParticleRotated();
+        }
+    }
+    //-----------------------------------------------------------------------
     const Radian& RotationAffector::getRotationSpeedRangeStart(void) const
     {
         return mRotationSpeedRangeStart;
@@ -26,9 +26,11 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreScaleAffector.h"
+#include "OgreParticleAffectorKernels.h"
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleStreams.h"
 
 
 namespace Ogre {
@@ -85,6 +87,23 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void ScaleAffector::_affectParticleStreams(ParticleSystem* pSystem, Real timeElapsed, ParticleStreams& streams)
+    {
+        if (streams.empty())
+            return;
+
+        // Scale adjustments by time
+        ParticleAffectorKernels::getImplementation()->scaleDimensions(
+            streams.getStream(ParticleStreams::PS_WIDTH),
+            streams.getStream(ParticleStreams::PS_HEIGHT),
+            streams.getStream(ParticleStreams::PS_OWN_DIMENSIONS),
+            pSystem->getDefaultWidth(), pSystem->getDefaultHeight(),
+            mScaleAdj * timeElapsed, streams.size());
+
+        // Once for all particles, as Particle::setDimensions would
+        pSystem->_notifyParticleResized();
+    }
+    //-----------------------------------------------------------------------
     void ScaleAffector::setAdjust( Real rate )
     {
         mScaleAdj = rate;
@@ -0,0 +1,85 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ShaderProgramCacheTests_H__
+#define __ShaderProgramCacheTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "OgrePrerequisites.h"
+#include "OgreGpuProgramManager.h"
+#include "OgreShaderPrerequisites.h"
+#include "OgreShaderProgramWriter.h"
+
+/// GPU program manager of a render system which supports no syntax
+class CacheTestGpuProgramManager : public Ogre::GpuProgramManager
+{
+public:
+    const SyntaxCodes& getSupportedSyntax(void) const { return mSyntaxCodes; }
+    bool isSyntaxSupported(const Ogre::String& syntaxCode) const { return false; }
+
+protected:
+    SyntaxCodes mSyntaxCodes;
+
+    Ogre::Resource* createImpl(const Ogre::String& name, Ogre::ResourceHandle handle,
+        const Ogre::String& group, bool isManual, Ogre::ManualResourceLoader* loader,
+        const Ogre::NameValuePairList* params) { return 0; }
+    Ogre::Resource* createImpl(const Ogre::String& name, Ogre::ResourceHandle handle,
+        const Ogre::String& group, bool isManual, Ogre::ManualResourceLoader* loader,
+        Ogre::GpuProgramType gptype, const Ogre::String& syntaxCode) { return 0; }
+};
+
+class ShaderProgramCacheTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(ShaderProgramCacheTests);
+    CPPUNIT_TEST(testCacheKeyStable);
+    CPPUNIT_TEST(testCacheKeyChanges);
+    CPPUNIT_TEST(testSaveLoadRoundTrip);
+    CPPUNIT_TEST(testLoadUnknownVersion);
+    CPPUNIT_TEST(testMicrocodeCacheOptIn);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    Ogre::Root* mRoot;
+    CacheTestGpuProgramManager* mGpuProgramManager;
+    Ogre::RTShader::ProgramWriter* mWriter;
+
+    Ogre::RTShader::Program* createProgram(int positionMask);
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testCacheKeyStable();
+    void testCacheKeyChanges();
+    void testSaveLoadRoundTrip();
+    void testLoadUnknownVersion();
+    void testMicrocodeCacheOptIn();
+};
+
+#endif
@@ -0,0 +1,261 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ShaderProgramCacheTests.h"
+#include "OgreRoot.h"
+#include "OgreDataStream.h"
+#include "OgreHighLevelGpuProgramManager.h"
+#include "OgreShaderGenerator.h"
+#include "OgreShaderProgramManager.h"
+#include "OgreShaderProgram.h"
+#include "OgreShaderFunctionAtom.h"
+#include "OgreShaderFFPRenderState.h"
+#include "OgreShaderCGProgramWriter.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+using namespace Ogre::RTShader;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(ShaderProgramCacheTests);
+
+//--------------------------------------------------------------------------
+/// Reaches the program creation and cache keys of the program manager
+class ProgramManagerAccess : public ProgramManager
+{
+public:
+    static Program* createCpu(GpuProgramType type)
+    {
+        Program* (ProgramManager::*create)(GpuProgramType) = &ProgramManagerAccess::createCpuProgram;
+        return (ProgramManager::getSingleton().*create)(type);
+    }
+
+    static void destroyCpu(Program* program)
+    {
+        void (ProgramManager::*destroy)(Program*) = &ProgramManagerAccess::destroyCpuProgram;
+        (ProgramManager::getSingleton().*destroy)(program);
+    }
+
+    static String cacheKey(Program* program, const String& language, const String& profiles)
+    {
+        String (ProgramManager::*key)(Program*, const String&, const String&) =
+            &ProgramManagerAccess::generateProgramCacheKey;
+        return (ProgramManager::getSingleton().*key)(program, language, profiles);
+    }
+
+    static GpuProgramPtr createGpu(Program* program, ProgramWriter* writer, const String& language)
+    {
+        GpuProgramPtr (ProgramManager::*create)(Program*, ProgramWriter*, const String&,
+            const String&, const StringVector&, const String&) = &ProgramManagerAccess::createGpuProgram;
+        return (ProgramManager::getSingleton().*create)(program, writer, language,
+            "vs_1_1", StringUtil::split("vs_1_1"), BLANKSTRING);
+    }
+};
+//--------------------------------------------------------------------------
+void ShaderProgramCacheTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+    mGpuProgramManager = OGRE_NEW CacheTestGpuProgramManager();
+    ShaderGenerator::initialize();
+    mWriter = OGRE_NEW CGProgramWriter();
+}
+//--------------------------------------------------------------------------
+void ShaderProgramCacheTests::tearDown()
+{
+    OGRE_DELETE mWriter;
+    ShaderGenerator::destroy();
+    OGRE_DELETE mGpuProgramManager;
+    OGRE_DELETE mRoot;
+}
+//--------------------------------------------------------------------------
+/// Builds the vertex program of the FFP transform, built anew for each call
+Program* ShaderProgramCacheTests::createProgram(int positionMask)
+{
+    Program* program = ProgramManagerAccess::createCpu(GPT_VERTEX_PROGRAM);
+    program->addDependency(FFP_LIB_COMMON);
+    program->addDependency(FFP_LIB_TRANSFORM);
+
+    Function* main = program->createFunction("main", "Vertex Program Entry point", Function::FFT_VS_MAIN);
+    program->setEntryPointFunction(main);
+
+    UniformParameterPtr wvpMatrix = program->resolveAutoParameterInt(GpuProgramParameters::ACT_WORLDVIEWPROJ_MATRIX, 0);
+    ParameterPtr positionIn = main->resolveInputParameter(Parameter::SPS_POSITION, 0, Parameter::SPC_POSITION_OBJECT_SPACE, GCT_FLOAT4);
+    ParameterPtr positionOut = main->resolveOutputParameter(Parameter::SPS_POSITION, 0, Parameter::SPC_POSITION_PROJECTIVE_SPACE, GCT_FLOAT4);
+
+    FunctionInvocation* transformFunc = OGRE_NEW FunctionInvocation(FFP_FUNC_TRANSFORM, FFP_VS_TRANSFORM, 0);
+    transformFunc->pushOperand(wvpMatrix, Operand::OPS_IN);
+    transformFunc->pushOperand(positionIn, Operand::OPS_IN, positionMask);
+    transformFunc->pushOperand(positionOut, Operand::OPS_OUT);
+    main->addAtomInstance(transformFunc);
+
+    return program;
+}
+//--------------------------------------------------------------------------
+void ShaderProgramCacheTests::testCacheKeyStable()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Programs built separately with the same structure share their key.
+    Program* first = createProgram(Operand::OPM_ALL);
+    Program* second = createProgram(Operand::OPM_ALL);
+
+    String key = ProgramManagerAccess::cacheKey(first, "cg", "vs_1_1");
+    CPPUNIT_ASSERT_EQUAL(size_t(32), key.size());
+    CPPUNIT_ASSERT_EQUAL(key, ProgramManagerAccess::cacheKey(first, "cg", "vs_1_1"));
+    CPPUNIT_ASSERT_EQUAL(key, ProgramManagerAccess::cacheKey(second, "cg", "vs_1_1"));
+
+    ProgramManagerAccess::destroyCpu(first);
+    ProgramManagerAccess::destroyCpu(second);
+}
+//--------------------------------------------------------------------------
+void ShaderProgramCacheTests::testCacheKeyChanges()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Program* program = createProgram(Operand::OPM_ALL);
+    String key = ProgramManagerAccess::cacheKey(program, "cg", "vs_1_1");
+
+    // The target of the writers.
+    CPPUNIT_ASSERT(key != ProgramManagerAccess::cacheKey(program, "hlsl", "vs_1_1"));
+    CPPUNIT_ASSERT(key != ProgramManagerAccess::cacheKey(program, "cg", "vs_2_0"));
+
+    // An operand mask.
+    Program* masked = createProgram(Operand::OPM_XYZ);
+    CPPUNIT_ASSERT(key != ProgramManagerAccess::cacheKey(masked, "cg", "vs_1_1"));
+
+    // A uniform parameter.
+    Program* extended = createProgram(Operand::OPM_ALL);
+    extended->resolveAutoParameterInt(GpuProgramParameters::ACT_WORLD_MATRIX, 0);
+    CPPUNIT_ASSERT(key != ProgramManagerAccess::cacheKey(extended, "cg", "vs_1_1"));
+
+    // A dependency.
+    Program* dependent = createProgram(Operand::OPM_ALL);
+    dependent->addDependency(FFP_LIB_LIGHTING);
+    CPPUNIT_ASSERT(key != ProgramManagerAccess::cacheKey(dependent, "cg", "vs_1_1"));
+
+    ProgramManagerAccess::destroyCpu(program);
+    ProgramManagerAccess::destroyCpu(masked);
+    ProgramManagerAccess::destroyCpu(extended);
+    ProgramManagerAccess::destroyCpu(dependent);
+}
+//--------------------------------------------------------------------------
+void ShaderProgramCacheTests::testSaveLoadRoundTrip()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    ProgramManager& manager = ProgramManager::getSingleton();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), manager.getProgramCacheSize());
+
+    // The first program is written and added to the cache.
+    Program* program = createProgram(Operand::OPM_ALL);
+    GpuProgramPtr gpuProgram = ProgramManagerAccess::createGpu(program, mWriter, "cg");
+    CPPUNIT_ASSERT(!gpuProgram.isNull());
+    const String name = gpuProgram->getName();
+    const String source = gpuProgram->getSource();
+    CPPUNIT_ASSERT(!source.empty());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), manager.getProgramCacheSize());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), manager.getProgramCacheMisses());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), manager.getProgramCacheHits());
+    CPPUNIT_ASSERT(manager.isProgramCacheDirty());
+    ProgramManagerAccess::destroyCpu(program);
+    gpuProgram.setNull();
+
+    DataStreamPtr stream(OGRE_NEW MemoryDataStream(source.size() + 1024));
+    manager.saveProgramCache(stream);
+    CPPUNIT_ASSERT(!manager.isProgramCacheDirty());
+
+    // As in a new session, nothing is cached or created.
+    manager.clearProgramCache();
+    manager.flushGpuProgramsCache();
+    CPPUNIT_ASSERT(HighLevelGpuProgramManager::getSingleton().getByName(name).isNull());
+
+    stream->seek(0);
+    CPPUNIT_ASSERT(manager.loadProgramCache(stream));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), manager.getProgramCacheSize());
+    CPPUNIT_ASSERT(!manager.isProgramCacheDirty());
+
+    // The same program is found in the loaded cache, with its name and source.
+    program = createProgram(Operand::OPM_ALL);
+    gpuProgram = ProgramManagerAccess::createGpu(program, mWriter, "cg");
+    CPPUNIT_ASSERT(!gpuProgram.isNull());
+    CPPUNIT_ASSERT_EQUAL(name, gpuProgram->getName());
+    CPPUNIT_ASSERT_EQUAL(source, gpuProgram->getSource());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), manager.getProgramCacheHits());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), manager.getProgramCacheMisses());
+    CPPUNIT_ASSERT(!manager.isProgramCacheDirty());
+    ProgramManagerAccess::destroyCpu(program);
+
+    // A different program is not.
+    program = createProgram(Operand::OPM_XYZ);
+    gpuProgram = ProgramManagerAccess::createGpu(program, mWriter, "cg");
+    CPPUNIT_ASSERT(name != gpuProgram->getName());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), manager.getProgramCacheHits());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), manager.getProgramCacheMisses());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), manager.getProgramCacheSize());
+    ProgramManagerAccess::destroyCpu(program);
+}
+//--------------------------------------------------------------------------
+void ShaderProgramCacheTests::testLoadUnknownVersion()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    ProgramManager& manager = ProgramManager::getSingleton();
+    Program* program = createProgram(Operand::OPM_ALL);
+    ProgramManagerAccess::createGpu(program, mWriter, "cg");
+    ProgramManagerAccess::destroyCpu(program);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), manager.getProgramCacheSize());
+
+    uint32 data[2] = { 0x52545330, 0 };
+    DataStreamPtr stream(OGRE_NEW MemoryDataStream(data, sizeof(data)));
+    CPPUNIT_ASSERT(!manager.loadProgramCache(stream));
+    CPPUNIT_ASSERT_EQUAL(size_t(0), manager.getProgramCacheSize());
+}
+//--------------------------------------------------------------------------
+void ShaderProgramCacheTests::testMicrocodeCacheOptIn()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    ShaderGenerator& generator = ShaderGenerator::getSingleton();
+    CPPUNIT_ASSERT(!generator.getMicrocodeCacheEnabled());
+
+    // A cache path alone leaves the microcode cache alone. Turning it on
+    // needs a render system, which this test has not.
+    generator.setShaderCachePath("./");
+    CPPUNIT_ASSERT_EQUAL(String("./"), generator.getShaderCachePath());
+    CPPUNIT_ASSERT(!mGpuProgramManager->getEnableMicrocodeCache());
+    generator.setShaderCachePath(BLANKSTRING);
+
+    // Without a cache path, the opt-in waits for one.
+    generator.setMicrocodeCacheEnabled(true);
+    CPPUNIT_ASSERT(generator.getMicrocodeCacheEnabled());
+    CPPUNIT_ASSERT(!mGpuProgramManager->getEnableMicrocodeCache());
+    generator.setMicrocodeCacheEnabled(false);
+    CPPUNIT_ASSERT(!generator.getMicrocodeCacheEnabled());
+}
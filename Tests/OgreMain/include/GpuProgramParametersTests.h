@@ -0,0 +1,67 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __GpuProgramParametersTests_H__
+#define __GpuProgramParametersTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "OgrePrerequisites.h"
+#include "OgreHardwareBufferManager.h"
+#include "UnitTestSuite.h"
+
+class GpuProgramParametersTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(GpuProgramParametersTests);
+    CPPUNIT_TEST(testDerivedMatrixCache);
+    CPPUNIT_TEST(testUpdateMatchesFullUpdate);
+    CPPUNIT_TEST(testSkipUnchangedAutos);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    Ogre::HardwareBufferManager* mBufMgr;
+    Ogre::Root* mRoot;
+    Ogre::SceneManager* mSceneMgr;
+    Ogre::Camera* mCamera;
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testDerivedMatrixCache();
+    void testUpdateMatchesFullUpdate();
+    void testSkipUnchangedAutos();
+    void testUpdateTiming();
+};
+
+/// Timings of the auto constant updates, run with --benchmarks
+OGRE_BENCHMARK_SUITE(GpuProgramParametersBenchmarks, GpuProgramParametersTests);
+    CPPUNIT_TEST(testUpdateTiming);
+OGRE_BENCHMARK_SUITE_END();
+
+#endif
@@ -51,6 +51,7 @@ class MeshSerializerTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testMesh_Version_1_4);
     CPPUNIT_TEST(testMesh_Version_1_3);
     CPPUNIT_TEST(testMesh_Version_1_2);
+    CPPUNIT_TEST(testMesh_MappedLoad);
     CPPUNIT_TEST_SUITE_END();
 
 protected:
@@ -75,6 +76,7 @@ public:
     void testMesh_Version_1_3();
     void testMesh_Version_1_2();
     void testMesh_XML();
+    void testMesh_MappedLoad();
     void testMesh(MeshVersion version);
     void assertMeshClone(Mesh* a, Mesh* b, MeshVersion version = MESH_VERSION_LATEST);
     void assertVertexDataClone(VertexData* a, VertexData* b, MeshVersion version = MESH_VERSION_LATEST);
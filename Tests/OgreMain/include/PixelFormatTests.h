@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "OgrePixelFormat.h"
+#include "UnitTestSuite.h"
 
 using namespace Ogre;
 
@@ -42,6 +43,9 @@ class PixelFormatTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testIntegerPackUnpack);
     CPPUNIT_TEST(testFloatPackUnpack);
     CPPUNIT_TEST(testBulkConversion);
+    CPPUNIT_TEST(testVectorisedConversion);
+    CPPUNIT_TEST(testHalfFloatConversion);
+    CPPUNIT_TEST(testParallelConversion);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -51,6 +55,10 @@ public:
     void testIntegerPackUnpack();
     void testFloatPackUnpack();
     void testBulkConversion();
+    void testVectorisedConversion();
+    void testHalfFloatConversion();
+    void testParallelConversion();
+    void testConversionTiming();
 
     // Utils
     void setupBoxes(PixelFormat srcFormat, PixelFormat dstFormat);
@@ -63,4 +71,9 @@ private:
     PixelBox mSrc, mDst1, mDst2;
 };
 
+/// Timings of the pixel conversions, run with --benchmarks
+OGRE_BENCHMARK_SUITE(PixelFormatBenchmarks, PixelFormatTests);
+    CPPUNIT_TEST(testConversionTiming);
+OGRE_BENCHMARK_SUITE_END();
+
 #endif
\ No newline at end of file
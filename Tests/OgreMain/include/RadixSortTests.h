@@ -42,6 +42,8 @@ class RadixSortTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testIntList);
     CPPUNIT_TEST(testUnsignedIntVector);
     CPPUNIT_TEST(testIntVector);
+    CPPUNIT_TEST(testUnsignedInt64Vector);
+    CPPUNIT_TEST(testSharedBytes);
     CPPUNIT_TEST_SUITE_END();
 
 protected:
@@ -56,6 +58,8 @@ public:
     void testIntList();
     void testUnsignedIntVector();
     void testIntVector();
+    void testUnsignedInt64Vector();
+    void testSharedBytes();
 };
 
 #endif
\ No newline at end of file
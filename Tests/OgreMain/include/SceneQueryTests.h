@@ -0,0 +1,76 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SceneQueryTests_H__
+#define __SceneQueryTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "OgrePrerequisites.h"
+#include "OgreMovableObject.h"
+#include "UnitTestSuite.h"
+
+/// Creates the objects of the scene query tests
+class QueryTestObjectFactory : public Ogre::MovableObjectFactory
+{
+protected:
+    Ogre::MovableObject* createInstanceImpl(const Ogre::String& name, const Ogre::NameValuePairList* params);
+
+public:
+    static Ogre::String FACTORY_TYPE_NAME;
+
+    const Ogre::String& getType(void) const { return FACTORY_TYPE_NAME; }
+    void destroyInstance(Ogre::MovableObject* obj);
+};
+
+class SceneQueryTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(SceneQueryTests);
+    CPPUNIT_TEST(testBroadphaseMatchesLinearScan);
+    CPPUNIT_TEST(testBroadphaseAfterSceneChanges);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    Ogre::Root* mRoot;
+    QueryTestObjectFactory* mFactory;
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testBroadphaseMatchesLinearScan();
+    void testBroadphaseAfterSceneChanges();
+    void testQueryTiming();
+};
+
+/// Timings of the scene queries, run with --benchmarks
+OGRE_BENCHMARK_SUITE(SceneQueryBenchmarks, SceneQueryTests);
+    CPPUNIT_TEST(testQueryTiming);
+OGRE_BENCHMARK_SUITE_END();
+
+#endif
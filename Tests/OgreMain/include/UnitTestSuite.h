@@ -30,8 +30,10 @@ THE SOFTWARE.
 #define __UnitTestSuite_H__
 
 #include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
 
 #include "OgreSingleton.h"
+#include "OgreTimer.h"
 
 class UnitTestSuite : public Ogre::Singleton<UnitTestSuite>, public Ogre::GeneralAllocatedObject
 {
@@ -45,4 +47,56 @@ public:
     void startTestMethod(const std::string testName);
 };
 
+/// Registry of the timing benchmarks, which main only runs with --benchmarks
+#define OGRE_BENCHMARK_REGISTRY "Benchmarks"
+
+/** Declares a subclass of a test fixture running its timing benchmarks.
+@remarks
+    Benchmarks only log how long they took, so they are kept out of the usual
+    tests: list them between OGRE_BENCHMARK_SUITE and OGRE_BENCHMARK_SUITE_END
+    with CPPUNIT_TEST, and register the subclass with
+    OGRE_BENCHMARK_SUITE_REGISTRATION.
+*/
+#define OGRE_BENCHMARK_SUITE(benchmarks, fixture) \
+    class benchmarks : public fixture \
+    { \
+        CPPUNIT_TEST_SUITE(benchmarks)
+
+#define OGRE_BENCHMARK_SUITE_END() \
+        CPPUNIT_TEST_SUITE_END(); \
+    }
+
+#define OGRE_BENCHMARK_SUITE_REGISTRATION(benchmarks) \
+    CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(benchmarks, OGRE_BENCHMARK_REGISTRY)
+
+/** Times the steps of a benchmark and logs them on one line.
+@remarks
+    The line starts with the name of the fixture and a description of the
+    benchmark, each timing and note is appended to it, and it is logged once
+    the BenchmarkLog is destroyed.
+*/
+class BenchmarkLog
+{
+public:
+    BenchmarkLog(const std::string& fixture, const std::string& description);
+    ~BenchmarkLog();
+
+    /// Restarts the timer, so that what was done since isn't timed
+    void restart();
+
+    /** Appends the time since the timer was started to the line, and restarts it.
+    @param step What was timed.
+    @param repeats How many times it was done, the time logged is per repeat.
+    @return The time logged, in microseconds.
+    */
+    unsigned long time(const std::string& step, size_t repeats = 1);
+
+    /// Appends something else than a timing to the line
+    void note(const std::string& text);
+
+private:
+    Ogre::Timer mTimer;
+    std::string mLine;
+};
+
 #endif
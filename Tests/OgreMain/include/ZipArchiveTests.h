@@ -47,6 +47,9 @@ class ZipArchiveTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testFindFileInfoRecursive);
     CPPUNIT_TEST(testFileRead);
     CPPUNIT_TEST(testReadInterleave);
+    CPPUNIT_TEST(testSeekBackwards);
+    CPPUNIT_TEST(testConcurrentRead);
+    CPPUNIT_TEST(testExists);
     CPPUNIT_TEST_SUITE_END();
 
 protected:
@@ -66,6 +69,9 @@ public:
     void testFindFileInfoRecursive();
     void testFileRead();
     void testReadInterleave();
+    void testSeekBackwards();
+    void testConcurrentRead();
+    void testExists();
 };
 
 #endif
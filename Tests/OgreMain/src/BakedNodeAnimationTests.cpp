@@ -0,0 +1,496 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "BakedNodeAnimationTests.h"
+#include "OgreRoot.h"
+#include "OgreSkeleton.h"
+#include "OgreSkeletonManager.h"
+#include "OgreBone.h"
+#include "OgreAnimation.h"
+#include "OgreAnimationTrack.h"
+#include "OgreAnimationState.h"
+#include "OgreKeyFrame.h"
+#include "OgreMath.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+#include "OgreBakedNodeAnimation.h"
+#include "OgreSkeletonSerializer.h"
+#include "OgreDataStream.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(BakedNodeAnimationTests);
+
+//--------------------------------------------------------------------------
+static const unsigned short NUM_BONES = 80;
+static const Real ANIMATION_LENGTH = 10;
+//--------------------------------------------------------------------------
+/// Skeleton with a walk animation of random keyframes on every bone
+static SkeletonPtr createSkeleton(bool baked)
+{
+    srand(0);
+    SkeletonPtr skeleton = SkeletonManager::getSingleton().create(baked ? "Baked" : "Tracks",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+    skeleton->load();
+    for (unsigned short b = 0; b < NUM_BONES; ++b)
+    {
+        Bone* bone = skeleton->createBone(b);
+        if (b)
+            skeleton->getBone(static_cast<unsigned short>(rand() % b))->addChild(bone);
+    }
+    skeleton->setBindingPose();
+
+    Animation* anim = skeleton->createAnimation("Walk", ANIMATION_LENGTH);
+    anim->setUseBakedNodeTracks(baked);
+    for (unsigned short b = 0; b < NUM_BONES; ++b)
+    {
+        NodeAnimationTrack* track = anim->createNodeTrack(b, skeleton->getBone(b));
+        track->setUseShortestRotationPath(b % 7 != 0);
+        // Some tracks start late, one has no keyframes at all
+        const size_t numKeyFrames = b == 3 ? 0 : 1 + rand() % 30;
+        Real time = (b % 5 == 0) ? Math::RangeRandom(0, 1) : 0;
+        for (size_t k = 0; k < numKeyFrames && time < ANIMATION_LENGTH; ++k)
+        {
+            TransformKeyFrame* kf = track->createNodeKeyFrame(time);
+            kf->setTranslate(Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(),
+                Math::SymmetricRandom()) * 10);
+            kf->setRotation(Quaternion(Radian(Math::RangeRandom(-Math::PI, Math::PI)),
+                Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(), Math::SymmetricRandom()).normalisedCopy()));
+            kf->setScale(Vector3(Math::RangeRandom(0.5, 2), Math::RangeRandom(0.5, 2), Math::RangeRandom(0.5, 2)));
+            time += Math::RangeRandom(0.05f, 1.0f);
+        }
+    }
+    return skeleton;
+}
+//--------------------------------------------------------------------------
+static void assertSameBones(const SkeletonPtr& expected, const SkeletonPtr& actual)
+{
+    for (unsigned short b = 0; b < NUM_BONES; ++b)
+    {
+        Bone* e = expected->getBone(b);
+        Bone* a = actual->getBone(b);
+        CPPUNIT_ASSERT(e->getPosition() == a->getPosition());
+        CPPUNIT_ASSERT(e->getOrientation() == a->getOrientation());
+        CPPUNIT_ASSERT(e->getScale() == a->getScale());
+    }
+}
+//--------------------------------------------------------------------------
+/// Skeleton with an animation sampled at 30 frames per second, as exporters write them
+static SkeletonPtr createSampledSkeleton(const String& name)
+{
+    srand(1);
+    SkeletonPtr skeleton = SkeletonManager::getSingleton().create(name,
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+    skeleton->load();
+    for (unsigned short b = 0; b < NUM_BONES; ++b)
+    {
+        Bone* bone = skeleton->createBone(b);
+        if (b)
+            skeleton->getBone(static_cast<unsigned short>(rand() % b))->addChild(bone);
+    }
+    skeleton->setBindingPose();
+
+    Animation* anim = skeleton->createAnimation("Walk", ANIMATION_LENGTH);
+    for (unsigned short b = 0; b < NUM_BONES; ++b)
+    {
+        NodeAnimationTrack* track = anim->createNodeTrack(b, skeleton->getBone(b));
+        track->setUseShortestRotationPath(b % 7 != 0);
+        const Real frequency = Math::RangeRandom(0.2f, 2.0f);
+        const Real phase = Math::RangeRandom(0, Math::TWO_PI);
+        const Vector3 axis = Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(),
+            Math::SymmetricRandom()).normalisedCopy();
+        const Vector3 offset = Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(),
+            Math::SymmetricRandom()) * 10;
+        for (size_t k = 0; k <= 300; ++k)
+        {
+            const Real time = k / 30.0f;
+            const Real wave = Math::Sin(time * frequency * Math::TWO_PI + phase);
+            TransformKeyFrame* kf = track->createNodeKeyFrame(time);
+            // Some bones only rotate, some hold still for a while
+            if (b % 3 == 0)
+                kf->setTranslate(offset + Vector3(wave, 0.5f * wave, 0));
+            if (b % 11 != 0 || time < 5)
+                kf->setRotation(Quaternion(Radian(wave), axis));
+            if (b % 13 == 0)
+                kf->setScale(Vector3(1.0f + 0.25f * wave, 1, 1));
+        }
+    }
+    return skeleton;
+}
+//--------------------------------------------------------------------------
+void BakedNodeAnimationTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+}
+//--------------------------------------------------------------------------
+void BakedNodeAnimationTests::tearDown()
+{
+    OGRE_DELETE mRoot;
+}
+//--------------------------------------------------------------------------
+void BakedNodeAnimationTests::testBakedMatchesTracks()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    SkeletonPtr tracks = createSkeleton(false);
+    SkeletonPtr baked = createSkeleton(true);
+    AnimationStateSet tracksStates, bakedStates;
+    tracks->_initAnimationState(&tracksStates);
+    baked->_initAnimationState(&bakedStates);
+    AnimationState* tracksState = tracksStates.getAnimationState("Walk");
+    AnimationState* bakedState = bakedStates.getAnimationState("Walk");
+    tracksState->setEnabled(true);
+    bakedState->setEnabled(true);
+
+    const Animation::InterpolationMode im = Animation::IM_LINEAR;
+    for (int rim = Animation::RIM_LINEAR; rim <= Animation::RIM_SPHERICAL; ++rim)
+    {
+        tracks->getAnimation("Walk")->setRotationInterpolationMode(Animation::RotationInterpolationMode(rim));
+        baked->getAnimation("Walk")->setRotationInterpolationMode(Animation::RotationInterpolationMode(rim));
+        tracks->getAnimation("Walk")->setInterpolationMode(im);
+        baked->getAnimation("Walk")->setInterpolationMode(im);
+
+        // Forward playback across the loop point, then some jumps backwards
+        // and onto keyframe times
+        for (size_t step = 0; step < 400; ++step)
+        {
+            Real offset = 1 / 30.0f;
+            if (step % 50 == 49)
+                offset = -Math::RangeRandom(0, ANIMATION_LENGTH);
+            tracksState->addTime(offset);
+            bakedState->addTime(offset);
+            if (step % 77 == 76)
+            {
+                const NodeAnimationTrack* track = tracks->getAnimation("Walk")->getNodeTrack(10);
+                const Real time = track->getKeyFrame(track->getNumKeyFrames() / 2)->getTime();
+                tracksState->setTimePosition(time);
+                bakedState->setTimePosition(time);
+            }
+
+            // Half way through, weight some bones
+            if (step == 200)
+            {
+                tracksState->createBlendMask(NUM_BONES);
+                bakedState->createBlendMask(NUM_BONES);
+                for (unsigned short b = 0; b < NUM_BONES; b += 3)
+                {
+                    tracksState->setBlendMaskEntry(b, b % 2 ? 0.0f : 0.5f);
+                    bakedState->setBlendMaskEntry(b, b % 2 ? 0.0f : 0.5f);
+                }
+                tracksState->setWeight(0.75f);
+                bakedState->setWeight(0.75f);
+            }
+
+            tracks->setAnimationState(tracksStates);
+            baked->setAnimationState(bakedStates);
+            assertSameBones(tracks, baked);
+        }
+        tracksState->destroyBlendMask();
+        bakedState->destroyBlendMask();
+        tracksState->setWeight(1);
+        bakedState->setWeight(1);
+    }
+
+    // Timings of forward playback
+    const size_t numUpdates = 2000;
+    Timer timer;
+    for (size_t i = 0; i < numUpdates; ++i)
+    {
+        tracksState->addTime(1 / 60.0f);
+        tracks->setAnimationState(tracksStates);
+    }
+    const unsigned long tracksTime = timer.getMicroseconds();
+    timer.reset();
+    for (size_t i = 0; i < numUpdates; ++i)
+    {
+        bakedState->addTime(1 / 60.0f);
+        baked->setAnimationState(bakedStates);
+    }
+    const unsigned long bakedTime = timer.getMicroseconds();
+    LogManager::getSingleton().stream() << "BakedNodeAnimationTests: " << numUpdates
+        << " updates of " << NUM_BONES << " bones, tracks " << tracksTime
+        << " us, baked " << bakedTime << " us";
+}
+//--------------------------------------------------------------------------
+void BakedNodeAnimationTests::testKeyFrameChanges()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    SkeletonPtr tracks = createSkeleton(false);
+    SkeletonPtr baked = createSkeleton(true);
+    AnimationStateSet tracksStates, bakedStates;
+    tracks->_initAnimationState(&tracksStates);
+    baked->_initAnimationState(&bakedStates);
+    tracksStates.getAnimationState("Walk")->setEnabled(true);
+    bakedStates.getAnimationState("Walk")->setEnabled(true);
+    tracksStates.getAnimationState("Walk")->setTimePosition(2.5f);
+    bakedStates.getAnimationState("Walk")->setTimePosition(2.5f);
+    tracks->setAnimationState(tracksStates);
+    baked->setAnimationState(bakedStates);
+    assertSameBones(tracks, baked);
+
+    // Edit, add and remove keyframes after the first evaluation
+    Skeleton* skeletons[2] = { tracks.get(), baked.get() };
+    for (size_t s = 0; s < 2; ++s)
+    {
+        Animation* anim = skeletons[s]->getAnimation("Walk");
+        anim->getNodeTrack(1)->getNodeKeyFrame(0)->setTranslate(Vector3(1, 2, 3));
+        anim->getNodeTrack(2)->createNodeKeyFrame(2.4f)->setScale(Vector3(2, 2, 2));
+        anim->getNodeTrack(4)->removeKeyFrame(0);
+        anim->destroyNodeTrack(5);
+    }
+    tracks->setAnimationState(tracksStates);
+    baked->setAnimationState(bakedStates);
+    assertSameBones(tracks, baked);
+
+    // Spline interpolation is not baked but must still work
+    tracks->getAnimation("Walk")->setInterpolationMode(Animation::IM_SPLINE);
+    baked->getAnimation("Walk")->setInterpolationMode(Animation::IM_SPLINE);
+    tracks->setAnimationState(tracksStates);
+    baked->setAnimationState(bakedStates);
+    assertSameBones(tracks, baked);
+}
+//--------------------------------------------------------------------------
+void BakedNodeAnimationTests::testCompressedTracks()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    SkeletonPtr original = createSampledSkeleton("Original");
+    SkeletonPtr compressed = createSampledSkeleton("Compressed");
+    Animation* anim = compressed->getAnimation("Walk");
+    size_t numKeyFrames = 0;
+    for (unsigned short b = 0; b < NUM_BONES; ++b)
+        numKeyFrames += anim->getNodeTrack(b)->getNumKeyFrames();
+    anim->compressNodeTracks(0.001f, Radian(0.001f), 0.001f);
+    CPPUNIT_ASSERT(anim->hasCompressedNodeTracks());
+    CPPUNIT_ASSERT_EQUAL((unsigned short)0, anim->getNodeTrack(0)->getNumKeyFrames());
+
+    // Memory of the keyframes, each allocated on its own and pointed to by its track
+    const size_t originalSize = numKeyFrames * (sizeof(TransformKeyFrame) + sizeof(KeyFrame*));
+    const size_t compressedSize = anim->_getCompressedNodeTracks()->calculateSize();
+    CPPUNIT_ASSERT(originalSize >= compressedSize * 4);
+
+    AnimationStateSet originalStates, compressedStates;
+    original->_initAnimationState(&originalStates);
+    compressed->_initAnimationState(&compressedStates);
+    AnimationState* originalState = originalStates.getAnimationState("Walk");
+    AnimationState* compressedState = compressedStates.getAnimationState("Walk");
+    originalState->setEnabled(true);
+    compressedState->setEnabled(true);
+
+    // The error stays close to the tolerances; quantisation and normalised
+    // interpolation between the keyframes add a little to rotations
+    for (size_t step = 0; step < 400; ++step)
+    {
+        originalState->addTime(1 / 45.0f);
+        compressedState->addTime(1 / 45.0f);
+        original->setAnimationState(originalStates);
+        compressed->setAnimationState(compressedStates);
+        for (unsigned short b = 0; b < NUM_BONES; ++b)
+        {
+            const Bone* e = original->getBone(b);
+            const Bone* a = compressed->getBone(b);
+            CPPUNIT_ASSERT(e->getPosition().distance(a->getPosition()) < 0.002f);
+            // Angle from the distance between the quaternions, precise when small
+            const Quaternion& q = e->getOrientation();
+            const Quaternion& r = a->getOrientation();
+            const Real chord = Math::Sqrt(q.Dot(r) < 0 ? (q + r).Norm() : (q - r).Norm());
+            CPPUNIT_ASSERT(4 * Math::ASin(chord * 0.5f).valueRadians() < 0.003f);
+            CPPUNIT_ASSERT(e->getScale().distance(a->getScale()) < 0.002f);
+        }
+    }
+
+    // Clones and decompressed tracks evaluate the same keyframes
+    Animation* clone = anim->clone("Clone");
+    anim->decompressNodeTracks();
+    CPPUNIT_ASSERT(!anim->hasCompressedNodeTracks());
+    CPPUNIT_ASSERT(clone->hasCompressedNodeTracks());
+    for (size_t step = 0; step < 50; ++step)
+    {
+        const Real time = Math::RangeRandom(0, ANIMATION_LENGTH);
+        compressed->reset();
+        anim->apply(compressed.get(), time);
+        Vector3 positions[NUM_BONES];
+        Quaternion orientations[NUM_BONES];
+        for (unsigned short b = 0; b < NUM_BONES; ++b)
+        {
+            positions[b] = compressed->getBone(b)->getPosition();
+            orientations[b] = compressed->getBone(b)->getOrientation();
+        }
+        compressed->reset();
+        clone->apply(compressed.get(), time);
+        for (unsigned short b = 0; b < NUM_BONES; ++b)
+        {
+            CPPUNIT_ASSERT(positions[b] == compressed->getBone(b)->getPosition());
+            CPPUNIT_ASSERT(orientations[b] == compressed->getBone(b)->getOrientation());
+        }
+    }
+    OGRE_DELETE clone;
+
+    // Timings of forward playback
+    anim->compressNodeTracks(0.001f, Radian(0.001f), 0.001f);
+    const size_t numUpdates = 2000;
+    Timer timer;
+    for (size_t i = 0; i < numUpdates; ++i)
+    {
+        originalState->addTime(1 / 60.0f);
+        original->setAnimationState(originalStates);
+    }
+    const unsigned long originalTime = timer.getMicroseconds();
+    timer.reset();
+    for (size_t i = 0; i < numUpdates; ++i)
+    {
+        compressedState->addTime(1 / 60.0f);
+        compressed->setAnimationState(compressedStates);
+    }
+    const unsigned long compressedTime = timer.getMicroseconds();
+    LogManager::getSingleton().stream() << "BakedNodeAnimationTests: " << numKeyFrames
+        << " keyframes, " << originalSize << " bytes, compressed to "
+        << anim->_getCompressedNodeTracks()->getNumKeyFrames() << " keyframes, "
+        << compressedSize << " bytes; " << numUpdates << " updates, tracks "
+        << originalTime << " us, compressed " << compressedTime << " us";
+}
+//--------------------------------------------------------------------------
+void BakedNodeAnimationTests::testCompressedSerializer()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    SkeletonPtr compressed = createSampledSkeleton("Compressed");
+    compressed->getAnimation("Walk")->compressNodeTracks();
+
+    const SkeletonVersion versions[2] = { SKELETON_VERSION_LATEST, SKELETON_VERSION_1_8 };
+    for (size_t v = 0; v < 2; ++v)
+    {
+        // Bones are written in their current pose
+        compressed->reset();
+        SkeletonSerializer serializer;
+        MemoryDataStream* memory = OGRE_NEW MemoryDataStream(1 << 20);
+        DataStreamPtr output(memory);
+        serializer.exportSkeleton(compressed.get(), output, versions[v]);
+        DataStreamPtr input(OGRE_NEW MemoryDataStream(memory->getPtr(), output->tell(), false));
+
+        SkeletonPtr loaded = SkeletonManager::getSingleton().create("Loaded" + StringConverter::toString(v),
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+        loaded->load();
+        serializer.importSkeleton(input, loaded.get());
+
+        // Only the latest version keeps the tracks compressed, both evaluate the same
+        CPPUNIT_ASSERT_EQUAL(v == 0, loaded->getAnimation("Walk")->hasCompressedNodeTracks());
+        for (size_t step = 0; step < 50; ++step)
+        {
+            const Real time = Math::RangeRandom(0, ANIMATION_LENGTH);
+            compressed->reset();
+            loaded->reset();
+            compressed->getAnimation("Walk")->apply(compressed.get(), time);
+            loaded->getAnimation("Walk")->apply(loaded.get(), time);
+            assertSameBones(compressed, loaded);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void BakedNodeAnimationTests::testCompressedEdits()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Rebasing compressed keyframes matches rebasing the keyframes they decode
+    // to, without the error of quantising them a second time
+    SkeletonPtr compressed = createSampledSkeleton("Compressed");
+    SkeletonPtr reference = createSampledSkeleton("Reference");
+    Animation* anim = compressed->getAnimation("Walk");
+    Animation* referenceAnim = reference->getAnimation("Walk");
+    anim->compressNodeTracks();
+    referenceAnim->compressNodeTracks();
+    referenceAnim->decompressNodeTracks();
+    anim->setUseBaseKeyFrame(true, 2.5f);
+    referenceAnim->setUseBaseKeyFrame(true, 2.5f);
+    anim->_applyBaseKeyFrame();
+    referenceAnim->_applyBaseKeyFrame();
+    CPPUNIT_ASSERT(anim->hasCompressedNodeTracks());
+    for (size_t step = 0; step < 50; ++step)
+    {
+        const Real time = Math::RangeRandom(0, ANIMATION_LENGTH);
+        compressed->reset();
+        reference->reset();
+        anim->apply(compressed.get(), time);
+        referenceAnim->apply(reference.get(), time);
+        for (unsigned short b = 0; b < NUM_BONES; ++b)
+        {
+            const Bone* e = reference->getBone(b);
+            const Bone* a = compressed->getBone(b);
+            CPPUNIT_ASSERT(e->getPosition().distance(a->getPosition()) < 1e-5f);
+            const Quaternion& q = e->getOrientation();
+            const Quaternion& r = a->getOrientation();
+            CPPUNIT_ASSERT(Math::Sqrt(q.Dot(r) < 0 ? (q + r).Norm() : (q - r).Norm()) < 1e-5f);
+            CPPUNIT_ASSERT(e->getScale().distance(a->getScale()) < 1e-5f);
+        }
+    }
+
+    // The base rotations survive the serializer
+    compressed->reset();
+    SkeletonSerializer serializer;
+    MemoryDataStream* memory = OGRE_NEW MemoryDataStream(1 << 20);
+    DataStreamPtr output(memory);
+    serializer.exportSkeleton(compressed.get(), output);
+    DataStreamPtr input(OGRE_NEW MemoryDataStream(memory->getPtr(), output->tell(), false));
+    SkeletonPtr loaded = SkeletonManager::getSingleton().create("Loaded",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+    loaded->load();
+    serializer.importSkeleton(input, loaded.get());
+    CPPUNIT_ASSERT(loaded->getAnimation("Walk")->hasCompressedNodeTracks());
+    for (size_t step = 0; step < 20; ++step)
+    {
+        const Real time = Math::RangeRandom(0, ANIMATION_LENGTH);
+        compressed->reset();
+        loaded->reset();
+        anim->apply(compressed.get(), time);
+        loaded->getAnimation("Walk")->apply(loaded.get(), time);
+        assertSameBones(compressed, loaded);
+    }
+
+    // New keyframes and tracks are added to the decompressed tracks
+    const BakedNodeAnimation* baked = anim->_getCompressedNodeTracks();
+    const unsigned short numKeyFrames = baked->getNumKeyFrames(baked->findTrack(0));
+    anim->getNodeTrack(0)->createNodeKeyFrame(ANIMATION_LENGTH);
+    CPPUNIT_ASSERT(!anim->hasCompressedNodeTracks());
+    CPPUNIT_ASSERT_EQUAL((unsigned short)(numKeyFrames + 1), anim->getNodeTrack(0)->getNumKeyFrames());
+    anim->compressNodeTracks();
+    anim->createNodeTrack(NUM_BONES);
+    CPPUNIT_ASSERT(!anim->hasCompressedNodeTracks());
+    anim->destroyNodeTrack(NUM_BONES);
+
+    // Without compressed tracks the file keeps the version older runtimes read
+    compressed->reset();
+    output->seek(0);
+    serializer.exportSkeleton(compressed.get(), output);
+    output->seek(sizeof(uint16));
+    CPPUNIT_ASSERT_EQUAL(String("[Serializer_v1.80]"), output->getLine());
+}
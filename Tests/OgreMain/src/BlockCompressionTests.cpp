@@ -0,0 +1,278 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "BlockCompressionTests.h"
+#include "OgreRoot.h"
+#include "OgreImage.h"
+#include "OgreBlockCompression.h"
+#include "OgreDataStream.h"
+#include "Threading/OgreTaskScheduler.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(BlockCompressionTests);
+OGRE_BENCHMARK_SUITE_REGISTRATION(BlockCompressionBenchmarks);
+
+//--------------------------------------------------------------------------
+/// Fills an RGBA image with smooth gradients and a little noise
+static void fillGradients(Image& image)
+{
+    uint32 seed = 5;
+    for (size_t y = 0; y < image.getHeight(); ++y)
+    {
+        uchar* row = image.getData() + y * image.getWidth() * 4;
+        for (size_t x = 0; x < image.getWidth(); ++x)
+        {
+            seed = seed * 1664525 + 1013904223;
+            const int noise = int(seed >> 29) - 4;
+            row[x * 4 + 0] = static_cast<uchar>(std::min(255, std::max(0, int(x * 255 / image.getWidth()) + noise)));
+            row[x * 4 + 1] = static_cast<uchar>(std::min(255, std::max(0, int(y * 255 / image.getHeight()) - noise)));
+            row[x * 4 + 2] = static_cast<uchar>((x + y) * 255 / (image.getWidth() + image.getHeight()));
+            row[x * 4 + 3] = static_cast<uchar>(255 - y * 255 / image.getHeight());
+        }
+    }
+}
+//--------------------------------------------------------------------------
+/// Loads a new RGBA image of the given size, sharing no buffer
+static void createImage(Image& image, uint32 width, uint32 height)
+{
+    size_t size = Image::calculateSize(0, 1, width, height, 1, PF_BYTE_RGBA);
+    uchar* data = OGRE_ALLOC_T(uchar, size, MEMCATEGORY_GENERAL);
+    image.loadDynamicImage(data, width, height, 1, PF_BYTE_RGBA, true);
+}
+//--------------------------------------------------------------------------
+/// Compresses then decompresses src into dst, both RGBA images of the same size
+static void roundTrip(const Image& src, Image& dst, PixelFormat format)
+{
+    const size_t width = src.getWidth(), height = src.getHeight();
+    vector<uchar>::type blocks(PixelUtil::getMemorySize(width, height, 1, format));
+    PixelBox compressed(width, height, 1, format, &blocks[0]);
+    PixelUtil::bulkPixelConversion(src.getPixelBox(), compressed);
+    PixelUtil::bulkPixelConversion(compressed, dst.getPixelBox());
+}
+//--------------------------------------------------------------------------
+/// Root mean square error of a channel between two RGBA images
+static float channelError(const Image& a, const Image& b, size_t channel)
+{
+    double sum = 0;
+    for (size_t i = 0; i < a.getWidth() * a.getHeight(); ++i)
+    {
+        int delta = int(a.getData()[i * 4 + channel]) - int(b.getData()[i * 4 + channel]);
+        sum += delta * delta;
+    }
+    return static_cast<float>(sqrt(sum / (a.getWidth() * a.getHeight())));
+}
+//--------------------------------------------------------------------------
+void BlockCompressionTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+}
+//--------------------------------------------------------------------------
+void BlockCompressionTests::tearDown()
+{
+    OGRE_DELETE mRoot;
+}
+//--------------------------------------------------------------------------
+void BlockCompressionTests::testRoundTrip()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Sizes which aren't multiples of the blocks, bounds per format
+    Image src, dst;
+    createImage(src, 67, 45);
+    createImage(dst, 67, 45);
+    fillGradients(src);
+
+    const PixelFormat formats[] = { PF_DXT1, PF_DXT5, PF_BC4_UNORM, PF_BC5_UNORM, PF_ETC1_RGB8 };
+    const size_t numChannels[] = { 3, 4, 1, 2, 3 };
+    const float maxErrors[] = { 6, 6, 2, 2, 8 };
+    for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f)
+    {
+        // DXT1 would make the translucent half transparent
+        for (size_t i = 0; formats[f] == PF_DXT1 && i < 67 * 45; ++i)
+            src.getData()[i * 4 + 3] = 255;
+
+        CPPUNIT_ASSERT(BlockCompression::canCompress(formats[f]));
+        roundTrip(src, dst, formats[f]);
+        for (size_t k = 0; k < numChannels[f]; ++k)
+            CPPUNIT_ASSERT(channelError(src, dst, k) < maxErrors[f]);
+    }
+    CPPUNIT_ASSERT(!BlockCompression::canCompress(PF_BC7_UNORM));
+}
+//--------------------------------------------------------------------------
+void BlockCompressionTests::testSolidBlocks()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Colours representable in 565 come back exactly, others within a step
+    Image src, dst;
+    createImage(src, 8, 8);
+    createImage(dst, 8, 8);
+    const uchar colours[][4] = { { 255, 0, 255, 255 }, { 0, 0, 0, 255 }, { 123, 45, 210, 177 } };
+    for (size_t c = 0; c < 3; ++c)
+    {
+        for (size_t i = 0; i < 64; ++i)
+            memcpy(src.getData() + i * 4, colours[c], 4);
+
+        const PixelFormat formats[] = { PF_DXT1, PF_DXT5, PF_ETC1_RGB8 };
+        for (size_t f = 0; f < 3; ++f)
+        {
+            roundTrip(src, dst, formats[f]);
+            for (size_t i = 0; i < 64; ++i)
+            {
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    int delta = abs(int(dst.getData()[i * 4 + k]) - int(colours[c][k]));
+                    CPPUNIT_ASSERT(c < 2 && formats[f] != PF_ETC1_RGB8 ? delta == 0 : delta <= 6);
+                }
+            }
+        }
+
+        // Interpolated alpha is exact for a single value
+        roundTrip(src, dst, PF_DXT5);
+        for (size_t i = 0; i < 64; ++i)
+            CPPUNIT_ASSERT_EQUAL(colours[c][3], dst.getData()[i * 4 + 3]);
+    }
+}
+//--------------------------------------------------------------------------
+void BlockCompressionTests::testTransparency()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // DXT1 keeps 1 bit alpha, with a block entirely transparent
+    Image src, dst;
+    createImage(src, 12, 4);
+    createImage(dst, 12, 4);
+    fillGradients(src);
+    for (size_t i = 0; i < 48; ++i)
+    {
+        const size_t x = i % 12;
+        src.getData()[i * 4 + 3] = x >= 8 || (i * 7) % 3 == 0 ? 0 : 255;
+    }
+
+    roundTrip(src, dst, PF_DXT1);
+    for (size_t i = 0; i < 48; ++i)
+    {
+        const uchar alpha = src.getData()[i * 4 + 3];
+        CPPUNIT_ASSERT_EQUAL(alpha, dst.getData()[i * 4 + 3]);
+        if (alpha == 255)
+        {
+            for (size_t k = 0; k < 3; ++k)
+                CPPUNIT_ASSERT(abs(int(dst.getData()[i * 4 + k]) - int(src.getData()[i * 4 + k])) < 48);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void BlockCompressionTests::testImageCompress()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Image image;
+    createImage(image, 64, 64);
+    fillGradients(image);
+    image.generateMipmaps();
+    Image copy;
+    copy = image;
+
+    image.compress(PF_DXT5);
+    CPPUNIT_ASSERT_EQUAL(PF_DXT5, image.getFormat());
+    CPPUNIT_ASSERT(image.hasFlag(IF_COMPRESSED));
+    CPPUNIT_ASSERT_EQUAL(size_t(6), image.getNumMipmaps());
+    CPPUNIT_ASSERT_EQUAL(Image::calculateSize(6, 1, 64, 64, 1, PF_DXT5), image.getSize());
+
+    // Every level is compressed in place, down to 1x1
+    for (size_t mip = 0; mip <= image.getNumMipmaps(); ++mip)
+    {
+        PixelBox level = image.getPixelBox(0, mip);
+        PixelBox original = copy.getPixelBox(0, mip);
+        vector<uchar>::type blocks(level.getConsecutiveSize());
+        BlockCompression::compress(original,
+            PixelBox(level.getWidth(), level.getHeight(), 1, PF_DXT5, &blocks[0]));
+        CPPUNIT_ASSERT(memcmp(level.data, &blocks[0], blocks.size()) == 0);
+    }
+
+    // Saved as DDS, the blocks load back as they were; without a render
+    // system the codec decodes them itself, which agrees with the decoder here
+    const String fileName = "BlockCompressionTests.dds";
+    image.save(fileName);
+    std::ifstream* file = OGRE_NEW_T(std::ifstream, MEMCATEGORY_GENERAL)(fileName.c_str(), std::ios::binary);
+    DataStreamPtr stream(OGRE_NEW FileStreamDataStream(file));
+    Image loaded;
+    loaded.load(stream, "dds");
+    CPPUNIT_ASSERT_EQUAL(image.getNumMipmaps(), loaded.getNumMipmaps());
+    for (size_t mip = 0; mip <= image.getNumMipmaps(); ++mip)
+    {
+        PixelBox level = image.getPixelBox(0, mip);
+        PixelBox loadedLevel = loaded.getPixelBox(0, mip);
+        vector<uchar>::type expected(level.getWidth() * level.getHeight() * 4);
+        vector<uchar>::type actual(expected.size());
+        PixelUtil::bulkPixelConversion(level,
+            PixelBox(level.getWidth(), level.getHeight(), 1, PF_BYTE_RGBA, &expected[0]));
+        PixelUtil::bulkPixelConversion(loadedLevel,
+            PixelBox(level.getWidth(), level.getHeight(), 1, PF_BYTE_RGBA, &actual[0]));
+        for (size_t i = 0; i < expected.size(); ++i)
+            CPPUNIT_ASSERT(abs(int(expected[i]) - int(actual[i])) <= 1);
+    }
+    stream->close();
+    remove(fileName.c_str());
+}
+//--------------------------------------------------------------------------
+void BlockCompressionTests::testCompressionTiming()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Image source;
+    createImage(source, 1024, 1024);
+    fillGradients(source);
+
+    const PixelFormat formats[] = { PF_DXT1, PF_DXT5, PF_BC5_UNORM, PF_ETC1_RGB8 };
+    for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f)
+    {
+        Image serial, parallel;
+        serial = source;
+        parallel = source;
+
+        BenchmarkLog log("BlockCompressionTests", PixelUtil::getFormatName(formats[f]) + " of 1024x1024");
+        serial.compress(formats[f]);
+        log.time("1 thread");
+
+        TaskScheduler scheduler;
+        scheduler.startup(3);
+        log.restart();
+        parallel.compress(formats[f], &scheduler);
+        log.time("4 threads");
+
+        // Blocks are independent, the threads don't change them
+        CPPUNIT_ASSERT_EQUAL(serial.getSize(), parallel.getSize());
+        CPPUNIT_ASSERT(memcmp(serial.getData(), parallel.getData(), serial.getSize()) == 0);
+    }
+}
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreFileSystem.h"
 #include "OgreException.h"
 #include "OgreCommon.h"
+#include "OgreScriptLexer.h"
 
 #include "UnitTestSuite.h"
 
@@ -328,6 +329,54 @@ void FileSystemArchiveTests::testReadInterleave()
     CPPUNIT_ASSERT(stream2->eof());
 }
 //--------------------------------------------------------------------------
+void FileSystemArchiveTests::testMappedFileRead()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    FileSystemArchive arch(mTestPath, "FileSystem", true);
+    arch.load();
+
+    // Streamed
+    FileSystemArchive::setUseMappedFiles(false);
+    DataStreamPtr streamed = arch.open("rootfile2.txt");
+    CPPUNIT_ASSERT(!dynamic_cast<MemoryDataStream*>(streamed.get()));
+    const String contents = streamed->getAsString();
+
+    // Mapped, with the contents available in place
+    FileSystemArchive::setUseMappedFiles(true);
+    DataStreamPtr mapped = arch.open("rootfile2.txt");
+    MemoryDataStream* memStream = dynamic_cast<MemoryDataStream*>(mapped.get());
+    CPPUNIT_ASSERT(memStream);
+    CPPUNIT_ASSERT_EQUAL(contents.size(), mapped->size());
+    CPPUNIT_ASSERT(memcmp(contents.data(), memStream->getPtr(), contents.size()) == 0);
+    CPPUNIT_ASSERT(!mapped->isWriteable());
+
+    CPPUNIT_ASSERT_EQUAL(String("this is line 1 in file 2"), mapped->getLine());
+    mapped->skipLine();
+    CPPUNIT_ASSERT_EQUAL(String("this is line 3 in file 2"), mapped->getLine());
+    mapped->seek(0);
+    CPPUNIT_ASSERT_EQUAL(contents, mapped->getAsString());
+    CPPUNIT_ASSERT(mapped->eof());
+
+    // Both are tokenized from the current position, in place when mapped
+    ScriptLexer lexer;
+    ScriptTokenListPtr rest = lexer.tokenize(contents.substr(contents.find('\n') + 1), "rootfile2.txt");
+    DataStreamPtr streams[2] = { streamed, mapped };
+    for (size_t s = 0; s < 2; ++s)
+    {
+        streams[s]->seek(0);
+        streams[s]->skipLine();
+        ScriptTokenListPtr tokens = lexer.tokenize(streams[s], "rootfile2.txt");
+        CPPUNIT_ASSERT(streams[s]->eof());
+        CPPUNIT_ASSERT_EQUAL(rest->size(), tokens->size());
+        for (size_t i = 0; i < rest->size(); ++i)
+            CPPUNIT_ASSERT_EQUAL((*rest)[i]->lexeme, (*tokens)[i]->lexeme);
+    }
+
+    mapped->close();
+    CPPUNIT_ASSERT(!memStream->getPtr());
+}
+//--------------------------------------------------------------------------
 void FileSystemArchiveTests::testCreateAndRemoveFile()
 {
     UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
@@ -0,0 +1,391 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "GpuProgramParametersTests.h"
+#include "OgreRoot.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreSceneManagerEnumerator.h"
+#include "OgreAutoParamDataSource.h"
+#include "OgreGpuProgramParams.h"
+#include "OgreRenderable.h"
+#include "OgreCamera.h"
+#include "OgreLight.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreMath.h"
+#include "OgreStringConverter.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(GpuProgramParametersTests);
+OGRE_BENCHMARK_SUITE_REGISTRATION(GpuProgramParametersBenchmarks);
+
+//--------------------------------------------------------------------------
+/// A renderable with a single world transform
+class ParamsTestRenderable : public Renderable
+{
+public:
+    Matrix4 transform;
+    MaterialPtr material;
+    LightList lights;
+
+    const MaterialPtr& getMaterial(void) const { return material; }
+    void getRenderOperation(RenderOperation& op) {}
+    void getWorldTransforms(Matrix4* xform) const { *xform = transform; }
+    Real getSquaredViewDepth(const Camera* cam) const { return 0; }
+    const LightList& getLights(void) const { return lights; }
+};
+//--------------------------------------------------------------------------
+static Matrix4 randomTransform(void)
+{
+    Quaternion orientation(Math::SymmetricRandom(), Math::SymmetricRandom(),
+        Math::SymmetricRandom(), Math::SymmetricRandom());
+    orientation.normalise();
+    Matrix4 m;
+    m.makeTransform(Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(), Math::SymmetricRandom()) * 100,
+        Vector3(Math::RangeRandom(0.5, 2), Math::RangeRandom(0.5, 2), Math::RangeRandom(0.5, 2)),
+        orientation);
+    return m;
+}
+//--------------------------------------------------------------------------
+/// Autos of every variability, the matrices derived in several ways
+static const GpuProgramParameters::AutoConstantType TEST_AUTOS[] =
+{
+    GpuProgramParameters::ACT_WORLDVIEWPROJ_MATRIX,
+    GpuProgramParameters::ACT_INVERSE_VIEWPROJ_MATRIX,
+    GpuProgramParameters::ACT_TRANSPOSE_WORLD_MATRIX,
+    GpuProgramParameters::ACT_INVERSE_TRANSPOSE_PROJECTION_MATRIX,
+    GpuProgramParameters::ACT_VIEW_MATRIX,
+    GpuProgramParameters::ACT_INVERSE_TRANSPOSE_WORLDVIEWPROJ_MATRIX,
+    GpuProgramParameters::ACT_CAMERA_POSITION,
+    GpuProgramParameters::ACT_CAMERA_POSITION_OBJECT_SPACE,
+    GpuProgramParameters::ACT_AMBIENT_LIGHT_COLOUR,
+    GpuProgramParameters::ACT_FOG_COLOUR,
+    GpuProgramParameters::ACT_SURFACE_DIFFUSE_COLOUR,
+    GpuProgramParameters::ACT_PASS_NUMBER,
+    GpuProgramParameters::ACT_LIGHT_DIFFUSE_COLOUR,
+    GpuProgramParameters::ACT_LIGHT_POSITION_OBJECT_SPACE
+};
+static const size_t NUM_TEST_AUTOS = sizeof(TEST_AUTOS) / sizeof(TEST_AUTOS[0]);
+//--------------------------------------------------------------------------
+static GpuProgramParametersSharedPtr createTestParams(void)
+{
+    GpuProgramParametersSharedPtr params(OGRE_NEW GpuProgramParameters());
+    params->_setLogicalIndexes(GpuLogicalBufferStructPtr(OGRE_NEW GpuLogicalBufferStruct()),
+        GpuLogicalBufferStructPtr(), GpuLogicalBufferStructPtr(),
+        GpuLogicalBufferStructPtr(), GpuLogicalBufferStructPtr());
+    // Matrices take 4 logical indexes
+    for (size_t i = 0; i < NUM_TEST_AUTOS; ++i)
+        params->setAutoConstant(i * 4, TEST_AUTOS[i]);
+    return params;
+}
+//--------------------------------------------------------------------------
+/// Checks that the autos have the values they would get if all were updated
+static void checkMatchesFullUpdate(const GpuProgramParameters& params, const AutoParamDataSource& source)
+{
+    // Copies start with everything out of date
+    GpuProgramParameters full(params);
+    full._updateAutoParams(&source, GPV_ALL);
+    CPPUNIT_ASSERT(params.getFloatConstantList() == full.getFloatConstantList());
+}
+//--------------------------------------------------------------------------
+static void checkDerivedMatrices(const AutoParamDataSource& source)
+{
+    CPPUNIT_ASSERT(source.getTransposeWorldMatrix() == source.getWorldMatrix().transpose());
+    CPPUNIT_ASSERT(source.getTransposeViewMatrix() == source.getViewMatrix().transpose());
+    CPPUNIT_ASSERT(source.getInverseTransposeViewMatrix() == source.getInverseViewMatrix().transpose());
+    CPPUNIT_ASSERT(source.getTransposeProjectionMatrix() == source.getProjectionMatrix().transpose());
+    CPPUNIT_ASSERT(source.getInverseProjectionMatrix() == source.getProjectionMatrix().inverse());
+    CPPUNIT_ASSERT(source.getInverseTransposeProjectionMatrix() ==
+        source.getProjectionMatrix().inverse().transpose());
+    CPPUNIT_ASSERT(source.getTransposeViewProjMatrix() == source.getViewProjectionMatrix().transpose());
+    CPPUNIT_ASSERT(source.getInverseViewProjMatrix() == source.getViewProjectionMatrix().inverse());
+    CPPUNIT_ASSERT(source.getInverseTransposeViewProjMatrix() ==
+        source.getViewProjectionMatrix().inverse().transpose());
+    CPPUNIT_ASSERT(source.getTransposeWorldViewMatrix() == source.getWorldViewMatrix().transpose());
+    CPPUNIT_ASSERT(source.getTransposeWorldViewProjMatrix() == source.getWorldViewProjMatrix().transpose());
+    CPPUNIT_ASSERT(source.getInverseWorldViewProjMatrix() == source.getWorldViewProjMatrix().inverse());
+    CPPUNIT_ASSERT(source.getInverseTransposeWorldViewProjMatrix() ==
+        source.getWorldViewProjMatrix().inverse().transpose());
+}
+//--------------------------------------------------------------------------
+void GpuProgramParametersTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    // Cameras need a buffer manager
+    mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+    mSceneMgr = OGRE_NEW DefaultSceneManager("GpuProgramParametersTests");
+    mCamera = mSceneMgr->createCamera("GpuProgramParametersTests");
+    mCamera->setPosition(10, 20, 30);
+    mCamera->lookAt(Vector3::ZERO);
+}
+//--------------------------------------------------------------------------
+void GpuProgramParametersTests::tearDown()
+{
+    OGRE_DELETE mSceneMgr;
+    OGRE_DELETE mRoot;
+    OGRE_DELETE mBufMgr;
+}
+//--------------------------------------------------------------------------
+void GpuProgramParametersTests::testDerivedMatrixCache()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    srand(0);
+    AutoParamDataSource source;
+    ParamsTestRenderable rend, other, identityView;
+    rend.transform = randomTransform();
+    other.transform = randomTransform();
+    identityView.transform = randomTransform();
+    identityView.setUseIdentityView(true);
+
+    source.setCurrentCamera(mCamera, false);
+    source.setCurrentRenderable(&rend);
+    checkDerivedMatrices(source);
+
+    // Only the world changes
+    source.setCurrentRenderable(&other);
+    checkDerivedMatrices(source);
+
+    // The view changes with the renderable, and back
+    source.setCurrentRenderable(&identityView);
+    checkDerivedMatrices(source);
+    CPPUNIT_ASSERT(source.getTransposeViewMatrix() == Matrix4::IDENTITY);
+    source.setCurrentRenderable(&rend);
+    checkDerivedMatrices(source);
+    CPPUNIT_ASSERT(source.getViewMatrix() == mCamera->getViewMatrix(true));
+
+    // A new camera position
+    mCamera->setPosition(-40, 5, 12);
+    mCamera->lookAt(Vector3(1, 2, 3));
+    source.setCurrentCamera(mCamera, false);
+    checkDerivedMatrices(source);
+    CPPUNIT_ASSERT(source.getViewMatrix() == mCamera->getViewMatrix(true));
+
+    // Matrices given directly
+    Matrix4 world = randomTransform();
+    source.setWorldMatrices(&world, 1);
+    checkDerivedMatrices(source);
+    CPPUNIT_ASSERT(source.getTransposeWorldMatrix() == world.transpose());
+}
+//--------------------------------------------------------------------------
+void GpuProgramParametersTests::testUpdateMatchesFullUpdate()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    srand(1);
+    MaterialPtr mat = MaterialManager::getSingleton().create("GpuProgramParametersTests",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    Pass* passes[2] = { mat->createTechnique()->createPass(), mat->getTechnique(0)->createPass() };
+    passes[0]->setDiffuse(ColourValue::Red);
+    passes[1]->setDiffuse(ColourValue::Blue);
+    LightList lights[2];
+    for (size_t l = 0; l < 2; ++l)
+    {
+        Light* light = mSceneMgr->createLight();
+        light->setPosition(Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(), Math::SymmetricRandom()) * 50);
+        light->setDiffuseColour(Math::UnitRandom(), Math::UnitRandom(), Math::UnitRandom());
+        lights[l].push_back(light);
+    }
+    const size_t numRenderables = 8;
+    ParamsTestRenderable rends[numRenderables];
+    for (size_t r = 0; r < numRenderables; ++r)
+    {
+        rends[r].transform = randomTransform();
+        rends[r].setUseIdentityView(r == 0);
+    }
+
+    AutoParamDataSource source;
+    source.setCurrentSceneManager(mSceneMgr);
+    source.setCurrentCamera(mCamera, false);
+    source.setCurrentRenderable(&rends[1]);
+    source.setCurrentPass(passes[0]);
+    source.setCurrentLightList(&lights[0]);
+    GpuProgramParametersSharedPtr params = createTestParams();
+    params->_updateAutoParams(&source, GPV_ALL);
+    checkMatchesFullUpdate(*params, source);
+
+    for (size_t step = 0; step < 2000; ++step)
+    {
+        switch (rand() % 8)
+        {
+        case 0:
+            mCamera->setPosition(Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(), Math::SymmetricRandom()) * 100);
+            source.setCurrentCamera(mCamera, false);
+            break;
+        case 1:
+            source.setAmbientLightColour(rand() % 2 ? ColourValue::White : ColourValue(0.2f, 0.2f, 0.2f));
+            break;
+        case 2:
+            source.setFog(FOG_LINEAR, rand() % 2 ? ColourValue::Green : ColourValue::Black, 0.001f, 10, 100);
+            break;
+        case 3:
+            {
+                size_t p = rand() % 2;
+                source.setCurrentPass(passes[p]);
+                source.setPassNumber(static_cast<int>(p));
+            }
+            break;
+        case 4:
+            source.setCurrentLightList(&lights[rand() % 2]);
+            break;
+        case 5:
+            // Nothing changed
+            break;
+        default:
+            source.setCurrentRenderable(&rends[rand() % numRenderables]);
+            break;
+        }
+
+        // Sometimes only part of the autos are asked for, then they are out of
+        // date until the next full update
+        if (rand() % 3 == 0)
+        {
+            params->_updateAutoParams(&source, GPV_PER_OBJECT);
+        }
+        else
+        {
+            params->_updateAutoParams(&source, GPV_ALL);
+            checkMatchesFullUpdate(*params, source);
+        }
+    }
+
+    // Another data source never looks up to date
+    AutoParamDataSource otherSource;
+    otherSource.setCurrentSceneManager(mSceneMgr);
+    otherSource.setCurrentCamera(mCamera, false);
+    otherSource.setCurrentRenderable(&rends[2]);
+    otherSource.setCurrentPass(passes[1]);
+    otherSource.setCurrentLightList(&lights[1]);
+    otherSource.setAmbientLightColour(ColourValue(0.5f, 0.1f, 0.9f));
+    params->_updateAutoParams(&otherSource, GPV_ALL);
+    checkMatchesFullUpdate(*params, otherSource);
+
+    MaterialManager::getSingleton().remove(mat->getHandle());
+}
+//--------------------------------------------------------------------------
+void GpuProgramParametersTests::testSkipUnchangedAutos()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    srand(2);
+    LightList lights;
+    lights.push_back(mSceneMgr->createLight());
+    ParamsTestRenderable rend, other;
+    rend.transform = randomTransform();
+    other.transform = randomTransform();
+
+    AutoParamDataSource source;
+    source.setCurrentSceneManager(mSceneMgr);
+    source.setCurrentCamera(mCamera, false);
+    source.setCurrentRenderable(&rend);
+    source.setCurrentLightList(&lights);
+    GpuProgramParametersSharedPtr params = createTestParams();
+    // Only autos which don't need a pass
+    params->clearAutoConstant(10 * 4);
+    params->_updateAutoParams(&source, GPV_ALL);
+
+    // Overwrite a global and a per object auto
+    const GpuProgramParameters::AutoConstantList& autos = params->getAutoConstantList();
+    float* global = params->getFloatPointer(autos[1].physicalIndex);
+    float* perObject = params->getFloatPointer(autos[0].physicalIndex);
+    const float globalValue = *global, perObjectValue = *perObject;
+    *global = *perObject = 12345;
+
+    // Nothing changed, so nothing is written again
+    params->_updateAutoParams(&source, GPV_ALL);
+    CPPUNIT_ASSERT_EQUAL(12345.0f, *global);
+    CPPUNIT_ASSERT_EQUAL(12345.0f, *perObject);
+
+    // Only the per object autos are written
+    source.setCurrentRenderable(&other);
+    params->_updateAutoParams(&source, GPV_ALL);
+    CPPUNIT_ASSERT_EQUAL(12345.0f, *global);
+    CPPUNIT_ASSERT(*perObject != 12345.0f);
+    source.setCurrentRenderable(&rend);
+    params->_updateAutoParams(&source, GPV_ALL);
+    CPPUNIT_ASSERT_EQUAL(perObjectValue, *perObject);
+
+    // Everything is written for a new camera
+    source.setCurrentCamera(mCamera, false);
+    params->_updateAutoParams(&source, GPV_ALL);
+    CPPUNIT_ASSERT_EQUAL(globalValue, *global);
+    checkMatchesFullUpdate(*params, source);
+
+    // Also after the autos themselves change
+    *global = 12345;
+    params->setAutoConstant(10 * 4, GpuProgramParameters::ACT_FOG_PARAMS);
+    params->_updateAutoParams(&source, GPV_ALL);
+    CPPUNIT_ASSERT_EQUAL(globalValue, *global);
+}
+//--------------------------------------------------------------------------
+void GpuProgramParametersTests::testUpdateTiming()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    srand(3);
+    LightList lights;
+    lights.push_back(mSceneMgr->createLight());
+    const size_t numRenderables = 64, numUpdates = 100000;
+    ParamsTestRenderable rends[numRenderables];
+    for (size_t r = 0; r < numRenderables; ++r)
+        rends[r].transform = randomTransform();
+
+    AutoParamDataSource source;
+    source.setCurrentSceneManager(mSceneMgr);
+    source.setCurrentCamera(mCamera, false);
+    source.setCurrentLightList(&lights);
+    GpuProgramParametersSharedPtr params = createTestParams();
+    params->clearAutoConstant(10 * 4);
+
+    BenchmarkLog log("GpuProgramParametersTests", StringConverter::toString(numUpdates) +
+        " updates of " + StringConverter::toString(params->getAutoConstantCount()) + " autos");
+
+    // As if every renderable needed all the autos again, and the camera changed
+    for (size_t i = 0; i < numUpdates; ++i)
+    {
+        source.setCurrentCamera(mCamera, false);
+        source.setCurrentRenderable(&rends[i % numRenderables]);
+        params->_updateAutoParams(&source, GPV_ALL);
+    }
+    log.time("rewriting all");
+
+    // Only the world matrices change
+    for (size_t i = 0; i < numUpdates; ++i)
+    {
+        source.setCurrentRenderable(&rends[i % numRenderables]);
+        params->_updateAutoParams(&source, GPV_ALL);
+    }
+    log.time("when only the renderable changes");
+    checkMatchesFullUpdate(*params, source);
+}
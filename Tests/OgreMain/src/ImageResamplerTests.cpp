@@ -0,0 +1,274 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ImageResamplerTests.h"
+#include "OgreRoot.h"
+#include "OgreImage.h"
+#include "Threading/OgreTaskScheduler.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(ImageResamplerTests);
+OGRE_BENCHMARK_SUITE_REGISTRATION(ImageResamplerBenchmarks);
+
+//--------------------------------------------------------------------------
+/// Fills an image with reproducible noise
+static void fillNoise(Image& image, uint32 seed)
+{
+    uchar* data = image.getData();
+    for (size_t i = 0; i < image.getSize(); ++i)
+    {
+        seed = seed * 1664525 + 1013904223;
+        data[i] = static_cast<uchar>(seed >> 24);
+    }
+}
+//--------------------------------------------------------------------------
+/// Loads a new image of the given size, sharing no buffer
+static void createImage(Image& image, uint32 width, uint32 height, PixelFormat format,
+    size_t numFaces = 1)
+{
+    size_t size = Image::calculateSize(0, numFaces, width, height, 1, format);
+    uchar* data = OGRE_ALLOC_T(uchar, size, MEMCATEGORY_GENERAL);
+    image.loadDynamicImage(data, width, height, 1, format, true, numFaces);
+}
+//--------------------------------------------------------------------------
+void ImageResamplerTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+}
+//--------------------------------------------------------------------------
+void ImageResamplerTests::tearDown()
+{
+    OGRE_DELETE mRoot;
+}
+//--------------------------------------------------------------------------
+void ImageResamplerTests::testBilinearBands()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    TaskScheduler scheduler;
+    scheduler.startup(3);
+
+    const PixelFormat formats[] = { PF_A8R8G8B8, PF_R8G8B8, PF_L8 };
+    for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f)
+    {
+        Image src;
+        createImage(src, 301, 211, formats[f]);
+        fillNoise(src, 7);
+
+        // Bands of rows on several threads match a single pass
+        Image serial, parallel;
+        createImage(serial, 517, 129, formats[f]);
+        createImage(parallel, 517, 129, formats[f]);
+        Image::scale(src.getPixelBox(), serial.getPixelBox(), Image::FILTER_BILINEAR);
+        Image::scale(src.getPixelBox(), parallel.getPixelBox(), Image::FILTER_BILINEAR, &scheduler);
+        CPPUNIT_ASSERT(memcmp(serial.getData(), parallel.getData(), serial.getSize()) == 0);
+
+        // The byte paths agree with the floating point one
+        Image reference;
+        createImage(reference, 517, 129, PF_FLOAT32_RGBA);
+        Image::scale(src.getPixelBox(), reference.getPixelBox(), Image::FILTER_BILINEAR, &scheduler);
+        for (size_t y = 0; y < serial.getHeight(); ++y)
+        {
+            for (size_t x = 0; x < serial.getWidth(); ++x)
+            {
+                ColourValue expected = reference.getColourAt(x, y, 0);
+                ColourValue actual = serial.getColourAt(x, y, 0);
+                for (size_t k = 0; k < 4; ++k)
+                    CPPUNIT_ASSERT(Math::Abs(expected[k] - actual[k]) <= 1.5f / 255);
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void ImageResamplerTests::testBoxMipmaps()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    TaskScheduler scheduler;
+    scheduler.startup(3);
+
+    // Cube maps filter every face, float formats go through the generic path
+    const PixelFormat formats[] = { PF_A8R8G8B8, PF_R8G8B8, PF_BYTE_LA, PF_FLOAT32_RGBA };
+    for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f)
+    {
+        const size_t numFaces = formats[f] == PF_A8R8G8B8 ? 6 : 1;
+        Image image;
+        createImage(image, 75, 40, formats[f], numFaces);
+        if (PixelUtil::isFloatingPoint(formats[f]))
+        {
+            for (size_t y = 0; y < image.getHeight(); ++y)
+                for (size_t x = 0; x < image.getWidth(); ++x)
+                    image.setColourAt(ColourValue(x / 75.0f, y / 40.0f, (x * y % 7) / 7.0f, 1), x, y, 0);
+        }
+        else
+            fillNoise(image, 11);
+
+        Image copy;
+        copy = image;
+        image.generateMipmaps(Image::FILTER_BOX, &scheduler);
+        CPPUNIT_ASSERT_EQUAL(size_t(6), image.getNumMipmaps());
+        CPPUNIT_ASSERT_EQUAL(Image::calculateSize(6, numFaces, 75, 40, 1, formats[f]), image.getSize());
+
+        const size_t pixelSize = PixelUtil::getNumElemBytes(formats[f]);
+        for (size_t face = 0; face < numFaces; ++face)
+        {
+            PixelBox top = image.getPixelBox(face, 0);
+            CPPUNIT_ASSERT(memcmp(top.data, copy.getPixelBox(face, 0).data, top.getConsecutiveSize()) == 0);
+
+            // Each level averages 2x2 blocks of the previous one
+            for (size_t mip = 1; mip <= image.getNumMipmaps(); ++mip)
+            {
+                PixelBox src = image.getPixelBox(face, mip - 1);
+                PixelBox dst = image.getPixelBox(face, mip);
+                CPPUNIT_ASSERT_EQUAL(std::max<size_t>(src.getWidth() / 2, 1), dst.getWidth());
+                CPPUNIT_ASSERT_EQUAL(std::max<size_t>(src.getHeight() / 2, 1), dst.getHeight());
+
+                for (size_t y = 0; y < dst.getHeight(); ++y)
+                {
+                    for (size_t x = 0; x < dst.getWidth(); ++x)
+                    {
+                        size_t x1 = src.getWidth() > 1 ? 2 * x : x, x2 = src.getWidth() > 1 ? 2 * x + 1 : x;
+                        size_t y1 = src.getHeight() > 1 ? 2 * y : y, y2 = src.getHeight() > 1 ? 2 * y + 1 : y;
+                        if (PixelUtil::isFloatingPoint(formats[f]))
+                        {
+                            ColourValue samples[4];
+                            PixelUtil::unpackColour(&samples[0], src.format, (uchar*)src.data + pixelSize * (y1 * src.rowPitch + x1));
+                            PixelUtil::unpackColour(&samples[1], src.format, (uchar*)src.data + pixelSize * (y1 * src.rowPitch + x2));
+                            PixelUtil::unpackColour(&samples[2], src.format, (uchar*)src.data + pixelSize * (y2 * src.rowPitch + x1));
+                            PixelUtil::unpackColour(&samples[3], src.format, (uchar*)src.data + pixelSize * (y2 * src.rowPitch + x2));
+                            ColourValue actual;
+                            PixelUtil::unpackColour(&actual, dst.format, (uchar*)dst.data + pixelSize * (y * dst.rowPitch + x));
+                            ColourValue expected = (samples[0] + samples[1] + samples[2] + samples[3]) * 0.25f;
+                            for (size_t k = 0; k < 4; ++k)
+                                CPPUNIT_ASSERT(Math::Abs(expected[k] - actual[k]) < 1e-5f);
+                        }
+                        else
+                        {
+                            const uchar* row1 = (uchar*)src.data + pixelSize * y1 * src.rowPitch;
+                            const uchar* row2 = (uchar*)src.data + pixelSize * y2 * src.rowPitch;
+                            const uchar* actual = (uchar*)dst.data + pixelSize * (y * dst.rowPitch + x);
+                            for (size_t k = 0; k < pixelSize; ++k)
+                            {
+                                unsigned int sum = row1[x1 * pixelSize + k] + row1[x2 * pixelSize + k] +
+                                    row2[x1 * pixelSize + k] + row2[x2 * pixelSize + k];
+                                CPPUNIT_ASSERT_EQUAL((sum + 2) >> 2, (unsigned int)actual[k]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void ImageResamplerTests::testKaiserMipmaps()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // The weights are normalised: flat colours stay flat, up to the edges
+    Image image;
+    createImage(image, 64, 48, PF_A8R8G8B8);
+    const ColourValue colour(0.2f, 0.6f, 0.8f, 1.0f);
+    for (size_t y = 0; y < image.getHeight(); ++y)
+        for (size_t x = 0; x < image.getWidth(); ++x)
+            image.setColourAt(colour, x, y, 0);
+
+    image.generateMipmaps(Image::FILTER_KAISER);
+    CPPUNIT_ASSERT_EQUAL(size_t(6), image.getNumMipmaps());
+    for (size_t mip = 1; mip <= image.getNumMipmaps(); ++mip)
+    {
+        PixelBox level = image.getPixelBox(0, mip);
+        for (size_t y = 0; y < level.getHeight(); ++y)
+        {
+            for (size_t x = 0; x < level.getWidth(); ++x)
+            {
+                ColourValue actual;
+                PixelUtil::unpackColour(&actual, level.format, (uchar*)level.data + 4 * (y * level.rowPitch + x));
+                for (size_t k = 0; k < 4; ++k)
+                    CPPUNIT_ASSERT(Math::Abs(colour[k] - actual[k]) <= 1.0f / 255);
+            }
+        }
+    }
+
+    // An edge stays sharper than with the box filter, overshooting at most
+    // to the saturated range
+    Image edge;
+    createImage(edge, 64, 64, PF_L8);
+    for (size_t y = 0; y < edge.getHeight(); ++y)
+        for (size_t x = 0; x < edge.getWidth(); ++x)
+            edge.getData()[y * 64 + x] = x < 31 ? 0 : 255;
+    edge.generateMipmaps(Image::FILTER_KAISER);
+    PixelBox level = edge.getPixelBox(0, 1);
+    const uchar* row = (uchar*)level.data + 10 * level.rowPitch;
+    CPPUNIT_ASSERT_EQUAL((uchar)0, row[0]);
+    CPPUNIT_ASSERT_EQUAL((uchar)255, row[31]);
+    CPPUNIT_ASSERT(row[14] < 64 && row[16] > 191);
+}
+//--------------------------------------------------------------------------
+void ImageResamplerTests::testMipmapTiming()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Image source;
+    createImage(source, 2048, 2048, PF_A8R8G8B8);
+    fillNoise(source, 3);
+
+    const Image::Filter filters[] = { Image::FILTER_BOX, Image::FILTER_KAISER };
+    const char* filterNames[] = { "box", "kaiser" };
+    for (size_t f = 0; f < 2; ++f)
+    {
+        Image serial, parallel;
+        serial = source;
+        parallel = source;
+
+        BenchmarkLog log("ImageResamplerTests", String(filterNames[f]) + " mipmaps of 2048x2048");
+        serial.generateMipmaps(filters[f]);
+        log.time("1 thread");
+
+        TaskScheduler scheduler;
+        scheduler.startup(3);
+        log.restart();
+        parallel.generateMipmaps(filters[f], &scheduler);
+        log.time("4 threads");
+
+        CPPUNIT_ASSERT_EQUAL(serial.getSize(), parallel.getSize());
+        CPPUNIT_ASSERT(memcmp(serial.getData(), parallel.getData(), serial.getSize()) == 0);
+    }
+
+    // Bilinear scaling of the same image
+    Image scaled;
+    createImage(scaled, 1536, 1536, PF_A8R8G8B8);
+    BenchmarkLog log("ImageResamplerTests", "bilinear 2048x2048 to 1536x1536");
+    Image::scale(source.getPixelBox(), scaled.getPixelBox(), Image::FILTER_BILINEAR);
+    log.time("1 thread");
+}
@@ -0,0 +1,182 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "LightIndexTests.h"
+#include "OgreRoot.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreSceneManagerEnumerator.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreLight.h"
+#include "OgreMath.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+#include "OgreStringConverter.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(LightIndexTests);
+
+//--------------------------------------------------------------------------
+static const size_t NUM_QUERIES = 2000;
+//--------------------------------------------------------------------------
+/// Gives access to the lights affecting frustum update
+class LightTestSceneManager : public DefaultSceneManager
+{
+public:
+    LightTestSceneManager(const String& name) : DefaultSceneManager(name) {}
+
+    void updateLights(Camera* camera)
+    {
+        _updateSceneGraph(camera);
+        findLightsAffectingFrustum(camera);
+    }
+};
+//--------------------------------------------------------------------------
+static void randomiseLight(Light* light)
+{
+    light->getParentSceneNode()->setPosition(Math::RangeRandom(-500, 500),
+        Math::RangeRandom(-500, 500), Math::RangeRandom(-500, 500));
+    light->setDirection(Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(),
+        Math::SymmetricRandom()).normalisedCopy());
+    light->setAttenuation(Math::RangeRandom(5, 80), 1, 0, 0);
+}
+//--------------------------------------------------------------------------
+static Camera* buildScene(SceneManager* sceneMgr, size_t numLights)
+{
+    srand(0);
+    for (size_t i = 0; i < numLights; ++i)
+    {
+        Light* light = sceneMgr->createLight("Light" + StringConverter::toString(i));
+        const Real type = Math::UnitRandom();
+        light->setType(type < 0.02 ? Light::LT_DIRECTIONAL :
+            (type < 0.3 ? Light::LT_SPOTLIGHT : Light::LT_POINT));
+        light->setLightMask(Math::UnitRandom() < 0.9 ? 0xFFFFFFFF : 0x1);
+        sceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(light);
+        randomiseLight(light);
+    }
+
+    Camera* camera = sceneMgr->createCamera("Camera");
+    camera->setPosition(0, 0, 1500);
+    camera->lookAt(Vector3::ZERO);
+    camera->setAspectRatio(1);
+    camera->setFOVy(Degree(60));
+    camera->setNearClipDistance(1);
+    camera->setFarClipDistance(0);
+    return camera;
+}
+//--------------------------------------------------------------------------
+/// Populates the light lists of random spheres, returns the time taken
+static unsigned long populateLightLists(SceneManager* sceneMgr, bool useIndex,
+    vector<LightList>::type& lists)
+{
+    sceneMgr->setUseSpatialLightIndex(useIndex);
+    lists.resize(NUM_QUERIES);
+
+    srand(1);
+    Timer timer;
+    for (size_t i = 0; i < NUM_QUERIES; ++i)
+    {
+        const Vector3 position(Math::RangeRandom(-600, 600),
+            Math::RangeRandom(-600, 600), Math::RangeRandom(-600, 600));
+        const Real radius = Math::RangeRandom(0, 40);
+        const uint32 mask = Math::UnitRandom() < 0.9 ? 0xFFFFFFFF : 0x2;
+        sceneMgr->_populateLightList(position, radius, lists[i], mask);
+    }
+    return timer.getMicroseconds();
+}
+//--------------------------------------------------------------------------
+static void checkSameLightLists(SceneManager* sceneMgr, const String& label)
+{
+    vector<LightList>::type expected, actual;
+    const unsigned long linearTime = populateLightLists(sceneMgr, false, expected);
+    const unsigned long indexTime = populateLightLists(sceneMgr, true, actual);
+
+    LogManager::getSingleton().stream() << "LightIndexTests: " << label << ", "
+        << NUM_QUERIES << " light lists, linear scan " << linearTime
+        << " us, spatial index " << indexTime << " us";
+
+    for (size_t i = 0; i < NUM_QUERIES; ++i)
+    {
+        CPPUNIT_ASSERT(expected[i] == actual[i]);
+    }
+}
+//--------------------------------------------------------------------------
+void LightIndexTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    // Cameras need a buffer manager, there is no render system
+    mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+}
+//--------------------------------------------------------------------------
+void LightIndexTests::tearDown()
+{
+    OGRE_DELETE mRoot;
+    OGRE_DELETE mBufMgr;
+}
+//--------------------------------------------------------------------------
+void LightIndexTests::testIndexMatchesLinearScan()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t lightCounts[] = { 10, 100, 1000 };
+    for (size_t c = 0; c < sizeof(lightCounts) / sizeof(lightCounts[0]); ++c)
+    {
+        LightTestSceneManager* sceneMgr = OGRE_NEW LightTestSceneManager("LightIndexTests");
+        Camera* camera = buildScene(sceneMgr, lightCounts[c]);
+        sceneMgr->updateLights(camera);
+        CPPUNIT_ASSERT(!sceneMgr->_getLightsAffectingFrustum().empty());
+
+        checkSameLightLists(sceneMgr, StringConverter::toString(lightCounts[c]) + " lights");
+        OGRE_DELETE sceneMgr;
+    }
+}
+//--------------------------------------------------------------------------
+void LightIndexTests::testIndexAfterLightsChange()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    LightTestSceneManager* sceneMgr = OGRE_NEW LightTestSceneManager("LightIndexTests");
+    Camera* camera = buildScene(sceneMgr, 200);
+    for (unsigned int frame = 0; frame < 5; ++frame)
+    {
+        // Move some lights, the index must follow
+        srand(frame + 10);
+        for (size_t i = 0; i < 50; ++i)
+        {
+            randomiseLight(sceneMgr->getLight("Light" + StringConverter::toString(rand() % 200)));
+        }
+        sceneMgr->updateLights(camera);
+        checkSameLightLists(sceneMgr, "200 moving lights");
+    }
+    OGRE_DELETE sceneMgr;
+}
@@ -45,6 +45,8 @@ THE SOFTWARE.
 #include "OgreMaterialManager.h"
 #include "OgreLodStrategyManager.h"
 #include "OgreSkeleton.h"
+#include "OgreLogManager.h"
+#include "OgreTimer.h"
 
 #include "UnitTestSuite.h"
 
@@ -305,6 +307,62 @@ void MeshSerializerTests::testMesh_Version_1_2()
 #endif /* ifdef I_HAVE_LOT_OF_FREE_TIME */
 }
 //--------------------------------------------------------------------------
+void MeshSerializerTests::testMesh_MappedLoad()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Load every mesh of the media through a file stream and through a
+    // mapped file, which takes the in place path of the serializer
+    const bool useMappedFiles = FileSystemArchive::getUseMappedFiles();
+    FileSystemArchive::setUseMappedFiles(false);
+    MeshSerializer serializer;
+    size_t numMeshes = 0;
+    size_t numBytes = 0;
+    unsigned long streamTime = 0;
+    unsigned long mappedTime = 0;
+    Timer timer;
+    StringVector groups = ResourceGroupManager::getSingleton().getResourceGroups();
+    for (StringVector::iterator g = groups.begin(); g != groups.end(); ++g)
+    {
+        FileInfoListPtr files = ResourceGroupManager::getSingleton().findResourceFileInfo(*g, "*.mesh");
+        for (FileInfoList::iterator f = files->begin(); f != files->end(); ++f)
+        {
+            const String fullPath = f->archive->getName() + "/" + f->filename;
+
+            // Warm up the file cache so both loads read the same way
+            DataStreamPtr stream = f->archive->open(f->filename);
+            MemoryDataStream warmUp(stream);
+
+            MeshPtr streamMesh = MeshManager::getSingleton().createManual(fullPath + ".stream", *g);
+            timer.reset();
+            stream = f->archive->open(f->filename);
+            serializer.importMesh(stream, streamMesh.get());
+            streamTime += timer.getMicroseconds();
+
+            MeshPtr mappedMesh = MeshManager::getSingleton().createManual(fullPath + ".mapped", *g);
+            timer.reset();
+            DataStreamPtr mapped(OGRE_NEW MappedFileDataStream(f->filename, fullPath));
+            serializer.importMesh(mapped, mappedMesh.get());
+            mappedTime += timer.getMicroseconds();
+
+            assertMeshClone(streamMesh.get(), mappedMesh.get());
+            numBytes += mapped->size();
+            ++numMeshes;
+
+            ResourcePtr resource = streamMesh;
+            MeshManager::getSingleton().remove(resource);
+            resource = mappedMesh;
+            MeshManager::getSingleton().remove(resource);
+        }
+    }
+
+    FileSystemArchive::setUseMappedFiles(useMappedFiles);
+
+    LogManager::getSingleton().stream() << "MeshSerializerTests: " << numMeshes
+        << " meshes, " << numBytes << " bytes; file stream " << streamTime
+        << " us, mapped " << mappedTime << " us";
+}
+//--------------------------------------------------------------------------
 void MeshSerializerTests::testMesh_XML()
 {
 #ifdef OGRE_TEST_XMLSERIALIZER
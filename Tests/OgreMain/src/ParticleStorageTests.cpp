@@ -0,0 +1,301 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ParticleStorageTests.h"
+#include "OgreRoot.h"
+#include "OgreControllerManager.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreParticleSystem.h"
+#include "OgreParticleSystemManager.h"
+#include "OgreParticleSystemRenderer.h"
+#include "OgreParticleEmitter.h"
+#include "OgreParticleEmitterFactory.h"
+#include "OgreParticleAffector.h"
+#include "OgreParticleAffectorFactory.h"
+#include "OgreParticle.h"
+#include "OgreMath.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(ParticleStorageTests);
+
+//--------------------------------------------------------------------------
+/// Emits particles with random state
+class TestEmitter : public ParticleEmitter
+{
+public:
+    TestEmitter(ParticleSystem* psys) : ParticleEmitter(psys) { mType = "Test"; }
+
+    unsigned short _getEmissionCount(Real timeElapsed) { return genConstantEmissionCount(timeElapsed); }
+
+    void _initParticle(Particle* p)
+    {
+        ParticleEmitter::_initParticle(p);
+        p->mPosition = Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(), Math::SymmetricRandom());
+        p->mDirection = Vector3(Math::SymmetricRandom(), Math::UnitRandom(), Math::SymmetricRandom()) * 50;
+        p->mColour = ColourValue(Math::UnitRandom(), Math::UnitRandom(), Math::UnitRandom(), 1);
+        p->mTimeToLive = p->mTotalTimeToLive = Math::RangeRandom(0.5, 3);
+    }
+};
+//--------------------------------------------------------------------------
+class TestEmitterFactory : public ParticleEmitterFactory
+{
+public:
+    String getName() const { return "Test"; }
+    ParticleEmitter* createEmitter(ParticleSystem* psys)
+    {
+        ParticleEmitter* emitter = OGRE_NEW TestEmitter(psys);
+        mEmitters.push_back(emitter);
+        return emitter;
+    }
+};
+//--------------------------------------------------------------------------
+/// Applies gravity and fades particles through the particle iterator
+class TestAffector : public ParticleAffector
+{
+public:
+    TestAffector(ParticleSystem* psys) : ParticleAffector(psys) { mType = "Test"; }
+
+    void _affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+    {
+        ParticleIterator pi = pSystem->_getIterator();
+        while (!pi.end())
+        {
+            Particle* p = pi.getNext();
+            p->mDirection.y -= 100 * timeElapsed;
+            p->mColour.a = p->mTimeToLive / p->mTotalTimeToLive;
+            if (p->mPosition.y < -100)
+                p->mTimeToLive = 0;
+        }
+    }
+};
+//--------------------------------------------------------------------------
+class TestAffectorFactory : public ParticleAffectorFactory
+{
+public:
+    String getName() const { return "Test"; }
+    ParticleAffector* createAffector(ParticleSystem* psys)
+    {
+        ParticleAffector* affector = OGRE_NEW TestAffector(psys);
+        mAffectors.push_back(affector);
+        return affector;
+    }
+};
+//--------------------------------------------------------------------------
+/// Renderer which draws nothing
+class TestRenderer : public ParticleSystemRenderer
+{
+public:
+    const String& getType(void) const
+    {
+        static const String type = "billboard";
+        return type;
+    }
+    void _updateRenderQueue(RenderQueue* queue, list<Particle*>::type& currentParticles,
+        bool cullIndividually) {}
+    void _setMaterial(MaterialPtr& mat) {}
+    void _notifyCurrentCamera(Camera* cam) {}
+    void _notifyAttached(Node* parent, bool isTagPoint = false) {}
+    void _notifyParticleQuota(size_t quota) {}
+    void _notifyDefaultDimensions(Real width, Real height) {}
+    void setRenderQueueGroup(uint8 queueID) {}
+    void setRenderQueueGroupAndPriority(uint8 queueID, ushort priority) {}
+    void setKeepParticlesInLocalSpace(bool keepLocal) {}
+    SortMode _getSortMode(void) const { return SM_DISTANCE; }
+    void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables = false) {}
+};
+//--------------------------------------------------------------------------
+class TestRendererFactory : public ParticleSystemRendererFactory
+{
+public:
+    const String& getType() const
+    {
+        static const String type = "billboard";
+        return type;
+    }
+    ParticleSystemRenderer* createInstance(const String& name) { return OGRE_NEW TestRenderer(); }
+    void destroyInstance(ParticleSystemRenderer* ptr) { OGRE_DELETE ptr; }
+};
+//--------------------------------------------------------------------------
+/// Particle system which does not need a material
+class TestParticleSystem : public ParticleSystem
+{
+public:
+    TestParticleSystem(const String& name, SceneManager* sceneMgr, bool contiguous)
+        : ParticleSystem(name, ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME)
+    {
+        mIsRendererConfigured = true;
+        setParticleQuota(2000);
+        setContiguousParticleStorage(contiguous);
+        addEmitter("Test")->setEmissionRate(1000);
+        addAffector("Test");
+        sceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(this);
+    }
+};
+//--------------------------------------------------------------------------
+/// State of a particle, ordered so that the states of systems can be compared
+struct ParticleState
+{
+    Real values[16];
+
+    ParticleState(const Particle* p)
+    {
+        values[0] = p->mPosition.x;
+        values[1] = p->mPosition.y;
+        values[2] = p->mPosition.z;
+        values[3] = p->mDirection.x;
+        values[4] = p->mDirection.y;
+        values[5] = p->mDirection.z;
+        values[6] = p->mColour.r;
+        values[7] = p->mColour.g;
+        values[8] = p->mColour.b;
+        values[9] = p->mColour.a;
+        values[10] = p->mTimeToLive;
+        values[11] = p->mTotalTimeToLive;
+        values[12] = p->mRotation.valueRadians();
+        values[13] = p->mRotationSpeed.valueRadians();
+        values[14] = p->hasOwnDimensions() ? p->getOwnWidth() : -1;
+        values[15] = p->hasOwnDimensions() ? p->getOwnHeight() : -1;
+    }
+
+    bool operator<(const ParticleState& rhs) const
+    {
+        return std::lexicographical_compare(values, values + 16, rhs.values, rhs.values + 16);
+    }
+    bool operator==(const ParticleState& rhs) const
+    {
+        return std::equal(values, values + 16, rhs.values);
+    }
+};
+//--------------------------------------------------------------------------
+static void checkSameParticles(ParticleSystem* expected, ParticleSystem* actual)
+{
+    CPPUNIT_ASSERT_EQUAL(expected->getNumParticles(), actual->getNumParticles());
+
+    vector<ParticleState>::type expectedStates, actualStates;
+    for (size_t i = 0; i < expected->getNumParticles(); ++i)
+    {
+        expectedStates.push_back(ParticleState(expected->getParticle(i)));
+        actualStates.push_back(ParticleState(actual->getParticle(i)));
+    }
+    std::sort(expectedStates.begin(), expectedStates.end());
+    std::sort(actualStates.begin(), actualStates.end());
+
+    // Results must match exactly, not only within a tolerance
+    CPPUNIT_ASSERT(expectedStates == actualStates);
+}
+//--------------------------------------------------------------------------
+static void updateSystems(ParticleSystem* expected, ParticleSystem* actual, unsigned int frame)
+{
+    // Same random sequence for both systems
+    srand(frame);
+    expected->_update(0.02f);
+    srand(frame);
+    actual->_update(0.02f);
+}
+//--------------------------------------------------------------------------
+void ParticleStorageTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+    // Normally created by Root::initialise, drives the particle systems
+    mControllerMgr = OGRE_NEW ControllerManager();
+    mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+
+    mEmitterFactory = OGRE_NEW TestEmitterFactory();
+    mAffectorFactory = OGRE_NEW TestAffectorFactory();
+    mRendererFactory = OGRE_NEW TestRendererFactory();
+    ParticleSystemManager::getSingleton().addEmitterFactory(mEmitterFactory);
+    ParticleSystemManager::getSingleton().addAffectorFactory(mAffectorFactory);
+    ParticleSystemManager::getSingleton().addRendererFactory(mRendererFactory);
+}
+//--------------------------------------------------------------------------
+void ParticleStorageTests::tearDown()
+{
+    OGRE_DELETE mRoot;
+    OGRE_DELETE mControllerMgr;
+    OGRE_DELETE mEmitterFactory;
+    OGRE_DELETE mAffectorFactory;
+    OGRE_DELETE mRendererFactory;
+}
+//--------------------------------------------------------------------------
+void ParticleStorageTests::testContiguousMatchesList()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    ParticleSystem* listSystem = OGRE_NEW TestParticleSystem("List", mSceneMgr, false);
+    ParticleSystem* contiguousSystem = OGRE_NEW TestParticleSystem("Contiguous", mSceneMgr, true);
+
+    // Long enough to reach the quota and expire particles
+    for (unsigned int frame = 0; frame < 300; ++frame)
+    {
+        updateSystems(listSystem, contiguousSystem, frame);
+        if (frame % 25 == 0)
+            checkSameParticles(listSystem, contiguousSystem);
+    }
+    CPPUNIT_ASSERT(contiguousSystem->getNumParticles() > 0);
+
+    listSystem->clear();
+    contiguousSystem->clear();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), contiguousSystem->getNumParticles());
+    for (unsigned int frame = 0; frame < 50; ++frame)
+    {
+        updateSystems(listSystem, contiguousSystem, frame);
+    }
+    checkSameParticles(listSystem, contiguousSystem);
+
+    OGRE_DELETE listSystem;
+    OGRE_DELETE contiguousSystem;
+}
+//--------------------------------------------------------------------------
+void ParticleStorageTests::testSwitchStorage()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    ParticleSystem* listSystem = OGRE_NEW TestParticleSystem("List", mSceneMgr, false);
+    ParticleSystem* switchedSystem = OGRE_NEW TestParticleSystem("Switched", mSceneMgr, false);
+
+    // Switch with live particles, in both directions
+    for (unsigned int frame = 0; frame < 200; ++frame)
+    {
+        if (frame % 40 == 20)
+        {
+            switchedSystem->setContiguousParticleStorage(
+                !switchedSystem->getContiguousParticleStorage());
+        }
+        updateSystems(listSystem, switchedSystem, frame);
+    }
+    checkSameParticles(listSystem, switchedSystem);
+
+    OGRE_DELETE listSystem;
+    OGRE_DELETE switchedSystem;
+}
@@ -26,6 +26,10 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "PixelFormatTests.h"
+#include "OgreRoot.h"
+#include "OgreBitwise.h"
+#include "OgreStringConverter.h"
+#include "Threading/OgreTaskSchedulerWorkQueue.h"
 #include <cstdlib>
 #include <iomanip>
 
@@ -33,6 +37,7 @@ THE SOFTWARE.
 
 // Register the test suite
 CPPUNIT_TEST_SUITE_REGISTRATION(PixelFormatTests);
+OGRE_BENCHMARK_SUITE_REGISTRATION(PixelFormatBenchmarks);
 
 //--------------------------------------------------------------------------
 void PixelFormatTests::setUp()
@@ -235,3 +240,218 @@ void PixelFormatTests::testBulkConversion()
 }
 //--------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------
+/// Format pairs which have vectorised conversions
+static const PixelFormat vectorisedPairs[][2] =
+{
+    { PF_A8R8G8B8, PF_A8B8G8R8 }, { PF_A8R8G8B8, PF_B8G8R8A8 }, { PF_A8R8G8B8, PF_R8G8B8A8 },
+    { PF_A8B8G8R8, PF_A8R8G8B8 }, { PF_A8B8G8R8, PF_B8G8R8A8 }, { PF_A8B8G8R8, PF_R8G8B8A8 },
+    { PF_B8G8R8A8, PF_A8R8G8B8 }, { PF_B8G8R8A8, PF_A8B8G8R8 }, { PF_B8G8R8A8, PF_R8G8B8A8 },
+    { PF_R8G8B8A8, PF_A8R8G8B8 }, { PF_R8G8B8A8, PF_A8B8G8R8 }, { PF_R8G8B8A8, PF_B8G8R8A8 },
+    { PF_X8R8G8B8, PF_A8R8G8B8 }, { PF_X8R8G8B8, PF_A8B8G8R8 }, { PF_X8R8G8B8, PF_B8G8R8A8 },
+    { PF_X8R8G8B8, PF_R8G8B8A8 }, { PF_X8B8G8R8, PF_A8R8G8B8 }, { PF_X8B8G8R8, PF_A8B8G8R8 },
+    { PF_X8B8G8R8, PF_B8G8R8A8 }, { PF_X8B8G8R8, PF_R8G8B8A8 },
+    { PF_R8G8B8, PF_A8R8G8B8 }, { PF_R8G8B8, PF_A8B8G8R8 }, { PF_R8G8B8, PF_B8G8R8A8 },
+    { PF_R8G8B8, PF_R8G8B8A8 }, { PF_B8G8R8, PF_A8R8G8B8 }, { PF_B8G8R8, PF_A8B8G8R8 },
+    { PF_B8G8R8, PF_B8G8R8A8 }, { PF_B8G8R8, PF_R8G8B8A8 },
+    { PF_L8, PF_A8R8G8B8 }, { PF_L8, PF_A8B8G8R8 }, { PF_L8, PF_B8G8R8A8 }, { PF_L8, PF_R8G8B8A8 },
+    { PF_A8R8G8B8, PF_L8 }, { PF_A8B8G8R8, PF_L8 }, { PF_B8G8R8A8, PF_L8 }, { PF_R8G8B8A8, PF_L8 },
+    { PF_A8R8G8B8, PF_FLOAT32_RGBA }, { PF_A8B8G8R8, PF_FLOAT32_RGBA }, { PF_B8G8R8A8, PF_FLOAT32_RGBA },
+    { PF_R8G8B8A8, PF_FLOAT32_RGBA }, { PF_X8R8G8B8, PF_FLOAT32_RGBA }, { PF_X8B8G8R8, PF_FLOAT32_RGBA },
+    { PF_R8G8B8, PF_FLOAT32_RGBA }, { PF_B8G8R8, PF_FLOAT32_RGBA },
+    { PF_FLOAT32_RGBA, PF_A8R8G8B8 }, { PF_FLOAT32_RGBA, PF_A8B8G8R8 }, { PF_FLOAT32_RGBA, PF_B8G8R8A8 },
+    { PF_FLOAT32_RGBA, PF_R8G8B8A8 },
+    { PF_FLOAT16_R, PF_FLOAT32_R }, { PF_FLOAT32_R, PF_FLOAT16_R },
+    { PF_FLOAT16_GR, PF_FLOAT32_GR }, { PF_FLOAT32_GR, PF_FLOAT16_GR },
+    { PF_FLOAT16_RGB, PF_FLOAT32_RGB }, { PF_FLOAT32_RGB, PF_FLOAT16_RGB },
+    { PF_FLOAT16_RGBA, PF_FLOAT32_RGBA }, { PF_FLOAT32_RGBA, PF_FLOAT16_RGBA }
+};
+static const size_t numVectorisedPairs = sizeof(vectorisedPairs) / sizeof(vectorisedPairs[0]);
+//--------------------------------------------------------------------------
+void PixelFormatTests::testVectorisedConversion()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Random floats are mostly out of range; mix in values of [-0.5, 1.5]
+    // so that every branch of the float kernels is taken
+    vector<uint8>::type source(mSize * 4);
+    for (size_t i = 0; i < source.size() / 4; ++i)
+    {
+        float value = (rand() % 2048) / 1024.0f - 0.5f;
+        if (i % 3)
+            memcpy(&source[i * 4], &value, 4);
+        else
+            memcpy(&source[i * 4], &mRandomData[(i * 4) % (mSize - 4)], 4);
+    }
+
+    for (size_t p = 0; p < numVectorisedPairs; ++p)
+    {
+        const PixelFormat srcFormat = vectorisedPairs[p][0], dstFormat = vectorisedPairs[p][1];
+        const size_t srcPixelSize = PixelUtil::getNumElemBytes(srcFormat);
+        const size_t dstPixelSize = PixelUtil::getNumElemBytes(dstFormat);
+
+        // Every length of row up to a few vectors, and rows of boxes with
+        // padding between them
+        for (size_t width = 1; width <= 67; ++width)
+        {
+            const size_t height = width < 60 ? 1 : 3, pitch = width + (height > 1 ? 5 : 0);
+            PixelBox src(Box(0, 0, 0, width, height, 1), srcFormat, &source[0]);
+            src.rowPitch = pitch;
+            src.slicePitch = pitch * height;
+
+            vector<uint8>::type actual((pitch * height + 1) * dstPixelSize, 0x5A);
+            vector<uint8>::type expected(actual);
+            PixelBox dst1(Box(0, 0, 0, width, height, 1), dstFormat, &actual[0]);
+            PixelBox dst2(Box(0, 0, 0, width, height, 1), dstFormat, &expected[0]);
+            dst1.rowPitch = dst2.rowPitch = pitch;
+            dst1.slicePitch = dst2.slicePitch = pitch * height;
+            CPPUNIT_ASSERT(pitch * height * srcPixelSize <= source.size());
+
+            PixelUtil::bulkPixelConversion(src, dst1);
+            naiveBulkPixelConversion(src, dst2);
+
+            StringStream msg;
+            msg << "Conversion mismatch [" << PixelUtil::getFormatName(srcFormat) <<
+                "->" << PixelUtil::getFormatName(dstFormat) << "] width " << width;
+            CPPUNIT_ASSERT_MESSAGE(msg.str().c_str(), actual == expected);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void PixelFormatTests::testHalfFloatConversion()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Every half
+    vector<uint16>::type halves(65536);
+    for (size_t i = 0; i < halves.size(); ++i)
+        halves[i] = static_cast<uint16>(i);
+    vector<uint32>::type floats(halves.size());
+    PixelUtil::bulkPixelConversion(&halves[0], PF_FLOAT16_R, &floats[0], PF_FLOAT32_R,
+        static_cast<unsigned int>(halves.size()));
+    for (size_t i = 0; i < halves.size(); ++i)
+        CPPUNIT_ASSERT_EQUAL(Bitwise::halfToFloatI(halves[i]), floats[i]);
+
+    // Every float exponent and sign, with mantissas around the bits which
+    // get truncated
+    floats.clear();
+    for (uint32 exponent = 0; exponent < 256; ++exponent)
+    {
+        for (uint32 m = 0; m < 64; ++m)
+        {
+            uint32 mantissa = (m & 1 ? 0x1FFF : 0) ^ (m * 0x1F3D5) ^ (rand() & 0x7F);
+            floats.push_back((exponent << 23) | (mantissa & 0x7FFFFF));
+            floats.push_back(0x80000000 | (exponent << 23) | (mantissa & 0x7FFFFF));
+        }
+    }
+    halves.resize(floats.size());
+    PixelUtil::bulkPixelConversion(&floats[0], PF_FLOAT32_R, &halves[0], PF_FLOAT16_R,
+        static_cast<unsigned int>(floats.size()));
+    for (size_t i = 0; i < floats.size(); ++i)
+        CPPUNIT_ASSERT_EQUAL(Bitwise::floatToHalfI(floats[i]), halves[i]);
+}
+//--------------------------------------------------------------------------
+void PixelFormatTests::testParallelConversion()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Over the 256K pixels from which rows are converted in stripes, with an
+    // odd width and padding at the end of the rows
+    const size_t width = 515, height = 513, pitch = width + 7;
+    const PixelFormat pairs[][2] =
+    {
+        { PF_A8R8G8B8, PF_A8R8G8B8 }, { PF_R8G8B8, PF_B8G8R8A8 }, { PF_L8, PF_L16 },
+        { PF_A8R8G8B8, PF_FLOAT32_RGBA }, { PF_FLOAT32_RGBA, PF_FLOAT16_RGBA }
+    };
+
+    vector<uint8>::type source(pitch * height * 16);
+    for (size_t i = 0; i < source.size(); ++i)
+        source[i] = mRandomData[(i * 7) % mSize];
+
+    // Converted on the calling thread, as long as there is no Root
+    vector< vector<uint8>::type >::type expected;
+    for (size_t p = 0; p < sizeof(pairs) / sizeof(pairs[0]); ++p)
+    {
+        PixelBox src(Box(0, 0, 0, width, height, 1), pairs[p][0], &source[0]);
+        src.rowPitch = pitch;
+        src.slicePitch = pitch * height;
+        expected.push_back(vector<uint8>::type(
+            pitch * height * PixelUtil::getNumElemBytes(pairs[p][1]), 0x5A));
+        PixelBox dst(Box(0, 0, 0, width, height, 1), pairs[p][1], &expected.back()[0]);
+        dst.rowPitch = pitch;
+        dst.slicePitch = pitch * height;
+        PixelUtil::bulkPixelConversion(src, dst);
+    }
+
+    Root* root = OGRE_NEW Root(BLANKSTRING);
+    TaskSchedulerWorkQueue* queue = OGRE_NEW TaskSchedulerWorkQueue("PixelFormatTests");
+    queue->setWorkerThreadCount(3);
+    root->setWorkQueue(queue);
+    queue->startup();
+    // Without thread support the queue has no workers and the rows stay serial
+#if OGRE_THREAD_SUPPORT
+    CPPUNIT_ASSERT(queue->getTaskScheduler()->getNumThreads() > 0);
+#endif
+
+    for (size_t p = 0; p < sizeof(pairs) / sizeof(pairs[0]); ++p)
+    {
+        PixelBox src(Box(0, 0, 0, width, height, 1), pairs[p][0], &source[0]);
+        src.rowPitch = pitch;
+        src.slicePitch = pitch * height;
+        vector<uint8>::type actual(expected[p].size(), 0x5A);
+        PixelBox dst(Box(0, 0, 0, width, height, 1), pairs[p][1], &actual[0]);
+        dst.rowPitch = pitch;
+        dst.slicePitch = pitch * height;
+        PixelUtil::bulkPixelConversion(src, dst);
+
+        // The padding included
+        StringStream msg;
+        msg << "Parallel conversion mismatch [" << PixelUtil::getFormatName(pairs[p][0]) <<
+            "->" << PixelUtil::getFormatName(pairs[p][1]) << "]";
+        CPPUNIT_ASSERT_MESSAGE(msg.str().c_str(), actual == expected[p]);
+    }
+
+    OGRE_DELETE root;
+}
+//--------------------------------------------------------------------------
+void PixelFormatTests::testConversionTiming()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t size = 1024;
+    const PixelFormat pairs[][2] =
+    {
+        { PF_R8G8B8, PF_B8G8R8A8 }, { PF_L8, PF_R8G8B8A8 }, { PF_A8R8G8B8, PF_FLOAT32_RGBA },
+        { PF_FLOAT32_RGBA, PF_FLOAT16_RGBA }, { PF_FLOAT16_RGBA, PF_FLOAT32_RGBA }
+    };
+
+    vector<uint8>::type source(size * size * 16), actual(size * size * 16), expected(size * size * 16);
+    for (size_t i = 0; i < source.size(); ++i)
+        source[i] = mRandomData[i % mSize];
+
+    // Stripes of large boxes run on the scheduler of the work queue
+    Root* root = OGRE_NEW Root(BLANKSTRING);
+    TaskSchedulerWorkQueue* queue = OGRE_NEW TaskSchedulerWorkQueue("PixelFormatTests");
+    queue->setWorkerThreadCount(3);
+    root->setWorkQueue(queue);
+    queue->startup();
+
+    for (size_t p = 0; p < sizeof(pairs) / sizeof(pairs[0]); ++p)
+    {
+        PixelBox src(size, size, 1, pairs[p][0], &source[0]);
+        PixelBox dst1(size, size, 1, pairs[p][1], &actual[0]);
+        PixelBox dst2(size, size, 1, pairs[p][1], &expected[0]);
+
+        BenchmarkLog log("PixelFormatTests", PixelUtil::getFormatName(pairs[p][0]) + "->" +
+            PixelUtil::getFormatName(pairs[p][1]) + " " + StringConverter::toString(size) + "x" +
+            StringConverter::toString(size));
+        naiveBulkPixelConversion(src, dst2);
+        log.time("unpacking to floats");
+
+        PixelUtil::bulkPixelConversion(src, dst1);
+        log.time("on 4 threads");
+        CPPUNIT_ASSERT(memcmp(&actual[0], &expected[0], dst1.getConsecutiveSize()) == 0);
+    }
+
+    OGRE_DELETE root;
+}
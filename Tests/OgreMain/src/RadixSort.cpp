@@ -75,6 +75,15 @@ public:
     }
 };
 //--------------------------------------------------------------------------
+class UnsignedInt64SortFunctor
+{
+public:
+    uint64 operator()(const uint64& p) const
+    {
+        return p;
+    }
+};
+//--------------------------------------------------------------------------
 void RadixSortTests::testFloatVector()
 {
     UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
@@ -219,5 +228,70 @@ void RadixSortTests::testIntVector()
     }
 }
 //--------------------------------------------------------------------------
+void RadixSortTests::testUnsignedInt64Vector()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    std::vector<uint64> container;
+    UnsignedInt64SortFunctor func;
+    RadixSort<std::vector<uint64>, uint64, uint64> sorter;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        container.push_back((static_cast<uint64>(rand()) << 48) ^ 
+            (static_cast<uint64>(rand()) << 24) ^ static_cast<uint64>(rand()));
+    }
+    std::vector<uint64> expected = container;
+    std::sort(expected.begin(), expected.end());
 
+    sorter.sort(container, func);
 
+    CPPUNIT_ASSERT(container == expected);
+}
+//--------------------------------------------------------------------------
+void RadixSortTests::testSharedBytes()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Only some bytes differ, the rest are skipped
+    std::vector<uint64> keys;
+    UnsignedInt64SortFunctor keyFunc;
+    RadixSort<std::vector<uint64>, uint64, uint64> keySorter;
+    for (int i = 0; i < 1000; ++i)
+    {
+        keys.push_back((static_cast<uint64>(0xAB) << 56) | 
+            (static_cast<uint64>(rand() % 4) << 40) | 0x1234 | (rand() % 8));
+    }
+    std::vector<uint64> expectedKeys = keys;
+    std::sort(expectedKeys.begin(), expectedKeys.end());
+    keySorter.sort(keys, keyFunc);
+    CPPUNIT_ASSERT(keys == expectedKeys);
+
+    // Negative floats still need reversing when only the top byte differs
+    std::vector<float> floats;
+    FloatSortFunctor floatFunc;
+    RadixSort<std::vector<float>, float, float> floatSorter;
+    for (int i = 0; i < 1000; ++i)
+    {
+        floats.push_back(rand() % 2 ? 2.0f : -2.0f);
+        floats.push_back(rand() % 2 ? 3.0f : -3.0f);
+    }
+    std::vector<float> expectedFloats = floats;
+    std::sort(expectedFloats.begin(), expectedFloats.end());
+    floatSorter.sort(floats, floatFunc);
+    CPPUNIT_ASSERT(floats == expectedFloats);
+
+    // Likewise negative ints
+    std::vector<int> ints;
+    IntSortFunctor intFunc;
+    RadixSort<std::vector<int>, int, int> intSorter;
+    for (int i = 0; i < 1000; ++i)
+    {
+        ints.push_back((rand() % 2 ? 1 : -1) << 24);
+    }
+    std::vector<int> expectedInts = ints;
+    std::sort(expectedInts.begin(), expectedInts.end());
+    intSorter.sort(ints, intFunc);
+    CPPUNIT_ASSERT(ints == expectedInts);
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,555 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "RenderQueueSortingTests.h"
+#include "OgreRoot.h"
+#include "OgreRenderQueueSortingGrouping.h"
+#include "OgreRenderable.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreMath.h"
+#include "OgreRenderSystem.h"
+#include "OgreRenderSystemCapabilities.h"
+#include "OgreRenderObjectListener.h"
+#include "OgreSceneManager.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(RenderQueueSortingTests);
+OGRE_BENCHMARK_SUITE_REGISTRATION(RenderQueueSortingBenchmarks);
+
+//--------------------------------------------------------------------------
+/// A renderable at a given view depth
+class SortingTestRenderable : public Renderable
+{
+public:
+    Real depth;
+    MaterialPtr material;
+    LightList lights;
+
+    SortingTestRenderable() : depth(0) {}
+    const MaterialPtr& getMaterial(void) const { return material; }
+    void getRenderOperation(RenderOperation& op) {}
+    void getWorldTransforms(Matrix4* xform) const { *xform = Matrix4::IDENTITY; }
+    Real getSquaredViewDepth(const Camera* cam) const { return depth; }
+    const LightList& getLights(void) const { return lights; }
+};
+//--------------------------------------------------------------------------
+/// Records the order in which a collection is visited
+class RecordingVisitor : public QueuedRenderableVisitor
+{
+public:
+    typedef std::vector<std::pair<const Pass*, Renderable*> > VisitList;
+    VisitList visits;
+    std::vector<const Pass*> passes;
+    const Pass* currentPass;
+    const Pass* skippedPass;
+
+    RecordingVisitor() : currentPass(0), skippedPass(0) {}
+    void visit(RenderablePass* rp) { visits.push_back(std::make_pair(rp->pass, rp->renderable)); }
+    bool visit(const Pass* p)
+    {
+        currentPass = p;
+        passes.push_back(p);
+        return p != skippedPass;
+    }
+    void visit(Renderable* r) { visits.push_back(std::make_pair(currentPass, r)); }
+};
+//--------------------------------------------------------------------------
+/// A render system which only counts the passes set on it
+class PassCountingRenderSystem : public RenderSystem
+{
+public:
+    size_t passesSet;
+
+    PassCountingRenderSystem() : passesSet(0) { mCurrentCapabilities = &mCapabilities; }
+
+    // _setPass sets the depth function once for each pass it doesn't skip
+    void _setDepthBufferFunction(CompareFunction func) { ++passesSet; }
+
+    const String& getName(void) const { static String name("PassCounting"); return name; }
+    const String& getFriendlyName(void) const { return getName(); }
+    ConfigOptionMap& getConfigOptions(void) { return mOptions; }
+    void setConfigOption(const String& name, const String& value) {}
+    HardwareOcclusionQuery* createHardwareOcclusionQuery(void) { return 0; }
+    String validateConfigOptions(void) { return BLANKSTRING; }
+    RenderSystemCapabilities* createRenderSystemCapabilities() const { return 0; }
+    void reinitialise(void) {}
+    void setAmbientLight(float r, float g, float b) {}
+    void setShadingType(ShadeOptions so) {}
+    void setLightingEnabled(bool enabled) {}
+    RenderWindow* _createRenderWindow(const String& name, unsigned int width, unsigned int height,
+        bool fullScreen, const NameValuePairList* miscParams = 0) { return 0; }
+    MultiRenderTarget* createMultiRenderTarget(const String& name) { return 0; }
+    String getErrorDescription(long errorNumber) const { return BLANKSTRING; }
+    void _useLights(const LightList& lights, unsigned short limit) {}
+    void _setWorldMatrix(const Matrix4& m) {}
+    void _setViewMatrix(const Matrix4& m) {}
+    void _setProjectionMatrix(const Matrix4& m) {}
+    void _setSurfaceParams(const ColourValue& ambient, const ColourValue& diffuse,
+        const ColourValue& specular, const ColourValue& emissive, Real shininess,
+        TrackVertexColourType tracking = TVC_NONE) {}
+    void _setPointSpritesEnabled(bool enabled) {}
+    void _setPointParameters(Real size, bool attenuationEnabled, Real constant, Real linear,
+        Real quadratic, Real minSize, Real maxSize) {}
+    void _setTexture(size_t unit, bool enabled, const TexturePtr& texPtr,
+        TextureUnitState::BindingType bindingType) {}
+    void _setTextureCoordSet(size_t unit, size_t index) {}
+    void _setTextureCoordCalculation(size_t unit, TexCoordCalcMethod m, const Frustum* frustum = 0) {}
+    void _setTextureBlendMode(size_t unit, const LayerBlendModeEx& bm) {}
+    void _setTextureUnitFiltering(size_t unit, FilterType ftype, FilterOptions filter) {}
+    void _setTextureUnitCompareEnabled(size_t unit, bool compare) {}
+    void _setTextureUnitCompareFunction(size_t unit, CompareFunction function) {}
+    void _setTextureLayerAnisotropy(size_t unit, unsigned int maxAnisotropy) {}
+    void _setTextureAddressingMode(size_t unit, const TextureUnitState::UVWAddressingMode& uvw) {}
+    void _setTextureBorderColour(size_t unit, const ColourValue& colour) {}
+    void _setTextureMipmapBias(size_t unit, float bias) {}
+    void _setTextureMatrix(size_t unit, const Matrix4& xform) {}
+    void _setSceneBlending(SceneBlendFactor sourceFactor, SceneBlendFactor destFactor,
+        SceneBlendOperation op = SBO_ADD) {}
+    void _setSeparateSceneBlending(SceneBlendFactor sourceFactor, SceneBlendFactor destFactor,
+        SceneBlendFactor sourceFactorAlpha, SceneBlendFactor destFactorAlpha,
+        SceneBlendOperation op = SBO_ADD, SceneBlendOperation alphaOp = SBO_ADD) {}
+    void _setAlphaRejectSettings(CompareFunction func, unsigned char value, bool alphaToCoverage) {}
+    DepthBuffer* _createDepthBufferFor(RenderTarget* renderTarget) { return 0; }
+    void _beginFrame(void) {}
+    void _endFrame(void) {}
+    void _setViewport(Viewport* vp) {}
+    void _setCullingMode(CullingMode mode) {}
+    void _setDepthBufferParams(bool depthTest = true, bool depthWrite = true,
+        CompareFunction depthFunction = CMPF_LESS_EQUAL) {}
+    void _setDepthBufferCheckEnabled(bool enabled = true) {}
+    void _setDepthBufferWriteEnabled(bool enabled = true) {}
+    void _setColourBufferWriteEnabled(bool red, bool green, bool blue, bool alpha) {}
+    void _setDepthBias(float constantBias, float slopeScaleBias = 0.0f) {}
+    void _setFog(FogMode mode = FOG_NONE, const ColourValue& colour = ColourValue::White,
+        Real expDensity = 1.0, Real linearStart = 0.0, Real linearEnd = 1.0) {}
+    VertexElementType getColourVertexElementType(void) const { return VET_COLOUR_ABGR; }
+    void _convertProjectionMatrix(const Matrix4& matrix, Matrix4& dest, bool forGpuProgram = false) {}
+    void _makeProjectionMatrix(const Radian& fovy, Real aspect, Real nearPlane, Real farPlane,
+        Matrix4& dest, bool forGpuProgram = false) {}
+    void _makeProjectionMatrix(Real left, Real right, Real bottom, Real top,
+        Real nearPlane, Real farPlane, Matrix4& dest, bool forGpuProgram = false) {}
+    void _makeOrthoMatrix(const Radian& fovy, Real aspect, Real nearPlane, Real farPlane,
+        Matrix4& dest, bool forGpuProgram = false) {}
+    void _applyObliqueDepthProjection(Matrix4& matrix, const Plane& plane, bool forGpuProgram) {}
+    void _setPolygonMode(PolygonMode level) {}
+    void setStencilCheckEnabled(bool enabled) {}
+    void setVertexDeclaration(VertexDeclaration* decl) {}
+    void setVertexBufferBinding(VertexBufferBinding* binding) {}
+    void setNormaliseNormals(bool normalise) {}
+    void bindGpuProgramParameters(GpuProgramType gptype,
+        GpuProgramParametersSharedPtr params, uint16 variabilityMask) {}
+    void bindGpuProgramPassIterationParameters(GpuProgramType gptype) {}
+    void setScissorTest(bool enabled, size_t left = 0, size_t top = 0,
+        size_t right = 800, size_t bottom = 600) {}
+    void clearFrameBuffer(unsigned int buffers, const ColourValue& colour = ColourValue::Black,
+        Real depth = 1.0f, unsigned short stencil = 0) {}
+    Real getHorizontalTexelOffset(void) { return 0; }
+    Real getVerticalTexelOffset(void) { return 0; }
+    Real getMinimumDepthInputValue(void) { return 0; }
+    Real getMaximumDepthInputValue(void) { return 1; }
+    void _setRenderTarget(RenderTarget* target) {}
+    void eventOccurred(const String& eventName, const NameValuePairList* parameters = 0) {}
+    void preExtraThreadsStarted() {}
+    void postExtraThreadsStarted() {}
+    void registerThread() {}
+    void unregisterThread() {}
+    unsigned int getDisplayMonitorCount() const { return 0; }
+    void beginProfileEvent(const String& eventName) {}
+    void endProfileEvent(void) {}
+    void markProfileEvent(const String& event) {}
+    bool hasAnisotropicMipMapFilter() const { return false; }
+
+protected:
+    RenderSystemCapabilities mCapabilities;
+    ConfigOptionMap mOptions;
+
+    void setClipPlanesImpl(const PlaneList& clipPlanes) {}
+    void initialiseFromRenderSystemCapabilities(RenderSystemCapabilities* caps, RenderTarget* primary) {}
+};
+//--------------------------------------------------------------------------
+/// A scene manager which lets the test fire the render object event
+class PassCountingSceneManager : public SceneManager
+{
+public:
+    PassCountingSceneManager() : SceneManager("PassCountingSceneManager") {}
+    const String& getTypeName(void) const { static String name("PassCounting"); return name; }
+    void notifyRenderSingleObject(const Pass* pass) { fireRenderSingleObject(0, pass, 0, 0, false); }
+};
+//--------------------------------------------------------------------------
+/// Counts the render object events
+class CountingRenderObjectListener : public RenderObjectListener
+{
+public:
+    size_t count;
+
+    CountingRenderObjectListener() : count(0) {}
+    void notifyRenderSingleObject(Renderable* rend, const Pass* pass, const AutoParamDataSource* source,
+        const LightList* pLightList, bool suppressRenderStateChanges) { ++count; }
+};
+//--------------------------------------------------------------------------
+/// Orders passes by descending identifier
+struct ReverseIdHashFunc : public Pass::HashFunc
+{
+    uint32 operator()(const Pass* p) const { return 0xFFFFFFFF - p->getId(); }
+};
+//--------------------------------------------------------------------------
+/// Creates materials with two passes each, using a few textures and blend modes
+static void createTestPasses(std::vector<Pass*>& passes, size_t numMaterials)
+{
+    for (size_t m = 0; m < numMaterials; ++m)
+    {
+        MaterialPtr mat = MaterialManager::getSingleton().create(
+            "RenderQueueSortingTests" + StringConverter::toString(m),
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+        Technique* tech = mat->createTechnique();
+        for (int p = 0; p < 2; ++p)
+        {
+            Pass* pass = tech->createPass();
+            pass->createTextureUnitState()->setTextureName(
+                "tex" + StringConverter::toString(m % 5) + ".png");
+            if (m % 3 == 0)
+                pass->setSceneBlending(SBT_ADD);
+            // Hashes of unloaded materials are only updated on load
+            pass->_recalculateHash();
+            passes.push_back(pass);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+static void checkPassGroupOrder(const RecordingVisitor& visitor, size_t numRenderables)
+{
+    CPPUNIT_ASSERT_EQUAL(numRenderables, visitor.visits.size());
+
+    std::set<const Pass*> seen;
+    for (size_t i = 0; i < visitor.passes.size(); ++i)
+    {
+        // Each pass is visited once, first passes before second
+        CPPUNIT_ASSERT(seen.insert(visitor.passes[i]).second);
+        if (i > 0)
+            CPPUNIT_ASSERT(visitor.passes[i - 1]->getIndex() <= visitor.passes[i]->getIndex());
+    }
+
+    for (size_t i = 1; i < visitor.visits.size(); ++i)
+    {
+        // Front to back within a pass
+        if (visitor.visits[i - 1].first == visitor.visits[i].first)
+        {
+            CPPUNIT_ASSERT(visitor.visits[i - 1].second->getSquaredViewDepth(0) <= 
+                visitor.visits[i].second->getSquaredViewDepth(0));
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortingTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+    srand(0);
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortingTests::tearDown()
+{
+    Pass::setHashFunction(Pass::MIN_TEXTURE_CHANGE);
+    MaterialManager::getSingleton().removeAll();
+    OGRE_DELETE mRoot;
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortingTests::testRenderStateKey()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    std::vector<Pass*> passes;
+    createTestPasses(passes, 2);
+
+    // Pass index is the most significant part
+    CPPUNIT_ASSERT(passes[0]->getRenderStateKey() < passes[1]->getRenderStateKey());
+    CPPUNIT_ASSERT(passes[2]->getRenderStateKey() < passes[1]->getRenderStateKey());
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(0), passes[0]->getRenderStateKey() & 0xFFFFFF);
+
+    // Same state, same key
+    Pass* a = passes[2];
+    Pass* b = passes[2]->getParent()->createPass();
+    *b = *a;
+    b->_recalculateHash();
+    CPPUNIT_ASSERT_EQUAL(a->getRenderStateKey() & ~(static_cast<uint64>(0xF) << 60),
+        b->getRenderStateKey() & ~(static_cast<uint64>(0xF) << 60));
+
+    // State changes show in the key and the change count
+    uint64 key = a->getRenderStateKey();
+    uint32 changes = a->getRenderStateChangeCount();
+    a->setSceneBlending(SBT_TRANSPARENT_ALPHA);
+    CPPUNIT_ASSERT(key != a->getRenderStateKey());
+    CPPUNIT_ASSERT(changes != a->getRenderStateChangeCount());
+
+    changes = a->getRenderStateChangeCount();
+    a->setDiffuse(ColourValue::Red);
+    CPPUNIT_ASSERT(changes != a->getRenderStateChangeCount());
+
+    changes = a->getRenderStateChangeCount();
+    a->getTextureUnitState(0)->setTextureName("other.png");
+    CPPUNIT_ASSERT(changes != a->getRenderStateChangeCount());
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortingTests::testPassGroupOrder()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    std::vector<Pass*> passes;
+    createTestPasses(passes, 12);
+
+    // Both the stable sort and the radix sort
+    const size_t counts[] = { 500, 5000 };
+    for (size_t c = 0; c < 2; ++c)
+    {
+        std::vector<SortingTestRenderable> rends(counts[c]);
+        QueuedRenderableCollection collection;
+        collection.addOrganisationMode(QueuedRenderableCollection::OM_PASS_GROUP);
+        for (size_t r = 0; r < rends.size(); ++r)
+        {
+            // Powers of two, so that many renderables share a depth
+            rends[r].depth = static_cast<Real>(1 << (rand() % 20));
+            collection.addRenderable(passes[rand() % passes.size()], &rends[r]);
+        }
+        collection.sort(0);
+
+        RecordingVisitor visitor;
+        collection.acceptVisitor(&visitor, QueuedRenderableCollection::OM_PASS_GROUP);
+        checkPassGroupOrder(visitor, rends.size());
+
+        // Removing a pass removes its renderables
+        collection.removePassGroup(passes[0]);
+        RecordingVisitor afterRemove;
+        collection.acceptVisitor(&afterRemove, QueuedRenderableCollection::OM_PASS_GROUP);
+        for (size_t i = 0; i < afterRemove.visits.size(); ++i)
+            CPPUNIT_ASSERT(afterRemove.visits[i].first != passes[0]);
+        CPPUNIT_ASSERT(afterRemove.visits.size() < rends.size());
+    }
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortingTests::testPassGroupSkip()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    std::vector<Pass*> passes;
+    createTestPasses(passes, 4);
+
+    std::vector<SortingTestRenderable> rends(100);
+    QueuedRenderableCollection collection;
+    collection.addOrganisationMode(QueuedRenderableCollection::OM_PASS_GROUP);
+    size_t numSkipped = 0;
+    for (size_t r = 0; r < rends.size(); ++r)
+    {
+        Pass* pass = passes[r % passes.size()];
+        if (pass == passes[3])
+            ++numSkipped;
+        collection.addRenderable(pass, &rends[r]);
+    }
+    collection.sort(0);
+
+    // The visitor turning a pass down skips its renderables only
+    RecordingVisitor visitor;
+    visitor.skippedPass = passes[3];
+    collection.acceptVisitor(&visitor, QueuedRenderableCollection::OM_PASS_GROUP);
+    CPPUNIT_ASSERT_EQUAL(passes.size(), visitor.passes.size());
+    CPPUNIT_ASSERT_EQUAL(rends.size() - numSkipped, visitor.visits.size());
+    for (size_t i = 0; i < visitor.visits.size(); ++i)
+        CPPUNIT_ASSERT(visitor.visits[i].first != passes[3]);
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortingTests::testPassGroupSameState()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Passes with the same render state only differ by identifier, which must
+    // still keep each pass together
+    MaterialPtr mat = MaterialManager::getSingleton().create(
+        "RenderQueueSortingTestsSameState", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    std::vector<Pass*> passes;
+    for (size_t p = 0; p < 5000; ++p)
+    {
+        Pass* pass = mat->createTechnique()->createPass();
+        pass->_recalculateHash();
+        passes.push_back(pass);
+    }
+    CPPUNIT_ASSERT_EQUAL(passes[0]->getRenderStateKey(), passes[4999]->getRenderStateKey());
+
+    // Both the stable sort and the radix sort
+    const size_t counts[] = { 1000, 10000 };
+    for (size_t c = 0; c < 2; ++c)
+    {
+        std::vector<SortingTestRenderable> rends(counts[c]);
+        QueuedRenderableCollection collection;
+        collection.addOrganisationMode(QueuedRenderableCollection::OM_PASS_GROUP);
+        for (size_t r = 0; r < rends.size(); ++r)
+        {
+            rends[r].depth = static_cast<Real>(rand() % 100);
+            collection.addRenderable(passes[rand() % passes.size()], &rends[r]);
+        }
+        collection.sort(0);
+
+        RecordingVisitor visitor;
+        collection.acceptVisitor(&visitor, QueuedRenderableCollection::OM_PASS_GROUP);
+        checkPassGroupOrder(visitor, rends.size());
+    }
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortingTests::testCustomHashFunction()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    ReverseIdHashFunc hashFunc;
+    Pass::setHashFunction(&hashFunc);
+
+    std::vector<Pass*> passes;
+    createTestPasses(passes, 12);
+
+    std::vector<SortingTestRenderable> rends(500);
+    QueuedRenderableCollection collection;
+    collection.addOrganisationMode(QueuedRenderableCollection::OM_PASS_GROUP);
+    for (size_t r = 0; r < rends.size(); ++r)
+        collection.addRenderable(passes[rand() % passes.size()], &rends[r]);
+    collection.sort(0);
+
+    // Passes come in the order of the custom hash, most recently created first
+    RecordingVisitor visitor;
+    collection.acceptVisitor(&visitor, QueuedRenderableCollection::OM_PASS_GROUP);
+    CPPUNIT_ASSERT_EQUAL(passes.size(), visitor.passes.size());
+    for (size_t i = 1; i < visitor.passes.size(); ++i)
+        CPPUNIT_ASSERT(visitor.passes[i - 1]->getId() > visitor.passes[i]->getId());
+
+    Pass::setHashFunction(Pass::MIN_TEXTURE_CHANGE);
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortingTests::testRedundantPassSkip()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    MaterialPtr mat = MaterialManager::getSingleton().create(
+        "RenderQueueSortingTestsTransparent", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    Technique* tech = mat->createTechnique();
+    Pass* glass = tech->createPass();
+    glass->setSceneBlending(SBT_TRANSPARENT_ALPHA);
+    glass->setDepthWriteEnabled(false);
+    Pass* smoke = tech->createPass();
+    *smoke = *glass;
+    smoke->setDiffuse(ColourValue(0.5, 0.5, 0.5, 0.5));
+
+    PassCountingRenderSystem renderSystem;
+    PassCountingSceneManager* sceneMgr = OGRE_NEW PassCountingSceneManager();
+    sceneMgr->_setDestinationRenderSystem(&renderSystem);
+
+    // Consecutive transparent objects with the same pass set it once
+    sceneMgr->_setPass(glass);
+    sceneMgr->_setPass(glass);
+    sceneMgr->_setPass(glass);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), renderSystem.passesSet);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), sceneMgr->getRenderStateStats().passChanges);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), sceneMgr->getRenderStateStats().redundantPassChanges);
+
+    // Interleaved passes are all set
+    sceneMgr->_setPass(smoke);
+    sceneMgr->_setPass(glass);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), renderSystem.passesSet);
+
+    // Marking the state dirty sets the pass again
+    sceneMgr->_markRenderStateDirty();
+    sceneMgr->_setPass(glass);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), renderSystem.passesSet);
+
+    // So does changing the pass
+    glass->setDiffuse(ColourValue::Red);
+    sceneMgr->_setPass(glass);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), renderSystem.passesSet);
+    glass->setSceneBlending(SBT_ADD);
+    sceneMgr->_setPass(glass);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), renderSystem.passesSet);
+    sceneMgr->_setPass(glass);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), renderSystem.passesSet);
+
+    // Render object listeners may change the state, so their presence does too
+    sceneMgr->notifyRenderSingleObject(glass);
+    sceneMgr->_setPass(glass);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), renderSystem.passesSet);
+
+    CountingRenderObjectListener listener;
+    sceneMgr->addRenderObjectListener(&listener);
+    sceneMgr->notifyRenderSingleObject(glass);
+    sceneMgr->_setPass(glass);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), listener.count);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), renderSystem.passesSet);
+    sceneMgr->_setPass(glass);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), renderSystem.passesSet);
+    sceneMgr->removeRenderObjectListener(&listener);
+
+    OGRE_DELETE sceneMgr;
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortingTests::testPassGroupTiming()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    std::vector<Pass*> passes;
+    createTestPasses(passes, 50);
+
+    const size_t numRenderables = 20000;
+    const size_t numFrames = 20;
+    std::vector<SortingTestRenderable> rends(numRenderables);
+    std::vector<Pass*> rendPasses(numRenderables);
+    for (size_t r = 0; r < numRenderables; ++r)
+    {
+        rends[r].depth = Math::RangeRandom(1, 1e6);
+        rendPasses[r] = passes[rand() % passes.size()];
+    }
+
+    QueuedRenderableCollection collection;
+    collection.addOrganisationMode(QueuedRenderableCollection::OM_PASS_GROUP);
+    RecordingVisitor visitor;
+    BenchmarkLog log("RenderQueueSortingTests", "pass grouped queue of " +
+        StringConverter::toString(numRenderables) + " renderables and " +
+        StringConverter::toString(passes.size()) + " passes");
+    for (size_t f = 0; f < numFrames; ++f)
+    {
+        collection.clear();
+        for (size_t r = 0; r < numRenderables; ++r)
+            collection.addRenderable(rendPasses[r], &rends[r]);
+        collection.sort(0);
+        visitor.passes.clear();
+        visitor.visits.clear();
+        collection.acceptVisitor(&visitor, QueuedRenderableCollection::OM_PASS_GROUP);
+    }
+    log.time("per frame", numFrames);
+    log.note(StringConverter::toString(visitor.passes.size()) + " pass changes");
+
+    CPPUNIT_ASSERT_EQUAL(numRenderables, visitor.visits.size());
+}
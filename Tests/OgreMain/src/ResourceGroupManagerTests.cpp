@@ -0,0 +1,229 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ResourceGroupManagerTests.h"
+#include "OgreRoot.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreArchiveManager.h"
+#include "OgreFileSystem.h"
+#include "OgreFileSystemLayer.h"
+#include "OgreWorkQueue.h"
+#include "OgreLogManager.h"
+#include "OgreTimer.h"
+#include "Threading/OgreLightweightMutex.h"
+#include "Threading/OgreThreads.h"
+
+#include "UnitTestSuite.h"
+
+#include <fstream>
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(ResourceGroupManagerTests);
+
+//--------------------------------------------------------------------------
+/// Creates file system archives which record how many files are opened at once
+class ConcurrencyTestArchiveFactory : public ArchiveFactory
+{
+public:
+    LightweightMutex mMutex;
+    size_t mOpening;
+    size_t mMaxOpening;
+
+    ConcurrencyTestArchiveFactory() : mOpening(0), mMaxOpening(0) {}
+
+    const String& getType(void) const
+    {
+        static const String type = "ConcurrencyTest";
+        return type;
+    }
+    Archive* createInstance(const String& name, bool readOnly);
+    void destroyInstance(Archive* ptr) { OGRE_DELETE ptr; }
+};
+//--------------------------------------------------------------------------
+class ConcurrencyTestArchive : public FileSystemArchive
+{
+    ConcurrencyTestArchiveFactory* mFactory;
+
+public:
+    ConcurrencyTestArchive(const String& name, bool readOnly, ConcurrencyTestArchiveFactory* factory)
+        : FileSystemArchive(name, factory->getType(), readOnly), mFactory(factory) {}
+
+    DataStreamPtr open(const String& filename, bool readOnly = true)
+    {
+        mFactory->mMutex.lock();
+        mFactory->mMaxOpening = std::max(mFactory->mMaxOpening, ++mFactory->mOpening);
+        mFactory->mMutex.unlock();
+
+        // As slow as a disk, so that the reads overlap
+        Threads::Sleep(2);
+        DataStreamPtr stream = FileSystemArchive::open(filename, readOnly);
+
+        mFactory->mMutex.lock();
+        --mFactory->mOpening;
+        mFactory->mMutex.unlock();
+        return stream;
+    }
+};
+//--------------------------------------------------------------------------
+Archive* ConcurrencyTestArchiveFactory::createInstance(const String& name, bool readOnly)
+{
+    return OGRE_NEW ConcurrencyTestArchive(name, readOnly, this);
+}
+//--------------------------------------------------------------------------
+void ResourceGroupManagerTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+
+    mTestDir = "ResourceGroupManagerTests";
+    FileSystemLayer::createDirectory(mTestDir);
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        mFileNames.push_back("resource" + StringConverter::toString(i) + ".txt");
+        std::ofstream file((mTestDir + "/" + mFileNames.back()).c_str(), std::ios::binary);
+        file << getFileContents(i);
+    }
+
+    ResourceGroupManager::getSingleton().addResourceLocation(mTestDir, "FileSystem",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    mArchiveFactory = OGRE_NEW ConcurrencyTestArchiveFactory();
+    ArchiveManager::getSingleton().addArchiveFactory(mArchiveFactory);
+}
+//--------------------------------------------------------------------------
+void ResourceGroupManagerTests::tearDown()
+{
+    OGRE_DELETE mRoot;
+    OGRE_DELETE mArchiveFactory;
+
+    for (size_t i = 0; i < mFileNames.size(); ++i)
+        FileSystemLayer::removeFile(mTestDir + "/" + mFileNames[i]);
+    FileSystemLayer::removeDirectory(mTestDir);
+    mFileNames.clear();
+}
+//--------------------------------------------------------------------------
+String ResourceGroupManagerTests::getFileContents(size_t index) const
+{
+    // Sizes from a few bytes to several pages
+    StringStream contents;
+    for (size_t i = 0; i < (index % 97) * (index % 13) + 1; ++i)
+        contents << "line " << i << " of resource " << index << "\n";
+    return contents.str();
+}
+//--------------------------------------------------------------------------
+void ResourceGroupManagerTests::testIndexLookup()
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    const String& group = ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME;
+
+    // Every generated file is indexed, names are case sensitive here
+    for (size_t i = 0; i < mFileNames.size(); ++i)
+    {
+        CPPUNIT_ASSERT(rgm.resourceExists(group, mFileNames[i]));
+        CPPUNIT_ASSERT_EQUAL(getFileContents(i), rgm.openResource(mFileNames[i], group)->getAsString());
+    }
+    CPPUNIT_ASSERT(!rgm.resourceExists(group, "resource1000.txt"));
+    CPPUNIT_ASSERT(rgm.findGroupContainingResource(mFileNames[0]) == group);
+
+    const size_t numLookups = 200000;
+    size_t found = 0;
+    Timer timer;
+    for (size_t i = 0; i < numLookups; ++i)
+    {
+        if (rgm.resourceExists(group, mFileNames[i % mFileNames.size()]))
+            ++found;
+    }
+    const unsigned long elapsed = timer.getMicroseconds();
+    CPPUNIT_ASSERT_EQUAL(numLookups, found);
+
+    LogManager::getSingleton().stream() << "ResourceGroupManagerTests: " << numLookups
+        << " lookups in an index of " << mFileNames.size() << " resources took "
+        << elapsed / 1000.0f << " ms";
+}
+//--------------------------------------------------------------------------
+void ResourceGroupManagerTests::testPrefetchResources()
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    const String& group = ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME;
+
+    Timer timer;
+    for (size_t i = 0; i < mFileNames.size(); ++i)
+        rgm.openResource(mFileNames[i], group)->getAsString();
+    const unsigned long openTime = timer.getMicroseconds();
+
+    // Unknown names are skipped
+    StringVector names = mFileNames;
+    names.push_back("missing.txt");
+
+    timer.reset();
+    rgm.prefetchResources(names, group);
+    const unsigned long prefetchTime = timer.getMicroseconds();
+    StringVector contents(mFileNames.size());
+    timer.reset();
+    for (size_t i = 0; i < mFileNames.size(); ++i)
+        contents[i] = rgm.openResource(mFileNames[i], group)->getAsString();
+    const unsigned long prefetchedOpenTime = timer.getMicroseconds();
+    for (size_t i = 0; i < mFileNames.size(); ++i)
+        CPPUNIT_ASSERT_EQUAL(getFileContents(i), contents[i]);
+
+    // Handed out once, then opened as usual
+    CPPUNIT_ASSERT_EQUAL(getFileContents(5), rgm.openResource(mFileNames[5], group)->getAsString());
+
+    // Released on request and with the group contents
+    rgm.prefetchResources(names, group);
+    rgm.clearPrefetchedResources(group);
+    rgm.prefetchResources(names, group);
+    rgm.clearResourceGroup(group);
+    CPPUNIT_ASSERT_EQUAL(getFileContents(7), rgm.openResource(mFileNames[7], group)->getAsString());
+
+    LogManager::getSingleton().stream() << "ResourceGroupManagerTests: reading "
+        << mFileNames.size() << " resources took " << openTime / 1000.0f
+        << " ms, prefetching them " << prefetchTime / 1000.0f << " ms and reading them then "
+        << prefetchedOpenTime / 1000.0f << " ms";
+}
+//--------------------------------------------------------------------------
+void ResourceGroupManagerTests::testPrefetchConcurrency()
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    const String group = "Concurrency";
+    rgm.createResourceGroup(group);
+    // Another name, archives are shared by name
+    rgm.addResourceLocation("./" + mTestDir, mArchiveFactory->getType(), group);
+
+    // The default work queue of Root has no task scheduler
+    CPPUNIT_ASSERT(!Root::getSingleton().getWorkQueue()->getTaskScheduler());
+
+    StringVector names(mFileNames.begin(), mFileNames.begin() + 64);
+    rgm.prefetchResources(names, group);
+    CPPUNIT_ASSERT(mArchiveFactory->mMaxOpening > 1);
+
+    for (size_t i = 0; i < names.size(); ++i)
+        CPPUNIT_ASSERT_EQUAL(getFileContents(i), rgm.openResource(names[i], group)->getAsString());
+}
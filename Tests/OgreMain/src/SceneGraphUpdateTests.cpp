@@ -0,0 +1,248 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "SceneGraphUpdateTests.h"
+#include "OgreRoot.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreMovableObject.h"
+#include "OgreMath.h"
+#include "OgreStringConverter.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(SceneGraphUpdateTests);
+
+//--------------------------------------------------------------------------
+static const size_t NUM_NODES = 2000;
+//--------------------------------------------------------------------------
+static String nodeName(size_t i)
+{
+    return "Node" + StringConverter::toString(i);
+}
+//--------------------------------------------------------------------------
+static void randomiseTransform(SceneNode* node)
+{
+    node->setPosition(Math::RangeRandom(-100, 100), Math::RangeRandom(-100, 100), Math::RangeRandom(-100, 100));
+    node->setOrientation(Quaternion(Radian(Math::RangeRandom(-Math::PI, Math::PI)),
+        Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(), Math::SymmetricRandom()).normalisedCopy()));
+    node->setScale(Math::RangeRandom(0.5, 2), Math::RangeRandom(0.5, 2), Math::RangeRandom(0.5, 2));
+}
+//--------------------------------------------------------------------------
+static void buildScene(SceneManager* sceneMgr)
+{
+    srand(0);
+    for (size_t i = 0; i < NUM_NODES; ++i)
+    {
+        // Attach to one of the previous nodes, favouring recent ones to get deep trees
+        SceneNode* parent = sceneMgr->getRootSceneNode();
+        if (i > 0 && Math::UnitRandom() < 0.9)
+            parent = sceneMgr->getSceneNode(nodeName(i - 1 - rand() % std::min<size_t>(i, 8)));
+
+        SceneNode* node = parent->createChildSceneNode(nodeName(i));
+        randomiseTransform(node);
+        node->setInheritOrientation(Math::UnitRandom() < 0.8);
+        node->setInheritScale(Math::UnitRandom() < 0.8);
+    }
+}
+//--------------------------------------------------------------------------
+static void moveNodes(SceneManager* sceneMgr, unsigned int seed)
+{
+    srand(seed);
+    for (size_t i = 0; i < NUM_NODES / 10; ++i)
+    {
+        randomiseTransform(sceneMgr->getSceneNode(nodeName(rand() % NUM_NODES)));
+    }
+}
+//--------------------------------------------------------------------------
+static void reparentNodes(SceneManager* sceneMgr, unsigned int seed)
+{
+    srand(seed);
+    for (size_t i = 0; i < NUM_NODES / 100; ++i)
+    {
+        // Only move a node under a node created before it, to avoid cycles
+        const size_t index = 1 + rand() % (NUM_NODES - 1);
+        SceneNode* node = sceneMgr->getSceneNode(nodeName(index));
+        SceneNode* parent = sceneMgr->getSceneNode(nodeName(rand() % index));
+        if (node->getParent() != parent)
+        {
+            node->getParent()->removeChild(node);
+            parent->addChild(node);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+/// Object with fixed bounds which records when it is queued for rendering
+class QueueRecorder : public MovableObject
+{
+public:
+    QueueRecorder(const String& name, StringVector* queued)
+        : MovableObject(name), mQueued(queued), mBox(-1, -1, -1, 1, 1, 1) {}
+
+    const String& getMovableType(void) const
+    {
+        static const String type = "QueueRecorder";
+        return type;
+    }
+    const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+    Real getBoundingRadius(void) const { return Math::Sqrt(3); }
+    void _updateRenderQueue(RenderQueue* queue) { mQueued->push_back(getName()); }
+    void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables) {}
+
+protected:
+    StringVector* mQueued;
+    AxisAlignedBox mBox;
+};
+//--------------------------------------------------------------------------
+static void checkSameTransforms(SceneManager* expected, SceneManager* actual)
+{
+    for (size_t i = 0; i < NUM_NODES; ++i)
+    {
+        SceneNode* expectedNode = expected->getSceneNode(nodeName(i));
+        SceneNode* actualNode = actual->getSceneNode(nodeName(i));
+        if (!expectedNode->isInSceneGraph())
+            continue;
+
+        // Results must match exactly, not only within a tolerance
+        CPPUNIT_ASSERT(expectedNode->_getDerivedPosition() == actualNode->_getDerivedPosition());
+        CPPUNIT_ASSERT(expectedNode->_getDerivedOrientation() == actualNode->_getDerivedOrientation());
+        CPPUNIT_ASSERT(expectedNode->_getDerivedScale() == actualNode->_getDerivedScale());
+    }
+}
+//--------------------------------------------------------------------------
+void SceneGraphUpdateTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    // Cameras need a buffer manager, there is no render system
+    mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+    mRecursiveSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+    mParallelSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+    mParallelSceneMgr->setParallelSceneGraphUpdate(true);
+    mParallelSceneMgr->setNumWorkerThreads(4);
+
+    buildScene(mRecursiveSceneMgr);
+    buildScene(mParallelSceneMgr);
+}
+//--------------------------------------------------------------------------
+void SceneGraphUpdateTests::tearDown()
+{
+    OGRE_DELETE mRoot;
+    OGRE_DELETE mBufMgr;
+}
+//--------------------------------------------------------------------------
+void SceneGraphUpdateTests::testParallelMatchesRecursive()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    for (unsigned int frame = 0; frame < 10; ++frame)
+    {
+        mRecursiveSceneMgr->_updateSceneGraph(0);
+        mParallelSceneMgr->_updateSceneGraph(0);
+        checkSameTransforms(mRecursiveSceneMgr, mParallelSceneMgr);
+
+        moveNodes(mRecursiveSceneMgr, frame);
+        moveNodes(mParallelSceneMgr, frame);
+    }
+}
+//--------------------------------------------------------------------------
+void SceneGraphUpdateTests::testParallelStructureChanges()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    for (unsigned int frame = 0; frame < 10; ++frame)
+    {
+        mRecursiveSceneMgr->_updateSceneGraph(0);
+        mParallelSceneMgr->_updateSceneGraph(0);
+        checkSameTransforms(mRecursiveSceneMgr, mParallelSceneMgr);
+
+        reparentNodes(mRecursiveSceneMgr, frame);
+        reparentNodes(mParallelSceneMgr, frame);
+        moveNodes(mRecursiveSceneMgr, frame);
+        moveNodes(mParallelSceneMgr, frame);
+    }
+}
+//--------------------------------------------------------------------------
+void SceneGraphUpdateTests::testParallelFrustumCulling()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    mParallelSceneMgr->setParallelFrustumCulling(true);
+
+    StringVector expected, actual;
+    vector<QueueRecorder*>::type objects;
+    for (size_t i = 0; i < NUM_NODES; ++i)
+    {
+        objects.push_back(OGRE_NEW QueueRecorder(nodeName(i), &expected));
+        mRecursiveSceneMgr->getSceneNode(nodeName(i))->attachObject(objects.back());
+        objects.push_back(OGRE_NEW QueueRecorder(nodeName(i), &actual));
+        mParallelSceneMgr->getSceneNode(nodeName(i))->attachObject(objects.back());
+    }
+
+    Camera* recursiveCamera = mRecursiveSceneMgr->createCamera("Camera");
+    Camera* parallelCamera = mParallelSceneMgr->createCamera("Camera");
+
+    for (unsigned int frame = 0; frame < 10; ++frame)
+    {
+        mRecursiveSceneMgr->_updateSceneGraph(recursiveCamera);
+        mParallelSceneMgr->_updateSceneGraph(parallelCamera);
+
+        srand(frame);
+        const Vector3 position(Math::RangeRandom(-200, 200), Math::RangeRandom(-200, 200), Math::RangeRandom(-200, 200));
+        const Vector3 target(Math::RangeRandom(-200, 200), Math::RangeRandom(-200, 200), Math::RangeRandom(-200, 200));
+        recursiveCamera->setPosition(position);
+        recursiveCamera->lookAt(target);
+        parallelCamera->setPosition(position);
+        parallelCamera->lookAt(target);
+
+        expected.clear();
+        actual.clear();
+        mRecursiveSceneMgr->_findVisibleObjects(recursiveCamera, 0, false);
+        mParallelSceneMgr->_findVisibleObjects(parallelCamera, 0, false);
+
+        // Same objects, although not necessarily in the same order
+        std::sort(expected.begin(), expected.end());
+        std::sort(actual.begin(), actual.end());
+        CPPUNIT_ASSERT(!expected.empty());
+        CPPUNIT_ASSERT(expected == actual);
+
+        moveNodes(mRecursiveSceneMgr, frame);
+        moveNodes(mParallelSceneMgr, frame);
+    }
+
+    mRecursiveSceneMgr->clearScene();
+    mParallelSceneMgr->clearScene();
+    for (size_t i = 0; i < objects.size(); ++i)
+        OGRE_DELETE objects[i];
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,415 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "SceneQueryTests.h"
+#include "OgreRoot.h"
+#include "OgreSceneManagerEnumerator.h"
+#include "OgreSceneNode.h"
+#include "OgreSceneQuery.h"
+#include "OgreSceneQueryBroadphase.h"
+#include "OgreMovableObject.h"
+#include "OgreLight.h"
+#include "OgreMath.h"
+#include "OgreStringConverter.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(SceneQueryTests);
+OGRE_BENCHMARK_SUITE_REGISTRATION(SceneQueryBenchmarks);
+
+//--------------------------------------------------------------------------
+static const Real WORLD_SIZE = 1000;
+//--------------------------------------------------------------------------
+/// Object with arbitrary bounds, which needs no render system
+class QueryTestObject : public MovableObject
+{
+public:
+    QueryTestObject(const String& name) : MovableObject(name), mRadius(0) {}
+
+    void setBounds(const AxisAlignedBox& box, Real radius)
+    {
+        mBox = box;
+        mRadius = radius;
+        if (mParentNode)
+            mParentNode->needUpdate();
+    }
+
+    const String& getMovableType(void) const { return QueryTestObjectFactory::FACTORY_TYPE_NAME; }
+    const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+    Real getBoundingRadius(void) const { return mRadius; }
+    void _updateRenderQueue(RenderQueue* queue) {}
+    void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables = false) {}
+
+protected:
+    AxisAlignedBox mBox;
+    Real mRadius;
+};
+//--------------------------------------------------------------------------
+String QueryTestObjectFactory::FACTORY_TYPE_NAME = "QueryTestObject";
+//--------------------------------------------------------------------------
+MovableObject* QueryTestObjectFactory::createInstanceImpl(const String& name,
+    const NameValuePairList* params)
+{
+    return OGRE_NEW QueryTestObject(name);
+}
+//--------------------------------------------------------------------------
+void QueryTestObjectFactory::destroyInstance(MovableObject* obj)
+{
+    OGRE_DELETE obj;
+}
+//--------------------------------------------------------------------------
+typedef vector<String>::type NameList;
+//--------------------------------------------------------------------------
+/// Collects the names of the objects found, sorted
+static NameList getNames(const SceneQueryResult& result)
+{
+    NameList names;
+    for (SceneQueryResultMovableList::const_iterator i = result.movables.begin();
+        i != result.movables.end(); ++i)
+    {
+        names.push_back((*i)->getName());
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+//--------------------------------------------------------------------------
+static NameList getNames(const RaySceneQueryResult& result)
+{
+    NameList names;
+    for (RaySceneQueryResult::const_iterator i = result.begin(); i != result.end(); ++i)
+    {
+        names.push_back(i->movable->getName() + " " + StringConverter::toString(i->distance));
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+//--------------------------------------------------------------------------
+static NameList getNames(const IntersectionSceneQueryResult& result)
+{
+    NameList names;
+    for (SceneQueryMovableIntersectionList::const_iterator i = result.movables2movables.begin();
+        i != result.movables2movables.end(); ++i)
+    {
+        const String& first = i->first->getName();
+        const String& second = i->second->getName();
+        names.push_back(first < second ? first + " " + second : second + " " + first);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+//--------------------------------------------------------------------------
+static Vector3 randomPosition(Real size)
+{
+    return Vector3(Math::RangeRandom(-size, size),
+        Math::RangeRandom(-size, size), Math::RangeRandom(-size, size));
+}
+//--------------------------------------------------------------------------
+static void randomiseBounds(QueryTestObject* obj)
+{
+    const Vector3 halfSize(Math::RangeRandom(1, 30), Math::RangeRandom(1, 30), Math::RangeRandom(1, 30));
+    obj->setBounds(AxisAlignedBox(-halfSize, halfSize), halfSize.length());
+}
+//--------------------------------------------------------------------------
+static void createObject(SceneManager* sceneMgr, size_t index)
+{
+    const String name = "Object" + StringConverter::toString(index);
+    MovableObject* obj;
+    if (Math::UnitRandom() < 0.1)
+    {
+        obj = sceneMgr->createLight(name);
+    }
+    else
+    {
+        QueryTestObject* testObj = static_cast<QueryTestObject*>(
+            sceneMgr->createMovableObject(name, QueryTestObjectFactory::FACTORY_TYPE_NAME));
+        randomiseBounds(testObj);
+        obj = testObj;
+    }
+    obj->setQueryFlags(Math::UnitRandom() < 0.8 ? 0x1 : 0x2);
+
+    // Some objects below a moving parent, a few left out of the scene
+    SceneNode* root = sceneMgr->getRootSceneNode();
+    const Real placement = Math::UnitRandom();
+    if (placement < 0.05)
+        return;
+    SceneNode* parent = root;
+    if (placement < 0.2 && root->numChildren() > 0)
+        parent = static_cast<SceneNode*>(root->getChild(rand() % root->numChildren()));
+    // Named, so both scenes list the children in the same order
+    SceneNode* node = parent->createChildSceneNode("Node" + StringConverter::toString(index),
+        randomPosition(parent == root ? WORLD_SIZE : 50));
+    node->setScale(Vector3::UNIT_SCALE * Math::RangeRandom(0.5, 2));
+    node->attachObject(obj);
+}
+//--------------------------------------------------------------------------
+static void buildScene(SceneManager* sceneMgr, size_t numObjects, unsigned int seed)
+{
+    srand(seed);
+    for (size_t i = 0; i < numObjects; ++i)
+    {
+        createObject(sceneMgr, i);
+    }
+    sceneMgr->getRootSceneNode()->_update(true, false);
+}
+//--------------------------------------------------------------------------
+/// Applies the same random changes to a scene
+static void changeScene(SceneManager* sceneMgr, size_t numObjects, unsigned int seed)
+{
+    srand(seed);
+    for (size_t i = 0; i < numObjects / 4; ++i)
+    {
+        const String name = "Object" + StringConverter::toString(rand() % numObjects);
+        const Real change = Math::UnitRandom();
+        if (sceneMgr->hasMovableObject(name, QueryTestObjectFactory::FACTORY_TYPE_NAME))
+        {
+            QueryTestObject* obj = static_cast<QueryTestObject*>(
+                sceneMgr->getMovableObject(name, QueryTestObjectFactory::FACTORY_TYPE_NAME));
+            SceneNode* node = obj->getParentSceneNode();
+            if (change < 0.6 && node)
+                node->translate(randomPosition(change < 0.5 ? 10 : WORLD_SIZE));
+            else if (change < 0.8)
+                randomiseBounds(obj);
+            else if (change < 0.9 && node)
+                node->detachObject(obj);
+            else
+                sceneMgr->destroyMovableObject(obj);
+        }
+        else if (!sceneMgr->hasLight(name))
+        {
+            createObject(sceneMgr, numObjects * seed + i);
+        }
+    }
+    sceneMgr->getRootSceneNode()->_update(true, false);
+}
+//--------------------------------------------------------------------------
+/// Runs random queries of every kind
+static void runQueries(SceneManager* sceneMgr, size_t numQueries,
+    unsigned int seed, vector<NameList>::type& results)
+{
+    srand(seed);
+    results.clear();
+
+    AxisAlignedBoxSceneQuery* boxQuery = sceneMgr->createAABBQuery(AxisAlignedBox());
+    SphereSceneQuery* sphereQuery = sceneMgr->createSphereQuery(Sphere());
+    RaySceneQuery* rayQuery = sceneMgr->createRayQuery(Ray());
+    PlaneBoundedVolumeListSceneQuery* volumeQuery =
+        sceneMgr->createPlaneBoundedVolumeQuery(PlaneBoundedVolumeList());
+
+    for (size_t i = 0; i < numQueries; ++i)
+    {
+        const uint32 mask = Math::UnitRandom() < 0.8 ? 0xFFFFFFFF : 0x2;
+        const uint32 typeMask = Math::UnitRandom() < 0.8 ? 0xFFFFFFFF : SceneManager::LIGHT_TYPE_MASK;
+        const Vector3 centre = randomPosition(WORLD_SIZE);
+        const Vector3 halfSize(Math::RangeRandom(1, 100), Math::RangeRandom(1, 100), Math::RangeRandom(1, 100));
+
+        boxQuery->setBox(AxisAlignedBox(centre - halfSize, centre + halfSize));
+        boxQuery->setQueryMask(mask);
+        boxQuery->setQueryTypeMask(typeMask);
+        results.push_back(getNames(boxQuery->execute()));
+
+        sphereQuery->setSphere(Sphere(centre, halfSize.x));
+        sphereQuery->setQueryMask(mask);
+        sphereQuery->setQueryTypeMask(typeMask);
+        results.push_back(getNames(sphereQuery->execute()));
+
+        const Vector3 direction = randomPosition(1).normalisedCopy();
+        rayQuery->setRay(Ray(centre - direction * WORLD_SIZE, direction));
+        rayQuery->setQueryMask(mask);
+        rayQuery->setQueryTypeMask(typeMask);
+        results.push_back(getNames(rayQuery->execute()));
+
+        // A box made of planes facing inwards
+        PlaneBoundedVolume volume(Plane::NEGATIVE_SIDE);
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            Vector3 normal = Vector3::ZERO;
+            normal[axis] = 1;
+            volume.planes.push_back(Plane(normal, centre - halfSize));
+            volume.planes.push_back(Plane(-normal, centre + halfSize));
+        }
+        PlaneBoundedVolumeList volumes;
+        volumes.push_back(volume);
+        volumeQuery->setVolumes(volumes);
+        volumeQuery->setQueryMask(mask);
+        volumeQuery->setQueryTypeMask(typeMask);
+        results.push_back(getNames(volumeQuery->execute()));
+    }
+
+    sceneMgr->destroyQuery(boxQuery);
+    sceneMgr->destroyQuery(sphereQuery);
+    sceneMgr->destroyQuery(rayQuery);
+    sceneMgr->destroyQuery(volumeQuery);
+}
+//--------------------------------------------------------------------------
+static void runIntersectionQuery(SceneManager* sceneMgr, uint32 mask, NameList& result)
+{
+    IntersectionSceneQuery* query = sceneMgr->createIntersectionQuery(mask);
+    result = getNames(query->execute());
+    sceneMgr->destroyQuery(query);
+}
+//--------------------------------------------------------------------------
+/// Compares the queries of a scene using the broadphase with those of the same scene without it
+static void checkSameResults(SceneManager* linearMgr, SceneManager* broadphaseMgr,
+    unsigned int seed)
+{
+    vector<NameList>::type expected, actual;
+    runQueries(linearMgr, 100, seed, expected);
+    runQueries(broadphaseMgr, 100, seed, actual);
+    CPPUNIT_ASSERT_EQUAL(expected.size(), actual.size());
+    size_t found = 0;
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        CPPUNIT_ASSERT(expected[i] == actual[i]);
+        found += expected[i].size();
+    }
+    CPPUNIT_ASSERT(found > 0);
+
+    const uint32 masks[] = { 0xFFFFFFFF, 0x2 };
+    for (size_t m = 0; m < 2; ++m)
+    {
+        NameList expectedPairs, actualPairs;
+        runIntersectionQuery(linearMgr, masks[m], expectedPairs);
+        runIntersectionQuery(broadphaseMgr, masks[m], actualPairs);
+        CPPUNIT_ASSERT(expectedPairs == actualPairs);
+    }
+}
+//--------------------------------------------------------------------------
+void SceneQueryTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+    mFactory = OGRE_NEW QueryTestObjectFactory();
+    mRoot->addMovableObjectFactory(mFactory);
+}
+//--------------------------------------------------------------------------
+void SceneQueryTests::tearDown()
+{
+    OGRE_DELETE mRoot;
+    OGRE_DELETE mFactory;
+}
+//--------------------------------------------------------------------------
+void SceneQueryTests::testBroadphaseMatchesLinearScan()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t objectCounts[] = { 10, 100, 2000 };
+    for (size_t c = 0; c < sizeof(objectCounts) / sizeof(objectCounts[0]); ++c)
+    {
+        SceneManager* linearMgr = OGRE_NEW DefaultSceneManager("Linear");
+        linearMgr->setUseSceneQueryBroadphase(false);
+        buildScene(linearMgr, objectCounts[c], 0);
+        SceneManager* broadphaseMgr = OGRE_NEW DefaultSceneManager("Broadphase");
+        buildScene(broadphaseMgr, objectCounts[c], 0);
+
+        checkSameResults(linearMgr, broadphaseMgr, 1);
+
+        SceneQueryBroadphase* broadphase = broadphaseMgr->_getSceneQueryBroadphase();
+        CPPUNIT_ASSERT(broadphase);
+        CPPUNIT_ASSERT_EQUAL(objectCounts[c], broadphase->getNumObjects());
+        CPPUNIT_ASSERT(!linearMgr->_getSceneQueryBroadphase());
+
+        OGRE_DELETE linearMgr;
+        OGRE_DELETE broadphaseMgr;
+    }
+}
+//--------------------------------------------------------------------------
+void SceneQueryTests::testBroadphaseAfterSceneChanges()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t numObjects = 1000;
+    SceneManager* linearMgr = OGRE_NEW DefaultSceneManager("Linear");
+    linearMgr->setUseSceneQueryBroadphase(false);
+    buildScene(linearMgr, numObjects, 0);
+    SceneManager* broadphaseMgr = OGRE_NEW DefaultSceneManager("Broadphase");
+    buildScene(broadphaseMgr, numObjects, 0);
+
+    for (unsigned int frame = 0; frame < 10; ++frame)
+    {
+        // Move, resize, detach, destroy and create objects, the tree must follow
+        changeScene(linearMgr, numObjects, frame + 10);
+        changeScene(broadphaseMgr, numObjects, frame + 10);
+        checkSameResults(linearMgr, broadphaseMgr, frame + 100);
+    }
+
+    // Balanced despite the changes
+    SceneQueryBroadphase* broadphase = broadphaseMgr->_getSceneQueryBroadphase();
+    CPPUNIT_ASSERT(broadphase->getHeight() < 40);
+
+    // Destroyed with the objects
+    broadphaseMgr->clearScene();
+    CPPUNIT_ASSERT_EQUAL((size_t)0, broadphase->getNumObjects());
+
+    OGRE_DELETE linearMgr;
+    OGRE_DELETE broadphaseMgr;
+}
+//--------------------------------------------------------------------------
+void SceneQueryTests::testQueryTiming()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t numObjects = 10000;
+    const size_t numQueries = 250;
+    SceneManager* sceneMgr = OGRE_NEW DefaultSceneManager("SceneQueryTiming");
+    buildScene(sceneMgr, numObjects, 0);
+
+    vector<NameList>::type expected, actual;
+    NameList expectedPairs, actualPairs;
+    BenchmarkLog log("SceneQueryTests", StringConverter::toString(numObjects) + " objects, " +
+        StringConverter::toString(numQueries) + " box, sphere, ray and volume queries");
+    sceneMgr->setUseSceneQueryBroadphase(false);
+    log.restart();
+    runQueries(sceneMgr, numQueries, 1, expected);
+    log.time("linear scan");
+    runIntersectionQuery(sceneMgr, 0xFFFFFFFF, expectedPairs);
+    log.time("intersection query by linear scan");
+
+    sceneMgr->setUseSceneQueryBroadphase(true);
+    log.restart();
+    sceneMgr->_updateSceneQueryBroadphase();
+    log.time("building the tree");
+    runQueries(sceneMgr, numQueries, 1, actual);
+    log.time("broadphase");
+    runIntersectionQuery(sceneMgr, 0xFFFFFFFF, actualPairs);
+    log.time("intersection query by broadphase");
+
+    // Refitting after a frame moving a quarter of the objects
+    changeScene(sceneMgr, numObjects, 2);
+    log.restart();
+    sceneMgr->_updateSceneQueryBroadphase();
+    log.time("refitting");
+    log.note("height " + StringConverter::toString(sceneMgr->_getSceneQueryBroadphase()->getHeight()));
+
+    CPPUNIT_ASSERT(expected == actual);
+    CPPUNIT_ASSERT(!expectedPairs.empty());
+    CPPUNIT_ASSERT(expectedPairs == actualPairs);
+    OGRE_DELETE sceneMgr;
+}
@@ -0,0 +1,250 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ScriptParsingTests.h"
+#include "OgreRoot.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreMaterialSerializer.h"
+#include "OgreScriptCompiler.h"
+#include "OgreFileSystemLayer.h"
+#include "OgreLogManager.h"
+#include "OgreTimer.h"
+
+#include "UnitTestSuite.h"
+
+#include <fstream>
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(ScriptParsingTests);
+
+// Number of materials in each generated script
+#define MATERIALS_PER_SCRIPT 8
+
+//--------------------------------------------------------------------------
+/// Collects the errors reported by the script compiler
+class ScriptErrorCollector : public LogListener
+{
+public:
+    StringVector* errors;
+
+    void messageLogged(const String& message, LogMessageLevel lml, bool maskDebug,
+                       const String& logName, bool& skipThisMessage)
+    {
+        if (StringUtil::startsWith(message, "Compiler error", false))
+            errors->push_back(message);
+    }
+};
+//--------------------------------------------------------------------------
+static String getMaterialName(size_t script, size_t material)
+{
+    return "ScriptParsingTests/" + StringConverter::toString(script) + "_" +
+        StringConverter::toString(material);
+}
+//--------------------------------------------------------------------------
+void ScriptParsingTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+
+    mNumScripts = 128;
+    mScriptDir = "ScriptParsingTests";
+    FileSystemLayer::createDirectory(mScriptDir);
+
+    writeCommonScript("0.5 0.5 0.5");
+
+    for (size_t i = 0; i < mNumScripts; ++i)
+    {
+        std::ofstream script((mScriptDir + "/script" + StringConverter::toString(i) + ".material").c_str());
+        script << "import ScriptParsingTests/base from \"common.material.inc\"\n"
+            "set $texture \"texture" << i << ".png\"\n";
+        // Errors found while building the tree and while translating it
+        if (i % 37 == 5)
+            script << "unknown_object ScriptParsingTests/unknown" << i << " { }\n";
+        if (i % 41 == 7)
+            script << "material ScriptParsingTests/invalid" << i << " { technique { pass { ambient red } } }\n";
+
+        for (size_t m = 0; m < MATERIALS_PER_SCRIPT; ++m)
+        {
+            script << "material " << getMaterialName(i, m) << " : ScriptParsingTests/base\n"
+                "{\n"
+                "    set $diffuse \"" << (m + 1) / Real(MATERIALS_PER_SCRIPT) << " 0.25 " << i / Real(mNumScripts) << "\"\n"
+                "    set $bias \"" << m << "\"\n"
+                "    technique\n"
+                "    {\n"
+                "        pass\n"
+                "        {\n"
+                "            scene_blend alpha_blend\n"
+                "            texture_unit\n"
+                "            {\n"
+                "                texture $texture\n"
+                "                tex_address_mode clamp\n"
+                "                scroll_anim 0." << m << " 0\n"
+                "            }\n"
+                "        }\n"
+                "    }\n"
+                "}\n";
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void ScriptParsingTests::tearDown()
+{
+    for (size_t i = 0; i < mNumScripts; ++i)
+        FileSystemLayer::removeFile(mScriptDir + "/script" + StringConverter::toString(i) + ".material");
+    FileSystemLayer::removeFile(mScriptDir + "/common.material.inc");
+    FileSystemLayer::removeFile("ScriptParsingTests.cache");
+    FileSystemLayer::removeDirectory(mScriptDir);
+
+    OGRE_DELETE mRoot;
+}
+//--------------------------------------------------------------------------
+void ScriptParsingTests::writeCommonScript(const String& ambient)
+{
+    std::ofstream common((mScriptDir + "/common.material.inc").c_str());
+    common << "abstract material ScriptParsingTests/base\n"
+        "{\n"
+        "    technique\n"
+        "    {\n"
+        "        pass\n"
+        "        {\n"
+        "            ambient " << ambient << "\n"
+        "            diffuse $diffuse\n"
+        "            depth_bias 1 $bias\n"
+        "        }\n"
+        "    }\n"
+        "}\n";
+}
+//--------------------------------------------------------------------------
+String ScriptParsingTests::parseScripts(size_t numThreads, StringVector& errors)
+{
+    const String group = "ScriptParsingTests";
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    rgm.createResourceGroup(group);
+    rgm.addResourceLocation(mScriptDir, "FileSystem", group);
+    rgm.setNumScriptParsingThreads(numThreads);
+
+    ScriptErrorCollector collector;
+    collector.errors = &errors;
+    Log* log = LogManager::getSingleton().getDefaultLog();
+    log->addListener(&collector);
+
+    Timer timer;
+    rgm.initialiseResourceGroup(group);
+    const unsigned long elapsed = timer.getMicroseconds();
+
+    log->removeListener(&collector);
+    rgm.setNumScriptParsingThreads(1);
+
+    LogManager::getSingleton().stream() << "ScriptParsingTests: parsed " << mNumScripts
+        << " scripts with " << numThreads << " threads"
+        << (ScriptCompilerManager::getSingleton().getScriptCacheEnabled() ? " and the script cache" : "")
+        << " in " << elapsed / 1000.0f << " ms";
+
+    MaterialSerializer serializer;
+    for (size_t i = 0; i < mNumScripts; ++i)
+    {
+        for (size_t m = 0; m < MATERIALS_PER_SCRIPT; ++m)
+        {
+            MaterialPtr material = MaterialManager::getSingleton().getByName(getMaterialName(i, m), group);
+            CPPUNIT_ASSERT(!material.isNull());
+            serializer.queueForExport(material);
+        }
+    }
+
+    rgm.destroyResourceGroup(group);
+    return serializer.getQueuedAsString();
+}
+//--------------------------------------------------------------------------
+void ScriptParsingTests::testParallelMatchesSerial()
+{
+    StringVector serialErrors;
+    String serial = parseScripts(1, serialErrors);
+
+    // The generated scripts parsed as expected
+    CPPUNIT_ASSERT(serial.find("texture" + StringConverter::toString(mNumScripts - 1) + ".png") != String::npos);
+    CPPUNIT_ASSERT(serial.find("$") == String::npos);
+    CPPUNIT_ASSERT_EQUAL(size_t(7), serialErrors.size());
+
+    StringVector parallelErrors;
+    String parallel = parseScripts(4, parallelErrors);
+
+    CPPUNIT_ASSERT(serial == parallel);
+    CPPUNIT_ASSERT(serialErrors == parallelErrors);
+}
+//--------------------------------------------------------------------------
+void ScriptParsingTests::testScriptCache()
+{
+    ScriptCompilerManager& compilerMgr = ScriptCompilerManager::getSingleton();
+
+    StringVector uncachedErrors;
+    String uncached = parseScripts(1, uncachedErrors);
+
+    // Fill the cache, then save it and load it back
+    compilerMgr.setScriptCacheEnabled(true);
+    StringVector recordedErrors;
+    String recorded = parseScripts(1, recordedErrors);
+    CPPUNIT_ASSERT(compilerMgr.isScriptCacheDirty());
+    {
+        std::fstream* file = OGRE_NEW_T(std::fstream, MEMCATEGORY_GENERAL)();
+        file->open("ScriptParsingTests.cache", std::ios::out | std::ios::binary);
+        DataStreamPtr stream(OGRE_NEW FileStreamDataStream(file));
+        compilerMgr.saveScriptCache(stream);
+    }
+    CPPUNIT_ASSERT(!compilerMgr.isScriptCacheDirty());
+    compilerMgr.clearScriptCache();
+    {
+        std::ifstream* file = OGRE_NEW_T(std::ifstream, MEMCATEGORY_GENERAL)();
+        file->open("ScriptParsingTests.cache", std::ios::in | std::ios::binary);
+        DataStreamPtr stream(OGRE_NEW FileStreamDataStream(file));
+        compilerMgr.loadScriptCache(stream);
+    }
+
+    // Every script comes from the cache, with the same result and errors
+    StringVector cachedErrors;
+    String cached = parseScripts(1, cachedErrors);
+    CPPUNIT_ASSERT(!compilerMgr.isScriptCacheDirty());
+    CPPUNIT_ASSERT(uncached == recorded);
+    CPPUNIT_ASSERT(uncached == cached);
+    CPPUNIT_ASSERT(uncachedErrors == recordedErrors);
+    CPPUNIT_ASSERT(uncachedErrors == cachedErrors);
+
+    // Changing the imported script invalidates the scripts importing it
+    writeCommonScript("0.25 0.25 0.25");
+    StringVector changedErrors;
+    String changed = parseScripts(1, changedErrors);
+    CPPUNIT_ASSERT(compilerMgr.isScriptCacheDirty());
+    CPPUNIT_ASSERT(changed != cached);
+    CPPUNIT_ASSERT(changed.find("ambient 0.25 0.25 0.25") != String::npos);
+    CPPUNIT_ASSERT(changed.find("ambient 0.5 0.5 0.5") == String::npos);
+
+    compilerMgr.setScriptCacheEnabled(false);
+    compilerMgr.clearScriptCache();
+}
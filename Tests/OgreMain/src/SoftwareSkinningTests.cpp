@@ -0,0 +1,193 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "SoftwareSkinningTests.h"
+#include "OgreRoot.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreSoftwareSkinningBatch.h"
+#include "OgreVertexIndexData.h"
+#include "OgreMesh.h"
+#include "OgreMatrix4.h"
+#include "OgreMath.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(SoftwareSkinningTests);
+
+//--------------------------------------------------------------------------
+static const size_t NUM_BONES = 24;
+//--------------------------------------------------------------------------
+/// Positions and normals in one buffer, blend indices and weights in another
+static VertexData* createSourceData(size_t numVertices)
+{
+    VertexData* data = OGRE_NEW VertexData();
+    data->vertexCount = numVertices;
+    VertexDeclaration* decl = data->vertexDeclaration;
+    size_t offset = decl->addElement(0, 0, VET_FLOAT3, VES_POSITION).getSize();
+    decl->addElement(0, offset, VET_FLOAT3, VES_NORMAL);
+    offset = decl->addElement(1, 0, VET_UBYTE4, VES_BLEND_INDICES).getSize();
+    decl->addElement(1, offset, VET_FLOAT3, VES_BLEND_WEIGHTS);
+
+    HardwareVertexBufferSharedPtr posBuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+        decl->getVertexSize(0), numVertices, HardwareBuffer::HBU_STATIC_WRITE_ONLY, true);
+    HardwareVertexBufferSharedPtr blendBuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+        decl->getVertexSize(1), numVertices, HardwareBuffer::HBU_STATIC_WRITE_ONLY, true);
+    data->vertexBufferBinding->setBinding(0, posBuf);
+    data->vertexBufferBinding->setBinding(1, blendBuf);
+
+    float* pos = static_cast<float*>(posBuf->lock(HardwareBuffer::HBL_DISCARD));
+    unsigned char* blend = static_cast<unsigned char*>(blendBuf->lock(HardwareBuffer::HBL_DISCARD));
+    for (size_t v = 0; v < numVertices; ++v)
+    {
+        const Vector3 normal = Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(),
+            Math::SymmetricRandom()).normalisedCopy();
+        for (size_t i = 0; i < 3; ++i)
+        {
+            pos[i] = Math::RangeRandom(-50, 50);
+            pos[3 + i] = normal[i];
+        }
+        pos += 6;
+
+        float* weights = reinterpret_cast<float*>(blend + 4);
+        Real total = 0;
+        for (size_t i = 0; i < 3; ++i)
+        {
+            blend[i] = static_cast<unsigned char>(rand() % NUM_BONES);
+            weights[i] = Math::UnitRandom();
+            total += weights[i];
+        }
+        blend[3] = 0;
+        for (size_t i = 0; i < 3; ++i)
+            weights[i] /= total;
+        blend += 16;
+    }
+    posBuf->unlock();
+    blendBuf->unlock();
+    return data;
+}
+//--------------------------------------------------------------------------
+/// Positions and normals in one buffer, as the temporary blend buffers
+static VertexData* createTargetData(size_t numVertices)
+{
+    VertexData* data = OGRE_NEW VertexData();
+    data->vertexCount = numVertices;
+    size_t offset = data->vertexDeclaration->addElement(0, 0, VET_FLOAT3, VES_POSITION).getSize();
+    data->vertexDeclaration->addElement(0, offset, VET_FLOAT3, VES_NORMAL);
+    data->vertexBufferBinding->setBinding(0, HardwareBufferManager::getSingleton().createVertexBuffer(
+        data->vertexDeclaration->getVertexSize(0), numVertices, HardwareBuffer::HBU_DYNAMIC, true));
+    return data;
+}
+//--------------------------------------------------------------------------
+static void randomiseBones(Matrix4* bones)
+{
+    for (size_t i = 0; i < NUM_BONES; ++i)
+    {
+        Quaternion q(Math::SymmetricRandom(), Math::SymmetricRandom(),
+            Math::SymmetricRandom(), Math::SymmetricRandom());
+        q.normalise();
+        bones[i].makeTransform(Vector3(Math::RangeRandom(-10, 10), Math::RangeRandom(-10, 10),
+            Math::RangeRandom(-10, 10)), Vector3(1, 1, 1) * Math::RangeRandom(0.5, 2), q);
+    }
+}
+//--------------------------------------------------------------------------
+void SoftwareSkinningTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+}
+//--------------------------------------------------------------------------
+void SoftwareSkinningTests::tearDown()
+{
+    OGRE_DELETE mRoot;
+    OGRE_DELETE mBufMgr;
+}
+//--------------------------------------------------------------------------
+void SoftwareSkinningTests::testBatchMatchesVertexBlend()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // A crowd sharing one mesh, each with its own pose
+    srand(0);
+    const size_t numEntities = 200, numVertices = 2501;
+    VertexData* source = createSourceData(numVertices);
+    vector<VertexData*>::type expected(numEntities), actual(numEntities);
+    vector<Matrix4>::type bones(numEntities * NUM_BONES);
+    vector<const Matrix4*>::type blendMatrices(numEntities * NUM_BONES);
+    for (size_t e = 0; e < numEntities; ++e)
+    {
+        expected[e] = createTargetData(numVertices);
+        actual[e] = createTargetData(numVertices);
+        randomiseBones(&bones[e * NUM_BONES]);
+        for (size_t i = 0; i < NUM_BONES; ++i)
+            blendMatrices[e * NUM_BONES + i] = &bones[e * NUM_BONES + i];
+    }
+
+    Timer timer;
+    for (size_t e = 0; e < numEntities; ++e)
+        Mesh::softwareVertexBlend(source, expected[e], &blendMatrices[e * NUM_BONES], NUM_BONES, true);
+    const unsigned long perEntityTime = timer.getMicroseconds();
+
+    // Shares of 3 threads, run one after the other
+    SoftwareSkinningBatch batch;
+    timer.reset();
+    for (size_t e = 0; e < numEntities; ++e)
+        batch.add(source, actual[e], &blendMatrices[e * NUM_BONES], NUM_BONES, true);
+    CPPUNIT_ASSERT_EQUAL(numEntities * numVertices, batch.getNumVertices());
+    for (size_t t = 0; t < 3; ++t)
+        batch.execute(t, 3);
+    batch.finish();
+    const unsigned long batchTime = timer.getMicroseconds();
+    CPPUNIT_ASSERT(batch.empty());
+
+    LogManager::getSingleton().stream() << "SoftwareSkinningTests: " << numEntities
+        << " entities of " << numVertices << " vertices, per entity " << perEntityTime
+        << " us, batched " << batchTime << " us";
+
+    const size_t numFloats = numVertices * 6;
+    for (size_t e = 0; e < numEntities; ++e)
+    {
+        HardwareVertexBufferSharedPtr expectedBuf = expected[e]->vertexBufferBinding->getBuffer(0);
+        HardwareVertexBufferSharedPtr actualBuf = actual[e]->vertexBufferBinding->getBuffer(0);
+        const float* pExpected = static_cast<const float*>(expectedBuf->lock(HardwareBuffer::HBL_READ_ONLY));
+        const float* pActual = static_cast<const float*>(actualBuf->lock(HardwareBuffer::HBL_READ_ONLY));
+        for (size_t i = 0; i < numFloats; ++i)
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(pExpected[i], pActual[i], 1e-4 * (1 + Math::Abs(pExpected[i])));
+        expectedBuf->unlock();
+        actualBuf->unlock();
+
+        OGRE_DELETE expected[e];
+        OGRE_DELETE actual[e];
+    }
+    OGRE_DELETE source;
+}
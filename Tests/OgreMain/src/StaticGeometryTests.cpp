@@ -0,0 +1,358 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "StaticGeometryTests.h"
+#include "OgreRoot.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreSceneManagerEnumerator.h"
+#include "OgreStaticGeometry.h"
+#include "OgreMeshManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreSubMesh.h"
+#include "OgreEntity.h"
+#include "OgreMath.h"
+#include "OgreStringConverter.h"
+#include "Threading/OgreTaskSchedulerWorkQueue.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(StaticGeometryTests);
+OGRE_BENCHMARK_SUITE_REGISTRATION(StaticGeometryBenchmarks);
+
+//--------------------------------------------------------------------------
+static const Real WORLD_SIZE = 3000;
+//--------------------------------------------------------------------------
+/// Two submeshes of random triangles, with positions, normals and texture coordinates
+static MeshPtr createTestMesh(const String& name, size_t numVertices)
+{
+    MeshPtr mesh = MeshManager::getSingleton().createManual(name,
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    for (size_t s = 0; s < 2; ++s)
+    {
+        SubMesh* sm = mesh->createSubMesh();
+        sm->useSharedVertices = false;
+        sm->setMaterialName("BaseWhite");
+
+        VertexData* data = OGRE_NEW VertexData();
+        data->vertexCount = numVertices;
+        VertexDeclaration* decl = data->vertexDeclaration;
+        size_t offset = decl->addElement(0, 0, VET_FLOAT3, VES_POSITION).getSize();
+        offset += decl->addElement(0, offset, VET_FLOAT3, VES_NORMAL).getSize();
+        decl->addElement(0, offset, VET_FLOAT2, VES_TEXTURE_COORDINATES);
+        HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+            decl->getVertexSize(0), numVertices, HardwareBuffer::HBU_STATIC_WRITE_ONLY, true);
+        data->vertexBufferBinding->setBinding(0, vbuf);
+        float* pVert = static_cast<float*>(vbuf->lock(HardwareBuffer::HBL_DISCARD));
+        for (size_t v = 0; v < numVertices; ++v)
+        {
+            const Vector3 normal = Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(),
+                Math::SymmetricRandom()).normalisedCopy();
+            for (size_t i = 0; i < 3; ++i)
+            {
+                pVert[i] = Math::RangeRandom(-10, 10);
+                pVert[3 + i] = normal[i];
+            }
+            pVert[6] = Math::UnitRandom();
+            pVert[7] = Math::UnitRandom();
+            pVert += 8;
+        }
+        vbuf->unlock();
+        sm->vertexData = data;
+
+        // Index a part of the buffer, to check the start offset
+        const size_t numIndexes = numVertices * 3, indexStart = 6;
+        sm->indexData->indexStart = indexStart;
+        sm->indexData->indexCount = numIndexes;
+        sm->indexData->indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+            HardwareIndexBuffer::IT_16BIT, indexStart + numIndexes, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        uint16* pIndex = static_cast<uint16*>(
+            sm->indexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+        for (size_t i = 0; i < indexStart + numIndexes; ++i)
+            pIndex[i] = static_cast<uint16>(rand() % numVertices);
+        sm->indexData->indexBuffer->unlock();
+    }
+    mesh->_setBounds(AxisAlignedBox(-10, -10, -10, 10, 10, 10));
+    mesh->_setBoundingSphereRadius(Math::Sqrt(300));
+    mesh->load();
+    return mesh;
+}
+//--------------------------------------------------------------------------
+/// Instances of an entity, and their transforms
+struct TestInstance
+{
+    Vector3 position;
+    Quaternion orientation;
+    Vector3 scale;
+    StaticGeometry::InstanceID id;
+};
+typedef vector<TestInstance>::type TestInstanceList;
+//--------------------------------------------------------------------------
+static TestInstance randomInstance(void)
+{
+    TestInstance inst;
+    inst.position = Vector3(Math::RangeRandom(-WORLD_SIZE, WORLD_SIZE),
+        Math::RangeRandom(-WORLD_SIZE, WORLD_SIZE), Math::RangeRandom(-WORLD_SIZE, WORLD_SIZE));
+    inst.orientation = Quaternion(Math::SymmetricRandom(), Math::SymmetricRandom(),
+        Math::SymmetricRandom(), Math::SymmetricRandom());
+    inst.orientation.normalise();
+    inst.scale = Vector3(Math::RangeRandom(0.5, 2), Math::RangeRandom(0.5, 2), Math::RangeRandom(0.5, 2));
+    inst.id = 0;
+    return inst;
+}
+//--------------------------------------------------------------------------
+static void addInstance(StaticGeometry* geom, Entity* ent, TestInstance& inst)
+{
+    inst.id = geom->addEntityInstance(ent, inst.position, inst.orientation, inst.scale);
+}
+//--------------------------------------------------------------------------
+typedef map<uint32, vector<float>::type>::type RegionContents;
+//--------------------------------------------------------------------------
+/// Bounds, vertices and indexes of every built region
+static RegionContents getContents(StaticGeometry* geom)
+{
+    RegionContents contents;
+    StaticGeometry::RegionIterator ri = geom->getRegionIterator();
+    while (ri.hasMoreElements())
+    {
+        StaticGeometry::Region* region = ri.getNext();
+        vector<float>::type& values = contents[region->getID()];
+        const AxisAlignedBox& box = region->getBoundingBox();
+        for (size_t i = 0; i < 3; ++i)
+        {
+            values.push_back(box.getMinimum()[i]);
+            values.push_back(box.getMaximum()[i]);
+        }
+        values.push_back(region->getBoundingRadius());
+
+        StaticGeometry::Region::LODIterator li = region->getLODIterator();
+        while (li.hasMoreElements())
+        {
+            StaticGeometry::LODBucket::MaterialIterator mi = li.getNext()->getMaterialIterator();
+            while (mi.hasMoreElements())
+            {
+                StaticGeometry::MaterialBucket::GeometryIterator gi = mi.getNext()->getGeometryIterator();
+                while (gi.hasMoreElements())
+                {
+                    StaticGeometry::GeometryBucket* bucket = gi.getNext();
+                    const VertexData* vdata = bucket->getVertexData();
+                    HardwareVertexBufferSharedPtr vbuf = vdata->vertexBufferBinding->getBuffer(0);
+                    const float* pVert = static_cast<const float*>(vbuf->lock(HardwareBuffer::HBL_READ_ONLY));
+                    values.insert(values.end(), pVert, pVert + vdata->vertexCount * 8);
+                    vbuf->unlock();
+
+                    const IndexData* idata = bucket->getIndexData();
+                    CPPUNIT_ASSERT(idata->indexBuffer->getType() == HardwareIndexBuffer::IT_16BIT);
+                    const uint16* pIndex = static_cast<const uint16*>(
+                        idata->indexBuffer->lock(HardwareBuffer::HBL_READ_ONLY));
+                    values.insert(values.end(), pIndex, pIndex + idata->indexCount);
+                    idata->indexBuffer->unlock();
+                }
+            }
+        }
+    }
+    return contents;
+}
+//--------------------------------------------------------------------------
+/// Total vertices of the built regions
+static size_t getNumVertices(StaticGeometry* geom)
+{
+    size_t numVertices = 0;
+    StaticGeometry::RegionIterator ri = geom->getRegionIterator();
+    while (ri.hasMoreElements())
+    {
+        StaticGeometry::Region::LODIterator li = ri.getNext()->getLODIterator();
+        while (li.hasMoreElements())
+        {
+            StaticGeometry::LODBucket::MaterialIterator mi = li.getNext()->getMaterialIterator();
+            while (mi.hasMoreElements())
+            {
+                StaticGeometry::MaterialBucket::GeometryIterator gi = mi.getNext()->getGeometryIterator();
+                while (gi.hasMoreElements())
+                    numVertices += gi.getNext()->getVertexData()->vertexCount;
+            }
+        }
+    }
+    return numVertices;
+}
+//--------------------------------------------------------------------------
+/// Replaces the default work queue with one providing a task scheduler
+static void useTaskScheduler(Root* root)
+{
+    TaskSchedulerWorkQueue* queue = OGRE_NEW TaskSchedulerWorkQueue("StaticGeometryTests");
+    queue->setWorkerThreadCount(3);
+    root->setWorkQueue(queue);
+    queue->startup();
+}
+//--------------------------------------------------------------------------
+void StaticGeometryTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+    MaterialManager::getSingleton().initialise();
+    // Techniques can't be compiled without a render system
+    MaterialManager::getSingleton().getByName("BaseWhite")->removeAllTechniques();
+    mSceneMgr = OGRE_NEW DefaultSceneManager("StaticGeometryTests");
+}
+//--------------------------------------------------------------------------
+void StaticGeometryTests::tearDown()
+{
+    OGRE_DELETE mSceneMgr;
+    OGRE_DELETE mRoot;
+    OGRE_DELETE mBufMgr;
+}
+//--------------------------------------------------------------------------
+void StaticGeometryTests::testParallelMatchesSerial()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    srand(0);
+    const size_t numVertices = 100, numInstances = 500;
+    Entity* ent = mSceneMgr->createEntity(createTestMesh("StaticGeometryTests", numVertices));
+    StaticGeometry* geom = mSceneMgr->createStaticGeometry("StaticGeometryTests");
+    for (size_t i = 0; i < numInstances; ++i)
+    {
+        TestInstance inst = randomInstance();
+        addInstance(geom, ent, inst);
+    }
+
+    // The default work queue has no task scheduler
+    geom->build();
+    CPPUNIT_ASSERT(geom->isBuilt());
+    const RegionContents expected = getContents(geom);
+    CPPUNIT_ASSERT(expected.size() > 100);
+    CPPUNIT_ASSERT_EQUAL(numInstances * 2 * numVertices, getNumVertices(geom));
+
+    useTaskScheduler(mRoot);
+    geom->build();
+    CPPUNIT_ASSERT(getContents(geom) == expected);
+
+    geom->destroy();
+    CPPUNIT_ASSERT(!geom->isBuilt());
+    CPPUNIT_ASSERT(!geom->getRegionIterator().hasMoreElements());
+}
+//--------------------------------------------------------------------------
+void StaticGeometryTests::testIncrementalUpdate()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    srand(1);
+    const size_t numVertices = 100, numInstances = 500;
+    Entity* ent = mSceneMgr->createEntity(createTestMesh("StaticGeometryTests", numVertices));
+    useTaskScheduler(mRoot);
+
+    // Both geometries get the same changes, only one is built in between
+    StaticGeometry* updated = mSceneMgr->createStaticGeometry("Updated");
+    StaticGeometry* rebuilt = mSceneMgr->createStaticGeometry("Rebuilt");
+    TestInstanceList instances;
+    for (size_t i = 0; i < numInstances; ++i)
+    {
+        TestInstance inst = randomInstance();
+        addInstance(updated, ent, inst);
+        addInstance(rebuilt, ent, inst);
+        instances.push_back(inst);
+    }
+    updated->update();
+    CPPUNIT_ASSERT(updated->isBuilt());
+
+    for (unsigned int round = 0; round < 5; ++round)
+    {
+        // Remove some instances, add others
+        for (size_t i = 0; i < 20; ++i)
+        {
+            size_t index = rand() % instances.size();
+            updated->removeEntity(instances[index].id);
+            rebuilt->removeEntity(instances[index].id);
+            instances.erase(instances.begin() + index);
+        }
+        for (size_t i = 0; i < 30; ++i)
+        {
+            TestInstance inst = randomInstance();
+            addInstance(updated, ent, inst);
+            StaticGeometry::InstanceID id = inst.id;
+            addInstance(rebuilt, ent, inst);
+            CPPUNIT_ASSERT_EQUAL(id, inst.id);
+            instances.push_back(inst);
+        }
+
+        updated->update();
+        rebuilt->build();
+        CPPUNIT_ASSERT(getContents(updated) == getContents(rebuilt));
+        CPPUNIT_ASSERT_EQUAL(instances.size() * 2 * numVertices, getNumVertices(updated));
+    }
+
+    // Regions left empty are destroyed
+    for (size_t i = 0; i < instances.size(); ++i)
+        updated->removeEntity(instances[i].id);
+    updated->update();
+    CPPUNIT_ASSERT(!updated->getRegionIterator().hasMoreElements());
+    CPPUNIT_ASSERT(updated->isBuilt());
+}
+//--------------------------------------------------------------------------
+void StaticGeometryTests::testBuildTiming()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    srand(2);
+    const size_t numVertices = 500, numInstances = 2000, numChanges = 10;
+    Entity* ent = mSceneMgr->createEntity(createTestMesh("StaticGeometryTests", numVertices));
+    StaticGeometry* geom = mSceneMgr->createStaticGeometry("StaticGeometryTests");
+    TestInstanceList instances;
+    for (size_t i = 0; i < numInstances; ++i)
+    {
+        TestInstance inst = randomInstance();
+        addInstance(geom, ent, inst);
+        instances.push_back(inst);
+    }
+
+    BenchmarkLog log("StaticGeometryTests", StringConverter::toString(numInstances) +
+        " instances of " + StringConverter::toString(2 * numVertices) + " vertices");
+    geom->build();
+    log.time("build on 1 thread");
+
+    useTaskScheduler(mRoot);
+    log.restart();
+    geom->build();
+    log.time("build on 4 threads");
+
+    // A few instances moved
+    for (size_t i = 0; i < numChanges; ++i)
+    {
+        TestInstance& inst = instances[rand() % instances.size()];
+        geom->removeEntity(inst.id);
+        inst = randomInstance();
+        addInstance(geom, ent, inst);
+    }
+    log.restart();
+    geom->update();
+    log.time("update after moving " + StringConverter::toString(numChanges) + " instances");
+    CPPUNIT_ASSERT_EQUAL(numInstances * 2 * numVertices, getNumVertices(geom));
+}
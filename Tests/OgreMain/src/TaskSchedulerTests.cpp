@@ -0,0 +1,265 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "TaskSchedulerTests.h"
+#include "OgreRoot.h"
+#include "Threading/OgreTaskSchedulerWorkQueue.h"
+#include "OgreMath.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(TaskSchedulerTests);
+
+//--------------------------------------------------------------------------
+/// Counts the visits of each index
+struct CountVisits
+{
+    vector<uint32>::type* counts;
+
+    void operator()(size_t begin, size_t end) const
+    {
+        for (size_t i = begin; i < end; ++i)
+            ++(*counts)[i];
+    }
+};
+//--------------------------------------------------------------------------
+/// Runs a parallelFor per row from within a parallelFor over the rows
+struct CountRowVisits
+{
+    TaskScheduler* scheduler;
+    vector<uint32>::type* counts;
+    size_t rowSize;
+
+    void operator()(size_t begin, size_t end) const
+    {
+        for (size_t row = begin; row < end; ++row)
+        {
+            CountVisits visits = { counts };
+            scheduler->parallelFor(row * rowSize, (row + 1) * rowSize, 16, visits);
+        }
+    }
+};
+//--------------------------------------------------------------------------
+/// Compute bound work, the same for every index
+struct ComputeSeries
+{
+    Real* results;
+
+    void operator()(size_t begin, size_t end) const
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            Real sum = 0;
+            for (size_t k = 1; k < 100; ++k)
+                sum += Math::Sin(Real(i * k) * 0.001f) / k;
+            results[i] = sum;
+        }
+    }
+};
+//--------------------------------------------------------------------------
+/// Doubles the request data, counts the responses
+class DoublingHandler : public WorkQueue::RequestHandler, public WorkQueue::ResponseHandler
+{
+public:
+    size_t numResponses;
+    size_t sum;
+
+    DoublingHandler() : numResponses(0), sum(0) {}
+
+    WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+    {
+        const size_t value = any_cast<size_t>(req->getData());
+        return OGRE_NEW WorkQueue::Response(req, true, Any(value * 2));
+    }
+
+    void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
+    {
+        CPPUNIT_ASSERT(res->succeeded());
+        ++numResponses;
+        sum += any_cast<size_t>(res->getData());
+    }
+};
+//--------------------------------------------------------------------------
+void TaskSchedulerTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+}
+//--------------------------------------------------------------------------
+void TaskSchedulerTests::tearDown()
+{
+    OGRE_DELETE mRoot;
+}
+//--------------------------------------------------------------------------
+void TaskSchedulerTests::testParallelForCoversRange()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t threadCounts[] = { 0, 1, 3, 7 };
+    for (size_t t = 0; t < sizeof(threadCounts) / sizeof(threadCounts[0]); ++t)
+    {
+        TaskScheduler scheduler;
+        scheduler.startup(threadCounts[t]);
+        CPPUNIT_ASSERT_EQUAL(threadCounts[t], scheduler.getNumThreads());
+
+        // Every index exactly once, whatever the grain size
+        const size_t grainSizes[] = { 1, 37, 1000, 100000 };
+        for (size_t g = 0; g < sizeof(grainSizes) / sizeof(grainSizes[0]); ++g)
+        {
+            vector<uint32>::type counts(10007, 0);
+            CountVisits visits = { &counts };
+            scheduler.parallelFor(0, counts.size(), grainSizes[g], visits);
+            for (size_t i = 0; i < counts.size(); ++i)
+                CPPUNIT_ASSERT_EQUAL(uint32(1), counts[i]);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void TaskSchedulerTests::testNestedParallelFor()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    TaskScheduler scheduler;
+    scheduler.startup(3);
+
+    // Tasks waiting on their own tasks must not deadlock
+    const size_t numRows = 64, rowSize = 512;
+    vector<uint32>::type counts(numRows * rowSize, 0);
+    CountRowVisits rowVisits = { &scheduler, &counts, rowSize };
+    scheduler.parallelFor(0, numRows, 1, rowVisits);
+    for (size_t i = 0; i < counts.size(); ++i)
+        CPPUNIT_ASSERT_EQUAL(uint32(1), counts[i]);
+}
+//--------------------------------------------------------------------------
+void TaskSchedulerTests::testWorkQueueRequests()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    TaskSchedulerWorkQueue queue("TaskSchedulerTests");
+    queue.setWorkerThreadCount(3);
+    queue.startup();
+    CPPUNIT_ASSERT(queue.getTaskScheduler());
+
+    DoublingHandler handler;
+    const uint16 channel = queue.getChannel("TaskSchedulerTests");
+    queue.addRequestHandler(channel, &handler);
+    queue.addResponseHandler(channel, &handler);
+
+    const size_t numRequests = 500;
+    for (size_t i = 0; i < numRequests; ++i)
+        queue.addRequest(channel, 0, Any(i));
+
+    // Responses are processed on this thread, as with DefaultWorkQueue
+    Timer timer;
+    while (handler.numResponses < numRequests && timer.getMilliseconds() < 10000)
+    {
+        queue.processResponses();
+        Threads::Sleep(1);
+    }
+    CPPUNIT_ASSERT_EQUAL(numRequests, handler.numResponses);
+    CPPUNIT_ASSERT_EQUAL(numRequests * (numRequests - 1), handler.sum);
+
+    queue.removeRequestHandler(channel, &handler);
+    queue.removeResponseHandler(channel, &handler);
+    queue.shutdown();
+}
+//--------------------------------------------------------------------------
+void TaskSchedulerTests::testWorkQueueWithoutWorkers()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    TaskSchedulerWorkQueue queue("TaskSchedulerTests");
+    queue.setWorkerThreadCount(0);
+    queue.startup();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), queue.getTaskScheduler()->getNumThreads());
+
+    DoublingHandler handler;
+    const uint16 channel = queue.getChannel("TaskSchedulerTests");
+    queue.addRequestHandler(channel, &handler);
+    queue.addResponseHandler(channel, &handler);
+
+    const size_t numRequests = 50;
+    for (size_t i = 0; i < numRequests; ++i)
+        queue.addRequest(channel, 0, Any(i));
+
+    // The requests are run by processResponses, on this thread
+    queue.setResponseProcessingTimeLimit(0);
+    queue.processResponses();
+    CPPUNIT_ASSERT_EQUAL(numRequests, handler.numResponses);
+    CPPUNIT_ASSERT_EQUAL(numRequests * (numRequests - 1), handler.sum);
+
+    queue.removeRequestHandler(channel, &handler);
+    queue.removeResponseHandler(channel, &handler);
+    queue.shutdown();
+}
+//--------------------------------------------------------------------------
+void TaskSchedulerTests::testScaling()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+#ifdef OGRE_THREAD_HARDWARE_CONCURRENCY
+    const size_t numCores = std::max<size_t>(OGRE_THREAD_HARDWARE_CONCURRENCY, 1);
+#else
+    const size_t numCores = 4;
+#endif
+
+    const size_t numItems = 100000;
+    vector<Real>::type expected(numItems), results(numItems);
+    ComputeSeries serial = { &expected[0] };
+    serial(0, numItems);
+
+    // The calling thread works too, so n threads are n - 1 workers
+    unsigned long singleThreadTime = 0;
+    for (size_t numThreads = 1; ; numThreads = std::min(numThreads * 2, numCores))
+    {
+        TaskScheduler scheduler;
+        scheduler.startup(numThreads - 1);
+
+        std::fill(results.begin(), results.end(), Real(0));
+        ComputeSeries parallel = { &results[0] };
+        Timer timer;
+        scheduler.parallelFor(0, numItems, 256, parallel);
+        const unsigned long time = timer.getMicroseconds();
+        if (numThreads == 1)
+            singleThreadTime = time;
+
+        LogManager::getSingleton().stream() << "TaskSchedulerTests: " << numThreads
+            << " thread(s), " << numItems << " items in " << time << " us, speedup "
+            << (time ? Real(singleThreadTime) / time : Real(0));
+
+        CPPUNIT_ASSERT(results == expected);
+
+        if (numThreads == numCores)
+            break;
+    }
+}
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreHighLevelGpuProgramManager.h"
 #include "OgreGpuProgramManager.h"
 #include "OgreLodStrategyManager.h"
+#include "OgreStringConverter.h"
 
 #include "UnitTestSuite.h"
 
@@ -87,4 +88,31 @@ void UnitTestSuite::startTestMethod(const std::string testName)
     Ogre::LogManager::getSingletonPtr()->logMessage("||--> Starting Unit Test [" + testName + "]:");
 }
 //--------------------------------------------------------------------------
-
+BenchmarkLog::BenchmarkLog(const std::string& fixture, const std::string& description)
+    : mLine(fixture + ": " + description)
+{
+}
+//--------------------------------------------------------------------------
+BenchmarkLog::~BenchmarkLog()
+{
+    Ogre::LogManager::getSingletonPtr()->logMessage(mLine);
+}
+//--------------------------------------------------------------------------
+void BenchmarkLog::restart()
+{
+    mTimer.reset();
+}
+//--------------------------------------------------------------------------
+unsigned long BenchmarkLog::time(const std::string& step, size_t repeats)
+{
+    const unsigned long elapsed = mTimer.getMicroseconds() / static_cast<unsigned long>(repeats);
+    mLine += ", " + step + " " + Ogre::StringConverter::toString(elapsed) + " us";
+    mTimer.reset();
+    return elapsed;
+}
+//--------------------------------------------------------------------------
+void BenchmarkLog::note(const std::string& text)
+{
+    mLine += ", " + text;
+}
+//--------------------------------------------------------------------------
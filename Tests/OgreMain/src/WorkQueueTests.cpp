@@ -0,0 +1,166 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "WorkQueueTests.h"
+#include "OgreRoot.h"
+#include "OgreTimer.h"
+#include "Threading/OgreDefaultWorkQueue.h"
+#include "Threading/OgreThreads.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(WorkQueueTests);
+
+//--------------------------------------------------------------------------
+/// Answers every request, records the channels of the responses handled
+class RecordingHandler : public WorkQueue::RequestHandler, public WorkQueue::ResponseHandler
+{
+public:
+    vector<uint16>::type handled;
+
+    WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+    {
+        return OGRE_NEW WorkQueue::Response(req, true, Any());
+    }
+
+    void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
+    {
+        handled.push_back(res->getRequest()->getChannel());
+    }
+};
+//--------------------------------------------------------------------------
+/// Queues requests on two channels and waits until all responses are queued
+static void queueRequests(DefaultWorkQueueBase& queue, RecordingHandler& handler,
+    uint16 first, size_t numFirst, uint16 second, size_t numSecond)
+{
+    queue.addRequestHandler(first, &handler);
+    queue.addResponseHandler(first, &handler);
+    queue.addRequestHandler(second, &handler);
+    queue.addResponseHandler(second, &handler);
+
+    for (size_t i = 0; i < numFirst; ++i)
+        queue.addRequest(first, 0, Any());
+    for (size_t i = 0; i < numSecond; ++i)
+        queue.addRequest(second, 0, Any());
+
+    Timer timer;
+    while ((queue.getResponseChannelStats(first).queued < numFirst ||
+            queue.getResponseChannelStats(second).queued < numSecond) &&
+           timer.getMilliseconds() < 10000)
+    {
+        Threads::Sleep(1);
+    }
+    CPPUNIT_ASSERT_EQUAL(numFirst, queue.getResponseChannelStats(first).queued);
+    CPPUNIT_ASSERT_EQUAL(numSecond, queue.getResponseChannelStats(second).queued);
+}
+//--------------------------------------------------------------------------
+void WorkQueueTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+}
+//--------------------------------------------------------------------------
+void WorkQueueTests::tearDown()
+{
+    OGRE_DELETE mRoot;
+}
+//--------------------------------------------------------------------------
+void WorkQueueTests::testResponsePriorities()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+#if OGRE_THREAD_SUPPORT
+    DefaultWorkQueue queue("WorkQueueTests");
+    queue.setWorkerThreadCount(2);
+    queue.setResponseProcessingTimeLimit(0);
+    queue.startup();
+
+    RecordingHandler handler;
+    const uint16 textures = queue.getChannel("Textures");
+    const uint16 geometry = queue.getChannel("Geometry");
+    queue.setResponseChannelPriority(geometry, 1);
+    queueRequests(queue, handler, textures, 10, geometry, 5);
+
+    // Geometry first although queued last, then the textures
+    queue.processResponses();
+    CPPUNIT_ASSERT_EQUAL(size_t(15), handler.handled.size());
+    for (size_t i = 0; i < handler.handled.size(); ++i)
+        CPPUNIT_ASSERT_EQUAL(i < 5 ? geometry : textures, handler.handled[i]);
+
+    WorkQueue::RequestHandler* rh = &handler;
+    queue.removeRequestHandler(textures, rh);
+    queue.removeRequestHandler(geometry, rh);
+    queue.shutdown();
+#endif
+}
+//--------------------------------------------------------------------------
+void WorkQueueTests::testResponseBudgets()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+#if OGRE_THREAD_SUPPORT
+    DefaultWorkQueue queue("WorkQueueTests");
+    queue.setWorkerThreadCount(2);
+    queue.setResponseProcessingTimeLimit(0);
+    queue.startup();
+
+    RecordingHandler handler;
+    const uint16 textures = queue.getChannel("Textures");
+    const uint16 geometry = queue.getChannel("Geometry");
+    queue.setResponseChannelBudget(textures, 3, 0);
+    queueRequests(queue, handler, textures, 10, geometry, 5);
+
+    // Three textures per call, the geometry isn't held back by them
+    queue.processResponses();
+    CPPUNIT_ASSERT_EQUAL(size_t(8), handler.handled.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(5), (size_t)std::count(handler.handled.begin(), handler.handled.end(), geometry));
+
+    DefaultWorkQueueBase::ResponseChannelStats stats = queue.getResponseChannelStats(textures);
+    CPPUNIT_ASSERT_EQUAL(size_t(7), stats.queued);
+    CPPUNIT_ASSERT_EQUAL(size_t(3), stats.processed);
+    CPPUNIT_ASSERT(stats.averageLatency <= stats.maxLatency);
+
+    queue.processResponses();
+    queue.processResponses();
+    queue.processResponses();
+    CPPUNIT_ASSERT_EQUAL(size_t(15), handler.handled.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), queue.getResponseChannelStats(textures).queued);
+    CPPUNIT_ASSERT_EQUAL(size_t(10), queue.getResponseChannelStats(textures).processed);
+
+    queue.resetResponseChannelStats();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), queue.getResponseChannelStats(geometry).processed);
+
+    WorkQueue::RequestHandler* rh = &handler;
+    queue.removeRequestHandler(textures, rh);
+    queue.removeRequestHandler(geometry, rh);
+    queue.shutdown();
+#endif
+}
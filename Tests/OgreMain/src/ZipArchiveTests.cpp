@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "Threading/OgreThreadHeaders.h"
 #include "OgreZip.h"
 #include "OgreCommon.h"
+#include "Threading/OgreTaskScheduler.h"
 
 #include "UnitTestSuite.h"
 
@@ -41,6 +42,23 @@ using namespace Ogre;
 // Register the test suite
 CPPUNIT_TEST_SUITE_REGISTRATION( ZipArchiveTests );
 
+namespace
+{
+    /// Reads files of an archive into a list of strings
+    struct ReadFiles
+    {
+        Archive* archive;
+        const StringVector* names;
+        StringVector* contents;
+
+        void operator()(size_t begin, size_t end) const
+        {
+            for (size_t i = begin; i < end; ++i)
+                (*contents)[i] = archive->open((*names)[i])->getAsString();
+        }
+    };
+}
+
 //--------------------------------------------------------------------------
 void ZipArchiveTests::setUp()
 {
@@ -382,3 +400,101 @@ void ZipArchiveTests::testReadInterleave()
     OGRE_DELETE arch;
 }
 //--------------------------------------------------------------------------
+void ZipArchiveTests::testSeekBackwards()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    ZipArchive* arch = OGRE_NEW ZipArchive(mTestPath, "Zip");
+    try {
+        arch->load();
+    } catch (Ogre::Exception e) {
+        // If it starts in build/bin/debug
+        OGRE_DELETE arch;
+        arch = OGRE_NEW ZipArchive("../../../" + mTestPath, "Zip");
+        arch->load();
+    }
+
+    DataStreamPtr stream = arch->open("rootfile2.txt");
+    CPPUNIT_ASSERT_EQUAL((size_t)156, stream->size());
+    stream->seek(26);
+    CPPUNIT_ASSERT_EQUAL(String("this is line 2 in file 2"), stream->getLine());
+    stream->seek(0);
+    CPPUNIT_ASSERT_EQUAL(String("this is line 1 in file 2"), stream->getLine());
+    stream->skip(26);
+    CPPUNIT_ASSERT_EQUAL(String("this is line 3 in file 2"), stream->getLine());
+    stream->skip(-52);
+    CPPUNIT_ASSERT_EQUAL(String("this is line 2 in file 2"), stream->getLine());
+    stream->seek(stream->size());
+    CPPUNIT_ASSERT(stream->eof());
+
+    // Files are found by their full name or their base name, in any case
+    CPPUNIT_ASSERT(!arch->open("level1/materials/scripts/file.material").isNull());
+    CPPUNIT_ASSERT(!arch->open("FILE2.material").isNull());
+    CPPUNIT_ASSERT(arch->exists("level2/materials/scripts/file3.material"));
+    CPPUNIT_ASSERT(!arch->exists("file5.material"));
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+void ZipArchiveTests::testConcurrentRead()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    ZipArchive* arch = OGRE_NEW ZipArchive(mTestPath, "Zip");
+    try {
+        arch->load();
+    } catch (Ogre::Exception e) {
+        // If it starts in build/bin/debug
+        OGRE_DELETE arch;
+        arch = OGRE_NEW ZipArchive("../../../" + mTestPath, "Zip");
+        arch->load();
+    }
+
+    const String file1 = arch->open("rootfile.txt")->getAsString();
+    const String file2 = arch->open("rootfile2.txt")->getAsString();
+
+    StringVector names;
+    for (size_t i = 0; i < 256; ++i)
+        names.push_back(i % 2 ? "rootfile2.txt" : "rootfile.txt");
+    StringVector contents(names.size());
+
+    ReadFiles readFiles;
+    readFiles.archive = arch;
+    readFiles.names = &names;
+    readFiles.contents = &contents;
+    TaskScheduler scheduler;
+    scheduler.startup(3);
+    scheduler.parallelFor(0, names.size(), 1, readFiles);
+    scheduler.shutdown();
+
+    for (size_t i = 0; i < names.size(); ++i)
+        CPPUNIT_ASSERT_EQUAL(i % 2 ? file2 : file1, contents[i]);
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+void ZipArchiveTests::testExists()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    ZipArchive* arch = OGRE_NEW ZipArchive(mTestPath, "Zip");
+    try {
+        arch->load();
+    } catch (Ogre::Exception e) {
+        // If it starts in build/bin/debug
+        OGRE_DELETE arch;
+        arch = OGRE_NEW ZipArchive("../../../" + mTestPath, "Zip");
+        arch->load();
+    }
+
+    // Files by base name and top level folders, case sensitive
+    CPPUNIT_ASSERT(arch->exists("rootfile.txt"));
+    CPPUNIT_ASSERT(arch->exists("level1/materials/scripts/file.material"));
+    CPPUNIT_ASSERT(arch->exists("file3.material"));
+    CPPUNIT_ASSERT(arch->exists("level2"));
+    CPPUNIT_ASSERT(!arch->exists("RootFile.txt"));
+    CPPUNIT_ASSERT(!arch->exists("missing.txt"));
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,315 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OctreeSceneQueryTests.h"
+#include "OgreRoot.h"
+#include "OgreOctreeSceneManager.h"
+#include "OgreOctreeNode.h"
+#include "OgreOctree.h"
+#include "OgreSceneQuery.h"
+#include "OgreMath.h"
+#include "OgreStringConverter.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(OctreeSceneQueryTests);
+
+//--------------------------------------------------------------------------
+static const Real WORLD_SIZE = 1000;
+//--------------------------------------------------------------------------
+/// Object with arbitrary bounds, which needs no render system
+class OctreeTestObject : public MovableObject
+{
+public:
+    OctreeTestObject(const String& name) : MovableObject(name), mRadius(0) {}
+
+    void setBounds(const AxisAlignedBox& box, Real radius)
+    {
+        mBox = box;
+        mRadius = radius;
+        if (mParentNode)
+            mParentNode->needUpdate();
+    }
+
+    const String& getMovableType(void) const { return OctreeTestObjectFactory::FACTORY_TYPE_NAME; }
+    const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+    Real getBoundingRadius(void) const { return mRadius; }
+    void _updateRenderQueue(RenderQueue* queue) {}
+    void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables = false) {}
+
+protected:
+    AxisAlignedBox mBox;
+    Real mRadius;
+};
+//--------------------------------------------------------------------------
+String OctreeTestObjectFactory::FACTORY_TYPE_NAME = "OctreeTestObject";
+//--------------------------------------------------------------------------
+MovableObject* OctreeTestObjectFactory::createInstanceImpl(const String& name,
+    const NameValuePairList* params)
+{
+    return OGRE_NEW OctreeTestObject(name);
+}
+//--------------------------------------------------------------------------
+void OctreeTestObjectFactory::destroyInstance(MovableObject* obj)
+{
+    OGRE_DELETE obj;
+}
+//--------------------------------------------------------------------------
+typedef vector<String>::type NameList;
+typedef vector<OctreeTestObject*>::type ObjectList;
+//--------------------------------------------------------------------------
+static Vector3 randomPosition(Real size)
+{
+    return Vector3(Math::RangeRandom(-size, size),
+        Math::RangeRandom(-size, size), Math::RangeRandom(-size, size));
+}
+//--------------------------------------------------------------------------
+/// Mostly small objects, with a few spanning many octants
+static void randomiseBounds(OctreeTestObject* obj)
+{
+    const Real maxSize = Math::UnitRandom() < 0.1 ? 300 : 30;
+    const Vector3 halfSize(Math::RangeRandom(1, maxSize), Math::RangeRandom(1, maxSize),
+        Math::RangeRandom(1, maxSize));
+    obj->setBounds(AxisAlignedBox(-halfSize, halfSize), halfSize.length());
+}
+//--------------------------------------------------------------------------
+static OctreeTestObject* createObject(SceneManager* sceneMgr, SceneNode* parent, size_t index)
+{
+    OctreeTestObject* obj = static_cast<OctreeTestObject*>(sceneMgr->createMovableObject(
+        "Object" + StringConverter::toString(index), OctreeTestObjectFactory::FACTORY_TYPE_NAME));
+    randomiseBounds(obj);
+    parent->attachObject(obj);
+    return obj;
+}
+//--------------------------------------------------------------------------
+/// Creates an octree scene whose objects partly lie outside the octree
+static OctreeSceneManager* createScene(Real looseness, size_t numObjects, ObjectList& objects)
+{
+    OctreeSceneManager* sceneMgr = OGRE_NEW OctreeSceneManager("Octree");
+    AxisAlignedBox size(-WORLD_SIZE, -WORLD_SIZE, -WORLD_SIZE, WORLD_SIZE, WORLD_SIZE, WORLD_SIZE);
+    int depth = 6;
+    sceneMgr->setOption("Size", &size);
+    sceneMgr->setOption("Depth", &depth);
+    sceneMgr->setOption("Looseness", &looseness);
+
+    objects.clear();
+    SceneNode* root = sceneMgr->getRootSceneNode();
+    for (size_t i = 0; i < numObjects; ++i)
+    {
+        SceneNode* node = root->createChildSceneNode(randomPosition(WORLD_SIZE * 1.2f));
+        objects.push_back(createObject(sceneMgr, node, i));
+    }
+    root->_update(true, false);
+    return sceneMgr;
+}
+//--------------------------------------------------------------------------
+/// Moves a quarter of the objects, by little or far, and changes the size of some
+static void moveObjects(SceneManager* sceneMgr, const ObjectList& objects)
+{
+    for (size_t i = 0; i < objects.size() / 4; ++i)
+    {
+        OctreeTestObject* obj = objects[rand() % objects.size()];
+        SceneNode* node = obj->getParentSceneNode();
+        const Real change = Math::UnitRandom();
+        if (change < 0.5)
+            node->translate(randomPosition(10));
+        else if (change < 0.8)
+            node->setPosition(randomPosition(WORLD_SIZE * 1.2f));
+        else
+            randomiseBounds(obj);
+    }
+    sceneMgr->getRootSceneNode()->_update(true, false);
+}
+//--------------------------------------------------------------------------
+static NameList getNames(const SceneQueryResult& result)
+{
+    NameList names;
+    for (SceneQueryResultMovableList::const_iterator i = result.movables.begin();
+        i != result.movables.end(); ++i)
+    {
+        names.push_back((*i)->getName());
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+//--------------------------------------------------------------------------
+static NameList getNames(const RaySceneQueryResult& result)
+{
+    NameList names;
+    for (RaySceneQueryResult::const_iterator i = result.begin(); i != result.end(); ++i)
+    {
+        names.push_back(i->movable->getName() + " " + StringConverter::toString(i->distance));
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+//--------------------------------------------------------------------------
+/// Runs random box, sphere and ray queries and compares them with a scan of every object
+static void checkQueries(SceneManager* sceneMgr, const ObjectList& objects, size_t numQueries)
+{
+    AxisAlignedBoxSceneQuery* boxQuery = sceneMgr->createAABBQuery(AxisAlignedBox());
+    SphereSceneQuery* sphereQuery = sceneMgr->createSphereQuery(Sphere());
+    RaySceneQuery* rayQuery = sceneMgr->createRayQuery(Ray());
+
+    size_t found = 0;
+    for (size_t i = 0; i < numQueries; ++i)
+    {
+        const Vector3 centre = randomPosition(WORLD_SIZE);
+        const Vector3 halfSize(Math::RangeRandom(1, 150), Math::RangeRandom(1, 150), Math::RangeRandom(1, 150));
+        const AxisAlignedBox box(centre - halfSize, centre + halfSize);
+        const Sphere sphere(centre, halfSize.x);
+        const Vector3 direction = randomPosition(1).normalisedCopy();
+        const Ray ray(centre - direction * WORLD_SIZE, direction);
+
+        NameList boxNames, sphereNames, rayNames;
+        for (ObjectList::const_iterator it = objects.begin(); it != objects.end(); ++it)
+        {
+            const AxisAlignedBox& bounds = (*it)->getWorldBoundingBox(true);
+            if (box.intersects(bounds))
+                boxNames.push_back((*it)->getName());
+            if (sphere.intersects(bounds))
+                sphereNames.push_back((*it)->getName());
+            std::pair<bool, Real> hit = ray.intersects(bounds);
+            if (hit.first)
+                rayNames.push_back((*it)->getName() + " " + StringConverter::toString(hit.second));
+        }
+        std::sort(boxNames.begin(), boxNames.end());
+        std::sort(sphereNames.begin(), sphereNames.end());
+        std::sort(rayNames.begin(), rayNames.end());
+
+        boxQuery->setBox(box);
+        CPPUNIT_ASSERT(boxNames == getNames(boxQuery->execute()));
+        sphereQuery->setSphere(sphere);
+        CPPUNIT_ASSERT(sphereNames == getNames(sphereQuery->execute()));
+        rayQuery->setRay(ray);
+        CPPUNIT_ASSERT(rayNames == getNames(rayQuery->execute()));
+
+        found += boxNames.size() + sphereNames.size() + rayNames.size();
+    }
+    CPPUNIT_ASSERT(found > 0);
+
+    sceneMgr->destroyQuery(boxQuery);
+    sceneMgr->destroyQuery(sphereQuery);
+    sceneMgr->destroyQuery(rayQuery);
+}
+//--------------------------------------------------------------------------
+void OctreeSceneQueryTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+    mFactory = OGRE_NEW OctreeTestObjectFactory();
+    mRoot->addMovableObjectFactory(mFactory);
+}
+//--------------------------------------------------------------------------
+void OctreeSceneQueryTests::tearDown()
+{
+    OGRE_DELETE mRoot;
+    OGRE_DELETE mFactory;
+}
+//--------------------------------------------------------------------------
+void OctreeSceneQueryTests::testQueriesMatchBruteForce()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const Real loosenesses[] = { 1, 1.5, 2, 3 };
+    for (size_t l = 0; l < sizeof(loosenesses) / sizeof(loosenesses[0]); ++l)
+    {
+        srand(static_cast<unsigned int>(l));
+        ObjectList objects;
+        OctreeSceneManager* sceneMgr = createScene(loosenesses[l], 2000, objects);
+        checkQueries(sceneMgr, objects, 100);
+        OGRE_DELETE sceneMgr;
+    }
+}
+//--------------------------------------------------------------------------
+void OctreeSceneQueryTests::testQueriesAfterMoves()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const Real loosenesses[] = { 1, 2 };
+    for (size_t l = 0; l < sizeof(loosenesses) / sizeof(loosenesses[0]); ++l)
+    {
+        srand(static_cast<unsigned int>(l));
+        ObjectList objects;
+        OctreeSceneManager* sceneMgr = createScene(loosenesses[l], 2000, objects);
+        for (int frame = 0; frame < 5; ++frame)
+        {
+            moveObjects(sceneMgr, objects);
+            checkQueries(sceneMgr, objects, 50);
+        }
+
+        // Rebuilding the octree keeps the nodes.
+        AxisAlignedBox size(-WORLD_SIZE / 2, -WORLD_SIZE / 2, -WORLD_SIZE / 2,
+            WORLD_SIZE / 2, WORLD_SIZE / 2, WORLD_SIZE / 2);
+        sceneMgr->setOption("Size", &size);
+        checkQueries(sceneMgr, objects, 50);
+        moveObjects(sceneMgr, objects);
+        checkQueries(sceneMgr, objects, 50);
+        OGRE_DELETE sceneMgr;
+    }
+}
+//--------------------------------------------------------------------------
+void OctreeSceneQueryTests::testClearSceneReleasesOctants()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    srand(0);
+    ObjectList objects;
+    OctreeSceneManager* sceneMgr = createScene(2, 500, objects);
+
+    // The root survives the clear, and is in the octree while it holds an object.
+    OctreeNode* root = static_cast<OctreeNode*>(sceneMgr->getRootSceneNode());
+    createObject(sceneMgr, root, 500);
+    root->_update(true, false);
+    CPPUNIT_ASSERT(root->getOctant() != 0);
+
+    sceneMgr->clearScene();
+    CPPUNIT_ASSERT(root->getOctant() == 0);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), root->_getOctantIndex());
+
+    // The root can go back into the new octree, and move in it.
+    objects.clear();
+    for (size_t i = 0; i < 500; ++i)
+    {
+        SceneNode* node = root->createChildSceneNode(randomPosition(WORLD_SIZE * 1.2f));
+        objects.push_back(createObject(sceneMgr, node, i));
+    }
+    objects.push_back(createObject(sceneMgr, root, 500));
+    root->_update(true, false);
+    CPPUNIT_ASSERT(root->getOctant() != 0);
+    checkQueries(sceneMgr, objects, 50);
+
+    root->setPosition(Vector3(WORLD_SIZE / 2, 0, 0));
+    moveObjects(sceneMgr, objects);
+    checkQueries(sceneMgr, objects, 50);
+
+    OGRE_DELETE sceneMgr;
+}
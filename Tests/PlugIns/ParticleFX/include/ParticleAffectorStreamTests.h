@@ -0,0 +1,82 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ParticleAffectorStreamTests_H__
+#define __ParticleAffectorStreamTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "OgrePrerequisites.h"
+#include "OgreStringVector.h"
+
+class ParticleAffectorStreamTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(ParticleAffectorStreamTests);
+    CPPUNIT_TEST(testLinearForce);
+    CPPUNIT_TEST(testColourFader);
+    CPPUNIT_TEST(testColourFader2);
+    CPPUNIT_TEST(testScale);
+    CPPUNIT_TEST(testRotation);
+    CPPUNIT_TEST(testColourInterpolator);
+    CPPUNIT_TEST(testColourImage);
+    CPPUNIT_TEST(testDeflectorPlane);
+    CPPUNIT_TEST(testDirectionRandomiser);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    Ogre::Root* mRoot;
+    Ogre::ControllerManager* mControllerMgr;
+    Ogre::SceneManager* mSceneMgr;
+    Ogre::ParticleEmitterFactory* mEmitterFactory;
+    Ogre::vector<Ogre::ParticleAffectorFactory*>::type mAffectorFactories;
+    Ogre::ParticleSystemRendererFactory* mRendererFactory;
+
+    /** Checks that an affector gives the same particles on contiguous storage,
+        with every kernel implementation, as on the particle list.
+    @param type The affector type.
+    @param params Parameter names and values, alternating.
+    @param streams Whether the affector is expected to have a stream path.
+    */
+    void checkAffector(const Ogre::String& type, const Ogre::StringVector& params, bool streams);
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testLinearForce();
+    void testColourFader();
+    void testColourFader2();
+    void testScale();
+    void testRotation();
+    void testColourInterpolator();
+    void testColourImage();
+    void testDeflectorPlane();
+    void testDirectionRandomiser();
+};
+
+#endif
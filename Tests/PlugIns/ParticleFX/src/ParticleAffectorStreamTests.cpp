@@ -0,0 +1,433 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ParticleAffectorStreamTests.h"
+#include "OgreRoot.h"
+#include "OgreControllerManager.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreParticleSystem.h"
+#include "OgreParticleSystemManager.h"
+#include "OgreParticleSystemRenderer.h"
+#include "OgreParticleEmitter.h"
+#include "OgreParticleEmitterFactory.h"
+#include "OgreParticleAffector.h"
+#include "OgreParticle.h"
+#include "OgreMath.h"
+#include "OgreParticleAffectorKernels.h"
+#include "OgreLinearForceAffectorFactory.h"
+#include "OgreColourFaderAffectorFactory.h"
+#include "OgreColourFaderAffectorFactory2.h"
+#include "OgreScaleAffectorFactory.h"
+#include "OgreRotationAffectorFactory.h"
+#include "OgreColourInterpolatorAffectorFactory.h"
+#include "OgreColourImageAffector.h"
+#include "OgreDeflectorPlaneAffectorFactory.h"
+#include "OgreDirectionRandomiserAffectorFactory.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(ParticleAffectorStreamTests);
+
+//--------------------------------------------------------------------------
+/// Emits particles with random state covering the branches of the affectors
+class StreamTestEmitter : public ParticleEmitter
+{
+public:
+    StreamTestEmitter(ParticleSystem* psys) : ParticleEmitter(psys) { mType = "StreamTest"; }
+
+    unsigned short _getEmissionCount(Real timeElapsed) { return genConstantEmissionCount(timeElapsed); }
+
+    void _initParticle(Particle* p)
+    {
+        ParticleEmitter::_initParticle(p);
+        // Around the origin, so that the deflector plane gets crossed both ways
+        p->mPosition = Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(), Math::SymmetricRandom());
+        p->mDirection = Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(), Math::SymmetricRandom()) * 50;
+        // Slightly out of [0, 1], so that the clamping is exercised
+        p->mColour = ColourValue(Math::RangeRandom(-0.1f, 1.1f), Math::RangeRandom(-0.1f, 1.1f),
+            Math::RangeRandom(-0.1f, 1.1f), Math::RangeRandom(-0.1f, 1.1f));
+        p->mTimeToLive = Math::RangeRandom(0.1f, 3);
+        p->mTotalTimeToLive = p->mTimeToLive + Math::RangeRandom(0, 2);
+        p->mRotation = Radian(Math::SymmetricRandom() * Math::PI);
+        p->mRotationSpeed = Radian(Math::SymmetricRandom() * 3);
+        if (Math::UnitRandom() < 0.5f)
+            p->setDimensions(Math::RangeRandom(1, 10), Math::RangeRandom(1, 10));
+    }
+};
+//--------------------------------------------------------------------------
+class StreamTestEmitterFactory : public ParticleEmitterFactory
+{
+public:
+    String getName() const { return "StreamTest"; }
+    ParticleEmitter* createEmitter(ParticleSystem* psys)
+    {
+        ParticleEmitter* emitter = OGRE_NEW StreamTestEmitter(psys);
+        mEmitters.push_back(emitter);
+        return emitter;
+    }
+};
+//--------------------------------------------------------------------------
+/// ColourImageAffector with an image in memory rather than from the resources
+class StreamTestColourImageAffector : public ColourImageAffector
+{
+public:
+    StreamTestColourImageAffector(ParticleSystem* psys) : ColourImageAffector(psys)
+    {
+        mType = "StreamTestColourImage";
+        static float data[8 * 4];
+        for (size_t i = 0; i < 8; ++i)
+        {
+            data[i * 4 + 0] = i / 7.0f;
+            data[i * 4 + 1] = 1 - i / 7.0f;
+            data[i * 4 + 2] = (i % 3) / 2.0f;
+            data[i * 4 + 3] = 1;
+        }
+        mColourImage.loadDynamicImage(reinterpret_cast<uchar*>(data), 8, 1, 1, PF_FLOAT32_RGBA);
+        mColourImageLoaded = true;
+    }
+};
+//--------------------------------------------------------------------------
+class StreamTestColourImageAffectorFactory : public ParticleAffectorFactory
+{
+public:
+    String getName() const { return "StreamTestColourImage"; }
+    ParticleAffector* createAffector(ParticleSystem* psys)
+    {
+        ParticleAffector* affector = OGRE_NEW StreamTestColourImageAffector(psys);
+        mAffectors.push_back(affector);
+        return affector;
+    }
+};
+//--------------------------------------------------------------------------
+/// Renderer which draws nothing
+class StreamTestRenderer : public ParticleSystemRenderer
+{
+public:
+    const String& getType(void) const
+    {
+        static const String type = "billboard";
+        return type;
+    }
+    void _updateRenderQueue(RenderQueue* queue, list<Particle*>::type& currentParticles,
+        bool cullIndividually) {}
+    void _setMaterial(MaterialPtr& mat) {}
+    void _notifyCurrentCamera(Camera* cam) {}
+    void _notifyAttached(Node* parent, bool isTagPoint = false) {}
+    void _notifyParticleQuota(size_t quota) {}
+    void _notifyDefaultDimensions(Real width, Real height) {}
+    void setRenderQueueGroup(uint8 queueID) {}
+    void setRenderQueueGroupAndPriority(uint8 queueID, ushort priority) {}
+    void setKeepParticlesInLocalSpace(bool keepLocal) {}
+    SortMode _getSortMode(void) const { return SM_DISTANCE; }
+    void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables = false) {}
+};
+//--------------------------------------------------------------------------
+class StreamTestRendererFactory : public ParticleSystemRendererFactory
+{
+public:
+    const String& getType() const
+    {
+        static const String type = "billboard";
+        return type;
+    }
+    ParticleSystemRenderer* createInstance(const String& name) { return OGRE_NEW StreamTestRenderer(); }
+    void destroyInstance(ParticleSystemRenderer* ptr) { OGRE_DELETE ptr; }
+};
+//--------------------------------------------------------------------------
+/// Particle system filled up to its quota, whose affectors can be run alone
+class StreamTestParticleSystem : public ParticleSystem
+{
+public:
+    StreamTestParticleSystem(const String& name, SceneManager* sceneMgr, size_t quota, bool contiguous)
+        : ParticleSystem(name, ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME)
+    {
+        mIsRendererConfigured = true;
+        setParticleQuota(quota);
+        setDefaultDimensions(4, 2);
+        setContiguousParticleStorage(contiguous);
+        addEmitter("StreamTest")->setEmissionRate(100000);
+        sceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(this);
+
+        srand(static_cast<unsigned int>(quota));
+        _update(0.1f);
+    }
+
+    /// Runs the affectors only, without expiring, moving or emitting particles
+    void affect(Real timeElapsed) { _triggerAffectors(timeElapsed); }
+};
+//--------------------------------------------------------------------------
+/// State of a particle, ordered so that the states of systems can be compared
+struct StreamTestParticleState
+{
+    Real values[16];
+
+    StreamTestParticleState(const Particle* p)
+    {
+        values[0] = p->mPosition.x;
+        values[1] = p->mPosition.y;
+        values[2] = p->mPosition.z;
+        values[3] = p->mDirection.x;
+        values[4] = p->mDirection.y;
+        values[5] = p->mDirection.z;
+        values[6] = p->mColour.r;
+        values[7] = p->mColour.g;
+        values[8] = p->mColour.b;
+        values[9] = p->mColour.a;
+        values[10] = p->mTimeToLive;
+        values[11] = p->mTotalTimeToLive;
+        values[12] = p->mRotation.valueRadians();
+        values[13] = p->mRotationSpeed.valueRadians();
+        values[14] = p->hasOwnDimensions() ? p->getOwnWidth() : -1;
+        values[15] = p->hasOwnDimensions() ? p->getOwnHeight() : -1;
+    }
+
+    bool operator<(const StreamTestParticleState& rhs) const
+    {
+        return std::lexicographical_compare(values, values + 16, rhs.values, rhs.values + 16);
+    }
+    bool operator==(const StreamTestParticleState& rhs) const
+    {
+        return std::equal(values, values + 16, rhs.values);
+    }
+};
+//--------------------------------------------------------------------------
+static void checkSameParticles(ParticleSystem* expected, ParticleSystem* actual, const String& msg)
+{
+    CPPUNIT_ASSERT_EQUAL(expected->getNumParticles(), actual->getNumParticles());
+
+    vector<StreamTestParticleState>::type expectedStates, actualStates;
+    for (size_t i = 0; i < expected->getNumParticles(); ++i)
+    {
+        expectedStates.push_back(StreamTestParticleState(expected->getParticle(i)));
+        actualStates.push_back(StreamTestParticleState(actual->getParticle(i)));
+    }
+    std::sort(expectedStates.begin(), expectedStates.end());
+    std::sort(actualStates.begin(), actualStates.end());
+
+    // Results must match exactly, not only within a tolerance
+    CPPUNIT_ASSERT_MESSAGE(msg, expectedStates == actualStates);
+}
+//--------------------------------------------------------------------------
+static StringVector makeParams(const char* const* namesAndValues)
+{
+    StringVector params;
+    for (; *namesAndValues; ++namesAndValues)
+        params.push_back(*namesAndValues);
+    return params;
+}
+//--------------------------------------------------------------------------
+void ParticleAffectorStreamTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+    // Normally created by Root::initialise, drives the particle systems
+    mControllerMgr = OGRE_NEW ControllerManager();
+    mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+
+    // As ParticleFXPlugin::install, which needs a plugin to be loaded
+    mEmitterFactory = OGRE_NEW StreamTestEmitterFactory();
+    mAffectorFactories.push_back(OGRE_NEW LinearForceAffectorFactory());
+    mAffectorFactories.push_back(OGRE_NEW ColourFaderAffectorFactory());
+    mAffectorFactories.push_back(OGRE_NEW ColourFaderAffectorFactory2());
+    mAffectorFactories.push_back(OGRE_NEW ScaleAffectorFactory());
+    mAffectorFactories.push_back(OGRE_NEW RotationAffectorFactory());
+    mAffectorFactories.push_back(OGRE_NEW ColourInterpolatorAffectorFactory());
+    mAffectorFactories.push_back(OGRE_NEW StreamTestColourImageAffectorFactory());
+    mAffectorFactories.push_back(OGRE_NEW DeflectorPlaneAffectorFactory());
+    mAffectorFactories.push_back(OGRE_NEW DirectionRandomiserAffectorFactory());
+    mRendererFactory = OGRE_NEW StreamTestRendererFactory();
+
+    ParticleSystemManager::getSingleton().addEmitterFactory(mEmitterFactory);
+    for (size_t i = 0; i < mAffectorFactories.size(); ++i)
+        ParticleSystemManager::getSingleton().addAffectorFactory(mAffectorFactories[i]);
+    ParticleSystemManager::getSingleton().addRendererFactory(mRendererFactory);
+}
+//--------------------------------------------------------------------------
+void ParticleAffectorStreamTests::tearDown()
+{
+    ParticleAffectorKernels::_selectImplementation(ParticleAffectorKernels::KI_BEST);
+
+    OGRE_DELETE mRoot;
+    OGRE_DELETE mControllerMgr;
+    OGRE_DELETE mEmitterFactory;
+    for (size_t i = 0; i < mAffectorFactories.size(); ++i)
+        OGRE_DELETE mAffectorFactories[i];
+    mAffectorFactories.clear();
+    OGRE_DELETE mRendererFactory;
+}
+//--------------------------------------------------------------------------
+void ParticleAffectorStreamTests::checkAffector(const String& type, const StringVector& params,
+    bool streams)
+{
+    const ParticleAffectorKernels::Implementation impls[] =
+    {
+        ParticleAffectorKernels::KI_GENERAL,
+        ParticleAffectorKernels::KI_SSE
+    };
+    const char* implNames[] = { "general", "SSE" };
+    // None a multiple of 4, so that the tails of the SIMD loops are run
+    const size_t counts[] = { 1, 3, 6, 37, 103 };
+
+    for (size_t impl = 0; impl < 2; ++impl)
+    {
+        // SSE is not built in or not supported by the CPU
+        if (!ParticleAffectorKernels::_selectImplementation(impls[impl]))
+            continue;
+
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+        {
+            StreamTestParticleSystem* listSystem =
+                OGRE_NEW StreamTestParticleSystem("List", mSceneMgr, counts[c], false);
+            StreamTestParticleSystem* contiguousSystem =
+                OGRE_NEW StreamTestParticleSystem("Contiguous", mSceneMgr, counts[c], true);
+            CPPUNIT_ASSERT_EQUAL(counts[c], contiguousSystem->getNumParticles());
+
+            ParticleAffector* listAffector = listSystem->addAffector(type);
+            ParticleAffector* contiguousAffector = contiguousSystem->addAffector(type);
+            CPPUNIT_ASSERT_EQUAL(streams, contiguousAffector->_supportsParticleStreams());
+            for (size_t i = 0; i + 1 < params.size(); i += 2)
+            {
+                CPPUNIT_ASSERT(listAffector->setParameter(params[i], params[i + 1]));
+                CPPUNIT_ASSERT(contiguousAffector->setParameter(params[i], params[i + 1]));
+            }
+
+            for (unsigned int step = 0; step < 10; ++step)
+            {
+                // Same random sequence for both systems
+                srand(step);
+                listSystem->affect(0.05f);
+                srand(step);
+                contiguousSystem->affect(0.05f);
+
+                StringStream msg;
+                msg << type << " with the " << implNames[impl] << " kernels, "
+                    << counts[c] << " particles, step " << step;
+                checkSameParticles(listSystem, contiguousSystem, msg.str());
+            }
+
+            OGRE_DELETE listSystem;
+            OGRE_DELETE contiguousSystem;
+        }
+    }
+
+    ParticleAffectorKernels::_selectImplementation(ParticleAffectorKernels::KI_BEST);
+}
+//--------------------------------------------------------------------------
+void ParticleAffectorStreamTests::testLinearForce()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const char* add[] = { "force_vector", "3 -100 0.5", "force_application", "add", 0 };
+    checkAffector("LinearForce", makeParams(add), true);
+    const char* average[] = { "force_vector", "3 -100 0.5", "force_application", "average", 0 };
+    checkAffector("LinearForce", makeParams(average), true);
+}
+//--------------------------------------------------------------------------
+void ParticleAffectorStreamTests::testColourFader()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const char* params[] = { "red", "-0.5", "green", "0.25", "blue", "-2", "alpha", "1.5", 0 };
+    checkAffector("ColourFader", makeParams(params), true);
+}
+//--------------------------------------------------------------------------
+void ParticleAffectorStreamTests::testColourFader2()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const char* params[] = {
+        "red1", "-0.5", "green1", "0.25", "blue1", "-2", "alpha1", "1.5",
+        "red2", "2", "green2", "-0.75", "blue2", "0", "alpha2", "-1",
+        "state_change", "1.5", 0 };
+    checkAffector("ColourFader2", makeParams(params), true);
+}
+//--------------------------------------------------------------------------
+void ParticleAffectorStreamTests::testScale()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const char* grow[] = { "rate", "5", 0 };
+    checkAffector("Scaler", makeParams(grow), true);
+    // Shrinks the particles, not below zero which Particle asserts on
+    const char* shrink[] = { "rate", "-1.5", 0 };
+    checkAffector("Scaler", makeParams(shrink), true);
+}
+//--------------------------------------------------------------------------
+void ParticleAffectorStreamTests::testRotation()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const char* params[] = {
+        "rotation_speed_range_start", "-90", "rotation_speed_range_end", "180",
+        "rotation_range_start", "0", "rotation_range_end", "360", 0 };
+    checkAffector("Rotator", makeParams(params), true);
+}
+//--------------------------------------------------------------------------
+void ParticleAffectorStreamTests::testColourInterpolator()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const char* params[] = {
+        "colour0", "1 0 0 1", "time0", "0",
+        "colour1", "0 1 0 0.5", "time1", "0.3",
+        "colour2", "0 0 1 0.25", "time2", "0.6",
+        "colour3", "1 1 1 0", "time3", "1", 0 };
+    checkAffector("ColourInterpolator", makeParams(params), true);
+}
+//--------------------------------------------------------------------------
+void ParticleAffectorStreamTests::testColourImage()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // No stream path, contiguous storage goes through the particle iterator
+    checkAffector("StreamTestColourImage", StringVector(), false);
+}
+//--------------------------------------------------------------------------
+void ParticleAffectorStreamTests::testDeflectorPlane()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const char* params[] = {
+        "plane_point", "0 0.1 0", "plane_normal", "0.6 0.8 0", "bounce", "0.8", 0 };
+    checkAffector("DeflectorPlane", makeParams(params), true);
+}
+//--------------------------------------------------------------------------
+void ParticleAffectorStreamTests::testDirectionRandomiser()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // No stream path, contiguous storage goes through the particle iterator
+    const char* keep[] = { "randomness", "20", "scope", "0.5", "keep_velocity", "true", 0 };
+    checkAffector("DirectionRandomiser", makeParams(keep), false);
+    const char* change[] = { "randomness", "20", "scope", "1", "keep_velocity", "false", 0 };
+    checkAffector("DirectionRandomiser", makeParams(change), false);
+}
@@ -23,6 +23,16 @@ int main(int argc, char *argv[])
     OGRE_NEW UnitTestSuite();
     UnitTestSuite::getSingletonPtr()->setUpSuite();
 
+    // Timing benchmarks, which only log their results, are registered apart
+    // and run with --benchmarks
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+    const bool runBenchmarks = strstr(strCmdLine, "--benchmarks") != 0;
+#else
+    bool runBenchmarks = false;
+    for (int i = 1; i < argc; ++i)
+        runBenchmarks |= strcmp(argv[i], "--benchmarks") == 0;
+#endif
+
     // Create the event manager and test controller
     CPPUNIT_NS::TestResult controller;
 
@@ -37,6 +47,8 @@ int main(int argc, char *argv[])
     // Add the top suite to the test runner
     CPPUNIT_NS::TestRunner runner;
     runner.addTest(CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest());
+    if (runBenchmarks)
+        runner.addTest(CPPUNIT_NS::TestFactoryRegistry::getRegistry(OGRE_BENCHMARK_REGISTRY).makeTest());
     runner.run(controller);
 
     // Print test results to a separate file
@@ -0,0 +1,177 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+
+#include "Ogre.h"
+#include "OgreConfigFile.h"
+#include "OgreRTShaderSystem.h"
+#include <iostream>
+
+using namespace std;
+using namespace Ogre;
+
+void help(void)
+{
+    // Print help message
+    cout << endl << "OgreRTShaderPrecompiler: Generates the programs of the run time shader system" << endl;
+    cout << "ahead of time, so that they are loaded from the cache on the next launch." << endl;
+
+    cout << endl << "Usage: OgreRTShaderPrecompiler [options] cachepath group [group...]" << endl;
+    cout << endl << "Available options:" << endl;
+    cout << "-p plugins.cfg  = The plugins to load, plugins.cfg by default" << endl;
+    cout << "-r resources.cfg= The resource locations, resources.cfg by default" << endl;
+    cout << "-d rendersystem = The render system to generate for, the first one by default" << endl;
+    cout << "-l language     = The target language, hlsl, glsl, glsles or cg" << endl;
+    cout << "-s scheme       = The destination scheme, the default of the generator by default" << endl;
+    cout << endl;
+}
+
+void addResourceLocations(const String& resourcesCfg)
+{
+    ConfigFile cf;
+    cf.load(resourcesCfg);
+
+    ConfigFile::SectionIterator seci = cf.getSectionIterator();
+    while (seci.hasMoreElements())
+    {
+        String sec = seci.peekNextKey();
+        ConfigFile::SettingsMultiMap* settings = seci.getNext();
+        for (ConfigFile::SettingsMultiMap::iterator i = settings->begin(); i != settings->end(); ++i)
+        {
+            ResourceGroupManager::getSingleton().addResourceLocation(i->second, i->first, sec);
+        }
+    }
+}
+
+int main(int numargs, char** args)
+{
+    String pluginsCfg = "plugins.cfg";
+    String resourcesCfg = "resources.cfg";
+    String renderSystemName;
+    String language;
+    String schemeName;
+    StringVector params;
+
+    for (int i = 1; i < numargs; ++i)
+    {
+        String arg = args[i];
+        if (arg.size() == 2 && arg[0] == '-')
+        {
+            if (i + 1 >= numargs)
+            {
+                help();
+                return -1;
+            }
+            String value = args[++i];
+            switch (arg[1])
+            {
+            case 'p': pluginsCfg = value; break;
+            case 'r': resourcesCfg = value; break;
+            case 'd': renderSystemName = value; break;
+            case 'l': language = value; break;
+            case 's': schemeName = value; break;
+            default:
+                help();
+                return -1;
+            }
+        }
+        else
+        {
+            params.push_back(arg);
+        }
+    }
+
+    if (params.size() < 2)
+    {
+        help();
+        return -1;
+    }
+
+    Root* root = OGRE_NEW Root(pluginsCfg, "", "OgreRTShaderPrecompiler.log");
+    int result = 0;
+
+    try
+    {
+        const RenderSystemList& renderSystems = root->getAvailableRenderers();
+        RenderSystem* rs = renderSystemName.empty() ?
+            (renderSystems.empty() ? 0 : renderSystems.front()) : root->getRenderSystemByName(renderSystemName);
+        if (!rs)
+        {
+            cout << "No render system available." << endl;
+            OGRE_DELETE root;
+            return -1;
+        }
+
+        // The programs depend on the capabilities of the device, which needs a window.
+        root->setRenderSystem(rs);
+        root->initialise(false);
+        NameValuePairList miscParams;
+        miscParams["hidden"] = "true";
+        root->createRenderWindow("OgreRTShaderPrecompiler", 64, 64, false, &miscParams);
+
+        addResourceLocations(resourcesCfg);
+
+        if (!RTShader::ShaderGenerator::initialize())
+        {
+            cout << "Unable to initialise the shader generator." << endl;
+            OGRE_DELETE root;
+            return -1;
+        }
+        RTShader::ShaderGenerator* shaderGenerator = RTShader::ShaderGenerator::getSingletonPtr();
+        if (!language.empty())
+            shaderGenerator->setTargetLanguage(language);
+        if (schemeName.empty())
+            schemeName = RTShader::ShaderGenerator::DEFAULT_SCHEME_NAME;
+
+        String cachePath = params[0];
+        if (cachePath[cachePath.size() - 1] != '/' && cachePath[cachePath.size() - 1] != '\\')
+            cachePath += '/';
+        shaderGenerator->setMicrocodeCacheEnabled(true);
+        shaderGenerator->setShaderCachePath(cachePath);
+
+        SceneManager* sceneMgr = root->createSceneManager(ST_GENERIC);
+        shaderGenerator->addSceneManager(sceneMgr);
+
+        for (size_t i = 1; i < params.size(); ++i)
+        {
+            ResourceGroupManager::getSingleton().initialiseResourceGroup(params[i]);
+            size_t count = shaderGenerator->precompileResourceGroup(params[i], schemeName);
+            cout << params[i] << ": generated the programs of " << count << " materials" << endl;
+        }
+
+        RTShader::ShaderGenerator::destroy();
+    }
+    catch (Exception& e)
+    {
+        cout << "Exception caught: " << e.getDescription() << endl;
+        result = -1;
+    }
+
+    OGRE_DELETE root;
+    return result;
+}
@@ -401,7 +401,18 @@ namespace Ogre {
             Animation* pAnim = pSkeleton->getAnimation(i);
             msg = "Exporting animation: " + pAnim->getName();
             LogManager::getSingleton().logMessage(msg);
-            writeAnimation(animsNode, pAnim);
+            if (pAnim->hasCompressedNodeTracks())
+            {
+                // XML holds the keyframes themselves
+                Animation* decompressed = pAnim->clone(pAnim->getName());
+                decompressed->decompressNodeTracks();
+                writeAnimation(animsNode, decompressed);
+                OGRE_DELETE decompressed;
+            }
+            else
+            {
+                writeAnimation(animsNode, pAnim);
+            }
             LogManager::getSingleton().logMessage("Animation exported.");
 
         }